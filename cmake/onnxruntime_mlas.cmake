@@ -7,9 +7,14 @@ onnxruntime_add_static_library(onnxruntime_mlas
   ${MLAS_SRC_DIR}/platform.cpp
   ${MLAS_SRC_DIR}/threading.cpp
   ${MLAS_SRC_DIR}/sgemm.cpp
+  ${MLAS_SRC_DIR}/sgemm_small.cpp
   ${MLAS_SRC_DIR}/qgemm.cpp
+  ${MLAS_SRC_DIR}/halfgemm.cpp
+  ${MLAS_SRC_DIR}/sbgemm.cpp
+  ${MLAS_SRC_DIR}/q4gemm.cpp
   ${MLAS_SRC_DIR}/qdwconv.cpp
   ${MLAS_SRC_DIR}/convolve.cpp
+  ${MLAS_SRC_DIR}/convwinograd.cpp
   ${MLAS_SRC_DIR}/convsym.cpp
   ${MLAS_SRC_DIR}/pooling.cpp
   ${MLAS_SRC_DIR}/transpose.cpp
@@ -20,6 +25,8 @@ onnxruntime_add_static_library(onnxruntime_mlas
   ${MLAS_SRC_DIR}/tanh.cpp
   ${MLAS_SRC_DIR}/erf.cpp
   ${MLAS_SRC_DIR}/compute.cpp
+  ${MLAS_SRC_DIR}/layernorm.cpp
+  ${MLAS_SRC_DIR}/flashattn.cpp
   ${MLAS_SRC_DIR}/quantize.cpp
   ${MLAS_SRC_DIR}/qgemm_kernel_default.cpp
   ${MLAS_SRC_DIR}/qladd.cpp
@@ -44,6 +51,9 @@ function(setup_mlas_source_for_windows)
         ${MLAS_SRC_DIR}/qgemm_kernel_neon.cpp
         ${MLAS_SRC_DIR}/qgemm_kernel_udot.cpp
         ${MLAS_SRC_DIR}/qgemm_kernel_sdot.cpp
+        ${MLAS_SRC_DIR}/sbgemm_kernel_neon.cpp
+        ${MLAS_SRC_DIR}/q4gemm_kernel_neon.cpp
+        ${MLAS_SRC_DIR}/sgemm_small_kernel_neon.cpp
       )
 
       set(mlas_platform_preprocess_srcs
@@ -127,6 +137,10 @@ function(setup_mlas_source_for_windows)
       ${MLAS_SRC_DIR}/qgemm_kernel_sse.cpp
       ${MLAS_SRC_DIR}/qgemm_kernel_sse41.cpp
       ${MLAS_SRC_DIR}/intrinsics/avx512/quantize_avx512f.cpp
+      ${MLAS_SRC_DIR}/intrinsics/avx512/sbgemm_kernel_avx512f.cpp
+      ${MLAS_SRC_DIR}/intrinsics/avx512/q4gemm_kernel_avx512f.cpp
+      ${MLAS_SRC_DIR}/intrinsics/avx512/sgemm_small_kernel_avx512f.cpp
+      ${MLAS_SRC_DIR}/intrinsics/avx512/layernorm_kernel_avx512f.cpp
       ${MLAS_SRC_DIR}/amd64/QgemmU8S8KernelAvx2.asm
       ${MLAS_SRC_DIR}/amd64/QgemmU8U8KernelAvx2.asm
       ${MLAS_SRC_DIR}/amd64/QgemmU8X8KernelAvx2.asm
@@ -297,7 +311,13 @@ else()
           ${MLAS_SRC_DIR}/qgemm_kernel_neon.cpp
           ${MLAS_SRC_DIR}/qgemm_kernel_udot.cpp
           ${MLAS_SRC_DIR}/qgemm_kernel_sdot.cpp
+          ${MLAS_SRC_DIR}/halfgemm_kernel_neon_fp16.cpp
+          ${MLAS_SRC_DIR}/sbgemm_kernel_neon.cpp
+          ${MLAS_SRC_DIR}/q4gemm_kernel_neon.cpp
+          ${MLAS_SRC_DIR}/sgemm_small_kernel_neon.cpp
         )
+        set_source_files_properties(${MLAS_SRC_DIR}/halfgemm_kernel_neon_fp16.cpp
+                                    PROPERTIES COMPILE_FLAGS "-march=armv8.2-a+fp16")
         if(ONNXRUNTIME_MLAS_MULTI_ARCH)
             onnxruntime_add_static_library(onnxruntime_mlas_arm64 ${mlas_platform_srcs})
             set_target_properties(onnxruntime_mlas_arm64 PROPERTIES OSX_ARCHITECTURES "arm64")
@@ -453,8 +473,15 @@ else()
           ${MLAS_SRC_DIR}/x86_64/ErfKernelFma3.S
           ${MLAS_SRC_DIR}/intrinsics/avx2/qladd_avx2.cpp
           ${MLAS_SRC_DIR}/intrinsics/avx2/qdwconv_avx2.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx2/halfgemm_kernel_avx2.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx2/sbgemm_kernel_avx2.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx2/q4gemm_kernel_avx2.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx2/sgemm_small_kernel_avx2.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx2/layernorm_kernel_avx2.cpp
         )
         set_source_files_properties(${mlas_platform_srcs_avx2} PROPERTIES COMPILE_FLAGS "-mavx2 -mfma")
+        set_source_files_properties(${MLAS_SRC_DIR}/intrinsics/avx2/halfgemm_kernel_avx2.cpp
+                                    PROPERTIES COMPILE_FLAGS "-mavx2 -mfma -mf16c")
 
         set(mlas_platform_srcs_avx512f
           ${MLAS_SRC_DIR}/x86_64/DgemmKernelAvx512F.S
@@ -463,6 +490,10 @@ else()
           ${MLAS_SRC_DIR}/x86_64/SpoolKernelAvx512F.S
           ${MLAS_SRC_DIR}/x86_64/TransKernelAvx512F.S
           ${MLAS_SRC_DIR}/intrinsics/avx512/quantize_avx512f.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx512/sbgemm_kernel_avx512f.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx512/q4gemm_kernel_avx512f.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx512/sgemm_small_kernel_avx512f.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx512/layernorm_kernel_avx512f.cpp
         )
         set_source_files_properties(${mlas_platform_srcs_avx512f} PROPERTIES COMPILE_FLAGS "-mavx512f")
 
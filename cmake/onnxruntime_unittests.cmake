@@ -909,6 +909,9 @@ if (NOT onnxruntime_ENABLE_TRAINING_TORCH_INTEROP)
     onnxruntime_add_executable(onnxruntime_benchmark
       ${BENCHMARK_DIR}/main.cc
       ${BENCHMARK_DIR}/modeltest.cc
+      ${BENCHMARK_DIR}/executor.cc
+      ${BENCHMARK_DIR}/batching.cc
+      ${BENCHMARK_DIR}/broadcast.cc
       ${BENCHMARK_DIR}/pooling.cc
       ${BENCHMARK_DIR}/resize.cc
       ${BENCHMARK_DIR}/batchnorm.cc
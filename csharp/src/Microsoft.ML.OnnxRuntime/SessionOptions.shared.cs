@@ -31,6 +31,7 @@ namespace Microsoft.ML.OnnxRuntime
     {
         ORT_SEQUENTIAL = 0,
         ORT_PARALLEL = 1,
+        ORT_PARALLEL_WORK_STEALING = 2,
     }
 
     /// <summary>
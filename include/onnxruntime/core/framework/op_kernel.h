@@ -116,6 +116,23 @@ class OpKernel {
     return Status::OK();
   }
 
+  // Override this function to use pre-packed buffers that PrePack() produced for the same input in an earlier
+  // session, without calling PrePack() again. This is how the pre-packed weights saved with an optimized model
+  // cache are restored. Unlike UseSharedPrePackedBuffers(), the kernel has to set up everything PrePack() would have,
+  // so it is given the shape of the initialized constant tensor.
+  // @param prepacked_buffers: The pre-packed buffers, in the order PrePack() stored them in PrePackedWeights.
+  // @param input_idx: The input index of the tensor in this kernel
+  // @param tensor_shape: The shape of the initialized constant tensor
+  // @param used_saved_buffers: Boolean flag set by the kernel implementation indicating that the provided weight
+  // has been used by the kernel. If false, PrePack() is called as usual.
+  virtual Status UseSavedPrePackedBuffers(std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                          int /*input_idx*/,
+                                          const TensorShape& /*tensor_shape*/,
+                                          /*out*/ bool& used_saved_buffers) {
+    used_saved_buffers = false;
+    return Status::OK();
+  }
+
   const OrtMemoryInfo& Allocator(int id, OrtMemType mem_type) const;
   const OpKernelInfo& Info() const {
     return *op_kernel_info_;
@@ -15,6 +15,7 @@ namespace onnxruntime {
 class OrtValueNameIdxMap;
 class FuncManager;
 class DataTransferManager;
+struct ConfigOptions;
 
 // A very light-weight class, which works as an aggregated
 // view of all data needed for constructing a Kernel instance.
@@ -26,7 +27,8 @@ class OpKernelInfo : public OpNodeProtoHelper<ProtoHelperNodeContext> {
                         const IExecutionProvider& execution_provider,
                         const std::unordered_map<int, OrtValue>& constant_initialized_tensors,
                         const OrtValueNameIdxMap& mlvalue_name_idx_map,
-                        const DataTransferManager& data_transfer_mgr);
+                        const DataTransferManager& data_transfer_mgr,
+                        const ConfigOptions* config_options = nullptr);
 
   OpKernelInfo(const OpKernelInfo& other);
 
@@ -42,6 +44,9 @@ class OpKernelInfo : public OpNodeProtoHelper<ProtoHelperNodeContext> {
 
   const onnxruntime::Node& node() const noexcept;
 
+  // Session configuration entries. Empty if the kernel is created outside of an inference session.
+  const ConfigOptions& GetConfigOptions() const noexcept;
+
   bool TryGetConstantInput(int input_index, const Tensor** constant_input_value) const;
 
  private:
@@ -56,6 +61,7 @@ class OpKernelInfo : public OpNodeProtoHelper<ProtoHelperNodeContext> {
   const std::unordered_map<int, OrtValue>& constant_initialized_tensors_;
   const OrtValueNameIdxMap& ort_value_name_idx_map_;
   const DataTransferManager& data_transfer_mgr_;
+  const ConfigOptions* config_options_;
   ProtoHelperNodeContext proto_helper_context_;
 };
 
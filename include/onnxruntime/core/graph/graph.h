@@ -409,7 +409,10 @@ class Node {
 
 #if !defined(ORT_MINIMAL_BUILD)
   /** Gets the Node's mutable attributes. */
-  NodeAttributes& GetMutableAttributes() noexcept { return attributes_; }
+  NodeAttributes& GetMutableAttributes() noexcept {
+    inference_signature_ = 0;
+    return attributes_;
+  }
 
   /** Gets the Graph instance that is instantiated from a GraphProto attribute during Graph::Resolve.
   @param attr_name Attribute name for the GraphProto attribute.
@@ -641,6 +644,11 @@ class Node {
   // This allows attribute adding and removing.
   NodeAttributes attributes_;
 
+  // Hash of the operator, input and output types, and constant input values seen by the last type and shape
+  // inference of this Node. 0 if the Node has not been inferred since its attributes last changed.
+  // Graph::Resolve skips inference for Nodes that are unchanged since then.
+  size_t inference_signature_ = 0;
+
   // Graph that contains this Node
   Graph* graph_ = nullptr;
 
@@ -3,6 +3,7 @@
 
 #pragma once
 #include <string>
+#include <vector>
 
 #include "core/common/common.h"
 #include "core/common/inlined_containers.h"
@@ -42,6 +43,11 @@ class GraphTransformer {
 
   virtual bool ShouldOnlyApplyOnce() const { return false; }
 
+  /** Gets the op types of the nodes this transformer rewrites. The transformer is not applied to a graph that
+  contains no node of any of these op types, in the graph or in its subgraphs.
+  @returns The op types, or an empty list if the transformer may modify any graph. */
+  virtual std::vector<std::string> TargetOpTypes() const noexcept { return {}; }
+
  protected:
   /** Helper method to call ApplyImpl on any subgraphs in the Node. */
   common::Status Recurse(Node& node, bool& modified, int graph_level, const logging::Logger& logger) const {
@@ -53,6 +53,10 @@ class RuleBasedGraphTransformer : public GraphTransformer {
   /** Returns the total number of rules that are registered in this transformer. */
   size_t RulesCount() const;
 
+  /** Returns the union of the target op types of the registered rules, or an empty list if a rule is evaluated
+      on all nodes. */
+  std::vector<std::string> TargetOpTypes() const noexcept override;
+
  protected:
   /** Applies the given set of rewrite rules on the Node of this Graph.
       @param[in] graph The Graph.
@@ -293,6 +293,18 @@ typedef void(ORT_API_CALL* OrtLoggingFunction)(
     void* param, OrtLoggingLevel severity, const char* category, const char* logid, const char* code_location,
     const char* message);
 
+/** \brief Callback invoked when a Run started with OrtApi::RunAsync completes
+*
+* \param[in] user_data The `user_data` passed to OrtApi::RunAsync
+* \param[in] outputs The `output` array passed to OrtApi::RunAsync. Entries that were nullptr are set to newly
+*  created ::OrtValue instances if the Run succeeded. They must be freed with OrtApi::ReleaseValue.
+* \param[in] num_outputs Number of entries in `outputs`
+* \param[in] status nullptr if the Run succeeded. Otherwise the error, which must be freed with
+*  OrtApi::ReleaseStatus.
+*/
+typedef void(ORT_API_CALL* RunAsyncCallbackFn)(void* user_data, OrtValue** outputs, size_t num_outputs,
+                                                OrtStatusPtr status);
+
 /** \brief Graph optimization level
 *
 * Refer to https://www.onnxruntime.ai/docs/resources/graph-optimizations.html
@@ -308,6 +320,8 @@ typedef enum GraphOptimizationLevel {
 typedef enum ExecutionMode {
   ORT_SEQUENTIAL = 0,
   ORT_PARALLEL = 1,
+  // Parallel execution using per-thread work stealing queues. Nodes on the critical path are run first.
+  ORT_PARALLEL_WORK_STEALING = 2,
 } ExecutionMode;
 
 /** \brief Language projection identifiers
@@ -805,6 +819,7 @@ struct OrtApi {
   *
   * Controls whether you want to execute operators in your graph sequentially or in parallel. Usually when the model
   *  has many branches, setting this option to ExecutionMode.ORT_PARALLEL will give you better performance.
+  *  ExecutionMode.ORT_PARALLEL_WORK_STEALING is an alternative parallel executor that scales better on very wide graphs.
   *  See [docs/ONNX_Runtime_Perf_Tuning.md] for more details.
   *
   * \param[in] options
@@ -2667,6 +2682,10 @@ struct OrtApi {
   *  Only relevant if arena strategy is `kNextPowerOfTwo`. Use -1 to allow ORT to choose the default.
   *  Ultimately, the allocation size is determined by the allocation memory request.
   *  Further allocation sizes are governed by the arena extend strategy.
+  * "max_thread_cache_bytes": Maximum bytes of freed memory each thread may cache for reuse without taking the
+  *  arena lock. Only allocations of up to 64KB are cached. Use 0 to disable the per-thread caches. Default is 0.
+  * "shrink_idle_runs": Number of Run calls after which a memory region of the arena that is entirely free and was
+  *  not allocated from during those calls is returned to the system. Use 0 to disable. Default is 0.
   *
   * \param[in] arena_config_keys Keys to configure the arena
   * \param[in] arena_config_values Values to configure the arena
@@ -3613,6 +3632,75 @@ struct OrtApi {
    */
   ORT_API2_STATUS(UpdateEnvWithCustomLogLevel, _In_ OrtEnv* ort_env, OrtLoggingLevel log_severity_level);
 
+  /** \brief Get statistics of an allocator used by a session
+  *
+  * Supported keys are:
+  * "num_allocs", "num_reserves", "bytes_in_use", "max_bytes_in_use", "max_alloc_size", "bytes_limit" and
+  * "total_allocated_bytes": allocation counters and sizes in bytes.
+  * "num_arena_extensions", "num_arena_shrinkages": number of memory regions added to and released by an arena.
+  * "num_regions": number of memory regions currently held by an arena.
+  * "largest_free_chunk": size of the largest free chunk of an arena. Requests up to this size don't grow the arena.
+  * "num_bins": number of size bins of an arena. 0 for allocators that aren't arena based.
+  * "free_bytes_in_bin_<n>": free bytes in bin n, for n in [0, num_bins). Bin n holds free chunks of at least
+  *  256 << n bytes. Together with "largest_free_chunk" this shows how fragmented the free memory of an arena is.
+  *
+  * \param[in] session
+  * \param[in] mem_info Memory info of the allocator
+  * \param[in] stat_keys Statistics to get
+  * \param[out] stat_values Values of the statistics, in the same order as `stat_keys`
+  * \param[in] num_keys Number of keys in `stat_keys` and `stat_values`
+  *
+  * \snippet{doc} snippets.dox OrtStatus Return Value
+  *
+  * \since Version 1.14.
+  */
+  ORT_API2_STATUS(SessionGetAllocatorStats, _In_ const OrtSession* session, _In_ const OrtMemoryInfo* mem_info,
+                  _In_reads_(num_keys) const char* const* stat_keys, _Out_writes_all_(num_keys) int64_t* stat_values,
+                  _In_ size_t num_keys);
+
+  /** \brief Run the model asynchronously
+  *
+  * Queues the Run on a thread pool of the session and returns without waiting for it, so a few threads can keep many
+  * requests in flight. The pool is created on the first call and is configured with the inter-op thread options,
+  * e.g. OrtApi::SetInterOpNumThreads. The kernels of the Run still use the intra-op thread pool.
+  * `run_async_callback` is invoked from the thread pool when the Run completes. It is invoked from the calling thread
+  * before RunAsync returns if the inter-op options ask for a single thread or the thread pool can't queue more work.
+  *
+  * The Run can be cancelled with OrtApi::RunOptionsSetTerminate on `run_options`, in which case the callback
+  * receives an error status. The session waits for the queued runs to complete when it is released.
+  *
+  * The session no longer uses the inputs, `run_options` or the session itself when the callback is invoked.
+  * The callback may:
+  *  - Release the session with OrtApi::ReleaseSession. The release still waits for the other queued runs.
+  *  - Start new runs on the session with OrtApi::Run or OrtApi::RunAsync.
+  *
+  * The callback must not wait for the callback of another RunAsync call on the same session: it occupies a thread
+  * of the pool that the other run may need.
+  *
+  * \param[in] session
+  * \param[in] run_options If nullptr, default options are used. Must stay valid until the callback is invoked.
+  * \param[in] input_names Array of null terminated UTF8 encoded strings of the input names
+  * \param[in] input Array of ::OrtValue%s of the input values
+  * \param[in] input_len Number of elements in the input_names and inputs arrays
+  * \param[in] output_names Array of null terminated UTF8 encoded strings of the output names
+  * \param[in] output_names_len Number of elements in the output_names and outputs array
+  * \param[in,out] output Array of ::OrtValue%s that the outputs are stored in. Entries can be pre-allocated
+  *  ::OrtValue%s or nullptr to have them allocated. The array must stay valid until the callback is invoked and is
+  *  passed to it.
+  * \param[in] run_async_callback Callback invoked when the Run completes
+  * \param[in] user_data Passed to the callback
+  *
+  * \snippet{doc} snippets.dox OrtStatus Return Value
+  *
+  * \since Version 1.14.
+  */
+  ORT_API2_STATUS(RunAsync, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                  _In_reads_(input_len) const char* const* input_names,
+                  _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                  _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                  _Inout_updates_all_(output_names_len) OrtValue** output,
+                  _In_ RunAsyncCallbackFn run_async_callback, _In_opt_ void* user_data);
+
 #ifdef __cplusplus
   OrtApi(const OrtApi&)=delete; // Prevent users from accidentally copying the API structure, it should always be passed as a pointer
 #endif
@@ -646,6 +646,24 @@ struct SessionImpl : ConstSessionImpl<T> {
 
   void Run(const RunOptions& run_options, const IoBinding&);  ///< Wraps OrtApi::RunWithBinding
 
+  /** \brief Run the model asynchronously. Wraps OrtApi::RunAsync
+   *
+   * \param[in] run_options Must stay valid until the callback is invoked
+   * \param[in] input_names Array of null terminated UTF8 encoded strings of the input names
+   * \param[in] input_values Array of Value objects of length input_count
+   * \param[in] input_count Number of elements in the input_names and inputs arrays
+   * \param[in] output_names Array of null terminated UTF8 encoded strings of the output names
+   * \param[out] output_values Array of provided Values to be filled with outputs.
+   *             On calling RunAsync, Value objects can be default constructed, in which case they are filled
+   *             with the allocated outputs. The array must stay valid until the callback is invoked.
+   * \param[in] output_count Number of elements in the output_names and outputs array
+   * \param[in] callback Invoked with `user_data`, the outputs and the status when the Run completes
+   * \param[in] user_data Passed to the callback
+   */
+  void RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values,
+                size_t input_count, const char* const* output_names, Value* output_values, size_t output_count,
+                RunAsyncCallbackFn callback, void* user_data);
+
   /** \brief End profiling and return a copy of the profiling file name.
    *
    * \param allocator to allocate memory for the copy of the string returned
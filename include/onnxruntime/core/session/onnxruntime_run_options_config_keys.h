@@ -25,3 +25,8 @@
 // Example usage: "cpu:0;gpu:0" (or) "gpu:0"
 // By default, the value for this key is empty (i.e.) no memory arenas are shrunk
 static const char* const kOrtRunOptionsConfigEnableMemoryArenaShrinkage = "memory.enable_memory_arena_shrinkage";
+
+// "1": this Run is not coalesced with concurrent Run calls when dynamic batching is enabled for the session, e.g. for
+// latency sensitive requests. See kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize.
+// "0": the Run may be batched. The default.
+static const char* const kOrtRunOptionsConfigDisableDynamicBatching = "session.disable_dynamic_batching";
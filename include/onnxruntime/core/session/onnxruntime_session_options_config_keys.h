@@ -61,6 +61,11 @@ static const char* const kOrtSessionOptionsEnableQuantQDQCleanup = "session.enab
 // GeluApproximation has side effects which may change the inference results. It is disabled by default due to this.
 static const char* const kOrtSessionOptionsEnableGeluApproximation = "optimization.enable_gelu_approximation";
 
+// Enable or disable the fusion of connected elementwise nodes (Add, Sub, Mul, Div, Relu, Sigmoid, Erf and Where) on
+// float tensors into FusedElementwise nodes for the CPU execution provider. "0": disable; "1": enable.
+// The default is "0".
+static const char* const kOrtSessionOptionsEnableElementwiseFusion = "optimization.enable_elementwise_fusion";
+
 #ifdef ENABLE_TRAINING
 // Specifies a list of op types for memory footprint reduction.
 // The value should be a ","-delimited list of pair of
@@ -158,3 +163,89 @@ static const char* const kOrtSessionOptionsConfigForceSpinningStop = "session.fo
 // "0": in some cases warnings will be logged but processing will continue. The default.
 // May be useful to expose bugs in models.
 static const char* const kOrtSessionOptionsConfigStrictShapeTypeInference = "session.strict_shape_type_inference";
+
+// Controls how input shapes are matched against cached memory patterns when memory pattern optimization is enabled.
+// "exact": a memory pattern is only reused for the exact same input shapes. The default.
+// "pow2": every input dimension is rounded up to the next power of two, so requests with varying dims
+// (e.g. sequence length) reuse the memory pattern planned for their bucket.
+static const char* const kOrtSessionOptionsConfigMemoryPatternBucketPolicy = "session.memory_pattern_bucket_policy";
+
+// Maximum number of memory patterns cached per graph. The least recently used pattern is evicted once the limit
+// is reached. "0" means unbounded. The default is "0".
+static const char* const kOrtSessionOptionsConfigMemoryPatternCacheCapacity = "session.memory_pattern_cache_capacity";
+
+// "1": for graphs where the shape of every activation is known statically (e.g. after free dimension overrides),
+// plan the offsets of all activations at session initialization and place them in a buffer that is allocated once
+// and reused by every Run, instead of tracing a memory pattern on the first Run. Requires memory pattern optimization
+// and sequential execution mode. Graphs with dynamic activation shapes fall back to traced memory patterns.
+// "0": disabled. The default.
+static const char* const kOrtSessionOptionsConfigEnableStaticMemoryPlanning = "session.enable_static_memory_planning";
+
+// "1": intermediate values of each Run on CPU are carved from a per-Run region arena, which takes fixed size chunks
+// from a pool shared by the session and returns them all at once when the Run completes. Graph outputs are still
+// allocated from the session's allocator. This avoids contention on the shared arena when many threads call Run on
+// the same session concurrently, at the cost of not reusing memory freed in the middle of a Run.
+// "0": disabled. The default.
+static const char* const kOrtSessionOptionsConfigUseRegionArena = "session.use_per_run_region_arena";
+
+// Size in bytes of the chunks used by the per-Run region arena. Allocations larger than a quarter of this size go to
+// the session's allocator directly. Must be a multiple of 256. The default is "4194304" (4MB).
+static const char* const kOrtSessionOptionsConfigRegionArenaChunkSize = "session.per_run_region_arena_chunk_size";
+
+// Maximum number of samples in a dynamic batch. With a value larger than "1", concurrent Run calls with the same
+// input and output names, input element types and input shapes apart from the first dimension are concatenated
+// along the first dimension and executed by a single Run. Each caller gets its rows of the batched outputs without
+// a copy. Only applies to models where every graph input and output has the batch as its first dimension, and to
+// Run calls with CPU tensor inputs and no pre-allocated outputs or RunOptions config entries.
+// "0": disabled. The default.
+static const char* const kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize = "session.dynamic_batching.max_batch_size";
+
+// Maximum time in microseconds the first request of a dynamic batch waits for other requests to join before the
+// batch runs. The default is "1000".
+static const char* const kOrtSessionOptionsConfigDynamicBatchingMaxWaitMicros = "session.dynamic_batching.max_wait_us";
+
+// "1": in sequential execution mode, run the graph with an executor that resolves the kernels and the values to
+// release after each node once at session initialization and executes them in a tight loop, skipping the
+// per-node profiling, logging and fence checks of the default executor. Intended for models with many cheap nodes
+// where the executor overhead is significant. The default executor is still used when profiling is enabled, when
+// only the path to the fetches is executed, or when the graph needs fences.
+// "0": disabled. The default.
+static const char* const kOrtSessionOptionsConfigUseFastSequentialExecutor = "session.use_fast_sequential_executor";
+
+// ';' separated names of graph inputs whose values repeat between Runs, e.g. user features in a recommendation
+// model. In sequential execution mode the outputs of the nodes that only depend on these inputs and constant
+// initializers are cached in CPU memory, keyed by a hash of the inputs, and reused when a Run is fed the same
+// values. Only Runs without preallocated outputs use the cache. The default is "", which disables the cache.
+static const char* const kOrtSessionOptionsConfigCacheableInputs = "session.subgraph_cache.cacheable_inputs";
+
+// Memory budget in bytes of the cache enabled by kOrtSessionOptionsConfigCacheableInputs. The least recently used
+// entries are evicted to stay within it. The default is "67108864" (64 MB).
+static const char* const kOrtSessionOptionsConfigSubgraphCacheBudgetBytes = "session.subgraph_cache.budget_bytes";
+
+// "1": the CPU MatMul and FusedMatMul kernels with constant float weights store the weights in bfloat16 when they are
+// prepacked, which halves their memory footprint and bandwidth. The activations stay in float and the products are
+// accumulated in float, so only the weights lose precision: they are rounded to 8 significant bits.
+// "0": disabled. The default.
+static const char* const kOrtSessionOptionsConfigMlasGemmBf16Weights = "mlas.gemm.use_bf16_weights";
+
+// "1": the CPU MatMul kernel tunes the thread partition of its float multiplications. The first Run with a new shape
+// times the default partition of MLAS against a set of splits of the rows and columns between threads and records the
+// fastest in MLAS, where later multiplications with the same shape reuse it. That Run is slower while it tunes.
+// "0": disabled. The default.
+static const char* const kOrtSessionOptionsConfigMlasGemmTuneThreadPartition = "mlas.gemm.tune_thread_partition";
+
+// Directory of a persistent cache of optimized models. The cache key is a hash of the model bytes, the session options,
+// the execution providers and the CPU features. On a miss the session saves the graph it optimized as an ORT format
+// model in the directory, together with the weights its CPU kernels pre-packed. On a hit the session loads that model
+// instead of optimizing the graph again and maps the pre-packed weights into memory instead of packing them.
+// External data files of the model are not part of the key, so change the model file when they change.
+// "": disabled. The default.
+static const char* const kOrtSessionOptionsConfigOptimizedModelCacheDir = "session.optimized_model_cache_dir";
+
+// "1": the tensors of CPU initializers whose data is stored in an external file are created directly on a private
+// mapping of that file. No session memory is planned or allocated for them, and processes loading the same model share
+// the physical pages through the page cache. A page is only copied if it is written to. Data that is not aligned to
+// the size of its element type is copied into session memory instead.
+// "0": disabled. The default.
+static const char* const kOrtSessionOptionsConfigUseMmapForExternalInitializers =
+    "session.use_mmap_for_external_initializers";
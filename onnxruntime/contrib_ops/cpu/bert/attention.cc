@@ -55,7 +55,8 @@ ONNX_OPERATOR_TYPED_KERNEL_EX(
     float,
     kCpuExecutionProvider,
     KernelDefBuilder()
-        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("U", {DataTypeImpl::GetTensorType<float>(), DataTypeImpl::GetTensorType<uint8_t>()}),
     Attention<float>);
 
 template <typename T>
@@ -203,6 +204,9 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
   const Tensor* key = context->Input<Tensor>(6);
   const Tensor* value = context->Input<Tensor>(7);
 
+  const Tensor* past_seq_len = context->Input<Tensor>(8);
+  const Tensor* cache_indirection = context->Input<Tensor>(9);
+
   const TensorShape& weights_shape = (weights ? weights->Shape() : weight_shape_);
 
   AttentionParameters parameters;
@@ -214,7 +218,29 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
                                   extra_add_qk,
                                   key,
                                   value,
-                                  &parameters));
+                                  &parameters,
+                                  past_seq_len));
+
+  const int32_t* cache_indirection_data = nullptr;
+  if (cache_indirection != nullptr) {
+    ORT_RETURN_IF(past_seq_len == nullptr, "Input 'cache_indirection' requires input 'past_sequence_length'");
+
+    const auto& past_dims = past->Shape().GetDims();
+    const auto& cache_indirection_dims = cache_indirection->Shape().GetDims();
+    ORT_RETURN_IF(cache_indirection_dims.size() != 2 || cache_indirection_dims[0] != past_dims[1] ||
+                      cache_indirection_dims[1] != past_dims[3],
+                  "Input 'cache_indirection' shall have shape (batch_size, max_sequence_length)");
+
+    // The indirection of the valid rows shall point to a batch of the past state.
+    cache_indirection_data = cache_indirection->Data<int32_t>();
+    for (int64_t b = 0; b < past_dims[1]; b++) {
+      for (int t = 0; t < parameters.past_sequence_length; t++) {
+        const int32_t index = cache_indirection_data[b * past_dims[3] + t];
+        ORT_RETURN_IF(index < 0 || index >= past_dims[1], "Input 'cache_indirection' has invalid batch index ",
+                      index);
+      }
+    }
+  }
 
   const int batch_size = parameters.batch_size;
   const int sequence_length = parameters.sequence_length;
@@ -333,6 +359,12 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
   }
 
   // Compute the attention score and apply the score to V
+  if (past_seq_len != nullptr) {
+    return ApplySharedBufferAttention(Q, K, V, mask_index, past, cache_indirection_data, output,
+                                      batch_size, sequence_length, parameters.past_sequence_length,
+                                      parameters.head_size, parameters.v_hidden_size, context);
+  }
+
   return ApplyAttention(Q, K, V, mask_index, past, output,
                         batch_size, sequence_length,
                         parameters.head_size, parameters.v_head_size, parameters.v_hidden_size,
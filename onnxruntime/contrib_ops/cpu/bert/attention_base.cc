@@ -14,13 +14,14 @@ Status AttentionBase::CheckInputs(const TensorShape& input_shape,
                                   const Tensor* extra_add_qk,
                                   const Tensor* key,
                                   const Tensor* value,
-                                  void* parameters) const {
+                                  void* parameters,
+                                  const Tensor* past_seq_len) const {
   // Abbreviation and Meanings:
   //   B:    batch_size
   //   S:    sequence_length (input sequence length of query)
   //   P:    past_sequence_length (past sequence length of key or value)
   //   L:    kv_sequence_length (input sequence length of key or value)
-  //   M:    max_sequence_length
+  //   M:    max_sequence_length (of mask_index, or of past and present state that share a buffer)
   //   T:    total_sequence_length = past_sequence_length + kv_sequence_length
   //   N:    num_heads
   //   H:    head size for Q and K, aka q_head_size or v_head_size or qk_head_size
@@ -51,6 +52,9 @@ Status AttentionBase::CheckInputs(const TensorShape& input_shape,
   //   key           (K)       : (B, L, D)
   //   value         (V)       : (B, L, D_v)
 
+  // When past_seq_len is given, past and present state share a buffer with shape (2, B, N, M, H), and only
+  // the first P rows of past are valid.
+
   // For mask_index, the following shapes are supported:
   //     NULL, (B, 1), (1, 1)
   //     (B), (2 * B),
@@ -218,12 +222,36 @@ Status AttentionBase::CheckInputs(const TensorShape& input_shape,
                              "Inputs 'past' dimension 2 shall have length of num_heads", num_heads_);
     }
 
-    if (static_cast<int>(past_dims[4]) != k_hidden_size / num_heads_) {
+    const int64_t past_head_size = past->IsDataType<uint8_t>()
+                                       ? k_hidden_size / num_heads_ + kQuantizedStateScaleSize
+                                       : k_hidden_size / num_heads_;
+    if (past_dims[4] != past_head_size) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
-                             "Inputs 'past' dimension 2 shall have length of ", k_hidden_size / num_heads_);
+                             "Inputs 'past' dimension 4 shall have length of ", past_head_size);
     }
 
-    past_sequence_length = past_dims[3];
+    if (past_seq_len == nullptr) {
+      past_sequence_length = past_dims[3];
+    } else {
+      if (past->IsDataType<uint8_t>()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Input 'past_sequence_length' is not supported with quantized past state");
+      }
+
+      if (past_seq_len->Shape().Size() != 1) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Input 'past_sequence_length' is expected to have one element");
+      }
+
+      past_sequence_length = *past_seq_len->Data<int32_t>();
+      if (past_sequence_length < 0 || past_sequence_length + kv_sequence_length > past_dims[3]) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Input 'past_sequence_length' plus kv_sequence_length shall be in the range of "
+                               "past dimension 3, got ", past_sequence_length);
+      }
+    }
+  } else if (past_seq_len != nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'past_sequence_length' requires input 'past'");
   }
 
   int64_t total_sequence_length = kv_sequence_length + past_sequence_length;
@@ -373,9 +401,13 @@ Tensor* AttentionBase::GetPresent(OpKernelContext* context,
   // Input and output shapes:
   //   past        : (2, batch_size, num_heads, past_sequence_length, head_size)
   //   present     : (2, batch_size, num_heads, past_sequence_length + kv_sequence_length, head_size)
+  // The rows of a quantized state are followed by their scales, see kQuantizedStateScaleSize.
 
   past_sequence_length = (nullptr != past) ? static_cast<int>(past->Shape().GetDims()[3]) : 0;
-  std::array<int64_t, 5> present_dims{2, batch_size, num_heads_, static_cast<int64_t>(kv_sequence_length) + past_sequence_length, head_size};
+  const int64_t present_head_size = (nullptr != past && past->IsDataType<uint8_t>())
+                                        ? static_cast<int64_t>(head_size) + kQuantizedStateScaleSize
+                                        : head_size;
+  std::array<int64_t, 5> present_dims{2, batch_size, num_heads_, static_cast<int64_t>(kv_sequence_length) + past_sequence_length, present_head_size};
 
   TensorShape present_shape(present_dims);
   Tensor* present = context->Output(1, present_shape);
@@ -63,7 +63,8 @@ class AttentionBase {
                      const Tensor* extra_add_qk,
                      const Tensor* key,
                      const Tensor* value,
-                     void* parameters) const;
+                     void* parameters,
+                     const Tensor* past_seq_len = nullptr) const;
 
   int num_heads_;                          // number of attention heads
   bool is_unidirectional_;                 // whether every token can only attend to previous tokens.
@@ -22,5 +22,10 @@ struct AttentionParameters {
   bool is_unidirectional;
 };
 
+// A quantized past or present state has uint8 type. Each row of head_size values of K or V is quantized
+// symmetrically with a zero point of 128, and followed by the float scale of the row. So the last dimension
+// of the state is head_size + kQuantizedStateScaleSize.
+constexpr int kQuantizedStateScaleSize = sizeof(float);
+
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -9,10 +9,19 @@
 #include "core/common/common.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel.h"
+#include "core/util/qmath.h"
 
 namespace onnxruntime {
 namespace contrib {
 
+// Total sequence length from which the tiled attention is used without a causal mask. Shorter sequences
+// are faster with the materialized attention probabilities, and need little memory for them.
+constexpr int kTiledAttentionMinimumSequenceLength = 1024;
+
+// Average number of rows held by the same chunk of a shared past and present state buffer, below which the rows of
+// a head are gathered for the attention, since a GEMM per run of rows has a high overhead.
+constexpr size_t kSharedBufferMinimumRunLength = 16;
+
 class AttentionCPUBase : public AttentionBase {
  protected:
   AttentionCPUBase(const OpKernelInfo& info, bool require_same_hidden_size, bool require_weights)
@@ -45,13 +54,33 @@ class AttentionCPUBase : public AttentionBase {
     // Total sequence length including that of past state: T = P + L
     const int total_sequence_length = past_sequence_length + kv_sequence_length;
 
+    bool has_unidirectional = (is_unidirectional_ && sequence_length > 1);
+
+    if constexpr (std::is_same<T, float>::value) {
+      if (past != nullptr && past->IsDataType<uint8_t>()) {
+        return ApplyQuantizedStateAttention(Q, K, V, mask_index, past, present, output,
+                                            batch_size, sequence_length, past_sequence_length,
+                                            v_head_size, v_hidden_size, has_unidirectional,
+                                            extra_add_qk != nullptr ? extra_add_qk->Data<float>() : nullptr,
+                                            allocator, tp);
+      }
+
+      // The tiled attention applies a mask that reduces to a bias per key (1D or 2D mask index).
+      if (extra_add_qk == nullptr &&
+          (mask_index == nullptr || mask_index->Shape().NumDimensions() <= 2) &&
+          (has_unidirectional || total_sequence_length >= kTiledAttentionMinimumSequenceLength)) {
+        return ApplyTiledAttention(Q, K, V, mask_index, past, present, output,
+                                   batch_size, sequence_length, past_sequence_length,
+                                   qk_head_size == 0 ? v_head_size : qk_head_size, v_head_size,
+                                   has_unidirectional, allocator, tp);
+      }
+    }
+
     // Compute the attention score.
     size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * total_sequence_length * sizeof(T);
     auto attention_probs = allocator->Alloc(bytes);
     BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
 
-    bool has_unidirectional = (is_unidirectional_ && sequence_length > 1);
-
     void* mask_data = nullptr;
     if (mask_index != nullptr || has_unidirectional) {
       size_t mask_data_bytes = SafeInt<size_t>(batch_size) * sequence_length * total_sequence_length * sizeof(T);
@@ -92,7 +121,455 @@ class AttentionCPUBase : public AttentionBase {
     return Status::OK();
   }
 
+  // Computes the attention with past and present state that share a buffer of max sequence length M with shape
+  // (2, B, N, M, H). The first P rows of each chunk are valid, and the current K and V are written to the rows
+  // from P in place, so the state is not concatenated. The optional cache indirection with shape BxM has the
+  // batch index of the chunk that holds each past row. Each run of consecutive rows held by the same chunk is
+  // multiplied by a GEMM in place, or the rows are gathered when the runs are short, so beam search reorders
+  // beams without copying the state.
+  Status ApplySharedBufferAttention(const float* Q,                     // Q data with shape BxNxSxH
+                                    const float* K,                     // K data with shape BxNxSxH
+                                    const float* V,                     // V value with shape BxNxSxH
+                                    const Tensor* mask_index,           // mask index. nullptr if no mask
+                                    const Tensor* past,                 // past state with shape 2xBxNxMxH
+                                    const int32_t* cache_indirection,   // cache indirection. nullptr if not used
+                                    Tensor* output,                     // output tensor with shape BxSxNxH
+                                    int batch_size,                     // batch size (B)
+                                    int sequence_length,                // sequence length (S)
+                                    int past_sequence_length,           // valid sequence length of past state (P)
+                                    int head_size,                      // head size of Q, K and V (H)
+                                    int hidden_size,                    // hidden size of V (D)
+                                    OpKernelContext* context) const {
+    AllocatorPtr allocator;
+    ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+    auto* tp = context->GetOperatorThreadPool();
+
+    Tensor* present = context->Output(1, past->Shape());
+    ORT_RETURN_IF(present == nullptr, "Expect to have present state output when past state input is given");
+
+    const size_t S = static_cast<size_t>(sequence_length);
+    const size_t P = static_cast<size_t>(past_sequence_length);
+    const size_t T = P + S;
+    const size_t M = static_cast<size_t>(past->Shape()[3]);
+    const size_t H = static_cast<size_t>(head_size);
+    const size_t chunk_size = M * H;
+    const size_t loop_len = SafeInt<size_t>(batch_size) * num_heads_;
+
+    // The present state is usually bound to the buffer of the past state, otherwise it starts as a copy.
+    float* present_data = present->MutableData<float>();
+    if (present_data != past->Data<float>()) {
+      memcpy(present_data, past->Data<float>(), past->SizeInBytes());
+    }
+    float* output_data = output->MutableData<float>();
+
+    bool has_unidirectional = (is_unidirectional_ && sequence_length > 1);
+
+    // mask_data is nullptr when mask_index is nullptr and not unidirectional, otherwise its shape is BxSxT
+    void* mask_data = nullptr;
+    if (mask_index != nullptr || has_unidirectional) {
+      size_t mask_data_bytes = SafeInt<size_t>(batch_size) * S * T * sizeof(float);
+      mask_data = allocator->Alloc(mask_data_bytes);
+      memset(mask_data, 0, mask_data_bytes);
+      PrepareMask(mask_index != nullptr ? mask_index->Data<int32_t>() : nullptr,
+                  mask_index != nullptr ? mask_index->Shape().GetDims() : gsl::span<const int64_t>{},
+                  static_cast<float*>(mask_data), has_unidirectional, batch_size, sequence_length,
+                  past_sequence_length);
+    }
+    BufferUniquePtr mask_data_buffer(mask_data, BufferDeleter(allocator));
+    const float* mask = static_cast<const float*>(mask_data);
+
+    const float alpha = 1.0f / sqrt(static_cast<float>(head_size));
+
+    const double cost = static_cast<double>(S) * static_cast<double>(T) * static_cast<double>(H) * 2.0;
+
+    ThreadPool::TryParallelFor(tp, static_cast<std::ptrdiff_t>(loop_len), cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      // Working buffers of a head: probs (SxT), and gathered rows of K and V (TxH each)
+      void* scratch = allocator->Alloc((S * T + 2 * T * H) * sizeof(float));
+      BufferUniquePtr scratch_buffer(scratch, BufferDeleter(allocator));
+      float* probs = static_cast<float*>(scratch);
+      float* k_rows = probs + S * T;
+      float* v_rows = k_rows + T * H;
+
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const size_t head = static_cast<size_t>(i);
+        const size_t batch_index = head / num_heads_;
+        const size_t head_index = head % num_heads_;
+
+        // Write current K and V after the valid rows: (BxNx)SxH -> (BxNx)MxH. Other heads only read the rows
+        // before P of this chunk.
+        memcpy(present_data + head * chunk_size + P * H, K + head * S * H, S * H * sizeof(float));
+        memcpy(present_data + (loop_len + head) * chunk_size + P * H, V + head * S * H, S * H * sizeof(float));
+
+        // Returns the batch index of the chunk that holds row t, and the end of the run of rows held by it.
+        const int32_t* indirection = cache_indirection != nullptr ? cache_indirection + batch_index * M : nullptr;
+        auto next_run = [&](size_t t, size_t& run_end) {
+          size_t chunk_batch_index = batch_index;
+          run_end = T;
+          if (indirection != nullptr && t < P) {
+            chunk_batch_index = static_cast<size_t>(indirection[t]);
+            run_end = t + 1;
+            while (run_end < P && indirection[run_end] == indirection[t]) {
+              run_end++;
+            }
+            if (run_end == P && chunk_batch_index == batch_index) {
+              run_end = T;
+            }
+          }
+          return chunk_batch_index * num_heads_ + head_index;
+        };
+
+        size_t run_count = 0;
+        for (size_t t = 0, run_end = 0; t < T; t = run_end) {
+          next_run(t, run_end);
+          run_count++;
+        }
+
+        const float* gathered_k = nullptr;
+        const float* gathered_v = nullptr;
+        if (run_count > 1 && T < run_count * kSharedBufferMinimumRunLength) {
+          for (size_t t = 0, run_end = 0; t < T; t = run_end) {
+            const size_t chunk = next_run(t, run_end);
+            memcpy(k_rows + t * H, present_data + chunk * chunk_size + t * H, (run_end - t) * H * sizeof(float));
+            memcpy(v_rows + t * H, present_data + (loop_len + chunk) * chunk_size + t * H,
+                   (run_end - t) * H * sizeof(float));
+          }
+          gathered_k = k_rows;
+          gathered_v = v_rows;
+        }
+
+        // Returns the rows of K or V of the run from row t.
+        auto key_run = [&](size_t t, size_t& run_end) -> const float* {
+          if (gathered_k != nullptr) {
+            run_end = T;
+            return gathered_k + t * H;
+          }
+          return present_data + next_run(t, run_end) * chunk_size + t * H;
+        };
+        auto value_run = [&](size_t t, size_t& run_end) -> const float* {
+          if (gathered_v != nullptr) {
+            run_end = T;
+            return gathered_v + t * H;
+          }
+          return present_data + (loop_len + next_run(t, run_end)) * chunk_size + t * H;
+        };
+
+        // Compute Q*K' + AttentionMask
+        if (mask != nullptr) {
+          memcpy(probs, mask + batch_index * S * T, S * T * sizeof(float));
+        } else {
+          memset(probs, 0, S * T * sizeof(float));
+        }
+
+        const float* q = Q + head * S * H;
+        for (size_t t = 0, run_end = 0; t < T; t = run_end) {
+          const float* k = key_run(t, run_end);
+          MlasGemm(CblasNoTrans, CblasTrans, S, run_end - t, H, alpha, q, H, k, H, 1.0f, probs + t, T, nullptr);
+        }
+
+        // Fix unidirectional mask to be parity with huggingface implementation.
+        if (has_unidirectional) {
+          for (size_t s = 0; s + 1 < S; s++) {
+            for (size_t t = P + s + 1; t < T; t++) {
+              probs[s * T + t] = mask[batch_index * S * T + s * T + t];
+            }
+          }
+        }
+
+        MlasComputeSoftmax(probs, probs, S, T, false, nullptr);
+
+        // Compute the attention probs x V, and transpose it: (BxNx)SxH -> (Bx)Sx(N)xH
+        float* dest = output_data + batch_index * S * hidden_size + head_index * H;
+        for (size_t t = 0, run_end = 0; t < T; t = run_end) {
+          const float* v = value_run(t, run_end);
+          MlasGemm(CblasNoTrans, CblasNoTrans, S, H, run_end - t, 1.0f, probs + t, T, v, H, t == 0 ? 0.0f : 1.0f,
+                   dest, hidden_size, nullptr);
+        }
+      }
+    });
+
+    return Status::OK();
+  }
+
  private:
+  // Computes the attention without materializing the attention probabilities of shape BxNxSxT.
+  // MlasFlashAttention streams blocks of K and V through an online softmax, so the memory is linear
+  // in the sequence length. The mask index is converted to a bias per key with shape BxT.
+  Status ApplyTiledAttention(const float* Q,            // Q data with shape BxNxSxH
+                             const float* K,            // K data with shape BxNxLxH
+                             const float* V,            // V value with shape BxNxLxH_v
+                             const Tensor* mask_index,  // 1D or 2D mask index. nullptr if no mask
+                             const Tensor* past,        // past state
+                             Tensor* present,           // present state
+                             Tensor* output,            // output tensor with shape BxSxNxH_v
+                             int batch_size,            // batch size (B)
+                             int sequence_length,       // sequence length (S)
+                             int past_sequence_length,  // sequence length of past state (P)
+                             int qk_head_size,          // head size of Q or K (H)
+                             int v_head_size,           // head size of V (H_v)
+                             bool has_unidirectional,   // has unidirectional mask
+                             AllocatorPtr allocator,    // allocator for the temporary buffers
+                             ThreadPool* tp) const {
+    const int total_sequence_length = past_sequence_length + sequence_length;  // T = P + L
+
+    const float* k = K;
+    const float* v = V;
+
+    if (present != nullptr) {
+      // Concatenate past and current K and V: (BxNx)PxH, (BxNx)LxH -> (BxNx)TxH
+      const float* past_data = past != nullptr ? past->Data<float>() : nullptr;
+      float* present_data = present->MutableData<float>();
+
+      const ptrdiff_t loop_len = SafeInt<ptrdiff_t>(batch_size) * num_heads_;
+      const size_t past_k_chunk_length = static_cast<size_t>(past_sequence_length) * qk_head_size;
+      const size_t present_k_chunk_length = static_cast<size_t>(total_sequence_length) * qk_head_size;
+      const size_t past_v_chunk_length = static_cast<size_t>(past_sequence_length) * v_head_size;
+      const size_t present_v_chunk_length = static_cast<size_t>(total_sequence_length) * v_head_size;
+
+      const float* past_v = past_data != nullptr ? past_data + loop_len * past_v_chunk_length : nullptr;
+      float* present_v = present_data + loop_len * present_v_chunk_length;
+
+      const double cost = static_cast<double>(total_sequence_length) * (qk_head_size + v_head_size);
+
+      ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = begin; i != end; ++i) {
+          ConcatStateChunk(past_data, K + (present_k_chunk_length - past_k_chunk_length) * i, present_data,
+                           past_k_chunk_length, present_k_chunk_length, i);
+          ConcatStateChunk(past_v, V + (present_v_chunk_length - past_v_chunk_length) * i, present_v,
+                           past_v_chunk_length, present_v_chunk_length, i);
+        }
+      });
+
+      k = present_data;
+      v = present_v;
+    }
+
+    // Convert the mask index to a bias per key, which is the first row of the BxSxT mask.
+    void* key_bias = nullptr;
+    if (mask_index != nullptr) {
+      size_t key_bias_bytes = SafeInt<size_t>(batch_size) * total_sequence_length * sizeof(float);
+      key_bias = allocator->Alloc(key_bias_bytes);
+      memset(key_bias, 0, key_bias_bytes);
+      PrepareMask(mask_index->Data<int32_t>(), mask_index->Shape().GetDims(), static_cast<float*>(key_bias),
+                  false, batch_size, 1, total_sequence_length - 1);
+    }
+    BufferUniquePtr key_bias_buffer(key_bias, BufferDeleter(allocator));
+
+    // The scores hidden by the unidirectional mask are replaced by the mask value plus the key bias,
+    // for parity with the materialized attention probabilities.
+    MLAS_FLASH_ATTENTION_PARAMETERS parameters;
+    size_t working_buffer_size;
+    MlasFlashAttentionPrepare(&parameters, batch_size, num_heads_, sequence_length, total_sequence_length,
+                              qk_head_size, v_head_size, 1.0f / sqrt(static_cast<float>(qk_head_size)),
+                              has_unidirectional, -10000.0f, &working_buffer_size, tp);
+
+    auto working_buffer = allocator->Alloc(SafeInt<size_t>(working_buffer_size) * sizeof(float));
+    BufferUniquePtr working_buffer_holder(working_buffer, BufferDeleter(std::move(allocator)));
+
+    MlasFlashAttention(&parameters, Q, k, v, static_cast<const float*>(key_bias),
+                       static_cast<float*>(working_buffer), output->MutableData<float>(), tp);
+
+    return Status::OK();
+  }
+
+  // Computes the attention with a quantized past and present state, which takes about a quarter of the memory
+  // of a float state. The new rows of K and V are quantized into the present state, and the quantized GEMM reads
+  // the present state directly:
+  //   scores(T, S) = K(T, H) x Q'(H, S), where each row of Q is quantized with its own scale and zero point
+  //   output(S, H) = probs'(S, T) x V(T, H), where probs' are the attention probabilities multiplied by the
+  //                  scales of the V rows, and quantized per row
+  // K is the left operand of the first GEMM since the quantized GEMM does not transpose its right operand.
+  // The past state has the same head size for Q, K and V.
+  Status ApplyQuantizedStateAttention(const float* Q,             // Q data with shape BxNxSxH
+                                      const float* K,             // K data with shape BxNxLxH
+                                      const float* V,             // V value with shape BxNxLxH
+                                      const Tensor* mask_index,   // mask index. nullptr if no mask
+                                      const Tensor* past,         // quantized past state
+                                      Tensor* present,            // quantized present state
+                                      Tensor* output,             // output tensor with shape BxSxNxH
+                                      int batch_size,             // batch size (B)
+                                      int sequence_length,        // sequence length (S)
+                                      int past_sequence_length,   // sequence length of past state (P)
+                                      int head_size,              // head size of Q, K and V (H)
+                                      int hidden_size,            // hidden size of V (D)
+                                      bool has_unidirectional,    // has unidirectional mask
+                                      const float* extra_add_qk,  // extra add in QK with shape BxNxSxT, or nullptr
+                                      AllocatorPtr allocator,     // allocator for the temporary buffers
+                                      ThreadPool* tp) const {
+    const int total_sequence_length = past_sequence_length + sequence_length;  // T = P + L
+    const size_t S = static_cast<size_t>(sequence_length);
+    const size_t T = static_cast<size_t>(total_sequence_length);
+    const size_t H = static_cast<size_t>(head_size);
+    const size_t row_size = H + kQuantizedStateScaleSize;
+    const size_t past_chunk_size = static_cast<size_t>(past_sequence_length) * row_size;
+    const size_t present_chunk_size = T * row_size;
+    const size_t loop_len = SafeInt<size_t>(batch_size) * num_heads_;
+
+    const uint8_t* past_data = past->Data<uint8_t>();
+    uint8_t* present_data = present->MutableData<uint8_t>();
+    float* output_data = output->MutableData<float>();
+
+    // mask_data is nullptr when mask_index is nullptr and not unidirectional, otherwise its shape is BxSxT
+    void* mask_data = nullptr;
+    if (mask_index != nullptr || has_unidirectional) {
+      size_t mask_data_bytes = SafeInt<size_t>(batch_size) * S * T * sizeof(float);
+      mask_data = allocator->Alloc(mask_data_bytes);
+      memset(mask_data, 0, mask_data_bytes);
+      PrepareMask(mask_index != nullptr ? mask_index->Data<int32_t>() : nullptr,
+                  mask_index != nullptr ? mask_index->Shape().GetDims() : gsl::span<const int64_t>{},
+                  static_cast<float*>(mask_data), has_unidirectional, batch_size, sequence_length,
+                  past_sequence_length);
+    }
+    BufferUniquePtr mask_data_buffer(mask_data, BufferDeleter(allocator));
+    const float* mask = static_cast<const float*>(mask_data);
+
+    // Working buffers of a head, which are reused by the heads of a thread:
+    //   scores (TxS int32), probs (SxT float), state scales (T float), Q scales (S float),
+    //   probs scales (S float), context (SxH int32), quantized Q (SxH and HxS), Q zero points (S),
+    //   quantized probs (SxT)
+    const size_t scratch_floats = T * S + S * T + T + S + S + S * H;
+    const size_t scratch_bytes = scratch_floats * sizeof(float) + 2 * S * H + S + S * T;
+
+    const float alpha = 1.0f / sqrt(static_cast<float>(head_size));
+    const uint8_t state_zero_point = 128;
+
+    const double cost = static_cast<double>(S) * static_cast<double>(T) * static_cast<double>(H) * 2.0;
+
+    ThreadPool::TryParallelFor(tp, static_cast<std::ptrdiff_t>(loop_len), cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      void* scratch = allocator->Alloc(scratch_bytes);
+      BufferUniquePtr scratch_buffer(scratch, BufferDeleter(allocator));
+
+      int32_t* scores = static_cast<int32_t*>(scratch);
+      float* probs = reinterpret_cast<float*>(scores + T * S);
+      float* state_scales = probs + S * T;
+      float* q_scales = state_scales + T;
+      float* probs_scales = q_scales + S;
+      int32_t* context = reinterpret_cast<int32_t*>(probs_scales + S);
+      uint8_t* q_rows = reinterpret_cast<uint8_t*>(context + S * H);
+      uint8_t* q_columns = q_rows + S * H;
+      uint8_t* q_zero_points = q_columns + S * H;
+      uint8_t* quantized_probs = q_zero_points + S;
+
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const size_t head = static_cast<size_t>(i);
+        const size_t batch_index = head / num_heads_;
+        const size_t head_index = head % num_heads_;
+
+        // Concatenate past K and V with the quantized rows of current K and V: (BxNx)PxH, (BxNx)LxH -> (BxNx)TxH
+        uint8_t* present_k = present_data + head * present_chunk_size;
+        uint8_t* present_v = present_data + (loop_len + head) * present_chunk_size;
+        if (past_chunk_size > 0) {
+          memcpy(present_k, past_data + head * past_chunk_size, past_chunk_size);
+          memcpy(present_v, past_data + (loop_len + head) * past_chunk_size, past_chunk_size);
+        }
+
+        for (size_t s = 0; s < S; s++) {
+          QuantizeStateRow(K + (head * S + s) * H, present_k + past_chunk_size + s * row_size, H);
+          QuantizeStateRow(V + (head * S + s) * H, present_v + past_chunk_size + s * row_size, H);
+        }
+
+        // Quantize the rows of Q, and transpose them to the columns of the right operand.
+        const float* q = Q + head * S * H;
+        for (size_t s = 0; s < S; s++) {
+          GetQuantizationParameter<uint8_t>(q + s * H, static_cast<int64_t>(H), q_scales[s], q_zero_points[s],
+                                            nullptr);
+          MlasQuantizeLinear(q + s * H, q_rows + s * H, H, q_scales[s], q_zero_points[s]);
+        }
+        for (size_t h = 0; h < H; h++) {
+          for (size_t s = 0; s < S; s++) {
+            q_columns[h * S + s] = q_rows[s * H + h];
+          }
+        }
+
+        MLAS_GEMM_QUANT_SHAPE_PARAMS gemm_shape;
+        gemm_shape.M = T;
+        gemm_shape.N = S;
+        gemm_shape.K = H;
+
+        MLAS_GEMM_QUANT_DATA_PARAMS gemm_params;
+        gemm_params.A = present_k;
+        gemm_params.lda = row_size;
+        gemm_params.ZeroPointA = state_zero_point;
+        gemm_params.B = q_columns;
+        gemm_params.ldb = S;
+        gemm_params.ZeroPointB = q_zero_points;
+        gemm_params.PerColumnZeroPoints = true;
+        gemm_params.C = scores;
+        gemm_params.ldc = S;
+
+        MlasGemm(gemm_shape, gemm_params, nullptr);
+
+        // Scale and transpose the scores, and add the mask and the extra add. The scores hidden by the
+        // unidirectional mask are replaced by the mask value for parity with huggingface implementation.
+        const float* mask_row = mask != nullptr ? mask + batch_index * S * T : nullptr;
+        const float* extra_add_row = extra_add_qk != nullptr ? extra_add_qk + head * S * T : nullptr;
+        for (size_t t = 0; t < T; t++) {
+          const float k_scale = alpha * GetStateRowScale(present_k + t * row_size, H);
+          for (size_t s = 0; s < S; s++) {
+            float score = static_cast<float>(scores[t * S + s]) * k_scale * q_scales[s];
+            if (mask_row != nullptr) {
+              if (has_unidirectional && t > static_cast<size_t>(past_sequence_length) + s) {
+                score = mask_row[s * T + t];
+              } else {
+                score += mask_row[s * T + t];
+              }
+            }
+            if (extra_add_row != nullptr) {
+              score += extra_add_row[s * T + t];
+            }
+            probs[s * T + t] = score;
+          }
+        }
+
+        MlasComputeSoftmax(probs, probs, S, T, false, nullptr);
+
+        // Fold the scales of the V rows into the probabilities, and quantize them per row.
+        for (size_t t = 0; t < T; t++) {
+          state_scales[t] = GetStateRowScale(present_v + t * row_size, H);
+        }
+
+        for (size_t s = 0; s < S; s++) {
+          float* p = probs + s * T;
+          for (size_t t = 0; t < T; t++) {
+            p[t] *= state_scales[t];
+          }
+
+          float min;
+          float max;
+          MlasFindMinMaxElement(p, &min, &max, T);
+          probs_scales[s] = max > 0.0f ? max / 255.0f : 1.0f;
+          MlasQuantizeLinear(p, quantized_probs + s * T, T, probs_scales[s], static_cast<uint8_t>(0));
+        }
+
+        gemm_shape.M = S;
+        gemm_shape.N = H;
+        gemm_shape.K = T;
+
+        gemm_params.A = quantized_probs;
+        gemm_params.lda = T;
+        gemm_params.ZeroPointA = 0;
+        gemm_params.B = present_v;
+        gemm_params.ldb = row_size;
+        gemm_params.ZeroPointB = &state_zero_point;
+        gemm_params.PerColumnZeroPoints = false;
+        gemm_params.C = context;
+        gemm_params.ldc = H;
+
+        MlasGemm(gemm_shape, gemm_params, nullptr);
+
+        // Scale the context, and transpose it: (BxNx)SxH -> (Bx)Sx(N)xH
+        for (size_t s = 0; s < S; s++) {
+          float* dest = output_data + (batch_index * S + s) * hidden_size + head_index * H;
+          for (size_t h = 0; h < H; h++) {
+            dest[h] = static_cast<float>(context[s * H + h]) * probs_scales[s];
+          }
+        }
+      }
+    });
+
+    return Status::OK();
+  }
+
   // Helper function to compute the attention probs. It does 2 things:
   //  attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T) +
   //                                1 x mask_data(B, N, S, T)
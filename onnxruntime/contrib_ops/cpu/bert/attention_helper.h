@@ -172,5 +172,27 @@ T* ConcatStateChunk(const T* past,
   return start;
 }
 
+// Quantize a row of head_size values of K or V into a row of quantized state, which is followed by its scale.
+inline void QuantizeStateRow(const float* input, uint8_t* row, size_t head_size) {
+  float min;
+  float max;
+  MlasFindMinMaxElement(input, &min, &max, head_size);
+
+  float scale = std::max(-min, max) / 127.0f;
+  if (scale == 0.0f) {
+    scale = 1.0f;
+  }
+
+  MlasQuantizeLinear(input, row, head_size, scale, static_cast<uint8_t>(128));
+  memcpy(row + head_size, &scale, sizeof(float));
+}
+
+// Get the scale that follows a row of quantized state. The scale is not aligned.
+inline float GetStateRowScale(const uint8_t* row, size_t head_size) {
+  float scale;
+  memcpy(&scale, row + head_size, sizeof(float));
+  return scale;
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
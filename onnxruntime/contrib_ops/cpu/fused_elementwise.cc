@@ -0,0 +1,350 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/fused_elementwise.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/math/element_wise_ops.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    FusedElementwise,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", {DataTypeImpl::GetTensorType<float>(), DataTypeImpl::GetTensorType<bool>()})
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise);
+
+namespace {
+
+// Number of output elements evaluated at a time. Each intermediate result and each gathered input of a tile takes
+// kTileSize floats, which keeps the working set of typical expressions within the L2 cache.
+constexpr ptrdiff_t kTileSize = 4096;
+
+// An operand of an operation within a tile: either kTileSize contiguous elements or a single repeated element.
+struct Operand {
+  const void* data;
+  bool is_scalar;
+};
+
+// How an input of the node is read for a tile of the output.
+struct InputView {
+  const uint8_t* data;
+  size_t element_size;
+  // The input has one element, or as many elements as the output, in which case it is read in place.
+  bool is_scalar;
+  bool is_full;
+  // Otherwise the broadcast iterator walks the input in runs of span output elements, which are either contiguous in
+  // the input or repeat one element of it.
+  BroadcastIterator iterator;
+  ptrdiff_t span;
+  bool is_repeated;
+};
+
+template <typename T>
+void FillRun(const uint8_t* source, uint8_t* destination, ptrdiff_t count) {
+  std::fill_n(reinterpret_cast<T*>(destination), count, *reinterpret_cast<const T*>(source));
+}
+
+Operand ReadTile(const InputView& view, BroadcastIterator& iterator, ptrdiff_t start, ptrdiff_t count,
+                 uint8_t* gather_buffer) {
+  if (view.is_scalar) {
+    return {view.data, true};
+  }
+
+  if (view.is_full) {
+    return {view.data + start * view.element_size, false};
+  }
+
+  // The tile lies within a single run of the input, so it can be read in place.
+  if (start % view.span + count <= view.span) {
+    const size_t index = iterator.AdvanceBy(static_cast<size_t>(count));
+    return {view.data + index * view.element_size, view.is_repeated};
+  }
+
+  for (ptrdiff_t done = 0; done < count;) {
+    const ptrdiff_t n = std::min(view.span - (start + done) % view.span, count - done);
+    const uint8_t* source = view.data + iterator.AdvanceBy(static_cast<size_t>(n)) * view.element_size;
+    uint8_t* destination = gather_buffer + done * view.element_size;
+    if (!view.is_repeated) {
+      std::memcpy(destination, source, n * view.element_size);
+    } else if (view.element_size == sizeof(float)) {
+      FillRun<float>(source, destination, n);
+    } else {
+      FillRun<bool>(source, destination, n);
+    }
+    done += n;
+  }
+
+  return {gather_buffer, false};
+}
+
+template <typename Fn>
+void ComputeBinary(const Operand& a, const Operand& b, float* result, ptrdiff_t count, Fn fn) {
+  const float* a_data = static_cast<const float*>(a.data);
+  const float* b_data = static_cast<const float*>(b.data);
+  EigenVectorArrayMap<float> y(result, count);
+
+  if (a.is_scalar && b.is_scalar) {
+    y.setConstant(fn(*a_data, *b_data));
+  } else if (a.is_scalar) {
+    y = fn(*a_data, ConstEigenVectorArrayMap<float>(b_data, count));
+  } else if (b.is_scalar) {
+    y = fn(ConstEigenVectorArrayMap<float>(a_data, count), *b_data);
+  } else {
+    y = fn(ConstEigenVectorArrayMap<float>(a_data, count), ConstEigenVectorArrayMap<float>(b_data, count));
+  }
+}
+
+void ComputeWhere(const Operand& condition, const Operand& x, const Operand& y, float* result, ptrdiff_t count) {
+  const bool* condition_data = static_cast<const bool*>(condition.data);
+  const float* x_data = static_cast<const float*>(x.data);
+  const float* y_data = static_cast<const float*>(y.data);
+  const ptrdiff_t condition_step = condition.is_scalar ? 0 : 1;
+  const ptrdiff_t x_step = x.is_scalar ? 0 : 1;
+  const ptrdiff_t y_step = y.is_scalar ? 0 : 1;
+
+  for (ptrdiff_t i = 0; i < count; i++) {
+    result[i] = condition_data[i * condition_step] ? x_data[i * x_step] : y_data[i * y_step];
+  }
+}
+
+}  // namespace
+
+FusedElementwise::FusedElementwise(const OpKernelInfo& info) : OpKernel(info) {
+  std::vector<std::string> op_types;
+  std::vector<int64_t> operands;
+  ORT_ENFORCE(info.GetAttrs("operations", op_types).IsOK() && !op_types.empty(),
+              "FusedElementwise requires a non-empty 'operations' attribute.");
+  ORT_ENFORCE(info.GetAttrs("operands", operands).IsOK(), "FusedElementwise requires an 'operands' attribute.");
+
+  static const InlinedHashMap<std::string, std::pair<OpCode, size_t>> kOpCodes = {
+      {"Add", {OpCode::Add, 2}},
+      {"Sub", {OpCode::Sub, 2}},
+      {"Mul", {OpCode::Mul, 2}},
+      {"Div", {OpCode::Div, 2}},
+      {"Relu", {OpCode::Relu, 1}},
+      {"Sigmoid", {OpCode::Sigmoid, 1}},
+      {"Erf", {OpCode::Erf, 1}},
+      {"Where", {OpCode::Where, 3}},
+  };
+
+  input_count_ = info.GetInputCount();
+  operations_.reserve(op_types.size());
+
+  size_t next_operand = 0;
+  for (const auto& op_type : op_types) {
+    auto it = kOpCodes.find(op_type);
+    ORT_ENFORCE(it != kOpCodes.end(), "FusedElementwise does not support operation ", op_type);
+
+    Operation operation{};
+    operation.op_code = it->second.first;
+    operation.operand_count = it->second.second;
+    ORT_ENFORCE(next_operand + operation.operand_count <= operands.size(),
+                "FusedElementwise is missing operands of operation ", operations_.size());
+
+    for (size_t i = 0; i < operation.operand_count; i++) {
+      const int64_t operand = operands[next_operand++];
+      ORT_ENFORCE(operand >= 0 && static_cast<size_t>(operand) < input_count_ + operations_.size(),
+                  "Operand ", i, " of operation ", operations_.size(), " of FusedElementwise is out of range.");
+      ORT_ENFORCE(operation.op_code != OpCode::Where || i != 0 || static_cast<size_t>(operand) < input_count_,
+                  "The condition of Where in FusedElementwise must be an input of the node.");
+      operation.operands[i] = static_cast<size_t>(operand);
+    }
+
+    operations_.push_back(operation);
+  }
+  ORT_ENFORCE(next_operand == operands.size(), "FusedElementwise has more operands than its operations use.");
+
+  // Assign the intermediate results to buffers, reusing the buffer of a result after its last use. The buffers of
+  // the operands are released before the result is assigned, so an operation may compute in place.
+  InlinedVector<size_t> last_use(operations_.size(), 0);
+  for (size_t k = 0; k < operations_.size(); k++) {
+    for (size_t i = 0; i < operations_[k].operand_count; i++) {
+      if (operations_[k].operands[i] >= input_count_) {
+        last_use[operations_[k].operands[i] - input_count_] = k;
+      }
+    }
+  }
+
+  InlinedVector<size_t> free_slots;
+  slot_count_ = 0;
+  for (size_t k = 0; k < operations_.size(); k++) {
+    Operation& operation = operations_[k];
+    for (size_t i = 0; i < operation.operand_count; i++) {
+      const size_t operand = operation.operands[i];
+      const bool repeated = std::find(operation.operands.begin(), operation.operands.begin() + i, operand) !=
+                            operation.operands.begin() + i;
+      if (operand >= input_count_ && last_use[operand - input_count_] == k && !repeated) {
+        free_slots.push_back(operations_[operand - input_count_].slot);
+      }
+    }
+
+    if (k + 1 == operations_.size()) {
+      break;
+    }
+
+    if (free_slots.empty()) {
+      operation.slot = slot_count_++;
+    } else {
+      operation.slot = free_slots.back();
+      free_slots.pop_back();
+    }
+  }
+}
+
+Status FusedElementwise::Compute(OpKernelContext* context) const {
+  TensorShapeVector output_dims = context->Input<Tensor>(0)->Shape().AsShapeVector();
+  for (size_t i = 1; i < input_count_; i++) {
+    Broadcaster broadcaster(output_dims, context->Input<Tensor>(static_cast<int>(i))->Shape().GetDims());
+    output_dims = broadcaster.output_shape_;
+  }
+
+  Tensor* output = context->Output(0, TensorShape(output_dims));
+  const ptrdiff_t total = static_cast<ptrdiff_t>(output->Shape().Size());
+  if (total == 0) {
+    return Status::OK();
+  }
+
+  for (const Operation& operation : operations_) {
+    for (size_t i = 0; i < operation.operand_count; i++) {
+      if (operation.operands[i] < input_count_) {
+        const Tensor* input = context->Input<Tensor>(static_cast<int>(operation.operands[i]));
+        const bool is_condition = operation.op_code == OpCode::Where && i == 0;
+        ORT_RETURN_IF_NOT(is_condition ? input->IsDataType<bool>() : input->IsDataType<float>(),
+                          "Input ", operation.operands[i], " of FusedElementwise has an unexpected type.");
+      }
+    }
+  }
+
+  std::vector<InputView> views(input_count_);
+  InlinedVector<size_t> gather_offsets(input_count_, 0);
+  size_t gather_count = 0;
+  for (size_t i = 0; i < input_count_; i++) {
+    const Tensor* input = context->Input<Tensor>(static_cast<int>(i));
+    const ptrdiff_t size = static_cast<ptrdiff_t>(input->Shape().Size());
+    InputView& view = views[i];
+    view.data = static_cast<const uint8_t*>(input->DataRaw());
+    view.element_size = input->DataType()->Size();
+    view.is_scalar = size == 1;
+    view.is_full = size == total;
+    if (!view.is_scalar && !view.is_full) {
+      Broadcaster broadcaster(input->Shape().GetDims(), output_dims);
+      view.iterator = broadcaster.iterator1_;
+      view.span = view.iterator.GetCountsFront();
+      view.is_repeated = view.iterator.GetDeltasFront() == 0;
+      gather_offsets[i] = (slot_count_ + gather_count++) * kTileSize;
+    }
+  }
+
+  double compute_cycles = 0.0;
+  for (const Operation& operation : operations_) {
+    compute_cycles += (operation.op_code == OpCode::Sigmoid || operation.op_code == OpCode::Erf) ? 16.0 : 1.0;
+  }
+  const TensorOpCost cost{static_cast<double>(input_count_ * sizeof(float) * kTileSize),
+                          static_cast<double>(sizeof(float) * kTileSize),
+                          compute_cycles * kTileSize};
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  float* output_data = output->MutableData<float>();
+  const ptrdiff_t tile_count = (total + kTileSize - 1) / kTileSize;
+  const size_t buffer_size = (slot_count_ + gather_count) * kTileSize;
+
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), tile_count, cost,
+      [&](ptrdiff_t first, ptrdiff_t last) {
+        auto buffer = IAllocator::MakeUniquePtr<float>(allocator, std::max<size_t>(buffer_size, 1));
+        float* slots = buffer.get();
+
+        std::vector<BroadcastIterator> iterators(input_count_);
+        for (size_t i = 0; i < input_count_; i++) {
+          if (!views[i].is_scalar && !views[i].is_full) {
+            iterators[i] = views[i].iterator;
+            iterators[i].AdvanceBy(static_cast<size_t>(first * kTileSize));
+          }
+        }
+
+        InlinedVector<Operand> inputs(input_count_);
+        for (ptrdiff_t tile = first; tile < last; tile++) {
+          const ptrdiff_t start = tile * kTileSize;
+          const ptrdiff_t count = std::min(kTileSize, total - start);
+
+          for (size_t i = 0; i < input_count_; i++) {
+            inputs[i] = ReadTile(views[i], iterators[i], start, count,
+                                 reinterpret_cast<uint8_t*>(slots + gather_offsets[i]));
+          }
+
+          auto get_operand = [&](size_t operand) -> Operand {
+            if (operand < input_count_) {
+              return inputs[operand];
+            }
+            return {slots + operations_[operand - input_count_].slot * kTileSize, false};
+          };
+
+          for (size_t k = 0; k < operations_.size(); k++) {
+            const Operation& operation = operations_[k];
+            float* result = (k + 1 == operations_.size()) ? output_data + start
+                                                          : slots + operation.slot * kTileSize;
+            const Operand a = get_operand(operation.operands[0]);
+
+            switch (operation.op_code) {
+              case OpCode::Add:
+                ComputeBinary(a, get_operand(operation.operands[1]), result, count,
+                              [](const auto& x, const auto& y) { return x + y; });
+                break;
+              case OpCode::Sub:
+                ComputeBinary(a, get_operand(operation.operands[1]), result, count,
+                              [](const auto& x, const auto& y) { return x - y; });
+                break;
+              case OpCode::Mul:
+                ComputeBinary(a, get_operand(operation.operands[1]), result, count,
+                              [](const auto& x, const auto& y) { return x * y; });
+                break;
+              case OpCode::Div:
+                ComputeBinary(a, get_operand(operation.operands[1]), result, count,
+                              [](const auto& x, const auto& y) { return x / y; });
+                break;
+              case OpCode::Relu:
+              case OpCode::Sigmoid:
+              case OpCode::Erf: {
+                // A scalar operand is evaluated once and repeated.
+                const float* x = static_cast<const float*>(a.data);
+                const size_t n = a.is_scalar ? 1 : static_cast<size_t>(count);
+                if (operation.op_code == OpCode::Relu) {
+                  EigenVectorArrayMap<float>(result, n) = ConstEigenVectorArrayMap<float>(x, n).cwiseMax(0.0f);
+                } else if (operation.op_code == OpCode::Sigmoid) {
+                  MlasComputeLogistic(x, result, n);
+                } else {
+                  MlasComputeErf(x, result, n);
+                }
+                if (a.is_scalar) {
+                  std::fill_n(result + 1, count - 1, result[0]);
+                }
+                break;
+              }
+              case OpCode::Where:
+                ComputeWhere(a, get_operand(operation.operands[1]), get_operand(operation.operands[2]), result,
+                             count);
+                break;
+            }
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+
+#include "core/common/inlined_containers.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Evaluates the expression of a FusedElementwise node, as produced by the ElementwiseFusion transformer. The output
+// is computed one tile at a time and the intermediate results of the expression live in tile sized buffers, so
+// every input is read once and only the output is written to memory.
+class FusedElementwise final : public OpKernel {
+ public:
+  explicit FusedElementwise(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  enum class OpCode {
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Relu,
+    Sigmoid,
+    Erf,
+    Where,
+  };
+
+  struct Operation {
+    OpCode op_code;
+    size_t operand_count;
+    // indices of the inputs of the node followed by the results of the earlier operations
+    std::array<size_t, 3> operands;
+    // buffer holding the result within a tile, unused for the last operation which writes to the output
+    size_t slot;
+  };
+
+  InlinedVector<Operation> operations_;
+  size_t input_count_;
+  size_t slot_count_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+//
+// This module defines MatMulFpQ4 operator, it is basically
+// matmul float32 with right hand side being a 2-D matrix
+// pre-packed and block-compacted into int4
+//
+
+#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+class MatMulFpQ4 final : public OpKernel {
+ public:
+  MatMulFpQ4(const OpKernelInfo& info) : OpKernel(info) {
+    const auto t = info.GetAttrOrDefault<int64_t>("blk_quant_type", static_cast<int64_t>(BlkQ4Sym32));
+    ORT_ENFORCE(t >= BlkQ4Sym32 && t <= BlkQ4Zp128, "Unsupported blk_quant_type: ", t);
+    blk_quant_type_ = static_cast<MLAS_BLK_QUANT_TYPE>(t);
+
+    ORT_ENFORCE(info.GetAttr<int64_t>("K", &K_).IsOK() && K_ > 0, "Attribute K must be positive.");
+    ORT_ENFORCE(info.GetAttr<int64_t>("N", &N_).IsOK() && N_ > 0, "Attribute N must be positive.");
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  MLAS_BLK_QUANT_TYPE blk_quant_type_{BlkQ4Sym32};
+  int64_t K_{0};
+  int64_t N_{0};
+};
+
+Status MatMulFpQ4::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const Tensor* a = ctx->Input<Tensor>(0);
+  const Tensor* b = ctx->Input<Tensor>(1);
+  const Tensor* bias = ctx->Input<Tensor>(2);
+
+  const size_t K = static_cast<size_t>(K_);
+  const size_t N = static_cast<size_t>(N_);
+
+  const size_t packed_b_size = MlasQ4GemmPackBSize(blk_quant_type_, N, K);
+  ORT_RETURN_IF(packed_b_size == 0, "Unsupported blk_quant_type: ", static_cast<int>(blk_quant_type_));
+  ORT_RETURN_IF_NOT(b->Shape().NumDimensions() == 1 &&
+                        static_cast<size_t>(b->Shape().Size()) == packed_b_size,
+                    "Input B must be a 1-D blob of ", packed_b_size, " bytes for K=", K, ", N=", N,
+                    " but has shape ", b->Shape());
+
+  if (bias != nullptr) {
+    ORT_RETURN_IF_NOT(bias->Shape().NumDimensions() == 1 && static_cast<size_t>(bias->Shape().Size()) == N,
+                      "Input bias must be a 1-D tensor of size N=", N, " but has shape ", bias->Shape());
+  }
+
+  MatMulComputeHelper helper;
+  TensorShape b_shape({K_, N_});
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b_shape));
+
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  // Bail out early if the output is going to be empty
+  if (y->Shape().Size() == 0)
+    return Status::OK();
+
+  const float* a_data = a->Data<float>();
+  const uint8_t* b_data = b->Data<uint8_t>();
+  const float* bias_data = bias != nullptr ? bias->Data<float>() : nullptr;
+  float* y_data = y->MutableData<float>();
+
+  const size_t max_len = helper.OutputOffsets().size();
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t lda = static_cast<size_t>(helper.Lda(false));
+
+  std::vector<MLAS_Q4GEMM_DATA_PARAMS> gemm_params(max_len);
+  for (size_t i = 0; i < max_len; i++) {
+    gemm_params[i].A = a_data + helper.LeftOffsets()[i];
+    gemm_params[i].lda = lda;
+    gemm_params[i].B = b_data;
+    gemm_params[i].Bias = bias_data;
+    gemm_params[i].C = y_data + helper.OutputOffsets()[i];
+    gemm_params[i].ldc = N;
+  }
+
+  MlasQ4GemmBatch(blk_quant_type_, M, N, K, gemm_params.data(), max_len, thread_pool);
+
+  return Status::OK();
+}
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    MatMulFpQ4,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>()),
+    MatMulFpQ4);
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -83,6 +83,7 @@ Status BeamSearchGpt<T>::CreateInitialFeeds(gsl::span<int32_t>& sequence_lengths
                                           this->implicit_inputs_,
                                           this->parameters_->num_beams,
                                           this->parameters_->pad_token_id,
+                                          this->parameters_->max_length,
                                           sequence_lengths,
                                           expanded_input_ids,
                                           attn_mask_value,
@@ -112,7 +113,8 @@ Status BeamSearchGpt<T>::UpdateFeeds(
                             beam_indices,
                             this->parameters_->num_beams,
                             gpt_subgraph_.GetFirstPastInputIndex(),
-                            gpt_subgraph_.GetFirstPresentOutputIndex());
+                            gpt_subgraph_.GetFirstPresentOutputIndex(),
+                            gpt_subgraph_.IsPastPresentShareBuffer());
 }
 
 template <typename T>
@@ -221,6 +223,8 @@ Status BeamSearchGpt<T>::Execute(const FeedsFetchesManager& feeds_fetches_manage
     }
 #endif
 
+    gpt_subgraph_.BindPresentFetches(feeds, fetches);
+
     status = utils::ExecuteSubgraph(this->decoder_session_state_,
                                     feeds_fetches_manager,
                                     feeds,
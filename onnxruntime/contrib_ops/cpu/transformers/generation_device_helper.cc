@@ -501,8 +501,7 @@ Status DeviceCopy(gsl::span<T> target, gsl::span<const T> source, void* /*stream
   return Status::OK();
 }
 
-// Copy present state to past state for GPT model
-template <typename T>
+// Copy present state to past state for GPT model. The state is copied as bytes, since it could be quantized.
 void PickGptPastState(const std::vector<OrtValue>& last_outputs,
                       std::vector<OrtValue>& next_inputs,
                       gsl::span<const int32_t>& beam_indices,
@@ -511,29 +510,29 @@ void PickGptPastState(const std::vector<OrtValue>& last_outputs,
                       AllocatorPtr allocator) {
   int num_present_tensors = static_cast<int>(last_outputs.size()) - gpt_subgraph_first_present_output_idx;
   for (ptrdiff_t i = 0; i < num_present_tensors; ++i) {
-    const OrtValue& present = last_outputs[gpt_subgraph_first_present_output_idx + i];
+    const Tensor& present = last_outputs[gpt_subgraph_first_present_output_idx + i].Get<Tensor>();
 
     // shape is like (2, batch_beam_size, 12, past_seq_len, 64)
-    const TensorShape& past_shape = present.Get<Tensor>().Shape();
-    auto block_size_per_beam = past_shape[2] * past_shape[3] * past_shape[4];
-    auto past_key_size = past_shape[1] * past_shape[2] * past_shape[3] * past_shape[4];
+    const TensorShape& past_shape = present.Shape();
+    const size_t element_size = present.DataType()->Size();
+    auto block_size_per_beam = past_shape[2] * past_shape[3] * past_shape[4] * element_size;
+    auto past_key_size = past_shape[1] * past_shape[2] * past_shape[3] * past_shape[4] * element_size;
 
     // Create a tensor with same shape.
     // TODO(tianleiwu): allocate one buffer for all layers
     OrtValue past;
-    auto past_type = DataTypeImpl::GetType<T>();
-    Tensor::InitOrtValue(past_type, past_shape, allocator, past);
+    Tensor::InitOrtValue(present.DataType(), past_shape, allocator, past);
 
-    gsl::span<T> past_span = gsl::make_span<T>(past.GetMutable<Tensor>()->MutableData<T>(), onnxruntime::narrow<size_t>(past_shape.Size()));
-    gsl::span<const T> present_span = gsl::make_span<const T>(present.Get<Tensor>().Data<T>(), onnxruntime::narrow<size_t>(past_shape.Size()));
+    gsl::span<uint8_t> past_span = gsl::make_span<uint8_t>(static_cast<uint8_t*>(past.GetMutable<Tensor>()->MutableDataRaw()), present.SizeInBytes());
+    gsl::span<const uint8_t> present_span = gsl::make_span<const uint8_t>(static_cast<const uint8_t*>(present.DataRaw()), present.SizeInBytes());
     for (size_t j = 0; j < beam_indices.size(); j++) {
       int32_t beam_index = beam_indices[j];
-      gsl::span<const T> present_key = present_span.subspan(beam_index * SafeInt<size_t>(block_size_per_beam), onnxruntime::narrow<size_t>(block_size_per_beam));
-      gsl::span<const T> present_value = present_span.subspan(past_key_size + beam_index * SafeInt<size_t>(block_size_per_beam),
-                                                              onnxruntime::narrow<size_t>(block_size_per_beam));
+      gsl::span<const uint8_t> present_key = present_span.subspan(beam_index * SafeInt<size_t>(block_size_per_beam), onnxruntime::narrow<size_t>(block_size_per_beam));
+      gsl::span<const uint8_t> present_value = present_span.subspan(past_key_size + beam_index * SafeInt<size_t>(block_size_per_beam),
+                                                                    onnxruntime::narrow<size_t>(block_size_per_beam));
 
-      gsl::span<T> past_key = past_span.subspan(j * SafeInt<size_t>(block_size_per_beam), onnxruntime::narrow<size_t>(block_size_per_beam));
-      gsl::span<T> past_value = past_span.subspan(past_key_size + j * SafeInt<size_t>(block_size_per_beam), onnxruntime::narrow<size_t>(block_size_per_beam));
+      gsl::span<uint8_t> past_key = past_span.subspan(j * SafeInt<size_t>(block_size_per_beam), onnxruntime::narrow<size_t>(block_size_per_beam));
+      gsl::span<uint8_t> past_value = past_span.subspan(past_key_size + j * SafeInt<size_t>(block_size_per_beam), onnxruntime::narrow<size_t>(block_size_per_beam));
       gsl::copy(present_key, past_key);
       gsl::copy(present_value, past_value);
     }
@@ -555,9 +554,11 @@ Status UpdateGptFeeds(
     gsl::span<const int32_t> beam_indices,
     int num_beams,
     int gpt_subgraph_first_past_input_idx,
-    int gpt_subgraph_first_present_output_idx) {
+    int gpt_subgraph_first_present_output_idx,
+    bool past_present_share_buffer) {
   // last_outputs: logits, present_0, present_1, ...
-  // next_inputs: input_ids, position_id, attention_mask, past_0, past_1
+  // next_inputs: input_ids, position_id, attention_mask, past_0, past_1, ...,
+  //              and past_sequence_length, cache_indirection when past and present state share buffers
   ORT_UNUSED_PARAMETER(stream);
 
   // The following updates inputs for subgraph
@@ -602,16 +603,40 @@ Status UpdateGptFeeds(
   next_inputs[2] = attention_mask;
 
   // Update past state
-  if (num_beams == 1) {
+  if (past_present_share_buffer) {
+    // The present state has been written to the past state buffers in place. Update the number of valid rows,
+    // and reorder the beams in the cache indirection instead of the past state.
+    const size_t num_layers = last_outputs.size() - static_cast<size_t>(gpt_subgraph_first_present_output_idx);
+    const size_t past_sequence_length_idx = static_cast<size_t>(gpt_subgraph_first_past_input_idx) + num_layers;
+    const int past_sequence_length = current_length - 1;
+    *next_inputs[past_sequence_length_idx].GetMutable<Tensor>()->MutableData<int32_t>() = past_sequence_length;
+
+    if (num_beams > 1) {
+      const Tensor& old_indirection = next_inputs[past_sequence_length_idx + 1].Get<Tensor>();
+      const int32_t* old_indirection_data = old_indirection.Data<int32_t>();
+      const int64_t max_length = old_indirection.Shape()[1];
+      OrtValue cache_indirection;
+      Tensor::InitOrtValue(int32_type, old_indirection.Shape(), allocator, cache_indirection);
+      int32_t* indirection_data = cache_indirection.GetMutable<Tensor>()->MutableData<int32_t>();
+      for (int i = 0; i < batch_beam_size; i++) {
+        // A beam continues the rows of the selected beam, and writes the remaining rows to its own past state.
+        const int32_t* source = old_indirection_data + beam_indices[i] * max_length;
+        int32_t* target = indirection_data + i * max_length;
+        std::copy_n(source, past_sequence_length, target);
+        std::fill(target + past_sequence_length, target + max_length, i);
+      }
+      next_inputs[past_sequence_length_idx + 1] = cache_indirection;
+    }
+  } else if (num_beams == 1) {
     // feed present_* output to past_* inputs one by one
     const int k = gpt_subgraph_first_past_input_idx - gpt_subgraph_first_present_output_idx;
     for (size_t i = gpt_subgraph_first_present_output_idx; i < last_outputs.size(); ++i) {
       next_inputs[i + k] = last_outputs[i];
     }
   } else {
-    PickGptPastState<T>(last_outputs, next_inputs, beam_indices,
-                        gpt_subgraph_first_past_input_idx,
-                        gpt_subgraph_first_present_output_idx, allocator);
+    PickGptPastState(last_outputs, next_inputs, beam_indices,
+                     gpt_subgraph_first_past_input_idx,
+                     gpt_subgraph_first_present_output_idx, allocator);
   }
   return Status::OK();
 }
@@ -862,7 +887,8 @@ template Status UpdateGptFeeds<float>(
     gsl::span<const int32_t> beam_indices,
     int num_beams,
     int gpt_subgraph_first_past_input_idx,
-    int gpt_subgraph_first_present_output_idx);
+    int gpt_subgraph_first_present_output_idx,
+    bool past_present_share_buffer);
 
 template Status UpdateDecoderFeeds<float>(
     AllocatorPtr allocator,
@@ -88,6 +88,7 @@ Status GreedySearchGpt<T>::CreateInitialFeeds(gsl::span<int32_t>& sequence_lengt
                                           this->implicit_inputs_,
                                           this->parameters_->num_beams,
                                           this->parameters_->pad_token_id,
+                                          this->parameters_->max_length,
                                           sequence_lengths,
                                           expanded_input_ids,
                                           attn_mask_value,
@@ -117,7 +118,8 @@ Status GreedySearchGpt<T>::UpdateFeeds(
                             place_holder,
                             this->parameters_->num_beams,
                             gpt_subgraph_.GetFirstPastInputIndex(),
-                            gpt_subgraph_.GetFirstPresentOutputIndex());
+                            gpt_subgraph_.GetFirstPresentOutputIndex(),
+                            gpt_subgraph_.IsPastPresentShareBuffer());
 }
 
 template <typename T>
@@ -182,6 +184,8 @@ Status GreedySearchGpt<T>::Execute(const FeedsFetchesManager& feeds_fetches_mana
     dumper->Print("attention_mask", feeds[2]);
 #endif
 
+    gpt_subgraph_.BindPresentFetches(feeds, fetches);
+
     status = utils::ExecuteSubgraph(this->decoder_session_state_,
                                     feeds_fetches_manager,
                                     feeds,
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+
 #include "core/framework/framework_common.h"
 #include "core/framework/session_state.h"
 #include "core/framework/tensorprotoutils.h"
@@ -19,6 +21,7 @@ Status GptSubgraph::CreateInitialFeeds(
     const std::vector<const OrtValue*>& implicit_inputs,
     int num_beams,
     int pad_token_id,
+    int max_length,
     gsl::span<int32_t>& sequence_lengths,
     OrtValue& expanded_input_ids,
     const OrtValue* attn_mask_value,
@@ -48,7 +51,9 @@ Status GptSubgraph::CreateInitialFeeds(
   allocator_ = default_allocator;
 
   // Initialize empty past state
-  auto past_type = IsOutputFloat16() ? DataTypeImpl::GetType<MLFloat16>() : DataTypeImpl::GetType<float>();
+  auto past_type = IsPastQuantized()   ? DataTypeImpl::GetType<uint8_t>()
+                   : IsOutputFloat16() ? DataTypeImpl::GetType<MLFloat16>()
+                                       : DataTypeImpl::GetType<float>();
   int64_t past_state_dims[] = {2, batch_size * num_beams, num_heads, 0, head_size};
   TensorShape past_shape(&past_state_dims[0], 5);
   OrtValue empty_past;
@@ -74,9 +79,44 @@ Status GptSubgraph::CreateInitialFeeds(
                                         feeds,
                                         buffer));
 
-  // The remaining inputs are past state.
-  for (int i = first_past_input_index_; i < num_subgraph_inputs; ++i) {
-    feeds.push_back(empty_past);
+  if (!past_present_share_buffer_) {
+    // The remaining inputs are past state.
+    for (int i = first_past_input_index_; i < num_subgraph_inputs; ++i) {
+      feeds.push_back(empty_past);
+    }
+  } else {
+    // The past state of each layer is a buffer of max length, where the present state is written in place.
+    ORT_RETURN_IF(provider->Type() != kCpuExecutionProvider,
+                  "Shared buffer of past and present state is only supported by CPU execution provider");
+    ORT_RETURN_IF(num_beams > 1 && !has_cache_indirection_,
+                  "Beam search with shared buffer of past and present state requires cache_indirection input");
+
+    const int64_t batch_beam_size = batch_size * num_beams;
+    past_state_dims[3] = max_length;
+    TensorShape max_past_shape(&past_state_dims[0], 5);
+    for (int i = 0; i < num_layers; ++i) {
+      OrtValue past;
+      Tensor::InitOrtValue(past_type, max_past_shape, default_allocator, past);
+      feeds.push_back(past);
+    }
+
+    auto int32_type = DataTypeImpl::GetType<int32_t>();
+    OrtValue past_sequence_length;
+    Tensor::InitOrtValue(int32_type, TensorShape({1}), cpu_allocator, past_sequence_length);
+    *past_sequence_length.GetMutable<Tensor>()->MutableData<int32_t>() = 0;
+    feeds.push_back(past_sequence_length);
+
+    // Each sequence starts with the rows of its own past state.
+    if (has_cache_indirection_) {
+      OrtValue cache_indirection;
+      Tensor::InitOrtValue(int32_type, TensorShape({batch_beam_size, max_length}), cpu_allocator,
+                           cache_indirection);
+      int32_t* cache_indirection_data = cache_indirection.GetMutable<Tensor>()->MutableData<int32_t>();
+      for (int64_t i = 0; i < batch_beam_size; i++) {
+        std::fill_n(cache_indirection_data + i * max_length, max_length, static_cast<int32_t>(i));
+      }
+      feeds.push_back(cache_indirection);
+    }
   }
 
   // Pass in implicit inputs
@@ -87,13 +127,27 @@ Status GptSubgraph::CreateInitialFeeds(
   return Status::OK();
 }
 
+void GptSubgraph::BindPresentFetches(const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches) const {
+  if (!past_present_share_buffer_) {
+    return;
+  }
+
+  // Logits are allocated by the subgraph, and present state is written to the past state buffers.
+  fetches.clear();
+  fetches.resize(first_present_output_index_);
+  for (int i = 0; i < num_layers; ++i) {
+    fetches.push_back(feeds[static_cast<size_t>(first_past_input_index_) + i]);
+  }
+}
+
 Status GptSubgraph::Validate(const std::vector<const NodeArg*>& subgraph_inputs,
                              const std::vector<const NodeArg*>& subgraph_outputs) {
   ORT_RETURN_IF(num_subgraph_outputs <= first_present_output_index_,
                 "Invalid GPT-2 subgraph: number of outputs shall be larger than 1 (Need past state in outputs).");
 
-  ORT_RETURN_IF(num_subgraph_inputs != num_subgraph_outputs + 2,
-                "Invalid GPT-2 subgraph: number of inputs shall be number of outputs plus 2");
+  ORT_RETURN_IF(num_subgraph_inputs < num_subgraph_outputs + 2 || num_subgraph_inputs > num_subgraph_outputs + 4,
+                "Invalid GPT-2 subgraph: number of inputs shall be number of outputs plus 2, or plus 3 or 4 "
+                "with past_sequence_length and cache_indirection inputs");
 
   ORT_RETURN_IF(subgraph_inputs[0]->Name() != "input_ids",
                 "subgraph input 0 shall be named as input_ids, got: ", subgraph_inputs[0]->Name());
@@ -140,6 +194,7 @@ Status GptSubgraph::Validate(const std::vector<const NodeArg*>& subgraph_inputs,
   num_layers = static_cast<int>(subgraph_outputs.size()) - 1;
 
   constexpr auto int32_type = ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_INT32;
+  constexpr auto uint8_type = ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_UINT8;
   constexpr auto float32_type = ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_FLOAT;
   constexpr auto float16_type = ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_FLOAT16;
 
@@ -154,12 +209,42 @@ Status GptSubgraph::Validate(const std::vector<const NodeArg*>& subgraph_inputs,
   ORT_RETURN_IF(output_type != float32_type && output_type != float16_type,
                 "subgraph output 0 (logits) shall be float or float16 data type");
 
-  ORT_RETURN_IF(subgraph_inputs[first_past_input_index_]->TypeAsProto()->tensor_type().elem_type() != output_type,
-                "subgraph input 3 (past_0) shall shall have same data type of logits output");
-  ORT_RETURN_IF(subgraph_outputs[first_present_output_index_]->TypeAsProto()->tensor_type().elem_type() != output_type,
-                "subgraph output 1 (present_0) shall shall have same data type of logits output");
+  // The past state could be quantized to uint8, see the Attention operator.
+  auto past_type = subgraph_inputs[first_past_input_index_]->TypeAsProto()->tensor_type().elem_type();
+  ORT_RETURN_IF(past_type != output_type && past_type != uint8_type,
+                "subgraph input 3 (past_0) shall shall have same data type of logits output, or uint8 data type");
+  ORT_RETURN_IF(subgraph_outputs[first_present_output_index_]->TypeAsProto()->tensor_type().elem_type() != past_type,
+                "subgraph output 1 (present_0) shall shall have same data type of past_0 input");
 
   is_output_float16_ = (output_type == float16_type);
+  is_past_quantized_ = (past_type == uint8_type);
+
+  // The inputs after past state are past_sequence_length and cache_indirection, when past and present state
+  // share buffers.
+  const int num_extra_inputs = num_subgraph_inputs - num_subgraph_outputs - 2;
+  past_present_share_buffer_ = (num_extra_inputs > 0);
+  has_cache_indirection_ = (num_extra_inputs > 1);
+  if (past_present_share_buffer_) {
+    const int past_sequence_length_index = first_past_input_index_ + num_layers;
+    ORT_RETURN_IF(subgraph_inputs[past_sequence_length_index]->Name() != "past_sequence_length",
+                  "subgraph input ", past_sequence_length_index, " shall be named as past_sequence_length, got: ",
+                  subgraph_inputs[past_sequence_length_index]->Name());
+    ORT_RETURN_IF(subgraph_inputs[past_sequence_length_index]->TypeAsProto()->tensor_type().elem_type() !=
+                      int32_type,
+                  "subgraph input past_sequence_length shall have int32 type");
+
+    if (has_cache_indirection_) {
+      const int cache_indirection_index = past_sequence_length_index + 1;
+      ORT_RETURN_IF(subgraph_inputs[cache_indirection_index]->Name() != "cache_indirection",
+                    "subgraph input ", cache_indirection_index, " shall be named as cache_indirection, got: ",
+                    subgraph_inputs[cache_indirection_index]->Name());
+      ORT_RETURN_IF(subgraph_inputs[cache_indirection_index]->TypeAsProto()->tensor_type().elem_type() != int32_type,
+                    "subgraph input cache_indirection shall have int32 type");
+    }
+
+    ORT_RETURN_IF(past_type != float32_type,
+                  "Shared buffer of past and present state requires float past state");
+  }
 
   return Status::OK();
 }
@@ -26,6 +26,7 @@ class GptSubgraph : public Subgraph {
       const std::vector<const OrtValue*>& implicit_inputs,
       int num_beams,
       int pad_token_id,
+      int max_length,
       gsl::span<int32_t>& sequence_lengths,
       OrtValue& expanded_input_ids,
       const OrtValue* attn_mask_value,
@@ -34,6 +35,9 @@ class GptSubgraph : public Subgraph {
       const GenerationDeviceHelper::AddToFeedsFunc& add_to_feeds_func,
       IAllocatorUniquePtr<char>& buffer);
 
+  // Bind present state outputs to the buffers of past state inputs when they share buffers.
+  void BindPresentFetches(const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches) const;
+
   Status Validate(const std::vector<const NodeArg*>& subgraph_inputs,
                   const std::vector<const NodeArg*>& subgraph_outputs) override;
 
@@ -45,9 +49,23 @@ class GptSubgraph : public Subgraph {
     return first_present_output_index_;
   }
 
+  // Whether the past state is quantized to uint8 for the Attention CPU kernel.
+  bool IsPastQuantized() const {
+    return is_past_quantized_;
+  }
+
+  // Whether the past and present state share buffers of max length, which has a past_sequence_length input
+  // after the past state, and optionally a cache_indirection input for beam search. See the Attention operator.
+  bool IsPastPresentShareBuffer() const {
+    return past_present_share_buffer_;
+  }
+
  private:
   int first_past_input_index_;
   int first_present_output_index_;
+  bool is_past_quantized_ = false;
+  bool past_present_share_buffer_ = false;
+  bool has_cache_indirection_ = false;
 };
 
 }  // namespace transformers
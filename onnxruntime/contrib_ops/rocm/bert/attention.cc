@@ -22,7 +22,8 @@ namespace rocm {
       T,                                                          \
       kRocmExecutionProvider,                                     \
       (*KernelDefBuilder::Create())                               \
-          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())  \
+          .TypeConstraint("U", DataTypeImpl::GetTensorType<T>()), \
       Attention<T>);
 
 REGISTER_KERNEL_TYPED(float)
@@ -43,6 +44,10 @@ Status Attention<T>::ComputeInternal(OpKernelContext* context) const {
   const Tensor* key = context->Input<Tensor>(6);
   const Tensor* value = context->Input<Tensor>(7);
 
+  if (context->Input<Tensor>(8) != nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Input 'past_sequence_length' is not supported");
+  }
+
   auto& device_prop = GetDeviceProp();
   ORT_RETURN_IF_ERROR(CheckInputs(input->Shape(),
                                   weights == nullptr ? nullptr : &(weights->Shape()),
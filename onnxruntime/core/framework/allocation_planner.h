@@ -59,7 +59,7 @@ class SequentialPlannerContext : public ISequentialPlannerContext {
     return arg.Shape();
   }
 
-  bool IsParallelExecutionEnabled() const override { return execution_mode_ == ExecutionMode::ORT_PARALLEL; }
+  bool IsParallelExecutionEnabled() const override { return execution_mode_ != ExecutionMode::ORT_SEQUENTIAL; }
 
   ExecutionOrder GetExecutionOrder() const override { return exection_order_; }
 
@@ -5,6 +5,7 @@
 
 #include <string>
 #include <sstream>
+#include <vector>
 
 namespace onnxruntime {
 
@@ -22,6 +23,15 @@ struct AllocatorStats {
                                   // is known. Certain allocator may return 0 to indicate the limit is
                                   // unknown.
   int64_t bytes_limit;
+  int64_t num_lock_acquisitions;  // Number of times the allocator lock was taken by Alloc/Free/Reserve.
+  int64_t num_lock_contentions;   // Number of those lock acquisitions that had to wait for another thread.
+  int64_t num_thread_cache_hits;  // Number of allocations served from a per-thread cache without taking the lock.
+  int64_t bytes_in_thread_caches;  // Number of freed bytes held by per-thread caches. Not included in bytes_in_use.
+  int64_t num_regions;            // Number of memory regions held (Relevant only for arena based allocators)
+  int64_t largest_free_chunk;     // Size of the largest free chunk (Relevant only for arena based allocators)
+                                  // Free bytes in each bin of an arena based allocator. Bin i holds free chunks
+                                  // of at least 256 << i bytes. Empty for other allocators.
+  std::vector<int64_t> free_bytes_per_bin;
 
   AllocatorStats() { Clear(); }
 
@@ -35,6 +45,13 @@ struct AllocatorStats {
     this->max_alloc_size = 0;
     this->bytes_limit = 0;
     this->total_allocated_bytes = 0;
+    this->num_lock_acquisitions = 0;
+    this->num_lock_contentions = 0;
+    this->num_thread_cache_hits = 0;
+    this->bytes_in_thread_caches = 0;
+    this->num_regions = 0;
+    this->largest_free_chunk = 0;
+    this->free_bytes_per_bin.clear();
   }
 
   std::string DebugString() const {
@@ -47,7 +64,20 @@ struct AllocatorStats {
        << "NumReserves:              " << this->num_reserves << "\n"
        << "NumArenaExtensions:       " << this->num_arena_extensions << "\n"
        << "NumArenaShrinkages:       " << this->num_arena_shrinkages << "\n"
-       << "MaxAllocSize:             " << this->max_alloc_size << "\n";
+       << "MaxAllocSize:             " << this->max_alloc_size << "\n"
+       << "NumLockAcquisitions:      " << this->num_lock_acquisitions << "\n"
+       << "NumLockContentions:       " << this->num_lock_contentions << "\n"
+       << "NumThreadCacheHits:       " << this->num_thread_cache_hits << "\n"
+       << "BytesInThreadCaches:      " << this->bytes_in_thread_caches << "\n"
+       << "NumRegions:               " << this->num_regions << "\n"
+       << "LargestFreeChunk:         " << this->largest_free_chunk << "\n";
+    if (!this->free_bytes_per_bin.empty()) {
+      ss << "FreeBytesPerBin:         ";
+      for (auto free_bytes : this->free_bytes_per_bin) {
+        ss << " " << free_bytes;
+      }
+      ss << "\n";
+    }
     return ss.str();
   }
 };
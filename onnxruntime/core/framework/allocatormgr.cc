@@ -62,7 +62,9 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
                                                    arena_extend_str,
                                                    initial_chunk_size_bytes,
                                                    max_dead_bytes_per_chunk,
-                                                   initial_growth_chunk_size_bytes));
+                                                   initial_growth_chunk_size_bytes,
+                                                   info.arena_cfg.max_thread_cache_bytes,
+                                                   info.arena_cfg.shrink_idle_runs));
   } else {
     return device_allocator;
   }
@@ -6,12 +6,18 @@
 #include <type_traits>
 
 namespace onnxruntime {
+namespace {
+std::atomic<uint64_t> next_arena_id{1};
+}  // namespace
+
 BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
                    size_t total_memory,
                    ArenaExtendStrategy arena_extend_strategy,
                    int initial_chunk_size_bytes,
                    int max_dead_bytes_per_chunk,
-                   int initial_growth_chunk_size_bytes)
+                   int initial_growth_chunk_size_bytes,
+                   size_t max_thread_cache_bytes,
+                   int shrink_idle_runs)
     : IAllocator(OrtMemoryInfo(resource_allocator->Info().name,
                                OrtAllocatorType::OrtArenaAllocator,
                                resource_allocator->Info().device,
@@ -22,11 +28,16 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       next_allocation_id_(1),
       initial_chunk_size_bytes_(initial_chunk_size_bytes),
       max_dead_bytes_per_chunk_(max_dead_bytes_per_chunk),
-      initial_growth_chunk_size_bytes_(initial_growth_chunk_size_bytes) {
+      initial_growth_chunk_size_bytes_(initial_growth_chunk_size_bytes),
+      max_thread_cache_bytes_(max_thread_cache_bytes),
+      shrink_idle_runs_(shrink_idle_runs),
+      arena_id_(next_arena_id++) {
   LOGS_DEFAULT(INFO) << "Creating BFCArena for " << device_allocator_->Info().name
                      << " with following configs: initial_chunk_size_bytes: " << initial_chunk_size_bytes_
                      << " max_dead_bytes_per_chunk: " << max_dead_bytes_per_chunk_
                      << " initial_growth_chunk_size_bytes: " << initial_growth_chunk_size_bytes_
+                     << " max_thread_cache_bytes: " << max_thread_cache_bytes_
+                     << " shrink_idle_runs: " << shrink_idle_runs_
                      << " memory limit: " << total_memory
                      << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy);
 
@@ -203,6 +214,7 @@ Status BFCArena::Extend(size_t rounded_bytes) {
   LOGS_DEFAULT(INFO) << "Allocated memory at " << mem_addr << " to "
                      << static_cast<void*>(static_cast<char*>(mem_addr) + bytes);
   region_manager_.AddAllocationRegion(mem_addr, bytes, stats_.num_arena_extensions);
+  region_manager_.set_last_use_run(mem_addr, num_runs_);
   stats_.num_arena_extensions += 1;
 
   // Create one large chunk for the whole memory space that will
@@ -255,14 +267,120 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
-  return AllocateRawInternal(size, false);
+  if (!ThreadCacheEnabled() || size == 0) {
+    return AllocateRawInternal(size, false);
+  }
+
+  const size_t rounded_bytes = RoundedBytes(size);
+  if (rounded_bytes > kMaxThreadCacheAllocationSize) {
+    return AllocateRawInternal(size, false);
+  }
+
+  const size_t size_class = rounded_bytes / kMinAllocationSize - 1;
+  ThreadCache& cache = GetThreadCache();
+  {
+    std::lock_guard<OrtMutex> guard(cache.mutex);
+    auto& free_list = cache.free_lists[size_class];
+    if (!free_list.empty()) {
+      const ThreadCache::Entry entry = free_list.back();
+      free_list.pop_back();
+      cache.cached_bytes -= entry.size;
+      cache.low_water_marks[size_class] = std::min(cache.low_water_marks[size_class], free_list.size());
+      ++cache.num_hits;
+      return entry.ptr;
+    }
+  }
+
+  size_t chunk_size = 0;
+  void* ptr = AllocateRawInternal(size, false, &chunk_size);
+
+  // the chunk goes to a thread cache instead of the bins when it's freed
+  auto& shard = ShardFor(ptr);
+  std::lock_guard<OrtMutex> guard(shard.mutex);
+  shard.chunk_sizes[ptr] = chunk_size;
+  return ptr;
+}
+
+BFCArena::ThreadCache& BFCArena::GetThreadCache() {
+  // the caches of the arenas used by this thread. entries of destroyed arenas are never looked up again.
+  thread_local InlinedHashMap<uint64_t, ThreadCache*> caches;
+  thread_local uint64_t last_arena_id = 0;
+  thread_local ThreadCache* last_cache = nullptr;
+
+  if (last_arena_id == arena_id_) {
+    return *last_cache;
+  }
+
+  ThreadCache*& cache = caches[arena_id_];
+  if (cache == nullptr) {
+    auto new_cache = std::make_unique<ThreadCache>();
+    new_cache->free_lists.resize(kNumThreadCacheClasses);
+    new_cache->low_water_marks.resize(kNumThreadCacheClasses, 0);
+    cache = new_cache.get();
+
+    // the arena owns the cache so chunks cached by a thread that exited are still released by Shrink
+    std::lock_guard<OrtMutex> guard(thread_caches_lock_);
+    thread_caches_.push_back(std::move(new_cache));
+  }
+
+  last_arena_id = arena_id_;
+  last_cache = cache;
+  return *cache;
+}
+
+BFCArena::ChunkOwnerShard& BFCArena::ShardFor(const void* ptr) {
+  // chunks are at least kMinAllocationSize apart so drop the low bits
+  const auto key = reinterpret_cast<std::uintptr_t>(ptr) >> kMinAllocationBits;
+  return chunk_owner_shards_[((key * 0x9E3779B97F4A7C15ull) >> 32) % kNumChunkOwnerShards];
+}
+
+bool BFCArena::TryGetThreadCacheChunkSize(void* ptr, size_t& size) {
+  auto& shard = ShardFor(ptr);
+  std::lock_guard<OrtMutex> guard(shard.mutex);
+  auto it = shard.chunk_sizes.find(ptr);
+  if (it == shard.chunk_sizes.end()) {
+    return false;
+  }
+
+  size = it->second;
+  return true;
+}
+
+void BFCArena::TakeOldestEntries(ThreadCache& cache, size_t size_class, size_t count,
+                                 std::vector<ThreadCache::Entry>& released) {
+  auto& free_list = cache.free_lists[size_class];
+  count = std::min(count, free_list.size());
+  if (count == 0) {
+    return;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    cache.cached_bytes -= free_list[i].size;
+  }
+
+  released.insert(released.end(), free_list.begin(), free_list.begin() + count);
+  free_list.erase(free_list.begin(), free_list.begin() + count);
+  cache.low_water_marks[size_class] = std::min(cache.low_water_marks[size_class], free_list.size());
+}
+
+void BFCArena::ReleaseThreadCacheEntries(const std::vector<ThreadCache::Entry>& released) {
+  auto lock = AcquireLock();
+  for (const auto& entry : released) {
+    auto& shard = ShardFor(entry.ptr);
+    {
+      std::lock_guard<OrtMutex> guard(shard.mutex);
+      shard.chunk_sizes.erase(entry.ptr);
+    }
+
+    DeallocateRawInternal(entry.ptr);
+  }
 }
 
 void* BFCArena::Reserve(size_t size) {
   if (size == 0)
     return nullptr;
 
-  std::lock_guard<OrtMutex> lock(lock_);
+  auto lock = AcquireLock();
 
   LOGS_DEFAULT(INFO) << "Reserving memory in BFCArena for " << device_allocator_->Info().name << " size: " << size;
 
@@ -295,7 +413,8 @@ size_t BFCArena::AllocatedSize(const void* ptr) {
 }
 
 void* BFCArena::AllocateRawInternal(size_t num_bytes,
-                                    bool dump_log_on_failure) {
+                                    bool dump_log_on_failure,
+                                    size_t* chunk_size) {
   if (num_bytes == 0) {
     LOGS_DEFAULT(VERBOSE) << "tried to allocate 0 bytes";
     return nullptr;
@@ -308,9 +427,12 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   // The BFC allocator tries to find the best fit first.
   BinNum bin_num = BinNumForSize(rounded_bytes);
 
-  std::lock_guard<OrtMutex> lock(lock_);
+  auto lock = AcquireLock();
   void* ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
   if (ptr != nullptr) {
+    if (chunk_size != nullptr) {
+      *chunk_size = ChunkFromHandle(region_manager_.get_handle(ptr))->size;
+    }
     return ptr;
   }
 
@@ -322,6 +444,9 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   if (status.IsOK()) {
     ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
     if (ptr != nullptr) {
+      if (chunk_size != nullptr) {
+        *chunk_size = ChunkFromHandle(region_manager_.get_handle(ptr))->size;
+      }
       return ptr;
     } else {
       status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
@@ -342,9 +467,52 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   ORT_THROW(status.ErrorMessage());
 }
 
+std::unique_lock<OrtMutex> BFCArena::AcquireLock() {
+  std::unique_lock<OrtMutex> lock(lock_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    lock.lock();
+    ++stats_.num_lock_contentions;
+  }
+
+  ++stats_.num_lock_acquisitions;
+  return lock;
+}
+
 void BFCArena::GetStats(AllocatorStats* stats) {
-  std::lock_guard<OrtMutex> lock(lock_);
-  *stats = stats_;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    *stats = stats_;
+
+    stats->num_regions = static_cast<int64_t>(region_manager_.regions().size());
+    stats->free_bytes_per_bin.resize(kNumBins);
+    for (BinNum b = 0; b < kNumBins; b++) {
+      const Bin* bin = BinFromIndex(b);
+      stats->free_bytes_per_bin[b] = static_cast<int64_t>(bin->free_bytes);
+    }
+
+    // free chunks in a bin are sorted by size so the largest is the last chunk of the last non-empty bin
+    for (BinNum b = kNumBins - 1; b >= 0; b--) {
+      const Bin* bin = BinFromIndex(b);
+      if (!bin->free_chunks.empty()) {
+        stats->largest_free_chunk = static_cast<int64_t>(ChunkFromHandle(*bin->free_chunks.rbegin())->size);
+        break;
+      }
+    }
+  }
+
+  if (!ThreadCacheEnabled()) {
+    return;
+  }
+
+  // chunks in the thread caches are in use as far as the bins are concerned
+  std::lock_guard<OrtMutex> guard(thread_caches_lock_);
+  for (const auto& cache : thread_caches_) {
+    std::lock_guard<OrtMutex> cache_guard(cache->mutex);
+    stats->num_allocs += cache->num_hits;
+    stats->num_thread_cache_hits += cache->num_hits;
+    stats->bytes_in_use -= static_cast<int64_t>(cache->cached_bytes);
+    stats->bytes_in_thread_caches += static_cast<int64_t>(cache->cached_bytes);
+  }
 }
 
 void* BFCArena::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
@@ -373,6 +541,10 @@ void* BFCArena::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
           chunk = ChunkFromHandle(h);  // Update chunk pointer in case it moved
         }
 
+        if (shrink_idle_runs_ > 0) {
+          region_manager_.set_last_use_run(chunk->ptr, num_runs_);
+        }
+
         // The requested size of the returned chunk is what the user
         // has allocated.
         chunk->requested_size = num_bytes;
@@ -432,7 +604,41 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
-  std::lock_guard<OrtMutex> lock(lock_);
+
+  size_t chunk_size = 0;
+  if (ThreadCacheEnabled() && TryGetThreadCacheChunkSize(p, chunk_size)) {
+    // chunks larger than the largest class only occur when a chunk wasn't split and still fit its request
+    const size_t size_class = std::min(chunk_size, kMaxThreadCacheAllocationSize) / kMinAllocationSize - 1;
+    ThreadCache& cache = GetThreadCache();
+    std::vector<ThreadCache::Entry> released;
+    {
+      std::lock_guard<OrtMutex> guard(cache.mutex);
+      cache.free_lists[size_class].push_back({p, chunk_size});
+      cache.cached_bytes += chunk_size;
+
+      if (cache.cached_bytes > max_thread_cache_bytes_) {
+        // return the older half of the lists to the bins, largest classes first, until half the limit is cached
+        for (size_t c = kNumThreadCacheClasses; c-- > 0 && cache.cached_bytes > max_thread_cache_bytes_ / 2;) {
+          TakeOldestEntries(cache, c, (cache.free_lists[c].size() + 1) / 2, released);
+        }
+      } else if (++cache.frees_since_scavenge >= kThreadCacheScavengeInterval) {
+        // release the chunks that weren't needed since the last scavenge
+        cache.frees_since_scavenge = 0;
+        for (size_t c = 0; c < kNumThreadCacheClasses; ++c) {
+          TakeOldestEntries(cache, c, cache.low_water_marks[c], released);
+          cache.low_water_marks[c] = cache.free_lists[c].size();
+        }
+      }
+    }
+
+    if (!released.empty()) {
+      ReleaseThreadCacheEntries(released);
+    }
+
+    return;
+  }
+
+  auto lock = AcquireLock();
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
     device_allocator_->Free(it->first);
@@ -445,7 +651,47 @@ void BFCArena::Free(void* p) {
 }
 
 Status BFCArena::Shrink() {
+  if (ThreadCacheEnabled()) {
+    std::vector<ThreadCache::Entry> released;
+    {
+      std::lock_guard<OrtMutex> guard(thread_caches_lock_);
+      for (auto& cache : thread_caches_) {
+        std::lock_guard<OrtMutex> cache_guard(cache->mutex);
+        for (size_t c = 0; c < kNumThreadCacheClasses; ++c) {
+          TakeOldestEntries(*cache, c, cache->free_lists[c].size(), released);
+        }
+      }
+    }
+
+    if (!released.empty()) {
+      ReleaseThreadCacheEntries(released);
+    }
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
+  ReleaseFreeRegions(0);
+
+  // Will affect how the arena grows if the arena extend strategy is kNextPowerOfTwo
+  // In case the extend strategy is kSameAsRequested, the arena growth is exactly the size of the memory request itself
+  curr_region_allocation_bytes_ = initial_growth_chunk_size_bytes_;
+
+  return Status::OK();
+}
+
+void BFCArena::OnRunEnd() {
+  if (shrink_idle_runs_ <= 0) {
+    return;
+  }
+
+  auto lock = AcquireLock();
+  ++num_runs_;
+  if (ReleaseFreeRegions(shrink_idle_runs_) > 0) {
+    // same as Shrink(), grow from the initial growth size again if a burst of large requests comes back
+    curr_region_allocation_bytes_ = initial_growth_chunk_size_bytes_;
+  }
+}
+
+size_t BFCArena::ReleaseFreeRegions(int64_t min_idle_runs) {
   auto num_regions = region_manager_.regions().size();
   std::vector<void*> region_ptrs;
   std::vector<size_t> region_sizes;
@@ -453,12 +699,14 @@ Status BFCArena::Shrink() {
   region_sizes.reserve(num_regions);
 
   for (const auto& region : region_manager_.regions()) {
-    if (consider_first_allocation_region_for_shrinkage_ || region.id() != 0) {
+    if ((consider_first_allocation_region_for_shrinkage_ || region.id() != 0) &&
+        num_runs_ - region.last_use_run() >= min_idle_runs) {
       region_ptrs.push_back(region.ptr());
       region_sizes.push_back(region.memory_size());
     }
   }
 
+  size_t num_released = 0;
   size_t i = 0;
   for (void* region_ptr : region_ptrs) {
     bool deallocate_region = true;
@@ -468,8 +716,9 @@ Status BFCArena::Shrink() {
       const Chunk* c = ChunkFromHandle(h);
       if (c->in_use()) {
         // at-least one used chunk found in the allocation region -
-        // so we cannot deallocate it
+        // so we cannot deallocate it. count it as used so it isn't walked again for another min_idle_runs runs.
         deallocate_region = false;
+        region_manager_.set_last_use_run(region_ptr, num_runs_);
         break;
       }
       h = c->next;
@@ -496,16 +745,13 @@ Status BFCArena::Shrink() {
 
       device_allocator_->Free(region_ptr);
       region_manager_.RemoveAllocationRegion(region_ptr);
+      ++num_released;
     }
 
     ++i;
   }
 
-  // Will affect how the arena grows if the arena extend strategy is kNextPowerOfTwo
-  // In case the extend strategy is kSameAsRequested, the arena growth is exactly the size of the memory request itself
-  curr_region_allocation_bytes_ = initial_growth_chunk_size_bytes_;
-
-  return Status::OK();
+  return num_released;
 }
 
 void BFCArena::DeallocateRawInternal(void* ptr) {
@@ -563,6 +809,7 @@ void BFCArena::InsertFreeChunkIntoBin(BFCArena::ChunkHandle h) {
   Bin* new_bin = BinFromIndex(bin_num);
   c->bin_num = bin_num;
   new_bin->free_chunks.insert(h);
+  new_bin->free_bytes += c->size;
 }
 
 void BFCArena::RemoveFreeChunkIterFromBin(
@@ -572,6 +819,7 @@ void BFCArena::RemoveFreeChunkIterFromBin(
   Chunk* c = ChunkFromHandle(h);
   ORT_ENFORCE(!c->in_use() && (c->bin_num != kInvalidBinNum));
   free_chunks->erase(citer);
+  BinFromIndex(c->bin_num)->free_bytes -= c->size;
   c->bin_num = kInvalidBinNum;
 }
 
@@ -580,6 +828,7 @@ void BFCArena::RemoveFreeChunkFromBin(BFCArena::ChunkHandle h) {
   ORT_ENFORCE(!c->in_use() && (c->bin_num != kInvalidBinNum));
   ORT_ENFORCE(BinFromIndex(c->bin_num)->free_chunks.erase(h) > 0,
               "Could not find chunk in bin");
+  BinFromIndex(c->bin_num)->free_bytes -= c->size;
   c->bin_num = kInvalidBinNum;
 }
 
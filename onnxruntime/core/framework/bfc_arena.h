@@ -16,15 +16,18 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <vector>
 
 #include "onnxruntime_config.h"
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/common/logging/severity.h"
+#include "core/common/inlined_containers.h"
 #include "core/common/safeint.h"
 
 #include "core/platform/ort_mutex.h"
@@ -57,13 +60,24 @@ class BFCArena : public IAllocator {
   static const int DEFAULT_MAX_DEAD_BYTES_PER_CHUNK = 128 * 1024 * 1024;
   static const int DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES = 2 * 1024 * 1024;
   static const size_t DEFAULT_MAX_MEM = std::numeric_limits<size_t>::max();
+  static const size_t DEFAULT_MAX_THREAD_CACHE_BYTES = 0;
+  static const int DEFAULT_SHRINK_IDLE_RUNS = 0;
 
+  // Allocations up to this size (after rounding) are served by the per-thread caches if they are enabled.
+  static constexpr size_t kMaxThreadCacheAllocationSize = 64 * 1024;
+
+  // max_thread_cache_bytes: bytes of freed chunks each thread may keep for reuse without taking the arena lock.
+  // 0 disables the per-thread caches.
+  // shrink_idle_runs: number of Run calls after which an allocation region in which no chunk was allocated is
+  // released by OnRunEnd. 0 disables the policy.
   BFCArena(std::unique_ptr<IAllocator> resource_allocator,
            size_t total_memory,
            ArenaExtendStrategy arena_extend_strategy = DEFAULT_ARENA_EXTEND_STRATEGY,
            int initial_chunk_size_bytes = DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
            int max_dead_bytes_per_chunk = DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
-           int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES);
+           int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
+           size_t max_thread_cache_bytes = DEFAULT_MAX_THREAD_CACHE_BYTES,
+           int shrink_idle_runs = DEFAULT_SHRINK_IDLE_RUNS);
 
   ~BFCArena() override;
 
@@ -76,6 +90,7 @@ class BFCArena : public IAllocator {
   void Free(void* p) override;
 
   // Frees all allocation regions in which no chunk is in use.
+  // Chunks held by the per-thread caches are returned to the bins first.
   // Does not free any reserved chunks.
   // Resets the size that the arena will grow by in the next allocation to
   // `initial_growth_chunk_size_bytes_` but ultimately all
@@ -83,6 +98,11 @@ class BFCArena : public IAllocator {
   // and the allocation request.
   Status Shrink();
 
+  // Called at the end of each Run that uses the arena. Releases the allocation regions that are free and had no
+  // allocation in the last shrink_idle_runs Run calls, with the same rules as Shrink() for the first region.
+  // No-op if shrink_idle_runs is 0.
+  void OnRunEnd();
+
   void* Reserve(size_t size) override;
 
   FencePtr CreateFence(const SessionState* session_state) override {
@@ -97,9 +117,61 @@ class BFCArena : public IAllocator {
   size_t AllocatedSize(const void* ptr);
 
  private:
-  void* AllocateRawInternal(size_t num_bytes, bool dump_log_on_failure);
+  // Takes lock_ for Alloc/Free/Reserve and updates the lock contention stats.
+  std::unique_lock<OrtMutex> AcquireLock();
+
+  // If chunk_size is not null it is set to the size of the chunk that was allocated.
+  void* AllocateRawInternal(size_t num_bytes, bool dump_log_on_failure, size_t* chunk_size = nullptr);
   void DeallocateRawInternal(void* ptr);
 
+  // Per-thread cache of freed chunks, similar to the thread caches of tcmalloc.
+  // Chunks in a thread cache stay allocated from the point of view of the bins. They are filed by size class,
+  // class i holding chunks of at least (i + 1) * kMinAllocationSize bytes, and are reused for requests of that
+  // class without taking lock_. A thread returns chunks to the bins in one batch when it caches more than
+  // max_thread_cache_bytes_, and periodically releases the chunks that stayed unused since the previous scavenge.
+  // The mutex is only taken by the owning thread and by Shrink/GetStats so it is practically never contended.
+  struct ThreadCache {
+    struct Entry {
+      void* ptr;
+      size_t size;  // size of the chunk
+    };
+
+    OrtMutex mutex;
+    std::vector<std::vector<Entry>> free_lists;
+    // the smallest length of each free list since the last scavenge
+    std::vector<size_t> low_water_marks;
+    size_t cached_bytes = 0;
+    size_t frees_since_scavenge = 0;
+    int64_t num_hits = 0;
+  };
+
+  // Size classes tracked by the chunk owner map are sharded by address so concurrent Free calls rarely
+  // wait for each other.
+  struct alignas(64) ChunkOwnerShard {
+    OrtMutex mutex;
+    // chunks allocated for the thread caches and their sizes
+    InlinedHashMap<void*, size_t> chunk_sizes;
+  };
+
+  static constexpr size_t kNumThreadCacheClasses = kMaxThreadCacheAllocationSize / 256;
+  static constexpr size_t kNumChunkOwnerShards = 64;
+  // number of frees to a thread cache between scavenges
+  static constexpr size_t kThreadCacheScavengeInterval = 1024;
+
+  bool ThreadCacheEnabled() const noexcept { return max_thread_cache_bytes_ > 0; }
+  ThreadCache& GetThreadCache();
+  ChunkOwnerShard& ShardFor(const void* ptr);
+
+  // Returns true if `ptr` was allocated for the thread caches, and its chunk size in `size`.
+  bool TryGetThreadCacheChunkSize(void* ptr, size_t& size);
+
+  // Moves up to `count` of the oldest entries of free list `size_class` into `released`.
+  static void TakeOldestEntries(ThreadCache& cache, size_t size_class, size_t count,
+                                std::vector<ThreadCache::Entry>& released);
+
+  // Returns released thread cache entries to the bins with a single acquisition of lock_.
+  void ReleaseThreadCacheEntries(const std::vector<ThreadCache::Entry>& released);
+
   // A ChunkHandle is an index into the chunks_ vector in BFCAllocator
   // kInvalidChunkHandle means an invalid chunk
   using ChunkHandle = size_t;
@@ -189,6 +261,8 @@ class BFCArena : public IAllocator {
     // List of free chunks within the bin, sorted by chunk size.
     // Chunk * not owned.
     FreeChunkSet free_chunks;
+    // Sum of the sizes of free_chunks.
+    size_t free_bytes = 0;
     Bin(BFCArena* allocator, size_t bs)
         : bin_size(bs), free_chunks(ChunkComparator(allocator)) {}
   };
@@ -232,6 +306,8 @@ class BFCArena : public IAllocator {
     void* end_ptr() const { return end_ptr_; }
     size_t memory_size() const { return memory_size_; }
     int64_t id() const { return id_; }
+    int64_t last_use_run() const { return last_use_run_; }
+    void set_last_use_run(int64_t run) { last_use_run_ = run; }
     ChunkHandle get_handle(const void* p) const {
       return handles_[IndexFor(p)];
     }
@@ -244,6 +320,7 @@ class BFCArena : public IAllocator {
       std::swap(memory_size_, other.memory_size_);
       std::swap(end_ptr_, other.end_ptr_);
       std::swap(id_, other.id_);
+      std::swap(last_use_run_, other.last_use_run_);
       std::swap(handles_, other.handles_);
     }
 
@@ -263,6 +340,9 @@ class BFCArena : public IAllocator {
     // (May be used by the client to track which allocation region was allocated first, second, and so on)
     int64_t id_ = -1;
 
+    // The value of the arena's Run counter when a chunk of the region was last allocated or seen in use.
+    int64_t last_use_run_ = 0;
+
     // Array of size "memory_size / kMinAllocationSize".  It is
     // indexed by (p-base) / kMinAllocationSize, contains ChunkHandle
     // for the memory allocation represented by "p"
@@ -305,6 +385,7 @@ class BFCArena : public IAllocator {
       return MutableRegionFor(p)->set_handle(p, h);
     }
     void erase(const void* p) { return MutableRegionFor(p)->erase(p); }
+    void set_last_use_run(const void* p, int64_t run) { MutableRegionFor(p)->set_last_use_run(run); }
 
     const std::vector<AllocationRegion>& regions() const { return regions_; }
 
@@ -368,6 +449,10 @@ class BFCArena : public IAllocator {
   // Removes a free chunk from the bin.
   void RemoveFreeChunkFromBin(ChunkHandle h);
 
+  // Releases the allocation regions in which no chunk is in use and no chunk was allocated during the last
+  // 'min_idle_runs' Run calls. Returns the number of regions released. Requires lock_ to be held.
+  size_t ReleaseFreeRegions(int64_t min_idle_runs);
+
   // Removes the chunk metadata represented by 'h'.
   void DeleteChunk(ChunkHandle h);
 
@@ -469,6 +554,20 @@ class BFCArena : public IAllocator {
   const int max_dead_bytes_per_chunk_;
   const int initial_growth_chunk_size_bytes_;
 
+  const size_t max_thread_cache_bytes_;
+  const int shrink_idle_runs_;
+
+  // Number of OnRunEnd calls. Only counted if shrink_idle_runs_ is set.
+  int64_t num_runs_ = 0;
+
+  // Unique id of the arena used to find the thread caches of this arena from thread local storage.
+  // Not reused by later arenas so a stale entry of a destroyed arena is never matched.
+  const uint64_t arena_id_;
+
+  OrtMutex thread_caches_lock_;
+  std::vector<std::unique_ptr<ThreadCache>> thread_caches_;
+  std::array<ChunkOwnerShard, kNumChunkOwnerShards> chunk_owner_shards_;
+
   // This flag is only relevant if Shrink() is invoked.
   // This is a boolean flag that controls whether the first allocation region
   // is to be considered for shrinkage or not.
@@ -9,6 +9,7 @@
 #include "core/framework/execution_plan_base.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/framework/ort_value_pattern_planner.h"
+#include "core/framework/region_arena.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/mldata_type_utils.h"
 #include "core/framework/sparse_utils.h"
@@ -360,6 +361,15 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
   session_state.GetMemoryProfiler()->GetMemoryInfo().IncreaseIteration();
 #endif
 
+  // created after Init so graph outputs provided by initializers are allocated from the session's allocators
+  const auto& region_arena_chunk_pools = session_state.GetRegionArenaChunkPools();
+  if (!region_arena_chunk_pools.empty()) {
+    region_arenas_.reserve(region_arena_chunk_pools.size());
+    for (const auto& location_pool : region_arena_chunk_pools) {
+      region_arenas_.emplace(location_pool.first, std::make_shared<RegionArena>(location_pool.second));
+    }
+  }
+
   // map the custom allocators to ort_value_idx entries
   if (!fetch_allocators.empty()) {
     custom_allocators_.reserve(fetch_allocators.size());
@@ -387,10 +397,33 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
 
     // if there are some traditional ml value type in inputs disable the memory pattern optimization.
     if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(feeds, feed_mlvalue_idxs, inferred_shapes_);
+      const auto* static_memory_plan = session_state.GetStaticMemoryPlan();
+      if (static_memory_plan) {
+        // activation shapes are fixed, so the patterns planned at initialization apply to every run
+        mem_pattern_entry_ = static_memory_plan->GetMemoryPatterns();
+      } else {
+        mem_pattern_entry_ = session_state.GetMemoryPatternGroup(feeds, feed_mlvalue_idxs);
+      }
+
+      if (mem_pattern_entry_) {
+        mem_patterns_ = &mem_pattern_entry_->mem_patterns;
+        inferred_shapes_ = &mem_pattern_entry_->inferred_shapes;
+        allow_larger_pattern_blocks_ =
+            session_state.GetMemoryPatternCache().BucketPolicy() != MemoryPatternBucketPolicy::kExact;
+      }
+
       // if no existing patterns, generate one in this execution frame
       if (!mem_patterns_) {
         planner_.emplace(*session_state.GetExecutionPlan());
+      } else if (static_memory_plan) {
+        // borrow buffers that were allocated for the plan up front. they're returned in the destructor.
+        static_slabs_ = static_memory_plan->AcquireSlabs();
+        buffers_.reserve(mem_patterns_->locations.size());
+        for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
+          if (static_slabs_->buffers[i] != nullptr) {
+            buffers_[mem_patterns_->locations[i]] = BufferUniquePtr(static_slabs_->buffers[i].get(), BufferDeleter());
+          }
+        }
       } else {
         // pre-allocate the big chunk requested in memory pattern.
         // all the internal kernel's input/output tensors will be allocated on these buffer.
@@ -459,7 +492,11 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
   }
 }
 
-ExecutionFrame::~ExecutionFrame() = default;
+ExecutionFrame::~ExecutionFrame() {
+  if (static_slabs_) {
+    session_state_.GetStaticMemoryPlan()->ReleaseSlabs(std::move(static_slabs_));
+  }
+}
 
 Status ExecutionFrame::CopyTensor(const Tensor& src, Tensor& dest) const {
   return session_state_.GetDataTransferMgr().CopyTensor(src, dest);
@@ -522,8 +559,9 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
       if (block) {
         auto it = buffers_.find(location);
         if (it != buffers_.end()) {
-          // if the block is not correct, log message then fall back to default behavior
-          if (block->size_ == size) {
+          // if the block is not correct, log message then fall back to default behavior.
+          // a pattern planned for a bucket of input shapes has blocks sized for the largest shapes in the bucket.
+          if (block->size_ == size || (allow_larger_pattern_blocks_ && block->size_ > size)) {
             void* buffer = it->second.get();
             auto status = AllocateTensorWithPreAllocateBufferHelper(
                 ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
@@ -546,7 +584,8 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
   }
 
   // no memory pattern, or the pattern is not correct.
-  if (!alloc) alloc = GetAllocator(location);
+  // graph outputs are handed back to the caller so they don't come from the per-Run region arena.
+  if (!alloc) alloc = IsOutput(ort_value_index) ? session_state_.GetAllocator(location) : GetAllocator(location);
   Tensor::InitOrtValue(element_type, shape, std::move(alloc), ort_value);
 
   // trace the memory allocation.
@@ -795,6 +834,13 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_
 }
 
 AllocatorPtr ExecutionFrame::GetAllocatorImpl(const OrtMemoryInfo& info) const {
+  if (!region_arenas_.empty()) {
+    auto it = region_arenas_.find(info);
+    if (it != region_arenas_.end()) {
+      return it->second;
+    }
+  }
+
   return session_state_.GetAllocator(info);
 }
 
@@ -11,10 +11,12 @@
 #include "core/common/logging/logging.h"
 #include "core/common/status.h"
 #include "core/framework/iexecutor.h"
+#include "core/framework/mem_pattern_cache.h"
 #include "core/framework/ort_value.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/ort_value_pattern_planner.h"
 #include "core/framework/sequential_execution_plan.h"
+#include "core/framework/static_memory_planner.h"
 #include "core/framework/tensor.h"
 #include "core/graph/graph_viewer.h"
 
@@ -215,11 +217,19 @@ class ExecutionFrame final : public IExecutionFrame {
   // map of index to custom allocator
   InlinedHashMap<int, IExecutor::CustomAllocator> custom_allocators_;
 
+  // Cache entry holding mem_patterns_ and inferred_shapes_. Keeps them alive if the
+  // session's memory pattern cache evicts the entry while this frame is running.
+  std::shared_ptr<const MemoryPatternCacheEntry> mem_pattern_entry_;
+
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
   const MemoryPatternGroup* mem_patterns_;
 
+  // True if a pattern block larger than the requested size may be used, i.e. the cached
+  // pattern was planned for a bucket of input shapes rather than the exact shapes.
+  bool allow_larger_pattern_blocks_{false};
+
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
   std::optional<OrtValuePatternPlanner> planner_;
@@ -227,6 +237,12 @@ class ExecutionFrame final : public IExecutionFrame {
   // Big chunks on different locations that will be used by mem_pattern.
   InlinedHashMap<OrtMemoryInfo, BufferUniquePtr> buffers_;
 
+  // Per-Run region arenas for the locations the session has chunk pools for.
+  InlinedHashMap<OrtMemoryInfo, AllocatorPtr> region_arenas_;
+
+  // Buffers borrowed from the session's StaticMemoryPlan. buffers_ holds non-owning pointers to them.
+  std::unique_ptr<StaticMemoryPlan::Slabs> static_slabs_;
+
   // Given the input shapes of the executed graph, ExecutionFrame tries inferring
   // all symbolic shapes. inferred_shapes_[i] is the shape of OrtValue indexed
   // by i, if the key i exists.
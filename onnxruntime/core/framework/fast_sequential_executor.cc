@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/fast_sequential_executor.h"
+
+#include <sstream>
+
+#include "core/framework/execution_frame.h"
+#include "core/framework/op_kernel_context_internal.h"
+
+namespace onnxruntime {
+
+Status FastSequentialExecutor::Execute(const SessionState& session_state, gsl::span<const int> feed_mlvalue_idxs,
+                                       gsl::span<const OrtValue> feeds, gsl::span<const int> fetch_mlvalue_idxs,
+                                       std::vector<OrtValue>& fetches,
+                                       const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
+                                       const logging::Logger& logger) {
+  const SubgraphResultCache* subgraph_result_cache = session_state.GetSubgraphResultCache();
+  SubgraphResultCache::RunState cache_run_state;
+  if (subgraph_result_cache != nullptr) {
+    subgraph_result_cache->Lookup(feed_mlvalue_idxs, feeds, fetches, cache_run_state);
+  }
+
+  ExecutionFrame frame{feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators, session_state};
+
+  const int* values_to_release = dispatch_table_.values_to_release.data();
+  for (const auto& entry : dispatch_table_.entries) {
+    if (terminate_flag_) {
+      LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+    }
+
+    const OpKernel& kernel = *entry.kernel;
+    const NodeIndex node_index = kernel.Node().Index();
+    if (SubgraphResultCache::SkipNode(subgraph_result_cache, cache_run_state, node_index)) {
+      for (size_t i = entry.release_begin; i < entry.release_end; ++i) {
+        ORT_RETURN_IF_ERROR(frame.ReleaseMLValue(values_to_release[i]));
+      }
+
+      continue;
+    }
+
+    OpKernelContextInternal op_kernel_context(session_state, frame, kernel, logger, terminate_flag_);
+
+    Status compute_status;
+    ORT_TRY {
+      compute_status = kernel.Compute(&op_kernel_context);
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        compute_status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      });
+    }
+
+    if (!compute_status.IsOK()) {
+      const auto& node = kernel.Node();
+      std::ostringstream ss;
+      ss << "Non-zero status code returned while running " << node.OpType() << " node. Name:'" << node.Name()
+         << "' Status Message: " << compute_status.ErrorMessage();
+      const auto msg_string = ss.str();
+      LOGS(logger, ERROR) << msg_string;
+      return Status(compute_status.Category(), compute_status.Code(), msg_string);
+    }
+
+    if (subgraph_result_cache != nullptr) {
+      ORT_RETURN_IF_ERROR(subgraph_result_cache->CaptureOutputs(node_index, op_kernel_context, cache_run_state));
+    }
+
+    for (size_t i = entry.release_begin; i < entry.release_end; ++i) {
+      ORT_RETURN_IF_ERROR(frame.ReleaseMLValue(values_to_release[i]));
+    }
+  }
+
+  ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
+
+  if (subgraph_result_cache != nullptr) {
+    subgraph_result_cache->Insert(cache_run_state);
+  }
+
+  if (frame.HasMemoryPatternPlanner()) {
+    bool all_tensors = true;
+    for (const auto& feed : feeds) {
+      if (!(feed.IsTensor())) {
+        all_tensors = false;
+        break;
+      }
+    }
+
+    if (all_tensors) {
+      MemoryPatternGroup mem_patterns;
+      ORT_RETURN_IF_ERROR(frame.GeneratePatterns(mem_patterns));
+      ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(feeds, std::move(mem_patterns)));
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
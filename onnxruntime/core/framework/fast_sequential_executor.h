@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/iexecutor.h"
+#include "core/framework/framework_common.h"
+#include "core/framework/kernel_dispatch_table.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/session_state.h"
+
+namespace onnxruntime {
+
+// Sequential executor for graphs where the per-node overhead of SequentialExecutor is significant compared to the
+// kernels, e.g. tree ensembles or small MLPs. Runs the kernels of the session's KernelDispatchTable in a tight loop
+// without profiling, tracing, fences or node input/output dumping. Only used when the profiler is off and all nodes
+// are executed.
+class FastSequentialExecutor : public IExecutor {
+ public:
+  FastSequentialExecutor(const KernelDispatchTable& dispatch_table, const bool& terminate_flag = false)
+      : dispatch_table_{dispatch_table}, terminate_flag_{terminate_flag} {}
+
+  common::Status Execute(const SessionState& session_state, gsl::span<const int> feed_mlvalue_idxs,
+                         gsl::span<const OrtValue> feeds, gsl::span<const int> fetch_mlvalue_idxs,
+                         std::vector<OrtValue>& fetches,
+                         const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
+                         const logging::Logger& logger) override;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(FastSequentialExecutor);
+  const KernelDispatchTable& dispatch_table_;
+  const bool& terminate_flag_;
+};
+}  // namespace onnxruntime
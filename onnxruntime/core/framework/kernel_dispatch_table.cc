@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/kernel_dispatch_table.h"
+
+#include "core/framework/op_kernel.h"
+#include "core/framework/session_state.h"
+
+namespace onnxruntime {
+
+Status KernelDispatchTable::Create(const SessionState& session_state, const SequentialExecutionPlan& plan,
+                                   std::optional<KernelDispatchTable>& table) {
+  table.reset();
+
+  KernelDispatchTable new_table;
+  new_table.entries.reserve(plan.execution_plan.size());
+
+  for (const auto& node_exec_plan : plan.execution_plan) {
+    const auto node_index = node_exec_plan.node_index;
+    if (plan.NodeHasFence(node_index)) {
+      return Status::OK();
+    }
+
+    const auto* kernel = session_state.GetKernel(node_index);
+    ORT_RETURN_IF(kernel == nullptr, "Got nullptr from GetKernel for node index ", node_index);
+
+#ifdef ENABLE_TRAINING
+    if (kernel->KernelDef().AllocateInputsContiguously()) {
+      return Status::OK();
+    }
+#endif
+
+    Entry entry{kernel, new_table.values_to_release.size(), 0};
+    for (auto i = node_exec_plan.free_from_index; i <= node_exec_plan.free_to_index; ++i) {
+      new_table.values_to_release.push_back(plan.to_be_freed[i]);
+    }
+
+    entry.release_end = new_table.values_to_release.size();
+    new_table.entries.push_back(entry);
+  }
+
+  table.emplace(std::move(new_table));
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
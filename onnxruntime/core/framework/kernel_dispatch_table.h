@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/sequential_execution_plan.h"
+
+namespace onnxruntime {
+
+class OpKernel;
+class SessionState;
+
+// Flattened form of a SequentialExecutionPlan for FastSequentialExecutor: the kernel of every node in execution
+// order and the OrtValues to release after it ran, resolved once when the session state is finalized so a Run
+// doesn't go through the graph, the kernel map and the plan for every node. The input and output OrtValue indices
+// of the nodes are already laid out in one flat array by NodeIndexInfo, which OpKernelContext indexes into.
+struct KernelDispatchTable {
+  struct Entry {
+    const OpKernel* kernel;
+    // the OrtValues to release after the kernel ran are values_to_release[release_begin, release_end)
+    size_t release_begin;
+    size_t release_end;
+  };
+
+  std::vector<Entry> entries;
+  std::vector<int> values_to_release;
+
+  // Creates the table for the plan. `table` is left empty if the plan needs something the fast path doesn't
+  // support, e.g. fences or kernels that require contiguous inputs.
+  static Status Create(const SessionState& session_state, const SequentialExecutionPlan& plan,
+                       std::optional<KernelDispatchTable>& table);
+};
+
+}  // namespace onnxruntime
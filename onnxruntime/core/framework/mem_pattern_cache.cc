@@ -0,0 +1,161 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+
+#include "core/common/hash_combine.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+void MemoryPatternCache::Configure(MemoryPatternBucketPolicy policy, size_t capacity) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  policy_ = policy;
+  capacity_ = capacity;
+  // keys computed with a different policy are meaningless now
+  entries_.clear();
+  lru_.clear();
+}
+
+Status MemoryPatternCache::ParseBucketPolicy(const std::string& value, MemoryPatternBucketPolicy& policy) {
+  if (value.empty() || value == "exact") {
+    policy = MemoryPatternBucketPolicy::kExact;
+  } else if (value == "pow2") {
+    policy = MemoryPatternBucketPolicy::kPowerOfTwo;
+  } else {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Invalid memory pattern bucket policy '", value, "'. Valid values are 'exact' and 'pow2'.");
+  }
+
+  return Status::OK();
+}
+
+int64_t MemoryPatternCache::BucketDim(int64_t dim, MemoryPatternBucketPolicy policy) {
+  if (policy == MemoryPatternBucketPolicy::kExact || dim <= 1) {
+    return dim;
+  }
+
+  int64_t bucket = 1;
+  while (bucket < dim) {
+    bucket <<= 1;
+  }
+
+  return bucket;
+}
+
+size_t MemoryPatternCache::CalculateKey(gsl::span<const OrtValue> tensor_inputs) const {
+  size_t key = 0;
+  for (const auto& input : tensor_inputs) {
+    const auto dims = input.Get<Tensor>().Shape().GetDims();
+    // include the rank so inputs with the same dims split differently don't collide
+    HashCombine(dims.size(), key);
+    for (auto dim : dims) {
+      HashCombine(BucketDim(dim, policy_), key);
+    }
+  }
+
+  return key;
+}
+
+bool MemoryPatternCache::CanServe(const MemoryPatternCacheEntry& entry,
+                                  gsl::span<const OrtValue> tensor_inputs) const {
+  if (entry.planned_input_dims.size() != tensor_inputs.size()) {
+    return false;
+  }
+
+  for (size_t i = 0, end = tensor_inputs.size(); i < end; ++i) {
+    const auto dims = tensor_inputs[i].Get<Tensor>().Shape().GetDims();
+    const auto& planned_dims = entry.planned_input_dims[i];
+    if (dims.size() != planned_dims.size()) {
+      return false;
+    }
+
+    for (size_t d = 0, rank = dims.size(); d < rank; ++d) {
+      // in bucketed mode a pattern planned for larger inputs is good enough for smaller ones in the same bucket.
+      // individual blocks that turn out to be too small fall back to the allocator in ExecutionFrame.
+      const bool fits = policy_ == MemoryPatternBucketPolicy::kExact ? dims[d] == planned_dims[d]
+                                                                      : dims[d] <= planned_dims[d];
+      if (!fits) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+std::shared_ptr<const MemoryPatternCacheEntry> MemoryPatternCache::Find(
+    gsl::span<const OrtValue> tensor_inputs) const {
+  const size_t key = CalculateKey(tensor_inputs);
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end() || !CanServe(*it->second.entry, tensor_inputs)) {
+    ++num_misses_;
+    return nullptr;
+  }
+
+  ++num_hits_;
+  lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+  return it->second.entry;
+}
+
+std::shared_ptr<const MemoryPatternCacheEntry> MemoryPatternCache::Insert(
+    gsl::span<const OrtValue> tensor_inputs,
+    MemoryPatternGroup mem_patterns,
+    InlinedHashMap<int, TensorShape> inferred_shapes) const {
+  const size_t key = CalculateKey(tensor_inputs);
+
+  auto entry = std::make_shared<MemoryPatternCacheEntry>();
+  entry->mem_patterns = std::move(mem_patterns);
+  entry->inferred_shapes = std::move(inferred_shapes);
+  entry->planned_input_dims.reserve(tensor_inputs.size());
+  for (const auto& input : tensor_inputs) {
+    entry->planned_input_dims.push_back(input.Get<Tensor>().Shape().AsShapeVector());
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    // another Run may have cached a pattern for these inputs concurrently. keep it if it's usable, as existing
+    // ExecutionFrame instances may be sharing it.
+    if (!CanServe(*it->second.entry, tensor_inputs)) {
+      it->second.entry = std::move(entry);
+    }
+
+    lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+    return it->second.entry;
+  }
+
+  if (capacity_ > 0 && entries_.size() >= capacity_) {
+    entries_.erase(lru_.back());
+    lru_.pop_back();
+    ++num_evictions_;
+  }
+
+  lru_.push_front(key);
+  auto inserted = entries_.emplace(key, Slot{std::move(entry), lru_.begin()});
+  return inserted.first->second.entry;
+}
+
+size_t MemoryPatternCache::NumHits() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return num_hits_;
+}
+
+size_t MemoryPatternCache::NumMisses() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return num_misses_;
+}
+
+size_t MemoryPatternCache::NumEvictions() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return num_evictions_;
+}
+
+size_t MemoryPatternCache::Size() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return entries_.size();
+}
+
+}  // namespace onnxruntime
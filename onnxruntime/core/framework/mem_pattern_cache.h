@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+
+#include "core/common/gsl.h"
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/tensor_shape.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// How input shapes are mapped to a memory pattern cache key.
+enum class MemoryPatternBucketPolicy {
+  // A memory pattern is only reused for the exact same set of input shapes.
+  kExact = 0,
+  // Every input dimension is rounded up to the next power of two. Requests whose shapes fall into the same bucket
+  // share one memory pattern, which is traced with the largest shapes seen in that bucket so far.
+  kPowerOfTwo = 1,
+};
+
+// A cached memory pattern together with the information needed to decide whether it can serve a request.
+struct MemoryPatternCacheEntry {
+  MemoryPatternGroup mem_patterns;
+  // Shapes inferred for activations while generating the pattern from symbolic dims. Empty if traced at run time.
+  InlinedHashMap<int, TensorShape> inferred_shapes;
+  // Input shapes the pattern was generated with.
+  InlinedVector<TensorShapeVector> planned_input_dims;
+};
+
+/**
+ * Bounded LRU cache of memory patterns keyed by (optionally bucketed) input shapes.
+ * Entries are handed out as shared pointers so an entry evicted or replaced while an ExecutionFrame is still
+ * using it stays alive until that frame is destroyed.
+ * Thread-safe.
+ */
+class MemoryPatternCache {
+ public:
+  MemoryPatternCache() = default;
+
+  // capacity of 0 means the cache is unbounded.
+  void Configure(MemoryPatternBucketPolicy policy, size_t capacity);
+
+  MemoryPatternBucketPolicy BucketPolicy() const noexcept { return policy_; }
+
+  // Returns the entry that can serve the given inputs, or nullptr. Updates the hit/miss counters.
+  std::shared_ptr<const MemoryPatternCacheEntry> Find(gsl::span<const OrtValue> tensor_inputs) const;
+
+  // Insert a pattern generated for the given inputs and return the entry now cached for their key.
+  // An existing entry is only replaced if it cannot serve the given inputs, so the pattern for a bucket
+  // grows towards the largest shapes seen in it.
+  std::shared_ptr<const MemoryPatternCacheEntry> Insert(gsl::span<const OrtValue> tensor_inputs,
+                                                        MemoryPatternGroup mem_patterns,
+                                                        InlinedHashMap<int, TensorShape> inferred_shapes = {}) const;
+
+  size_t NumHits() const;
+  size_t NumMisses() const;
+  size_t NumEvictions() const;
+  size_t Size() const;
+
+  // Parse a value of the kOrtSessionOptionsConfigMemoryPatternBucketPolicy session config key.
+  static Status ParseBucketPolicy(const std::string& value, MemoryPatternBucketPolicy& policy);
+
+  // Round dim up to the bucket it falls into under the given policy.
+  static int64_t BucketDim(int64_t dim, MemoryPatternBucketPolicy policy);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryPatternCache);
+
+  size_t CalculateKey(gsl::span<const OrtValue> tensor_inputs) const;
+  bool CanServe(const MemoryPatternCacheEntry& entry, gsl::span<const OrtValue> tensor_inputs) const;
+
+  using LruList = std::list<size_t>;
+
+  struct Slot {
+    std::shared_ptr<const MemoryPatternCacheEntry> entry;
+    LruList::iterator lru_position;
+  };
+
+  MemoryPatternBucketPolicy policy_{MemoryPatternBucketPolicy::kExact};
+  size_t capacity_{0};
+
+  mutable OrtMutex mutex_;
+  // most recently used key is at the front
+  mutable LruList lru_;
+  mutable InlinedHashMap<size_t, Slot> entries_;
+  mutable size_t num_hits_{0};
+  mutable size_t num_misses_{0};
+  mutable size_t num_evictions_{0};
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/parallel_execution_schedule.h"
+
+#include <algorithm>
+
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+namespace {
+// Rough estimate of the work done by a node: the number of output elements, with symbolic dims counted as 1.
+// Only relative values matter as this is used to order ready nodes.
+double EstimateNodeCost(const Node& node) {
+  double cost = 1.0;
+  for (const auto* output_def : node.OutputDefs()) {
+    if (!output_def->Exists()) {
+      continue;
+    }
+
+    const auto* shape = output_def->Shape();
+    if (shape == nullptr) {
+      continue;
+    }
+
+    double num_elements = 1.0;
+    for (const auto& dim : shape->dim()) {
+      if (dim.has_dim_value() && dim.dim_value() > 0) {
+        num_elements *= static_cast<double>(dim.dim_value());
+      }
+    }
+
+    cost += num_elements;
+  }
+
+  return cost;
+}
+}  // namespace
+
+Status ParallelExecutionSchedule::Create(const GraphViewer& graph_viewer, const SequentialExecutionPlan& plan,
+                                         ParallelExecutionSchedule& schedule) {
+  const auto& execution_plan = plan.execution_plan;
+  const size_t num_nodes = execution_plan.size();
+
+  schedule.nodes.clear();
+  schedule.nodes.reserve(num_nodes);
+
+  std::vector<size_t> position_of_node(graph_viewer.MaxNodeIndex(), kInvalidPosition);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    const auto node_index = execution_plan[i].node_index;
+    ORT_RETURN_IF_NOT(node_index < position_of_node.size(), "Invalid node index in execution plan: ", node_index);
+    position_of_node[node_index] = i;
+    schedule.nodes.push_back(node_index);
+  }
+
+  schedule.dependency_counts.assign(num_nodes, 0);
+  schedule.successor_offsets.assign(num_nodes + 1, 0);
+  schedule.successors.clear();
+
+  std::vector<size_t> node_successors;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    const auto* node = graph_viewer.GetNode(schedule.nodes[i]);
+    ORT_RETURN_IF(node == nullptr, "Execution plan contains a node that is not in the graph: ", schedule.nodes[i]);
+
+    node_successors.clear();
+    for (auto it = node->OutputEdgesBegin(), end = node->OutputEdgesEnd(); it != end; ++it) {
+      const size_t successor = position_of_node[it->GetNode().Index()];
+      if (successor != kInvalidPosition) {
+        node_successors.push_back(successor);
+      }
+    }
+
+    // a node may consume several outputs of the same upstream node. count each dependency once.
+    std::sort(node_successors.begin(), node_successors.end());
+    node_successors.erase(std::unique(node_successors.begin(), node_successors.end()), node_successors.end());
+
+    for (size_t successor : node_successors) {
+      ORT_RETURN_IF_NOT(successor > i, "Execution plan is not in topological order.");
+      ++schedule.dependency_counts[successor];
+      schedule.successors.push_back(successor);
+    }
+
+    schedule.successor_offsets[i + 1] = schedule.successors.size();
+  }
+
+  // the execution plan is topologically sorted, so walking it backwards visits all successors of a node first.
+  schedule.priorities.assign(num_nodes, 0.0);
+  for (size_t i = num_nodes; i-- > 0;) {
+    double longest_successor_path = 0.0;
+    for (size_t successor : schedule.Successors(i)) {
+      longest_successor_path = std::max(longest_successor_path, schedule.priorities[successor]);
+    }
+
+    schedule.priorities[i] = EstimateNodeCost(*graph_viewer.GetNode(schedule.nodes[i])) + longest_successor_path;
+  }
+
+  schedule.roots.clear();
+  for (size_t i = 0; i < num_nodes; ++i) {
+    if (schedule.dependency_counts[i] == 0) {
+      schedule.roots.push_back(i);
+    }
+  }
+
+  std::stable_sort(schedule.roots.begin(), schedule.roots.end(), [&schedule](size_t a, size_t b) {
+    return schedule.priorities[a] > schedule.priorities[b];
+  });
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/common/gsl.h"
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/sequential_execution_plan.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+
+class GraphViewer;
+
+// Dependency information derived from a SequentialExecutionPlan for executors that run nodes as soon as
+// their inputs are ready. Nodes are referred to by their position in SequentialExecutionPlan::execution_plan.
+// Created once per session so executors only need to copy the dependency counts on each run.
+struct ParallelExecutionSchedule {
+  static constexpr size_t kInvalidPosition = static_cast<size_t>(-1);
+
+  // node index of the node at each position
+  std::vector<NodeIndex> nodes;
+
+  // number of distinct upstream nodes each node has to wait for
+  std::vector<int> dependency_counts;
+
+  // downstream nodes of the node at position i are successors[successor_offsets[i]..successor_offsets[i + 1])
+  std::vector<size_t> successor_offsets;
+  std::vector<size_t> successors;
+
+  // estimated cost of the longest path from the node to the end of the graph, including the node itself.
+  // nodes with a higher priority are on the critical path and should run first.
+  std::vector<double> priorities;
+
+  // positions of nodes without dependencies, in descending priority order
+  std::vector<size_t> roots;
+
+  size_t NumNodes() const noexcept { return nodes.size(); }
+
+  gsl::span<const size_t> Successors(size_t position) const {
+    return gsl::make_span(successors.data() + successor_offsets[position],
+                          successor_offsets[position + 1] - successor_offsets[position]);
+  }
+
+  static Status Create(const GraphViewer& graph_viewer, const SequentialExecutionPlan& plan,
+                       ParallelExecutionSchedule& schedule);
+};
+
+}  // namespace onnxruntime
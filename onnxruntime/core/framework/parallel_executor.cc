@@ -98,7 +98,12 @@ Status ParallelExecutor::Execute(const SessionState& session_state, gsl::span<co
   }
 
   if (is_profiler_enabled) {
-    session_state.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "ParallelExecutor::Execute", tp);
+    const auto& mem_pattern_cache = session_state.GetMemoryPatternCache();
+    session_state.Profiler().EndTimeAndRecordEvent(
+        profiling::SESSION_EVENT, "ParallelExecutor::Execute", tp,
+        {{"mem_pattern_cache_hits", std::to_string(mem_pattern_cache.NumHits())},
+         {"mem_pattern_cache_misses", std::to_string(mem_pattern_cache.NumMisses())},
+         {"mem_pattern_cache_evictions", std::to_string(mem_pattern_cache.NumEvictions())}});
   }
 
   return Status::OK();
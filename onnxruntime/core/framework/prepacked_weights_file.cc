@@ -0,0 +1,182 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/prepacked_weights_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "core/common/make_string.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// The file starts with the magic and the number of weights. Each weight is described by the size and bytes of its
+// key, the number of its buffers and the offset and size of each buffer. The buffers follow the descriptions, each
+// aligned to kBufferAlignment bytes from the start of the file so a mapped buffer is as aligned as an allocated one.
+constexpr char kMagic[] = {'O', 'R', 'T', 'P', 'P', 'W', '0', '1'};
+constexpr uint64_t kBufferAlignment = 64;
+
+std::string MakeKey(NodeIndex node_index, const std::string& op_domain, const std::string& op_type, int input_idx,
+                    const std::string& initializer_name) {
+  // the length prefixes keep names containing ':' from producing the key of another input
+  return MakeString(node_index, ':', op_domain.size(), ':', op_domain, ':', op_type.size(), ':', op_type, ':',
+                    input_idx, ':', initializer_name);
+}
+
+uint64_t AlignOffset(uint64_t offset) {
+  return (offset + kBufferAlignment - 1) / kBufferAlignment * kBufferAlignment;
+}
+
+class Reader {
+ public:
+  Reader(const char* data, size_t size) : data_(data), size_(size) {}
+
+  Status Read(void* dst, size_t size) {
+    ORT_RETURN_IF(size > size_ - offset_, "Pre-packed weights file is truncated.");
+    memcpy(dst, data_ + offset_, size);
+    offset_ += size;
+    return Status::OK();
+  }
+
+  Status ReadUInt64(uint64_t& value) {
+    return Read(&value, sizeof(value));
+  }
+
+ private:
+  const char* data_;
+  size_t size_;
+  size_t offset_ = 0;
+};
+
+void WriteUInt64(std::ofstream& file, uint64_t value) {
+  file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+}  // namespace
+
+Status PrepackedWeightsFile::Load(const PathString& path, std::unique_ptr<PrepackedWeightsFile>& file) {
+  const Env& env = Env::Default();
+  size_t file_length = 0;
+  ORT_RETURN_IF_ERROR(env.GetFileLength(path.c_str(), file_length));
+
+  auto loaded = std::make_unique<PrepackedWeightsFile>();
+  ORT_RETURN_IF_ERROR(env.MapFileIntoMemory(path.c_str(), 0, file_length, loaded->mapped_file_));
+  const char* data = loaded->mapped_file_.get();
+  ORT_RETURN_IF(data == nullptr, "Pre-packed weights file is empty: ", ToUTF8String(path));
+
+  Reader reader(data, file_length);
+  char magic[sizeof(kMagic)];
+  ORT_RETURN_IF_ERROR(reader.Read(magic, sizeof(magic)));
+  ORT_RETURN_IF(memcmp(magic, kMagic, sizeof(kMagic)) != 0,
+                "Not a pre-packed weights file: ", ToUTF8String(path));
+
+  uint64_t num_weights = 0;
+  ORT_RETURN_IF_ERROR(reader.ReadUInt64(num_weights));
+  for (uint64_t i = 0; i < num_weights; ++i) {
+    uint64_t key_size = 0;
+    ORT_RETURN_IF_ERROR(reader.ReadUInt64(key_size));
+    ORT_RETURN_IF(key_size > file_length, "Pre-packed weights file is truncated.");
+    std::string key(static_cast<size_t>(key_size), '\0');
+    ORT_RETURN_IF_ERROR(reader.Read(key.data(), key.size()));
+
+    uint64_t num_buffers = 0;
+    ORT_RETURN_IF_ERROR(reader.ReadUInt64(num_buffers));
+    ORT_RETURN_IF(num_buffers > file_length, "Pre-packed weights file is truncated.");
+
+    PrePackedWeights weights;
+    for (uint64_t j = 0; j < num_buffers; ++j) {
+      uint64_t offset = 0;
+      uint64_t size = 0;
+      ORT_RETURN_IF_ERROR(reader.ReadUInt64(offset));
+      ORT_RETURN_IF_ERROR(reader.ReadUInt64(size));
+      ORT_RETURN_IF(offset > file_length || size > file_length - offset,
+                    "Pre-packed buffer is outside of the file: ", ToUTF8String(path));
+
+      // the mapping owns the memory, so the buffers must not be freed. kernels may leave unused buffers empty.
+      void* buffer = size != 0 ? const_cast<char*>(data) + offset : nullptr;
+      weights.buffers_.push_back(BufferUniquePtr(buffer, BufferDeleter(nullptr)));
+      weights.buffer_sizes_.push_back(static_cast<size_t>(size));
+    }
+
+    loaded->weights_.insert_or_assign(std::move(key), std::move(weights));
+  }
+
+  file = std::move(loaded);
+  return Status::OK();
+}
+
+Status PrepackedWeightsFile::Save(const PathString& path) const {
+  // sort the keys so the same weights always produce the same file
+  std::vector<const std::string*> keys;
+  keys.reserve(weights_.size());
+  for (const auto& entry : weights_) {
+    keys.push_back(&entry.first);
+  }
+  std::sort(keys.begin(), keys.end(), [](const std::string* a, const std::string* b) { return *a < *b; });
+
+  uint64_t header_size = sizeof(kMagic) + sizeof(uint64_t);
+  for (const std::string* key : keys) {
+    const PrePackedWeights& weights = weights_.at(*key);
+    header_size += sizeof(uint64_t) + key->size() + sizeof(uint64_t) +
+                   weights.buffers_.size() * 2 * sizeof(uint64_t);
+  }
+
+  std::ofstream file(path, std::ios::binary);
+  ORT_RETURN_IF_NOT(file, "Failed to open pre-packed weights file for writing: ", ToUTF8String(path));
+
+  file.write(kMagic, sizeof(kMagic));
+  WriteUInt64(file, keys.size());
+  uint64_t offset = header_size;
+  for (const std::string* key : keys) {
+    const PrePackedWeights& weights = weights_.at(*key);
+    WriteUInt64(file, key->size());
+    file.write(key->data(), key->size());
+    WriteUInt64(file, weights.buffers_.size());
+    for (size_t size : weights.buffer_sizes_) {
+      offset = AlignOffset(offset);
+      WriteUInt64(file, offset);
+      WriteUInt64(file, size);
+      offset += size;
+    }
+  }
+
+  offset = header_size;
+  const char padding[kBufferAlignment] = {};
+  for (const std::string* key : keys) {
+    const PrePackedWeights& weights = weights_.at(*key);
+    for (size_t j = 0; j < weights.buffers_.size(); ++j) {
+      const uint64_t aligned_offset = AlignOffset(offset);
+      file.write(padding, static_cast<std::streamsize>(aligned_offset - offset));
+      file.write(static_cast<const char*>(weights.buffers_[j].get()),
+                 static_cast<std::streamsize>(weights.buffer_sizes_[j]));
+      offset = aligned_offset + weights.buffer_sizes_[j];
+    }
+  }
+
+  file.flush();
+  ORT_RETURN_IF_NOT(file, "Failed to save pre-packed weights file: ", ToUTF8String(path));
+  return Status::OK();
+}
+
+const PrePackedWeights* PrepackedWeightsFile::GetWeights(NodeIndex node_index, const std::string& op_domain,
+                                                         const std::string& op_type, int input_idx,
+                                                         const std::string& initializer_name) const {
+  auto it = weights_.find(MakeKey(node_index, op_domain, op_type, input_idx, initializer_name));
+  return it != weights_.end() ? &it->second : nullptr;
+}
+
+const PrePackedWeights* PrepackedWeightsFile::AddWeights(NodeIndex node_index, const std::string& op_domain,
+                                                         const std::string& op_type, int input_idx,
+                                                         const std::string& initializer_name,
+                                                         PrePackedWeights&& weights) {
+  // a kernel may already use the buffers of the stored weights, so they are never replaced
+  auto result = weights_.try_emplace(MakeKey(node_index, op_domain, op_type, input_idx, initializer_name),
+                                     std::move(weights));
+  return result.second ? &result.first->second : nullptr;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+#include "core/framework/prepacked_weights.h"
+#include "core/graph/basic_types.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+// The pre-packed weights of the kernels of a graph, keyed by node index, op type, input index and initializer name.
+// Node names can be empty or repeated, but node indices are unique and kept by ORT format models.
+// A session records the weights its kernels pre-pack and saves them next to the optimized model in the optimized
+// model cache. A later session loading that optimized model maps the file into memory and hands the buffers to the
+// kernels instead of calling PrePack() again.
+class PrepackedWeightsFile final {
+ public:
+  PrepackedWeightsFile() = default;
+
+  // Maps the file at the given path into memory and indexes the weights it contains.
+  static Status Load(const PathString& path, std::unique_ptr<PrepackedWeightsFile>& file);
+
+  // Saves the weights that were added to the file at the given path.
+  Status Save(const PathString& path) const;
+
+  // Returns the weights for the input of the node, or nullptr if there are none.
+  // The buffers of the returned instance are not owned by it when the file was loaded.
+  const PrePackedWeights* GetWeights(NodeIndex node_index, const std::string& op_domain, const std::string& op_type,
+                                     int input_idx, const std::string& initializer_name) const;
+
+  // Adds weights to be saved. Returns the stored instance, which owns the buffers for the lifetime of this instance,
+  // or nullptr if weights were already added for the input of the node, which are kept.
+  const PrePackedWeights* AddWeights(NodeIndex node_index, const std::string& op_domain, const std::string& op_type,
+                                     int input_idx, const std::string& initializer_name, PrePackedWeights&& weights);
+
+  size_t NumWeights() const { return weights_.size(); }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrepackedWeightsFile);
+
+ private:
+  // Mapped file the buffers of loaded weights point into. Declared before weights_ so it outlives them.
+  Env::MappedMemoryPtr mapped_file_;
+
+  std::unordered_map<std::string, PrePackedWeights> weights_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,144 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/region_arena.h"
+
+#include <algorithm>
+
+#include "core/common/safeint.h"
+
+namespace onnxruntime {
+
+RegionArenaChunkPool::RegionArenaChunkPool(AllocatorPtr parent, size_t chunk_size)
+    : parent_(std::move(parent)), chunk_size_(chunk_size) {
+  ORT_ENFORCE(parent_ != nullptr, "RegionArenaChunkPool requires a parent allocator");
+  ORT_ENFORCE(chunk_size_ >= kAllocAlignment && chunk_size_ % kAllocAlignment == 0,
+              "Chunk size must be a multiple of ", kAllocAlignment, ". Got ", chunk_size_);
+}
+
+RegionArenaChunkPool::~RegionArenaChunkPool() {
+  // all RegionArena instances hold a reference to the pool, so every chunk is idle at this point
+  for (void* chunk : idle_chunks_) {
+    parent_->Free(chunk);
+  }
+}
+
+void* RegionArenaChunkPool::AcquireChunk() {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    if (!idle_chunks_.empty()) {
+      void* chunk = idle_chunks_.back();
+      idle_chunks_.pop_back();
+      return chunk;
+    }
+  }
+
+  // throws if the parent can't allocate. the lock isn't held so other Run calls can return chunks meanwhile.
+  void* chunk = parent_->Alloc(chunk_size_);
+  ORT_ENFORCE(chunk != nullptr, "Failed to allocate a chunk of ", chunk_size_, " bytes for the region arena");
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  ++num_chunks_;
+  return chunk;
+}
+
+void RegionArenaChunkPool::ReleaseChunks(gsl::span<void* const> chunks) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  idle_chunks_.insert(idle_chunks_.end(), chunks.begin(), chunks.end());
+}
+
+size_t RegionArenaChunkPool::NumChunks() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return num_chunks_;
+}
+
+RegionArena::RegionArena(std::shared_ptr<RegionArenaChunkPool> pool)
+    : IAllocator(pool->Parent()->Info()), pool_(std::move(pool)) {
+}
+
+RegionArena::~RegionArena() {
+  for (const auto& large_allocation : large_allocations_) {
+    pool_->Parent()->Free(large_allocation.first);
+  }
+
+  pool_->ReleaseChunks(chunks_);
+}
+
+void* RegionArena::Alloc(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  const size_t chunk_size = pool_->ChunkSize();
+  const size_t rounded_size = static_cast<size_t>(SafeInt<size_t>(size) + (kAllocAlignment - 1)) &
+                              ~(kAllocAlignment - 1);
+
+  std::unique_lock<OrtMutex> lock(mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    lock.lock();
+    ++stats_.num_lock_contentions;
+  }
+
+  ++stats_.num_lock_acquisitions;
+  ++stats_.num_allocs;
+  stats_.max_alloc_size = std::max<int64_t>(stats_.max_alloc_size, static_cast<int64_t>(rounded_size));
+
+  if (rounded_size > chunk_size / 4) {
+    void* p = pool_->Parent()->Alloc(size);
+    large_allocations_.emplace(p, rounded_size);
+    stats_.bytes_in_use += rounded_size;
+    stats_.max_bytes_in_use = std::max(stats_.max_bytes_in_use, stats_.bytes_in_use);
+    return p;
+  }
+
+  if (chunks_.empty() || chunk_size - offset_ < rounded_size) {
+    chunks_.push_back(pool_->AcquireChunk());
+    offset_ = 0;
+    ++stats_.num_arena_extensions;
+    stats_.total_allocated_bytes += chunk_size;
+  }
+
+  last_offset_ = offset_;
+  offset_ += rounded_size;
+  stats_.bytes_in_use += rounded_size;
+  stats_.max_bytes_in_use = std::max(stats_.max_bytes_in_use, stats_.bytes_in_use);
+  return static_cast<char*>(chunks_.back()) + last_offset_;
+}
+
+void RegionArena::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  std::unique_lock<OrtMutex> lock(mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    lock.lock();
+    ++stats_.num_lock_contentions;
+  }
+
+  ++stats_.num_lock_acquisitions;
+
+  auto it = large_allocations_.find(p);
+  if (it != large_allocations_.end()) {
+    stats_.bytes_in_use -= static_cast<int64_t>(it->second);
+    large_allocations_.erase(it);
+    lock.unlock();
+    pool_->Parent()->Free(p);
+    return;
+  }
+
+  // memory from a chunk is released with the arena, except for the most recent allocation which is rolled back
+  // so short lived buffers like kernel scratch space can reuse it.
+  if (last_offset_ != kNoAllocation && p == static_cast<char*>(chunks_.back()) + last_offset_) {
+    stats_.bytes_in_use -= static_cast<int64_t>(offset_ - last_offset_);
+    offset_ = last_offset_;
+    last_offset_ = kNoAllocation;
+  }
+}
+
+void RegionArena::GetStats(AllocatorStats* stats) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  *stats = stats_;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/gsl.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/allocator.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// Fixed size chunks shared by the RegionArena instances of a session. Chunks are taken from the parent allocator
+// the first time they are needed and are kept for later Run calls, so at steady state a Run only touches the
+// pool's lock when it starts using a new chunk and once when it finishes, instead of the parent arena's lock for
+// every tensor.
+class RegionArenaChunkPool {
+ public:
+  static constexpr size_t kDefaultChunkSize = 4 * 1024 * 1024;
+
+  RegionArenaChunkPool(AllocatorPtr parent, size_t chunk_size);
+  ~RegionArenaChunkPool();
+
+  const AllocatorPtr& Parent() const noexcept { return parent_; }
+  size_t ChunkSize() const noexcept { return chunk_size_; }
+
+  void* AcquireChunk();
+  void ReleaseChunks(gsl::span<void* const> chunks);
+
+  // number of chunks allocated from the parent allocator
+  size_t NumChunks() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RegionArenaChunkPool);
+
+  const AllocatorPtr parent_;
+  const size_t chunk_size_;
+
+  mutable OrtMutex mutex_;
+  std::vector<void*> idle_chunks_;
+  size_t num_chunks_{0};
+};
+
+// Bump allocator for the intermediate values of a single Run. Allocations are carved from chunks of the pool
+// and are not reused individually, apart from the most recent allocation in the current chunk which can be
+// rolled back. All chunks go back to the pool in one step when the arena is destroyed, which happens when the
+// last tensor referencing it is released. Allocations larger than a quarter of the chunk size go to the parent
+// allocator directly and are freed immediately.
+// Thread-safe. The lock is per arena so it is only shared by the threads executing the same Run.
+class RegionArena : public IAllocator {
+ public:
+  explicit RegionArena(std::shared_ptr<RegionArenaChunkPool> pool);
+  ~RegionArena() override;
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+  void GetStats(AllocatorStats* stats) override;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RegionArena);
+
+  static constexpr size_t kNoAllocation = static_cast<size_t>(-1);
+
+  const std::shared_ptr<RegionArenaChunkPool> pool_;
+
+  OrtMutex mutex_;
+  InlinedVector<void*> chunks_;
+  // offset of the next allocation in the last chunk
+  size_t offset_{0};
+  // offset of the most recent allocation in the last chunk, or kNoAllocation if it was rolled back
+  size_t last_offset_{kNoAllocation};
+  // allocations from the parent allocator and their sizes
+  InlinedHashMap<void*, size_t> large_allocations_;
+  AllocatorStats stats_;
+};
+
+}  // namespace onnxruntime
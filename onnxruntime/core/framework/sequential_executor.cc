@@ -160,6 +160,12 @@ Status SequentialExecutor::Execute(const SessionState& session_state, gsl::span<
     tp = session_state.Profiler().Start();
   }
 
+  const SubgraphResultCache* subgraph_result_cache = session_state.GetSubgraphResultCache();
+  SubgraphResultCache::RunState cache_run_state;
+  if (subgraph_result_cache != nullptr) {
+    subgraph_result_cache->Lookup(feed_mlvalue_idxs, feeds, fetches, cache_run_state);
+  }
+
   ExecutionFrame frame{feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators, session_state};
 
 #if !defined(ORT_MINIMAL_BUILD)
@@ -227,6 +233,12 @@ Status SequentialExecutor::Execute(const SessionState& session_state, gsl::span<
     }
 #endif
 
+    // the outputs of the node are fed from the subgraph result cache
+    if (SubgraphResultCache::SkipNode(subgraph_result_cache, cache_run_state, node_index)) {
+      ORT_RETURN_IF_ERROR(ReleaseNodeMLValues(frame, seq_exec_plan, node_exec_plan, logger));
+      continue;
+    }
+
     const auto& node = *graph_viewer.GetNode(node_exec_plan.node_index);
 
 #ifdef CONCURRENCY_VISUALIZER
@@ -370,6 +382,10 @@ Status SequentialExecutor::Execute(const SessionState& session_state, gsl::span<
       return Status(compute_status.Category(), compute_status.Code(), msg_string);
     }
 
+    if (subgraph_result_cache != nullptr) {
+      ORT_RETURN_IF_ERROR(subgraph_result_cache->CaptureOutputs(node_index, op_kernel_context, cache_run_state));
+    }
+
     if (is_profiler_enabled) {
       // Calculate total output sizes for this operation.
       CalculateTotalOutputSizes(&op_kernel_context, total_output_sizes, node_name_for_profiling, output_type_shape);
@@ -480,6 +496,10 @@ Status SequentialExecutor::Execute(const SessionState& session_state, gsl::span<
   ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
   VLOGS(logger, 1) << "Done with execution.";
 
+  if (subgraph_result_cache != nullptr) {
+    subgraph_result_cache->Insert(cache_run_state);
+  }
+
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   session_state.GetMemoryProfiler()->CreateEvents(
       "dynamic activations_" + std::to_string(session_state.GetMemoryProfiler()->GetMemoryInfo().GetIteration()),
@@ -504,7 +524,22 @@ Status SequentialExecutor::Execute(const SessionState& session_state, gsl::span<
   }
 
   if (is_profiler_enabled) {
-    session_state.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "SequentialExecutor::Execute", tp);
+    const auto& mem_pattern_cache = session_state.GetMemoryPatternCache();
+    session_state.Profiler().EndTimeAndRecordEvent(
+        profiling::SESSION_EVENT, "SequentialExecutor::Execute", tp,
+        {{"mem_pattern_cache_hits", std::to_string(mem_pattern_cache.NumHits())},
+         {"mem_pattern_cache_misses", std::to_string(mem_pattern_cache.NumMisses())},
+         {"mem_pattern_cache_evictions", std::to_string(mem_pattern_cache.NumEvictions())}});
+
+    if (subgraph_result_cache != nullptr) {
+      session_state.Profiler().EndTimeAndRecordEvent(
+          profiling::SESSION_EVENT, "SubgraphResultCache", tp,
+          {{"hit", cache_run_state.hit != nullptr ? "1" : "0"},
+           {"hits", std::to_string(subgraph_result_cache->NumHits())},
+           {"misses", std::to_string(subgraph_result_cache->NumMisses())},
+           {"evictions", std::to_string(subgraph_result_cache->NumEvictions())},
+           {"size_in_bytes", std::to_string(subgraph_result_cache->SizeInBytes())}});
+    }
   }
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
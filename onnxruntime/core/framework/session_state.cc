@@ -7,6 +7,7 @@
 
 #include "core/platform/ort_mutex.h"
 #include "core/common/logging/logging.h"
+#include "core/common/parse_string.h"
 #include "core/common/safeint.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/framework/allocator.h"
@@ -297,6 +298,54 @@ static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
   return ss_1.str();
 }
 
+Status SessionState::PrepackWithSavedWeights(OpKernel& kernel, const Node& node, int input_idx,
+                                             const std::string& input_name, const Tensor& tensor,
+                                             /*out*/ bool& is_packed) {
+  is_packed = false;
+
+  const PrePackedWeights* saved_weights =
+      prepacked_weights_to_restore_ != nullptr
+          ? prepacked_weights_to_restore_->GetWeights(node.Index(), node.Domain(), node.OpType(), input_idx,
+                                                      input_name)
+          : nullptr;
+  if (saved_weights != nullptr) {
+    std::vector<BufferUniquePtr> saved_buffers;
+    saved_buffers.reserve(saved_weights->buffers_.size());
+    for (const auto& saved_buffer : saved_weights->buffers_) {
+      // the buffers are owned by the mapped file, the kernel can only use them
+      saved_buffers.emplace_back(saved_buffer.get(), BufferDeleter(nullptr));
+    }
+
+    // kernels that keep state other than the buffers from PrePack() decline them and are pre-packed below
+    ORT_RETURN_IF_ERROR(kernel.UseSavedPrePackedBuffers(saved_buffers, input_idx, tensor.Shape(), is_packed));
+    if (is_packed) {
+      ++used_saved_pre_packed_weights_counter_;
+      return Status::OK();
+    }
+  }
+
+  AllocatorPtr session_cpu_alloc = kernel.Info().GetAllocator(0, OrtMemType::OrtMemTypeDefault);
+  if (prepacked_weights_to_save_ == nullptr ||
+      prepacked_weights_to_save_->GetWeights(node.Index(), node.Domain(), node.OpType(), input_idx,
+                                             input_name) != nullptr) {
+    return kernel.PrePack(tensor, input_idx, session_cpu_alloc, is_packed, nullptr);
+  }
+
+  PrePackedWeights weights_to_save;
+  ORT_RETURN_IF_ERROR(kernel.PrePack(tensor, input_idx, session_cpu_alloc, is_packed, &weights_to_save));
+  if (is_packed && !weights_to_save.buffers_.empty()) {
+    // the file keeps the buffers until they are saved, and the kernel shares them like weights from the container
+    const PrePackedWeights* saved = prepacked_weights_to_save_->AddWeights(node.Index(), node.Domain(),
+                                                                          node.OpType(), input_idx, input_name,
+                                                                          std::move(weights_to_save));
+    ORT_RETURN_IF(saved == nullptr, "Pre-packed weights of input ", input_idx, " of node ", node.Name(),
+                  " were already added.");
+    ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(kernel, input_idx, *saved, node.Name()));
+  }
+
+  return Status::OK();
+}
+
 Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                                        const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map) {
   auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map](
@@ -379,6 +428,11 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
                     }
                   }
 
+                } else if (st == this && node.GetExecutionProviderType() == kCpuExecutionProvider &&
+                           (prepacked_weights_to_restore_ != nullptr || prepacked_weights_to_save_ != nullptr)) {
+                  // pre-packed weights saved in the optimized model cache
+                  ORT_RETURN_IF_ERROR(PrepackWithSavedWeights(*kernel, node, input_idx, input_name,
+                                                              const_initialized_tensor, is_packed));
                 } else {  // caching of pre-packed weights' turned OFF
                   AllocatorPtr session_cpu_alloc = kernel->Info().GetAllocator(0, OrtMemType::OrtMemTypeDefault);
                   ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
@@ -426,14 +480,6 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
   }
 }
 
-static int64_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs) {
-  int64_t key = 0;
-  for (const auto& input : tensor_inputs) {
-    for (auto dim : input.Get<Tensor>().Shape().GetDims()) key ^= dim;
-  }
-  return key;
-}
-
 #ifdef ENABLE_TRAINING
 namespace {
 Status ResolveDimParams(const GraphViewer& graph,
@@ -656,38 +702,26 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
 
 #endif
 
-// MemoryPatternGroup pointer is cached. It only inserted upon creation
-// and is not updated if already present.
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
+// The returned entry is shared with the cache, so it remains valid for the caller even if the cache
+// evicts or replaces it in the meantime.
+std::shared_ptr<const MemoryPatternCacheEntry> SessionState::GetMemoryPatternGroup(
     gsl::span<const OrtValue> tensor_inputs,
-    gsl::span<const int> feed_mlvalue_idxs,
-    const InlinedHashMap<int, TensorShape>*& out_inferred_shapes) const {
-  out_inferred_shapes = nullptr;
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
-#ifdef ENABLE_TRAINING
-    MemoryPatternGroup mem_patterns;
-    InlinedHashMap<int, TensorShape> inferred_shapes;
-    if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, mem_patterns, inferred_shapes).IsOK()) {
-      auto patt_insert = mem_patterns_.insert_or_assign(key, std::move(mem_patterns));
-      auto ptr = &patt_insert.first->second;
-      auto shape_insert = shape_patterns_.insert_or_assign(key, std::move(inferred_shapes));
-      out_inferred_shapes = &shape_insert.first->second;
-      return ptr;
-    }
-#else
-    ORT_UNUSED_PARAMETER(feed_mlvalue_idxs);
-#endif
-    return nullptr;
+    gsl::span<const int> feed_mlvalue_idxs) const {
+  auto entry = mem_pattern_cache_.Find(tensor_inputs);
+  if (entry) {
+    return entry;
   }
 
-  auto patt_hit = shape_patterns_.find(key);
-  if (patt_hit != shape_patterns_.cend()) {
-    out_inferred_shapes = &patt_hit->second;
+#ifdef ENABLE_TRAINING
+  MemoryPatternGroup mem_patterns;
+  InlinedHashMap<int, TensorShape> inferred_shapes;
+  if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, mem_patterns, inferred_shapes).IsOK()) {
+    return mem_pattern_cache_.Insert(tensor_inputs, std::move(mem_patterns), std::move(inferred_shapes));
   }
-  return &it->second;
+#else
+  ORT_UNUSED_PARAMETER(feed_mlvalue_idxs);
+#endif
+  return nullptr;
 }
 
 void SessionState::ResolveMemoryPatternFlag() {
@@ -716,11 +750,7 @@ void SessionState::ResolveMemoryPatternFlag() {
 
 Status SessionState::UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                                    MemoryPatternGroup mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
-
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  // Do not update if present, as the pointer to the existing one is cached
-  mem_patterns_.emplace(key, std::move(mem_patterns));
+  mem_pattern_cache_.Insert(tensor_inputs, std::move(mem_patterns));
   return Status::OK();
 }
 
@@ -1231,12 +1261,61 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   SubgraphsKernelCreateInfoMaps subgraphs_kernel_create_info_maps;
   AccumulateAllNestedSubgraphsInfo(*this, "", 0, subgraphs_kernel_create_info_maps);
 
+  if (enable_mem_pattern_) {
+    MemoryPatternBucketPolicy bucket_policy;
+    ORT_RETURN_IF_ERROR(MemoryPatternCache::ParseBucketPolicy(
+        session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternBucketPolicy, "exact"),
+        bucket_policy));
+
+    const auto capacity_str =
+        session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternCacheCapacity, "0");
+    size_t capacity = 0;
+    ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale<size_t>(capacity_str, capacity),
+                      "Invalid value for ", kOrtSessionOptionsConfigMemoryPatternCacheCapacity, ": ", capacity_str);
+
+    mem_pattern_cache_.Configure(bucket_policy, capacity);
+  }
+
   SequentialPlannerContext context(session_options.execution_mode, session_options.execution_order, session_options.enable_mem_reuse);
   ORT_RETURN_IF_ERROR(SequentialPlanner::CreatePlan(parent_node, *graph_viewer_, valid_outer_scope_node_args,
                                                     execution_providers_, kernel_create_info_map_,
                                                     subgraphs_kernel_create_info_maps,
                                                     outer_scope_node_arg_to_location_map,
                                                     ort_value_name_idx_map_, context, p_seq_exec_plan_));
+
+  if (session_options.execution_mode == ExecutionMode::ORT_PARALLEL_WORK_STEALING) {
+    parallel_execution_schedule_.emplace();
+    ORT_RETURN_IF_ERROR(ParallelExecutionSchedule::Create(*graph_viewer_, *p_seq_exec_plan_,
+                                                          *parallel_execution_schedule_));
+  }
+
+  if (session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseRegionArena, "0") == "1") {
+    const auto chunk_size_str = session_options.config_options.GetConfigOrDefault(
+        kOrtSessionOptionsConfigRegionArenaChunkSize, std::to_string(RegionArenaChunkPool::kDefaultChunkSize));
+    size_t chunk_size = 0;
+    ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale<size_t>(chunk_size_str, chunk_size) &&
+                          chunk_size >= kAllocAlignment && chunk_size % kAllocAlignment == 0,
+                      "Invalid value for ", kOrtSessionOptionsConfigRegionArenaChunkSize, ": ", chunk_size_str);
+
+    for (const auto& location : p_seq_exec_plan_->GetAllLocations()) {
+      AllocatorPtr allocator = GetAllocator(location);
+      if (location.device.Type() == OrtDevice::CPU && allocator) {
+        region_arena_chunk_pools_.emplace(location,
+                                          std::make_shared<RegionArenaChunkPool>(std::move(allocator), chunk_size));
+      }
+    }
+  }
+
+  if (enable_mem_pattern_ &&
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigEnableStaticMemoryPlanning, "0") == "1") {
+    // the buffer lifetimes are based on the order of the execution plan, which only the sequential executor follows
+    if (session_options.execution_mode == ExecutionMode::ORT_SEQUENTIAL) {
+      ORT_RETURN_IF_ERROR(StaticMemoryPlan::Create(*this, static_memory_plan_));
+    } else {
+      LOGS(logger_, WARNING) << kOrtSessionOptionsConfigEnableStaticMemoryPlanning
+                             << " is only supported with sequential execution and will be ignored.";
+    }
+  }
 // Record the allocation plan
 
 // Uncomment the below to dump the allocation plan to std::cout
@@ -1309,8 +1388,35 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
     CleanInitializedTensorsFromGraph();
   }
 
+  config_options_ = session_options.config_options;
   ORT_RETURN_IF_ERROR(CreateKernels(kernel_registry_manager));
 
+#if !defined(DEBUG_NODE_INPUTS_OUTPUTS)
+  // node input/output dumping is only done by SequentialExecutor
+  if (session_options.execution_mode == ExecutionMode::ORT_SEQUENTIAL &&
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseFastSequentialExecutor, "0") ==
+          "1") {
+    ORT_RETURN_IF_ERROR(KernelDispatchTable::Create(*this, *p_seq_exec_plan_, kernel_dispatch_table_));
+    if (!kernel_dispatch_table_.has_value()) {
+      LOGS(logger_, INFO) << "The execution plan uses fences or kernels the fast sequential executor doesn't "
+                             "support. SequentialExecutor will be used.";
+    }
+  }
+#endif
+
+  const auto cacheable_inputs =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigCacheableInputs, "");
+  if (!cacheable_inputs.empty() && parent_node == nullptr &&
+      session_options.execution_mode == ExecutionMode::ORT_SEQUENTIAL) {
+    const auto budget_str = session_options.config_options.GetConfigOrDefault(
+        kOrtSessionOptionsConfigSubgraphCacheBudgetBytes, "67108864");
+    size_t budget_bytes = 0;
+    ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale<size_t>(budget_str, budget_bytes),
+                      "Invalid value for ", kOrtSessionOptionsConfigSubgraphCacheBudgetBytes, ": ", budget_str);
+
+    ORT_RETURN_IF_ERROR(SubgraphResultCache::Create(*this, cacheable_inputs, budget_bytes, subgraph_result_cache_));
+  }
+
 #ifndef ENABLE_TRAINING
   const auto disable_prepacking =
       session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDisablePrepacking, "0");
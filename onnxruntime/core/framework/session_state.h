@@ -16,18 +16,26 @@
 #include "core/common/profiler.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/callback.h"
+#include "core/framework/config_options.h"
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/prepacked_weights_container.h"
+#include "core/framework/prepacked_weights_file.h"
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
+#include "core/framework/mem_pattern_cache.h"
+#include "core/framework/region_arena.h"
+#include "core/framework/static_memory_planner.h"
+#include "core/framework/subgraph_result_cache.h"
 #include "core/framework/ort_value.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/ort_value_name_idx_map.h"
+#include "core/framework/kernel_dispatch_table.h"
+#include "core/framework/parallel_execution_schedule.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/onnx_protobuf.h"
 #include "core/platform/ort_mutex.h"
@@ -191,6 +199,22 @@ class SessionState {
 
   // execution plan. nullptr until FinalizeSessionState is called
   const SequentialExecutionPlan* GetExecutionPlan() const;
+
+  // node dependencies for the work stealing executor.
+  // nullptr unless FinalizeSessionState was called with ExecutionMode::ORT_PARALLEL_WORK_STEALING
+  const ParallelExecutionSchedule* GetParallelExecutionSchedule() const {
+    return parallel_execution_schedule_.has_value() ? &*parallel_execution_schedule_ : nullptr;
+  }
+
+  // kernels in execution order for FastSequentialExecutor.
+  // nullptr unless the fast sequential executor is enabled and supports the execution plan
+  const KernelDispatchTable* GetKernelDispatchTable() const {
+    return kernel_dispatch_table_.has_value() ? &*kernel_dispatch_table_ : nullptr;
+  }
+
+  // cached results of the nodes that only depend on the inputs configured as cacheable.
+  // nullptr unless the cache is enabled for the main graph and some nodes can be cached
+  const SubgraphResultCache* GetSubgraphResultCache() const noexcept { return subgraph_result_cache_.get(); }
   /**
   Get the logger for this session.
   Falls back to returning Logging::LoggingManager::DefaultLogger if SetLogger has not been called.
@@ -214,16 +238,13 @@ class SessionState {
   /**
   Get cached memory pattern based on input shapes
   Must be called only when all values contain tensors
-  In training scenarios, the cache may be updated so
-  the callers would receive a copy of inferred shapes
-  made under mutex being held. In inference scenarios,
-  it is not mutable, we do not obtain a lock and simply get a pointer
-  w/o copying a hashtable
+  In training scenarios, a pattern may be generated from the symbolic shapes
+  if none is cached. The returned entry also holds the inferred shapes of the activations
+  and stays valid even if it is evicted from the cache while in use.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  std::shared_ptr<const MemoryPatternCacheEntry> GetMemoryPatternGroup(
       gsl::span<const OrtValue> tensor_inputs,
-      gsl::span<const int> feed_mlvalue_idxs,
-      const InlinedHashMap<int, TensorShape>*& inferred_shapes) const;
+      gsl::span<const int> feed_mlvalue_idxs) const;
 
   /**
   Set generated memory pattern with a given input shapes.
@@ -233,6 +254,24 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                        MemoryPatternGroup mem_patterns) const;
 
+  /**
+  Get the memory pattern cache. Used to query the bucket policy and hit/miss statistics.
+  */
+  const MemoryPatternCache& GetMemoryPatternCache() const noexcept { return mem_pattern_cache_; }
+
+  /**
+  Get the activation memory plan computed at initialization if static memory planning is enabled
+  and all activation shapes are known. nullptr otherwise.
+  */
+  const StaticMemoryPlan* GetStaticMemoryPlan() const noexcept { return static_memory_plan_.get(); }
+
+  /**
+  Get the chunk pools for per-Run region arenas, keyed by location. Empty if region arenas are not enabled.
+  */
+  const InlinedHashMap<OrtMemoryInfo, std::shared_ptr<RegionArenaChunkPool>>& GetRegionArenaChunkPools() const noexcept {
+    return region_arena_chunk_pools_;
+  }
+
   bool GetUseDeterministicCompute() const { return use_deterministic_compute_; }
 
   /**
@@ -294,6 +333,9 @@ class SessionState {
 
   const DataTransferManager& GetDataTransferMgr() const noexcept { return data_transfer_mgr_; }
 
+  // Session configuration entries visible to the kernels through OpKernelInfo.
+  const ConfigOptions& GetConfigOptions() const noexcept { return config_options_; }
+
   InlinedVector<BufferUniquePtr>& GetMutableWeightsBuffers() noexcept { return weights_buffers_; }
 
   const NodeIndexInfo& GetNodeIndexInfo() const;
@@ -321,6 +363,18 @@ class SessionState {
     return used_shared_pre_packed_weights_counter_;
   }
 
+  size_t GetUsedSavedPrePackedWeightCounter() const {
+    return used_saved_pre_packed_weights_counter_;
+  }
+
+  // Pre-packed weights of the optimized model cache. Weights of CPU kernels found in restore_from are handed to
+  // the kernels instead of pre-packing the initializers, and weights pre-packed by the kernels are added to
+  // record_in. Both are optional and must outlive the session state.
+  void SetPrepackedWeightsFiles(const PrepackedWeightsFile* restore_from, PrepackedWeightsFile* record_in) {
+    prepacked_weights_to_restore_ = restore_from;
+    prepacked_weights_to_save_ = record_in;
+  }
+
   const KernelCreateInfoMap& GetKernelCreateInfoMap() const {
     return kernel_create_info_map_;
   }
@@ -361,6 +415,10 @@ class SessionState {
   Status PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                            const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map);
 
+  // Prepack a constant initializer of a CPU node using the pre-packed weights files of the optimized model cache.
+  Status PrepackWithSavedWeights(OpKernel& kernel, const Node& node, int input_idx, const std::string& input_name,
+                                 const Tensor& tensor, /*out*/ bool& is_packed);
+
   SessionState* GetMutableSubgraphSessionState(onnxruntime::NodeIndex index, const std::string& attribute_name);
 
   Status CreateSubgraphSessionState();
@@ -464,6 +522,9 @@ class SessionState {
   InlinedHashMap<int, OrtCallback> deleter_for_initialized_tensors_;
   InlinedVector<BufferUniquePtr> weights_buffers_;
   std::optional<SequentialExecutionPlan> p_seq_exec_plan_;
+  std::optional<ParallelExecutionSchedule> parallel_execution_schedule_;
+  std::optional<KernelDispatchTable> kernel_dispatch_table_;
+  std::unique_ptr<SubgraphResultCache> subgraph_result_cache_;
 
   const logging::Logger& logger_;
   profiling::Profiler& profiler_;
@@ -475,18 +536,15 @@ class SessionState {
   // switch for enable memory pattern optimization or not.
   bool enable_mem_pattern_;
 
-  // lock for the mem_patterns_
-  mutable OrtMutex mem_patterns_lock_;
-  // cache for the generated mem_patterns. key is calculated based on input shapes.
-  // must be a node based container as a pointer is cached.
-  mutable NodeHashMap<int64_t, MemoryPatternGroup> mem_patterns_;
-  // This is mutable under mutex in training scenarios so execution frame would make a copy
-  // of the value when created.
-#ifdef ENABLE_TRAINING
-  mutable NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#else
-  NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#endif
+  // cache for the generated memory patterns. key is calculated based on (possibly bucketed) input shapes.
+  // configured from the session options in FinalizeSessionState.
+  MemoryPatternCache mem_pattern_cache_;
+
+  // memory patterns and buffers planned at initialization. replaces mem_pattern_cache_ when set.
+  std::unique_ptr<StaticMemoryPlan> static_memory_plan_;
+
+  // chunk pools for the per-Run region arenas of CPU locations, if enabled in the session options.
+  InlinedHashMap<OrtMemoryInfo, std::shared_ptr<RegionArenaChunkPool>> region_arena_chunk_pools_;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -499,6 +557,9 @@ class SessionState {
 
   const DataTransferManager& data_transfer_mgr_;
 
+  // copy of the session configuration entries, set when the session state is finalized
+  ConfigOptions config_options_;
+
   bool use_deterministic_compute_;
   bool enable_mem_reuse_;
   std::optional<NodeIndexInfo> node_index_info_;
@@ -509,6 +570,10 @@ class SessionState {
   // prepacked_weights_container_ can be nullptr if no caching is required for prepacked weights
   PrepackedWeightsContainer* const prepacked_weights_container_{};
 
+  // Pre-packed weights files of the optimized model cache, owned by the session. Only set for the main graph.
+  const PrepackedWeightsFile* prepacked_weights_to_restore_{};
+  PrepackedWeightsFile* prepacked_weights_to_save_{};
+
 #if !defined(ORT_MINIMAL_BUILD)
 #ifndef DISABLE_ABSEIL
   InlinedHashMap<InlinedVector<int>, InlinedHashSet<NodeIndex>> to_be_executed_nodes_;
@@ -538,6 +603,10 @@ class SessionState {
   // a constant initialized weight was used by the session state
   size_t used_shared_pre_packed_weights_counter_ = 0;
 
+  // Counter for number of times a pre-packed weight saved in the optimized model cache was used
+  // instead of pre-packing the constant initialized weight
+  size_t used_saved_pre_packed_weights_counter_ = 0;
+
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
   // Counter for number of times the session graph has been executed
   size_t graph_executions_counter_ = 0;
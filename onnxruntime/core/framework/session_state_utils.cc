@@ -93,6 +93,38 @@ static inline common::Status ExtDataTensorProtoToTensor(const Env& env,
   return common::Status::OK();
 }
 
+// create the tensor of a CPU initializer with external data on the mapped file without allocating memory for it.
+// if the mapped data is not aligned to the size of the element type, it is copied to memory from alloc instead.
+static common::Status MapExternalDataTensorProto(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& proto_path,
+                                                 const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                                 const AllocatorPtr& alloc, OrtValue& ort_value,
+                                                 const logging::Logger& logger) {
+  auto p_tensor = std::make_unique<Tensor>();
+  OrtCallback ext_data_deleter;
+  ORT_RETURN_IF_ERROR(ExtDataTensorProtoToTensor(env, proto_path, tensor_proto, *p_tensor, ext_data_deleter));
+
+  if (reinterpret_cast<uintptr_t>(p_tensor->DataRaw()) % p_tensor->DataType()->Size() == 0) {
+    ExtDataValueDeleter deleter{ext_data_deleter, p_tensor.get()};
+    ort_value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), deleter);
+    return common::Status::OK();
+  }
+
+  if (ext_data_deleter.f) {
+    ext_data_deleter.f(ext_data_deleter.param);
+  }
+
+  LOGS(logger, WARNING) << "External data of initializer " << tensor_proto.name()
+                        << " is not aligned to the size of its element type. It will be copied.";
+  const DataTypeImpl* const type = p_tensor->DataType();
+  const TensorShape tensor_shape = p_tensor->Shape();
+  *p_tensor = Tensor(type, tensor_shape, alloc);
+  ORT_RETURN_IF_ERROR(utils::TensorProtoToTensor(env, proto_path.c_str(), tensor_proto, *p_tensor));
+
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  ort_value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  return common::Status::OK();
+}
+
 static common::Status DeserializeTensorProto(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& proto_path,
                                              const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer* m,
                                              const AllocatorPtr& alloc, const AllocatorPtr& default_cpu_alloc,
@@ -245,6 +277,17 @@ common::Status SaveInitializedTensors(
     id_to_initialized_tensor[ort_value_index] = entry.second;
   }
 
+  // with kOrtSessionOptionsConfigUseMmapForExternalInitializers the tensors of CPU initializers with external data are
+  // created on the mapped file, so no memory is planned or allocated for them
+  const bool use_mmap_for_external_initializers =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseMmapForExternalInitializers,
+                                                        "0") == "1";
+  auto is_mapped_initializer = [&](int ort_value_index, const ONNX_NAMESPACE::TensorProto& tensor_proto) -> bool {
+    return use_mmap_for_external_initializers && utils::HasExternalData(tensor_proto) &&
+           tensor_proto.data_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING &&
+           exec_plan.GetLocation(ort_value_index).device.Type() == OrtDevice::CPU;
+  };
+
   // tensors requiring a specific allocation order are traced first, to ensure they are allocated in order
   // NB1: vector with init allocation order may contain a subset of all tensors (or none at all)
   // NB2: only skip tracing and planning memory when data is external (i.e mmap) and on CPU.
@@ -270,6 +313,9 @@ common::Status SaveInitializedTensors(
       // do not trace string tensor
       continue;
     }
+    if (is_mapped_initializer(entry.first, *entry.second)) {
+      continue;
+    }
     ORT_RETURN_IF_ERROR(planner.Trace(entry.first, entry.second));
   }
   // 2. allocate weight buffer on different locations
@@ -307,16 +353,21 @@ common::Status SaveInitializedTensors(
     } else {
       const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
 
-      std::optional<MemBuffer> m;
-      AllocatorPtr alloc;
-      // TODO: if the tensor need be copied, does it have enough room?
-      ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, name, m, alloc));
-      bool use_device_allocator_for_initializers =
-          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
-
-      Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, (m.has_value()) ? &*m : nullptr, alloc,
-                                         default_cpu_alloc, ort_value, data_transfer_mgr,
-                                         use_device_allocator_for_initializers);
+      Status st;
+      if (is_mapped_initializer(ort_value_index, tensor_proto)) {
+        st = MapExternalDataTensorProto(env, graph_loc, tensor_proto, default_cpu_alloc, ort_value, logger);
+      } else {
+        std::optional<MemBuffer> m;
+        AllocatorPtr alloc;
+        // TODO: if the tensor need be copied, does it have enough room?
+        ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, name, m, alloc));
+        bool use_device_allocator_for_initializers =
+            session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
+
+        st = DeserializeTensorProto(env, graph_loc, tensor_proto, (m.has_value()) ? &*m : nullptr, alloc,
+                                    default_cpu_alloc, ort_value, data_transfer_mgr,
+                                    use_device_allocator_for_initializers);
+      }
       if (!st.IsOK()) {
         std::ostringstream oss;
         oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
@@ -0,0 +1,309 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/static_memory_planner.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include "core/common/safeint.h"
+#include "core/framework/ort_value_pattern_planner.h"
+#include "core/framework/session_state.h"
+
+namespace onnxruntime {
+
+namespace {
+// Returns true if the two buffers are in use during a common step of the execution plan.
+// The start/end pairs of a ProgramCounter are ordered and don't overlap each other.
+bool LifetimesOverlap(const AllocPlanPerValue::ProgramCounter& counter1,
+                      const AllocPlanPerValue::ProgramCounter& counter2) {
+  const auto& starts_1 = counter1.Starts();
+  const auto& ends_1 = counter1.Ends();
+  const auto& starts_2 = counter2.Starts();
+  const auto& ends_2 = counter2.Ends();
+
+  size_t index_1 = 0;
+  size_t index_2 = 0;
+  while (index_1 < starts_1.size() && index_2 < starts_2.size()) {
+    if (ends_1[index_1] < starts_2[index_2]) {
+      ++index_1;
+    } else if (ends_2[index_2] < starts_1[index_1]) {
+      ++index_2;
+    } else {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// Returns false if the shape of the NodeArg is missing or has a dimension without a value.
+bool TryGetStaticShape(const NodeArg& node_arg, TensorShapeVector& dims) {
+  const auto* shape = node_arg.Shape();
+  if (shape == nullptr) {
+    return false;
+  }
+
+  dims.clear();
+  for (const auto& dim : shape->dim()) {
+    if (!dim.has_dim_value() || dim.dim_value() < 0) {
+      return false;
+    }
+
+    dims.push_back(dim.dim_value());
+  }
+
+  return true;
+}
+}  // namespace
+
+void StaticMemoryPlanner::AddBuffer(int ort_value_idx, size_t size, const AllocPlanPerValue::ProgramCounter& counter) {
+  ORT_ENFORCE(counter.HasValidEntries(), "Invalid program_counter entries for buffer with index ", ort_value_idx);
+  buffers_.push_back({ort_value_idx, size, &counter});
+}
+
+MemoryPattern StaticMemoryPlanner::GeneratePattern() const {
+  // place large buffers first as they are the hardest to fit into gaps
+  std::vector<size_t> order(buffers_.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::stable_sort(order.begin(), order.end(),
+                   [this](size_t a, size_t b) { return buffers_[a].size > buffers_[b].size; });
+
+  struct PlacedBuffer {
+    MemoryBlock block;
+    const AllocPlanPerValue::ProgramCounter* counter;
+  };
+
+  std::vector<PlacedBuffer> placed;
+  placed.reserve(buffers_.size());
+  std::vector<const MemoryBlock*> overlapping;
+
+  MemoryPattern pattern;
+  pattern.patterns_.reserve(buffers_.size());
+  size_t peak_size = 0;
+
+  for (size_t i : order) {
+    const auto& buffer = buffers_[i];
+
+    overlapping.clear();
+    for (const auto& p : placed) {
+      if (LifetimesOverlap(*p.counter, *buffer.counter)) {
+        overlapping.push_back(&p.block);
+      }
+    }
+
+    std::sort(overlapping.begin(), overlapping.end(),
+              [](const MemoryBlock* a, const MemoryBlock* b) { return a->offset_ < b->offset_; });
+
+    // find the smallest gap between the buffers in use at the same time that fits, or place it after them
+    size_t current = 0;
+    size_t best_offset = 0;
+    size_t waste_bytes = std::numeric_limits<size_t>::max();
+    bool best_offset_found = false;
+    for (const auto* block : overlapping) {
+      if (block->offset_ > current) {
+        const size_t gap = block->offset_ - current;
+        if (gap >= buffer.size && (gap - buffer.size) < waste_bytes) {
+          waste_bytes = gap - buffer.size;
+          best_offset = current;
+          best_offset_found = true;
+        }
+      }
+
+      current = std::max(current, block->offset_ + block->size_);
+    }
+
+    if (!best_offset_found) {
+      best_offset = current;
+    }
+
+    const size_t end = SafeInt<size_t>(best_offset) + buffer.size;
+    peak_size = std::max(peak_size, end);
+    placed.push_back({MemoryBlock(best_offset, buffer.size), buffer.counter});
+    pattern.patterns_[buffer.ort_value_idx] = MemoryBlock(best_offset, buffer.size);
+  }
+
+  pattern.peak_size_ = peak_size;
+  return pattern;
+}
+
+StaticMemoryPlan::StaticMemoryPlan(const SessionState& session_state,
+                                   std::shared_ptr<const MemoryPatternCacheEntry> patterns,
+                                   size_t planned_peak_size, size_t traced_peak_size)
+    : session_state_(session_state),
+      patterns_(std::move(patterns)),
+      planned_peak_size_(planned_peak_size),
+      traced_peak_size_(traced_peak_size) {
+}
+
+Status StaticMemoryPlan::Create(const SessionState& session_state, std::unique_ptr<StaticMemoryPlan>& plan) {
+  plan.reset();
+
+  const auto* exe_plan = session_state.GetExecutionPlan();
+  ORT_RETURN_IF_NOT(exe_plan, "Static memory planning requires an execution plan.");
+
+  const auto& graph_viewer = session_state.GetGraphViewer();
+  const auto& ort_value_name_idx_map = session_state.GetOrtValueNameIdxMap();
+  const auto& logger = session_state.Logger();
+
+  auto entry = std::make_shared<MemoryPatternCacheEntry>();
+
+  // size of the buffer for each value the execution plan allocates. 0 if the value is not planned.
+  std::vector<size_t> sizes(exe_plan->allocation_plan.size(), 0);
+  TensorShapeVector dims;
+  for (const auto& step : exe_plan->execution_plan) {
+    const auto* node = graph_viewer.GetNode(step.node_index);
+    for (const auto* output_def : node->OutputDefs()) {
+      if (!output_def->Exists()) {
+        continue;
+      }
+
+      int ort_value_idx;
+      ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(output_def->Name(), ort_value_idx));
+      const auto& per_value_plan = exe_plan->allocation_plan[ort_value_idx];
+      if (per_value_plan.alloc_kind != AllocKind::kAllocate || per_value_plan.value_type == nullptr ||
+          !per_value_plan.value_type->IsTensorType()) {
+        continue;
+      }
+
+      const auto* element_type = static_cast<const TensorTypeBase*>(per_value_plan.value_type)->GetElementType();
+      if (element_type == DataTypeImpl::GetType<std::string>()) {
+        continue;
+      }
+
+      if (!TryGetStaticShape(*output_def, dims)) {
+        LOGS(logger, INFO) << "Static memory planning is not used as the shape of " << output_def->Name()
+                           << " is not fully known. Memory patterns will be traced at run time instead.";
+        return Status::OK();
+      }
+
+      TensorShape shape(dims);
+      size_t size = 0;
+      if (!IAllocator::CalcMemSizeForArrayWithAlignment<kAllocAlignment>(static_cast<size_t>(shape.Size()),
+                                                                         element_type->Size(), &size)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Size overflow planning memory for ", output_def->Name());
+      }
+
+      sizes[ort_value_idx] = size;
+      entry->inferred_shapes.emplace(ort_value_idx, std::move(shape));
+    }
+  }
+
+  // plan each location separately
+  InlinedHashMap<OrtMemoryInfo, std::unique_ptr<StaticMemoryPlanner>> planners;
+  for (size_t ort_value_idx = 0; ort_value_idx < sizes.size(); ++ort_value_idx) {
+    if (sizes[ort_value_idx] == 0) {
+      continue;
+    }
+
+    const auto& per_value_plan = exe_plan->allocation_plan[ort_value_idx];
+    auto& planner = planners[per_value_plan.location];
+    if (!planner) {
+      planner = std::make_unique<StaticMemoryPlanner>();
+    }
+
+    planner->AddBuffer(static_cast<int>(ort_value_idx), sizes[ort_value_idx], per_value_plan.program_counter);
+  }
+
+  size_t planned_peak_size = 0;
+  auto& mem_patterns = entry->mem_patterns;
+  for (const auto& location_planner : planners) {
+    mem_patterns.locations.push_back(location_planner.first);
+    mem_patterns.patterns.push_back(location_planner.second->GeneratePattern());
+    planned_peak_size += mem_patterns.patterns.back().PeakSize();
+  }
+
+  // replay the allocations in execution order to get the peak of the pattern the session would trace otherwise
+  OrtValuePatternPlanner traced_planner(*exe_plan);
+  for (const auto& step : exe_plan->execution_plan) {
+    const auto* node = graph_viewer.GetNode(step.node_index);
+    for (const auto* output_def : node->OutputDefs()) {
+      int ort_value_idx;
+      if (output_def->Exists() && ort_value_name_idx_map.GetIdx(output_def->Name(), ort_value_idx).IsOK() &&
+          sizes[ort_value_idx] != 0) {
+        ORT_RETURN_IF_ERROR(traced_planner.TraceAllocation(ort_value_idx, sizes[ort_value_idx]));
+      }
+    }
+
+    for (int index = step.free_from_index; index <= step.free_to_index; ++index) {
+      const auto ort_value_idx = exe_plan->to_be_freed[index];
+      if (sizes[ort_value_idx] != 0) {
+        ORT_RETURN_IF_ERROR(traced_planner.TraceFree(ort_value_idx));
+      }
+    }
+  }
+
+  MemoryPatternGroup traced_patterns;
+  ORT_RETURN_IF_ERROR(traced_planner.GeneratePatterns(traced_patterns));
+  size_t traced_peak_size = 0;
+  for (const auto& pattern : traced_patterns.patterns) {
+    traced_peak_size += pattern.PeakSize();
+  }
+
+  LOGS(logger, INFO) << "Static memory planning: planned activation peak is " << planned_peak_size
+                     << " bytes. Peak of the traced memory pattern is " << traced_peak_size << " bytes.";
+
+  plan.reset(new StaticMemoryPlan(session_state, std::move(entry), planned_peak_size, traced_peak_size));
+
+  // allocate the slabs for the first Run up front
+  plan->ReleaseSlabs(plan->AcquireSlabs());
+
+  return Status::OK();
+}
+
+std::unique_ptr<StaticMemoryPlan::Slabs> StaticMemoryPlan::AcquireSlabs() const {
+  {
+    std::lock_guard<OrtMutex> lock(idle_slabs_mutex_);
+    if (!idle_slabs_.empty()) {
+      auto slabs = std::move(idle_slabs_.back());
+      idle_slabs_.pop_back();
+      return slabs;
+    }
+  }
+
+  const auto& mem_patterns = patterns_->mem_patterns;
+  auto slabs = std::make_unique<Slabs>();
+  slabs->buffers.reserve(mem_patterns.locations.size());
+  for (size_t i = 0; i < mem_patterns.locations.size(); ++i) {
+    const auto& location = mem_patterns.locations[i];
+    const size_t peak_size = mem_patterns.patterns[i].PeakSize();
+    AllocatorPtr alloc = peak_size > 0 ? session_state_.GetAllocator(location) : nullptr;
+    void* buffer = nullptr;
+    if (alloc) {
+      // same as the buffer for a traced memory pattern, if this fails the activations are allocated individually
+      ORT_TRY {
+        buffer = alloc->Alloc(peak_size);
+        if (buffer == nullptr) {
+          LOGS(session_state_.Logger(), INFO) << "Allocation of static memory plan buffer for "
+                                              << location.ToString() << " returned nullptr";
+        }
+      }
+      ORT_CATCH(const OnnxRuntimeException& ex) {
+        ORT_HANDLE_EXCEPTION([&]() {
+          LOGS(session_state_.Logger(), INFO) << "Allocation of static memory plan buffer for "
+                                              << location.ToString() << " failed. Error:" << ex.what();
+        });
+      }
+    }
+
+    slabs->buffers.emplace_back(buffer, BufferDeleter(buffer != nullptr ? std::move(alloc) : AllocatorPtr{}));
+  }
+
+  return slabs;
+}
+
+void StaticMemoryPlan::ReleaseSlabs(std::unique_ptr<Slabs> slabs) const {
+  const auto& mem_patterns = patterns_->mem_patterns;
+  for (size_t i = 0; i < mem_patterns.patterns.size(); ++i) {
+    // don't keep slabs with a failed allocation around so the next Run tries again
+    if (mem_patterns.patterns[i].PeakSize() > 0 && slabs->buffers[i] == nullptr) {
+      return;
+    }
+  }
+
+  std::lock_guard<OrtMutex> lock(idle_slabs_mutex_);
+  idle_slabs_.push_back(std::move(slabs));
+}
+
+}  // namespace onnxruntime
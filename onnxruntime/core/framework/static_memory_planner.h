@@ -0,0 +1,92 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/common/status.h"
+#include "core/framework/buffer_deleter.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/mem_pattern_cache.h"
+#include "core/framework/sequential_execution_plan.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class SessionState;
+
+// Plans the offsets of buffers whose size and lifetime are both known before execution.
+// MemPatternPlanner traces allocations in execution order and has to place each buffer without knowing which later
+// buffers it will share the timeline with. Here the lifetimes of all buffers are known up front, so buffers are
+// placed largest first, each at the offset with the smallest gap among the buffers it overlaps in time
+// (greedy best-fit interval coloring).
+class StaticMemoryPlanner {
+ public:
+  StaticMemoryPlanner() = default;
+
+  // counter holds the steps of the execution plan during which the buffer is in use, and must outlive the planner.
+  void AddBuffer(int ort_value_idx, size_t size, const AllocPlanPerValue::ProgramCounter& counter);
+
+  MemoryPattern GeneratePattern() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(StaticMemoryPlanner);
+
+  struct Buffer {
+    int ort_value_idx;
+    size_t size;
+    const AllocPlanPerValue::ProgramCounter* counter;
+  };
+
+  std::vector<Buffer> buffers_;
+};
+
+// Activation memory layout computed at session initialization for graphs where the shape of every activation is
+// known statically, e.g. after free dimension overrides. The patterns are used for every Run, and the buffer each
+// pattern is laid out in (a 'slab') is allocated once and reused, so Run does not call the allocator for planned
+// activations. Concurrent Run calls each borrow their own set of slabs.
+class StaticMemoryPlan {
+ public:
+  // one buffer per location of the memory patterns. nullptr if the pattern is empty or the allocation failed.
+  struct Slabs {
+    InlinedVector<BufferUniquePtr> buffers;
+  };
+
+  // Creates a plan for the session state's execution plan. plan is left empty if any activation that the execution
+  // plan allocates has a shape that is not fully known.
+  static Status Create(const SessionState& session_state, std::unique_ptr<StaticMemoryPlan>& plan);
+
+  const std::shared_ptr<const MemoryPatternCacheEntry>& GetMemoryPatterns() const noexcept { return patterns_; }
+
+  // peak size summed over all locations
+  size_t PlannedPeakSize() const noexcept { return planned_peak_size_; }
+
+  // peak size summed over all locations of the pattern that tracing a Run in execution order produces,
+  // which is what the session uses when static planning is disabled.
+  size_t TracedPeakSize() const noexcept { return traced_peak_size_; }
+
+  // Returns an idle set of slabs, or allocates a new one if all are in use by other Run calls.
+  std::unique_ptr<Slabs> AcquireSlabs() const;
+
+  void ReleaseSlabs(std::unique_ptr<Slabs> slabs) const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(StaticMemoryPlan);
+
+  StaticMemoryPlan(const SessionState& session_state, std::shared_ptr<const MemoryPatternCacheEntry> patterns,
+                   size_t planned_peak_size, size_t traced_peak_size);
+
+  const SessionState& session_state_;
+  std::shared_ptr<const MemoryPatternCacheEntry> patterns_;
+  size_t planned_peak_size_;
+  size_t traced_peak_size_;
+
+  mutable OrtMutex idle_slabs_mutex_;
+  mutable std::vector<std::unique_ptr<Slabs>> idle_slabs_;
+};
+
+}  // namespace onnxruntime
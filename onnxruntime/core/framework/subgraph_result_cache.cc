@@ -0,0 +1,435 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/subgraph_result_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+#include "core/common/string_utils.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/session_state.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// ops that don't produce the same outputs for the same inputs
+const InlinedHashSet<std::string_view>& NonDeterministicOps() {
+  static const InlinedHashSet<std::string_view> ops{"Bernoulli", "Dropout", "Multinomial", "RandomNormal",
+                                                    "RandomNormalLike", "RandomUniform", "RandomUniformLike"};
+  return ops;
+}
+
+bool IsCpuTensor(const OrtValue& value) {
+  return value.IsTensor() && value.Get<Tensor>().Location().device.Type() == OrtDevice::CPU;
+}
+
+size_t TensorSizeInBytes(const Tensor& tensor) {
+  size_t size = tensor.SizeInBytes();
+  if (tensor.IsDataTypeString()) {
+    for (const auto& str : tensor.DataAsSpan<std::string>()) {
+      size += str.size();
+    }
+  }
+
+  return size;
+}
+
+OrtValue CopyTensor(const Tensor& src, const AllocatorPtr& allocator) {
+  OrtValue copy;
+  Tensor::InitOrtValue(src.DataType(), src.Shape(), allocator, copy);
+  auto& dst = *copy.GetMutable<Tensor>();
+  if (src.IsDataTypeString()) {
+    const auto src_strings = src.DataAsSpan<std::string>();
+    std::copy(src_strings.begin(), src_strings.end(), dst.MutableData<std::string>());
+  } else {
+    std::memcpy(dst.MutableDataRaw(), src.DataRaw(), src.SizeInBytes());
+  }
+
+  return copy;
+}
+
+bool TensorsEqual(const Tensor& a, const Tensor& b) {
+  if (a.GetElementType() != b.GetElementType() || a.Shape() != b.Shape()) {
+    return false;
+  }
+
+  if (a.IsDataTypeString()) {
+    const auto a_strings = a.DataAsSpan<std::string>();
+    const auto b_strings = b.DataAsSpan<std::string>();
+    return std::equal(a_strings.begin(), a_strings.end(), b_strings.begin());
+  }
+
+  return std::memcmp(a.DataRaw(), b.DataRaw(), a.SizeInBytes()) == 0;
+}
+
+// hash the element type, the shape and the data of the tensor. returns false if the tensor is too large to hash.
+bool HashTensor(const Tensor& tensor, uint32_t hash[4]) {
+  constexpr size_t max_len = static_cast<size_t>(std::numeric_limits<int>::max());
+  InlinedVector<int64_t> header{tensor.GetElementType(), static_cast<int64_t>(tensor.Shape().NumDimensions())};
+  const auto dims = tensor.Shape().GetDims();
+  header.insert(header.end(), dims.begin(), dims.end());
+  MurmurHash3::x86_128(header.data(), static_cast<int>(header.size() * sizeof(int64_t)), hash[0], hash);
+
+  if (tensor.IsDataTypeString()) {
+    for (const auto& str : tensor.DataAsSpan<std::string>()) {
+      if (str.size() > max_len) {
+        return false;
+      }
+
+      MurmurHash3::x86_128(str.data(), static_cast<int>(str.size()), hash[0], hash);
+    }
+  } else {
+    if (tensor.SizeInBytes() > max_len) {
+      return false;
+    }
+
+    MurmurHash3::x86_128(tensor.DataRaw(), static_cast<int>(tensor.SizeInBytes()), hash[0], hash);
+  }
+
+  return true;
+}
+
+}  // namespace
+
+Status SubgraphResultCache::Create(const SessionState& session_state, const std::string& cacheable_input_names,
+                                   size_t budget_bytes, std::unique_ptr<SubgraphResultCache>& cache) {
+  cache.reset();
+
+  const auto& graph_viewer = session_state.GetGraphViewer();
+  const auto& ort_value_name_idx_map = session_state.GetOrtValueNameIdxMap();
+  const auto* plan = session_state.GetExecutionPlan();
+  ORT_RETURN_IF(plan == nullptr, "The execution plan must be created before the subgraph result cache.");
+
+  std::unique_ptr<SubgraphResultCache> new_cache{
+      new SubgraphResultCache(session_state.GetAllocator(OrtDevice()), budget_bytes)};
+  ORT_RETURN_IF(new_cache->cpu_allocator_ == nullptr, "No CPU allocator for the subgraph result cache.");
+
+  const size_t num_values = static_cast<size_t>(ort_value_name_idx_map.MaxIdx() + 1);
+  // values that can be computed from the cacheable inputs and constant initializers
+  std::vector<bool> is_cacheable(num_values, false);
+  // cacheable values that depend on at least one cacheable input
+  std::vector<bool> depends_on_inputs(num_values, false);
+  // values produced by cached nodes
+  std::vector<bool> is_cached_node_output(num_values, false);
+
+  for (const auto& entry : session_state.GetConstantInitializedTensors()) {
+    is_cacheable[entry.first] = true;
+  }
+
+  for (const auto name : utils::SplitString(cacheable_input_names, ";")) {
+    const auto& graph_inputs = graph_viewer.GetInputs();
+    const bool is_graph_input = std::any_of(graph_inputs.begin(), graph_inputs.end(),
+                                            [&name](const NodeArg* input) { return input->Name() == name; });
+    ORT_RETURN_IF_NOT(is_graph_input, "Cacheable input '", name, "' is not an input of the graph.");
+
+    int idx;
+    ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(name, idx));
+    is_cacheable[idx] = true;
+    depends_on_inputs[idx] = true;
+    new_cache->cacheable_input_idxs_.push_back(idx);
+  }
+
+  if (new_cache->cacheable_input_idxs_.empty()) {
+    return Status::OK();
+  }
+
+  auto for_each_input = [&](const Node& node, const std::function<Status(int)>& func) -> Status {
+    auto process_defs = [&](const ConstPointerContainer<std::vector<NodeArg*>>& defs) -> Status {
+      for (const auto* def : defs) {
+        if (def->Exists()) {
+          int idx;
+          ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(def->Name(), idx));
+          ORT_RETURN_IF_ERROR(func(idx));
+        }
+      }
+
+      return Status::OK();
+    };
+
+    ORT_RETURN_IF_ERROR(process_defs(node.InputDefs()));
+    return process_defs(node.ImplicitInputDefs());
+  };
+
+  // the execution plan is in topological order
+  new_cache->is_cached_node_.resize(graph_viewer.MaxNodeIndex(), false);
+  for (const auto& node_exec_plan : plan->execution_plan) {
+    const auto& node = *graph_viewer.GetNode(node_exec_plan.node_index);
+    // control flow nodes have their own session states and are never cached
+    bool cached = !node.ContainsSubgraph() && node.GetExecutionProviderType() == kCpuExecutionProvider &&
+                  NonDeterministicOps().count(node.OpType()) == 0;
+    bool depends = false;
+    ORT_RETURN_IF_ERROR(for_each_input(node, [&](int idx) {
+      cached = cached && is_cacheable[idx];
+      depends = depends || depends_on_inputs[idx];
+      return Status::OK();
+    }));
+
+    if (!cached || !depends) {
+      continue;
+    }
+
+    new_cache->is_cached_node_[node.Index()] = true;
+    ++new_cache->num_cached_nodes_;
+    for (const auto* def : node.OutputDefs()) {
+      if (def->Exists()) {
+        int idx;
+        ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(def->Name(), idx));
+        is_cacheable[idx] = true;
+        depends_on_inputs[idx] = true;
+        is_cached_node_output[idx] = true;
+      }
+    }
+  }
+
+  // values whose buffer the plan reuses for another value
+  std::vector<bool> is_buffer_reused(num_values, false);
+  for (const auto& alloc_plan : plan->allocation_plan) {
+    if (alloc_plan.alloc_kind != AllocKind::kReuse && alloc_plan.alloc_kind != AllocKind::kShare) {
+      continue;
+    }
+
+    // mark every value along the chain of reused buffers
+    for (int reused = alloc_plan.reused_buffer; !is_buffer_reused[reused];) {
+      is_buffer_reused[reused] = true;
+      const auto& reused_plan = plan->allocation_plan[reused];
+      if (reused_plan.alloc_kind != AllocKind::kReuse && reused_plan.alloc_kind != AllocKind::kShare) {
+        break;
+      }
+
+      reused = reused_plan.reused_buffer;
+    }
+  }
+
+  std::vector<bool> is_graph_output(num_values, false);
+  for (const auto* output : graph_viewer.GetOutputs()) {
+    int idx;
+    ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(output->Name(), idx));
+    is_graph_output[idx] = true;
+  }
+
+  InlinedHashMap<int, size_t> frontier_index;
+  auto add_to_frontier = [&](int idx) {
+    if (is_cached_node_output[idx] && frontier_index.count(idx) == 0) {
+      frontier_index.emplace(idx, new_cache->frontier_.size());
+      new_cache->frontier_.push_back({idx, is_graph_output[idx] || is_buffer_reused[idx]});
+    }
+  };
+
+  for (const auto& node_exec_plan : plan->execution_plan) {
+    const auto& node = *graph_viewer.GetNode(node_exec_plan.node_index);
+    if (!new_cache->IsCachedNode(node.Index())) {
+      ORT_RETURN_IF_ERROR(for_each_input(node, [&](int idx) {
+        add_to_frontier(idx);
+        return Status::OK();
+      }));
+    }
+  }
+
+  for (size_t idx = 0; idx < num_values; ++idx) {
+    if (is_graph_output[idx]) {
+      add_to_frontier(static_cast<int>(idx));
+    }
+  }
+
+  if (new_cache->frontier_.empty()) {
+    return Status::OK();
+  }
+
+  for (const auto& frontier_value : new_cache->frontier_) {
+    const auto& alloc_plan = plan->allocation_plan[frontier_value.ort_value_idx];
+    if (alloc_plan.value_type == nullptr || !alloc_plan.value_type->IsTensorType() ||
+        alloc_plan.location.device.Type() != OrtDevice::CPU) {
+      LOGS(session_state.Logger(), INFO) << "The subgraph result cache only supports CPU tensors. It is disabled.";
+      return Status::OK();
+    }
+  }
+
+  for (const auto& node_exec_plan : plan->execution_plan) {
+    const auto& node = *graph_viewer.GetNode(node_exec_plan.node_index);
+    if (!new_cache->IsCachedNode(node.Index())) {
+      continue;
+    }
+
+    const auto& output_defs = node.OutputDefs();
+    for (int i = 0, end = static_cast<int>(output_defs.size()); i < end; ++i) {
+      if (!output_defs[i]->Exists()) {
+        continue;
+      }
+
+      int idx;
+      ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(output_defs[i]->Name(), idx));
+      auto it = frontier_index.find(idx);
+      if (it != frontier_index.end()) {
+        new_cache->frontier_outputs_[node.Index()].push_back({i, it->second});
+      }
+    }
+  }
+
+  LOGS(session_state.Logger(), INFO) << "Subgraph result cache: " << new_cache->num_cached_nodes_
+                                     << " cached nodes, " << new_cache->frontier_.size() << " cached values.";
+  cache = std::move(new_cache);
+  return Status::OK();
+}
+
+bool SubgraphResultCache::Matches(const Entry& entry, gsl::span<const OrtValue* const> inputs) {
+  for (size_t i = 0, end = inputs.size(); i < end; ++i) {
+    if (!TensorsEqual(entry.inputs[i].Get<Tensor>(), inputs[i]->Get<Tensor>())) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void SubgraphResultCache::Lookup(gsl::span<const int>& feed_mlvalue_idxs, gsl::span<const OrtValue>& feeds,
+                                 gsl::span<const OrtValue> fetches, RunState& run_state) const {
+  run_state = RunState{};
+
+  // the cached values would replace preallocated outputs instead of being written to them
+  for (const auto& fetch : fetches) {
+    if (fetch.IsAllocated()) {
+      return;
+    }
+  }
+
+  uint32_t hash[4] = {0, 0, 0, 0};
+  for (const int input_idx : cacheable_input_idxs_) {
+    auto it = std::find(feed_mlvalue_idxs.begin(), feed_mlvalue_idxs.end(), input_idx);
+    if (it == feed_mlvalue_idxs.end()) {
+      return;
+    }
+
+    const OrtValue& feed = feeds[it - feed_mlvalue_idxs.begin()];
+    if (!IsCpuTensor(feed) || !HashTensor(feed.Get<Tensor>(), hash)) {
+      return;
+    }
+
+    run_state.inputs.push_back(&feed);
+  }
+
+  run_state.enabled = true;
+  run_state.key = (static_cast<uint64_t>(hash[1]) << 32) | hash[0];
+
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = entries_.find(run_state.key);
+    if (it == entries_.end() || !Matches(*it->second.entry, run_state.inputs)) {
+      ++num_misses_;
+      run_state.captured.resize(frontier_.size());
+      return;
+    }
+
+    ++num_hits_;
+    lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+    run_state.hit = it->second.entry;
+  }
+
+  run_state.feed_mlvalue_idxs.assign(feed_mlvalue_idxs.begin(), feed_mlvalue_idxs.end());
+  run_state.feeds.assign(feeds.begin(), feeds.end());
+  const auto& frontier_values = run_state.hit->frontier_values;
+  for (size_t i = 0, end = frontier_.size(); i < end; ++i) {
+    run_state.feed_mlvalue_idxs.push_back(frontier_[i].ort_value_idx);
+    run_state.feeds.push_back(frontier_[i].needs_copy ? CopyTensor(frontier_values[i].Get<Tensor>(), cpu_allocator_)
+                                                      : frontier_values[i]);
+  }
+
+  feed_mlvalue_idxs = run_state.feed_mlvalue_idxs;
+  feeds = run_state.feeds;
+}
+
+Status SubgraphResultCache::CaptureOutputs(NodeIndex node_index, OpKernelContextInternal& op_kernel_context,
+                                           RunState& run_state) const {
+  if (!run_state.enabled || run_state.hit != nullptr) {
+    return Status::OK();
+  }
+
+  auto it = frontier_outputs_.find(node_index);
+  if (it == frontier_outputs_.end()) {
+    return Status::OK();
+  }
+
+  for (const auto& frontier_output : it->second) {
+    const OrtValue* output = op_kernel_context.GetOutputMLValue(frontier_output.output_index);
+    if (output == nullptr || !IsCpuTensor(*output)) {
+      // the Run still succeeds but its results can't be cached
+      run_state.enabled = false;
+      return Status::OK();
+    }
+
+    run_state.captured[frontier_output.frontier_index] = CopyTensor(output->Get<Tensor>(), cpu_allocator_);
+  }
+
+  return Status::OK();
+}
+
+void SubgraphResultCache::Insert(RunState& run_state) const {
+  if (!run_state.enabled || run_state.hit != nullptr) {
+    return;
+  }
+
+  auto entry = std::make_shared<Entry>();
+  for (const auto* input : run_state.inputs) {
+    const auto& tensor = input->Get<Tensor>();
+    entry->inputs.push_back(CopyTensor(tensor, cpu_allocator_));
+    entry->size_in_bytes += TensorSizeInBytes(tensor);
+  }
+
+  for (auto& value : run_state.captured) {
+    if (!value.IsAllocated()) {
+      return;
+    }
+
+    entry->size_in_bytes += TensorSizeInBytes(value.Get<Tensor>());
+    entry->frontier_values.push_back(std::move(value));
+  }
+
+  if (entry->size_in_bytes > budget_bytes_) {
+    return;
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (entries_.count(run_state.key) != 0) {
+    // another Run with the same inputs inserted its results concurrently
+    return;
+  }
+
+  while (size_in_bytes_ + entry->size_in_bytes > budget_bytes_) {
+    auto evicted = entries_.find(lru_.back());
+    size_in_bytes_ -= evicted->second.entry->size_in_bytes;
+    entries_.erase(evicted);
+    lru_.pop_back();
+    ++num_evictions_;
+  }
+
+  size_in_bytes_ += entry->size_in_bytes;
+  lru_.push_front(run_state.key);
+  entries_.emplace(run_state.key, Slot{std::move(entry), lru_.begin()});
+}
+
+size_t SubgraphResultCache::NumHits() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return num_hits_;
+}
+
+size_t SubgraphResultCache::NumMisses() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return num_misses_;
+}
+
+size_t SubgraphResultCache::NumEvictions() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return num_evictions_;
+}
+
+size_t SubgraphResultCache::SizeInBytes() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return size_in_bytes_;
+}
+
+}  // namespace onnxruntime
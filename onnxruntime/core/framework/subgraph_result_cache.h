@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/gsl.h"
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/graph/basic_types.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class OpKernelContextInternal;
+class SessionState;
+
+/**
+ * Caches the results of the part of a graph that only depends on a set of inputs, for workloads where those
+ * inputs repeat between Runs (e.g. user features in a recommendation model, or a prompt prefix).
+ *
+ * The cached nodes are the nodes whose inputs are computed from the cacheable inputs and constant initializers
+ * only. The values they produce that are used by the rest of the graph, or are graph outputs, are the 'frontier'.
+ * A Run looks up the hash of its cacheable inputs. On a miss the frontier values are copied as the cached nodes
+ * produce them and inserted once the Run succeeds. On a hit the cached frontier values are fed to the
+ * ExecutionFrame and the cached nodes are skipped.
+ *
+ * Entries are evicted in least recently used order to stay within a memory budget.
+ * Only CPU tensors are cached. Thread-safe.
+ */
+class SubgraphResultCache {
+ public:
+  struct Entry {
+    // copies of the cacheable inputs, to confirm a hash match
+    InlinedVector<OrtValue> inputs;
+    InlinedVector<OrtValue> frontier_values;
+    size_t size_in_bytes{0};
+  };
+
+  // The cache state of a single Run.
+  struct RunState {
+    // false if the Run can't use the cache, e.g. because a cacheable input wasn't fed
+    bool enabled{false};
+    uint64_t key{0};
+    InlinedVector<const OrtValue*> inputs;
+    // set on a hit
+    std::shared_ptr<const Entry> hit;
+    // frontier values copied on a miss. a frontier value that wasn't produced leaves the slot unallocated.
+    InlinedVector<OrtValue> captured;
+    // on a hit, the feeds of the Run followed by the cached values
+    std::vector<int> feed_mlvalue_idxs;
+    std::vector<OrtValue> feeds;
+  };
+
+  // Creates the cache for the main graph of a finalized session state.
+  // `cacheable_input_names` is a ';' separated list of graph input names.
+  // `cache` is left empty if no node depends only on the cacheable inputs.
+  static Status Create(const SessionState& session_state, const std::string& cacheable_input_names,
+                       size_t budget_bytes, std::unique_ptr<SubgraphResultCache>& cache);
+
+  // Hashes the cacheable inputs of a Run and looks them up. Updates the hit/miss counters.
+  // On a hit `feed_mlvalue_idxs` and `feeds` are pointed to copies in `run_state` that also contain the cached
+  // values, so the ExecutionFrame created with them has the values the skipped nodes would produce.
+  void Lookup(gsl::span<const int>& feed_mlvalue_idxs, gsl::span<const OrtValue>& feeds,
+              gsl::span<const OrtValue> fetches, RunState& run_state) const;
+
+  // true if the node doesn't need to run because its outputs are fed from the cache
+  static bool SkipNode(const SubgraphResultCache* cache, const RunState& run_state, NodeIndex node_index) {
+    return run_state.hit != nullptr && cache->IsCachedNode(node_index);
+  }
+
+  bool IsCachedNode(NodeIndex node_index) const {
+    return node_index < is_cached_node_.size() && is_cached_node_[node_index];
+  }
+
+  // On a miss, copies the frontier values produced by a node after it ran.
+  Status CaptureOutputs(NodeIndex node_index, OpKernelContextInternal& op_kernel_context, RunState& run_state) const;
+
+  // Inserts the values captured by a successful Run that missed the cache, evicting the least recently used
+  // entries to stay within the budget.
+  void Insert(RunState& run_state) const;
+
+  size_t NumHits() const;
+  size_t NumMisses() const;
+  size_t NumEvictions() const;
+  size_t SizeInBytes() const;
+
+  size_t NumCachedNodes() const noexcept { return num_cached_nodes_; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SubgraphResultCache);
+
+  SubgraphResultCache(AllocatorPtr cpu_allocator, size_t budget_bytes)
+      : cpu_allocator_(std::move(cpu_allocator)), budget_bytes_(budget_bytes) {}
+
+  static bool Matches(const Entry& entry, gsl::span<const OrtValue* const> inputs);
+
+  struct FrontierValue {
+    int ort_value_idx;
+    // a cached value can't be handed to the frame as is if the frame may write to its buffer or return it
+    // to the caller, e.g. because the plan reuses its buffer for another value or it is a graph output.
+    bool needs_copy;
+  };
+
+  // output of a cached node that is a frontier value
+  struct FrontierOutput {
+    int output_index;
+    size_t frontier_index;
+  };
+
+  using LruList = std::list<uint64_t>;
+
+  struct Slot {
+    std::shared_ptr<const Entry> entry;
+    LruList::iterator lru_position;
+  };
+
+  AllocatorPtr cpu_allocator_;
+  const size_t budget_bytes_;
+
+  InlinedVector<int> cacheable_input_idxs_;
+  std::vector<bool> is_cached_node_;
+  size_t num_cached_nodes_{0};
+  InlinedVector<FrontierValue> frontier_;
+  InlinedHashMap<NodeIndex, InlinedVector<FrontierOutput>> frontier_outputs_;
+
+  mutable OrtMutex mutex_;
+  // most recently used key is at the front
+  mutable LruList lru_;
+  mutable InlinedHashMap<uint64_t, Slot> entries_;
+  mutable size_t size_in_bytes_{0};
+  mutable size_t num_hits_{0};
+  mutable size_t num_misses_{0};
+  mutable size_t num_evictions_{0};
+};
+
+}  // namespace onnxruntime
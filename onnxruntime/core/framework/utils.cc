@@ -9,11 +9,13 @@
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/execution_providers.h"
+#include "core/framework/fast_sequential_executor.h"
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/kernel_def_builder.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/parallel_executor.h"
+#include "core/framework/work_stealing_executor.h"
 #include "core/framework/session_state.h"
 #include "core/framework/sequential_executor.h"
 #include "core/framework/tensorprotoutils.h"
@@ -526,17 +528,30 @@ static common::Status ExecuteGraphImpl(const SessionState& session_state,
                                        const logging::Logger& logger, const bool only_execute_path_to_fetches = false) {
   // avoid memory allocations
   std::optional<SequentialExecutor> seq_executor;
+  std::optional<FastSequentialExecutor> fast_seq_executor;
   std::optional<ParallelExecutor> par_executor;
+  std::optional<WorkStealingExecutor> work_stealing_executor;
   IExecutor* p_exec = nullptr;
   if (execution_mode == ExecutionMode::ORT_SEQUENTIAL) {
-    seq_executor.emplace(terminate_flag, only_execute_path_to_fetches);
-    p_exec = &seq_executor.value();
-  } else if (execution_mode == ExecutionMode::ORT_PARALLEL) {
+    // the fast path has no profiling and always executes every node
+    const auto* dispatch_table = session_state.GetKernelDispatchTable();
+    if (dispatch_table != nullptr && !session_state.Profiler().IsEnabled() && !only_execute_path_to_fetches) {
+      fast_seq_executor.emplace(*dispatch_table, terminate_flag);
+      p_exec = &fast_seq_executor.value();
+    } else {
+      seq_executor.emplace(terminate_flag, only_execute_path_to_fetches);
+      p_exec = &seq_executor.value();
+    }
+  } else if (execution_mode == ExecutionMode::ORT_PARALLEL ||
+             execution_mode == ExecutionMode::ORT_PARALLEL_WORK_STEALING) {
     auto* p_inter_op_thread_pool = session_state.GetInterOpThreadPool();
     if (!p_inter_op_thread_pool) {
       LOGS(logger, WARNING) << "Only one thread was configured for parallel execution. Hence will use sequential execution.";
       seq_executor.emplace(terminate_flag, only_execute_path_to_fetches);
       p_exec = &seq_executor.value();
+    } else if (execution_mode == ExecutionMode::ORT_PARALLEL_WORK_STEALING) {
+      work_stealing_executor.emplace(session_state, terminate_flag);
+      p_exec = &work_stealing_executor.value();
     } else {
       par_executor.emplace(session_state, terminate_flag);
       p_exec = &par_executor.value();
@@ -0,0 +1,490 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/work_stealing_executor.h"
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+#include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/execution_frame.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/session_state.h"
+#include "core/framework/utils.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+namespace {
+// Number of rounds a worker tries to steal before going to sleep.
+constexpr int kStealRoundsBeforeSleep = 64;
+}  // namespace
+
+WorkStealingQueue::WorkStealingQueue(size_t capacity) {
+  size_t size = 1;
+  while (size < capacity) {
+    size <<= 1;
+  }
+
+  mask_ = static_cast<int64_t>(size) - 1;
+  items_ = std::make_unique<std::atomic<size_t>[]>(size);
+}
+
+void WorkStealingQueue::Push(size_t item) {
+  const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+  ORT_ENFORCE(bottom - top_.load(std::memory_order_acquire) <= mask_, "WorkStealingQueue is full.");
+  items_[bottom & mask_].store(item, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  bottom_.store(bottom + 1, std::memory_order_relaxed);
+}
+
+size_t WorkStealingQueue::Pop() {
+  const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+  bottom_.store(bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t top = top_.load(std::memory_order_relaxed);
+
+  size_t item = kEmpty;
+  if (top <= bottom) {
+    item = items_[bottom & mask_].load(std::memory_order_relaxed);
+    if (top == bottom) {
+      // last item. race against thieves for it.
+      if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        item = kEmpty;
+      }
+
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+  } else {
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+  }
+
+  return item;
+}
+
+size_t WorkStealingQueue::Steal() {
+  int64_t top = top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  const int64_t bottom = bottom_.load(std::memory_order_acquire);
+
+  if (top < bottom) {
+    const size_t item = items_[top & mask_].load(std::memory_order_relaxed);
+    if (top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return item;
+    }
+  }
+
+  return kEmpty;
+}
+
+WorkStealingExecutor::WorkStealingExecutor(const SessionState& session_state, const bool& terminate_flag)
+    : schedule_(session_state.GetParallelExecutionSchedule()),
+      terminate_flag_(terminate_flag),
+      executor_pool_(session_state.GetInterOpThreadPool()) {
+  if (schedule_ == nullptr) {
+    local_schedule_.emplace();
+    ORT_THROW_IF_ERROR(ParallelExecutionSchedule::Create(session_state.GetGraphViewer(),
+                                                         *session_state.GetExecutionPlan(), *local_schedule_));
+    schedule_ = &*local_schedule_;
+  }
+}
+
+Status WorkStealingExecutor::Execute(const SessionState& session_state, gsl::span<const int> feed_mlvalue_idxs,
+                                     gsl::span<const OrtValue> feeds, gsl::span<const int> fetch_mlvalue_idxs,
+                                     std::vector<OrtValue>& fetches,
+                                     const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
+                                     const logging::Logger& logger) {
+  TimePoint tp;
+  const bool is_profiler_enabled = session_state.Profiler().IsEnabled();
+  if (is_profiler_enabled) {
+    tp = session_state.Profiler().Start();
+  }
+
+  root_frame_ = std::make_unique<ExecutionFrame>(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
+                                                 fetch_allocators, session_state);
+
+  const size_t num_nodes = schedule_->NumNodes();
+  dependency_counts_ = std::make_unique<std::atomic<int>[]>(num_nodes);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    dependency_counts_[i].store(schedule_->dependency_counts[i], std::memory_order_relaxed);
+  }
+
+  remaining_nodes_.store(num_nodes);
+
+  if (num_nodes > 0) {
+    const size_t num_workers = std::min<size_t>(
+        std::max(concurrency::ThreadPool::DegreeOfParallelism(executor_pool_), 1), num_nodes);
+    queues_.clear();
+    queues_.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+      queues_.push_back(std::make_unique<WorkStealingQueue>(num_nodes));
+    }
+
+    // spread the roots across the queues. each queue gets its share in ascending priority order so the
+    // root with the highest priority is popped first.
+    const auto& roots = schedule_->roots;
+    for (size_t i = roots.size(); i-- > 0;) {
+      queues_[i % num_workers]->Push(roots[i]);
+    }
+
+    num_ready_.store(static_cast<int64_t>(roots.size()));
+
+    {
+      std::lock_guard<OrtMutex> lock(complete_mutex_);
+      active_workers_ = static_cast<int>(num_workers) - 1;
+    }
+
+    for (size_t worker_id = 1; worker_id < num_workers; ++worker_id) {
+      concurrency::ThreadPool::Schedule(executor_pool_, [this, worker_id, &session_state, &logger]() {
+        WorkerLoop(worker_id, session_state, logger);
+
+        bool finished = false;
+        {
+          std::lock_guard<OrtMutex> lock(complete_mutex_);
+          finished = --active_workers_ == 0;
+        }
+
+        if (finished) {
+          complete_cv_.notify_all();
+        }
+      });
+    }
+
+    // the calling thread is worker 0
+    WorkerLoop(0, session_state, logger);
+
+    // Wait for finish.
+    {
+      std::unique_lock<OrtMutex> lock(complete_mutex_);
+      while (active_workers_ > 0) complete_cv_.wait(lock);
+    }
+  }
+
+  Status status = Status::OK();
+
+  if (!errors_.empty()) {
+    if (errors_.size() == 1)
+      status = errors_.front();
+    else {
+      std::stringstream ss;
+      ss << "Multiple errors were found.";
+      for (const auto& s : errors_) {
+        ss << '\n'
+           << s;
+      }
+
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ss.str());
+    }
+
+    LOGS(logger, ERROR) << status;
+    return status;
+  }
+
+  VLOGS(logger, 1) << "Fetching output.";
+  // ExecutionFrame::Finalize will update 'fetches' with the final output
+  ORT_RETURN_IF_ERROR(root_frame_->GetOutputs(fetches));
+  VLOGS(logger, 1) << "Done execution.";
+
+  if (root_frame_->HasMemoryPatternPlanner()) {
+    bool all_tensors = true;
+    for (const auto& feed : feeds) {
+      if (!(feed.IsTensor())) {
+        all_tensors = false;
+        break;
+      }
+    }
+
+    if (all_tensors) {
+      MemoryPatternGroup mem_patterns;
+      ORT_RETURN_IF_ERROR(root_frame_->GeneratePatterns(mem_patterns));
+      ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(feeds, std::move(mem_patterns)));
+    }
+  }
+
+  if (is_profiler_enabled) {
+    const auto& mem_pattern_cache = session_state.GetMemoryPatternCache();
+    session_state.Profiler().EndTimeAndRecordEvent(
+        profiling::SESSION_EVENT, "WorkStealingExecutor::Execute", tp,
+        {{"mem_pattern_cache_hits", std::to_string(mem_pattern_cache.NumHits())},
+         {"mem_pattern_cache_misses", std::to_string(mem_pattern_cache.NumMisses())},
+         {"mem_pattern_cache_evictions", std::to_string(mem_pattern_cache.NumEvictions())}});
+  }
+
+  return Status::OK();
+}
+
+size_t WorkStealingExecutor::FindWork(size_t worker_id) {
+  size_t position = queues_[worker_id]->Pop();
+  if (position != WorkStealingQueue::kEmpty) {
+    num_ready_.fetch_sub(1);
+    return position;
+  }
+
+  // start with the next worker so thieves spread out across the victims
+  const size_t num_workers = queues_.size();
+  for (size_t i = 1; i < num_workers; ++i) {
+    position = queues_[(worker_id + i) % num_workers]->Steal();
+    if (position != WorkStealingQueue::kEmpty) {
+      num_ready_.fetch_sub(1);
+      return position;
+    }
+  }
+
+  return WorkStealingQueue::kEmpty;
+}
+
+void WorkStealingExecutor::PushReady(size_t worker_id, size_t position) {
+  num_ready_.fetch_add(1);
+  queues_[worker_id]->Push(position);
+
+  if (num_idle_workers_.load() > 0) {
+    std::lock_guard<OrtMutex> lock(idle_mutex_);
+    idle_cv_.notify_one();
+  }
+}
+
+void WorkStealingExecutor::RecordError(const Status& status) {
+  {
+    std::lock_guard<OrtMutex> lock(complete_mutex_);
+    errors_.push_back(status);
+  }
+
+  has_error_.store(true, std::memory_order_release);
+
+  std::lock_guard<OrtMutex> lock(idle_mutex_);
+  idle_cv_.notify_all();
+}
+
+void WorkStealingExecutor::WorkerLoop(size_t worker_id, const SessionState& session_state,
+                                      const logging::Logger& logger) {
+  int failed_rounds = 0;
+
+  while (!ShouldStop()) {
+    size_t position = FindWork(worker_id);
+    if (position == WorkStealingQueue::kEmpty) {
+      if (++failed_rounds < kStealRoundsBeforeSleep) {
+        std::this_thread::yield();
+        continue;
+      }
+
+      // nothing to do for a while, e.g. all remaining work depends on a long running node. sleep until a node
+      // is queued. num_idle_workers_ is incremented before num_ready_ is checked, and PushReady increments
+      // num_ready_ before checking num_idle_workers_, so a push can't be missed.
+      std::unique_lock<OrtMutex> lock(idle_mutex_);
+      num_idle_workers_.fetch_add(1);
+      while (num_ready_.load() <= 0 && !ShouldStop()) {
+        idle_cv_.wait(lock);
+      }
+
+      num_idle_workers_.fetch_sub(1);
+      failed_rounds = 0;
+      continue;
+    }
+
+    failed_rounds = 0;
+
+    // Avoid going through the queues if possible.
+    while (position != WorkStealingQueue::kEmpty && !has_error_.load(std::memory_order_acquire)) {
+      auto create_exception_message = [this, position, &session_state](const std::exception* ex) {
+        const auto* node = session_state.GetGraphViewer().GetNode(schedule_->nodes[position]);
+
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exception running nodes starting at ", node->OpType(),
+                               " node '", node->Name(), "'. ",
+                               ex ? ex->what() : "Unknown exception was caught by catch-all handler.");
+      };
+
+      size_t next_position = WorkStealingQueue::kEmpty;
+      Status status;
+      ORT_TRY {
+        status = RunNode(position, worker_id, session_state, logger, next_position);
+      }
+      ORT_CATCH(const std::exception& ex) {
+        ORT_HANDLE_EXCEPTION([&]() {
+          status = create_exception_message(&ex);
+        });
+      }
+      ORT_CATCH(...) {
+        // catch node processing failure exceptions here to prevent app crash.
+        status = create_exception_message(nullptr);
+      }
+
+      if (!status.IsOK()) {
+        RecordError(status);
+        break;
+      }
+
+      position = next_position;
+    }
+  }
+}
+
+Status WorkStealingExecutor::RunNode(size_t position, size_t worker_id, const SessionState& session_state,
+                                     const logging::Logger& logger, size_t& next_position) {
+  next_position = WorkStealingQueue::kEmpty;
+
+  if (terminate_flag_) {
+    LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+  }
+
+  const NodeIndex node_index = schedule_->nodes[position];
+  const auto& graph_viewer = session_state.GetGraphViewer();
+  const SequentialExecutionPlan& exec_plan = *session_state.GetExecutionPlan();
+  const bool f_profiler_enabled = session_state.Profiler().IsEnabled();
+  TimePoint sync_time_begin;
+  TimePoint kernel_begin_time;
+
+  const auto* p_op_kernel = session_state.GetKernel(node_index);
+  const auto& node = *graph_viewer.GetNode(node_index);
+
+  // if a kernel has been added in the session state, it better be NON-null.
+  if (p_op_kernel == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Got nullptr from GetKernel for node: ", node.Name());
+  }
+
+  OpKernelContextInternal op_kernel_context(session_state, *root_frame_, *p_op_kernel, logger, terminate_flag_);
+
+  if (f_profiler_enabled) {
+    sync_time_begin = session_state.Profiler().Start();
+  }
+
+  // sync before compute
+  int queue_id = p_op_kernel->KernelDef().ExecQueueId();
+  if (exec_plan.NodeHasFence(node_index)) {
+    for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
+      Fence_t fence = op_kernel_context.InputFence(input_index);
+      if (fence) {
+        auto execution_provider_type = node.GetExecutionProviderType();
+        if (OrtMemTypeCPUInput == p_op_kernel->KernelDef().InputMemoryType(input_index)) {
+          execution_provider_type = kCpuExecutionProvider;
+        }
+        fence->BeforeUsingAsInput(execution_provider_type, queue_id);
+      }
+    }
+
+    for (int input_index = 0; input_index < op_kernel_context.ImplicitInputCount(); ++input_index) {
+      Fence_t fence = op_kernel_context.ImplicitInputFence(input_index);
+      if (fence) {
+        auto execution_provider_type = node.GetExecutionProviderType();
+        if (OrtMemTypeCPUInput == p_op_kernel->KernelDef().InputMemoryType(input_index)) {
+          execution_provider_type = kCpuExecutionProvider;
+        }
+        fence->BeforeUsingAsInput(execution_provider_type, queue_id);
+      }
+    }
+
+    for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
+      Fence_t fence = op_kernel_context.OutputFence(output_index);
+      if (fence) {
+        fence->BeforeUsingAsOutput(node.GetExecutionProviderType(), queue_id);
+      }
+    }
+  }
+
+  if (f_profiler_enabled) {
+    session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
+                                                   node.Name() + "_fence_before",
+                                                   sync_time_begin,
+                                                   {{"op_name", p_op_kernel->KernelDef().OpName()}});
+    concurrency::ThreadPool::StartProfiling(session_state.GetThreadPool());
+    kernel_begin_time = session_state.Profiler().Start();
+  }
+
+  // call compute on the kernel
+  VLOGS(logger, 1) << "Computing kernel: " << node.Name();
+
+#ifdef ENABLE_TRAINING
+  if (p_op_kernel->KernelDef().AllocateInputsContiguously()) {
+    ORT_RETURN_IF_ERROR(utils::VerifyInputTensorsAllocatedContiguously(&op_kernel_context));
+  }
+#endif
+
+  Status status = p_op_kernel->Compute(&op_kernel_context);
+  if (!status.IsOK()) {
+    std::ostringstream ss;
+    ss << "Non-zero status code returned while running " << node.OpType() << " node. Name:'" << node.Name()
+       << "' Status Message: " << status.ErrorMessage();
+    const auto msg_string = ss.str();
+    LOGS(logger, ERROR) << msg_string;
+    return Status(status.Category(), status.Code(), msg_string);
+  }
+
+  if (f_profiler_enabled) {
+    session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
+                                                   node.Name() + "_kernel_time",
+                                                   kernel_begin_time,
+                                                   {{"op_name", p_op_kernel->KernelDef().OpName()},
+                                                    {"provider", p_op_kernel->KernelDef().Provider()},
+                                                    {"worker_id", std::to_string(worker_id)},
+                                                    {"thread_scheduling_stats", concurrency::ThreadPool::StopProfiling(session_state.GetThreadPool())}});
+
+    sync_time_begin = session_state.Profiler().Start();
+  }
+
+  // sync after compute for outputs
+  if (exec_plan.NodeHasFence(node_index)) {
+    for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
+      Fence_t fence = op_kernel_context.InputFence(input_index);
+      if (fence) {
+        fence->AfterUsedAsInput(queue_id);
+      }
+    }
+
+    for (int input_index = 0; input_index < op_kernel_context.ImplicitInputCount(); ++input_index) {
+      Fence_t fence = op_kernel_context.ImplicitInputFence(input_index);
+      if (fence) {
+        fence->AfterUsedAsInput(queue_id);
+      }
+    }
+
+    for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
+      Fence_t fence = op_kernel_context.OutputFence(output_index);
+      if (fence) {
+        fence->AfterUsedAsOutput(queue_id);
+      }
+    }
+  }
+
+  if (f_profiler_enabled) {
+    session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
+                                                   node.Name() + "_fence_after",
+                                                   sync_time_begin,
+                                                   {{"op_name", p_op_kernel->KernelDef().OpName()}});
+  }
+
+  // Checking which downstream nodes are ready for running. The acquire-release decrement makes the outputs
+  // written by every upstream node visible to whichever thread runs the downstream node.
+  InlinedVector<size_t> ready;
+  for (size_t successor : schedule_->Successors(position)) {
+    if (dependency_counts_[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      ready.push_back(successor);
+    }
+  }
+
+  if (!ready.empty()) {
+    const auto& priorities = schedule_->priorities;
+    std::sort(ready.begin(), ready.end(), [&priorities](size_t a, size_t b) {
+      return priorities[a] < priorities[b];
+    });
+
+    // run the node on the critical path next on this thread and make the rest available to other workers.
+    // the queue is LIFO for the owner so the next most important node is popped next.
+    next_position = ready.back();
+    ready.pop_back();
+    for (size_t ready_position : ready) {
+      PushReady(worker_id, ready_position);
+    }
+  }
+
+  if (remaining_nodes_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    // all nodes are done. wake up the idle workers so they can exit.
+    std::lock_guard<OrtMutex> lock(idle_mutex_);
+    idle_cv_.notify_all();
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,111 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/iexecutor.h"
+#include "core/framework/framework_common.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/parallel_execution_schedule.h"
+#include "core/framework/session_state.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class ExecutionFrame;
+
+// Single producer, multi consumer work stealing deque (Chase-Lev) holding schedule positions.
+// The owning worker pushes and pops at the bottom, other workers steal from the top.
+// Capacity is fixed as every node is queued at most once per run.
+class WorkStealingQueue {
+ public:
+  static constexpr size_t kEmpty = static_cast<size_t>(-1);
+
+  explicit WorkStealingQueue(size_t capacity);
+
+  // owner only
+  void Push(size_t item);
+  // owner only. returns kEmpty if there is nothing to pop.
+  size_t Pop();
+  // any thread. returns kEmpty if there is nothing to steal or the steal lost a race.
+  size_t Steal();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(WorkStealingQueue);
+
+  // top_ and bottom_ are on separate cache lines as they are written by different threads
+  alignas(64) std::atomic<int64_t> top_{0};
+  alignas(64) std::atomic<int64_t> bottom_{0};
+  int64_t mask_;
+  std::unique_ptr<std::atomic<size_t>[]> items_;
+};
+
+// Executor that runs the graph on the inter-op thread pool using a work stealing queue per worker.
+// Dependency counts come from the session's ParallelExecutionSchedule and are decremented atomically,
+// so finishing a node doesn't take a lock. When a node makes several others ready the one with the
+// longest estimated path to the end of the graph is run next on the same thread.
+class WorkStealingExecutor : public IExecutor {
+ public:
+  WorkStealingExecutor(const SessionState& session_state, const bool& terminate_flag = false);
+
+  common::Status Execute(const SessionState& session_state, gsl::span<const int> feed_mlvalue_idxs,
+                         gsl::span<const OrtValue> feeds, gsl::span<const int> fetch_mlvalue_idxs,
+                         std::vector<OrtValue>& fetches,
+                         const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
+                         const logging::Logger& logger) override;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(WorkStealingExecutor);
+
+  void WorkerLoop(size_t worker_id, const SessionState& session_state, const logging::Logger& logger);
+
+  // Run the node at the given schedule position and queue the nodes it made ready.
+  // next_position is set to the ready node with the highest priority, which the caller should run next,
+  // or WorkStealingQueue::kEmpty.
+  Status RunNode(size_t position, size_t worker_id, const SessionState& session_state,
+                 const logging::Logger& logger, size_t& next_position);
+
+  size_t FindWork(size_t worker_id);
+  void PushReady(size_t worker_id, size_t position);
+  void RecordError(const Status& status);
+
+  bool ShouldStop() const {
+    return remaining_nodes_.load(std::memory_order_acquire) == 0 || has_error_.load(std::memory_order_acquire);
+  }
+
+  const ParallelExecutionSchedule* schedule_;
+  // used if the session state was not finalized with a schedule, e.g. in tests
+  std::optional<ParallelExecutionSchedule> local_schedule_;
+
+  std::unique_ptr<ExecutionFrame> root_frame_;
+  std::unique_ptr<std::atomic<int>[]> dependency_counts_;
+  std::vector<std::unique_ptr<WorkStealingQueue>> queues_;
+
+  std::atomic<size_t> remaining_nodes_{0};
+  // number of queued nodes. incremented before a push so it may briefly exceed the queue contents
+  std::atomic<int64_t> num_ready_{0};
+  std::atomic<bool> has_error_{false};
+
+  // idle workers sleep on idle_cv_ until new work is queued or execution finishes
+  OrtMutex idle_mutex_;
+  OrtCondVar idle_cv_;
+  std::atomic<int> num_idle_workers_{0};
+
+  // workers running on the inter-op thread pool. protected by complete_mutex_
+  int active_workers_{0};
+  OrtMutex complete_mutex_;
+  OrtCondVar complete_cv_;
+  std::vector<Status> errors_;  // protected by complete_mutex_
+
+  const bool& terminate_flag_;
+  onnxruntime::concurrency::ThreadPool* const executor_pool_{};
+};
+}  // namespace onnxruntime
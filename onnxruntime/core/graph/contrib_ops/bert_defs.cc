@@ -150,6 +150,19 @@ The qkv_hidden_sizes is required only when K and V have different hidden sizes.
 
 When there is past state, hidden dimension for Q, K and V shall be the same.
 
+The past and present state could be quantized to uint8 to reduce memory, which is supported by the CPU kernel
+for float input. Each row of head_size values of key or value is quantized symmetrically with zero point 128,
+and followed by the 4 bytes of its float scale, so the last dimension of past and present is head_size + 4.
+The present state has the same type as the past state.
+
+When past_sequence_length is given, past and present state share a buffer with shape
+(2, batch_size, num_heads, max_sequence_length, head_size), where only the first past_sequence_length rows of past
+are valid. The key and value of current tokens are written to present in place after them, so present has the same
+shape as past. When the present output is not bound to the same buffer as past, past is copied into present first.
+The optional cache_indirection with shape (batch_size, max_sequence_length) has, for each past row, the batch index
+in past that holds the row, so beam search could reorder beams by updating the indirection instead of copying the
+state. The shared buffer is supported by the CPU kernel for float past state.
+
 The total_sequence_length is past_sequence_length + kv_sequence_length. Here kv_sequence_length is the length of K or V.
 For self attention, kv_sequence_length equals to sequence_length (sequence length of Q).
 For cross attention, query and key might have different lengths.
@@ -193,7 +206,7 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
         .Input(4,
                "past",
                "past state for key and value with shape (2, batch_size, num_heads, past_sequence_length, head_size)",
-               "T",
+               "U",
                OpSchema::Optional)
         .Input(5,
                "extra_add",
@@ -212,14 +225,27 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "Required when weights is not available.",
                "T",
                OpSchema::Optional)
+        .Input(8,
+               "past_sequence_length",
+               "Number of valid rows in past with shape (1). When it is given, past and present share a buffer of "
+               "max_sequence_length rows.",
+               "M",
+               OpSchema::Optional)
+        .Input(9,
+               "cache_indirection",
+               "Batch index in past of each past row with shape (batch_size, max_sequence_length). "
+               "Only used with past_sequence_length.",
+               "M",
+               OpSchema::Optional)
         .Output(0,
                 "output",
                 "3D output tensor with shape (batch_size, sequence_length, v_hidden_size)",
                 "T")
         .Output(1,
                 "present",
-                "past state for key and value with shape (2, batch_size, num_heads, total_sequence_length, head_size)",
-                "T",
+                "past state for key and value with shape (2, batch_size, num_heads, total_sequence_length, head_size), "
+                "or the shape of past when past_sequence_length is given",
+                "U",
                 OpSchema::Optional)
         .TypeConstraint("T",
                         {"tensor(float)", "tensor(float16)"},
@@ -227,9 +253,13 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
         .TypeConstraint("M",
                         {"tensor(int32)"},
                         "Constrain mask index to integer types")
+        .TypeConstraint("U",
+                        {"tensor(float)", "tensor(float16)", "tensor(uint8)"},
+                        "Constrain past and present state types to float tensors, or uint8 tensors when quantized.")
         .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
           constexpr int past_input_index = 4;
-          AttentionTypeAndShapeInference(ctx, past_input_index);
+          constexpr int past_sequence_length_input_index = 8;
+          AttentionTypeAndShapeInference(ctx, past_input_index, past_sequence_length_input_index);
         }));
 
 constexpr const char* Longformer_Attention_doc = R"DOC(
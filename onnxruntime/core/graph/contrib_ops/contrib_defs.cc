@@ -601,6 +601,42 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
           return true;
         }));
 
+constexpr const char* FusedElementwise_ver1_doc = R"DOC(
+Evaluates an expression of elementwise operators in a single pass over the output.
+The expression is a list of operations in evaluation order, given by the `operations` attribute. Each operation is
+one of Add, Sub, Mul, Div, Relu, Sigmoid, Erf or Where with the semantics of the ONNX operator. The `operands` attribute
+lists the operands of all operations in order: index i refers to input i of the node when i is less than the number
+of inputs, and to the result of operation (i - number of inputs) otherwise. The output is the result of the last
+operation. Inputs are broadcast to the output shape, which is the multidirectional broadcast of all input shapes.
+The condition of Where must be a bool input of the node; every other operand is float.
+)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    FusedElementwise, 1,
+    OpSchema()
+        .SetDoc(FusedElementwise_ver1_doc)
+        .Attr("operations", "Operator types of the operations in evaluation order.", AttributeProto::STRINGS)
+        .Attr("operands", "Operand indices of all operations, in evaluation order.", AttributeProto::INTS)
+        .Input(0, "inputs", "Inputs of the expression.", "T", OpSchema::Variadic, /*is_homogeneous*/ false)
+        .Output(0, "Y", "Result of the last operation.", "T1")
+        .TypeConstraint("T", {"tensor(float)", "tensor(bool)"},
+                        "Constrain inputs to float tensors, or bool tensors for the conditions of Where.")
+        .TypeConstraint("T1", {"tensor(float)"}, "Constrain output to float tensors.")
+        .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+          updateOutputElemType(ctx, 0, ONNX_NAMESPACE::TensorProto::FLOAT);
+
+          std::vector<const ONNX_NAMESPACE::TensorShapeProto*> shapes;
+          for (size_t i = 0; i < ctx.getNumInputs(); ++i) {
+            if (!hasInputShape(ctx, i)) {
+              return;
+            }
+            shapes.push_back(&ctx.getInputType(i)->tensor_type().shape());
+          }
+
+          multidirectionalBroadcastShapeInference(shapes,
+                                                  *ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape());
+        }));
+
 // Used to be ONNX 1.7 Inverse(12)
 // Comment out docs not to increase the binary size
 //
@@ -440,6 +440,63 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
           ONNX_NAMESPACE::matmulShapeInference(ctx, 0, 1);
         }));
 
+constexpr const char* MatMulFpQ4_ver1_doc = R"DOC(
+Matrix product with right hand matrix being pre-packed and quantized int4 data blob.
+During quantization, the matrix is divided into blocks, where each block is a
+contiguous subset inside each column. Each block is quantized into a
+sequence of 4b integers with a scaling factor and an optional offset.
+Currently 4 quantization types are supported:
+0): type 0 block size 32, no offset, 1): type 1 block size 32, with offset,
+2): type 2 block size 128, no offset, 3): type 3 block size 128, with offset.
+The packed data blob is produced by MlasQ4GemmPackB (or the equivalent
+onnxruntime.quantization.matmul_weight4_quantizer tool), and the weights are
+dequantized inside the GEMM kernel so the activations stay in float.
+)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    MatMulFpQ4, 1,
+    OpSchema()
+        .SetDoc(MatMulFpQ4_ver1_doc)
+        .Input(0, "A", "N-dimensional matrix A", "T1")
+        .Input(1, "B", "1-dimensional data blob holding the block-wise 4-bit quantized K x N matrix B", "T2")
+        .Input(2, "bias", "1D input tensor, whose dimension is same as B's last dimension", "T1", OpSchema::Optional)
+        .Output(0, "Y", "Matrix multiply results from A * B", "T1")
+        .Attr("K", "number of rows of the quantized matrix B", AttributeProto::INT)
+        .Attr("N", "number of columns of the quantized matrix B", AttributeProto::INT)
+        .Attr("blk_quant_type", "Quantization type", AttributeProto::INT, static_cast<int64_t>(0))
+        .TypeConstraint("T1", {"tensor(float)"}, "Constrain input A, bias and output Y data type as float tensor.")
+        .TypeConstraint("T2", {"tensor(uint8)"}, "Constrain input B data type to data blob.")
+        .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+          propagateElemTypeFromInputToOutput(ctx, 0, 0);
+
+          if (!hasInputShape(ctx, 0)) {
+            return;
+          }
+
+          const auto& a_shape = ctx.getInputType(0)->tensor_type().shape();
+          if (a_shape.dim_size() == 0) {
+            fail_shape_inference("Input A must not be a scalar.");
+          }
+
+          const int64_t K = getAttribute(ctx, "K", -1);
+          const int64_t N = getAttribute(ctx, "N", -1);
+          if (K <= 0 || N <= 0) {
+            fail_shape_inference("Attributes K and N must be positive.");
+          }
+
+          const auto& a_k = a_shape.dim(a_shape.dim_size() - 1);
+          if (a_k.has_dim_value() && a_k.dim_value() != K) {
+            fail_shape_inference("Incompatible dimensions for matrix multiplication");
+          }
+
+          ONNX_NAMESPACE::TensorShapeProto y_shape;
+          for (int i = 0; i < a_shape.dim_size() - 1; ++i) {
+            *y_shape.add_dim() = a_shape.dim(i);
+          }
+          y_shape.add_dim()->set_dim_value(N);
+          updateOutputShape(ctx, 0, y_shape);
+        }));
+
 ONNX_MS_OPERATOR_SET_SCHEMA(
     QLinearAdd, 1,
     OpSchema().FillUsing(QLinearMathDocGenerator(
@@ -108,7 +108,8 @@ void EmbedLayerNormalizationShapeInference(::ONNX_NAMESPACE::InferenceContext& c
 }
 
 // Shape inference for Attention and QAttention
-void AttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, int past_input_index) {
+void AttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, int past_input_index,
+                                    int past_sequence_length_input_index) {
   // Input 0, 1, 2 are input, weights (optional) and bias.
   // The other inputs may vary in Attention and QAttention. For example, past_input_index is 4 for Attention,
   // and 8 for QAttention.
@@ -122,13 +123,17 @@ void AttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, int p
   //    Input 2 (bias) has 1D shape (hidden_size + hidden_size + v_hidden_size)
   //    Input 4 (past) has shape (2, batch_size, num_heads, past_sequence_length, head_size)
   //    Input 6 (value) has shape (batch_size, kv_sequence_length, v_hidden_size)
+  // When past_sequence_length (supported by Attention but not in QAttention) is given, past and present share
+  // a buffer of max_sequence_length rows, and present has the shape of past.
   //
   // Output 0 and 1 are output and present
 
-  // Type inference
+  // Type inference. The present state has the type of the past state, which could be quantized.
   ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 2, 0);
   if (ctx.getNumOutputs() > 1) {
-    ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 2, 1);
+    const bool has_past = ctx.getNumInputs() > static_cast<size_t>(past_input_index) &&
+                          ctx.getInputType(past_input_index) != nullptr;
+    ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, has_past ? past_input_index : 2, 1);
   }
 
   // Shape inference
@@ -174,6 +179,13 @@ void AttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, int p
           fail_shape_inference("The past input shall be 5 dimensions");
         }
 
+        if (past_sequence_length_input_index >= 0 &&
+            ctx.getNumInputs() > static_cast<size_t>(past_sequence_length_input_index) &&
+            ctx.getInputType(past_sequence_length_input_index) != nullptr) {
+          propagateShapeFromInputToOutput(ctx, past_input_index, 1);
+          return;
+        }
+
         int64_t total_sequence_length = -1;
         if (!hasInputShape(ctx, 1)) {  // no weights
           if (hasInputShape(ctx, 6)) {
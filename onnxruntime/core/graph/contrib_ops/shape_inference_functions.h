@@ -11,7 +11,8 @@ struct InferenceContext;
 
 namespace onnxruntime {
 namespace contrib {
-void AttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, int past_input_index);
+void AttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, int past_input_index,
+                                    int past_sequence_length_input_index = -1);
 void EmbedLayerNormalizationShapeInference(::ONNX_NAMESPACE::InferenceContext& ctx);
 }
 }  // namespace onnxruntime
\ No newline at end of file
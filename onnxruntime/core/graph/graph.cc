@@ -12,6 +12,7 @@
 
 #include "core/common/common.h"
 #include "core/common/gsl.h"
+#include "core/common/hash_combine.h"
 #include "core/common/inlined_containers.h"
 #include "core/common/logging/logging.h"
 #include "core/common/narrow.h"
@@ -891,6 +892,7 @@ void Node::CreateSubgraph(const std::string& attr_name) {
 
 void Node::AddAttributeProto(AttributeProto value) {
   utils::SetNodeAttribute(std::move(value), attributes_);
+  inference_signature_ = 0;
   if (graph_) {
     graph_->SetGraphResolveNeeded();
     graph_->SetGraphProtoSyncNeeded();
@@ -939,6 +941,7 @@ void Node::AddAttribute(std::string attr_name, GraphProto value) {
 
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
 bool Node::ClearAttribute(const std::string& attr_name) {
+  inference_signature_ = 0;
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
   return attributes_.erase(attr_name) > 0;
@@ -2447,6 +2450,71 @@ common::Status Graph::TypeCheckInputsAndInitializers() {
   return Status::OK();
 }
 
+// Constant inputs up to this size are hashed by value as shape inference may read them, e.g. the shape input of
+// Reshape. Larger ones are hashed by identity and shape.
+static constexpr size_t kMaxHashedInitializerSize = 1024;
+
+static void HashTypeProto(const TypeProto* type, size_t& seed) {
+  if (type == nullptr) {
+    HashCombine(0, seed);
+  } else if (utils::HasTensorType(*type)) {
+    const auto& tensor_type = type->tensor_type();
+    HashCombine(1, seed);
+    HashCombine(tensor_type.elem_type(), seed);
+    HashCombine(tensor_type.has_shape(), seed);
+    for (const auto& dim : tensor_type.shape().dim()) {
+      if (utils::HasDimValue(dim)) {
+        HashCombine(1, seed);
+        HashCombine(dim.dim_value(), seed);
+      } else if (utils::HasDimParam(dim)) {
+        HashCombine(2, seed);
+        HashCombine(dim.dim_param(), seed);
+      } else {
+        HashCombine(3, seed);
+      }
+    }
+  } else {
+    HashCombine(2, seed);
+    HashCombine(type->SerializeAsString(), seed);
+  }
+}
+
+// Hash of everything type and shape inference of a node without subgraphs reads, other than its attributes:
+// the operator, the input types and constant input values, and the output types that inference merges into.
+static size_t ComputeInferenceSignature(const Graph& graph, const Node& node) {
+  size_t seed = 0;
+  HashCombine(node.Op(), seed);
+
+  HashCombine(node.InputDefs().size(), seed);
+  for (const auto* input_def : node.InputDefs()) {
+    HashCombine(input_def->Exists(), seed);
+    if (!input_def->Exists()) {
+      continue;
+    }
+
+    HashTypeProto(input_def->TypeAsProto(), seed);
+    const TensorProto* initializer = graph.GetConstantInitializer(input_def->Name(), true);
+    HashCombine(initializer, seed);
+    if (initializer != nullptr) {
+      HashCombine(initializer->data_type(), seed);
+      for (auto dim : initializer->dims()) {
+        HashCombine(dim, seed);
+      }
+      if (initializer->ByteSizeLong() <= kMaxHashedInitializerSize) {
+        HashCombine(initializer->SerializeAsString(), seed);
+      }
+    }
+  }
+
+  HashCombine(node.OutputDefs().size(), seed);
+  for (const auto* output_def : node.OutputDefs()) {
+    HashTypeProto(output_def->TypeAsProto(), seed);
+  }
+
+  // 0 is reserved for nodes that have not been inferred
+  return seed != 0 ? seed : 1;
+}
+
 Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
   CheckerContext ctx;
   ctx.set_ir_version(gsl::narrow_cast<int>(IrVersion()));
@@ -2481,12 +2549,11 @@ Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
   for (auto node_index : nodes_in_topological_order_) {
     // Node verification.
     auto& node = *GetNode(node_index);
-
-    NodeProto node_proto;
-    node.ToProto(node_proto);
     const auto& node_name = node.Name();
 
     if (!node.Op()) {
+      NodeProto node_proto;
+      node.ToProto(node_proto);
       {
         auto status = Status::OK();
         ORT_TRY {
@@ -2559,11 +2626,21 @@ Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
       }
     }
 
-    NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op, options)));
+    // Inference of a node is skipped when nothing it reads has changed since it last ran, which is the case for
+    // most nodes when resolving after a graph transformer. Subgraphs also read outer scope values so are always run.
+    const bool can_skip_inference = !options.override_types && !node.ContainsSubgraph();
+    const size_t inference_signature = can_skip_inference ? ComputeInferenceSignature(*this, node) : 0;
+    if (!can_skip_inference || inference_signature != node.inference_signature_) {
+      node.inference_signature_ = 0;
+      NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op, options)));
+      if (can_skip_inference) {
+        node.inference_signature_ = ComputeInferenceSignature(*this, node);
+      }
+    }
 
     // Accumulate output names of the iterated Node
-    for (auto& output_name : node_proto.output()) {
-      lsc.output_names.insert(output_name);
+    for (const auto* output_def : node.OutputDefs()) {
+      lsc.output_names.insert(output_def->Name());
     }
   }
 
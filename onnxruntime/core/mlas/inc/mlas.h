@@ -221,6 +221,108 @@ MlasGemmBatch(
     MLAS_THREADPOOL* ThreadPool
     );
 
+/**
+ * @brief Supply the thread partition of a single precision GEMM. Each
+ *        multiplication of a batch is split into ThreadCountM segments of
+ *        rows times ThreadCountN segments of columns, one per thread.
+ */
+struct MLAS_SGEMM_THREAD_PARTITION {
+    ptrdiff_t ThreadCountM = 1; /**< Supplies the number of segments along the M dimension */
+    ptrdiff_t ThreadCountN = 1; /**< Supplies the number of segments along the N dimension */
+};
+
+/**
+ * @brief  Batched single precision matrix/matrix multiply operation (SGEMM)
+ *         with an explicit thread partition. The results do not depend on
+ *         the partition, so this is used to time candidate partitions.
+ *
+ * @param TransA     Supplies the transpose operation for matrix A.
+ * @param TransB     Supplies the transpose operation for matrix B.
+ * @param M          Supplies the number of rows of matrix A and matrix C.
+ * @param N          Supplies the number of columns of matrix B and matrix C.
+ * @param K          Supplies the number of columns of matrix A and the number
+                     of rows of matrix B.
+ * @param Data       A array of matrices data parameters
+ * @param BatchSize  Supplies number of multiplications in this batch
+ * @param Partition  Supplies the thread partition of each multiplication.
+ * @param ThreadPool Supplies the thread pool object to use, else nullptr if the
+                     base library threading support should be used.
+ */
+void
+MLASCALL
+MlasGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    const MLAS_SGEMM_THREAD_PARTITION& Partition,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+/**
+ * @brief  Get the thread partition that MlasGemmBatch uses for a shape when
+ *         the threaded path is taken.
+ *
+ * @param TransA     Supplies the transpose operation for matrix A.
+ * @param TransB     Supplies the transpose operation for matrix B.
+ * @param M, N, K    Supplies the shape of the multiplication.
+ * @param BatchSize  Supplies number of multiplications in the batch.
+ * @param Partition  Receives the recorded partition, else the default one.
+ * @param ThreadPool Supplies the thread pool object that will be used.
+ * @return true if a partition was recorded for the shape and the number of
+ *         threads of the thread pool, else false.
+ */
+bool
+MLASCALL
+MlasGemmGetThreadPartition(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    size_t BatchSize,
+    MLAS_SGEMM_THREAD_PARTITION* Partition,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+/**
+ * @brief  Record the thread partition that MlasGemmBatch uses for every later
+ *         call with a shape and the number of threads of a thread pool,
+ *         instead of the default partition.
+ *
+ * @param TransA     Supplies the transpose operation for matrix A.
+ * @param TransB     Supplies the transpose operation for matrix B.
+ * @param M, N, K    Supplies the shape of the multiplication.
+ * @param BatchSize  Supplies number of multiplications in the batch.
+ * @param Partition  Supplies the partition to record.
+ * @param ThreadPool Supplies the thread pool object that will be used.
+ */
+void
+MLASCALL
+MlasGemmSetThreadPartition(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    size_t BatchSize,
+    const MLAS_SGEMM_THREAD_PARTITION& Partition,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+/**
+ * @brief  Remove every thread partition recorded with
+ *         MlasGemmSetThreadPartition.
+ */
+void
+MLASCALL
+MlasGemmClearThreadPartitions(
+    void
+    );
+
 /**
  * @brief  Single precision matrix/matrix multiply operation (SGEMM)
  *
@@ -676,6 +778,23 @@ MlasGemmPackB(
     void* PackedB
     );
 
+/**
+ * @brief Returns whether a single precision matrix B should be packed ahead
+ *        of time with MlasGemmPackB. A small matrix B is faster left unpacked,
+ *        so that the small matrix kernels read it in place.
+ * @param TransB  Supplies the transpose operation for matrix B.
+ * @param N       Supplies the number of columns of matrix B.
+ * @param K       Supplies the number of rows of matrix B.
+ * @return true if matrix B should be packed
+ */
+bool
+MLASCALL
+MlasGemmShouldPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K
+    );
+
 size_t
 MLASCALL
 MlasGemmPackBSize(
@@ -734,6 +853,8 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmWinograd,
+    MlasConvAlgorithmDirect,
 #if defined(MLAS_TARGET_WASM_SCALAR)
     MlasConvAlgorithmDepthwise,
 #endif
@@ -766,6 +887,12 @@ struct MLAS_CONV_PARAMETERS {
         struct {
             size_t ThreadStrideN;
         } ExpandThenGemmSegmented;
+        struct {
+            size_t TileCountHeight;
+            size_t TileCountWidth;
+            size_t TileBlockSize;
+            size_t WorkingBufferSizePerThread;
+        } Winograd;
     } u;
 };
 
@@ -1004,6 +1131,143 @@ MlasComputeTanh(
     size_t N
     );
 
+/**
+ * @brief Computes the layer normalization of each row of Input, optionally
+ *        after adding a skip and a bias row.
+ *
+ *        Output = (X - mean(X)) / sqrt(var(X) + Epsilon) * Scale + Shift
+ *        where X = Input + Skip + Bias. When Simplified is true, the mean is
+ *        not subtracted and the variance is the mean of the squares (RMS
+ *        normalization).
+ *
+ *        When Skip or Bias is supplied, X is written to Output before the
+ *        normalization, so Output may alias Input but not Skip.
+ *
+ * @param Input      Input buffer of N rows of D elements
+ * @param Skip       Optional skip buffer of N rows of D elements, or nullptr
+ * @param Bias       Optional bias row of D elements, or nullptr
+ * @param Scale      Scale row of D elements
+ * @param Shift      Optional shift row of D elements, or nullptr
+ * @param Output     Output buffer of N rows of D elements
+ * @param Mean       Optionally receives the N row means, or nullptr
+ * @param InvStdDev  Optionally receives the N row inverse standard deviations,
+ *                   or nullptr
+ * @param N          Number of rows
+ * @param D          Number of elements per row
+ * @param Epsilon    Value added to the variance
+ * @param Simplified true to normalize by the root mean square
+ * @param ThreadPool Thread pool, or nullptr to use the base library threading
+ */
+void
+MLASCALL
+MlasLayerNorm(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Scale,
+    const float* Shift,
+    float* Output,
+    float* Mean,
+    float* InvStdDev,
+    size_t N,
+    size_t D,
+    float Epsilon,
+    bool Simplified,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Tiled scaled dot product attention routines.
+//
+
+struct MLAS_FLASH_ATTENTION_PARAMETERS {
+    size_t BatchCount;
+    size_t HeadCount;
+    size_t SequenceLength;
+    size_t TotalSequenceLength;
+    size_t QKHeadSize;
+    size_t VHeadSize;
+    float Scale;
+    bool Causal;
+    float CausalMaskValue;
+    size_t BlockSizeQ;
+    size_t BlockSizeKV;
+    size_t WorkingBufferSizePerThread;
+    ptrdiff_t ThreadCount;
+};
+
+/**
+ * @brief Prepares the parameters of a tiled attention operation and returns
+ *        the size of the working buffer that the caller must supply.
+ *
+ * @param Parameters          Receives the parameters of the operation
+ * @param BatchCount          Batch size (B)
+ * @param HeadCount           Number of heads (N)
+ * @param SequenceLength      Number of query rows per head (S)
+ * @param TotalSequenceLength Number of key and value rows per head (T),
+ *                            which is at least S
+ * @param QKHeadSize          Head size of the query and key (H)
+ * @param VHeadSize           Head size of the value (H_v)
+ * @param Scale               Scale applied to the query/key products
+ * @param Causal              true if query row s only attends to the key rows
+ *                            up to s + T - S
+ * @param CausalMaskValue     Score that replaces the query/key product of a
+ *                            key row hidden by the causal mask
+ * @param WorkingBufferSize   Receives the number of floats of the working
+ *                            buffer
+ * @param ThreadPool          Thread pool, or nullptr to use the base library
+ *                            threading
+ */
+void
+MLASCALL
+MlasFlashAttentionPrepare(
+    MLAS_FLASH_ATTENTION_PARAMETERS* Parameters,
+    size_t BatchCount,
+    size_t HeadCount,
+    size_t SequenceLength,
+    size_t TotalSequenceLength,
+    size_t QKHeadSize,
+    size_t VHeadSize,
+    float Scale,
+    bool Causal,
+    float CausalMaskValue,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+/**
+ * @brief Computes Output = Softmax(Scale * Query x Key' + KeyBias) x Value
+ *        for each batch and head without materializing the S x T matrix of
+ *        attention probabilities. Blocks of key and value rows are streamed
+ *        through an online softmax, so the memory is linear in the sequence
+ *        lengths.
+ *
+ * @param Parameters    Parameters from MlasFlashAttentionPrepare
+ * @param Query         Query buffer of shape B x N x S x H
+ * @param Key           Key buffer of shape B x N x T x H
+ * @param Value         Value buffer of shape B x N x T x H_v
+ * @param KeyBias       Optional buffer of shape B x T that is added to the
+ *                      scores of every query row, or nullptr. This is also
+ *                      added to the causal mask value.
+ * @param WorkingBuffer Working buffer of the size from
+ *                      MlasFlashAttentionPrepare
+ * @param Output        Output buffer of shape B x S x N x H_v
+ * @param ThreadPool    Thread pool, or nullptr to use the base library
+ *                      threading
+ */
+void
+MLASCALL
+MlasFlashAttention(
+    const MLAS_FLASH_ATTENTION_PARAMETERS* Parameters,
+    const float* Query,
+    const float* Key,
+    const float* Value,
+    const float* KeyBias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Half-precision floating-point routines.
 //
@@ -1017,6 +1281,331 @@ MlasConvertHalfToFloatBuffer(
     size_t Count
     );
 
+/**
+ * @brief Bit pattern of an IEEE 754 half precision floating point value
+ */
+typedef uint16_t MLAS_FP16;
+
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    MLAS_FP16* Destination,
+    size_t Count
+    );
+
+/**
+ * @brief Supply matrices data information to half precision gemm functions
+ */
+struct MLAS_HALF_GEMM_DATA_PARAMS {
+    const MLAS_FP16* A = nullptr; /**< Supplies the address of matrix A */
+    size_t lda = 0;               /**< Supplies the first dimension of matrix A. */
+    const void* B = nullptr;      /**< Supplies the address of matrix B, or the
+                                       buffer from MlasHalfGemmPackB */
+    size_t ldb = 0;               /**< Supplies the first dimension of matrix B. */
+    MLAS_FP16* C = nullptr;       /**< Supplies the address of matrix C */
+    size_t ldc = 0;               /**< Supplies the first dimension of matrix C. */
+    float alpha = 1.0f;           /**< Supplies the scalar alpha multiplier */
+    float beta = 0.0f;            /**< Supplies the scalar beta multiplier */
+    bool BIsPacked = false;       /**< Whether B is pre-packed */
+};
+
+/**
+ * @brief  Batched half precision matrix/matrix multiply operation (HALFGEMM)
+ *         C := alpha * op(A) * op(B) + beta * C
+ *
+ *         The matrices are stored in half precision. The products are
+ *         accumulated in single precision, or using native half precision
+ *         arithmetic on platforms that support it, see
+ *         MlasFp16AccelerationSupported.
+ *
+ * @param TransA     Supplies the transpose operation for matrix A.
+ * @param TransB     Supplies the transpose operation for matrix B. Ignored if
+                     B is pre-packed.
+ * @param M          Supplies the number of rows of matrix A and matrix C.
+ * @param N          Supplies the number of columns of matrix B and matrix C.
+ * @param K          Supplies the number of columns of matrix A and the number
+                     of rows of matrix B.
+ * @param Data       A array of matrices data parameters
+ * @param BatchSize  Supplies number of multiplications in this batch
+ * @param ThreadPool Supplies the thread pool object to use, else nullptr if the
+                     base library threading support should be used.
+ */
+void
+MLASCALL
+MlasHalfGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_HALF_GEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+/**
+ * @brief  For half precision gemm, returns size of the packing buffer
+ *         needed for right hand side
+ * @param N     Number of columns
+ * @param K     Number of rows
+ * @return size of the packing buffer in bytes
+ */
+size_t
+MLASCALL
+MlasHalfGemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+/**
+ * @brief For half precision gemm, pack the right hand side matrix B.
+ *        The packed buffer stays in half precision.
+ *
+ * @param TransB    Supplies the transpose operation for matrix B.
+ * @param N         Number of columns
+ * @param K         Number of rows
+ * @param B         Address of matrix B
+ * @param ldb       Leading dimension of matrix B
+ * @param PackedB   Address of the packed matrix
+ */
+void
+MLASCALL
+MlasHalfGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const MLAS_FP16* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+/**
+ * @brief Whether the current CPU multiplies half precision values natively,
+ *        without widening them to single precision first.
+ */
+bool
+MLASCALL
+MlasFp16AccelerationSupported(
+    void
+    );
+
+//
+// Single precision matrix/matrix multiply with bfloat16 weights (SBGEMM).
+//
+
+/**
+ * @brief Parameters that define one SBGEMM operation. Matrix B is always the
+ *        buffer produced by MlasSBGemmPackB.
+ */
+struct MLAS_SBGEMM_DATA_PARAMS {
+    const float* A = nullptr;     /**< Supplies the address of matrix A */
+    size_t lda = 0;               /**< Supplies the first dimension of matrix A. */
+    const void* B = nullptr;      /**< Supplies the buffer from MlasSBGemmPackB */
+    float* C = nullptr;           /**< Supplies the address of matrix C */
+    size_t ldc = 0;               /**< Supplies the first dimension of matrix C. */
+    float alpha = 1.0f;           /**< Supplies the scalar alpha multiplier */
+    float beta = 0.0f;            /**< Supplies the scalar beta multiplier */
+};
+
+/**
+ * @brief  Batched single precision matrix/matrix multiply operation with
+ *         matrix B stored in bfloat16 (SBGEMM)
+ *         C := alpha * op(A) * B + beta * C
+ *
+ *         The elements of matrix B are widened to single precision in the
+ *         kernel and the products are accumulated in single precision, the
+ *         only loss of accuracy compared to MlasGemm comes from rounding B to
+ *         bfloat16 when it is packed.
+ *
+ * @param TransA     Supplies the transpose operation for matrix A.
+ * @param M          Supplies the number of rows of matrix A and matrix C.
+ * @param N          Supplies the number of columns of matrix B and matrix C.
+ * @param K          Supplies the number of columns of matrix A and the number
+                     of rows of matrix B.
+ * @param Data       A array of matrices data parameters
+ * @param BatchSize  Supplies number of multiplications in this batch
+ * @param ThreadPool Supplies the thread pool object to use, else nullptr if the
+                     base library threading support should be used.
+ */
+void
+MLASCALL
+MlasSBGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SBGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+/**
+ * @brief  For SBGEMM, returns size of the packing buffer needed for right
+ *         hand side
+ * @param N     Number of columns
+ * @param K     Number of rows
+ * @return size of the packing buffer in bytes
+ */
+size_t
+MLASCALL
+MlasSBGemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+/**
+ * @brief For SBGEMM, round the single precision right hand side matrix B
+ *        to bfloat16 (to nearest even) and pack it.
+ *
+ * @param TransB    Supplies the transpose operation for matrix B.
+ * @param N         Number of columns
+ * @param K         Number of rows
+ * @param B         Address of matrix B
+ * @param ldb       Leading dimension of matrix B
+ * @param PackedB   Address of the packed matrix
+ */
+void
+MLASCALL
+MlasSBGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+//
+// Single precision matrix/matrix multiply with block-wise 4-bit weights (Q4GEMM).
+//
+
+/**
+ * @brief Block-wise 4-bit quantization formats of matrix B.
+ *
+ *        Each column of matrix B is split into blocks of consecutive K
+ *        elements that share a scale and a zero point. The packed matrix
+ *        stores the blocks of each column one after the other, column after
+ *        column. A block is stored as a blob:
+ *
+ *            float    scale
+ *            uint8_t  zero point (only for the Zp formats, else 8 is implied)
+ *            uint8_t  data[BlockLength / 2]
+ *
+ *        The data of each group of 32 elements takes 16 bytes: byte j holds
+ *        element j in its low nibble and element j + 16 in its high nibble.
+ *        Element values are scale * (q - zero_point). Rows past K in the last
+ *        block of a column are quantized as zero.
+ */
+typedef enum {
+    BlkQ4Sym32 = 0,     /*!< block length 32, symmetric */
+    BlkQ4Zp32 = 1,      /*!< block length 32, with zero points */
+    BlkQ4Sym128 = 2,    /*!< block length 128, symmetric */
+    BlkQ4Zp128 = 3,     /*!< block length 128, with zero points */
+} MLAS_BLK_QUANT_TYPE;
+
+/**
+ * @brief Parameters that define one Q4GEMM operation. Matrix B is the buffer
+ *        produced by MlasQ4GemmPackB.
+ */
+struct MLAS_Q4GEMM_DATA_PARAMS {
+    const float* A = nullptr;     /**< Supplies the address of matrix A */
+    size_t lda = 0;               /**< Supplies the first dimension of matrix A. */
+    const void* B = nullptr;      /**< Supplies the buffer from MlasQ4GemmPackB */
+    const float* Bias = nullptr;  /**< Supplies the optional bias vector of N elements */
+    float* C = nullptr;           /**< Supplies the address of matrix C */
+    size_t ldc = 0;               /**< Supplies the first dimension of matrix C. */
+};
+
+/**
+ * @brief  Batched single precision matrix/matrix multiply operation with
+ *         block-wise 4-bit matrix B (Q4GEMM)
+ *         C := A * B + Bias
+ *
+ *         Matrix B is dequantized in the kernel, close to the multiplications,
+ *         so that only the 4-bit data is read from memory.
+ *
+ * @param QType      Supplies the quantization format of matrix B.
+ * @param M          Supplies the number of rows of matrix A and matrix C.
+ * @param N          Supplies the number of columns of matrix B and matrix C.
+ * @param K          Supplies the number of columns of matrix A and the number
+                     of rows of matrix B.
+ * @param Data       A array of matrices data parameters
+ * @param BatchSize  Supplies number of multiplications in this batch
+ * @param ThreadPool Supplies the thread pool object to use, else nullptr if the
+                     base library threading support should be used.
+ */
+void
+MLASCALL
+MlasQ4GemmBatch(
+    MLAS_BLK_QUANT_TYPE QType,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_Q4GEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+/**
+ * @brief  For Q4GEMM, returns size of the packing buffer needed for right
+ *         hand side
+ * @param QType Quantization format
+ * @param N     Number of columns
+ * @param K     Number of rows
+ * @return size of the packing buffer in bytes, 0 if the format is unknown
+ */
+size_t
+MLASCALL
+MlasQ4GemmPackBSize(
+    MLAS_BLK_QUANT_TYPE QType,
+    size_t N,
+    size_t K
+    );
+
+/**
+ * @brief For Q4GEMM, quantize the single precision right hand side matrix B
+ *        to 4 bits per element and pack it.
+ *
+ * @param QType     Quantization format
+ * @param PackedB   Address of the packed matrix
+ * @param B         Address of matrix B, stored in row major order
+ * @param N         Number of columns
+ * @param K         Number of rows
+ * @param ldb       Leading dimension of matrix B
+ */
+void
+MLASCALL
+MlasQ4GemmPackB(
+    MLAS_BLK_QUANT_TYPE QType,
+    void* PackedB,
+    const float* B,
+    size_t N,
+    size_t K,
+    size_t ldb
+    );
+
+/**
+ * @brief For Q4GEMM, dequantize a packed matrix B back to single precision.
+ *
+ * @param QType     Quantization format
+ * @param B         Address of matrix B, stored in row major order
+ * @param PackedB   Address of the packed matrix
+ * @param N         Number of columns
+ * @param K         Number of rows
+ * @param ldb       Leading dimension of matrix B
+ */
+void
+MLASCALL
+MlasQ4GemmUnPackB(
+    MLAS_BLK_QUANT_TYPE QType,
+    float* B,
+    const void* PackedB,
+    size_t N,
+    size_t K,
+    size_t ldb
+    );
+
 //
 // Transpose routines.
 //
@@ -606,6 +606,292 @@ Return Value:
     }
 }
 
+void
+MlasConvDirectOutputRow(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t oy
+    )
+/*++
+
+Routine Description:
+
+    This routine accumulates one row of the output of a filter by reading the
+    input rows directly, without expanding the input to convolution patches.
+
+    The output columns for which every kernel column reads inside the input
+    rows are computed eight at a time when the stride is one, with the partial
+    sums of every kernel row kept in registers. The remaining columns check
+    the bounds of each input column.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor of a batch and group.
+
+    Filter - Supplies the filter of one output channel.
+
+    Output - Supplies the output row to accumulate into.
+
+    oy - Supplies the index of the output row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t HeightShapeIndex = 0;
+    constexpr size_t WidthShapeIndex = 1;
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t InputHeight = Parameters->InputShape[HeightShapeIndex];
+    const size_t InputWidth = Parameters->InputShape[WidthShapeIndex];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputWidth = Parameters->OutputShape[WidthShapeIndex];
+    const size_t KernelHeight = Parameters->KernelShape[HeightShapeIndex];
+    const size_t KernelWidth = Parameters->KernelShape[WidthShapeIndex];
+    const size_t DilationHeight = Parameters->DilationShape[HeightShapeIndex];
+    const size_t DilationWidth = Parameters->DilationShape[WidthShapeIndex];
+    const size_t PaddingTop = Parameters->Padding[HeightShapeIndex];
+    const size_t PaddingLeft = Parameters->Padding[WidthShapeIndex];
+    const size_t StrideHeight = Parameters->StrideShape[HeightShapeIndex];
+    const size_t StrideWidth = Parameters->StrideShape[WidthShapeIndex];
+
+    //
+    // Compute the range of output columns where the kernel does not extend
+    // past either edge of the input row.
+    //
+
+    const size_t KernelExtentWidth = (KernelWidth - 1) * DilationWidth;
+
+    size_t InteriorStart = std::min((PaddingLeft + StrideWidth - 1) / StrideWidth, OutputWidth);
+    size_t InteriorEnd = InteriorStart;
+
+    if (InputWidth + PaddingLeft > KernelExtentWidth) {
+        InteriorEnd = std::min((InputWidth + PaddingLeft - KernelExtentWidth - 1) / StrideWidth + 1, OutputWidth);
+        InteriorEnd = std::max(InteriorEnd, InteriorStart);
+    }
+
+    //
+    // Compute the range of kernel rows that read inside the input. The input
+    // row index wraps around for rows in the top padding.
+    //
+
+    const size_t OriginY = oy * StrideHeight - PaddingTop;
+
+    size_t KernelStartY = 0;
+
+    while (KernelStartY < KernelHeight && OriginY + KernelStartY * DilationHeight >= InputHeight) {
+        KernelStartY++;
+    }
+
+    size_t KernelEndY = KernelStartY;
+
+    while (KernelEndY < KernelHeight && OriginY + KernelEndY * DilationHeight < InputHeight) {
+        KernelEndY++;
+    }
+
+    const size_t RowStride = DilationHeight * InputWidth;
+
+    for (size_t c = 0; c < InputChannels; c++) {
+
+        const float* input = Input + c * InputSize + (OriginY + KernelStartY * DilationHeight) * InputWidth;
+        const float* filter = Filter + (c * KernelHeight + KernelStartY) * KernelWidth;
+
+        //
+        // Accumulate the output columns along the edges of the input rows.
+        //
+
+        for (size_t ox = 0; ox < OutputWidth; ox++) {
+
+            if (ox == InteriorStart) {
+                ox = InteriorEnd;
+                if (ox == OutputWidth) {
+                    break;
+                }
+            }
+
+            float Accumulator = Output[ox];
+
+            for (size_t ky = KernelStartY; ky < KernelEndY; ky++) {
+
+                const float* in = input + (ky - KernelStartY) * RowStride;
+                const float* f = filter + (ky - KernelStartY) * KernelWidth;
+
+                for (size_t kx = 0; kx < KernelWidth; kx++) {
+
+                    const size_t ix = ox * StrideWidth + kx * DilationWidth - PaddingLeft;
+
+                    if (ix < InputWidth) {
+                        Accumulator += f[kx] * in[ix];
+                    }
+                }
+            }
+
+            Output[ox] = Accumulator;
+        }
+
+        //
+        // Accumulate the interior output columns.
+        //
+
+        const float* interior = input + InteriorStart * StrideWidth - PaddingLeft;
+        size_t ox = InteriorStart;
+
+        if (StrideWidth == 1) {
+
+            for (; ox + 8 <= InteriorEnd; ox += 8) {
+
+                MLAS_FLOAT32X4 Accumulator0 = MlasLoadFloat32x4(Output + ox);
+                MLAS_FLOAT32X4 Accumulator1 = MlasLoadFloat32x4(Output + ox + 4);
+
+                for (size_t ky = KernelStartY; ky < KernelEndY; ky++) {
+
+                    const float* in = interior + (ky - KernelStartY) * RowStride + (ox - InteriorStart);
+                    const float* f = filter + (ky - KernelStartY) * KernelWidth;
+
+                    for (size_t kx = 0; kx < KernelWidth; kx++) {
+                        MLAS_FLOAT32X4 FilterElement = MlasBroadcastFloat32x4(f + kx);
+                        Accumulator0 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(in + kx * DilationWidth),
+                            FilterElement, Accumulator0);
+                        Accumulator1 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(in + kx * DilationWidth + 4),
+                            FilterElement, Accumulator1);
+                    }
+                }
+
+                MlasStoreFloat32x4(Output + ox, Accumulator0);
+                MlasStoreFloat32x4(Output + ox + 4, Accumulator1);
+            }
+
+            for (; ox + 4 <= InteriorEnd; ox += 4) {
+
+                MLAS_FLOAT32X4 Accumulator = MlasLoadFloat32x4(Output + ox);
+
+                for (size_t ky = KernelStartY; ky < KernelEndY; ky++) {
+
+                    const float* in = interior + (ky - KernelStartY) * RowStride + (ox - InteriorStart);
+                    const float* f = filter + (ky - KernelStartY) * KernelWidth;
+
+                    for (size_t kx = 0; kx < KernelWidth; kx++) {
+                        Accumulator = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(in + kx * DilationWidth),
+                            MlasBroadcastFloat32x4(f + kx), Accumulator);
+                    }
+                }
+
+                MlasStoreFloat32x4(Output + ox, Accumulator);
+            }
+        }
+
+        for (; ox < InteriorEnd; ox++) {
+
+            float Accumulator = Output[ox];
+
+            for (size_t ky = KernelStartY; ky < KernelEndY; ky++) {
+
+                const float* in = interior + (ky - KernelStartY) * RowStride + (ox - InteriorStart) * StrideWidth;
+                const float* f = filter + (ky - KernelStartY) * KernelWidth;
+
+                for (size_t kx = 0; kx < KernelWidth; kx++) {
+                    Accumulator += f[kx] * in[kx * DilationWidth];
+                }
+            }
+
+            Output[ox] = Accumulator;
+        }
+    }
+}
+
+void
+MlasConvDirect(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the convolution operation by accumulating the
+    output rows directly from the input rows. This avoids expanding the input
+    for convolutions with few filters, where the GEMM is dominated by the
+    cost of the expansion.
+
+    The output rows of every batch, group and filter are partitioned across
+    the threads.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+    const size_t InputGroupSize = Parameters->InputChannels * Parameters->InputSize;
+    const size_t RowCount = Parameters->BatchCount * GroupCount * FilterCount * OutputHeight;
+    const ptrdiff_t ThreadCount = Parameters->ThreadCount;
+    const float Beta = Parameters->Beta;
+
+    MlasTrySimpleParallel(ThreadPool, ThreadCount, [&](ptrdiff_t tid) {
+
+        size_t RowIndex;
+        size_t RowRemaining;
+
+        MlasPartitionWork(tid, ThreadCount, RowCount, &RowIndex, &RowRemaining);
+
+        for (size_t row = RowIndex; row < RowIndex + RowRemaining; row++) {
+
+            const size_t oy = row % OutputHeight;
+            const size_t bgf = row / OutputHeight;
+            const size_t bg = bgf / FilterCount;
+            const size_t gf = bgf % (GroupCount * FilterCount);
+
+            float* output = Output + bgf * OutputSize + oy * OutputWidth;
+
+            if (Beta == 0.0f) {
+                std::fill_n(output, OutputWidth, 0.0f);
+            } else if (Beta != 1.0f) {
+                for (size_t ox = 0; ox < OutputWidth; ox++) {
+                    output[ox] *= Beta;
+                }
+            }
+
+            MlasConvDirectOutputRow(Parameters, Input + bg * InputGroupSize, Filter + gf * K, output, oy);
+
+            MlasActivation(Parameters->Activation, output, (Bias != nullptr) ? Bias + gf : nullptr, 1,
+                OutputWidth, OutputWidth);
+        }
+    });
+}
+
 void
 MlasConvOperationThreaded(
     void* Context,
@@ -902,6 +1188,21 @@ Return Value:
         return;
     }
 
+    //
+    // Schedule the Winograd and direct algorithms across every batch and
+    // group at once.
+    //
+
+    if (Algorithm == MlasConvAlgorithmWinograd) {
+        MlasConvWinograd(Parameters, Input, Filter, Bias, WorkingBuffer, Output, ThreadPool);
+        return;
+    }
+
+    if (Algorithm == MlasConvAlgorithmDirect) {
+        MlasConvDirect(Parameters, Input, Filter, Bias, Output, ThreadPool);
+        return;
+    }
+
 #if defined(MLAS_TARGET_WASM_SCALAR)
 
     if (Algorithm == MlasConvAlgorithmDepthwise) {
@@ -1001,6 +1302,16 @@ Return Value:
 
                     break;
                 }
+
+                case MlasConvAlgorithmWinograd:
+                case MlasConvAlgorithmDirect:
+                {
+                    //
+                    // These algorithms process every batch and group above.
+                    //
+
+                    break;
+                }
             }
 
             //
@@ -1210,6 +1521,52 @@ Return Value:
         }
     }
 
+#if !defined(MLAS_TARGET_WASM_SCALAR)
+
+    if (Dimensions == 2) {
+
+        //
+        // Detect depthwise convolutions with unit width stride, which are
+        // computed directly from the input rows without expanding the input.
+        //
+
+        if (InputChannels == 1 && FilterCount == 1 && Parameters->StrideShape[1] == 1) {
+
+            size_t RowCount = BatchCount * GroupCount * Parameters->OutputShape[0];
+            double Complexity = double(OutputSize) * double(K) * double(BatchCount * GroupCount);
+
+            ptrdiff_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+            if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY) * double(TargetThreadCount)) {
+                TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+            }
+
+            if (size_t(TargetThreadCount) > RowCount) {
+                TargetThreadCount = ptrdiff_t(RowCount);
+            }
+
+            Parameters->ThreadCount = TargetThreadCount;
+            Parameters->Algorithm = MlasConvAlgorithmDirect;
+
+            return;
+        }
+
+        //
+        // Detect 3x3 convolutions with unit stride and dilation where the
+        // Winograd algorithm is estimated to be faster than the expanded GEMM.
+        //
+
+        if (Parameters->KernelShape[0] == 3 && Parameters->KernelShape[1] == 3 &&
+            AllStridesAreOne && AllDilationsAreOne) {
+
+            if (MlasConvWinogradPrepare(Parameters, WorkingBufferSize, ThreadPool)) {
+                return;
+            }
+        }
+    }
+
+#endif
+
     if (FilterCount > OutputSize) {
 
         //
@@ -0,0 +1,906 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    convwinograd.cpp
+
+Abstract:
+
+    This module implements the Winograd F(4x4, 3x3) algorithm for two
+    dimensional convolutions with a 3x3 kernel, unit stride and unit
+    dilation.
+
+    The filter is transformed to 36 matrices of FilterCount rows and
+    InputChannels columns. Each thread transforms a block of 6x6 input tiles
+    to 36 matrices of InputChannels rows and one column per tile, multiplies
+    the matching matrices with 36 GEMMs, and transforms the products back to
+    4x4 output tiles. The GEMMs perform 36 multiplies for 16 outputs instead
+    of the 144 multiplies of the expanded convolution.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of elements of a transformed tile, the number of outputs
+// of a tile along each dimension, and the number of input elements of a tile
+// along each dimension.
+//
+
+#define MLAS_WINOGRAD_TRANSFORM_SIZE                36
+#define MLAS_WINOGRAD_OUTPUT_TILE                   4
+#define MLAS_WINOGRAD_INPUT_TILE                    6
+
+//
+// Define the target number of elements of the transformed inputs and products
+// of a block of tiles, and the maximum number of tiles of a block.
+//
+
+#define MLAS_CONV_WINOGRAD_BLOCK_ELEMENTS           (256 * 1024)
+#define MLAS_CONV_WINOGRAD_MAXIMUM_BLOCK_SIZE       64
+
+//
+// Define the minimum number of input channels and filters for the Winograd
+// algorithm to be considered.
+//
+
+#define MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS         8
+
+//
+// Define the estimated costs, in SGEMM multiply-adds, of expanding one input
+// element for the GEMM convolution, of transforming the filter for one
+// filter and input channel pair, and of transforming one input tile of one
+// channel and one output tile of one filter.
+//
+
+#define MLAS_CONV_WINOGRAD_EXPAND_COST              20.0
+#define MLAS_CONV_WINOGRAD_FILTER_TRANSFORM_COST    1500.0
+#define MLAS_CONV_WINOGRAD_INPUT_TRANSFORM_COST     2400.0
+#define MLAS_CONV_WINOGRAD_OUTPUT_TRANSFORM_COST    1400.0
+
+//
+// Returns the distance between the 36 matrices of a transform. The matrices
+// are padded by a cache line so that the elements of one tile that are stored
+// to or loaded from every matrix do not map to the same cache set.
+//
+
+MLAS_FORCEINLINE
+size_t
+MlasWinogradMatrixStride(
+    size_t Rows,
+    size_t Columns
+    )
+{
+    return Rows * Columns + 16;
+}
+
+//
+// Applies the one dimensional filter transform G of F(4, 3) to three elements.
+//
+
+MLAS_FORCEINLINE
+void
+MlasWinogradFilterTransform1D(
+    const MLAS_FLOAT32X4 g[3],
+    MLAS_FLOAT32X4 t[6]
+    )
+{
+    //
+    // t0 = g0 / 4
+    // t1 = -(g0 + g1 + g2) / 6
+    // t2 = -(g0 - g1 + g2) / 6
+    // t3 = g0 / 24 + g1 / 12 + g2 / 6
+    // t4 = g0 / 24 - g1 / 12 + g2 / 6
+    // t5 = g2
+    //
+
+    MLAS_FLOAT32X4 g0_add_g2 = MlasAddFloat32x4(g[0], g[2]);
+    MLAS_FLOAT32X4 g0_g2 = MlasMultiplyAddFloat32x4(g[0], 1.0f / 24.0f,
+                                                    MlasMultiplyFloat32x4(g[2], MlasBroadcastFloat32x4(1.0f / 6.0f)));
+    MLAS_FLOAT32X4 g1 = MlasMultiplyFloat32x4(g[1], MlasBroadcastFloat32x4(1.0f / 12.0f));
+    MLAS_FLOAT32X4 MinusOneSixth = MlasBroadcastFloat32x4(-1.0f / 6.0f);
+
+    t[0] = MlasMultiplyFloat32x4(g[0], MlasBroadcastFloat32x4(0.25f));
+    t[1] = MlasMultiplyFloat32x4(MlasAddFloat32x4(g0_add_g2, g[1]), MinusOneSixth);
+    t[2] = MlasMultiplyFloat32x4(MlasSubtractFloat32x4(g0_add_g2, g[1]), MinusOneSixth);
+    t[3] = MlasAddFloat32x4(g0_g2, g1);
+    t[4] = MlasSubtractFloat32x4(g0_g2, g1);
+    t[5] = g[2];
+}
+
+//
+// Applies the one dimensional input transform B^T of F(4, 3) to six elements.
+//
+
+MLAS_FORCEINLINE
+void
+MlasWinogradInputTransform1D(
+    const MLAS_FLOAT32X4 d[6],
+    MLAS_FLOAT32X4 t[6]
+    )
+{
+    const MLAS_FLOAT32X4 Two = MlasBroadcastFloat32x4(2.0f);
+    const MLAS_FLOAT32X4 Four = MlasBroadcastFloat32x4(4.0f);
+    const MLAS_FLOAT32X4 Five = MlasBroadcastFloat32x4(5.0f);
+
+    //
+    // t0 = 4d0 - 5d2 + d4
+    // t1 = -4(d1 + d2) + d3 + d4
+    // t2 = 4(d1 - d2) - d3 + d4
+    // t3 = -2(d1 - d3) - d2 + d4
+    // t4 = 2(d1 - d3) - d2 + d4
+    // t5 = 4d1 - 5d3 + d5
+    //
+
+    MLAS_FLOAT32X4 d4_d2 = MlasSubtractFloat32x4(d[4], d[2]);
+    MLAS_FLOAT32X4 d1_d3 = MlasSubtractFloat32x4(d[1], d[3]);
+    MLAS_FLOAT32X4 d3_d4 = MlasAddFloat32x4(d[3], d[4]);
+    MLAS_FLOAT32X4 d4_d3 = MlasSubtractFloat32x4(d[4], d[3]);
+
+    t[0] = MlasAddFloat32x4(MlasMultiplyFloat32x4(Four, d[0]),
+                            MlasSubtractFloat32x4(d[4], MlasMultiplyFloat32x4(Five, d[2])));
+    t[1] = MlasSubtractFloat32x4(d3_d4, MlasMultiplyFloat32x4(Four, MlasAddFloat32x4(d[1], d[2])));
+    t[2] = MlasAddFloat32x4(d4_d3, MlasMultiplyFloat32x4(Four, MlasSubtractFloat32x4(d[1], d[2])));
+    t[3] = MlasSubtractFloat32x4(d4_d2, MlasMultiplyFloat32x4(Two, d1_d3));
+    t[4] = MlasAddFloat32x4(d4_d2, MlasMultiplyFloat32x4(Two, d1_d3));
+    t[5] = MlasAddFloat32x4(MlasMultiplyFloat32x4(Four, d[1]),
+                            MlasSubtractFloat32x4(d[5], MlasMultiplyFloat32x4(Five, d[3])));
+}
+
+//
+// Applies the one dimensional output transform A^T of F(4, 3) to six elements.
+//
+
+MLAS_FORCEINLINE
+void
+MlasWinogradOutputTransform1D(
+    const MLAS_FLOAT32X4 m[6],
+    MLAS_FLOAT32X4 o[4]
+    )
+{
+    const MLAS_FLOAT32X4 Two = MlasBroadcastFloat32x4(2.0f);
+    const MLAS_FLOAT32X4 Four = MlasBroadcastFloat32x4(4.0f);
+    const MLAS_FLOAT32X4 Eight = MlasBroadcastFloat32x4(8.0f);
+
+    //
+    // o0 = m0 + (m1 + m2) + (m3 + m4)
+    // o1 = (m1 - m2) + 2(m3 - m4)
+    // o2 = (m1 + m2) + 4(m3 + m4)
+    // o3 = (m1 - m2) + 8(m3 - m4) + m5
+    //
+
+    MLAS_FLOAT32X4 m1_add_m2 = MlasAddFloat32x4(m[1], m[2]);
+    MLAS_FLOAT32X4 m1_sub_m2 = MlasSubtractFloat32x4(m[1], m[2]);
+    MLAS_FLOAT32X4 m3_add_m4 = MlasAddFloat32x4(m[3], m[4]);
+    MLAS_FLOAT32X4 m3_sub_m4 = MlasSubtractFloat32x4(m[3], m[4]);
+
+    o[0] = MlasAddFloat32x4(MlasAddFloat32x4(m[0], m1_add_m2), m3_add_m4);
+    o[1] = MlasMultiplyAddFloat32x4(m3_sub_m4, Two, m1_sub_m2);
+    o[2] = MlasMultiplyAddFloat32x4(m3_add_m4, Four, m1_add_m2);
+    o[3] = MlasAddFloat32x4(MlasMultiplyAddFloat32x4(m3_sub_m4, Eight, m1_sub_m2), m[5]);
+}
+
+void
+MlasConvWinogradTransformFilter(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Filter,
+    float* TransformedFilter,
+    size_t FilterStart,
+    size_t FilterEnd
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms a range of 3x3 filters to the 6x6 Winograd
+    domain, G g G^T, and stores element p of the transform of filter m and
+    input channel c at row m and column c of matrix p.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Filter - Supplies the filter tensor of a group.
+
+    TransformedFilter - Supplies the buffer to receive the transformed filter
+        of the group.
+
+    FilterStart - Supplies the first filter to transform.
+
+    FilterEnd - Supplies the end of the range of filters to transform.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t TransformStride = MlasWinogradMatrixStride(FilterCount, InputChannels);
+
+    //
+    // Transform chunks of input channels to a local buffer, four channels at
+    // a time with one channel per vector lane, and then copy each transformed
+    // element to its matrix. Storing every element of a transform directly
+    // strides through 36 matrices, which thrashes the cache when the matrix
+    // size is a multiple of the page size.
+    //
+
+    constexpr size_t ChannelChunk = 128;
+
+    MLAS_DECLSPEC_ALIGN(float Transformed[MLAS_WINOGRAD_TRANSFORM_SIZE][ChannelChunk], 16);
+
+    for (size_t m = FilterStart; m < FilterEnd; m++) {
+
+        for (size_t c = 0; c < InputChannels; c += ChannelChunk) {
+
+            const size_t CountC = std::min(ChannelChunk, InputChannels - c);
+
+            for (size_t cc = 0; cc < CountC; cc += 4) {
+
+                const size_t CountLanes = std::min<size_t>(4, CountC - cc);
+                const float* g = Filter + (m * InputChannels + c + cc) * 9;
+
+                MLAS_DECLSPEC_ALIGN(float Gathered[9][4], 16);
+
+                for (size_t k = 0; k < 9; k++) {
+                    for (size_t l = 0; l < 4; l++) {
+                        Gathered[k][l] = (l < CountLanes) ? g[l * 9 + k] : 0.0f;
+                    }
+                }
+
+                //
+                // Compute the 6x3 product G g and then the 6x6 product
+                // (G g) G^T.
+                //
+
+                MLAS_FLOAT32X4 Gg[6][3];
+
+                for (size_t j = 0; j < 3; j++) {
+
+                    MLAS_FLOAT32X4 v[3];
+
+                    for (size_t i = 0; i < 3; i++) {
+                        v[i] = MlasLoadFloat32x4(Gathered[i * 3 + j]);
+                    }
+
+                    MLAS_FLOAT32X4 t[6];
+                    MlasWinogradFilterTransform1D(v, t);
+
+                    for (size_t i = 0; i < 6; i++) {
+                        Gg[i][j] = t[i];
+                    }
+                }
+
+                for (size_t i = 0; i < 6; i++) {
+
+                    MLAS_FLOAT32X4 t[6];
+                    MlasWinogradFilterTransform1D(Gg[i], t);
+
+                    for (size_t j = 0; j < 6; j++) {
+                        MlasStoreAlignedFloat32x4(&Transformed[i * 6 + j][cc], t[j]);
+                    }
+                }
+            }
+
+            float* u = TransformedFilter + m * InputChannels + c;
+
+            for (size_t p = 0; p < MLAS_WINOGRAD_TRANSFORM_SIZE; p++) {
+                std::copy_n(Transformed[p], CountC, u + p * TransformStride);
+            }
+        }
+    }
+}
+
+void
+MlasConvWinogradTransformInput(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    float* TransformedInput,
+    size_t TileStart,
+    size_t TileCount
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms a block of 6x6 input tiles to the Winograd domain,
+    B^T d B, and stores element p of the transform of input channel c and
+    tile t of the block at row c and column t of matrix p.
+
+    Groups of four tiles of the same tile row are transformed together, with
+    one tile per vector lane.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor of a batch and group.
+
+    TransformedInput - Supplies the buffer to receive the transformed tiles.
+
+    TileStart - Supplies the index of the first tile of the block.
+
+    TileCount - Supplies the number of tiles of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+    const size_t TileCountWidth = Parameters->u.Winograd.TileCountWidth;
+    const size_t TileBlockSize = Parameters->u.Winograd.TileBlockSize;
+    const size_t TransformStride = MlasWinogradMatrixStride(InputChannels, TileBlockSize);
+
+    for (size_t c = 0; c < InputChannels; c++) {
+
+        const float* input = Input + c * InputSize;
+        size_t t = 0;
+
+        while (t < TileCount) {
+
+            //
+            // Gather up to four tiles of the current tile row.
+            //
+
+            const size_t ty = (TileStart + t) / TileCountWidth;
+            const size_t tx = (TileStart + t) % TileCountWidth;
+            const size_t CountTiles = std::min<size_t>({4, TileCountWidth - tx, TileCount - t});
+
+            //
+            // The input origin of the tiles may be negative because of the
+            // padding, so rely on unsigned wraparound to check both bounds
+            // with a single comparison. The rows of four tiles span 18 input
+            // columns and are read as five vectors.
+            //
+
+            const size_t OriginY = ty * MLAS_WINOGRAD_OUTPUT_TILE - PaddingTop;
+            const size_t OriginX = tx * MLAS_WINOGRAD_OUTPUT_TILE - PaddingLeft;
+            const size_t SpanX = (CountTiles - 1) * MLAS_WINOGRAD_OUTPUT_TILE + MLAS_WINOGRAD_INPUT_TILE;
+
+            const bool InteriorX = (CountTiles == 4) && (OriginX < InputWidth) && (OriginX + 20 <= InputWidth);
+
+            MLAS_FLOAT32X4 Rows[6][6];
+
+            for (size_t r = 0; r < 6; r++) {
+
+                const size_t iy = OriginY + r;
+                const float* row = input + iy * InputWidth + OriginX;
+
+                MLAS_DECLSPEC_ALIGN(float RowBuffer[20], 16);
+
+                if (!InteriorX || iy >= InputHeight) {
+
+                    for (size_t x = 0; x < 20; x++) {
+                        const size_t ix = OriginX + x;
+                        RowBuffer[x] = (x < SpanX && iy < InputHeight && ix < InputWidth)
+                            ? input[iy * InputWidth + ix] : 0.0f;
+                    }
+
+                    row = RowBuffer;
+                }
+
+                //
+                // Transpose the input columns so that each vector holds one
+                // column of the four tiles.
+                //
+
+                MLAS_FLOAT32X4 v0 = MlasLoadFloat32x4(row);
+                MLAS_FLOAT32X4 v1 = MlasLoadFloat32x4(row + 4);
+                MLAS_FLOAT32X4 v2 = MlasLoadFloat32x4(row + 8);
+                MLAS_FLOAT32X4 v3 = MlasLoadFloat32x4(row + 12);
+                MLAS_FLOAT32X4 v4 = MlasLoadFloat32x4(row + 16);
+
+                MLAS_FLOAT32X4 v02Low = MlasInterleaveLowFloat32x4(v0, v2);
+                MLAS_FLOAT32X4 v13Low = MlasInterleaveLowFloat32x4(v1, v3);
+                MLAS_FLOAT32X4 v02High = MlasInterleaveHighFloat32x4(v0, v2);
+                MLAS_FLOAT32X4 v13High = MlasInterleaveHighFloat32x4(v1, v3);
+                MLAS_FLOAT32X4 v24Low = MlasInterleaveLowFloat32x4(v2, v4);
+
+                MLAS_FLOAT32X4 d[6];
+
+                d[0] = MlasInterleaveLowFloat32x4(v02Low, v13Low);
+                d[1] = MlasInterleaveHighFloat32x4(v02Low, v13Low);
+                d[2] = MlasInterleaveLowFloat32x4(v02High, v13High);
+                d[3] = MlasInterleaveHighFloat32x4(v02High, v13High);
+                d[4] = MlasInterleaveLowFloat32x4(v13Low, v24Low);
+                d[5] = MlasInterleaveHighFloat32x4(v13Low, v24Low);
+
+                MlasWinogradInputTransform1D(d, Rows[r]);
+            }
+
+            //
+            // Transform the columns of the tiles.
+            //
+
+            float* output = TransformedInput + c * TileBlockSize + t;
+
+            for (size_t j = 0; j < 6; j++) {
+
+                MLAS_FLOAT32X4 d[6];
+                MLAS_FLOAT32X4 v[6];
+
+                for (size_t r = 0; r < 6; r++) {
+                    d[r] = Rows[r][j];
+                }
+
+                MlasWinogradInputTransform1D(d, v);
+
+                for (size_t i = 0; i < 6; i++) {
+
+                    float* out = output + (i * 6 + j) * TransformStride;
+
+                    if (CountTiles == 4) {
+                        MlasStoreFloat32x4(out, v[i]);
+                    } else {
+                        MLAS_DECLSPEC_ALIGN(float Lanes[4], 16);
+                        MlasStoreAlignedFloat32x4(Lanes, v[i]);
+                        std::copy_n(Lanes, CountTiles, out);
+                    }
+                }
+            }
+
+            t += CountTiles;
+        }
+    }
+}
+
+void
+MlasConvWinogradTransformOutput(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* TransformedOutput,
+    const float* Bias,
+    float* TileBuffer,
+    float* Output,
+    size_t TileStart,
+    size_t TileCount
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms a block of products from the Winograd domain to
+    4x4 output tiles, A^T m A, applies the activation with the optional bias,
+    and stores the tiles to the output tensor.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    TransformedOutput - Supplies the products of the block, where element p
+        of filter m and tile t is at row m and column t of matrix p.
+
+    Bias - Optionally supplies the bias vector of the group.
+
+    TileBuffer - Supplies a buffer of FilterCount * TileBlockSize * 16
+        elements to hold the output tiles.
+
+    Output - Supplies the output tensor of a batch and group.
+
+    TileStart - Supplies the index of the first tile of the block.
+
+    TileCount - Supplies the number of tiles of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t TileCountWidth = Parameters->u.Winograd.TileCountWidth;
+    const size_t TileBlockSize = Parameters->u.Winograd.TileBlockSize;
+    const size_t TransformStride = MlasWinogradMatrixStride(FilterCount, TileBlockSize);
+    const size_t TileBufferStride = TileCount * 16;
+
+    //
+    // Transform groups of four tiles into the tile buffer, with the sixteen
+    // outputs of each tile stored contiguously.
+    //
+
+    for (size_t m = 0; m < FilterCount; m++) {
+
+        const float* input = TransformedOutput + m * TileBlockSize;
+        float* tiles = TileBuffer + m * TileBufferStride;
+
+        for (size_t t = 0; t < TileCount; t += 4) {
+
+            const size_t CountTiles = std::min<size_t>(4, TileCount - t);
+
+            MLAS_FLOAT32X4 Rows[6][4];
+
+            for (size_t i = 0; i < 6; i++) {
+
+                MLAS_FLOAT32X4 v[6];
+
+                for (size_t j = 0; j < 6; j++) {
+
+                    const float* in = input + (i * 6 + j) * TransformStride + t;
+
+                    if (CountTiles == 4) {
+                        v[j] = MlasLoadFloat32x4(in);
+                    } else {
+                        MLAS_DECLSPEC_ALIGN(float Lanes[4], 16) = {0.0f, 0.0f, 0.0f, 0.0f};
+                        std::copy_n(in, CountTiles, Lanes);
+                        v[j] = MlasLoadFloat32x4(Lanes);
+                    }
+                }
+
+                MlasWinogradOutputTransform1D(v, Rows[i]);
+            }
+
+            MLAS_FLOAT32X4 Columns[4][4];
+
+            for (size_t j = 0; j < 4; j++) {
+
+                MLAS_FLOAT32X4 d[6];
+
+                for (size_t i = 0; i < 6; i++) {
+                    d[i] = Rows[i][j];
+                }
+
+                MlasWinogradOutputTransform1D(d, Columns[j]);
+            }
+
+            //
+            // Transpose the output rows so that each vector holds one row of
+            // a tile.
+            //
+
+            for (size_t r = 0; r < 4; r++) {
+
+                MLAS_FLOAT32X4 v02Low = MlasInterleaveLowFloat32x4(Columns[0][r], Columns[2][r]);
+                MLAS_FLOAT32X4 v13Low = MlasInterleaveLowFloat32x4(Columns[1][r], Columns[3][r]);
+                MLAS_FLOAT32X4 v02High = MlasInterleaveHighFloat32x4(Columns[0][r], Columns[2][r]);
+                MLAS_FLOAT32X4 v13High = MlasInterleaveHighFloat32x4(Columns[1][r], Columns[3][r]);
+
+                MLAS_FLOAT32X4 TileRows[4];
+
+                TileRows[0] = MlasInterleaveLowFloat32x4(v02Low, v13Low);
+                TileRows[1] = MlasInterleaveHighFloat32x4(v02Low, v13Low);
+                TileRows[2] = MlasInterleaveLowFloat32x4(v02High, v13High);
+                TileRows[3] = MlasInterleaveHighFloat32x4(v02High, v13High);
+
+                for (size_t k = 0; k < CountTiles; k++) {
+                    MlasStoreFloat32x4(tiles + (t + k) * 16 + r * 4, TileRows[k]);
+                }
+            }
+        }
+    }
+
+    //
+    // Accumulate the existing output for the fused sum, apply the activation
+    // with the optional bias, and then store the output tiles. The outputs of
+    // the tiles that extend past the output tensor are discarded.
+    //
+
+    const float Beta = Parameters->Beta;
+
+    for (size_t m = 0; m < FilterCount; m++) {
+
+        float* tiles = TileBuffer + m * TileBufferStride;
+        float* output = Output + m * OutputSize;
+
+        if (Beta != 0.0f) {
+
+            for (size_t t = 0; t < TileCount; t++) {
+
+                const size_t oy = ((TileStart + t) / TileCountWidth) * MLAS_WINOGRAD_OUTPUT_TILE;
+                const size_t ox = ((TileStart + t) % TileCountWidth) * MLAS_WINOGRAD_OUTPUT_TILE;
+
+                for (size_t r = 0; r < 4 && oy + r < OutputHeight; r++) {
+                    for (size_t j = 0; j < 4 && ox + j < OutputWidth; j++) {
+                        tiles[t * 16 + r * 4 + j] += Beta * output[(oy + r) * OutputWidth + ox + j];
+                    }
+                }
+            }
+        }
+    }
+
+    MlasActivation(Parameters->Activation, TileBuffer, Bias, FilterCount, TileBufferStride,
+        TileBufferStride);
+
+    for (size_t m = 0; m < FilterCount; m++) {
+
+        const float* tiles = TileBuffer + m * TileBufferStride;
+        float* output = Output + m * OutputSize;
+
+        for (size_t t = 0; t < TileCount; t++) {
+
+            const size_t oy = ((TileStart + t) / TileCountWidth) * MLAS_WINOGRAD_OUTPUT_TILE;
+            const size_t ox = ((TileStart + t) % TileCountWidth) * MLAS_WINOGRAD_OUTPUT_TILE;
+            const size_t CountX = std::min<size_t>(4, OutputWidth - ox);
+
+            for (size_t r = 0; r < 4 && oy + r < OutputHeight; r++) {
+                if (CountX == 4) {
+                    MlasStoreFloat32x4(output + (oy + r) * OutputWidth + ox, MlasLoadFloat32x4(tiles + t * 16 + r * 4));
+                } else {
+                    std::copy_n(tiles + t * 16 + r * 4, CountX, output + (oy + r) * OutputWidth + ox);
+                }
+            }
+        }
+    }
+}
+
+bool
+MlasConvWinogradPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine estimates whether a Winograd convolution is faster than the
+    expanded GEMM convolution and, if so, computes the tiling, the number of
+    threads and the size of the working buffer.
+
+    The cost of both algorithms is estimated in units of one multiply-add of
+    the SGEMM kernel. The Winograd algorithm performs a quarter of the
+    multiply-adds but also pays for transforming the filter on every call and
+    for transforming each input and output tile, so it loses to the GEMM for
+    small images with many channels.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    WorkingBufferSize - Receives the number of elements to allocate for the
+        working buffer.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    Returns true if the Winograd algorithm should be used, else false and the
+    parameters are not updated.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t BatchGroupCount = Parameters->BatchCount * Parameters->GroupCount;
+
+    if (InputChannels < MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS ||
+        FilterCount < MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS) {
+        return false;
+    }
+
+    const size_t TileCountHeight =
+        (Parameters->OutputShape[0] + MLAS_WINOGRAD_OUTPUT_TILE - 1) / MLAS_WINOGRAD_OUTPUT_TILE;
+    const size_t TileCountWidth =
+        (Parameters->OutputShape[1] + MLAS_WINOGRAD_OUTPUT_TILE - 1) / MLAS_WINOGRAD_OUTPUT_TILE;
+    const size_t TileCount = TileCountHeight * TileCountWidth;
+
+    //
+    // Size the block of tiles so that the transformed inputs and products of
+    // a block stay in the L2 cache, while keeping enough columns for an
+    // efficient GEMM.
+    //
+
+    size_t TileBlockSize = MLAS_CONV_WINOGRAD_BLOCK_ELEMENTS /
+        (MLAS_WINOGRAD_TRANSFORM_SIZE * (InputChannels + FilterCount));
+
+    TileBlockSize = std::max<size_t>(TileBlockSize & ~size_t(15), 16);
+    TileBlockSize = std::min<size_t>(TileBlockSize, MLAS_CONV_WINOGRAD_MAXIMUM_BLOCK_SIZE);
+
+    if (TileBlockSize > TileCount) {
+        TileBlockSize = (TileCount + 3) & ~size_t(3);
+    }
+
+    const size_t BlockCount = (TileCount + TileBlockSize - 1) / TileBlockSize;
+    const size_t WorkCount = BatchGroupCount * BlockCount;
+
+    const ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+    ptrdiff_t ThreadCount = MaximumThreadCount;
+
+    if (size_t(ThreadCount) > WorkCount) {
+        ThreadCount = ptrdiff_t(WorkCount);
+    }
+
+    //
+    // Estimate the cost of the expanded GEMM convolution, including the
+    // expansion of the input, and the threads that it would use.
+    //
+
+    const double OutputSize = double(Parameters->OutputSize);
+    const double K = double(Parameters->K);
+    const double GemmComplexity = double(FilterCount) * OutputSize * K;
+
+    double GemmCost = BatchGroupCount * (GemmComplexity +
+        MLAS_CONV_WINOGRAD_EXPAND_COST * K * OutputSize);
+    double GemmThreadCount = std::min(double(MaximumThreadCount),
+        GemmComplexity / double(MLAS_SGEMM_THREAD_COMPLEXITY) + 1.0);
+
+    //
+    // Estimate the cost of the Winograd convolution. The tile transforms
+    // process four tiles of a row of tiles at a time, and the GEMMs are less
+    // efficient when the block of tiles is narrow.
+    //
+
+    const double TileLanes = double(TileCountHeight * ((TileCountWidth + 3) & ~size_t(3)));
+    const double WinogradGemmEfficiency = (TileBlockSize < 32) ? 1.5 : 1.0;
+
+    double WinogradCost =
+        BatchGroupCount * (WinogradGemmEfficiency * MLAS_WINOGRAD_TRANSFORM_SIZE *
+            double(FilterCount) * double(InputChannels) * double(TileCount) +
+        MLAS_CONV_WINOGRAD_INPUT_TRANSFORM_COST * double(InputChannels) * TileLanes +
+        MLAS_CONV_WINOGRAD_OUTPUT_TRANSFORM_COST * double(FilterCount) * TileLanes) +
+        Parameters->GroupCount * MLAS_CONV_WINOGRAD_FILTER_TRANSFORM_COST *
+            double(FilterCount) * double(InputChannels);
+
+    //
+    // Require a margin over the expanded GEMM because the estimate is coarse.
+    //
+
+    if (WinogradCost * 1.1 / double(ThreadCount) >= GemmCost / GemmThreadCount) {
+        return false;
+    }
+
+    Parameters->Algorithm = MlasConvAlgorithmWinograd;
+    Parameters->ThreadCount = ThreadCount;
+    Parameters->u.Winograd.TileCountHeight = TileCountHeight;
+    Parameters->u.Winograd.TileCountWidth = TileCountWidth;
+    Parameters->u.Winograd.TileBlockSize = TileBlockSize;
+    Parameters->u.Winograd.WorkingBufferSizePerThread =
+        MLAS_WINOGRAD_TRANSFORM_SIZE * MlasWinogradMatrixStride(InputChannels, TileBlockSize) +
+        MLAS_WINOGRAD_TRANSFORM_SIZE * MlasWinogradMatrixStride(FilterCount, TileBlockSize) +
+        16 * FilterCount * TileBlockSize;
+
+    const size_t TransformedFilterSize = Parameters->GroupCount *
+        MLAS_WINOGRAD_TRANSFORM_SIZE * MlasWinogradMatrixStride(FilterCount, InputChannels);
+
+    *WorkingBufferSize = TransformedFilterSize +
+        Parameters->u.Winograd.WorkingBufferSizePerThread * size_t(ThreadCount);
+
+    return true;
+}
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the convolution operation with the Winograd
+    F(4x4, 3x3) algorithm.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t TileCount = Parameters->u.Winograd.TileCountHeight * Parameters->u.Winograd.TileCountWidth;
+    const size_t TileBlockSize = Parameters->u.Winograd.TileBlockSize;
+    const size_t BlockCount = (TileCount + TileBlockSize - 1) / TileBlockSize;
+    const size_t WorkCount = Parameters->BatchCount * GroupCount * BlockCount;
+    const ptrdiff_t ThreadCount = Parameters->ThreadCount;
+
+    const size_t FilterMatrixStride = MlasWinogradMatrixStride(FilterCount, InputChannels);
+    const size_t InputMatrixStride = MlasWinogradMatrixStride(InputChannels, TileBlockSize);
+    const size_t OutputMatrixStride = MlasWinogradMatrixStride(FilterCount, TileBlockSize);
+    const size_t TransformedFilterGroupSize = MLAS_WINOGRAD_TRANSFORM_SIZE * FilterMatrixStride;
+    const size_t FilterGroupSize = FilterCount * InputChannels * 9;
+
+    float* TransformedFilter = WorkingBuffer;
+    float* ThreadWorkingBuffer = WorkingBuffer + GroupCount * TransformedFilterGroupSize;
+
+    //
+    // Transform the filters of every group.
+    //
+
+    MlasTrySimpleParallel(ThreadPool, ThreadCount, [&](ptrdiff_t tid) {
+
+        size_t Start;
+        size_t Count;
+
+        MlasPartitionWork(tid, ThreadCount, GroupCount * FilterCount, &Start, &Count);
+
+        for (size_t gm = Start; gm < Start + Count;) {
+
+            const size_t group = gm / FilterCount;
+            const size_t m = gm % FilterCount;
+            const size_t CountM = std::min(FilterCount - m, Start + Count - gm);
+
+            MlasConvWinogradTransformFilter(Parameters, Filter + group * FilterGroupSize,
+                TransformedFilter + group * TransformedFilterGroupSize, m, m + CountM);
+
+            gm += CountM;
+        }
+    });
+
+    //
+    // Convolve the blocks of tiles of every batch and group.
+    //
+
+    MlasTrySimpleParallel(ThreadPool, ThreadCount, [&](ptrdiff_t tid) {
+
+        const size_t InputGroupSize = InputChannels * Parameters->InputSize;
+        const size_t OutputGroupSize = FilterCount * Parameters->OutputSize;
+
+        float* TransformedInput = ThreadWorkingBuffer + tid * Parameters->u.Winograd.WorkingBufferSizePerThread;
+        float* TransformedOutput = TransformedInput + MLAS_WINOGRAD_TRANSFORM_SIZE * InputMatrixStride;
+        float* TileBuffer = TransformedOutput + MLAS_WINOGRAD_TRANSFORM_SIZE * OutputMatrixStride;
+
+        size_t WorkIndex;
+        size_t WorkRemaining;
+
+        MlasPartitionWork(tid, ThreadCount, WorkCount, &WorkIndex, &WorkRemaining);
+
+        for (size_t w = WorkIndex; w < WorkIndex + WorkRemaining; w++) {
+
+            const size_t bg = w / BlockCount;
+            const size_t group = bg % GroupCount;
+            const size_t TileStart = (w % BlockCount) * TileBlockSize;
+            const size_t CountTiles = std::min(TileBlockSize, TileCount - TileStart);
+
+            MlasConvWinogradTransformInput(Parameters, Input + bg * InputGroupSize, TransformedInput,
+                TileStart, CountTiles);
+
+            const float* filter = TransformedFilter + group * TransformedFilterGroupSize;
+
+            for (size_t p = 0; p < MLAS_WINOGRAD_TRANSFORM_SIZE; p++) {
+                MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, CountTiles, InputChannels,
+                    1.0f, filter + p * FilterMatrixStride, InputChannels,
+                    TransformedInput + p * InputMatrixStride, TileBlockSize, 0.0f,
+                    TransformedOutput + p * OutputMatrixStride, TileBlockSize);
+            }
+
+            MlasConvWinogradTransformOutput(Parameters, TransformedOutput,
+                (Bias != nullptr) ? Bias + group * FilterCount : nullptr, TileBuffer,
+                Output + bg * OutputGroupSize, TileStart, CountTiles);
+        }
+    });
+}
@@ -0,0 +1,408 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    flashattn.cpp
+
+Abstract:
+
+    This module implements the tiled scaled dot product attention operation.
+
+    Each thread computes blocks of query rows of a batch and head. The key and
+    value rows are streamed in blocks: the scores of a query block and a key
+    block are computed into the working buffer, and an online softmax keeps
+    the running maximum and sum of each query row. The output rows accumulate
+    the products of the unnormalized probabilities and the value block, and
+    are rescaled whenever the running maximum of the row increases.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the default number of query and key/value rows of a block. The
+// scores of a block and a key or value block stay in the L2 cache.
+//
+
+#define MLAS_FLASH_ATTENTION_BLOCK_SIZE_Q           128
+#define MLAS_FLASH_ATTENTION_BLOCK_SIZE_KV          256
+
+//
+// Define the difference from the row maximum below which the exponential of a
+// score does not contribute to the row sum.
+//
+
+#define MLAS_FLASH_ATTENTION_NEGLIGIBLE_SCORE       -104.0f
+
+void
+MLASCALL
+MlasFlashAttentionPrepare(
+    MLAS_FLASH_ATTENTION_PARAMETERS* Parameters,
+    size_t BatchCount,
+    size_t HeadCount,
+    size_t SequenceLength,
+    size_t TotalSequenceLength,
+    size_t QKHeadSize,
+    size_t VHeadSize,
+    float Scale,
+    bool Causal,
+    float CausalMaskValue,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine prepares for a tiled attention operation by computing the
+    block sizes and the number of threads, and returns the size of the working
+    buffer.
+
+Arguments:
+
+    Parameters - Receives the parameters of the operation.
+
+    BatchCount - Supplies the batch size.
+
+    HeadCount - Supplies the number of heads.
+
+    SequenceLength - Supplies the number of query rows per head.
+
+    TotalSequenceLength - Supplies the number of key and value rows per head.
+
+    QKHeadSize - Supplies the head size of the query and key.
+
+    VHeadSize - Supplies the head size of the value.
+
+    Scale - Supplies the scale applied to the query/key products.
+
+    Causal - Supplies true if a query row only attends to the key rows up to
+        its position offset by TotalSequenceLength - SequenceLength.
+
+    CausalMaskValue - Supplies the score of a key row hidden by the causal
+        mask.
+
+    WorkingBufferSize - Receives the number of floats of the working buffer.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    Parameters->BatchCount = BatchCount;
+    Parameters->HeadCount = HeadCount;
+    Parameters->SequenceLength = SequenceLength;
+    Parameters->TotalSequenceLength = TotalSequenceLength;
+    Parameters->QKHeadSize = QKHeadSize;
+    Parameters->VHeadSize = VHeadSize;
+    Parameters->Scale = Scale;
+    Parameters->Causal = Causal;
+    Parameters->CausalMaskValue = CausalMaskValue;
+
+    const size_t BlockSizeQ = std::min<size_t>(SequenceLength, MLAS_FLASH_ATTENTION_BLOCK_SIZE_Q);
+    const size_t BlockSizeKV = std::min<size_t>(TotalSequenceLength, MLAS_FLASH_ATTENTION_BLOCK_SIZE_KV);
+
+    Parameters->BlockSizeQ = BlockSizeQ;
+    Parameters->BlockSizeKV = BlockSizeKV;
+
+    //
+    // Each thread needs the scores of a block and the running maximum and sum
+    // of each query row of the block.
+    //
+
+    Parameters->WorkingBufferSizePerThread = BlockSizeQ * BlockSizeKV + 2 * BlockSizeQ;
+
+    //
+    // Limit the number of threads to the number of query blocks.
+    //
+
+    const size_t BlockCount = BatchCount * HeadCount * ((SequenceLength + BlockSizeQ - 1) / std::max<size_t>(BlockSizeQ, 1));
+
+    ptrdiff_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > BlockCount) {
+        ThreadCount = ptrdiff_t(std::max<size_t>(BlockCount, 1));
+    }
+
+    Parameters->ThreadCount = ThreadCount;
+
+    *WorkingBufferSize = Parameters->WorkingBufferSizePerThread * size_t(ThreadCount);
+}
+
+void
+MlasFlashAttentionBlock(
+    const MLAS_FLASH_ATTENTION_PARAMETERS* Parameters,
+    const float* Query,
+    const float* Key,
+    const float* Value,
+    const float* KeyBias,
+    float* Buffer,
+    float* Output,
+    size_t StartQ,
+    size_t CountQ
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the attention of a block of query rows of a batch
+    and head.
+
+Arguments:
+
+    Parameters - Supplies the parameters of the operation.
+
+    Query - Supplies the first query row of the block.
+
+    Key - Supplies the key rows of the batch and head.
+
+    Value - Supplies the value rows of the batch and head.
+
+    KeyBias - Optionally supplies the key bias row of the batch.
+
+    Buffer - Supplies the working buffer of the thread.
+
+    Output - Supplies the first output row of the block.
+
+    StartQ - Supplies the index of the first query row of the block.
+
+    CountQ - Supplies the number of query rows of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t TotalSequenceLength = Parameters->TotalSequenceLength;
+    const size_t QKHeadSize = Parameters->QKHeadSize;
+    const size_t VHeadSize = Parameters->VHeadSize;
+    const size_t BlockSizeKV = Parameters->BlockSizeKV;
+    const size_t ldo = Parameters->HeadCount * VHeadSize;
+    const float CausalMaskValue = Parameters->CausalMaskValue;
+
+    //
+    // Query row s attends to the key rows up to s + CausalOffset.
+    //
+
+    const size_t CausalOffset = TotalSequenceLength - Parameters->SequenceLength;
+
+    float* Scores = Buffer;
+    float* RowMaximum = Scores + Parameters->BlockSizeQ * BlockSizeKV;
+    float* RowSum = RowMaximum + Parameters->BlockSizeQ;
+
+    for (size_t q = 0; q < CountQ; q++) {
+        RowMaximum[q] = std::numeric_limits<float>::lowest();
+        RowSum[q] = 0.0f;
+        std::fill_n(Output + q * ldo, VHeadSize, 0.0f);
+    }
+
+    for (size_t StartKV = 0; StartKV < TotalSequenceLength; StartKV += BlockSizeKV) {
+
+        const size_t CountKV = std::min(TotalSequenceLength - StartKV, BlockSizeKV);
+        const float* Bias = (KeyBias != nullptr) ? KeyBias + StartKV : nullptr;
+
+        //
+        // A block hidden by the causal mask for every query row only needs
+        // to be computed if its constant scores are not negligible compared
+        // to the running maximum of some row. This is only the case when
+        // every visible score of the row is itself masked.
+        //
+
+        const bool BlockMasked = Parameters->Causal && StartKV > StartQ + CountQ - 1 + CausalOffset;
+
+        if (BlockMasked) {
+
+            float MaximumBias = 0.0f;
+
+            if (Bias != nullptr) {
+                MaximumBias = *std::max_element(Bias, Bias + CountKV);
+            }
+
+            const float MinimumRowMaximum = *std::min_element(RowMaximum, RowMaximum + CountQ);
+
+            if (CausalMaskValue + MaximumBias - MinimumRowMaximum < MLAS_FLASH_ATTENTION_NEGLIGIBLE_SCORE) {
+                continue;
+            }
+
+        } else {
+
+            MlasSgemmOperation(CblasNoTrans, CblasTrans, CountQ, CountKV, QKHeadSize,
+                Parameters->Scale, Query, QKHeadSize, Key + StartKV * QKHeadSize, QKHeadSize,
+                0.0f, Scores, BlockSizeKV);
+        }
+
+        for (size_t q = 0; q < CountQ; q++) {
+
+            float* s = Scores + q * BlockSizeKV;
+
+            //
+            // Apply the causal mask and the key bias.
+            //
+
+            size_t VisibleCount = CountKV;
+
+            if (Parameters->Causal) {
+                const size_t LastVisible = StartQ + q + CausalOffset;
+                VisibleCount = (LastVisible < StartKV) ? 0 : std::min(CountKV, LastVisible - StartKV + 1);
+                std::fill(s + VisibleCount, s + CountKV, CausalMaskValue);
+            }
+
+            if (Bias != nullptr) {
+                for (size_t kv = 0; kv < CountKV; kv++) {
+                    s[kv] += Bias[kv];
+                }
+            }
+
+            //
+            // Update the running maximum of the row and compute the
+            // exponentials of the scores relative to it.
+            //
+
+#if defined(MLAS_TARGET_AMD64)
+            const float Maximum = std::max(RowMaximum[q], GetMlasPlatform().ReduceMaximumF32Kernel(s, CountKV));
+#else
+            const float Maximum = std::max(RowMaximum[q], MlasReduceMaximumF32Kernel(s, CountKV));
+#endif
+            float NegativeMaximum = -Maximum;
+
+#if defined(MLAS_TARGET_AMD64)
+            const float Sum = GetMlasPlatform().ComputeSumExpF32Kernel(s, s, CountKV, &NegativeMaximum);
+#else
+            const float Sum = MlasComputeSumExpF32Kernel(s, s, CountKV, &NegativeMaximum);
+#endif
+
+            //
+            // Rescale the sum and the output row to the new maximum.
+            //
+
+            if (Maximum > RowMaximum[q]) {
+
+                const float Correction = std::exp(RowMaximum[q] - Maximum);
+
+                RowSum[q] *= Correction;
+
+                float* o = Output + q * ldo;
+
+                for (size_t v = 0; v < VHeadSize; v++) {
+                    o[v] *= Correction;
+                }
+
+                RowMaximum[q] = Maximum;
+            }
+
+            RowSum[q] += Sum;
+        }
+
+        MlasSgemmOperation(CblasNoTrans, CblasNoTrans, CountQ, VHeadSize, CountKV,
+            1.0f, Scores, BlockSizeKV, Value + StartKV * VHeadSize, VHeadSize,
+            1.0f, Output, ldo);
+    }
+
+    for (size_t q = 0; q < CountQ; q++) {
+
+        const float Scale = 1.0f / RowSum[q];
+
+        float* o = Output + q * ldo;
+
+        for (size_t v = 0; v < VHeadSize; v++) {
+            o[v] *= Scale;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasFlashAttention(
+    const MLAS_FLASH_ATTENTION_PARAMETERS* Parameters,
+    const float* Query,
+    const float* Key,
+    const float* Value,
+    const float* KeyBias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the tiled scaled dot product attention operation.
+
+Arguments:
+
+    Parameters - Supplies the parameters from MlasFlashAttentionPrepare.
+
+    Query - Supplies the query buffer of shape B x N x S x H.
+
+    Key - Supplies the key buffer of shape B x N x T x H.
+
+    Value - Supplies the value buffer of shape B x N x T x H_v.
+
+    KeyBias - Optionally supplies the key bias buffer of shape B x T.
+
+    WorkingBuffer - Supplies the working buffer.
+
+    Output - Supplies the output buffer of shape B x S x N x H_v.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t HeadCount = Parameters->HeadCount;
+    const size_t SequenceLength = Parameters->SequenceLength;
+    const size_t TotalSequenceLength = Parameters->TotalSequenceLength;
+    const size_t QKHeadSize = Parameters->QKHeadSize;
+    const size_t VHeadSize = Parameters->VHeadSize;
+    const size_t BlockSizeQ = Parameters->BlockSizeQ;
+
+    if (SequenceLength == 0 || TotalSequenceLength == 0) {
+        return;
+    }
+
+    const size_t BlockCountQ = (SequenceLength + BlockSizeQ - 1) / BlockSizeQ;
+    const size_t BlockCount = Parameters->BatchCount * HeadCount * BlockCountQ;
+    const ptrdiff_t ThreadCount = Parameters->ThreadCount;
+
+    MlasTrySimpleParallel(ThreadPool, ThreadCount, [&](ptrdiff_t tid) {
+
+        size_t Block;
+        size_t CountBlock;
+
+        MlasPartitionWork(tid, ThreadCount, BlockCount, &Block, &CountBlock);
+
+        float* Buffer = WorkingBuffer + size_t(tid) * Parameters->WorkingBufferSizePerThread;
+
+        for (size_t i = Block; i < Block + CountBlock; i++) {
+
+            const size_t BatchHead = i / BlockCountQ;
+            const size_t Batch = BatchHead / HeadCount;
+            const size_t Head = BatchHead % HeadCount;
+            const size_t StartQ = (i % BlockCountQ) * BlockSizeQ;
+            const size_t CountQ = std::min(SequenceLength - StartQ, BlockSizeQ);
+
+            MlasFlashAttentionBlock(Parameters,
+                Query + (BatchHead * SequenceLength + StartQ) * QKHeadSize,
+                Key + BatchHead * TotalSequenceLength * QKHeadSize,
+                Value + BatchHead * TotalSequenceLength * VHeadSize,
+                (KeyBias != nullptr) ? KeyBias + Batch * TotalSequenceLength : nullptr,
+                Buffer,
+                Output + ((Batch * SequenceLength + StartQ) * HeadCount + Head) * VHeadSize,
+                StartQ,
+                CountQ);
+        }
+    });
+}
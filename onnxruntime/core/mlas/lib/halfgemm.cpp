@@ -0,0 +1,604 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm.cpp
+
+Abstract:
+
+    This module implements the half precision floating point matrix/matrix
+    multiply operation (HALFGEMM) and the portable kernel used on platforms
+    without an optimized kernel.
+
+--*/
+
+#include "mlasi.h"
+#include "halfgemm.h"
+
+#include <memory>
+
+//
+// Define the parameters to execute segments of a HALFGEMM operation on worker
+// threads.
+//
+
+struct MLAS_HALFGEMM_WORK_BLOCK {
+    ptrdiff_t ThreadCountM;
+    ptrdiff_t ThreadCountN;
+    CBLAS_TRANSPOSE TransA;
+    size_t M;
+    size_t N;
+    size_t K;
+};
+
+void
+MlasHalfGemmCopyPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const MLAS_FP16* B,
+    size_t ldb,
+    MLAS_FP16* PackedB,
+    size_t PanelStart,
+    size_t PanelCount
+    )
+/*++
+
+Routine Description:
+
+    This routine copies a range of column panels of matrix B to the packed
+    layout consumed by the HALFGEMM kernels.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of the packed matrix B.
+
+    PanelStart - Supplies the index of the first panel to pack.
+
+    PanelCount - Supplies the number of panels to pack.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t panel = PanelStart; panel < PanelStart + PanelCount; panel++) {
+
+        const size_t n = panel * MLAS_HALFGEMM_PANEL_N;
+        const size_t CountN = std::min(N - n, MLAS_HALFGEMM_PANEL_N);
+        MLAS_FP16* d = PackedB + panel * K * MLAS_HALFGEMM_PANEL_N;
+
+        for (size_t k = 0; k < K; k++) {
+
+            if (TransB == CblasNoTrans) {
+                std::copy_n(B + k * ldb + n, CountN, d);
+            } else {
+                for (size_t nn = 0; nn < CountN; nn++) {
+                    d[nn] = B[(n + nn) * ldb + k];
+                }
+            }
+
+            std::fill_n(d + CountN, MLAS_HALFGEMM_PANEL_N - CountN, MLAS_FP16(0));
+            d += MLAS_HALFGEMM_PANEL_N;
+        }
+    }
+}
+
+void
+MlasHalfGemmOperation(
+    const MLAS_HALFGEMM_WORK_BLOCK* WorkBlock,
+    const MLAS_HALF_GEMM_DATA_PARAMS* Data,
+    const MLAS_FP16* PackedB,
+    size_t RangeStartM,
+    size_t RangeCountM,
+    size_t RangeStartN,
+    size_t RangeCountN
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the HALFGEMM operation over a range of matrix C.
+
+    Blocks of matrix A are converted to the element type consumed by the
+    kernel, the products are accumulated in a single precision block and the
+    block is scaled and rounded to half precision once all of K is done.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the GEMM shape.
+
+    Data - Supplies the structure containing the GEMM input and output data.
+
+    PackedB - Supplies the packed matrix B.
+
+    RangeStartM - Supplies the starting row index to output.
+
+    RangeCountM - Supplies the number of rows to output.
+
+    RangeStartN - Supplies the starting column index to output.
+
+    RangeCountN - Supplies the number of columns to output.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_HALFGEMM_DISPATCH* Dispatch = GetMlasPlatform().HalfGemmDispatch;
+
+    MLAS_DECLSPEC_ALIGN(float PanelA[MLAS_HALFGEMM_STRIDEM * MLAS_HALFGEMM_STRIDEK], 64);
+    MLAS_DECLSPEC_ALIGN(float Accumulators[MLAS_HALFGEMM_STRIDEM * MLAS_HALFGEMM_STRIDEN], 64);
+    MLAS_DECLSPEC_ALIGN(float RowBuffer[MLAS_HALFGEMM_STRIDEN], 64);
+
+    const size_t K = WorkBlock->K;
+    const size_t lda = Data->lda;
+    const size_t ldc = Data->ldc;
+    const size_t PanelStride = K * MLAS_HALFGEMM_PANEL_N;
+    const float alpha = Data->alpha;
+    const float beta = Data->beta;
+
+    for (size_t n = 0; n < RangeCountN;) {
+
+        const size_t CountN = std::min(RangeCountN - n, size_t(MLAS_HALFGEMM_STRIDEN));
+        const size_t PaddedCountN = (CountN + MLAS_HALFGEMM_PANEL_N - 1) & ~(MLAS_HALFGEMM_PANEL_N - 1);
+        const MLAS_FP16* b = PackedB + ((RangeStartN + n) / MLAS_HALFGEMM_PANEL_N) * PanelStride;
+
+        for (size_t m = 0; m < RangeCountM;) {
+
+            const size_t CountM = std::min(RangeCountM - m, size_t(MLAS_HALFGEMM_STRIDEM));
+            const size_t StartM = RangeStartM + m;
+
+            if (K == 0) {
+                std::fill_n(Accumulators, CountM * MLAS_HALFGEMM_STRIDEN, 0.0f);
+            }
+
+            for (size_t k = 0; k < K;) {
+
+                const size_t CountK = std::min(K - k, size_t(MLAS_HALFGEMM_STRIDEK));
+
+                //
+                // Copy the block of matrix A, widening the elements to single
+                // precision unless the kernel consumes half precision.
+                //
+
+                if (Dispatch->NativeArithmetic) {
+
+                    MLAS_FP16* a = reinterpret_cast<MLAS_FP16*>(PanelA);
+
+                    for (size_t mm = 0; mm < CountM; mm++) {
+                        if (WorkBlock->TransA == CblasNoTrans) {
+                            std::copy_n(Data->A + (StartM + mm) * lda + k, CountK, a);
+                        } else {
+                            for (size_t kk = 0; kk < CountK; kk++) {
+                                a[kk] = Data->A[(k + kk) * lda + StartM + mm];
+                            }
+                        }
+                        a += CountK;
+                    }
+
+                } else {
+
+                    float* a = PanelA;
+
+                    for (size_t mm = 0; mm < CountM; mm++) {
+                        if (WorkBlock->TransA == CblasNoTrans) {
+                            Dispatch->ConvertHalfToFloat(Data->A + (StartM + mm) * lda + k, a, CountK);
+                        } else {
+                            for (size_t kk = 0; kk < CountK; kk++) {
+                                a[kk] = MlasHalfToFloat(Data->A[(k + kk) * lda + StartM + mm]);
+                            }
+                        }
+                        a += CountK;
+                    }
+                }
+
+                Dispatch->Kernel(PanelA, CountK, b + k * MLAS_HALFGEMM_PANEL_N, PanelStride,
+                                 Accumulators, MLAS_HALFGEMM_STRIDEN, CountM, PaddedCountN, CountK, k == 0);
+
+                k += CountK;
+            }
+
+            //
+            // Scale the accumulators and round them to the output.
+            //
+
+            for (size_t mm = 0; mm < CountM; mm++) {
+
+                float* acc = Accumulators + mm * MLAS_HALFGEMM_STRIDEN;
+                MLAS_FP16* c = Data->C + (StartM + mm) * ldc + RangeStartN + n;
+
+                if (beta != 0.0f) {
+                    Dispatch->ConvertHalfToFloat(c, RowBuffer, CountN);
+                    for (size_t nn = 0; nn < CountN; nn++) {
+                        acc[nn] = alpha * acc[nn] + beta * RowBuffer[nn];
+                    }
+                } else if (alpha != 1.0f) {
+                    for (size_t nn = 0; nn < CountN; nn++) {
+                        acc[nn] *= alpha;
+                    }
+                }
+
+                Dispatch->ConvertFloatToHalf(acc, c, CountN);
+            }
+
+            m += CountM;
+        }
+
+        n += CountN;
+    }
+}
+
+void
+MlasHalfGemmThreaded(
+    const MLAS_HALFGEMM_WORK_BLOCK* WorkBlock,
+    const MLAS_HALF_GEMM_DATA_PARAMS* Data,
+    const MLAS_FP16* PackedB,
+    ptrdiff_t ThreadId
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    HALFGEMM operation.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the thread task partition
+        info and the GEMM shape.
+
+    Data - Supplies the structure containing the GEMM input and output data.
+
+    PackedB - Supplies the packed matrix B.
+
+    ThreadId - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const ptrdiff_t ThreadIdM = ThreadId / WorkBlock->ThreadCountN;
+    const ptrdiff_t ThreadIdN = ThreadId % WorkBlock->ThreadCountN;
+
+    //
+    // Partition the operation along the M dimension.
+    //
+
+    size_t RangeStartM;
+    size_t RangeCountM;
+
+    MlasPartitionWork(ThreadIdM, WorkBlock->ThreadCountM, WorkBlock->M, &RangeStartM, &RangeCountM);
+
+    //
+    // Partition the operation along the N dimension. The ranges start on a
+    // packed panel of matrix B.
+    //
+
+    size_t RangeStartN;
+    size_t RangeCountN;
+
+    const size_t N = WorkBlock->N;
+    const size_t BlockedN = (N + MLAS_HALFGEMM_STRIDEN_THREAD_ALIGN - 1) /
+        MLAS_HALFGEMM_STRIDEN_THREAD_ALIGN;
+
+    MlasPartitionWork(ThreadIdN, WorkBlock->ThreadCountN, BlockedN, &RangeStartN, &RangeCountN);
+
+    RangeStartN *= MLAS_HALFGEMM_STRIDEN_THREAD_ALIGN;
+    RangeCountN *= MLAS_HALFGEMM_STRIDEN_THREAD_ALIGN;
+
+    RangeCountN = std::min(N - RangeStartN, RangeCountN);
+
+    MlasHalfGemmOperation(WorkBlock, Data, PackedB, RangeStartM, RangeCountM, RangeStartN, RangeCountN);
+}
+
+void
+MLASCALL
+MlasHalfGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_HALF_GEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    static_assert(MLAS_HALFGEMM_STRIDEN % MLAS_HALFGEMM_PANEL_N == 0, "StrideN must be a multiple of the panel width");
+    static_assert(MLAS_HALFGEMM_STRIDEN_THREAD_ALIGN % MLAS_HALFGEMM_PANEL_N == 0,
+                  "threads must start on a panel of packed B");
+
+    if (M == 0 || N == 0 || BatchSize == 0) {
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K) * double(BatchSize);
+
+    ptrdiff_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_HALFGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
+        TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_HALFGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
+    }
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Pack the matrices B that the caller did not pack. The packed buffer
+    // is shared by the threads that compute the same multiplication.
+    //
+
+    const size_t PanelCount = (N + MLAS_HALFGEMM_PANEL_N - 1) / MLAS_HALFGEMM_PANEL_N;
+    const size_t PackedBCount = PanelCount * K * MLAS_HALFGEMM_PANEL_N;
+
+    size_t UnpackedCount = 0;
+    for (size_t gemm_i = 0; gemm_i < BatchSize; gemm_i++) {
+        UnpackedCount += Data[gemm_i].BIsPacked ? 0 : 1;
+    }
+
+    std::unique_ptr<MLAS_FP16[]> PackedBuffer;
+    std::unique_ptr<const MLAS_FP16*[]> PackedB(new const MLAS_FP16*[BatchSize]);
+
+    if (UnpackedCount > 0) {
+        PackedBuffer.reset(new MLAS_FP16[UnpackedCount * PackedBCount]);
+    }
+
+    for (size_t gemm_i = 0, packed_i = 0; gemm_i < BatchSize; gemm_i++) {
+        if (Data[gemm_i].BIsPacked) {
+            PackedB[gemm_i] = static_cast<const MLAS_FP16*>(Data[gemm_i].B);
+        } else {
+            PackedB[gemm_i] = PackedBuffer.get() + packed_i * PackedBCount;
+            packed_i++;
+        }
+    }
+
+    if (UnpackedCount > 0 && K > 0) {
+
+        ptrdiff_t PackThreadsPerGemm = TargetThreadCount / ptrdiff_t(UnpackedCount);
+        if (PackThreadsPerGemm < 1) {
+            PackThreadsPerGemm = 1;
+        }
+        if (size_t(PackThreadsPerGemm) > PanelCount) {
+            PackThreadsPerGemm = ptrdiff_t(PanelCount);
+        }
+
+        MlasTrySimpleParallel(ThreadPool, PackThreadsPerGemm * BatchSize, [&](ptrdiff_t tid) {
+            const auto gemm_i = tid / PackThreadsPerGemm;
+            const auto blk_i = tid % PackThreadsPerGemm;
+            if (Data[gemm_i].BIsPacked) {
+                return;
+            }
+            size_t PanelStart;
+            size_t PanelCountThread;
+            MlasPartitionWork(blk_i, PackThreadsPerGemm, PanelCount, &PanelStart, &PanelCountThread);
+            MlasHalfGemmCopyPackB(TransB, N, K, static_cast<const MLAS_FP16*>(Data[gemm_i].B), Data[gemm_i].ldb,
+                                  const_cast<MLAS_FP16*>(PackedB[gemm_i]), PanelStart, PanelCountThread);
+        });
+    }
+
+    ptrdiff_t ThreadsPerGemm = TargetThreadCount / BatchSize;
+    if (ThreadsPerGemm < 1) {
+        ThreadsPerGemm = 1;
+    }
+
+    //
+    // Segment the operation across multiple threads.
+    //
+    // N.B. Currently, the operation is segmented as a 1D partition, which
+    // works okay for operations involving skinny matrices.
+    //
+
+    MLAS_HALFGEMM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+
+    if (N > M) {
+
+        const size_t BlockedN = (N + MLAS_HALFGEMM_STRIDEN_THREAD_ALIGN - 1) /
+            MLAS_HALFGEMM_STRIDEN_THREAD_ALIGN;
+
+        if (size_t(ThreadsPerGemm) > BlockedN) {
+            ThreadsPerGemm = ptrdiff_t(BlockedN);
+        }
+
+        WorkBlock.ThreadCountM = 1;
+        WorkBlock.ThreadCountN = ThreadsPerGemm;
+
+    } else {
+
+        if (size_t(ThreadsPerGemm) > M) {
+            ThreadsPerGemm = ptrdiff_t(M);
+        }
+
+        WorkBlock.ThreadCountM = ThreadsPerGemm;
+        WorkBlock.ThreadCountN = 1;
+    }
+
+    TargetThreadCount = ThreadsPerGemm * BatchSize;
+
+    MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [&](ptrdiff_t tid) {
+        const auto gemm_i = tid / ThreadsPerGemm;
+        const auto blk_i = tid % ThreadsPerGemm;
+        MlasHalfGemmThreaded(&WorkBlock, &Data[gemm_i], PackedB[gemm_i], blk_i);
+    });
+}
+
+size_t
+MLASCALL
+MlasHalfGemmPackBSize(
+    size_t N,
+    size_t K
+    )
+{
+    const size_t PanelCount = (N + MLAS_HALFGEMM_PANEL_N - 1) / MLAS_HALFGEMM_PANEL_N;
+    const size_t BytesRequired = PanelCount * K * MLAS_HALFGEMM_PANEL_N * sizeof(MLAS_FP16);
+    const size_t BufferAlignment = MlasGetPreferredBufferAlignment();
+    const size_t AlignedBytesRequired = (BytesRequired + BufferAlignment - 1) &
+        ~(BufferAlignment - 1);
+
+    return AlignedBytesRequired;
+}
+
+void
+MLASCALL
+MlasHalfGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const MLAS_FP16* B,
+    size_t ldb,
+    void* PackedB
+    )
+{
+    const size_t PanelCount = (N + MLAS_HALFGEMM_PANEL_N - 1) / MLAS_HALFGEMM_PANEL_N;
+
+    MlasHalfGemmCopyPackB(TransB, N, K, B, ldb, static_cast<MLAS_FP16*>(PackedB), 0, PanelCount);
+}
+
+bool
+MLASCALL
+MlasFp16AccelerationSupported(
+    void
+    )
+{
+    return GetMlasPlatform().HalfGemmDispatch->NativeArithmetic;
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    MLAS_FP16* Destination,
+    size_t Count
+    )
+{
+    GetMlasPlatform().HalfGemmDispatch->ConvertFloatToHalf(Source, Destination, Count);
+}
+
+#if !defined(_M_AMD64) || defined(_M_ARM64EC)
+
+//
+// Windows x64 builds implement this routine in assembly (cvtfp16a.asm).
+//
+
+extern "C"
+void
+MLASCALL
+MlasConvertHalfToFloatBuffer(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    )
+{
+    GetMlasPlatform().HalfGemmDispatch->ConvertHalfToFloat(Source, Destination, Count);
+}
+
+#endif
+
+//
+// Portable kernel and conversion routines.
+//
+
+void
+MlasHalfGemmConvertHalfToFloat(
+    const MLAS_FP16* Source,
+    float* Destination,
+    size_t Count
+    )
+{
+    for (size_t i = 0; i < Count; i++) {
+        Destination[i] = MlasHalfToFloat(Source[i]);
+    }
+}
+
+void
+MlasHalfGemmConvertFloatToHalf(
+    const float* Source,
+    MLAS_FP16* Destination,
+    size_t Count
+    )
+{
+    for (size_t i = 0; i < Count; i++) {
+        Destination[i] = MlasFloatToHalf(Source[i]);
+    }
+}
+
+void
+MlasHalfGemmKernelDefault(
+    const void* A,
+    size_t lda,
+    const MLAS_FP16* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    bool ZeroMode
+    )
+{
+    const float* a = static_cast<const float*>(A);
+
+    for (size_t m = 0; m < CountM; m++) {
+
+        for (size_t n = 0; n < CountN; n += MLAS_HALFGEMM_PANEL_N) {
+
+            float Accumulators[MLAS_HALFGEMM_PANEL_N];
+            const MLAS_FP16* b = PackedB + (n / MLAS_HALFGEMM_PANEL_N) * PanelStride;
+            float* c = C + m * ldc + n;
+
+            for (size_t nn = 0; nn < MLAS_HALFGEMM_PANEL_N; nn++) {
+                Accumulators[nn] = ZeroMode ? 0.0f : c[nn];
+            }
+
+            for (size_t k = 0; k < CountK; k++) {
+                const float ak = a[m * lda + k];
+                for (size_t nn = 0; nn < MLAS_HALFGEMM_PANEL_N; nn++) {
+                    Accumulators[nn] += ak * MlasHalfToFloat(b[nn]);
+                }
+                b += MLAS_HALFGEMM_PANEL_N;
+            }
+
+            std::copy_n(Accumulators, MLAS_HALFGEMM_PANEL_N, c);
+        }
+    }
+}
+
+const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchDefault = {
+    MlasHalfGemmKernelDefault,
+    MlasHalfGemmConvertHalfToFloat,
+    MlasHalfGemmConvertFloatToHalf,
+    false,
+};
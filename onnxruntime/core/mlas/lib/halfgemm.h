@@ -0,0 +1,175 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm.h
+
+Abstract:
+
+    This module defines the dispatch structure and the helper routines used
+    to implement the half precision floating point matrix/matrix multiply
+    operation (HALFGEMM).
+
+    Matrix B is kept in half precision in panels of MLAS_HALFGEMM_PANEL_N
+    columns: each panel stores K rows of MLAS_HALFGEMM_PANEL_N elements, with
+    the columns past N zero filled. The shared driver converts blocks of matrix
+    A to the element type consumed by the kernel and accumulates the products
+    in single precision, so that only the final output is rounded to half
+    precision.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+#include <cstring>
+
+//
+// Define the number of columns in a panel of packed matrix B.
+//
+
+constexpr size_t MLAS_HALFGEMM_PANEL_N = 16;
+
+//
+// Define the prototypes of the platform optimized routines.
+//
+
+/**
+ * @brief Computes a block of the matrix product.
+ *
+ * @param A             Supplies the block of matrix A. The elements are single
+ *                      precision unless the dispatch uses native half
+ *                      precision arithmetic.
+ * @param lda           Supplies the first dimension of the block of matrix A.
+ * @param PackedB       Supplies the first packed panel of matrix B, starting at
+ *                      the first row of the block.
+ * @param PanelStride   Supplies the number of elements between consecutive
+ *                      panels of packed matrix B.
+ * @param C             Supplies the single precision accumulator block.
+ * @param ldc           Supplies the first dimension of the accumulator block.
+ * @param CountM        Supplies the number of rows of the block.
+ * @param CountN        Supplies the number of columns of the block, rounded up
+ *                      to a multiple of MLAS_HALFGEMM_PANEL_N.
+ * @param CountK        Supplies the number of columns of matrix A and rows of
+ *                      matrix B in the block.
+ * @param ZeroMode      Supplies true if the accumulator block is initialized,
+ *                      else false if the products are added to it.
+ */
+typedef
+void
+(MLAS_HALFGEMM_KERNEL)(
+    const void* A,
+    size_t lda,
+    const MLAS_FP16* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    bool ZeroMode
+    );
+
+typedef
+void
+(MLAS_HALF_TO_FLOAT_ROUTINE)(
+    const MLAS_FP16* Source,
+    float* Destination,
+    size_t Count
+    );
+
+typedef
+void
+(MLAS_FLOAT_TO_HALF_ROUTINE)(
+    const float* Source,
+    MLAS_FP16* Destination,
+    size_t Count
+    );
+
+struct MLAS_HALFGEMM_DISPATCH {
+    MLAS_HALFGEMM_KERNEL* Kernel;
+    MLAS_HALF_TO_FLOAT_ROUTINE* ConvertHalfToFloat;
+    MLAS_FLOAT_TO_HALF_ROUTINE* ConvertFloatToHalf;
+    bool NativeArithmetic;  /**< kernel consumes half precision matrix A */
+};
+
+//
+// Portable conversions between half and single precision values. Conversions
+// to half precision round to nearest even.
+//
+
+MLAS_FORCEINLINE
+float
+MlasHalfToFloat(
+    MLAS_FP16 Value
+    )
+{
+    constexpr uint32_t ShiftedExponent = 0x7C00 << 13;
+
+    uint32_t Bits = uint32_t(Value & 0x7FFF) << 13;
+    const uint32_t Exponent = Bits & ShiftedExponent;
+
+    Bits += (127 - 15) << 23;
+
+    if (Exponent == ShiftedExponent) {
+        Bits += (128 - 16) << 23;
+    } else if (Exponent == 0) {
+        constexpr uint32_t MagicBits = 113 << 23;
+        float Magic;
+        float Float;
+        Bits += 1 << 23;
+        std::memcpy(&Magic, &MagicBits, sizeof(float));
+        std::memcpy(&Float, &Bits, sizeof(float));
+        Float -= Magic;
+        std::memcpy(&Bits, &Float, sizeof(float));
+    }
+
+    Bits |= uint32_t(Value & 0x8000) << 16;
+
+    float Float;
+    std::memcpy(&Float, &Bits, sizeof(float));
+    return Float;
+}
+
+MLAS_FORCEINLINE
+MLAS_FP16
+MlasFloatToHalf(
+    float Value
+    )
+{
+    constexpr uint32_t Float32Infinity = 255 << 23;
+    constexpr uint32_t Float16Maximum = (127 + 16) << 23;
+    constexpr uint32_t DenormalMagicBits = ((127 - 15) + (23 - 10) + 1) << 23;
+
+    uint32_t Bits;
+    std::memcpy(&Bits, &Value, sizeof(float));
+
+    const uint32_t Sign = Bits & 0x80000000;
+    Bits ^= Sign;
+
+    uint16_t Half;
+
+    if (Bits >= Float16Maximum) {
+        Half = (Bits > Float32Infinity) ? 0x7E00 : 0x7C00;
+    } else if (Bits < (113 << 23)) {
+        float DenormalMagic;
+        float Float;
+        std::memcpy(&DenormalMagic, &DenormalMagicBits, sizeof(float));
+        std::memcpy(&Float, &Bits, sizeof(float));
+        Float += DenormalMagic;
+        std::memcpy(&Bits, &Float, sizeof(float));
+        Half = uint16_t(Bits - DenormalMagicBits);
+    } else {
+        const uint32_t MantissaOdd = (Bits >> 13) & 1;
+        Bits += (uint32_t(15 - 127) << 23) + 0xFFF;
+        Bits += MantissaOdd;
+        Half = uint16_t(Bits >> 13);
+    }
+
+    return MLAS_FP16(Half | (Sign >> 16));
+}
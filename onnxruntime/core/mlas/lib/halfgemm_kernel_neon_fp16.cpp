@@ -0,0 +1,177 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm_kernel_neon_fp16.cpp
+
+Abstract:
+
+    This module implements the kernel and the conversion routines for the half
+    precision matrix/matrix multiply operation (HALFGEMM) using the ARMv8.2
+    half precision vector arithmetic instructions.
+
+    The products of a block of K are accumulated in half precision and the
+    block sums are then added to the single precision accumulators, which
+    keeps the rounding error of the half precision sums bounded by the block
+    size.
+
+--*/
+
+#include "halfgemm.h"
+
+//
+// Define the number of rows of matrix A processed per iteration.
+//
+
+constexpr size_t MLAS_HALFGEMM_NEON_ROWS = 4;
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernelNeonFp16Rows(
+    const MLAS_FP16* A,
+    size_t lda,
+    const MLAS_FP16* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    size_t CountK,
+    bool ZeroMode
+    )
+{
+    for (size_t n = 0; n < CountN; n += MLAS_HALFGEMM_PANEL_N) {
+
+        float16x8_t Accumulators0[RowCount];
+        float16x8_t Accumulators1[RowCount];
+
+        MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+            Accumulators0[r] = vreinterpretq_f16_u16(vdupq_n_u16(0));
+            Accumulators1[r] = vreinterpretq_f16_u16(vdupq_n_u16(0));
+        });
+
+        const MLAS_FP16* b = PackedB + (n / MLAS_HALFGEMM_PANEL_N) * PanelStride;
+        const MLAS_FP16* a = A;
+
+        for (size_t k = 0; k < CountK; k++) {
+
+            float16x8_t BElements0 = vreinterpretq_f16_u16(vld1q_u16(b));
+            float16x8_t BElements1 = vreinterpretq_f16_u16(vld1q_u16(b + 8));
+
+            MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+                float16x8_t ABroadcast = vreinterpretq_f16_u16(vld1q_dup_u16(a + r * lda));
+                Accumulators0[r] = vfmaq_f16(Accumulators0[r], ABroadcast, BElements0);
+                Accumulators1[r] = vfmaq_f16(Accumulators1[r], ABroadcast, BElements1);
+            });
+
+            a += 1;
+            b += MLAS_HALFGEMM_PANEL_N;
+        }
+
+        MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+
+            float* c = C + r * ldc + n;
+
+            float32x4_t Sums[4] = {
+                vcvt_f32_f16(vget_low_f16(Accumulators0[r])),
+                vcvt_high_f32_f16(Accumulators0[r]),
+                vcvt_f32_f16(vget_low_f16(Accumulators1[r])),
+                vcvt_high_f32_f16(Accumulators1[r]),
+            };
+
+            for (size_t i = 0; i < 4; i++) {
+                if (!ZeroMode) {
+                    Sums[i] = vaddq_f32(Sums[i], vld1q_f32(c + i * 4));
+                }
+                vst1q_f32(c + i * 4, Sums[i]);
+            }
+        });
+    }
+}
+
+void
+MlasHalfGemmKernelNeonFp16(
+    const void* A,
+    size_t lda,
+    const MLAS_FP16* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    bool ZeroMode
+    )
+{
+    const MLAS_FP16* a = static_cast<const MLAS_FP16*>(A);
+
+    while (CountM >= MLAS_HALFGEMM_NEON_ROWS) {
+        MlasHalfGemmKernelNeonFp16Rows<MLAS_HALFGEMM_NEON_ROWS>(a, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+        a += MLAS_HALFGEMM_NEON_ROWS * lda;
+        C += MLAS_HALFGEMM_NEON_ROWS * ldc;
+        CountM -= MLAS_HALFGEMM_NEON_ROWS;
+    }
+
+    switch (CountM) {
+        case 1:
+            MlasHalfGemmKernelNeonFp16Rows<1>(a, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+        case 2:
+            MlasHalfGemmKernelNeonFp16Rows<2>(a, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+        case 3:
+            MlasHalfGemmKernelNeonFp16Rows<3>(a, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+    }
+}
+
+void
+MlasHalfGemmConvertHalfToFloatNeon(
+    const MLAS_FP16* Source,
+    float* Destination,
+    size_t Count
+    )
+{
+    while (Count >= 4) {
+        float16x4_t Vector = vreinterpret_f16_u16(vld1_u16(Source));
+        vst1q_f32(Destination, vcvt_f32_f16(Vector));
+        Source += 4;
+        Destination += 4;
+        Count -= 4;
+    }
+
+    for (size_t i = 0; i < Count; i++) {
+        Destination[i] = MlasHalfToFloat(Source[i]);
+    }
+}
+
+void
+MlasHalfGemmConvertFloatToHalfNeon(
+    const float* Source,
+    MLAS_FP16* Destination,
+    size_t Count
+    )
+{
+    while (Count >= 4) {
+        float16x4_t Vector = vcvt_f16_f32(vld1q_f32(Source));
+        vst1_u16(Destination, vreinterpret_u16_f16(Vector));
+        Source += 4;
+        Destination += 4;
+        Count -= 4;
+    }
+
+    for (size_t i = 0; i < Count; i++) {
+        Destination[i] = MlasFloatToHalf(Source[i]);
+    }
+}
+
+const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchNeonFp16 = {
+    MlasHalfGemmKernelNeonFp16,
+    MlasHalfGemmConvertHalfToFloatNeon,
+    MlasHalfGemmConvertFloatToHalfNeon,
+    true,
+};
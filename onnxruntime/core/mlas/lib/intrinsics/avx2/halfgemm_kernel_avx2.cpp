@@ -0,0 +1,178 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the kernel and the conversion routines for the half
+    precision matrix/matrix multiply operation (HALFGEMM) using F16C and
+    AVX2/FMA3 intrinsics.
+
+    The panels of matrix B stay in half precision in memory and are widened to
+    single precision in registers, the products are accumulated in single
+    precision.
+
+--*/
+
+#include "../../halfgemm.h"
+
+//
+// Define the number of rows of matrix A processed per iteration: each row
+// uses two accumulators for the 16 columns of a panel, which leaves registers
+// for the two columns of matrix B and the broadcast element of matrix A.
+//
+
+constexpr size_t MLAS_HALFGEMM_AVX2_ROWS = 6;
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernelAvx2Rows(
+    const float* A,
+    size_t lda,
+    const MLAS_FP16* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    size_t CountK,
+    bool ZeroMode
+    )
+{
+    for (size_t n = 0; n < CountN; n += MLAS_HALFGEMM_PANEL_N) {
+
+        __m256 Accumulators0[RowCount];
+        __m256 Accumulators1[RowCount];
+
+        MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+            Accumulators0[r] = _mm256_setzero_ps();
+            Accumulators1[r] = _mm256_setzero_ps();
+        });
+
+        const MLAS_FP16* b = PackedB + (n / MLAS_HALFGEMM_PANEL_N) * PanelStride;
+        const float* a = A;
+
+        for (size_t k = 0; k < CountK; k++) {
+
+            __m256 BElements0 = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+            __m256 BElements1 = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + 8)));
+
+            MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+                __m256 ABroadcast = _mm256_broadcast_ss(a + r * lda);
+                Accumulators0[r] = _mm256_fmadd_ps(ABroadcast, BElements0, Accumulators0[r]);
+                Accumulators1[r] = _mm256_fmadd_ps(ABroadcast, BElements1, Accumulators1[r]);
+            });
+
+            a += 1;
+            b += MLAS_HALFGEMM_PANEL_N;
+        }
+
+        MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+
+            float* c = C + r * ldc + n;
+
+            if (!ZeroMode) {
+                Accumulators0[r] = _mm256_add_ps(Accumulators0[r], _mm256_loadu_ps(c));
+                Accumulators1[r] = _mm256_add_ps(Accumulators1[r], _mm256_loadu_ps(c + 8));
+            }
+
+            _mm256_storeu_ps(c, Accumulators0[r]);
+            _mm256_storeu_ps(c + 8, Accumulators1[r]);
+        });
+    }
+}
+
+void
+MlasHalfGemmKernelAvx2(
+    const void* A,
+    size_t lda,
+    const MLAS_FP16* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    bool ZeroMode
+    )
+{
+    const float* a = static_cast<const float*>(A);
+
+    while (CountM >= MLAS_HALFGEMM_AVX2_ROWS) {
+        MlasHalfGemmKernelAvx2Rows<MLAS_HALFGEMM_AVX2_ROWS>(a, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+        a += MLAS_HALFGEMM_AVX2_ROWS * lda;
+        C += MLAS_HALFGEMM_AVX2_ROWS * ldc;
+        CountM -= MLAS_HALFGEMM_AVX2_ROWS;
+    }
+
+    switch (CountM) {
+        case 1:
+            MlasHalfGemmKernelAvx2Rows<1>(a, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+        case 2:
+            MlasHalfGemmKernelAvx2Rows<2>(a, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+        case 3:
+            MlasHalfGemmKernelAvx2Rows<3>(a, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+        case 4:
+            MlasHalfGemmKernelAvx2Rows<4>(a, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+        case 5:
+            MlasHalfGemmKernelAvx2Rows<5>(a, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+    }
+}
+
+void
+MlasHalfGemmConvertHalfToFloatAvx2(
+    const MLAS_FP16* Source,
+    float* Destination,
+    size_t Count
+    )
+{
+    while (Count >= 8) {
+        __m256 Vector = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Source)));
+        _mm256_storeu_ps(Destination, Vector);
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+    for (size_t i = 0; i < Count; i++) {
+        Destination[i] = MlasHalfToFloat(Source[i]);
+    }
+}
+
+void
+MlasHalfGemmConvertFloatToHalfAvx2(
+    const float* Source,
+    MLAS_FP16* Destination,
+    size_t Count
+    )
+{
+    while (Count >= 8) {
+        __m128i Vector = _mm256_cvtps_ph(_mm256_loadu_ps(Source), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(Destination), Vector);
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+    for (size_t i = 0; i < Count; i++) {
+        Destination[i] = MlasFloatToHalf(Source[i]);
+    }
+}
+
+const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx2 = {
+    MlasHalfGemmKernelAvx2,
+    MlasHalfGemmConvertHalfToFloatAvx2,
+    MlasHalfGemmConvertFloatToHalfAvx2,
+    false,
+};
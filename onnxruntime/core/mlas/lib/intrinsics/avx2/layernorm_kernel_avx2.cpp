@@ -0,0 +1,71 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the layer normalization kernel using AVX2/FMA3
+    intrinsics.
+
+--*/
+
+#include "../../layernorm.h"
+
+struct MLAS_LAYERNORM_KERNEL_AVX2
+{
+    typedef __m256 Vector;
+
+    static constexpr size_t VectorWidth = 8;
+
+    static MLAS_FORCEINLINE Vector Zero() { return _mm256_setzero_ps(); }
+
+    static MLAS_FORCEINLINE Vector Broadcast(float Value) { return _mm256_set1_ps(Value); }
+
+    static MLAS_FORCEINLINE Vector Load(const float* Buffer) { return _mm256_loadu_ps(Buffer); }
+
+    static MLAS_FORCEINLINE void Store(float* Buffer, Vector Value) { _mm256_storeu_ps(Buffer, Value); }
+
+    static MLAS_FORCEINLINE Vector Add(Vector Vector1, Vector Vector2) { return _mm256_add_ps(Vector1, Vector2); }
+
+    static MLAS_FORCEINLINE Vector Subtract(Vector Vector1, Vector Vector2) { return _mm256_sub_ps(Vector1, Vector2); }
+
+    static MLAS_FORCEINLINE Vector Multiply(Vector Vector1, Vector Vector2) { return _mm256_mul_ps(Vector1, Vector2); }
+
+    static MLAS_FORCEINLINE Vector MultiplyAdd(Vector Vector1, Vector Vector2, Vector Vector3)
+    {
+        return _mm256_fmadd_ps(Vector1, Vector2, Vector3);
+    }
+
+    static MLAS_FORCEINLINE float ReduceAdd(Vector Value)
+    {
+        __m128 Sum = _mm_add_ps(_mm256_castps256_ps128(Value), _mm256_extractf128_ps(Value, 1));
+        Sum = _mm_add_ps(Sum, _mm_movehl_ps(Sum, Sum));
+        Sum = _mm_add_ss(Sum, _mm_movehdup_ps(Sum));
+        return _mm_cvtss_f32(Sum);
+    }
+};
+
+void
+MLASCALL
+MlasLayerNormF32KernelAvx2(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Scale,
+    const float* Shift,
+    float* Output,
+    size_t D,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    )
+{
+    MlasLayerNormKernel<MLAS_LAYERNORM_KERNEL_AVX2>(Input, Skip, Bias, Scale, Shift, Output, D, Epsilon, Simplified, Mean, InvStdDev);
+}
@@ -0,0 +1,170 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    q4gemm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the kernel for the single precision matrix/matrix
+    multiply operation with block-wise 4-bit weights (Q4GEMM) using AVX2/FMA3
+    intrinsics.
+
+    The 16 bytes of a group of 32 elements are widened to four vectors of 8
+    elements and dequantized with a single multiply add. Each dequantized
+    vector is used for all of the rows of the tile.
+
+--*/
+
+#include "../../q4gemm.h"
+
+MLAS_FORCEINLINE
+float
+MlasQ4GemmReduceAddAvx2(
+    __m256 Vector
+    )
+{
+    __m128 Sum = _mm_add_ps(_mm256_castps256_ps128(Vector), _mm256_extractf128_ps(Vector, 1));
+    Sum = _mm_add_ps(Sum, _mm_movehl_ps(Sum, Sum));
+    Sum = _mm_add_ss(Sum, _mm_movehdup_ps(Sum));
+    return _mm_cvtss_f32(Sum);
+}
+
+template<typename Traits>
+struct MlasQ4GemmAvx2 {
+
+    template<size_t RowCount, size_t ColCount>
+    static void
+    Tile(
+        const float* A,
+        size_t lda,
+        const uint8_t* PackedB,
+        size_t ldb,
+        float* C,
+        size_t ldc,
+        const float* Bias,
+        size_t K
+        )
+    {
+        constexpr size_t BlkLen = Traits::BlkLen;
+
+        MLAS_DECLSPEC_ALIGN(float TailA[RowCount * BlkLen], 32);
+
+        __m256 Accumulators[RowCount][ColCount];
+
+        MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+            MlasLoopUnroll<ColCount>::Iterate([&](size_t c) {
+                Accumulators[r][c] = _mm256_setzero_ps();
+            });
+        });
+
+        const __m128i LowMask = _mm_set1_epi8(0x0F);
+        const uint8_t* Blob = PackedB;
+
+        for (size_t k = 0; k < K; k += BlkLen) {
+
+            const float* a = A + k;
+            size_t ld = lda;
+
+            if (K - k < BlkLen) {
+                MlasQ4GemmCopyTailA<Traits>(a, lda, RowCount, K - k, TailA);
+                a = TailA;
+                ld = BlkLen;
+            }
+
+            float Scale[ColCount];
+            float Offset[ColCount];
+
+            MlasLoopUnroll<ColCount>::Iterate([&](size_t c) {
+                const uint8_t* b = Blob + c * ldb;
+                Scale[c] = MlasQ4BlobScale<Traits>(b);
+                Offset[c] = -Scale[c] * float(MlasQ4BlobZeroPoint<Traits>(b));
+            });
+
+            for (size_t g = 0; g < BlkLen; g += 32) {
+
+                __m128i Nibbles[2][ColCount];
+
+                MlasLoopUnroll<ColCount>::Iterate([&](size_t c) {
+                    __m128i Bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                        MlasQ4BlobData<Traits>(Blob + c * ldb) + g / 2));
+                    Nibbles[0][c] = _mm_and_si128(Bytes, LowMask);
+                    Nibbles[1][c] = _mm_and_si128(_mm_srli_epi16(Bytes, 4), LowMask);
+                });
+
+                MlasLoopUnroll<4>::Iterate([&](size_t q) {
+
+                    __m256 BElements[ColCount];
+
+                    MlasLoopUnroll<ColCount>::Iterate([&](size_t c) {
+                        __m128i Quarter = (q % 2 == 0) ? Nibbles[q / 2][c] : _mm_srli_si128(Nibbles[q / 2][c], 8);
+                        __m256 Values = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(Quarter));
+                        BElements[c] = _mm256_fmadd_ps(Values, _mm256_set1_ps(Scale[c]), _mm256_set1_ps(Offset[c]));
+                    });
+
+                    MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+                        __m256 AElements = _mm256_loadu_ps(a + r * ld + g + q * 8);
+                        MlasLoopUnroll<ColCount>::Iterate([&](size_t c) {
+                            Accumulators[r][c] = _mm256_fmadd_ps(AElements, BElements[c], Accumulators[r][c]);
+                        });
+                    });
+                });
+            }
+
+            Blob += MlasQ4BlobSize<Traits>();
+        }
+
+        MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+            MlasLoopUnroll<ColCount>::Iterate([&](size_t c) {
+                float Sum = MlasQ4GemmReduceAddAvx2(Accumulators[r][c]);
+                if (Bias != nullptr) {
+                    Sum += Bias[c];
+                }
+                C[r * ldc + c] = Sum;
+            });
+        });
+    }
+
+    static void
+    Kernel(
+        const float* A,
+        size_t lda,
+        const uint8_t* PackedB,
+        size_t ldb,
+        float* C,
+        size_t ldc,
+        const float* Bias,
+        size_t CountM,
+        size_t CountN,
+        size_t K
+        )
+    {
+        MlasQ4GemmTiles<MlasQ4GemmAvx2, 2, 4>(A, lda, PackedB, ldb, C, ldc, Bias, CountM, CountN, K);
+    }
+};
+
+void
+MlasQ4GemmKernelAvx2(
+    MLAS_BLK_QUANT_TYPE QType,
+    const float* A,
+    size_t lda,
+    const uint8_t* PackedB,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    size_t CountM,
+    size_t CountN,
+    size_t K
+    )
+{
+    MlasQ4GemmKernelForType<MlasQ4GemmAvx2>(QType, A, lda, PackedB, ldb, C, ldc, Bias, CountM, CountN, K);
+}
+
+const MLAS_Q4GEMM_DISPATCH MlasQ4GemmDispatchAvx2 = {
+    MlasQ4GemmKernelAvx2,
+};
@@ -0,0 +1,142 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sbgemm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the kernel for the single precision matrix/matrix
+    multiply operation with bfloat16 weights (SBGEMM) using AVX2/FMA3
+    intrinsics.
+
+    The panels of matrix B are widened to single precision in registers by
+    shifting each bfloat16 element into the upper half of a 32-bit lane.
+
+--*/
+
+#include "../../sbgemm.h"
+
+//
+// Define the number of rows of matrix A processed per iteration: each row
+// uses two accumulators for the 16 columns of a panel, which leaves registers
+// for the two columns of matrix B and the broadcast element of matrix A.
+//
+
+constexpr size_t MLAS_SBGEMM_AVX2_ROWS = 6;
+
+MLAS_FORCEINLINE
+__m256
+MlasSBGemmLoadBAvx2(
+    const uint16_t* b
+    )
+{
+    __m256i Widened = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(Widened, 16));
+}
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasSBGemmKernelAvx2Rows(
+    const float* A,
+    size_t lda,
+    const uint16_t* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    size_t CountK,
+    bool ZeroMode
+    )
+{
+    for (size_t n = 0; n < CountN; n += MLAS_SBGEMM_PANEL_N) {
+
+        __m256 Accumulators0[RowCount];
+        __m256 Accumulators1[RowCount];
+
+        MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+            Accumulators0[r] = _mm256_setzero_ps();
+            Accumulators1[r] = _mm256_setzero_ps();
+        });
+
+        const uint16_t* b = PackedB + (n / MLAS_SBGEMM_PANEL_N) * PanelStride;
+        const float* a = A;
+
+        for (size_t k = 0; k < CountK; k++) {
+
+            __m256 BElements0 = MlasSBGemmLoadBAvx2(b);
+            __m256 BElements1 = MlasSBGemmLoadBAvx2(b + 8);
+
+            MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+                __m256 ABroadcast = _mm256_broadcast_ss(a + r * lda);
+                Accumulators0[r] = _mm256_fmadd_ps(ABroadcast, BElements0, Accumulators0[r]);
+                Accumulators1[r] = _mm256_fmadd_ps(ABroadcast, BElements1, Accumulators1[r]);
+            });
+
+            a += 1;
+            b += MLAS_SBGEMM_PANEL_N;
+        }
+
+        MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+
+            float* c = C + r * ldc + n;
+
+            if (!ZeroMode) {
+                Accumulators0[r] = _mm256_add_ps(Accumulators0[r], _mm256_loadu_ps(c));
+                Accumulators1[r] = _mm256_add_ps(Accumulators1[r], _mm256_loadu_ps(c + 8));
+            }
+
+            _mm256_storeu_ps(c, Accumulators0[r]);
+            _mm256_storeu_ps(c + 8, Accumulators1[r]);
+        });
+    }
+}
+
+void
+MlasSBGemmKernelAvx2(
+    const float* A,
+    size_t lda,
+    const uint16_t* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    bool ZeroMode
+    )
+{
+    while (CountM >= MLAS_SBGEMM_AVX2_ROWS) {
+        MlasSBGemmKernelAvx2Rows<MLAS_SBGEMM_AVX2_ROWS>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+        A += MLAS_SBGEMM_AVX2_ROWS * lda;
+        C += MLAS_SBGEMM_AVX2_ROWS * ldc;
+        CountM -= MLAS_SBGEMM_AVX2_ROWS;
+    }
+
+    switch (CountM) {
+        case 1:
+            MlasSBGemmKernelAvx2Rows<1>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+        case 2:
+            MlasSBGemmKernelAvx2Rows<2>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+        case 3:
+            MlasSBGemmKernelAvx2Rows<3>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+        case 4:
+            MlasSBGemmKernelAvx2Rows<4>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+        case 5:
+            MlasSBGemmKernelAvx2Rows<5>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+    }
+}
+
+const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAvx2 = {
+    MlasSBGemmKernelAvx2,
+};
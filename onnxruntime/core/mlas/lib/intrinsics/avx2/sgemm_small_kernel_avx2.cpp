@@ -0,0 +1,84 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_small_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation (SGEMM) for small matrices using AVX2/FMA3 intrinsics.
+
+--*/
+
+#include "../../sgemm_small.h"
+
+MLAS_INTERNAL_DATA const uint32_t MlasMaskMoveTableAvx[16];
+
+struct MLAS_SGEMM_SMALL_KERNEL_AVX2
+{
+    typedef __m256 Vector;
+    typedef __m256i Mask;
+
+    static constexpr size_t VectorWidth = 8;
+
+    //
+    // Each tile uses twelve accumulators for six rows of two vectors, which
+    // leaves registers for the two vectors of matrix B and the broadcast
+    // element of matrix A.
+    //
+
+    static constexpr size_t RowCount = 6;
+    static constexpr size_t VectorCount = 2;
+
+    //
+    // A transposed matrix B uses twelve accumulators for four rows of three
+    // columns, with the three vectors of matrix B and one vector of matrix A.
+    //
+
+    static constexpr size_t TransBRowCount = 4;
+    static constexpr size_t TransBColumnCount = 3;
+
+    static MLAS_FORCEINLINE Vector Zero() { return _mm256_setzero_ps(); }
+
+    static MLAS_FORCEINLINE Vector Broadcast(float Value) { return _mm256_set1_ps(Value); }
+
+    static MLAS_FORCEINLINE Vector Load(const float* Buffer) { return _mm256_loadu_ps(Buffer); }
+
+    static MLAS_FORCEINLINE void Store(float* Buffer, Vector Value) { _mm256_storeu_ps(Buffer, Value); }
+
+    static MLAS_FORCEINLINE Vector Multiply(Vector Vector1, Vector Vector2) { return _mm256_mul_ps(Vector1, Vector2); }
+
+    static MLAS_FORCEINLINE Vector MultiplyAdd(Vector Vector1, Vector Vector2, Vector Vector3)
+    {
+        return _mm256_fmadd_ps(Vector1, Vector2, Vector3);
+    }
+
+    static MLAS_FORCEINLINE float ReduceAdd(Vector Value)
+    {
+        return MlasReduceAddFloat32x4(_mm_add_ps(_mm256_castps256_ps128(Value), _mm256_extractf128_ps(Value, 1)));
+    }
+
+    static MLAS_FORCEINLINE Mask MakeMask(size_t Count)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&MlasMaskMoveTableAvx[8 - Count]));
+    }
+
+    static MLAS_FORCEINLINE Vector LoadMask(const float* Buffer, Mask ElementMask)
+    {
+        return _mm256_maskload_ps(Buffer, ElementMask);
+    }
+
+    static MLAS_FORCEINLINE void StoreMask(float* Buffer, Vector Value, Mask ElementMask)
+    {
+        _mm256_maskstore_ps(Buffer, ElementMask, Value);
+    }
+};
+
+const MLAS_SGEMM_SMALL_DISPATCH MlasSgemmSmallDispatchAvx2 = {
+    MlasSgemmSmallOperation<MLAS_SGEMM_SMALL_KERNEL_AVX2>,
+};
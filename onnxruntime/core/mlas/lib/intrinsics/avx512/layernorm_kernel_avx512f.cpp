@@ -0,0 +1,65 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm_kernel_avx512f.cpp
+
+Abstract:
+
+    This module implements the layer normalization kernel using AVX512F
+    intrinsics.
+
+--*/
+
+#include "../../layernorm.h"
+
+struct MLAS_LAYERNORM_KERNEL_AVX512F
+{
+    typedef __m512 Vector;
+
+    static constexpr size_t VectorWidth = 16;
+
+    static MLAS_FORCEINLINE Vector Zero() { return _mm512_setzero_ps(); }
+
+    static MLAS_FORCEINLINE Vector Broadcast(float Value) { return _mm512_set1_ps(Value); }
+
+    static MLAS_FORCEINLINE Vector Load(const float* Buffer) { return _mm512_loadu_ps(Buffer); }
+
+    static MLAS_FORCEINLINE void Store(float* Buffer, Vector Value) { _mm512_storeu_ps(Buffer, Value); }
+
+    static MLAS_FORCEINLINE Vector Add(Vector Vector1, Vector Vector2) { return _mm512_add_ps(Vector1, Vector2); }
+
+    static MLAS_FORCEINLINE Vector Subtract(Vector Vector1, Vector Vector2) { return _mm512_sub_ps(Vector1, Vector2); }
+
+    static MLAS_FORCEINLINE Vector Multiply(Vector Vector1, Vector Vector2) { return _mm512_mul_ps(Vector1, Vector2); }
+
+    static MLAS_FORCEINLINE Vector MultiplyAdd(Vector Vector1, Vector Vector2, Vector Vector3)
+    {
+        return _mm512_fmadd_ps(Vector1, Vector2, Vector3);
+    }
+
+    static MLAS_FORCEINLINE float ReduceAdd(Vector Value) { return _mm512_reduce_add_ps(Value); }
+};
+
+void
+MLASCALL
+MlasLayerNormF32KernelAvx512F(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Scale,
+    const float* Shift,
+    float* Output,
+    size_t D,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    )
+{
+    MlasLayerNormKernel<MLAS_LAYERNORM_KERNEL_AVX512F>(Input, Skip, Bias, Scale, Shift, Output, D, Epsilon, Simplified, Mean, InvStdDev);
+}
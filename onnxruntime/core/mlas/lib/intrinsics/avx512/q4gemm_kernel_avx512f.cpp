@@ -0,0 +1,159 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    q4gemm_kernel_avx512f.cpp
+
+Abstract:
+
+    This module implements the kernel for the single precision matrix/matrix
+    multiply operation with block-wise 4-bit weights (Q4GEMM) using AVX512F
+    intrinsics.
+
+    The 16 bytes of a group of 32 elements are widened to two vectors of 16
+    elements, from the low and the high nibbles, and dequantized with a single
+    multiply add. Each dequantized vector is used for all of the rows of the
+    tile.
+
+--*/
+
+#include "../../q4gemm.h"
+
+template<typename Traits>
+struct MlasQ4GemmAvx512F {
+
+    template<size_t RowCount, size_t ColCount>
+    static void
+    Tile(
+        const float* A,
+        size_t lda,
+        const uint8_t* PackedB,
+        size_t ldb,
+        float* C,
+        size_t ldc,
+        const float* Bias,
+        size_t K
+        )
+    {
+        constexpr size_t BlkLen = Traits::BlkLen;
+
+        MLAS_DECLSPEC_ALIGN(float TailA[RowCount * BlkLen], 64);
+
+        __m512 Accumulators[RowCount][ColCount];
+
+        MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+            MlasLoopUnroll<ColCount>::Iterate([&](size_t c) {
+                Accumulators[r][c] = _mm512_setzero_ps();
+            });
+        });
+
+        const __m128i LowMask = _mm_set1_epi8(0x0F);
+        const uint8_t* Blob = PackedB;
+
+        for (size_t k = 0; k < K; k += BlkLen) {
+
+            const float* a = A + k;
+            size_t ld = lda;
+
+            if (K - k < BlkLen) {
+                MlasQ4GemmCopyTailA<Traits>(a, lda, RowCount, K - k, TailA);
+                a = TailA;
+                ld = BlkLen;
+            }
+
+            __m512 Scale[ColCount];
+            __m512 Offset[ColCount];
+
+            MlasLoopUnroll<ColCount>::Iterate([&](size_t c) {
+                const uint8_t* b = Blob + c * ldb;
+                const float s = MlasQ4BlobScale<Traits>(b);
+                Scale[c] = _mm512_set1_ps(s);
+                Offset[c] = _mm512_set1_ps(-s * float(MlasQ4BlobZeroPoint<Traits>(b)));
+            });
+
+            for (size_t g = 0; g < BlkLen; g += 32) {
+
+                __m128i Bytes[ColCount];
+
+                MlasLoopUnroll<ColCount>::Iterate([&](size_t c) {
+                    Bytes[c] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                        MlasQ4BlobData<Traits>(Blob + c * ldb) + g / 2));
+                });
+
+                MlasLoopUnroll<2>::Iterate([&](size_t h) {
+
+                    __m512 BElements[ColCount];
+
+                    MlasLoopUnroll<ColCount>::Iterate([&](size_t c) {
+                        __m128i Nibbles = (h == 0) ? _mm_and_si128(Bytes[c], LowMask)
+                                                   : _mm_and_si128(_mm_srli_epi16(Bytes[c], 4), LowMask);
+                        __m512 Values = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(Nibbles));
+                        BElements[c] = _mm512_fmadd_ps(Values, Scale[c], Offset[c]);
+                    });
+
+                    MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+                        __m512 AElements = _mm512_loadu_ps(a + r * ld + g + h * 16);
+                        MlasLoopUnroll<ColCount>::Iterate([&](size_t c) {
+                            Accumulators[r][c] = _mm512_fmadd_ps(AElements, BElements[c], Accumulators[r][c]);
+                        });
+                    });
+                });
+            }
+
+            Blob += MlasQ4BlobSize<Traits>();
+        }
+
+        MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+            MlasLoopUnroll<ColCount>::Iterate([&](size_t c) {
+                float Sum = _mm512_reduce_add_ps(Accumulators[r][c]);
+                if (Bias != nullptr) {
+                    Sum += Bias[c];
+                }
+                C[r * ldc + c] = Sum;
+            });
+        });
+    }
+
+    static void
+    Kernel(
+        const float* A,
+        size_t lda,
+        const uint8_t* PackedB,
+        size_t ldb,
+        float* C,
+        size_t ldc,
+        const float* Bias,
+        size_t CountM,
+        size_t CountN,
+        size_t K
+        )
+    {
+        MlasQ4GemmTiles<MlasQ4GemmAvx512F, 4, 4>(A, lda, PackedB, ldb, C, ldc, Bias, CountM, CountN, K);
+    }
+};
+
+void
+MlasQ4GemmKernelAvx512F(
+    MLAS_BLK_QUANT_TYPE QType,
+    const float* A,
+    size_t lda,
+    const uint8_t* PackedB,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    size_t CountM,
+    size_t CountN,
+    size_t K
+    )
+{
+    MlasQ4GemmKernelForType<MlasQ4GemmAvx512F>(QType, A, lda, PackedB, ldb, C, ldc, Bias, CountM, CountN, K);
+}
+
+const MLAS_Q4GEMM_DISPATCH MlasQ4GemmDispatchAvx512F = {
+    MlasQ4GemmKernelAvx512F,
+};
@@ -0,0 +1,178 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sbgemm_kernel_avx512f.cpp
+
+Abstract:
+
+    This module implements the kernel for the single precision matrix/matrix
+    multiply operation with bfloat16 weights (SBGEMM) using AVX512F
+    intrinsics.
+
+    A 16 column panel of matrix B fills one register once widened, so pairs of
+    panels are processed together to amortize the broadcasts of matrix A.
+
+--*/
+
+#include "../../sbgemm.h"
+
+//
+// Define the number of rows of matrix A processed per iteration: each row
+// uses one accumulator per panel, so two panels over twelve rows use 24 of the
+// 32 registers.
+//
+
+constexpr size_t MLAS_SBGEMM_AVX512F_ROWS = 12;
+
+MLAS_FORCEINLINE
+__m512
+MlasSBGemmLoadBAvx512F(
+    const uint16_t* b
+    )
+{
+    __m512i Widened = _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b)));
+    return _mm512_castsi512_ps(_mm512_slli_epi32(Widened, 16));
+}
+
+template<size_t RowCount, size_t PanelCount>
+MLAS_FORCEINLINE
+void
+MlasSBGemmKernelAvx512FBlock(
+    const float* A,
+    size_t lda,
+    const uint16_t* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountK,
+    bool ZeroMode
+    )
+{
+    __m512 Accumulators[PanelCount][RowCount];
+
+    MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+        MlasLoopUnroll<PanelCount>::Iterate([&](size_t p) {
+            Accumulators[p][r] = _mm512_setzero_ps();
+        });
+    });
+
+    const uint16_t* b = PackedB;
+    const float* a = A;
+
+    for (size_t k = 0; k < CountK; k++) {
+
+        __m512 BElements[PanelCount];
+
+        MlasLoopUnroll<PanelCount>::Iterate([&](size_t p) {
+            BElements[p] = MlasSBGemmLoadBAvx512F(b + p * PanelStride);
+        });
+
+        MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+            __m512 ABroadcast = _mm512_set1_ps(a[r * lda]);
+            MlasLoopUnroll<PanelCount>::Iterate([&](size_t p) {
+                Accumulators[p][r] = _mm512_fmadd_ps(ABroadcast, BElements[p], Accumulators[p][r]);
+            });
+        });
+
+        a += 1;
+        b += MLAS_SBGEMM_PANEL_N;
+    }
+
+    MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+        MlasLoopUnroll<PanelCount>::Iterate([&](size_t p) {
+
+            float* c = C + r * ldc + p * MLAS_SBGEMM_PANEL_N;
+
+            if (!ZeroMode) {
+                Accumulators[p][r] = _mm512_add_ps(Accumulators[p][r], _mm512_loadu_ps(c));
+            }
+
+            _mm512_storeu_ps(c, Accumulators[p][r]);
+        });
+    });
+}
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasSBGemmKernelAvx512FRows(
+    const float* A,
+    size_t lda,
+    const uint16_t* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    size_t CountK,
+    bool ZeroMode
+    )
+{
+    size_t n = 0;
+
+    for (; n + 2 * MLAS_SBGEMM_PANEL_N <= CountN; n += 2 * MLAS_SBGEMM_PANEL_N) {
+        MlasSBGemmKernelAvx512FBlock<RowCount, 2>(A, lda, PackedB + (n / MLAS_SBGEMM_PANEL_N) * PanelStride,
+                                                  PanelStride, C + n, ldc, CountK, ZeroMode);
+    }
+
+    if (n < CountN) {
+        MlasSBGemmKernelAvx512FBlock<RowCount, 1>(A, lda, PackedB + (n / MLAS_SBGEMM_PANEL_N) * PanelStride,
+                                                  PanelStride, C + n, ldc, CountK, ZeroMode);
+    }
+}
+
+void
+MlasSBGemmKernelAvx512F(
+    const float* A,
+    size_t lda,
+    const uint16_t* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    bool ZeroMode
+    )
+{
+    while (CountM >= MLAS_SBGEMM_AVX512F_ROWS) {
+        MlasSBGemmKernelAvx512FRows<MLAS_SBGEMM_AVX512F_ROWS>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+        A += MLAS_SBGEMM_AVX512F_ROWS * lda;
+        C += MLAS_SBGEMM_AVX512F_ROWS * ldc;
+        CountM -= MLAS_SBGEMM_AVX512F_ROWS;
+    }
+
+    if (CountM >= 8) {
+        MlasSBGemmKernelAvx512FRows<8>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+        A += 8 * lda;
+        C += 8 * ldc;
+        CountM -= 8;
+    }
+
+    if (CountM >= 4) {
+        MlasSBGemmKernelAvx512FRows<4>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+        A += 4 * lda;
+        C += 4 * ldc;
+        CountM -= 4;
+    }
+
+    switch (CountM) {
+        case 1:
+            MlasSBGemmKernelAvx512FRows<1>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+        case 2:
+            MlasSBGemmKernelAvx512FRows<2>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+        case 3:
+            MlasSBGemmKernelAvx512FRows<3>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+    }
+}
+
+const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAvx512F = {
+    MlasSBGemmKernelAvx512F,
+};
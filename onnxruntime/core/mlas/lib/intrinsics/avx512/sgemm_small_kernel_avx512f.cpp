@@ -0,0 +1,75 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_small_kernel_avx512f.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation (SGEMM) for small matrices using AVX512F intrinsics.
+
+--*/
+
+#include "../../sgemm_small.h"
+
+struct MLAS_SGEMM_SMALL_KERNEL_AVX512F
+{
+    typedef __m512 Vector;
+    typedef __mmask16 Mask;
+
+    static constexpr size_t VectorWidth = 16;
+
+    //
+    // Each tile uses twelve accumulators for six rows of two vectors, the same
+    // tile as the AVX2 kernel with twice the columns.
+    //
+
+    static constexpr size_t RowCount = 6;
+    static constexpr size_t VectorCount = 2;
+
+    //
+    // A transposed matrix B uses sixteen accumulators for four rows of four
+    // columns.
+    //
+
+    static constexpr size_t TransBRowCount = 4;
+    static constexpr size_t TransBColumnCount = 4;
+
+    static MLAS_FORCEINLINE Vector Zero() { return _mm512_setzero_ps(); }
+
+    static MLAS_FORCEINLINE Vector Broadcast(float Value) { return _mm512_set1_ps(Value); }
+
+    static MLAS_FORCEINLINE Vector Load(const float* Buffer) { return _mm512_loadu_ps(Buffer); }
+
+    static MLAS_FORCEINLINE void Store(float* Buffer, Vector Value) { _mm512_storeu_ps(Buffer, Value); }
+
+    static MLAS_FORCEINLINE Vector Multiply(Vector Vector1, Vector Vector2) { return _mm512_mul_ps(Vector1, Vector2); }
+
+    static MLAS_FORCEINLINE Vector MultiplyAdd(Vector Vector1, Vector Vector2, Vector Vector3)
+    {
+        return _mm512_fmadd_ps(Vector1, Vector2, Vector3);
+    }
+
+    static MLAS_FORCEINLINE float ReduceAdd(Vector Value) { return _mm512_reduce_add_ps(Value); }
+
+    static MLAS_FORCEINLINE Mask MakeMask(size_t Count) { return __mmask16((1u << Count) - 1); }
+
+    static MLAS_FORCEINLINE Vector LoadMask(const float* Buffer, Mask ElementMask)
+    {
+        return _mm512_maskz_loadu_ps(ElementMask, Buffer);
+    }
+
+    static MLAS_FORCEINLINE void StoreMask(float* Buffer, Vector Value, Mask ElementMask)
+    {
+        _mm512_mask_storeu_ps(Buffer, ElementMask, Value);
+    }
+};
+
+const MLAS_SGEMM_SMALL_DISPATCH MlasSgemmSmallDispatchAvx512F = {
+    MlasSgemmSmallOperation<MLAS_SGEMM_SMALL_KERNEL_AVX512F>,
+};
@@ -0,0 +1,185 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm.cpp
+
+Abstract:
+
+    This module implements the layer normalization operation, optionally fused
+    with the addition of a skip and a bias row.
+
+--*/
+
+#include "mlasi.h"
+#include "layernorm.h"
+
+struct MLAS_LAYERNORM_KERNEL_DEFAULT
+{
+    typedef MLAS_FLOAT32X4 Vector;
+
+    static constexpr size_t VectorWidth = 4;
+
+    static MLAS_FORCEINLINE Vector Zero() { return MlasZeroFloat32x4(); }
+
+    static MLAS_FORCEINLINE Vector Broadcast(float Value) { return MlasBroadcastFloat32x4(Value); }
+
+    static MLAS_FORCEINLINE Vector Load(const float* Buffer) { return MlasLoadFloat32x4(Buffer); }
+
+    static MLAS_FORCEINLINE void Store(float* Buffer, Vector Value) { MlasStoreFloat32x4(Buffer, Value); }
+
+    static MLAS_FORCEINLINE Vector Add(Vector Vector1, Vector Vector2) { return MlasAddFloat32x4(Vector1, Vector2); }
+
+    static MLAS_FORCEINLINE Vector Subtract(Vector Vector1, Vector Vector2) { return MlasSubtractFloat32x4(Vector1, Vector2); }
+
+    static MLAS_FORCEINLINE Vector Multiply(Vector Vector1, Vector Vector2) { return MlasMultiplyFloat32x4(Vector1, Vector2); }
+
+    static MLAS_FORCEINLINE Vector MultiplyAdd(Vector Vector1, Vector Vector2, Vector Vector3)
+    {
+        return MlasMultiplyAddFloat32x4(Vector1, Vector2, Vector3);
+    }
+
+    static MLAS_FORCEINLINE float ReduceAdd(Vector Value) { return MlasReduceAddFloat32x4(Value); }
+};
+
+void
+MLASCALL
+MlasLayerNormF32Kernel(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Scale,
+    const float* Shift,
+    float* Output,
+    size_t D,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    )
+{
+    MlasLayerNormKernel<MLAS_LAYERNORM_KERNEL_DEFAULT>(Input, Skip, Bias, Scale, Shift, Output, D, Epsilon, Simplified, Mean, InvStdDev);
+}
+
+void
+MLASCALL
+MlasLayerNorm(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Scale,
+    const float* Shift,
+    float* Output,
+    float* Mean,
+    float* InvStdDev,
+    size_t N,
+    size_t D,
+    float Epsilon,
+    bool Simplified,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the layer normalization of each row of the input
+    buffer.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer of N rows of D elements.
+
+    Skip - Optionally supplies the skip buffer of N rows of D elements, which
+        is added to the input buffer.
+
+    Bias - Optionally supplies the bias row of D elements, which is added to
+        every row of the input buffer.
+
+    Scale - Supplies the scale row of D elements.
+
+    Shift - Optionally supplies the shift row of D elements.
+
+    Output - Supplies the output buffer of N rows of D elements.
+
+    Mean - Optionally receives the N means of the rows.
+
+    InvStdDev - Optionally receives the N inverse standard deviations of the
+        rows.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of elements per row.
+
+    Epsilon - Supplies the value added to the variance.
+
+    Simplified - Supplies true to normalize by the root mean square without
+        subtracting the mean.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (N == 0 || D == 0) {
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Limit the number of threads to the number of rows and try to
+    // keep each thread processing a minimum number of elements before using
+    // another thread.
+    //
+
+    ptrdiff_t ThreadCountN = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCountN) > N) {
+        ThreadCountN = ptrdiff_t(N);
+    }
+
+    constexpr size_t MinimumElementsPerThread = 16384;
+
+    size_t BlockCount = ((N * D) / MinimumElementsPerThread) + 1;
+
+    if (size_t(ThreadCountN) > BlockCount) {
+        ThreadCountN = ptrdiff_t(BlockCount);
+    }
+
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_LAYERNORM_FLOAT_KERNEL* Kernel = GetMlasPlatform().LayerNormF32Kernel;
+#else
+    MLAS_LAYERNORM_FLOAT_KERNEL* Kernel = MlasLayerNormF32Kernel;
+#endif
+
+    MlasTrySimpleParallel(ThreadPool, ThreadCountN, [&](ptrdiff_t tid) {
+
+        size_t n;
+        size_t CountN;
+
+        MlasPartitionWork(tid, ThreadCountN, N, &n, &CountN);
+
+        for (size_t i = n; i < n + CountN; i++) {
+            Kernel(Input + i * D,
+                   (Skip != nullptr) ? Skip + i * D : nullptr,
+                   Bias,
+                   Scale,
+                   Shift,
+                   Output + i * D,
+                   D,
+                   Epsilon,
+                   Simplified,
+                   (Mean != nullptr) ? Mean + i : nullptr,
+                   (InvStdDev != nullptr) ? InvStdDev + i : nullptr);
+        }
+    });
+}
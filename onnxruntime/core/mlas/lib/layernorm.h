@@ -0,0 +1,307 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm.h
+
+Abstract:
+
+    This module defines the template used to implement the layer
+    normalization kernels.
+
+    Each row is normalized in two passes. The first pass adds the optional
+    skip and bias rows to the input row, stores the sum to the output row, and
+    accumulates the sum and the sum of squares of the elements. The second pass
+    subtracts the mean, scales by the inverse standard deviation, and applies
+    the scale and shift rows.
+
+    The vector operations are supplied by a kernel type for each instruction
+    set.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+//
+// The kernel type supplies the following members:
+//
+//  Vector          - the vector type of VectorWidth single precision elements.
+//  Zero, Broadcast, Load, Store, Add, Subtract, Multiply, MultiplyAdd - vector
+//      operations.
+//  ReduceAdd       - the sum of the elements of a vector.
+//
+
+template<typename KernelType, bool HasSkip, bool HasBias>
+MLAS_FORCEINLINE
+void
+MlasLayerNormAccumulate(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    float* Output,
+    size_t D,
+    float& Sum,
+    float& SumSquares
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the first pass of the layer normalization of a row.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    Skip - Supplies the skip row if HasSkip is true.
+
+    Bias - Supplies the bias row if HasBias is true.
+
+    Output - Supplies the output row, which receives the sum of the input, skip
+        and bias rows if HasSkip or HasBias is true.
+
+    D - Supplies the number of elements of the row.
+
+    Sum - Receives the sum of the elements.
+
+    SumSquares - Receives the sum of the squares of the elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    using Vector = typename KernelType::Vector;
+    constexpr size_t VectorWidth = KernelType::VectorWidth;
+
+    //
+    // Use independent accumulators to hide the latency of the additions.
+    //
+
+    constexpr size_t UnrollCount = 4;
+
+    Vector Sums[UnrollCount];
+    Vector Squares[UnrollCount];
+
+    MlasLoopUnroll<UnrollCount>::Iterate([&](size_t u) {
+        Sums[u] = KernelType::Zero();
+        Squares[u] = KernelType::Zero();
+    });
+
+    auto LoadValue = [&](size_t d) {
+        Vector Value = KernelType::Load(Input + d);
+        if constexpr (HasSkip) {
+            Value = KernelType::Add(Value, KernelType::Load(Skip + d));
+        }
+        if constexpr (HasBias) {
+            Value = KernelType::Add(Value, KernelType::Load(Bias + d));
+        }
+        if constexpr (HasSkip || HasBias) {
+            KernelType::Store(Output + d, Value);
+        }
+        return Value;
+    };
+
+    size_t d = 0;
+
+    for (; d + UnrollCount * VectorWidth <= D; d += UnrollCount * VectorWidth) {
+        MlasLoopUnroll<UnrollCount>::Iterate([&](size_t u) {
+            Vector Value = LoadValue(d + u * VectorWidth);
+            Sums[u] = KernelType::Add(Sums[u], Value);
+            Squares[u] = KernelType::MultiplyAdd(Value, Value, Squares[u]);
+        });
+    }
+
+    for (; d + VectorWidth <= D; d += VectorWidth) {
+        Vector Value = LoadValue(d);
+        Sums[0] = KernelType::Add(Sums[0], Value);
+        Squares[0] = KernelType::MultiplyAdd(Value, Value, Squares[0]);
+    }
+
+    Sums[0] = KernelType::Add(KernelType::Add(Sums[0], Sums[1]), KernelType::Add(Sums[2], Sums[3]));
+    Squares[0] = KernelType::Add(KernelType::Add(Squares[0], Squares[1]), KernelType::Add(Squares[2], Squares[3]));
+
+    Sum = KernelType::ReduceAdd(Sums[0]);
+    SumSquares = KernelType::ReduceAdd(Squares[0]);
+
+    for (; d < D; d++) {
+        float Value = Input[d];
+        if constexpr (HasSkip) {
+            Value += Skip[d];
+        }
+        if constexpr (HasBias) {
+            Value += Bias[d];
+        }
+        if constexpr (HasSkip || HasBias) {
+            Output[d] = Value;
+        }
+        Sum += Value;
+        SumSquares += Value * Value;
+    }
+}
+
+template<typename KernelType, bool HasShift>
+MLAS_FORCEINLINE
+void
+MlasLayerNormOutput(
+    const float* Input,
+    const float* Scale,
+    const float* Shift,
+    float* Output,
+    size_t D,
+    float Mean,
+    float InvStdDev
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the second pass of the layer normalization of a row.
+
+Arguments:
+
+    Input - Supplies the row from the first pass, which may be the same as the
+        output row.
+
+    Scale - Supplies the scale row.
+
+    Shift - Supplies the shift row if HasShift is true.
+
+    Output - Supplies the output row.
+
+    D - Supplies the number of elements of the row.
+
+    Mean - Supplies the mean to subtract from each element.
+
+    InvStdDev - Supplies the inverse standard deviation of the row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    using Vector = typename KernelType::Vector;
+    constexpr size_t VectorWidth = KernelType::VectorWidth;
+
+    const Vector MeanBroadcast = KernelType::Broadcast(Mean);
+    const Vector InvStdDevBroadcast = KernelType::Broadcast(InvStdDev);
+
+    size_t d = 0;
+
+    for (; d + VectorWidth <= D; d += VectorWidth) {
+        Vector Value = KernelType::Subtract(KernelType::Load(Input + d), MeanBroadcast);
+        Value = KernelType::Multiply(Value, InvStdDevBroadcast);
+        if constexpr (HasShift) {
+            Value = KernelType::MultiplyAdd(Value, KernelType::Load(Scale + d), KernelType::Load(Shift + d));
+        } else {
+            Value = KernelType::Multiply(Value, KernelType::Load(Scale + d));
+        }
+        KernelType::Store(Output + d, Value);
+    }
+
+    for (; d < D; d++) {
+        float Value = (Input[d] - Mean) * InvStdDev * Scale[d];
+        if constexpr (HasShift) {
+            Value += Shift[d];
+        }
+        Output[d] = Value;
+    }
+}
+
+template<typename KernelType, bool HasSkip, bool HasBias>
+MLAS_FORCEINLINE
+void
+MlasLayerNormRow(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Scale,
+    const float* Shift,
+    float* Output,
+    size_t D,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    )
+{
+    float Sum;
+    float SumSquares;
+
+    MlasLayerNormAccumulate<KernelType, HasSkip, HasBias>(Input, Skip, Bias, Output, D, Sum, SumSquares);
+
+    const float RowMean = Simplified ? 0.0f : Sum / float(D);
+    const float Variance = SumSquares / float(D) - RowMean * RowMean;
+    const float RowInvStdDev = 1.0f / std::sqrt(Variance + Epsilon);
+
+    const float* Values = (HasSkip || HasBias) ? Output : Input;
+
+    if (Shift != nullptr) {
+        MlasLayerNormOutput<KernelType, true>(Values, Scale, Shift, Output, D, RowMean, RowInvStdDev);
+    } else {
+        MlasLayerNormOutput<KernelType, false>(Values, Scale, nullptr, Output, D, RowMean, RowInvStdDev);
+    }
+
+    if (Mean != nullptr) {
+        *Mean = RowMean;
+    }
+
+    if (InvStdDev != nullptr) {
+        *InvStdDev = RowInvStdDev;
+    }
+}
+
+template<typename KernelType>
+void
+MLASCALL
+MlasLayerNormKernel(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Scale,
+    const float* Shift,
+    float* Output,
+    size_t D,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the layer normalization of a row.
+
+Arguments:
+
+    See MLAS_LAYERNORM_FLOAT_KERNEL.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Skip != nullptr) {
+        if (Bias != nullptr) {
+            MlasLayerNormRow<KernelType, true, true>(Input, Skip, Bias, Scale, Shift, Output, D, Epsilon, Simplified, Mean, InvStdDev);
+        } else {
+            MlasLayerNormRow<KernelType, true, false>(Input, Skip, Bias, Scale, Shift, Output, D, Epsilon, Simplified, Mean, InvStdDev);
+        }
+    } else {
+        if (Bias != nullptr) {
+            MlasLayerNormRow<KernelType, false, true>(Input, Skip, Bias, Scale, Shift, Output, D, Epsilon, Simplified, Mean, InvStdDev);
+        } else {
+            MlasLayerNormRow<KernelType, false, false>(Input, Skip, Bias, Scale, Shift, Output, D, Epsilon, Simplified, Mean, InvStdDev);
+        }
+    }
+}
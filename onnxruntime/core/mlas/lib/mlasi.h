@@ -75,6 +75,17 @@ Abstract:
 #define MLAS_FORCEINLINE __attribute__ ((always_inline)) inline
 #endif
 
+//
+// Macro to inline every call made by a function, including the lambdas passed
+// to MlasLoopUnroll, which are otherwise subject to the inliner's size limits.
+//
+
+#if defined(__GNUC__) || defined(__clang__)
+#define MLAS_FLATTEN __attribute__ ((flatten))
+#else
+#define MLAS_FLATTEN
+#endif
+
 //
 // Macro to tag globals as internal data shared with kernels written in
 // assembly. These globals are marked with having hidden visibility to avoid
@@ -121,6 +132,8 @@ class MLASCPUIDInfo
     // ARM
     bool HasArmNeonDot() const { return has_arm_neon_dot_; }
 
+    bool HasArmNeon_FP16() const { return has_arm_neon_fp16_; }
+
     uint32_t GetCurrentCoreIdx() const { return 0xFFFFFFFF; }
 
     int32_t GetCurrentUarch() const { return -1; }
@@ -135,6 +148,7 @@ class MLASCPUIDInfo
     MLASCPUIDInfo();
 
     bool has_arm_neon_dot_{false};
+    bool has_arm_neon_fp16_{false};
 };
 using MLAS_CPUIDINFO = MLASCPUIDInfo;
 
@@ -197,6 +211,13 @@ enum MlasUArch {
 #define MLAS_SGEMM_PACKED_STRIDEK                   256
 #define MLAS_DGEMM_STRIDEN                          64
 #define MLAS_DGEMM_STRIDEK                          128
+#define MLAS_HALFGEMM_STRIDEM                       24
+#define MLAS_HALFGEMM_STRIDEN                       128
+#define MLAS_HALFGEMM_STRIDEK                       128
+#define MLAS_SBGEMM_STRIDEM                         24
+#define MLAS_SBGEMM_STRIDEN                         128
+#define MLAS_SBGEMM_STRIDEK                         256
+#define MLAS_Q4GEMM_STRIDEN                         32
 
 //
 // Define the alignment for segmenting a GEMM operation across multiple
@@ -210,6 +231,9 @@ enum MlasUArch {
 #define MLAS_SGEMM_STRIDEN_THREAD_ALIGN             16
 #define MLAS_DGEMM_STRIDEN_THREAD_ALIGN             8
 #define MLAS_QGEMM_STRIDEN_THREAD_ALIGN             16
+#define MLAS_HALFGEMM_STRIDEN_THREAD_ALIGN          16
+#define MLAS_SBGEMM_STRIDEN_THREAD_ALIGN            16
+#define MLAS_Q4GEMM_STRIDEN_THREAD_ALIGN            16
 
 //
 // Define the prototypes of the platform optimized routines.
@@ -469,6 +493,22 @@ void
     const float* Parameters
     );
 
+typedef
+void
+(MLASCALL MLAS_LAYERNORM_FLOAT_KERNEL)(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Scale,
+    const float* Shift,
+    float* Output,
+    size_t D,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    );
+
 typedef
 float
 (MLASCALL MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL)(
@@ -649,6 +689,7 @@ extern "C" {
     MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32Kernel;
     MLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeSoftmaxOutputF32Kernel;
     MLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeLogSoftmaxOutputF32Kernel;
+    MLAS_LAYERNORM_FLOAT_KERNEL MlasLayerNormF32Kernel;
     MLAS_QLINEAR_BINARY_OP_S8_KERNEL MlasQLinearAddS8Kernel;
     MLAS_QLINEAR_BINARY_OP_U8_KERNEL MlasQLinearAddU8Kernel;
     MLAS_QUANTIZE_LINEAR_S8_KERNEL MlasQuantizeLinearS8Kernel;
@@ -663,6 +704,8 @@ extern "C" {
     MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32KernelAvx512F;
     MLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeSoftmaxOutputF32KernelAvx;
     MLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeLogSoftmaxOutputF32KernelAvx;
+    MLAS_LAYERNORM_FLOAT_KERNEL MlasLayerNormF32KernelAvx2;
+    MLAS_LAYERNORM_FLOAT_KERNEL MlasLayerNormF32KernelAvx512F;
     MLAS_QLINEAR_BINARY_OP_S8_KERNEL MlasQLinearAddS8KernelAvx2;
     MLAS_QLINEAR_BINARY_OP_U8_KERNEL MlasQLinearAddU8KernelAvx2;
     MLAS_QUANTIZE_LINEAR_S8_KERNEL MlasQuantizeLinearS8KernelAvx512F;
@@ -703,6 +746,9 @@ extern "C" {
 #define MLAS_SGEMM_THREAD_COMPLEXITY                (64 * 1024)
 #define MLAS_DGEMM_THREAD_COMPLEXITY                (64 * 1024)
 #define MLAS_QGEMM_THREAD_COMPLEXITY                (64 * 1024)
+#define MLAS_HALFGEMM_THREAD_COMPLEXITY             (64 * 1024)
+#define MLAS_SBGEMM_THREAD_COMPLEXITY               (64 * 1024)
+#define MLAS_Q4GEMM_THREAD_COMPLEXITY               (64 * 1024)
 
 //
 // Single-threaded single precision matrix/matrix multiply operation.
@@ -725,6 +771,39 @@ MlasSgemmOperation(
     size_t ldc
     );
 
+//
+// Single precision matrix/matrix multiply operation for small matrices.
+//
+// The small matrix kernels handle shapes up to these limits by reading the
+// operands in place, and batches below MLAS_SGEMM_SMALL_THREAD_COMPLEXITY
+// total multiplies run on the calling thread. A single row of matrix A with
+// more than MLAS_SGEMM_SMALL_MAXIMUM_GEMV_NK elements of matrix B is left to
+// the matrix/vector kernels. A transposed matrix B is handled for at most
+// MLAS_SGEMM_SMALL_MAXIMUM_TRANSB_M rows of matrix A, and needs rows of at
+// least MLAS_SGEMM_SMALL_MINIMUM_TRANSB_K elements to amortize the horizontal
+// sums of its dot products. A non transposed matrix B of at most
+// MLAS_SGEMM_SMALL_MAXIMUM_UNPACKED_NK elements is faster left unpacked.
+//
+
+#define MLAS_SGEMM_SMALL_MAXIMUM_M                  16
+#define MLAS_SGEMM_SMALL_MAXIMUM_NK                 256
+#define MLAS_SGEMM_SMALL_MAXIMUM_GEMV_NK            (128 * 64)
+#define MLAS_SGEMM_SMALL_MAXIMUM_TRANSB_M           8
+#define MLAS_SGEMM_SMALL_MINIMUM_TRANSB_K           128
+#define MLAS_SGEMM_SMALL_MAXIMUM_UNPACKED_NK        (32 * 32)
+#define MLAS_SGEMM_SMALL_THREAD_COMPLEXITY          (256 * 1024)
+
+bool
+MlasSgemmSmallIsSupported(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize
+    );
+
 //
 // Quantized integer matrix/matrix dispatch structure.
 //
@@ -765,6 +844,48 @@ extern const MLAS_CONV_SYM_DISPATCH MlasConvSymS8DispatchNeon;
 extern const MLAS_CONV_SYM_DISPATCH MlasConvSymU8DispatchDot;
 extern const MLAS_CONV_SYM_DISPATCH MlasConvSymS8DispatchDot;
 
+//
+// Half precision floating point matrix/matrix dispatch structure.
+//
+
+struct MLAS_HALFGEMM_DISPATCH;
+
+extern const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchDefault;
+extern const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx2;
+extern const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchNeonFp16;
+
+//
+// Single precision matrix/matrix with bfloat16 weights dispatch structure.
+//
+
+struct MLAS_SBGEMM_DISPATCH;
+
+extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchDefault;
+extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAvx2;
+extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAvx512F;
+extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchNeon;
+
+//
+// Single precision matrix/matrix with block-wise 4-bit weights dispatch structure.
+//
+
+struct MLAS_Q4GEMM_DISPATCH;
+
+extern const MLAS_Q4GEMM_DISPATCH MlasQ4GemmDispatchDefault;
+extern const MLAS_Q4GEMM_DISPATCH MlasQ4GemmDispatchAvx2;
+extern const MLAS_Q4GEMM_DISPATCH MlasQ4GemmDispatchAvx512F;
+extern const MLAS_Q4GEMM_DISPATCH MlasQ4GemmDispatchNeon;
+
+//
+// Single precision matrix/matrix for small matrices dispatch structure.
+//
+
+struct MLAS_SGEMM_SMALL_DISPATCH;
+
+extern const MLAS_SGEMM_SMALL_DISPATCH MlasSgemmSmallDispatchAvx2;
+extern const MLAS_SGEMM_SMALL_DISPATCH MlasSgemmSmallDispatchAvx512F;
+extern const MLAS_SGEMM_SMALL_DISPATCH MlasSgemmSmallDispatchNeon;
+
 //
 // Quantized depthwise convolution kernels.
 //
@@ -842,6 +963,11 @@ struct MLAS_PLATFORM {
     const MLAS_CONV_SYM_DISPATCH* ConvSymU8S8Dispatch{nullptr};
     const MLAS_CONV_SYM_DISPATCH* ConvSymS8S8Dispatch{nullptr};
 
+    const MLAS_HALFGEMM_DISPATCH* HalfGemmDispatch{&MlasHalfGemmDispatchDefault};
+    const MLAS_SBGEMM_DISPATCH* SBGemmDispatch{&MlasSBGemmDispatchDefault};
+    const MLAS_Q4GEMM_DISPATCH* Q4GemmDispatch{&MlasQ4GemmDispatchDefault};
+    const MLAS_SGEMM_SMALL_DISPATCH* SgemmSmallDispatch{nullptr};
+
     MLAS_QUANT_KERNEL<uint8_t, int8_t>::DepthwiseKernel* ConvDepthwiseU8S8Kernel;
     MLAS_QUANT_KERNEL<uint8_t, uint8_t>::DepthwiseKernel* ConvDepthwiseU8U8Kernel;
     MLAS_QUANT_KERNEL<int8_t, int8_t>::DepthwiseKernel* ConvDepthwiseS8S8Kernel;
@@ -875,6 +1001,7 @@ struct MLAS_PLATFORM {
     MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL* ComputeSumExpF32Kernel;
     MLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL* ComputeSoftmaxOutputF32Kernel;
     MLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL* ComputeLogSoftmaxOutputF32Kernel;
+    MLAS_LAYERNORM_FLOAT_KERNEL* LayerNormF32Kernel;
     MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL* ReduceMaximumF32Kernel;
     MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL* ReduceMinimumMaximumF32Kernel;
     MLAS_QUANTIZE_LINEAR_S8_KERNEL* QuantizeLinearS8Kernel;
@@ -972,6 +1099,37 @@ MlasPartitionWork(
     }
 }
 
+//
+// Unrolls a loop at compile time, so that arrays indexed by the iteration
+// (such as the accumulators of a kernel) can stay in registers.
+//
+
+template<size_t Count>
+struct MlasLoopUnroll
+{
+    template<typename IterationType>
+    MLAS_FORCEINLINE
+    static
+    void
+    Iterate(IterationType Iteration)
+    {
+        MlasLoopUnroll<Count - 1>::Iterate(Iteration);
+        Iteration(Count - 1);
+    }
+};
+
+template<>
+struct MlasLoopUnroll<0>
+{
+    template<typename IterationType>
+    MLAS_FORCEINLINE
+    static
+    void
+    Iterate(IterationType)
+    {
+    }
+};
+
 //
 // Define the minimum floating point value (and its bit value equivalent) that
 // has no fractional bits. This number can be used for fast rounding of floating
@@ -1021,6 +1179,28 @@ MlasFp32FromBits(
 #pragma warning(pop)
 #endif
 
+//
+// Winograd F(4x4, 3x3) convolution routines.
+//
+
+bool
+MlasConvWinogradPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 #if defined(MLAS_TARGET_WASM_SCALAR)
 
 void
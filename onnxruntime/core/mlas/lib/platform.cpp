@@ -48,9 +48,16 @@ MLASCPUIDInfo::MLASCPUIDInfo()
 #ifndef HWCAP_ASIMDDP
 #define HWCAP_ASIMDDP (1 << 20)
 #endif
+#ifndef HWCAP_ASIMDHP
+#define HWCAP_ASIMDHP (1 << 10)
+#endif
 
 #if defined(BUILD_MLAS_NO_ONNXRUNTIME)
-MLASCPUIDInfo::MLASCPUIDInfo() { has_arm_neon_dot_ = ((getauxval(AT_HWCAP) & HWCAP_ASIMDDP) != 0); }
+MLASCPUIDInfo::MLASCPUIDInfo()
+{
+    has_arm_neon_dot_ = ((getauxval(AT_HWCAP) & HWCAP_ASIMDDP) != 0);
+    has_arm_neon_fp16_ = ((getauxval(AT_HWCAP) & HWCAP_ASIMDHP) != 0);
+}
 #endif
 
 #else
@@ -180,6 +187,7 @@ Return Value:
     this->ComputeSumExpF32Kernel = MlasComputeSumExpF32Kernel;
     this->ComputeSoftmaxOutputF32Kernel = MlasComputeSoftmaxOutputF32Kernel;
     this->ComputeLogSoftmaxOutputF32Kernel = MlasComputeLogSoftmaxOutputF32Kernel;
+    this->LayerNormF32Kernel = MlasLayerNormF32Kernel;
     this->ReduceMaximumF32Kernel = MlasReduceMaximumF32Kernel;
     this->ReduceMinimumMaximumF32Kernel = MlasReduceMinimumMaximumF32Kernel;
     this->QLinearAddS8Kernel = MlasQLinearAddS8Kernel;
@@ -285,6 +293,19 @@ Return Value:
                 this->ConvDepthwiseS8S8Kernel = MlasConvDepthwiseKernelAvx2<int8_t, int8_t>;
                 this->ConvDepthwiseS8U8Kernel = MlasConvDepthwiseKernelAvx2<int8_t, uint8_t>;
                 this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelFma3;
+                this->LayerNormF32Kernel = MlasLayerNormF32KernelAvx2;
+                this->SBGemmDispatch = &MlasSBGemmDispatchAvx2;
+                this->Q4GemmDispatch = &MlasQ4GemmDispatchAvx2;
+                this->SgemmSmallDispatch = &MlasSgemmSmallDispatchAvx2;
+
+                //
+                // Check if the processor supports F16C features for the
+                // half precision conversions.
+                //
+
+                if ((Cpuid1[2] & 0x20000000) != 0) {
+                    this->HalfGemmDispatch = &MlasHalfGemmDispatchAvx2;
+                }
 
                 //
                 // Check if the processor supports Hybrid core architecture.
@@ -333,8 +354,12 @@ Return Value:
                     this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelAvx512F;
                     this->ComputeExpF32Kernel = MlasComputeExpF32KernelAvx512F;
                     this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelAvx512F;
+                    this->LayerNormF32Kernel = MlasLayerNormF32KernelAvx512F;
                     this->QuantizeLinearS8Kernel = MlasQuantizeLinearS8KernelAvx512F;
                     this->QuantizeLinearU8Kernel = MlasQuantizeLinearU8KernelAvx512F;
+                    this->SBGemmDispatch = &MlasSBGemmDispatchAvx512F;
+                    this->Q4GemmDispatch = &MlasQ4GemmDispatchAvx512F;
+                    this->SgemmSmallDispatch = &MlasSgemmSmallDispatchAvx512F;
                     this->NchwcBlockSize = 16;
                     this->PreferredBufferAlignment = 64;
 
@@ -381,6 +406,9 @@ Return Value:
     this->SymmQgemmDispatch = &MlasSymmQgemmS8DispatchNeon;
     this->ConvSymU8S8Dispatch = &MlasConvSymU8DispatchNeon;
     this->ConvSymS8S8Dispatch = &MlasConvSymS8DispatchNeon;
+    this->SBGemmDispatch = &MlasSBGemmDispatchNeon;
+    this->Q4GemmDispatch = &MlasQ4GemmDispatchNeon;
+    this->SgemmSmallDispatch = &MlasSgemmSmallDispatchNeon;
 
     //
     // Check if the processor supports ASIMD dot product instructions.
@@ -403,6 +431,17 @@ Return Value:
         this->ConvSymS8S8Dispatch = &MlasConvSymS8DispatchDot;
     }
 
+    //
+    // Check if the processor supports ASIMD half precision arithmetic
+    // instructions.
+    //
+
+#if defined(__linux__)
+    if (MLAS_CPUIDINFO::GetCPUIDInfo().HasArmNeon_FP16()) {
+        this->HalfGemmDispatch = &MlasHalfGemmDispatchNeonFp16;
+    }
+#endif
+
 #endif // MLAS_TARGET_ARM64
 #if defined(MLAS_TARGET_POWER)
     this->GemmFloatKernel = MlasSgemmKernel;
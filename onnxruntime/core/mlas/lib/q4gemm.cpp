@@ -0,0 +1,520 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    q4gemm.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation with block-wise 4-bit weights (Q4GEMM), the quantization of
+    matrix B to the packed formats and the portable kernel.
+
+--*/
+
+#include "mlasi.h"
+#include "q4gemm.h"
+
+#include <cmath>
+
+//
+// Quantization of matrix B.
+//
+
+template<typename Traits>
+void
+MlasQ4GemmPackBImpl(
+    uint8_t* PackedB,
+    const float* B,
+    size_t N,
+    size_t K,
+    size_t ldb
+    )
+{
+    constexpr size_t BlkLen = Traits::BlkLen;
+
+    for (size_t n = 0; n < N; n++) {
+
+        for (size_t k = 0; k < K; k += BlkLen) {
+
+            const size_t CountK = std::min(K - k, BlkLen);
+
+            float Scale;
+            uint8_t ZeroPoint;
+
+            if (Traits::HasZeroPoint) {
+
+                //
+                // The range always includes zero so that zero is exact.
+                //
+
+                float Min = 0.0f;
+                float Max = 0.0f;
+
+                for (size_t kk = 0; kk < CountK; kk++) {
+                    const float v = B[(k + kk) * ldb + n];
+                    Min = std::min(Min, v);
+                    Max = std::max(Max, v);
+                }
+
+                Scale = (Max - Min) / 15.0f;
+
+                float ZeroPointFp = 0.0f;
+                if (Scale != 0.0f) {
+                    ZeroPointFp = -Min / Scale;
+                }
+                ZeroPoint = uint8_t(std::min(15.0f, std::max(0.0f, std::nearbyint(ZeroPointFp))));
+
+            } else {
+
+                //
+                // The element with the largest magnitude maps to -8, which
+                // keeps its sign exact and uses the full range of the data.
+                //
+
+                float Max = 0.0f;
+
+                for (size_t kk = 0; kk < CountK; kk++) {
+                    const float v = B[(k + kk) * ldb + n];
+                    if (std::fabs(v) > std::fabs(Max)) {
+                        Max = v;
+                    }
+                }
+
+                Scale = Max / -8.0f;
+                ZeroPoint = 8;
+            }
+
+            const float ReciprocalScale = (Scale != 0.0f) ? 1.0f / Scale : 0.0f;
+
+            std::memcpy(PackedB, &Scale, sizeof(float));
+            if (Traits::HasZeroPoint) {
+                PackedB[sizeof(float)] = ZeroPoint;
+            }
+            uint8_t* Data = PackedB + sizeof(float) + (Traits::HasZeroPoint ? 1 : 0);
+
+            uint8_t Values[BlkLen];
+
+            for (size_t kk = 0; kk < BlkLen; kk++) {
+                const float v = (kk < CountK) ? B[(k + kk) * ldb + n] : 0.0f;
+                const float q = std::nearbyint(v * ReciprocalScale) + float(ZeroPoint);
+                Values[kk] = uint8_t(std::min(15.0f, std::max(0.0f, q)));
+            }
+
+            for (size_t g = 0; g < BlkLen; g += 32) {
+                for (size_t j = 0; j < 16; j++) {
+                    Data[g / 2 + j] = uint8_t(Values[g + j] | (Values[g + j + 16] << 4));
+                }
+            }
+
+            PackedB += MlasQ4BlobSize<Traits>();
+        }
+    }
+}
+
+template<typename Traits>
+void
+MlasQ4GemmUnPackBImpl(
+    float* B,
+    const uint8_t* PackedB,
+    size_t N,
+    size_t K,
+    size_t ldb
+    )
+{
+    constexpr size_t BlkLen = Traits::BlkLen;
+
+    for (size_t n = 0; n < N; n++) {
+
+        for (size_t k = 0; k < K; k += BlkLen) {
+
+            const size_t CountK = std::min(K - k, BlkLen);
+            const float Scale = MlasQ4BlobScale<Traits>(PackedB);
+            const int ZeroPoint = MlasQ4BlobZeroPoint<Traits>(PackedB);
+            const uint8_t* Data = MlasQ4BlobData<Traits>(PackedB);
+
+            for (size_t kk = 0; kk < CountK; kk++) {
+                const uint8_t Byte = Data[(kk / 32) * 16 + (kk % 16)];
+                const int q = ((kk % 32) < 16) ? (Byte & 0x0F) : (Byte >> 4);
+                B[(k + kk) * ldb + n] = Scale * float(q - ZeroPoint);
+            }
+
+            PackedB += MlasQ4BlobSize<Traits>();
+        }
+    }
+}
+
+size_t
+MLASCALL
+MlasQ4GemmPackBSize(
+    MLAS_BLK_QUANT_TYPE QType,
+    size_t N,
+    size_t K
+    )
+{
+    size_t BlkLen;
+    size_t BlobSize;
+
+    switch (QType) {
+        case BlkQ4Sym32:
+            BlkLen = MLAS_Q4_BLK_TRAITS<BlkQ4Sym32>::BlkLen;
+            BlobSize = MlasQ4BlobSize<MLAS_Q4_BLK_TRAITS<BlkQ4Sym32>>();
+            break;
+        case BlkQ4Zp32:
+            BlkLen = MLAS_Q4_BLK_TRAITS<BlkQ4Zp32>::BlkLen;
+            BlobSize = MlasQ4BlobSize<MLAS_Q4_BLK_TRAITS<BlkQ4Zp32>>();
+            break;
+        case BlkQ4Sym128:
+            BlkLen = MLAS_Q4_BLK_TRAITS<BlkQ4Sym128>::BlkLen;
+            BlobSize = MlasQ4BlobSize<MLAS_Q4_BLK_TRAITS<BlkQ4Sym128>>();
+            break;
+        case BlkQ4Zp128:
+            BlkLen = MLAS_Q4_BLK_TRAITS<BlkQ4Zp128>::BlkLen;
+            BlobSize = MlasQ4BlobSize<MLAS_Q4_BLK_TRAITS<BlkQ4Zp128>>();
+            break;
+        default:
+            return 0;
+    }
+
+    return N * ((K + BlkLen - 1) / BlkLen) * BlobSize;
+}
+
+void
+MLASCALL
+MlasQ4GemmPackB(
+    MLAS_BLK_QUANT_TYPE QType,
+    void* PackedB,
+    const float* B,
+    size_t N,
+    size_t K,
+    size_t ldb
+    )
+{
+    uint8_t* Packed = static_cast<uint8_t*>(PackedB);
+
+    switch (QType) {
+        case BlkQ4Sym32:
+            MlasQ4GemmPackBImpl<MLAS_Q4_BLK_TRAITS<BlkQ4Sym32>>(Packed, B, N, K, ldb);
+            break;
+        case BlkQ4Zp32:
+            MlasQ4GemmPackBImpl<MLAS_Q4_BLK_TRAITS<BlkQ4Zp32>>(Packed, B, N, K, ldb);
+            break;
+        case BlkQ4Sym128:
+            MlasQ4GemmPackBImpl<MLAS_Q4_BLK_TRAITS<BlkQ4Sym128>>(Packed, B, N, K, ldb);
+            break;
+        case BlkQ4Zp128:
+            MlasQ4GemmPackBImpl<MLAS_Q4_BLK_TRAITS<BlkQ4Zp128>>(Packed, B, N, K, ldb);
+            break;
+    }
+}
+
+void
+MLASCALL
+MlasQ4GemmUnPackB(
+    MLAS_BLK_QUANT_TYPE QType,
+    float* B,
+    const void* PackedB,
+    size_t N,
+    size_t K,
+    size_t ldb
+    )
+{
+    const uint8_t* Packed = static_cast<const uint8_t*>(PackedB);
+
+    switch (QType) {
+        case BlkQ4Sym32:
+            MlasQ4GemmUnPackBImpl<MLAS_Q4_BLK_TRAITS<BlkQ4Sym32>>(B, Packed, N, K, ldb);
+            break;
+        case BlkQ4Zp32:
+            MlasQ4GemmUnPackBImpl<MLAS_Q4_BLK_TRAITS<BlkQ4Zp32>>(B, Packed, N, K, ldb);
+            break;
+        case BlkQ4Sym128:
+            MlasQ4GemmUnPackBImpl<MLAS_Q4_BLK_TRAITS<BlkQ4Sym128>>(B, Packed, N, K, ldb);
+            break;
+        case BlkQ4Zp128:
+            MlasQ4GemmUnPackBImpl<MLAS_Q4_BLK_TRAITS<BlkQ4Zp128>>(B, Packed, N, K, ldb);
+            break;
+    }
+}
+
+//
+// Define the parameters to execute segments of a Q4GEMM operation on worker
+// threads.
+//
+
+struct MLAS_Q4GEMM_WORK_BLOCK {
+    ptrdiff_t ThreadCountM;
+    ptrdiff_t ThreadCountN;
+    MLAS_BLK_QUANT_TYPE QType;
+    size_t M;
+    size_t N;
+    size_t K;
+};
+
+void
+MlasQ4GemmThreaded(
+    const MLAS_Q4GEMM_WORK_BLOCK* WorkBlock,
+    const MLAS_Q4GEMM_DATA_PARAMS* Data,
+    ptrdiff_t ThreadId
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    Q4GEMM operation.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the thread task partition
+        info and the GEMM shape.
+
+    Data - Supplies the structure containing the GEMM input and output data.
+
+    ThreadId - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const ptrdiff_t ThreadIdM = ThreadId / WorkBlock->ThreadCountN;
+    const ptrdiff_t ThreadIdN = ThreadId % WorkBlock->ThreadCountN;
+
+    //
+    // Partition the operation along the M dimension.
+    //
+
+    size_t RangeStartM;
+    size_t RangeCountM;
+
+    MlasPartitionWork(ThreadIdM, WorkBlock->ThreadCountM, WorkBlock->M, &RangeStartM, &RangeCountM);
+
+    //
+    // Partition the operation along the N dimension.
+    //
+
+    size_t RangeStartN;
+    size_t RangeCountN;
+
+    const size_t N = WorkBlock->N;
+    const size_t BlockedN = (N + MLAS_Q4GEMM_STRIDEN_THREAD_ALIGN - 1) /
+        MLAS_Q4GEMM_STRIDEN_THREAD_ALIGN;
+
+    MlasPartitionWork(ThreadIdN, WorkBlock->ThreadCountN, BlockedN, &RangeStartN, &RangeCountN);
+
+    RangeStartN *= MLAS_Q4GEMM_STRIDEN_THREAD_ALIGN;
+    RangeCountN *= MLAS_Q4GEMM_STRIDEN_THREAD_ALIGN;
+
+    RangeCountN = std::min(N - RangeStartN, RangeCountN);
+
+    //
+    // Step through the columns in strides that keep the packed matrix B in
+    // the cache while all of the rows of matrix A are multiplied with it.
+    //
+
+    const MLAS_Q4GEMM_DISPATCH* Dispatch = GetMlasPlatform().Q4GemmDispatch;
+    const size_t ldb = MlasQ4GemmPackBSize(WorkBlock->QType, 1, WorkBlock->K);
+    const uint8_t* PackedB = static_cast<const uint8_t*>(Data->B);
+
+    for (size_t n = 0; n < RangeCountN; n += MLAS_Q4GEMM_STRIDEN) {
+
+        const size_t StartN = RangeStartN + n;
+        const size_t CountN = std::min(RangeCountN - n, size_t(MLAS_Q4GEMM_STRIDEN));
+
+        Dispatch->Kernel(WorkBlock->QType, Data->A + RangeStartM * Data->lda, Data->lda, PackedB + StartN * ldb, ldb,
+                         Data->C + RangeStartM * Data->ldc + StartN, Data->ldc,
+                         Data->Bias != nullptr ? Data->Bias + StartN : nullptr, RangeCountM, CountN, WorkBlock->K);
+    }
+}
+
+void
+MLASCALL
+MlasQ4GemmBatch(
+    MLAS_BLK_QUANT_TYPE QType,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_Q4GEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    if (M == 0 || N == 0 || BatchSize == 0) {
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K) * double(BatchSize);
+
+    ptrdiff_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_Q4GEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
+        TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_Q4GEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
+    }
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    ptrdiff_t ThreadsPerGemm = TargetThreadCount / BatchSize;
+    if (ThreadsPerGemm < 1) {
+        ThreadsPerGemm = 1;
+    }
+
+    //
+    // Segment the operation across multiple threads. Partitioning along N
+    // splits the packed matrix B between the threads, which is preferred as
+    // reading matrix B is the dominant cost.
+    //
+
+    MLAS_Q4GEMM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.QType = QType;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+
+    const size_t BlockedN = (N + MLAS_Q4GEMM_STRIDEN_THREAD_ALIGN - 1) /
+        MLAS_Q4GEMM_STRIDEN_THREAD_ALIGN;
+
+    if (BlockedN >= size_t(ThreadsPerGemm) || BlockedN >= M) {
+
+        if (size_t(ThreadsPerGemm) > BlockedN) {
+            ThreadsPerGemm = ptrdiff_t(BlockedN);
+        }
+
+        WorkBlock.ThreadCountM = 1;
+        WorkBlock.ThreadCountN = ThreadsPerGemm;
+
+    } else {
+
+        if (size_t(ThreadsPerGemm) > M) {
+            ThreadsPerGemm = ptrdiff_t(M);
+        }
+
+        WorkBlock.ThreadCountM = ThreadsPerGemm;
+        WorkBlock.ThreadCountN = 1;
+    }
+
+    TargetThreadCount = ThreadsPerGemm * BatchSize;
+
+    MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [&](ptrdiff_t tid) {
+        const auto gemm_i = tid / ThreadsPerGemm;
+        const auto blk_i = tid % ThreadsPerGemm;
+        MlasQ4GemmThreaded(&WorkBlock, &Data[gemm_i], blk_i);
+    });
+}
+
+//
+// Portable kernel.
+//
+
+template<typename Traits>
+struct MlasQ4GemmDefault {
+
+    template<size_t RowCount, size_t ColCount>
+    static void
+    Tile(
+        const float* A,
+        size_t lda,
+        const uint8_t* PackedB,
+        size_t ldb,
+        float* C,
+        size_t ldc,
+        const float* Bias,
+        size_t K
+        )
+    {
+        constexpr size_t BlkLen = Traits::BlkLen;
+
+        for (size_t c = 0; c < ColCount; c++) {
+
+            float Accumulators[RowCount] = {};
+            const uint8_t* Blob = PackedB + c * ldb;
+
+            for (size_t k = 0; k < K; k += BlkLen) {
+
+                const size_t CountK = std::min(K - k, BlkLen);
+                const float Scale = MlasQ4BlobScale<Traits>(Blob);
+                const int ZeroPoint = MlasQ4BlobZeroPoint<Traits>(Blob);
+                const uint8_t* Data = MlasQ4BlobData<Traits>(Blob);
+
+                float Values[BlkLen];
+
+                for (size_t g = 0; g < BlkLen; g += 32) {
+                    for (size_t j = 0; j < 16; j++) {
+                        const uint8_t Byte = Data[g / 2 + j];
+                        Values[g + j] = Scale * float(int(Byte & 0x0F) - ZeroPoint);
+                        Values[g + j + 16] = Scale * float(int(Byte >> 4) - ZeroPoint);
+                    }
+                }
+
+                for (size_t r = 0; r < RowCount; r++) {
+                    const float* a = A + r * lda + k;
+                    for (size_t kk = 0; kk < CountK; kk++) {
+                        Accumulators[r] += a[kk] * Values[kk];
+                    }
+                }
+
+                Blob += MlasQ4BlobSize<Traits>();
+            }
+
+            for (size_t r = 0; r < RowCount; r++) {
+                C[r * ldc + c] = Accumulators[r] + (Bias != nullptr ? Bias[c] : 0.0f);
+            }
+        }
+    }
+
+    static void
+    Kernel(
+        const float* A,
+        size_t lda,
+        const uint8_t* PackedB,
+        size_t ldb,
+        float* C,
+        size_t ldc,
+        const float* Bias,
+        size_t CountM,
+        size_t CountN,
+        size_t K
+        )
+    {
+        MlasQ4GemmTiles<MlasQ4GemmDefault, 4, 1>(A, lda, PackedB, ldb, C, ldc, Bias, CountM, CountN, K);
+    }
+};
+
+void
+MlasQ4GemmKernelDefault(
+    MLAS_BLK_QUANT_TYPE QType,
+    const float* A,
+    size_t lda,
+    const uint8_t* PackedB,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    size_t CountM,
+    size_t CountN,
+    size_t K
+    )
+{
+    MlasQ4GemmKernelForType<MlasQ4GemmDefault>(QType, A, lda, PackedB, ldb, C, ldc, Bias, CountM, CountN, K);
+}
+
+const MLAS_Q4GEMM_DISPATCH MlasQ4GemmDispatchDefault = {
+    MlasQ4GemmKernelDefault,
+};
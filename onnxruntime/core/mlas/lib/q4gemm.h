@@ -0,0 +1,251 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    q4gemm.h
+
+Abstract:
+
+    This module defines the dispatch structure and the helper routines used
+    to implement the single precision matrix/matrix multiply operation with
+    block-wise 4-bit weights (Q4GEMM).
+
+    See MLAS_BLK_QUANT_TYPE for the layout of the packed matrix B. The blocks
+    of a column are contiguous, so the kernels stream down the columns of
+    matrix B, dequantize each block in registers and compute the dot products
+    with the rows of matrix A.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+#include <cstring>
+
+//
+// Define the properties of the quantization formats.
+//
+
+template<MLAS_BLK_QUANT_TYPE QType>
+struct MLAS_Q4_BLK_TRAITS;
+
+template<>
+struct MLAS_Q4_BLK_TRAITS<BlkQ4Sym32> {
+    static constexpr size_t BlkLen = 32;
+    static constexpr bool HasZeroPoint = false;
+};
+
+template<>
+struct MLAS_Q4_BLK_TRAITS<BlkQ4Zp32> {
+    static constexpr size_t BlkLen = 32;
+    static constexpr bool HasZeroPoint = true;
+};
+
+template<>
+struct MLAS_Q4_BLK_TRAITS<BlkQ4Sym128> {
+    static constexpr size_t BlkLen = 128;
+    static constexpr bool HasZeroPoint = false;
+};
+
+template<>
+struct MLAS_Q4_BLK_TRAITS<BlkQ4Zp128> {
+    static constexpr size_t BlkLen = 128;
+    static constexpr bool HasZeroPoint = true;
+};
+
+template<typename Traits>
+constexpr size_t
+MlasQ4BlobSize()
+{
+    return sizeof(float) + (Traits::HasZeroPoint ? 1 : 0) + Traits::BlkLen / 2;
+}
+
+template<typename Traits>
+MLAS_FORCEINLINE
+float
+MlasQ4BlobScale(
+    const uint8_t* Blob
+    )
+{
+    float Scale;
+    std::memcpy(&Scale, Blob, sizeof(float));
+    return Scale;
+}
+
+template<typename Traits>
+MLAS_FORCEINLINE
+uint8_t
+MlasQ4BlobZeroPoint(
+    const uint8_t* Blob
+    )
+{
+    return Traits::HasZeroPoint ? Blob[sizeof(float)] : 8;
+}
+
+template<typename Traits>
+MLAS_FORCEINLINE
+const uint8_t*
+MlasQ4BlobData(
+    const uint8_t* Blob
+    )
+{
+    return Blob + sizeof(float) + (Traits::HasZeroPoint ? 1 : 0);
+}
+
+/**
+ * @brief Copies the rows of matrix A for the last block of K, which may be
+ *        shorter than the block, zero filled to the block length.
+ */
+template<typename Traits>
+MLAS_FORCEINLINE
+void
+MlasQ4GemmCopyTailA(
+    const float* A,
+    size_t lda,
+    size_t RowCount,
+    size_t CountK,
+    float* TailA
+    )
+{
+    for (size_t r = 0; r < RowCount; r++) {
+        std::copy_n(A + r * lda, CountK, TailA + r * Traits::BlkLen);
+        std::fill_n(TailA + r * Traits::BlkLen + CountK, Traits::BlkLen - CountK, 0.0f);
+    }
+}
+
+//
+// Define the prototypes of the platform optimized routines.
+//
+
+/**
+ * @brief Computes a block of the matrix product C := A * B + Bias.
+ *
+ * @param QType     Supplies the quantization format of matrix B.
+ * @param A         Supplies the block of matrix A.
+ * @param lda       Supplies the first dimension of matrix A.
+ * @param PackedB   Supplies the blobs of the first column of the block.
+ * @param ldb       Supplies the number of bytes between the columns of the
+ *                  packed matrix B.
+ * @param C         Supplies the block of matrix C.
+ * @param ldc       Supplies the first dimension of matrix C.
+ * @param Bias      Supplies the optional bias of the first column.
+ * @param CountM    Supplies the number of rows of the block.
+ * @param CountN    Supplies the number of columns of the block.
+ * @param K         Supplies the number of columns of matrix A.
+ */
+typedef
+void
+(MLAS_Q4GEMM_KERNEL)(
+    MLAS_BLK_QUANT_TYPE QType,
+    const float* A,
+    size_t lda,
+    const uint8_t* PackedB,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    size_t CountM,
+    size_t CountN,
+    size_t K
+    );
+
+struct MLAS_Q4GEMM_DISPATCH {
+    MLAS_Q4GEMM_KERNEL* Kernel;
+};
+
+/**
+ * @brief Expands the quantization format to the Traits template argument of
+ *        a kernel implementation.
+ */
+template<template<typename> class KernelType>
+MLAS_FORCEINLINE
+void
+MlasQ4GemmKernelForType(
+    MLAS_BLK_QUANT_TYPE QType,
+    const float* A,
+    size_t lda,
+    const uint8_t* PackedB,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    size_t CountM,
+    size_t CountN,
+    size_t K
+    )
+{
+    switch (QType) {
+        case BlkQ4Sym32:
+            KernelType<MLAS_Q4_BLK_TRAITS<BlkQ4Sym32>>::Kernel(A, lda, PackedB, ldb, C, ldc, Bias, CountM, CountN, K);
+            break;
+        case BlkQ4Zp32:
+            KernelType<MLAS_Q4_BLK_TRAITS<BlkQ4Zp32>>::Kernel(A, lda, PackedB, ldb, C, ldc, Bias, CountM, CountN, K);
+            break;
+        case BlkQ4Sym128:
+            KernelType<MLAS_Q4_BLK_TRAITS<BlkQ4Sym128>>::Kernel(A, lda, PackedB, ldb, C, ldc, Bias, CountM, CountN, K);
+            break;
+        case BlkQ4Zp128:
+            KernelType<MLAS_Q4_BLK_TRAITS<BlkQ4Zp128>>::Kernel(A, lda, PackedB, ldb, C, ldc, Bias, CountM, CountN, K);
+            break;
+    }
+}
+
+/**
+ * @brief Runs the rows and columns of a kernel block in tiles of RowCount x
+ *        ColCount, with single row and single column tiles for the remainder.
+ *
+ *        KernelType::Tile<RowCount, ColCount> computes one tile over all of K.
+ */
+template<typename KernelType, size_t RowCount, size_t ColCount>
+MLAS_FORCEINLINE
+void
+MlasQ4GemmTiles(
+    const float* A,
+    size_t lda,
+    const uint8_t* PackedB,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    size_t CountM,
+    size_t CountN,
+    size_t K
+    )
+{
+    size_t m = 0;
+
+    for (; m + RowCount <= CountM; m += RowCount) {
+
+        size_t n = 0;
+
+        for (; n + ColCount <= CountN; n += ColCount) {
+            KernelType::template Tile<RowCount, ColCount>(A + m * lda, lda, PackedB + n * ldb, ldb,
+                C + m * ldc + n, ldc, Bias != nullptr ? Bias + n : nullptr, K);
+        }
+
+        for (; n < CountN; n++) {
+            KernelType::template Tile<RowCount, 1>(A + m * lda, lda, PackedB + n * ldb, ldb,
+                C + m * ldc + n, ldc, Bias != nullptr ? Bias + n : nullptr, K);
+        }
+    }
+
+    for (; m < CountM; m++) {
+
+        size_t n = 0;
+
+        for (; n + ColCount <= CountN; n += ColCount) {
+            KernelType::template Tile<1, ColCount>(A + m * lda, lda, PackedB + n * ldb, ldb,
+                C + m * ldc + n, ldc, Bias != nullptr ? Bias + n : nullptr, K);
+        }
+
+        for (; n < CountN; n++) {
+            KernelType::template Tile<1, 1>(A + m * lda, lda, PackedB + n * ldb, ldb,
+                C + m * ldc + n, ldc, Bias != nullptr ? Bias + n : nullptr, K);
+        }
+    }
+}
@@ -0,0 +1,162 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    q4gemm_kernel_neon.cpp
+
+Abstract:
+
+    This module implements the kernel for the single precision matrix/matrix
+    multiply operation with block-wise 4-bit weights (Q4GEMM) using ARM NEON
+    intrinsics.
+
+    The 16 bytes of a group of 32 elements are split into the low and the
+    high nibbles, widened to eight vectors of 4 elements and dequantized with
+    a single multiply add. Each dequantized vector is used for all of the rows
+    of the tile.
+
+--*/
+
+#include "q4gemm.h"
+
+template<typename Traits>
+struct MlasQ4GemmNeon {
+
+    template<size_t RowCount, size_t ColCount>
+    static void
+    Tile(
+        const float* A,
+        size_t lda,
+        const uint8_t* PackedB,
+        size_t ldb,
+        float* C,
+        size_t ldc,
+        const float* Bias,
+        size_t K
+        )
+    {
+        constexpr size_t BlkLen = Traits::BlkLen;
+
+        MLAS_DECLSPEC_ALIGN(float TailA[RowCount * BlkLen], 16);
+
+        float32x4_t Accumulators[RowCount][ColCount];
+
+        MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+            MlasLoopUnroll<ColCount>::Iterate([&](size_t c) {
+                Accumulators[r][c] = vdupq_n_f32(0.0f);
+            });
+        });
+
+        const uint8_t* Blob = PackedB;
+
+        for (size_t k = 0; k < K; k += BlkLen) {
+
+            const float* a = A + k;
+            size_t ld = lda;
+
+            if (K - k < BlkLen) {
+                MlasQ4GemmCopyTailA<Traits>(a, lda, RowCount, K - k, TailA);
+                a = TailA;
+                ld = BlkLen;
+            }
+
+            float32x4_t Scale[ColCount];
+            float32x4_t Offset[ColCount];
+
+            MlasLoopUnroll<ColCount>::Iterate([&](size_t c) {
+                const uint8_t* b = Blob + c * ldb;
+                const float s = MlasQ4BlobScale<Traits>(b);
+                Scale[c] = vdupq_n_f32(s);
+                Offset[c] = vdupq_n_f32(-s * float(MlasQ4BlobZeroPoint<Traits>(b)));
+            });
+
+            for (size_t g = 0; g < BlkLen; g += 32) {
+
+                uint16x8_t Nibbles[4][ColCount];
+
+                MlasLoopUnroll<ColCount>::Iterate([&](size_t c) {
+                    uint8x16_t Bytes = vld1q_u8(MlasQ4BlobData<Traits>(Blob + c * ldb) + g / 2);
+                    uint8x16_t Low = vandq_u8(Bytes, vdupq_n_u8(0x0F));
+                    uint8x16_t High = vshrq_n_u8(Bytes, 4);
+                    Nibbles[0][c] = vmovl_u8(vget_low_u8(Low));
+                    Nibbles[1][c] = vmovl_u8(vget_high_u8(Low));
+                    Nibbles[2][c] = vmovl_u8(vget_low_u8(High));
+                    Nibbles[3][c] = vmovl_u8(vget_high_u8(High));
+                });
+
+                MlasLoopUnroll<8>::Iterate([&](size_t q) {
+
+                    float32x4_t BElements[ColCount];
+
+                    MlasLoopUnroll<ColCount>::Iterate([&](size_t c) {
+                        uint32x4_t Widened = (q % 2 == 0) ? vmovl_u16(vget_low_u16(Nibbles[q / 2][c]))
+                                                          : vmovl_u16(vget_high_u16(Nibbles[q / 2][c]));
+                        BElements[c] = vfmaq_f32(Offset[c], vcvtq_f32_u32(Widened), Scale[c]);
+                    });
+
+                    MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+                        float32x4_t AElements = vld1q_f32(a + r * ld + g + q * 4);
+                        MlasLoopUnroll<ColCount>::Iterate([&](size_t c) {
+                            Accumulators[r][c] = vfmaq_f32(Accumulators[r][c], AElements, BElements[c]);
+                        });
+                    });
+                });
+            }
+
+            Blob += MlasQ4BlobSize<Traits>();
+        }
+
+        MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+            MlasLoopUnroll<ColCount>::Iterate([&](size_t c) {
+                float Sum = vaddvq_f32(Accumulators[r][c]);
+                if (Bias != nullptr) {
+                    Sum += Bias[c];
+                }
+                C[r * ldc + c] = Sum;
+            });
+        });
+    }
+
+    static void
+    Kernel(
+        const float* A,
+        size_t lda,
+        const uint8_t* PackedB,
+        size_t ldb,
+        float* C,
+        size_t ldc,
+        const float* Bias,
+        size_t CountM,
+        size_t CountN,
+        size_t K
+        )
+    {
+        MlasQ4GemmTiles<MlasQ4GemmNeon, 4, 4>(A, lda, PackedB, ldb, C, ldc, Bias, CountM, CountN, K);
+    }
+};
+
+void
+MlasQ4GemmKernelNeon(
+    MLAS_BLK_QUANT_TYPE QType,
+    const float* A,
+    size_t lda,
+    const uint8_t* PackedB,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    size_t CountM,
+    size_t CountN,
+    size_t K
+    )
+{
+    MlasQ4GemmKernelForType<MlasQ4GemmNeon>(QType, A, lda, PackedB, ldb, C, ldc, Bias, CountM, CountN, K);
+}
+
+const MLAS_Q4GEMM_DISPATCH MlasQ4GemmDispatchNeon = {
+    MlasQ4GemmKernelNeon,
+};
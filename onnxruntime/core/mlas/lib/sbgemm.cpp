@@ -0,0 +1,407 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sbgemm.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation with bfloat16 weights (SBGEMM) and the portable kernel used on
+    platforms without an optimized kernel.
+
+--*/
+
+#include "mlasi.h"
+#include "sbgemm.h"
+
+//
+// Define the parameters to execute segments of a SBGEMM operation on worker
+// threads.
+//
+
+struct MLAS_SBGEMM_WORK_BLOCK {
+    ptrdiff_t ThreadCountM;
+    ptrdiff_t ThreadCountN;
+    CBLAS_TRANSPOSE TransA;
+    size_t M;
+    size_t N;
+    size_t K;
+};
+
+void
+MlasSBGemmOperation(
+    const MLAS_SBGEMM_WORK_BLOCK* WorkBlock,
+    const MLAS_SBGEMM_DATA_PARAMS* Data,
+    size_t RangeStartM,
+    size_t RangeCountM,
+    size_t RangeStartN,
+    size_t RangeCountN
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the SBGEMM operation over a range of matrix C.
+
+    The products are accumulated in a single precision block, which is scaled
+    and stored to matrix C once all of K is done.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the GEMM shape.
+
+    Data - Supplies the structure containing the GEMM input and output data.
+
+    RangeStartM - Supplies the starting row index to output.
+
+    RangeCountM - Supplies the number of rows to output.
+
+    RangeStartN - Supplies the starting column index to output.
+
+    RangeCountN - Supplies the number of columns to output.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_SBGEMM_DISPATCH* Dispatch = GetMlasPlatform().SBGemmDispatch;
+
+    MLAS_DECLSPEC_ALIGN(float PanelA[MLAS_SBGEMM_STRIDEM * MLAS_SBGEMM_STRIDEK], 64);
+    MLAS_DECLSPEC_ALIGN(float Accumulators[MLAS_SBGEMM_STRIDEM * MLAS_SBGEMM_STRIDEN], 64);
+
+    const size_t K = WorkBlock->K;
+    const size_t lda = Data->lda;
+    const size_t ldc = Data->ldc;
+    const size_t PanelStride = K * MLAS_SBGEMM_PANEL_N;
+    const float alpha = Data->alpha;
+    const float beta = Data->beta;
+    const uint16_t* PackedB = static_cast<const uint16_t*>(Data->B);
+
+    for (size_t n = 0; n < RangeCountN;) {
+
+        const size_t CountN = std::min(RangeCountN - n, size_t(MLAS_SBGEMM_STRIDEN));
+        const size_t PaddedCountN = (CountN + MLAS_SBGEMM_PANEL_N - 1) & ~(MLAS_SBGEMM_PANEL_N - 1);
+        const uint16_t* b = PackedB + ((RangeStartN + n) / MLAS_SBGEMM_PANEL_N) * PanelStride;
+
+        for (size_t m = 0; m < RangeCountM;) {
+
+            const size_t CountM = std::min(RangeCountM - m, size_t(MLAS_SBGEMM_STRIDEM));
+            const size_t StartM = RangeStartM + m;
+
+            if (K == 0) {
+                std::fill_n(Accumulators, CountM * MLAS_SBGEMM_STRIDEN, 0.0f);
+            }
+
+            for (size_t k = 0; k < K;) {
+
+                const size_t CountK = std::min(K - k, size_t(MLAS_SBGEMM_STRIDEK));
+
+                //
+                // Matrix A is read in place unless it must be transposed.
+                //
+
+                const float* a;
+                size_t PanelLda;
+
+                if (WorkBlock->TransA == CblasNoTrans) {
+                    a = Data->A + StartM * lda + k;
+                    PanelLda = lda;
+                } else {
+                    for (size_t mm = 0; mm < CountM; mm++) {
+                        for (size_t kk = 0; kk < CountK; kk++) {
+                            PanelA[mm * CountK + kk] = Data->A[(k + kk) * lda + StartM + mm];
+                        }
+                    }
+                    a = PanelA;
+                    PanelLda = CountK;
+                }
+
+                Dispatch->Kernel(a, PanelLda, b + k * MLAS_SBGEMM_PANEL_N, PanelStride,
+                                 Accumulators, MLAS_SBGEMM_STRIDEN, CountM, PaddedCountN, CountK, k == 0);
+
+                k += CountK;
+            }
+
+            //
+            // Scale the accumulators and store them to the output.
+            //
+
+            for (size_t mm = 0; mm < CountM; mm++) {
+
+                const float* acc = Accumulators + mm * MLAS_SBGEMM_STRIDEN;
+                float* c = Data->C + (StartM + mm) * ldc + RangeStartN + n;
+
+                if (beta != 0.0f) {
+                    for (size_t nn = 0; nn < CountN; nn++) {
+                        c[nn] = alpha * acc[nn] + beta * c[nn];
+                    }
+                } else if (alpha != 1.0f) {
+                    for (size_t nn = 0; nn < CountN; nn++) {
+                        c[nn] = alpha * acc[nn];
+                    }
+                } else {
+                    std::copy_n(acc, CountN, c);
+                }
+            }
+
+            m += CountM;
+        }
+
+        n += CountN;
+    }
+}
+
+void
+MlasSBGemmThreaded(
+    const MLAS_SBGEMM_WORK_BLOCK* WorkBlock,
+    const MLAS_SBGEMM_DATA_PARAMS* Data,
+    ptrdiff_t ThreadId
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    SBGEMM operation.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the thread task partition
+        info and the GEMM shape.
+
+    Data - Supplies the structure containing the GEMM input and output data.
+
+    ThreadId - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const ptrdiff_t ThreadIdM = ThreadId / WorkBlock->ThreadCountN;
+    const ptrdiff_t ThreadIdN = ThreadId % WorkBlock->ThreadCountN;
+
+    //
+    // Partition the operation along the M dimension.
+    //
+
+    size_t RangeStartM;
+    size_t RangeCountM;
+
+    MlasPartitionWork(ThreadIdM, WorkBlock->ThreadCountM, WorkBlock->M, &RangeStartM, &RangeCountM);
+
+    //
+    // Partition the operation along the N dimension. The ranges start on a
+    // packed panel of matrix B.
+    //
+
+    size_t RangeStartN;
+    size_t RangeCountN;
+
+    const size_t N = WorkBlock->N;
+    const size_t BlockedN = (N + MLAS_SBGEMM_STRIDEN_THREAD_ALIGN - 1) /
+        MLAS_SBGEMM_STRIDEN_THREAD_ALIGN;
+
+    MlasPartitionWork(ThreadIdN, WorkBlock->ThreadCountN, BlockedN, &RangeStartN, &RangeCountN);
+
+    RangeStartN *= MLAS_SBGEMM_STRIDEN_THREAD_ALIGN;
+    RangeCountN *= MLAS_SBGEMM_STRIDEN_THREAD_ALIGN;
+
+    RangeCountN = std::min(N - RangeStartN, RangeCountN);
+
+    MlasSBGemmOperation(WorkBlock, Data, RangeStartM, RangeCountM, RangeStartN, RangeCountN);
+}
+
+void
+MLASCALL
+MlasSBGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SBGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    static_assert(MLAS_SBGEMM_STRIDEN % MLAS_SBGEMM_PANEL_N == 0, "StrideN must be a multiple of the panel width");
+    static_assert(MLAS_SBGEMM_STRIDEN_THREAD_ALIGN % MLAS_SBGEMM_PANEL_N == 0,
+                  "threads must start on a panel of packed B");
+
+    if (M == 0 || N == 0 || BatchSize == 0) {
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K) * double(BatchSize);
+
+    ptrdiff_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SBGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
+        TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SBGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
+    }
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    ptrdiff_t ThreadsPerGemm = TargetThreadCount / BatchSize;
+    if (ThreadsPerGemm < 1) {
+        ThreadsPerGemm = 1;
+    }
+
+    //
+    // Segment the operation across multiple threads.
+    //
+    // N.B. Currently, the operation is segmented as a 1D partition, which
+    // works okay for operations involving skinny matrices.
+    //
+
+    MLAS_SBGEMM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+
+    if (N > M) {
+
+        const size_t BlockedN = (N + MLAS_SBGEMM_STRIDEN_THREAD_ALIGN - 1) /
+            MLAS_SBGEMM_STRIDEN_THREAD_ALIGN;
+
+        if (size_t(ThreadsPerGemm) > BlockedN) {
+            ThreadsPerGemm = ptrdiff_t(BlockedN);
+        }
+
+        WorkBlock.ThreadCountM = 1;
+        WorkBlock.ThreadCountN = ThreadsPerGemm;
+
+    } else {
+
+        if (size_t(ThreadsPerGemm) > M) {
+            ThreadsPerGemm = ptrdiff_t(M);
+        }
+
+        WorkBlock.ThreadCountM = ThreadsPerGemm;
+        WorkBlock.ThreadCountN = 1;
+    }
+
+    TargetThreadCount = ThreadsPerGemm * BatchSize;
+
+    MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [&](ptrdiff_t tid) {
+        const auto gemm_i = tid / ThreadsPerGemm;
+        const auto blk_i = tid % ThreadsPerGemm;
+        MlasSBGemmThreaded(&WorkBlock, &Data[gemm_i], blk_i);
+    });
+}
+
+size_t
+MLASCALL
+MlasSBGemmPackBSize(
+    size_t N,
+    size_t K
+    )
+{
+    const size_t PanelCount = (N + MLAS_SBGEMM_PANEL_N - 1) / MLAS_SBGEMM_PANEL_N;
+    const size_t BytesRequired = PanelCount * K * MLAS_SBGEMM_PANEL_N * sizeof(uint16_t);
+    const size_t BufferAlignment = MlasGetPreferredBufferAlignment();
+    const size_t AlignedBytesRequired = (BytesRequired + BufferAlignment - 1) &
+        ~(BufferAlignment - 1);
+
+    return AlignedBytesRequired;
+}
+
+void
+MLASCALL
+MlasSBGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+{
+    const size_t PanelCount = (N + MLAS_SBGEMM_PANEL_N - 1) / MLAS_SBGEMM_PANEL_N;
+    uint16_t* d = static_cast<uint16_t*>(PackedB);
+
+    for (size_t panel = 0; panel < PanelCount; panel++) {
+
+        const size_t n = panel * MLAS_SBGEMM_PANEL_N;
+        const size_t CountN = std::min(N - n, MLAS_SBGEMM_PANEL_N);
+
+        for (size_t k = 0; k < K; k++) {
+
+            for (size_t nn = 0; nn < CountN; nn++) {
+                const float Value = (TransB == CblasNoTrans) ? B[k * ldb + n + nn] : B[(n + nn) * ldb + k];
+                d[nn] = MlasFloatToBFloat16(Value);
+            }
+
+            std::fill_n(d + CountN, MLAS_SBGEMM_PANEL_N - CountN, uint16_t(0));
+            d += MLAS_SBGEMM_PANEL_N;
+        }
+    }
+}
+
+//
+// Portable kernel.
+//
+
+void
+MlasSBGemmKernelDefault(
+    const float* A,
+    size_t lda,
+    const uint16_t* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    bool ZeroMode
+    )
+{
+    for (size_t m = 0; m < CountM; m++) {
+
+        for (size_t n = 0; n < CountN; n += MLAS_SBGEMM_PANEL_N) {
+
+            float Accumulators[MLAS_SBGEMM_PANEL_N];
+            const uint16_t* b = PackedB + (n / MLAS_SBGEMM_PANEL_N) * PanelStride;
+            float* c = C + m * ldc + n;
+
+            for (size_t nn = 0; nn < MLAS_SBGEMM_PANEL_N; nn++) {
+                Accumulators[nn] = ZeroMode ? 0.0f : c[nn];
+            }
+
+            for (size_t k = 0; k < CountK; k++) {
+                const float ak = A[m * lda + k];
+                for (size_t nn = 0; nn < MLAS_SBGEMM_PANEL_N; nn++) {
+                    Accumulators[nn] += ak * MlasBFloat16ToFloat(b[nn]);
+                }
+                b += MLAS_SBGEMM_PANEL_N;
+            }
+
+            std::copy_n(Accumulators, MLAS_SBGEMM_PANEL_N, c);
+        }
+    }
+}
+
+const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchDefault = {
+    MlasSBGemmKernelDefault,
+};
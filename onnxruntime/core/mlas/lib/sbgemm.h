@@ -0,0 +1,113 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sbgemm.h
+
+Abstract:
+
+    This module defines the dispatch structure and the helper routines used
+    to implement the single precision matrix/matrix multiply operation with
+    bfloat16 weights (SBGEMM).
+
+    Matrix B is rounded to bfloat16 when it is packed, in panels of
+    MLAS_SBGEMM_PANEL_N columns: each panel stores K rows of
+    MLAS_SBGEMM_PANEL_N elements, with the columns past N zero filled. The
+    kernels widen the panels back to single precision with a shift, which is
+    exact, and accumulate the products in single precision.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+#include <cstring>
+
+//
+// Define the number of columns in a panel of packed matrix B.
+//
+
+constexpr size_t MLAS_SBGEMM_PANEL_N = 16;
+
+//
+// Define the prototypes of the platform optimized routines.
+//
+
+/**
+ * @brief Computes a block of the matrix product.
+ *
+ * @param A             Supplies the block of matrix A.
+ * @param lda           Supplies the first dimension of the block of matrix A.
+ * @param PackedB       Supplies the first packed panel of matrix B, starting at
+ *                      the first row of the block.
+ * @param PanelStride   Supplies the number of elements between consecutive
+ *                      panels of packed matrix B.
+ * @param C             Supplies the single precision accumulator block.
+ * @param ldc           Supplies the first dimension of the accumulator block.
+ * @param CountM        Supplies the number of rows of the block.
+ * @param CountN        Supplies the number of columns of the block, rounded up
+ *                      to a multiple of MLAS_SBGEMM_PANEL_N.
+ * @param CountK        Supplies the number of columns of matrix A and rows of
+ *                      matrix B in the block.
+ * @param ZeroMode      Supplies true if the accumulator block is initialized,
+ *                      else false if the products are added to it.
+ */
+typedef
+void
+(MLAS_SBGEMM_KERNEL)(
+    const float* A,
+    size_t lda,
+    const uint16_t* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    bool ZeroMode
+    );
+
+struct MLAS_SBGEMM_DISPATCH {
+    MLAS_SBGEMM_KERNEL* Kernel;
+};
+
+//
+// Portable conversions between bfloat16 and single precision values.
+// Conversions to bfloat16 round to nearest even and keep NaNs quiet.
+//
+
+MLAS_FORCEINLINE
+float
+MlasBFloat16ToFloat(
+    uint16_t Value
+    )
+{
+    const uint32_t Bits = uint32_t(Value) << 16;
+
+    float Float;
+    std::memcpy(&Float, &Bits, sizeof(float));
+    return Float;
+}
+
+MLAS_FORCEINLINE
+uint16_t
+MlasFloatToBFloat16(
+    float Value
+    )
+{
+    uint32_t Bits;
+    std::memcpy(&Bits, &Value, sizeof(float));
+
+    if ((Bits & 0x7FFFFFFF) > 0x7F800000) {
+        return uint16_t((Bits >> 16) | 0x0040);
+    }
+
+    Bits += 0x7FFF + ((Bits >> 16) & 1);
+
+    return uint16_t(Bits >> 16);
+}
@@ -0,0 +1,138 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sbgemm_kernel_neon.cpp
+
+Abstract:
+
+    This module implements the kernel for the single precision matrix/matrix
+    multiply operation with bfloat16 weights (SBGEMM) using ARM NEON
+    intrinsics.
+
+    The panels of matrix B are widened to single precision in registers with a
+    long shift left, the products are accumulated in single precision.
+
+--*/
+
+#include "sbgemm.h"
+
+//
+// Define the number of rows of matrix A processed per iteration: each row
+// uses four accumulators for the 16 columns of a panel.
+//
+
+constexpr size_t MLAS_SBGEMM_NEON_ROWS = 6;
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasSBGemmKernelNeonRows(
+    const float* A,
+    size_t lda,
+    const uint16_t* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    size_t CountK,
+    bool ZeroMode
+    )
+{
+    for (size_t n = 0; n < CountN; n += MLAS_SBGEMM_PANEL_N) {
+
+        float32x4_t Accumulators[4][RowCount];
+
+        MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+            MlasLoopUnroll<4>::Iterate([&](size_t i) {
+                Accumulators[i][r] = vdupq_n_f32(0.0f);
+            });
+        });
+
+        const uint16_t* b = PackedB + (n / MLAS_SBGEMM_PANEL_N) * PanelStride;
+        const float* a = A;
+
+        for (size_t k = 0; k < CountK; k++) {
+
+            uint16x8_t BPacked0 = vld1q_u16(b);
+            uint16x8_t BPacked1 = vld1q_u16(b + 8);
+
+            float32x4_t BElements[4] = {
+                vreinterpretq_f32_u32(vshll_n_u16(vget_low_u16(BPacked0), 16)),
+                vreinterpretq_f32_u32(vshll_n_u16(vget_high_u16(BPacked0), 16)),
+                vreinterpretq_f32_u32(vshll_n_u16(vget_low_u16(BPacked1), 16)),
+                vreinterpretq_f32_u32(vshll_n_u16(vget_high_u16(BPacked1), 16)),
+            };
+
+            MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+                float32x4_t ABroadcast = vld1q_dup_f32(a + r * lda);
+                MlasLoopUnroll<4>::Iterate([&](size_t i) {
+                    Accumulators[i][r] = vfmaq_f32(Accumulators[i][r], ABroadcast, BElements[i]);
+                });
+            });
+
+            a += 1;
+            b += MLAS_SBGEMM_PANEL_N;
+        }
+
+        MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+
+            float* c = C + r * ldc + n;
+
+            MlasLoopUnroll<4>::Iterate([&](size_t i) {
+                if (!ZeroMode) {
+                    Accumulators[i][r] = vaddq_f32(Accumulators[i][r], vld1q_f32(c + i * 4));
+                }
+                vst1q_f32(c + i * 4, Accumulators[i][r]);
+            });
+        });
+    }
+}
+
+void
+MlasSBGemmKernelNeon(
+    const float* A,
+    size_t lda,
+    const uint16_t* PackedB,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    bool ZeroMode
+    )
+{
+    while (CountM >= MLAS_SBGEMM_NEON_ROWS) {
+        MlasSBGemmKernelNeonRows<MLAS_SBGEMM_NEON_ROWS>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+        A += MLAS_SBGEMM_NEON_ROWS * lda;
+        C += MLAS_SBGEMM_NEON_ROWS * ldc;
+        CountM -= MLAS_SBGEMM_NEON_ROWS;
+    }
+
+    switch (CountM) {
+        case 1:
+            MlasSBGemmKernelNeonRows<1>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+        case 2:
+            MlasSBGemmKernelNeonRows<2>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+        case 3:
+            MlasSBGemmKernelNeonRows<3>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+        case 4:
+            MlasSBGemmKernelNeonRows<4>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+        case 5:
+            MlasSBGemmKernelNeonRows<5>(A, lda, PackedB, PanelStride, C, ldc, CountN, CountK, ZeroMode);
+            break;
+    }
+}
+
+const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchNeon = {
+    MlasSBGemmKernelNeon,
+};
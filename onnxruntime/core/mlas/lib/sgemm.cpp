@@ -16,6 +16,12 @@ Abstract:
 --*/
 
 #include "mlasi.h"
+#include "sgemm_small.h"
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
 //
 // Define the number of rows from matrix A to transpose to a local buffer.
@@ -1552,25 +1558,99 @@ Return Value:
             DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc);
     }
 }
+
+//
+// Define the key of a recorded thread partition. The partition depends on the
+// shape of the multiplication and on the number of threads of the thread pool.
+//
+
+struct MLAS_SGEMM_THREAD_PARTITION_KEY {
+    CBLAS_TRANSPOSE TransA;
+    CBLAS_TRANSPOSE TransB;
+    size_t M;
+    size_t N;
+    size_t K;
+    size_t BatchSize;
+    ptrdiff_t ThreadCount;
+
+    bool operator==(const MLAS_SGEMM_THREAD_PARTITION_KEY& Other) const
+    {
+        return TransA == Other.TransA && TransB == Other.TransB && M == Other.M &&
+            N == Other.N && K == Other.K && BatchSize == Other.BatchSize &&
+            ThreadCount == Other.ThreadCount;
+    }
+};
+
+struct MLAS_SGEMM_THREAD_PARTITION_KEY_HASH {
+    size_t operator()(const MLAS_SGEMM_THREAD_PARTITION_KEY& Key) const
+    {
+        size_t Hash = size_t(Key.TransA) * 2 + size_t(Key.TransB);
+        for (size_t Value : {Key.M, Key.N, Key.K, Key.BatchSize, size_t(Key.ThreadCount)}) {
+            Hash ^= Value + size_t(0x9e3779b9) + (Hash << 6) + (Hash >> 2);
+        }
+        return Hash;
+    }
+};
+
+//
+// Stores the thread partitions recorded with MlasGemmSetThreadPartition. The
+// flag lets MlasGemmBatch skip the lock while no partition is recorded.
+//
+
+struct MLAS_SGEMM_THREAD_PARTITION_CACHE {
+    std::shared_mutex Lock;
+    std::atomic<bool> HasPartitions{false};
+    std::unordered_map<MLAS_SGEMM_THREAD_PARTITION_KEY, MLAS_SGEMM_THREAD_PARTITION,
+        MLAS_SGEMM_THREAD_PARTITION_KEY_HASH> Partitions;
+};
+
+static
+MLAS_SGEMM_THREAD_PARTITION_CACHE&
+MlasSgemmGetThreadPartitionCache(
+    void
+    )
+{
+    static MLAS_SGEMM_THREAD_PARTITION_CACHE ThreadPartitionCache;
+    return ThreadPartitionCache;
+}
+
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(push)
 // Chance of arithmetic overflow could be reduced
 #pragma warning(disable : 26451)
 #endif
+static
 void
-MLASCALL
-MlasGemmBatch(
-    CBLAS_TRANSPOSE TransA,
-    CBLAS_TRANSPOSE TransB,
+MlasSgemmGetDefaultThreadPartition(
     size_t M,
     size_t N,
     size_t K,
-    const MLAS_SGEMM_DATA_PARAMS* Data,
     size_t BatchSize,
-    MLAS_THREADPOOL* ThreadPool
+    ptrdiff_t MaximumThreadCount,
+    MLAS_SGEMM_THREAD_PARTITION* Partition
     )
-{
+/*++
+
+Routine Description:
+
+    This routine computes the default thread partition of a SGEMM operation.
+
+Arguments:
+
+    M, N, K - Supplies the shape of the multiplication.
+
+    BatchSize - Supplies the number of multiplications in the batch.
+
+    MaximumThreadCount - Supplies the number of threads of the thread pool.
+
+    Partition - Receives the thread partition.
+
+Return Value:
 
+    None.
+
+--*/
+{
     //
     // Compute the number of target threads given the complexity of the SGEMM
     // operation. Small requests should run using the single threaded path.
@@ -1586,8 +1666,6 @@ MlasGemmBatch(
         TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
     }
 
-    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
-
     if (TargetThreadCount >= MaximumThreadCount) {
         TargetThreadCount = MaximumThreadCount;
     }
@@ -1600,8 +1678,6 @@ MlasGemmBatch(
     //
 
     ptrdiff_t ThreadsPerGemm = (TargetThreadCount + BatchSize - 1) / BatchSize;
-    ptrdiff_t ThreadCountM;
-    ptrdiff_t ThreadCountN;
 
     if (N > M) {
 
@@ -1612,8 +1688,8 @@ MlasGemmBatch(
             ThreadsPerGemm = ptrdiff_t(BlockedN);
         }
 
-        ThreadCountM = 1;
-        ThreadCountN = ThreadsPerGemm;
+        Partition->ThreadCountM = 1;
+        Partition->ThreadCountN = ThreadsPerGemm;
 
     } else {
 
@@ -1621,9 +1697,110 @@ MlasGemmBatch(
             ThreadsPerGemm = ptrdiff_t(M);
         }
 
-        ThreadCountM = ThreadsPerGemm;
-        ThreadCountN = 1;
+        Partition->ThreadCountM = ThreadsPerGemm;
+        Partition->ThreadCountN = 1;
     }
+}
+
+bool
+MLASCALL
+MlasGemmGetThreadPartition(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    size_t BatchSize,
+    MLAS_SGEMM_THREAD_PARTITION* Partition,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    const ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    MLAS_SGEMM_THREAD_PARTITION_CACHE& Cache = MlasSgemmGetThreadPartitionCache();
+
+    if (Cache.HasPartitions.load(std::memory_order_acquire)) {
+
+        const MLAS_SGEMM_THREAD_PARTITION_KEY Key{TransA, TransB, M, N, K, BatchSize, MaximumThreadCount};
+
+        std::shared_lock<std::shared_mutex> SharedLock(Cache.Lock);
+
+        auto it = Cache.Partitions.find(Key);
+
+        if (it != Cache.Partitions.end()) {
+            *Partition = it->second;
+            return true;
+        }
+    }
+
+    MlasSgemmGetDefaultThreadPartition(M, N, K, BatchSize, MaximumThreadCount, Partition);
+
+    return false;
+}
+
+void
+MLASCALL
+MlasGemmSetThreadPartition(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    size_t BatchSize,
+    const MLAS_SGEMM_THREAD_PARTITION& Partition,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    const MLAS_SGEMM_THREAD_PARTITION_KEY Key{TransA, TransB, M, N, K, BatchSize,
+        MlasGetMaximumThreadCount(ThreadPool)};
+
+    MLAS_SGEMM_THREAD_PARTITION_CACHE& Cache = MlasSgemmGetThreadPartitionCache();
+
+    std::unique_lock<std::shared_mutex> ExclusiveLock(Cache.Lock);
+
+    Cache.Partitions[Key] = Partition;
+    Cache.HasPartitions.store(true, std::memory_order_release);
+}
+
+void
+MLASCALL
+MlasGemmClearThreadPartitions(
+    void
+    )
+{
+    MLAS_SGEMM_THREAD_PARTITION_CACHE& Cache = MlasSgemmGetThreadPartitionCache();
+
+    std::unique_lock<std::shared_mutex> ExclusiveLock(Cache.Lock);
+
+    Cache.Partitions.clear();
+    Cache.HasPartitions.store(false, std::memory_order_release);
+}
+
+void
+MLASCALL
+MlasGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    const MLAS_SGEMM_THREAD_PARTITION& Partition,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    //
+    // Clamp the partition to the rows and the aligned column blocks of the
+    // multiplication, so that every thread has work to do.
+    //
+
+    const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
+        MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+    const ptrdiff_t ThreadCountM = std::max<ptrdiff_t>(std::min<ptrdiff_t>(Partition.ThreadCountM, ptrdiff_t(M)), 1);
+    const ptrdiff_t ThreadCountN = std::max<ptrdiff_t>(std::min<ptrdiff_t>(Partition.ThreadCountN, ptrdiff_t(BlockedN)), 1);
+    const ptrdiff_t ThreadsPerGemm = ThreadCountM * ThreadCountN;
 
     MlasTrySimpleParallel(ThreadPool,
         ThreadsPerGemm * static_cast<ptrdiff_t>(BatchSize),
@@ -1635,6 +1812,83 @@ MlasGemmBatch(
             TransA, TransB, M, N, K, &(Data[GemmIdx]), ThreadIdx);
     });
 }
+
+void
+MLASCALL
+MlasGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    //
+    // Handle the special case of small matrices. The packing and blocking of
+    // the general path cost more than the multiply, so the small matrix
+    // kernels read the operands in place. Batches with few multiplies run on
+    // the calling thread, and larger batches are split by whole matrices.
+    //
+
+    if (MlasSgemmSmallIsSupported(TransA, TransB, M, N, K, Data, BatchSize)) {
+
+        MLAS_SGEMM_SMALL_OPERATION* SmallOperation = GetMlasPlatform().SgemmSmallDispatch->Operation;
+
+        const double BatchComplexity = double(M) * double(N) * double(K) * double(BatchSize);
+
+        if (BatchComplexity < double(MLAS_SGEMM_SMALL_THREAD_COMPLEXITY)) {
+
+            for (size_t i = 0; i < BatchSize; i++) {
+                SmallOperation(TransA, TransB, M, N, K, Data[i].alpha,
+                    Data[i].A, Data[i].lda, Data[i].B, Data[i].ldb, Data[i].beta,
+                    Data[i].C, Data[i].ldc);
+            }
+
+            return;
+        }
+
+        const ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+        ptrdiff_t ThreadCount = MaximumThreadCount;
+
+        if (BatchComplexity < double(MLAS_SGEMM_THREAD_COMPLEXITY) * double(MaximumThreadCount)) {
+            ThreadCount = ptrdiff_t(BatchComplexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+        }
+
+        if (BatchSize >= size_t(ThreadCount)) {
+
+            MlasTrySimpleParallel(ThreadPool, ThreadCount, [=](ptrdiff_t tid)
+            {
+                size_t GemmIdx;
+                size_t GemmCount;
+
+                MlasPartitionWork(tid, ThreadCount, BatchSize, &GemmIdx, &GemmCount);
+
+                for (size_t i = GemmIdx; i < GemmIdx + GemmCount; i++) {
+                    SmallOperation(TransA, TransB, M, N, K, Data[i].alpha,
+                        Data[i].A, Data[i].lda, Data[i].B, Data[i].ldb, Data[i].beta,
+                        Data[i].C, Data[i].ldc);
+                }
+            });
+
+            return;
+        }
+    }
+
+    //
+    // Segment the operation across multiple threads using the recorded
+    // partition for this shape, else the default partition.
+    //
+
+    MLAS_SGEMM_THREAD_PARTITION Partition;
+
+    MlasGemmGetThreadPartition(TransA, TransB, M, N, K, BatchSize, &Partition, ThreadPool);
+
+    MlasGemmBatch(TransA, TransB, M, N, K, Data, BatchSize, Partition, ThreadPool);
+}
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(pop)
 #endif
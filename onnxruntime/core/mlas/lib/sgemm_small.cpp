@@ -0,0 +1,142 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_small.cpp
+
+Abstract:
+
+    This module selects the single precision matrix/matrix multiply operation
+    (SGEMM) for small matrices. The kernels are implemented by sgemm_small.h
+    for each instruction set.
+
+--*/
+
+#include "mlasi.h"
+#include "sgemm_small.h"
+
+bool
+MlasSgemmSmallIsSupported(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize
+    )
+/*++
+
+Routine Description:
+
+    This routine determines whether the small matrix kernels should be used
+    for the batched SGEMM operation.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    Data - Supplies the array of matrices data parameters.
+
+    BatchSize - Supplies the number of multiplications in the batch.
+
+Return Value:
+
+    Returns true if the small matrix kernels handle the operation.
+
+--*/
+{
+    if (GetMlasPlatform().SgemmSmallDispatch == nullptr) {
+        return false;
+    }
+
+    if (M == 0 || N == 0 || K == 0 ||
+        M > MLAS_SGEMM_SMALL_MAXIMUM_M || N > MLAS_SGEMM_SMALL_MAXIMUM_NK || K > MLAS_SGEMM_SMALL_MAXIMUM_NK) {
+        return false;
+    }
+
+    //
+    // The general path consumes a packed matrix B without any copies.
+    //
+
+    for (size_t i = 0; i < BatchSize; i++) {
+        if (Data[i].BIsPacked) {
+            return false;
+        }
+    }
+
+    //
+    // A transposed matrix B is multiplied by dot products along the K
+    // dimension, which need contiguous rows of matrix A and enough elements
+    // to amortize their horizontal sums. The general path is faster for more
+    // rows of matrix A.
+    //
+
+    if (TransB == CblasTrans && (TransA == CblasTrans ||
+        M > MLAS_SGEMM_SMALL_MAXIMUM_TRANSB_M || K < MLAS_SGEMM_SMALL_MINIMUM_TRANSB_K)) {
+        return false;
+    }
+
+    //
+    // A single row of matrix A reads each element of matrix B once, which the
+    // matrix/vector kernels of the general path do faster for larger B.
+    //
+
+    if (M == 1 && TransA == CblasNoTrans && N * K > MLAS_SGEMM_SMALL_MAXIMUM_GEMV_NK) {
+        return false;
+    }
+
+    return true;
+}
+
+bool
+MLASCALL
+MlasGemmShouldPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine determines whether matrix B should be packed ahead of time
+    with MlasGemmPackB.
+
+    A packed matrix B is always multiplied by the general path. A small non
+    transposed matrix B is instead left unpacked, so that the small matrix
+    kernels read it in place when matrix A has few rows.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+Return Value:
+
+    Returns true if matrix B should be packed.
+
+--*/
+{
+    if (GetMlasPlatform().SgemmSmallDispatch == nullptr || TransB == CblasTrans) {
+        return true;
+    }
+
+    return N * K > MLAS_SGEMM_SMALL_MAXIMUM_UNPACKED_NK;
+}
@@ -0,0 +1,596 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_small.h
+
+Abstract:
+
+    This module defines the dispatch structure and the templates used to
+    implement the single precision matrix/matrix multiply operation (SGEMM)
+    for small matrices.
+
+    The general SGEMM path packs panels of matrix B and partitions the
+    operation across threads, which costs more than the multiply itself when
+    the matrices are tiny. The small matrix kernels read matrix A and matrix
+    B in place.
+
+    The kernels are fully unrolled over the output tile, with the tile shape
+    and the transpose of matrix A supplied as template arguments. A
+    transposed matrix B is handled by kernels that compute dot products
+    along the K dimension. The vector operations are supplied by a kernel
+    type for each instruction set.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+#include <utility>
+
+/**
+ * @brief Computes the single precision matrix/matrix multiply operation for
+ *        a shape accepted by MlasSgemmSmallIsSupported. The arguments are the
+ *        same as MlasSgemmOperation.
+ */
+typedef
+void
+(MLAS_SGEMM_SMALL_OPERATION)(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc
+    );
+
+struct MLAS_SGEMM_SMALL_DISPATCH {
+    MLAS_SGEMM_SMALL_OPERATION* Operation;
+};
+
+//
+// The kernel type supplies the following members:
+//
+//  Vector          - the vector type of VectorWidth single precision elements.
+//  Mask            - the type selecting the leading elements of a vector.
+//  RowCount        - the maximum number of rows in a tile of matrix C.
+//  VectorCount     - the maximum number of vectors in a tile of matrix C.
+//  TransBRowCount  - the maximum number of rows in a tile of matrix C when
+//                    matrix B is transposed.
+//  TransBColumnCount - the maximum number of columns in a tile of matrix C
+//                    when matrix B is transposed.
+//  Zero, Broadcast, Load, Store, MultiplyAdd, Multiply - vector operations.
+//  ReduceAdd       - returns the sum of the elements of a vector.
+//  MakeMask, LoadMask, StoreMask - operations on the leading elements. The
+//                    other elements are zero after LoadMask.
+//
+
+template<typename KernelType, size_t RowCount, size_t VectorCount, bool TransA, bool LastPartial>
+MLAS_FORCEINLINE
+void
+MlasSgemmSmallTile(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t K,
+    float alpha,
+    float beta,
+    typename KernelType::Mask LastMask
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a RowCount by VectorCount vectors tile of matrix C.
+    Each row of matrix B is loaded once and multiplied with a broadcast
+    element of every row of matrix A.
+
+Arguments:
+
+    A - Supplies the address of the first row of the tile in matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of the first column of the tile in matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    C - Supplies the address of the tile in matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    LastMask - Supplies the mask of the columns of the last vector if
+        LastPartial is true.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    using Vector = typename KernelType::Vector;
+    constexpr size_t VectorWidth = KernelType::VectorWidth;
+
+    Vector Accumulators[RowCount][VectorCount];
+
+    MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+        MlasLoopUnroll<VectorCount>::Iterate([&](size_t v) {
+            Accumulators[r][v] = KernelType::Zero();
+        });
+    });
+
+    for (size_t k = 0; k < K; k++) {
+
+        Vector BElements[VectorCount];
+
+        MlasLoopUnroll<VectorCount>::Iterate([&](size_t v) {
+            const float* b = B + k * ldb + v * VectorWidth;
+            if (LastPartial && v == VectorCount - 1) {
+                BElements[v] = KernelType::LoadMask(b, LastMask);
+            } else {
+                BElements[v] = KernelType::Load(b);
+            }
+        });
+
+        MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+            Vector AElement = KernelType::Broadcast(TransA ? A[k * lda + r] : A[r * lda + k]);
+            MlasLoopUnroll<VectorCount>::Iterate([&](size_t v) {
+                Accumulators[r][v] = KernelType::MultiplyAdd(AElement, BElements[v], Accumulators[r][v]);
+            });
+        });
+    }
+
+    const Vector AlphaBroadcast = KernelType::Broadcast(alpha);
+    const Vector BetaBroadcast = KernelType::Broadcast(beta);
+
+    MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+        MlasLoopUnroll<VectorCount>::Iterate([&](size_t v) {
+            float* c = C + r * ldc + v * VectorWidth;
+            const bool Partial = LastPartial && v == VectorCount - 1;
+            Vector Value = KernelType::Multiply(Accumulators[r][v], AlphaBroadcast);
+            if (beta != 0.0f) {
+                Vector CElements = Partial ? KernelType::LoadMask(c, LastMask) : KernelType::Load(c);
+                Value = KernelType::MultiplyAdd(CElements, BetaBroadcast, Value);
+            }
+            if (Partial) {
+                KernelType::StoreMask(c, Value, LastMask);
+            } else {
+                KernelType::Store(c, Value);
+            }
+        });
+    });
+}
+
+template<typename KernelType, size_t RowCount, size_t VectorCount, bool TransA>
+MLAS_FORCEINLINE
+void
+MlasSgemmSmallTileSelect(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t K,
+    float alpha,
+    float beta,
+    typename KernelType::Mask LastMask,
+    bool LastPartial
+    )
+{
+    if constexpr (VectorCount <= KernelType::VectorCount) {
+        if (LastPartial) {
+            MlasSgemmSmallTile<KernelType, RowCount, VectorCount, TransA, true>(A, lda, B, ldb, C, ldc, K, alpha, beta, LastMask);
+        } else {
+            MlasSgemmSmallTile<KernelType, RowCount, VectorCount, TransA, false>(A, lda, B, ldb, C, ldc, K, alpha, beta, LastMask);
+        }
+    }
+}
+
+template<typename KernelType, size_t RowCount, bool TransA>
+MLAS_FLATTEN
+void
+MlasSgemmSmallRows(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    size_t K,
+    float alpha,
+    float beta
+    )
+/*++
+
+Routine Description:
+
+    This routine computes RowCount rows of a column tile of matrix C.
+
+Arguments:
+
+    CountN - Supplies the number of columns of the tile, which is at most
+        KernelType::VectorCount vectors.
+
+    See MlasSgemmSmallTile for the remaining arguments.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t VectorWidth = KernelType::VectorWidth;
+
+    static_assert(KernelType::VectorCount >= 1 && KernelType::VectorCount <= 4, "unsupported vector count");
+
+    const size_t PartialCount = CountN % VectorWidth;
+    const typename KernelType::Mask LastMask = KernelType::MakeMask(PartialCount);
+    const bool LastPartial = (PartialCount != 0);
+
+    switch ((CountN + VectorWidth - 1) / VectorWidth) {
+        case 1:
+            MlasSgemmSmallTileSelect<KernelType, RowCount, 1, TransA>(A, lda, B, ldb, C, ldc, K, alpha, beta, LastMask, LastPartial);
+            break;
+        case 2:
+            MlasSgemmSmallTileSelect<KernelType, RowCount, 2, TransA>(A, lda, B, ldb, C, ldc, K, alpha, beta, LastMask, LastPartial);
+            break;
+        case 3:
+            MlasSgemmSmallTileSelect<KernelType, RowCount, 3, TransA>(A, lda, B, ldb, C, ldc, K, alpha, beta, LastMask, LastPartial);
+            break;
+        default:
+            MlasSgemmSmallTileSelect<KernelType, RowCount, 4, TransA>(A, lda, B, ldb, C, ldc, K, alpha, beta, LastMask, LastPartial);
+            break;
+    }
+}
+
+typedef
+void
+(MLAS_SGEMM_SMALL_ROWS_ROUTINE)(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    size_t K,
+    float alpha,
+    float beta
+    );
+
+template<typename KernelType, bool TransA, size_t... Index>
+MLAS_SGEMM_SMALL_ROWS_ROUTINE* const*
+MlasSgemmSmallRowsTable(
+    std::index_sequence<Index...>
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the table of routines indexed by the number of rows
+    of a tile of matrix C minus one.
+
+--*/
+{
+    static MLAS_SGEMM_SMALL_ROWS_ROUTINE* const Routines[] = {
+        MlasSgemmSmallRows<KernelType, Index + 1, TransA>...
+    };
+
+    return Routines;
+}
+
+template<typename KernelType, size_t RowCount, size_t ColumnCount, bool Partial>
+MLAS_FORCEINLINE
+void
+MlasSgemmSmallTransBStep(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    typename KernelType::Vector (&Accumulators)[RowCount][ColumnCount],
+    typename KernelType::Mask PartialMask
+    )
+/*++
+
+Routine Description:
+
+    This routine accumulates the products of one vector of elements along the
+    K dimension for a RowCount by ColumnCount tile of matrix C.
+
+--*/
+{
+    using Vector = typename KernelType::Vector;
+
+    Vector BElements[ColumnCount];
+
+    MlasLoopUnroll<ColumnCount>::Iterate([&](size_t c) {
+        BElements[c] = Partial ? KernelType::LoadMask(B + c * ldb, PartialMask) : KernelType::Load(B + c * ldb);
+    });
+
+    MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+        Vector AElements = Partial ? KernelType::LoadMask(A + r * lda, PartialMask) : KernelType::Load(A + r * lda);
+        MlasLoopUnroll<ColumnCount>::Iterate([&](size_t c) {
+            Accumulators[r][c] = KernelType::MultiplyAdd(AElements, BElements[c], Accumulators[r][c]);
+        });
+    });
+}
+
+template<typename KernelType, size_t RowCount, size_t ColumnCount>
+MLAS_FORCEINLINE
+void
+MlasSgemmSmallTransBTile(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t K,
+    float alpha,
+    float beta
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a RowCount by ColumnCount tile of matrix C from a
+    non transposed matrix A and a transposed matrix B. Each element of the
+    tile is the dot product of a row of matrix A and a row of matrix B, which
+    are both contiguous along the K dimension.
+
+Arguments:
+
+    A - Supplies the address of the first row of the tile in matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of the first row of the tile in the transposed
+        matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    C - Supplies the address of the tile in matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of columns
+        of the transposed matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+Return Value:
+
+    None.
+
+--*/
+{
+    using Vector = typename KernelType::Vector;
+    constexpr size_t VectorWidth = KernelType::VectorWidth;
+
+    Vector Accumulators[RowCount][ColumnCount];
+
+    MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+        MlasLoopUnroll<ColumnCount>::Iterate([&](size_t c) {
+            Accumulators[r][c] = KernelType::Zero();
+        });
+    });
+
+    size_t k = 0;
+
+    for (; k + VectorWidth <= K; k += VectorWidth) {
+        MlasSgemmSmallTransBStep<KernelType, RowCount, ColumnCount, false>(
+            A + k, lda, B + k, ldb, Accumulators, typename KernelType::Mask());
+    }
+
+    if (k < K) {
+        MlasSgemmSmallTransBStep<KernelType, RowCount, ColumnCount, true>(
+            A + k, lda, B + k, ldb, Accumulators, KernelType::MakeMask(K - k));
+    }
+
+    MlasLoopUnroll<RowCount>::Iterate([&](size_t r) {
+        MlasLoopUnroll<ColumnCount>::Iterate([&](size_t c) {
+            float* Element = C + r * ldc + c;
+            float Value = KernelType::ReduceAdd(Accumulators[r][c]) * alpha;
+            if (beta != 0.0f) {
+                Value += *Element * beta;
+            }
+            *Element = Value;
+        });
+    });
+}
+
+template<typename KernelType, size_t RowCount>
+MLAS_FLATTEN
+void
+MlasSgemmSmallTransBRows(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    size_t K,
+    float alpha,
+    float beta
+    )
+/*++
+
+Routine Description:
+
+    This routine computes RowCount rows of a column tile of matrix C from a
+    transposed matrix B.
+
+Arguments:
+
+    CountN - Supplies the number of columns of the tile, which is at most
+        KernelType::TransBColumnCount.
+
+    See MlasSgemmSmallTransBTile for the remaining arguments.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    static_assert(KernelType::TransBColumnCount >= 1 && KernelType::TransBColumnCount <= 4, "unsupported column count");
+
+    switch (CountN) {
+        case 1:
+            MlasSgemmSmallTransBTile<KernelType, RowCount, 1>(A, lda, B, ldb, C, ldc, K, alpha, beta);
+            break;
+        case 2:
+            if constexpr (KernelType::TransBColumnCount >= 2) {
+                MlasSgemmSmallTransBTile<KernelType, RowCount, 2>(A, lda, B, ldb, C, ldc, K, alpha, beta);
+            }
+            break;
+        case 3:
+            if constexpr (KernelType::TransBColumnCount >= 3) {
+                MlasSgemmSmallTransBTile<KernelType, RowCount, 3>(A, lda, B, ldb, C, ldc, K, alpha, beta);
+            }
+            break;
+        default:
+            if constexpr (KernelType::TransBColumnCount >= 4) {
+                MlasSgemmSmallTransBTile<KernelType, RowCount, 4>(A, lda, B, ldb, C, ldc, K, alpha, beta);
+            }
+            break;
+    }
+}
+
+template<typename KernelType, size_t... Index>
+MLAS_SGEMM_SMALL_ROWS_ROUTINE* const*
+MlasSgemmSmallTransBRowsTable(
+    std::index_sequence<Index...>
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the table of routines for a transposed matrix B
+    indexed by the number of rows of a tile of matrix C minus one.
+
+--*/
+{
+    static MLAS_SGEMM_SMALL_ROWS_ROUTINE* const Routines[] = {
+        MlasSgemmSmallTransBRows<KernelType, Index + 1>...
+    };
+
+    return Routines;
+}
+
+template<typename KernelType>
+void
+MLASCALL
+MlasSgemmSmallOperation(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) for a shape accepted by MlasSgemmSmallIsSupported.
+
+Arguments:
+
+    See MlasSgemmOperation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // A transposed matrix B is multiplied by rows. The rows of matrix A must
+    // then be contiguous, which is checked by MlasSgemmSmallIsSupported.
+    //
+
+    if (TransB == CblasTrans) {
+
+        constexpr size_t TileM = KernelType::TransBRowCount;
+        constexpr size_t TileN = KernelType::TransBColumnCount;
+
+        MLAS_SGEMM_SMALL_ROWS_ROUTINE* const* Rows =
+            MlasSgemmSmallTransBRowsTable<KernelType>(std::make_index_sequence<TileM>());
+
+        for (size_t n = 0; n < N; n += TileN) {
+
+            const size_t CountN = std::min(N - n, TileN);
+
+            for (size_t m = 0; m < M; m += TileM) {
+
+                const size_t CountM = std::min(M - m, TileM);
+
+                Rows[CountM - 1](A + m * lda, lda, B + n * ldb, ldb, C + m * ldc + n, ldc, CountN, K, alpha, beta);
+            }
+        }
+
+        return;
+    }
+
+    constexpr size_t TileM = KernelType::RowCount;
+    constexpr size_t TileN = KernelType::VectorCount * KernelType::VectorWidth;
+
+    MLAS_SGEMM_SMALL_ROWS_ROUTINE* const* Rows = (TransA == CblasTrans) ?
+        MlasSgemmSmallRowsTable<KernelType, true>(std::make_index_sequence<TileM>()) :
+        MlasSgemmSmallRowsTable<KernelType, false>(std::make_index_sequence<TileM>());
+
+    //
+    // Step to the next rows of matrix A, which are the next columns when
+    // matrix A is transposed.
+    //
+
+    const size_t StrideA = (TransA == CblasTrans) ? 1 : lda;
+
+    for (size_t n = 0; n < N; n += TileN) {
+
+        const size_t CountN = std::min(N - n, TileN);
+
+        for (size_t m = 0; m < M; m += TileM) {
+
+            const size_t CountM = std::min(M - m, TileM);
+
+            Rows[CountM - 1](A + m * StrideA, lda, B + n, ldb, C + m * ldc + n, ldc, CountN, K, alpha, beta);
+        }
+    }
+}
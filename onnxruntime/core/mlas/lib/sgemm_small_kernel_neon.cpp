@@ -0,0 +1,88 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_small_kernel_neon.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation (SGEMM) for small matrices using ARM NEON intrinsics.
+
+--*/
+
+#include "sgemm_small.h"
+
+struct MLAS_SGEMM_SMALL_KERNEL_NEON
+{
+    typedef float32x4_t Vector;
+    typedef size_t Mask;
+
+    static constexpr size_t VectorWidth = 4;
+
+    //
+    // Each tile uses sixteen accumulators for four rows of four vectors, the
+    // same tile as the packed SGEMM kernel.
+    //
+
+    static constexpr size_t RowCount = 4;
+    static constexpr size_t VectorCount = 4;
+
+    //
+    // A transposed matrix B uses sixteen accumulators for four rows of four
+    // columns.
+    //
+
+    static constexpr size_t TransBRowCount = 4;
+    static constexpr size_t TransBColumnCount = 4;
+
+    static MLAS_FORCEINLINE Vector Zero() { return vdupq_n_f32(0.0f); }
+
+    static MLAS_FORCEINLINE Vector Broadcast(float Value) { return vdupq_n_f32(Value); }
+
+    static MLAS_FORCEINLINE Vector Load(const float* Buffer) { return vld1q_f32(Buffer); }
+
+    static MLAS_FORCEINLINE void Store(float* Buffer, Vector Value) { vst1q_f32(Buffer, Value); }
+
+    static MLAS_FORCEINLINE Vector Multiply(Vector Vector1, Vector Vector2) { return vmulq_f32(Vector1, Vector2); }
+
+    static MLAS_FORCEINLINE Vector MultiplyAdd(Vector Vector1, Vector Vector2, Vector Vector3)
+    {
+        return vfmaq_f32(Vector3, Vector1, Vector2);
+    }
+
+    static MLAS_FORCEINLINE float ReduceAdd(Vector Value) { return MlasReduceAddFloat32x4(Value); }
+
+    //
+    // NEON has no masked memory operations, so the leading elements are
+    // copied through a local buffer.
+    //
+
+    static MLAS_FORCEINLINE Mask MakeMask(size_t Count) { return Count; }
+
+    static MLAS_FORCEINLINE Vector LoadMask(const float* Buffer, Mask ElementCount)
+    {
+        float Elements[VectorWidth] = {};
+        for (size_t i = 0; i < ElementCount; i++) {
+            Elements[i] = Buffer[i];
+        }
+        return vld1q_f32(Elements);
+    }
+
+    static MLAS_FORCEINLINE void StoreMask(float* Buffer, Vector Value, Mask ElementCount)
+    {
+        float Elements[VectorWidth];
+        vst1q_f32(Elements, Value);
+        for (size_t i = 0; i < ElementCount; i++) {
+            Buffer[i] = Elements[i];
+        }
+    }
+};
+
+const MLAS_SGEMM_SMALL_DISPATCH MlasSgemmSmallDispatchNeon = {
+    MlasSgemmSmallOperation<MLAS_SGEMM_SMALL_KERNEL_NEON>,
+};
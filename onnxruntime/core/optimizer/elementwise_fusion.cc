@@ -0,0 +1,207 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/elementwise_fusion.h"
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+bool IsTensorOfType(const NodeArg& node_arg, int32_t elem_type) {
+  const TypeProto* type = node_arg.TypeAsProto();
+  return node_arg.Exists() && type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == elem_type;
+}
+
+bool IsFusible(const Node& node, const InlinedHashSet<std::string_view>& compatible_providers) {
+  size_t input_count = 0;
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7, 13, 14})) {
+    input_count = 2;
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14}) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "Erf", {9, 13})) {
+    input_count = 1;
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Where", {9, 16})) {
+    input_count = 3;
+  } else {
+    return false;
+  }
+
+  if (!graph_utils::IsSupportedProvider(node, compatible_providers) || !node.ImplicitInputDefs().empty() ||
+      node.InputDefs().size() != input_count || node.OutputDefs().size() != 1 ||
+      !IsTensorOfType(*node.OutputDefs()[0], TensorProto_DataType_FLOAT)) {
+    return false;
+  }
+
+  // The condition of Where is bool, every other input is float.
+  for (size_t i = 0; i < input_count; ++i) {
+    const bool is_condition = input_count == 3 && i == 0;
+    if (!IsTensorOfType(*node.InputDefs()[i], is_condition ? TensorProto_DataType_BOOL : TensorProto_DataType_FLOAT)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Unlike optimizer_utils::CompareShape, symbolic dimensions match when they have the same name.
+bool HaveSameShape(const NodeArg& arg, const NodeArg& other) {
+  const TensorShapeProto* shape = arg.Shape();
+  const TensorShapeProto* other_shape = other.Shape();
+  if (shape == nullptr || other_shape == nullptr || shape->dim_size() != other_shape->dim_size()) {
+    return false;
+  }
+
+  for (int i = 0; i < shape->dim_size(); ++i) {
+    const auto& dim = shape->dim(i);
+    const auto& other_dim = other_shape->dim(i);
+    if (utils::HasDimValue(dim) && utils::HasDimValue(other_dim)) {
+      if (dim.dim_value() != other_dim.dim_value()) {
+        return false;
+      }
+    } else if (utils::HasDimParam(dim) && utils::HasDimParam(other_dim)) {
+      if (dim.dim_param() != other_dim.dim_param()) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Collect the tree of fusible nodes ending at node, producers before their consumers.
+void CollectFusedNodes(Graph& graph, Node& node, const NodeArg& root_output,
+                       const InlinedHashSet<std::string_view>& compatible_providers,
+                       InlinedHashSet<NodeIndex>& visited, InlinedVector<Node*>& fused_nodes) {
+  visited.insert(node.Index());
+
+  for (const NodeArg* input : node.InputDefs()) {
+    Node* producer = graph.GetMutableProducerNode(input->Name());
+    if (producer == nullptr || visited.count(producer->Index()) != 0 ||
+        producer->GetExecutionProviderType() != node.GetExecutionProviderType() ||
+        !IsFusible(*producer, compatible_providers) || !optimizer_utils::CheckOutputEdges(graph, *producer, 1) ||
+        !HaveSameShape(*producer->OutputDefs()[0], root_output)) {
+      continue;
+    }
+
+    CollectFusedNodes(graph, *producer, root_output, compatible_providers, visited, fused_nodes);
+  }
+
+  fused_nodes.push_back(&node);
+}
+
+void FuseNodes(Graph& graph, gsl::span<Node* const> fused_nodes) {
+  // The inputs of the fused node are the inputs of the tree that are not produced within it. The operands of an
+  // operation index these inputs, followed by the results of the earlier operations.
+  InlinedHashMap<const NodeArg*, int64_t> results;
+  for (size_t k = 0; k < fused_nodes.size(); ++k) {
+    results[fused_nodes[k]->OutputDefs()[0]] = static_cast<int64_t>(k);
+  }
+
+  InlinedVector<NodeArg*> inputs;
+  InlinedHashMap<const NodeArg*, int64_t> input_indices;
+  for (Node* node : fused_nodes) {
+    for (NodeArg* input : node->MutableInputDefs()) {
+      if (results.count(input) == 0 && input_indices.count(input) == 0) {
+        input_indices[input] = static_cast<int64_t>(inputs.size());
+        inputs.push_back(input);
+      }
+    }
+  }
+
+  std::vector<std::string> operations;
+  std::vector<int64_t> operands;
+  for (Node* node : fused_nodes) {
+    operations.push_back(node->OpType());
+    for (const NodeArg* input : node->InputDefs()) {
+      auto result = results.find(input);
+      operands.push_back(result != results.end() ? static_cast<int64_t>(inputs.size()) + result->second
+                                                 : input_indices[input]);
+    }
+  }
+
+  Node& root = *fused_nodes.back();
+  Node& fused_node = graph.AddNode(graph.GenerateNodeName("FusedElementwise"), "FusedElementwise",
+                                   "fused elementwise operations", inputs, root.MutableOutputDefs(), nullptr,
+                                   kMSDomain);
+  fused_node.AddAttribute("operations", operations);
+  fused_node.AddAttribute("operands", operands);
+  fused_node.SetExecutionProviderType(root.GetExecutionProviderType());
+
+  // The fused node takes over the output edges of the root of the tree.
+  for (const auto& edge : graph_utils::GraphEdge::GetNodeOutputEdges(root)) {
+    graph.AddEdge(fused_node.Index(), edge.dst_node, edge.src_arg_index, edge.dst_arg_index);
+  }
+
+  for (Node* node : fused_nodes) {
+    graph_utils::RemoveNodeOutputEdges(graph, *node);
+    graph.RemoveNode(node->Index());
+  }
+
+  graph.UpdateProducerNode(fused_node.OutputDefs()[0]->Name(), fused_node.Index());
+
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    const Node* producer = graph.GetProducerNode(inputs[i]->Name());
+    if (producer == nullptr) {
+      continue;
+    }
+
+    const auto& producer_outputs = producer->OutputDefs();
+    for (size_t j = 0; j < producer_outputs.size(); ++j) {
+      if (producer_outputs[j] == inputs[i]) {
+        graph.AddEdge(producer->Index(), fused_node.Index(), static_cast<int>(j), static_cast<int>(i));
+        break;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+Status ElementwiseFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    ORT_RETURN_IF_ERROR(Recurse(*node_ptr, modified, graph_level, logger));
+  }
+
+  // Visit consumers before producers, so that every tree is collected from its root.
+  InlinedHashSet<NodeIndex> visited;
+  for (auto it = node_topology_list.rbegin(); it != node_topology_list.rend(); ++it) {
+    auto* node_ptr = graph.GetNode(*it);
+    if (nullptr == node_ptr || visited.count(*it) != 0 ||
+        !IsFusible(*node_ptr, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    InlinedVector<Node*> fused_nodes;
+    CollectFusedNodes(graph, *node_ptr, *node_ptr->OutputDefs()[0], GetCompatibleExecutionProviders(), visited,
+                      fused_nodes);
+    if (fused_nodes.size() < 2) {
+      continue;
+    }
+
+    FuseNodes(graph, fused_nodes);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ElementwiseFusion
+
+Fuse connected float Add, Sub, Mul, Div, Relu, Sigmoid, Erf and Where nodes into a single FusedElementwise node,
+which evaluates the whole expression tile by tile instead of streaming every intermediate tensor through memory.
+
+A node is fused into the node consuming its output when that node is its only consumer and both outputs have the
+same shape, so a fused expression never evaluates an intermediate result at a larger shape than the original graph.
+The fused nodes form a tree whose inputs are the inputs of the FusedElementwise node.
+*/
+class ElementwiseFusion : public GraphTransformer {
+ public:
+  ElementwiseFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ElementwiseFusion", compatible_execution_providers) {}
+
+  std::vector<std::string> TargetOpTypes() const noexcept override {
+    return {"Add", "Sub", "Mul", "Div", "Relu", "Sigmoid", "Erf", "Where"};
+  }
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -56,6 +56,12 @@ Status GemmActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_l
       continue;
     }
 
+    // FusedGemm is only implemented for float.
+    const auto* gemm_type = node.InputDefs()[0]->Type();
+    if (gemm_type == nullptr || *gemm_type != "tensor(float)") {
+      continue;
+    }
+
     const Node& next_node = *(node.OutputNodesBegin());
     if (!IsFusableActivation(next_node) || next_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
       continue;
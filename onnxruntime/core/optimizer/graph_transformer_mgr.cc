@@ -2,6 +2,10 @@
 // Licensed under the MIT License.
 
 #include "core/optimizer/graph_transformer_mgr.h"
+
+#include <algorithm>
+#include <string>
+
 #include "core/optimizer/rule_based_graph_transformer.h"
 
 using namespace onnxruntime;
@@ -19,21 +23,68 @@ common::Status GraphTransformerManager::GetSteps(unsigned& steps) const {
   return Status::OK();
 }
 
+namespace {
+
+// Collect the op types of the nodes in the graph and its subgraphs.
+void CollectOpTypes(const Graph& graph, InlinedHashSet<std::string>& op_types) {
+  for (const auto& node : graph.Nodes()) {
+    op_types.insert(node.OpType());
+    for (const auto& entry : node.GetAttributeNameToSubgraphMap()) {
+      CollectOpTypes(*entry.second, op_types);
+    }
+  }
+}
+
+}  // namespace
+
 common::Status GraphTransformerManager::ApplyTransformers(Graph& graph, TransformerLevel level, const logging::Logger& logger) const {
   const auto& transformers = level_to_transformer_map_.find(level);
   if (transformers == level_to_transformer_map_.end()) {
     return Status::OK();
   }
 
+  const bool profiling = profiler_ != nullptr && profiler_->IsEnabled();
+
+  // The op types present in the graph, refreshed whenever a transformer modifies it.
+  InlinedHashSet<std::string> op_types;
+  bool op_types_stale = true;
+
   for (unsigned step = 0; step < steps_; ++step) {
     bool graph_changed = false;
     for (const auto& transformer : transformers->second) {
       if (step > 0 && transformer->ShouldOnlyApplyOnce())
         continue;
 
+      const auto target_op_types = transformer->TargetOpTypes();
+      if (!target_op_types.empty()) {
+        if (op_types_stale) {
+          op_types.clear();
+          CollectOpTypes(graph, op_types);
+          op_types_stale = false;
+        }
+
+        if (std::none_of(target_op_types.cbegin(), target_op_types.cend(),
+                         [&op_types](const std::string& op_type) { return op_types.count(op_type) != 0; })) {
+          continue;
+        }
+      }
+
+      TimePoint start_time;
+      if (profiling) {
+        start_time = profiler_->Start();
+      }
+
       bool modified = false;
       ORT_RETURN_IF_ERROR(transformer->Apply(graph, modified, logger));
       graph_changed = graph_changed || modified;
+      op_types_stale = op_types_stale || modified;
+
+      if (profiling) {
+        profiler_->EndTimeAndRecordEvent(profiling::SESSION_EVENT, transformer->Name(), start_time,
+                                         {{"level", std::to_string(static_cast<int>(level))},
+                                          {"step", std::to_string(step)},
+                                          {"modified", modified ? "1" : "0"}});
+      }
     }
     if (!graph_changed) {
       break;
@@ -5,6 +5,7 @@
 
 #include "core/common/inlined_containers.h"
 #include "core/common/logging/logging.h"
+#include "core/common/profiler.h"
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/constant_folding.h"
 #include "core/optimizer/rewrite_rule.h"
@@ -27,7 +28,11 @@ class GraphTransformerManager {
   // Register a transformer with a level.
   common::Status Register(std::unique_ptr<GraphTransformer> transformer, TransformerLevel level);
 
-  // Apply all transformers registered for the given level on the given graph
+  // Set the profiler that records the time spent in each transformer when it is enabled. May be nullptr.
+  void SetProfiler(profiling::Profiler* profiler) noexcept { profiler_ = profiler; }
+
+  // Apply all transformers registered for the given level on the given graph.
+  // A transformer is skipped when the graph has no node of the op types it targets.
   common::Status ApplyTransformers(Graph& graph, TransformerLevel level, const logging::Logger& logger) const;
 
  private:
@@ -36,6 +41,8 @@ class GraphTransformerManager {
   // maximum number of graph transformation steps
   unsigned steps_;
 
+  profiling::Profiler* profiler_ = nullptr;
+
   InlinedHashMap<TransformerLevel, InlinedVector<std::unique_ptr<GraphTransformer>>> level_to_transformer_map_;
   InlinedHashMap<std::string, GraphTransformer*> transformers_info_;
 };
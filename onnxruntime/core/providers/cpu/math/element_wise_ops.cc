@@ -12,7 +12,9 @@
 #include "core/util/math.h"
 #include "core/mlas/inc/mlas.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 
 namespace onnxruntime {
 // Supported types for operators that have type reduction enabled
@@ -1751,46 +1753,182 @@ Status Mod::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
-// Broadcast two inputs with no parallelization.
-//
-// This function is type agnostic, and uses function pointers instead of std::function, to minimize binary size.
-// Type specific logic is plugged in via the functions in ProcessBroadcastSpanFuncs.
-// Optional user_data can be provided, and will be available to the ProcessSpanFunc implementations
-// via BroadcastHelper.GetUserData().
-void UntypedBroadcastTwo(OpKernelContext& context, const ProcessBroadcastSpanFuncs& funcs, void* user_data) {
-  InputBroadcaster input_broadcaster(*context.Input<Tensor>(0), *context.Input<Tensor>(1));
-  OutputBroadcaster output_broadcaster(input_broadcaster.GetSpanSize(),
-                                       *context.Output(0, input_broadcaster.GetOutputShape()));
-  BroadcastHelper broadcast_helper(input_broadcaster, output_broadcaster, user_data);
+namespace {
 
-  BroadcastLooper(broadcast_helper, funcs);
-}
+// Broadcasts with short spans spend more time dispatching a span than computing it, e.g. [N, C, H, W] + [N, 1, H, W]
+// with a small spatial size. Those are processed in tiles of the output instead, with the broadcast input gathered
+// into a contiguous buffer. A span that repeats a single element of an input is cheaper to compute than to gather, so
+// it is only tiled when it is shorter. Gathering both inputs, as for the outer product [M, 1] + [1, N], costs more than
+// the per span calls it saves, so one input must have as many elements as the output.
+constexpr size_t kMinBroadcastSpanSize = 32;
+constexpr size_t kMinScalarBroadcastSpanSize = 10;
 
-// Variant of UntypedBroadcastTwo that will parallelize.
-// Operator usage is the same as the parallelization is opaque to the operator.
-// unit_cost must be a valid cost value.
-void UntypedBroadcastTwo(OpKernelContext& context, const ProcessBroadcastSpanFuncs& funcs, double unit_cost,
-                         void* user_data) {
-  const Tensor& input0_tensor = *context.Input<Tensor>(0);
-  const Tensor& input1_tensor = *context.Input<Tensor>(1);
-  InputBroadcaster input_broadcaster(input0_tensor, input1_tensor);
+// Number of output elements in a tile. The two gathered inputs of a tile stay within the L1/L2 cache.
+constexpr size_t kBroadcastTileSize = 4096;
 
-  Tensor& output_tensor = *context.Output(0, input_broadcaster.GetOutputShape());
+// Reads the elements of one input that a range of the output consumes. The broadcast iterator of the input walks it
+// in runs of span output elements, which are either contiguous in the input or repeat a single element.
+class BroadcastTileReader {
+ public:
+  BroadcastTileReader(const Tensor& input, const BroadcastIterator& iterator, size_t output_size)
+      : data_(static_cast<const uint8_t*>(input.DataRaw())),
+        element_size_(input.DataType()->Size()),
+        is_full_(static_cast<size_t>(input.Shape().Size()) == output_size),
+        iterator_(iterator),
+        span_(static_cast<size_t>(iterator.GetCountsFront())),
+        is_repeated_(iterator.GetDeltasFront() == 0) {
+  }
+
+  bool IsFull() const { return is_full_; }
+  size_t ElementSize() const { return element_size_; }
+
+  // position the reader at an output offset. must be called once, before the first Read.
+  void Seek(size_t output_offset) {
+    if (!is_full_) {
+      iterator_.AdvanceBy(output_offset);
+    }
+  }
+
+  // Returns the input elements for the output elements [start, start + count), which follow the previous read.
+  // An input with as many elements as the output is read in place, any other input is gathered into buffer.
+  const void* Read(size_t start, size_t count, uint8_t* buffer) {
+    if (is_full_) {
+      return data_ + start * element_size_;
+    }
+
+    for (size_t done = 0; done < count;) {
+      const size_t n = std::min(span_ - (start + done) % span_, count - done);
+      const uint8_t* source = data_ + iterator_.AdvanceBy(n) * element_size_;
+      uint8_t* destination = buffer + done * element_size_;
+      if (!is_repeated_) {
+        memcpy(destination, source, n * element_size_);
+      } else {
+        Fill(source, destination, n);
+      }
+      done += n;
+    }
+
+    return buffer;
+  }
 
+ private:
+  template <typename T>
+  static void FillTyped(const uint8_t* source, uint8_t* destination, size_t count) {
+    T value;
+    memcpy(&value, source, sizeof(T));
+    std::fill_n(reinterpret_cast<T*>(destination), count, value);
+  }
+
+  void Fill(const uint8_t* source, uint8_t* destination, size_t count) const {
+    switch (element_size_) {
+      case 1:
+        FillTyped<uint8_t>(source, destination, count);
+        break;
+      case 2:
+        FillTyped<uint16_t>(source, destination, count);
+        break;
+      case 4:
+        FillTyped<uint32_t>(source, destination, count);
+        break;
+      case 8:
+        FillTyped<uint64_t>(source, destination, count);
+        break;
+      default:
+        for (size_t i = 0; i < count; i++) {
+          memcpy(destination + i * element_size_, source, element_size_);
+        }
+    }
+  }
+
+  const uint8_t* data_;
+  const size_t element_size_;
+  const bool is_full_;
+  BroadcastIterator iterator_;
+  const size_t span_;
+  const bool is_repeated_;
+};
+
+// Process a broadcast with short spans one tile of the output at a time. Each tile is computed by a single call to
+// the general function over contiguous inputs, so the Eigen/MLAS loops of the operator run over kBroadcastTileSize
+// elements instead of a single span.
+void BroadcastTwoTiled(OpKernelContext& context, const Tensor& input0, const Tensor& input1, Tensor& output,
+                       const ProcessBroadcastSpanFuncs& funcs, concurrency::ThreadPool* tp, double unit_cost,
+                       void* user_data) {
+  const size_t output_size = static_cast<size_t>(output.Shape().Size());
+  const Broadcaster broadcaster(input0.Shape().GetDims(), input1.Shape().GetDims());
+  const BroadcastTileReader reader0(input0, broadcaster.iterator1_, output_size);
+  const BroadcastTileReader reader1(input1, broadcaster.iterator2_, output_size);
+
+  AllocatorPtr allocator;
+  ORT_THROW_IF_ERROR(context.GetTempSpaceAllocator(&allocator));
+
+  const size_t output_element_size = output.DataType()->Size();
+  uint8_t* output_bytes = static_cast<uint8_t*>(output.MutableDataRaw());
+  const std::ptrdiff_t num_tiles = static_cast<std::ptrdiff_t>((output_size + kBroadcastTileSize - 1) /
+                                                               kBroadcastTileSize);
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, num_tiles,
+      TensorOpCost{static_cast<double>(reader0.ElementSize() + reader1.ElementSize()) * kBroadcastTileSize,
+                   static_cast<double>(output_element_size) * kBroadcastTileSize,
+                   unit_cost * kBroadcastTileSize},
+      [&](std::ptrdiff_t first_tile, std::ptrdiff_t last_tile) {
+        BroadcastTileReader segment_reader0(reader0);
+        BroadcastTileReader segment_reader1(reader1);
+        segment_reader0.Seek(static_cast<size_t>(first_tile) * kBroadcastTileSize);
+        segment_reader1.Seek(static_cast<size_t>(first_tile) * kBroadcastTileSize);
+
+        auto buffer0 = IAllocator::MakeUniquePtr<uint8_t>(
+            allocator, reader0.IsFull() ? 0 : kBroadcastTileSize * reader0.ElementSize());
+        auto buffer1 = IAllocator::MakeUniquePtr<uint8_t>(
+            allocator, reader1.IsFull() ? 0 : kBroadcastTileSize * reader1.ElementSize());
+
+        for (std::ptrdiff_t tile = first_tile; tile < last_tile; tile++) {
+          const size_t start = static_cast<size_t>(tile) * kBroadcastTileSize;
+          const size_t count = std::min(kBroadcastTileSize, output_size - start);
+          const TensorShape tile_shape({static_cast<int64_t>(count)});
+
+          Tensor tile_input0(input0.DataType(), tile_shape,
+                             const_cast<void*>(segment_reader0.Read(start, count, buffer0.get())),
+                             input0.Location());
+          Tensor tile_input1(input1.DataType(), tile_shape,
+                             const_cast<void*>(segment_reader1.Read(start, count, buffer1.get())),
+                             input1.Location());
+          Tensor tile_output(output.DataType(), tile_shape, output_bytes + start * output_element_size,
+                             output.Location());
+
+          InputBroadcaster input_broadcaster(tile_input0, tile_input1);
+          OutputBroadcaster output_broadcaster(count, tile_output);
+          BroadcastHelper broadcast_helper(input_broadcaster, output_broadcaster, user_data);
+          funcs.general(broadcast_helper);
+        }
+      });
+}
+
+// Broadcast input0 and input1, which input_broadcaster was created from, into output. With a thread pool the work is
+// split within the span when the output is a single span, and across spans or tiles otherwise.
+void BroadcastTwo(OpKernelContext& context, InputBroadcaster& input_broadcaster, const Tensor& input0,
+                  const Tensor& input1, Tensor& output, const ProcessBroadcastSpanFuncs& funcs,
+                  concurrency::ThreadPool* tp, double unit_cost, void* user_data) {
   size_t span_size = input_broadcaster.GetSpanSize();
-  size_t output_size = static_cast<ptrdiff_t>(output_tensor.Shape().Size());
+  size_t output_size = static_cast<size_t>(output.Shape().Size());
 
   // one or more zero dimensions so nothing more to do
   if (output_size == 0) {
     return;
   }
 
-  concurrency::ThreadPool* tp = context.GetOperatorThreadPool();
-
   if (span_size == output_size) {  // Input data will be processed in a single span, so parallelize within the span
-    OutputBroadcaster output_broadcaster(span_size, output_tensor);
+    OutputBroadcaster output_broadcaster(span_size, output);
     BroadcastHelper broadcast_helper(input_broadcaster, output_broadcaster, user_data, tp, unit_cost);
     BroadcastLooper(broadcast_helper, funcs);
+  } else if (span_size < (input_broadcaster.IsInput0Scalar() || input_broadcaster.IsInput1Scalar()
+                               ? kMinScalarBroadcastSpanSize
+                               : kMinBroadcastSpanSize) &&
+             (static_cast<size_t>(input0.Shape().Size()) == output_size ||
+              static_cast<size_t>(input1.Shape().Size()) == output_size) &&
+             !input0.IsDataTypeString() && !input1.IsDataTypeString() && !output.IsDataTypeString()) {
+    BroadcastTwoTiled(context, input0, input1, output, funcs, tp, unit_cost, user_data);
   } else {
     // Input data will be processed in multiple spans, so parallelize across spans.
 
@@ -1800,16 +1938,16 @@ void UntypedBroadcastTwo(OpKernelContext& context, const ProcessBroadcastSpanFun
     concurrency::ThreadPool::TryParallelFor(
         tp, output_size / span_size,
         TensorOpCost{static_cast<double>(input_broadcaster.Input0ElementSize()) * span_size,
-                     static_cast<double>(output_tensor.DataType()->Size()) * span_size,
+                     static_cast<double>(output.DataType()->Size()) * span_size,
                      unit_cost * span_size},
-        [span_size, &const_input_broadcaster, &output_tensor, &funcs, user_data](std::ptrdiff_t first_span,
-                                                                                 std::ptrdiff_t last_span) {
+        [span_size, &const_input_broadcaster, &output, &funcs, user_data](std::ptrdiff_t first_span,
+                                                                          std::ptrdiff_t last_span) {
           // copy original input_broadcaster (which is at start of all input) and advance to this segment
           InputBroadcaster segment_input_broadcaster(const_input_broadcaster);
           segment_input_broadcaster.AdvanceBy(first_span * span_size);
 
           // create broadcaster for this segment of output
-          OutputBroadcaster segment_output_broadcaster(span_size, output_tensor,
+          OutputBroadcaster segment_output_broadcaster(span_size, output,
                                                        first_span * span_size, last_span * span_size);
 
           BroadcastHelper segment_helper(segment_input_broadcaster, segment_output_broadcaster, user_data);
@@ -1818,6 +1956,38 @@ void UntypedBroadcastTwo(OpKernelContext& context, const ProcessBroadcastSpanFun
   }
 }
 
+}  // namespace
+
+// Broadcast two inputs with no parallelization.
+//
+// This function is type agnostic, and uses function pointers instead of std::function, to minimize binary size.
+// Type specific logic is plugged in via the functions in ProcessBroadcastSpanFuncs.
+// Optional user_data can be provided, and will be available to the ProcessSpanFunc implementations
+// via BroadcastHelper.GetUserData().
+void UntypedBroadcastTwo(OpKernelContext& context, const ProcessBroadcastSpanFuncs& funcs, void* user_data) {
+  const Tensor& input0_tensor = *context.Input<Tensor>(0);
+  const Tensor& input1_tensor = *context.Input<Tensor>(1);
+  InputBroadcaster input_broadcaster(input0_tensor, input1_tensor);
+  Tensor& output_tensor = *context.Output(0, input_broadcaster.GetOutputShape());
+
+  BroadcastTwo(context, input_broadcaster, input0_tensor, input1_tensor, output_tensor, funcs, nullptr, 0.0,
+               user_data);
+}
+
+// Variant of UntypedBroadcastTwo that will parallelize.
+// Operator usage is the same as the parallelization is opaque to the operator.
+// unit_cost must be a valid cost value.
+void UntypedBroadcastTwo(OpKernelContext& context, const ProcessBroadcastSpanFuncs& funcs, double unit_cost,
+                         void* user_data) {
+  const Tensor& input0_tensor = *context.Input<Tensor>(0);
+  const Tensor& input1_tensor = *context.Input<Tensor>(1);
+  InputBroadcaster input_broadcaster(input0_tensor, input1_tensor);
+  Tensor& output_tensor = *context.Output(0, input_broadcaster.GetOutputShape());
+
+  BroadcastTwo(context, input_broadcaster, input0_tensor, input1_tensor, output_tensor, funcs,
+               context.GetOperatorThreadPool(), unit_cost, user_data);
+}
+
 // allocate_tensor should allocate a tensor of the output type with the given shape
 static void UntypedBroadcastVariadic(int input_count, OpKernelContext& context,
                                      AllocateTensorFunc allocate_tensor,
@@ -1852,10 +2022,7 @@ static void UntypedBroadcastVariadic(int input_count, OpKernelContext& context,
       p_output = temp_output.get();
     }
 
-    OutputBroadcaster output_broadcaster(input_broadcaster.GetSpanSize(), *p_output);
-    BroadcastHelper broadcast_helper(input_broadcaster, output_broadcaster);
-
-    BroadcastLooper(broadcast_helper, funcs);
+    BroadcastTwo(context, input_broadcaster, tensor0, tensor1, *p_output, funcs, nullptr, 0.0, nullptr);
 
     temp_input = std::move(temp_output);
   }
@@ -28,6 +28,11 @@ class Gemm : protected GemmBase, public OpKernel {
                                    int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status UseSavedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                  int input_idx,
+                                  const TensorShape& tensor_shape,
+                                  /*out*/ bool& used_saved_buffers) override;
+
   static void ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
                           int64_t M, int64_t N, int64_t K,
                           float alpha,
@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include "core/framework/config_options.h"
 #include "core/framework/op_kernel.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 
@@ -27,6 +29,10 @@ class MatMul<float> final : public OpKernel {
     info.GetAttrOrDefault<int64_t>("transBatchB", &trans_batch_b_attr, 0);
     trans_batch_a_ = trans_batch_a_attr != 0;
     trans_batch_b_ = trans_batch_b_attr != 0;
+    use_bf16_weights_ =
+        info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsConfigMlasGemmBf16Weights, "0") == "1";
+    tune_thread_partition_ =
+        info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsConfigMlasGemmTuneThreadPartition, "0") == "1";
   }
 
   Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
@@ -36,12 +42,21 @@ class MatMul<float> final : public OpKernel {
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status UseSavedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                  const TensorShape& tensor_shape, /*out*/ bool& used_saved_buffers) override;
+
   Status Compute(OpKernelContext* context) const override;
 
  private:
   TensorShape b_shape_;
   BufferUniquePtr packed_b_;
 
+  // packed_b_ holds bfloat16 weights for MlasSBGemmBatch instead of MlasGemmBatch
+  bool use_bf16_weights_;
+
+  // float multiplications tune their thread partition with cpu::tunable::TunedGemmBatch
+  bool tune_thread_partition_;
+
   // For FusedMatMul contrib ops
   float alpha_attr_;
   int64_t trans_a_attr_;
@@ -50,4 +65,26 @@ class MatMul<float> final : public OpKernel {
   bool trans_batch_b_;
 };
 
+template <>
+class MatMul<MLFloat16> final : public OpKernel {
+ public:
+  MatMul(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
+  Status UseSavedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                  const TensorShape& tensor_shape, /*out*/ bool& used_saved_buffers) override;
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  TensorShape b_shape_;
+  BufferUniquePtr packed_b_;
+};
+
 }  // namespace onnxruntime
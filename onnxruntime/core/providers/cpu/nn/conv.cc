@@ -296,6 +296,146 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+Status Conv<MLFloat16>::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* W = context->Input<Tensor>(1);
+  const Tensor* B = context->Input<Tensor>(2);  // optional. nullptr if not provided
+  const int64_t N = X->Shape()[0];
+  const int64_t C = X->Shape()[1];
+  const int64_t M = W->Shape()[0];
+  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X, W));
+
+  TensorShapeVector kernel_shape;
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W->Shape(), kernel_shape));
+
+  ConvPadVector pads(conv_attrs_.pads);
+  if (pads.empty()) {
+    pads.resize(kernel_shape.size() * 2, 0);
+  }
+  TensorShapeVector dilations(conv_attrs_.dilations);
+  if (dilations.empty()) {
+    dilations.resize(kernel_shape.size(), 1);
+  }
+  TensorShapeVector strides(conv_attrs_.strides);
+  if (strides.empty()) {
+    strides.resize(kernel_shape.size(), 1);
+  }
+
+  TensorShapeVector Y_dims({N, M});
+  TensorShape input_shape = X->Shape().Slice(2);
+  ORT_RETURN_IF_ERROR(conv_attrs_.InferPadsAndOutputShape(input_shape, kernel_shape, strides, dilations, pads, Y_dims));
+  Tensor* Y = context->Output(0, Y_dims);
+  TensorShape output_shape = Y->Shape().Slice(2);
+
+  // Bail out early if one of the dimensions is zero.
+  if (Y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  const size_t group_count = narrow<size_t>(conv_attrs_.group);
+  const size_t input_image_size = narrow<size_t>(input_shape.Size());
+  const size_t output_image_size = narrow<size_t>(output_shape.Size());
+  const size_t kernel_size = narrow<size_t>(TensorShape(kernel_shape).Size());
+  const size_t group_input_channels = narrow<size_t>(C) / group_count;
+  const size_t group_output_channels = narrow<size_t>(M) / group_count;
+  const size_t X_offset = group_input_channels * input_image_size;
+  const size_t Y_offset = group_output_channels * output_image_size;
+  const size_t W_offset = narrow<size_t>(W->Shape().Size()) / group_count;
+  const size_t kernel_dim = group_input_channels * kernel_size;
+  const size_t col_buffer_size = kernel_dim * output_image_size;
+
+  const size_t kernel_rank = kernel_shape.size();
+
+  BufferUniquePtr col_buffer;
+
+  // Pointwise convolutions can use the original input tensor in place,
+  // otherwise a temporary buffer is required for the im2col transform of
+  // every group of an image.
+  if (kernel_size != 1 || !conv_attrs_.HasStridesOneAndNoPadding()) {
+    AllocatorPtr alloc;
+    ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+
+    auto* col_data = alloc->Alloc(sizeof(MLAS_FP16) * SafeInt<size_t>(col_buffer_size) * group_count);
+    col_buffer = BufferUniquePtr(col_data, BufferDeleter(std::move(alloc)));
+  }
+
+  auto* col_buffer_data = static_cast<MLAS_FP16*>(col_buffer.get());
+
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
+  const auto* Xdata = reinterpret_cast<const MLAS_FP16*>(X->Data<MLFloat16>());
+  const auto* Wdata = reinterpret_cast<const MLAS_FP16*>(W->Data<MLFloat16>());
+  const auto* Bdata = B != nullptr ? reinterpret_cast<const MLAS_FP16*>(B->Data<MLFloat16>()) : nullptr;
+  auto* Ydata = reinterpret_cast<MLAS_FP16*>(Y->MutableData<MLFloat16>());
+
+  std::vector<MLAS_HALF_GEMM_DATA_PARAMS> data(group_count);
+
+  for (int64_t image_id = 0; image_id < N; ++image_id) {
+    for (size_t group_id = 0; group_id < group_count; ++group_id) {
+      const MLAS_FP16* col_data = Xdata + group_id * X_offset;
+
+      if (col_buffer_data != nullptr) {
+        MLAS_FP16* group_col_data = col_buffer_data + group_id * col_buffer_size;
+        if (kernel_rank == 2) {
+          math::Im2col<MLAS_FP16, StorageOrder::NCHW>()(
+              col_data,
+              static_cast<int64_t>(group_input_channels),
+              input_shape[0],
+              input_shape[1],
+              kernel_shape[0],
+              kernel_shape[1],
+              dilations[0],
+              dilations[1],
+              pads[0],
+              pads[1],
+              pads[2],
+              pads[3],
+              strides[0],
+              strides[1],
+              group_col_data);
+        } else {
+          math::Im2col<MLAS_FP16, StorageOrder::NCHW>()(
+              col_data,
+              input_shape.GetDims().data(),
+              output_shape.GetDims().data(),
+              static_cast<int64_t>(kernel_dim),
+              kernel_shape.data(),
+              strides.data(),
+              dilations.data(),
+              pads.data(),
+              static_cast<int>(kernel_rank),
+              group_col_data);
+        }
+        col_data = group_col_data;
+      }
+
+      // The bias is broadcast into the output rows and accumulated by the GEMM.
+      if (Bdata != nullptr) {
+        for (size_t m = 0; m < group_output_channels; m++) {
+          std::fill_n(Ydata + group_id * Y_offset + m * output_image_size, output_image_size,
+                      Bdata[group_id * group_output_channels + m]);
+        }
+      }
+
+      data[group_id].A = Wdata + group_id * W_offset;
+      data[group_id].lda = kernel_dim;
+      data[group_id].B = col_data;
+      data[group_id].ldb = output_image_size;
+      data[group_id].C = Ydata + group_id * Y_offset;
+      data[group_id].ldc = output_image_size;
+      data[group_id].beta = Bdata != nullptr ? 1.0f : 0.0f;
+    }
+
+    MlasHalfGemmBatch(CblasNoTrans, CblasNoTrans, group_output_channels, output_image_size, kernel_dim,
+                      data.data(), group_count, thread_pool);
+
+    Xdata += X_offset * group_count;
+    Ydata += Y_offset * group_count;
+  }
+
+  return Status::OK();
+}
+
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Conv,
     1, 10,
@@ -308,4 +448,18 @@ ONNX_CPU_OPERATOR_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Conv<float>);
 
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    Conv,
+    1, 10,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Conv<MLFloat16>);
+
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    Conv,
+    11,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Conv<MLFloat16>);
+
 }  // namespace onnxruntime
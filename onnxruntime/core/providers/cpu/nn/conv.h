@@ -36,4 +36,16 @@ class Conv<float> : public OpKernel {
   ConvAttributes conv_attrs_;
 };
 
+template <>
+class Conv<MLFloat16> : public OpKernel {
+ public:
+  Conv(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info) {
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  ConvAttributes conv_attrs_;
+};
+
 }  // namespace onnxruntime
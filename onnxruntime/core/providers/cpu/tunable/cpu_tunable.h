@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+
+#include "core/framework/tunable.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+// CPU kernels have no stream, so the stream of the tunable op params is unused.
+using StreamT = void*;
+
+class Timer : public ::onnxruntime::tunable::Timer<StreamT> {
+ public:
+  using TimerBase = ::onnxruntime::tunable::Timer<StreamT>;
+
+  explicit Timer(StreamT stream) : TimerBase{stream} {}
+
+  void Start() override {
+    start_ = std::chrono::steady_clock::now();
+  }
+
+  void End() override {
+    end_ = std::chrono::steady_clock::now();
+  }
+
+  float Duration() override {
+    return std::chrono::duration<float, std::milli>(end_ - start_).count();
+  }
+
+ private:
+  std::chrono::steady_clock::time_point start_;
+  std::chrono::steady_clock::time_point end_;
+};
+
+using OpParams = ::onnxruntime::tunable::OpParams<StreamT>;
+
+template <typename ParamsT>
+using Op = ::onnxruntime::tunable::Op<ParamsT>;
+
+template <typename ParamsT>
+using TunableOp = ::onnxruntime::tunable::TunableOp<ParamsT, Timer>;
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
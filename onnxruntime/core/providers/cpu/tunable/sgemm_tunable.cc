@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/tunable/sgemm_tunable.h"
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+
+#include "core/providers/cpu/tunable/cpu_tunable.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+namespace {
+
+struct SgemmParams : OpParams {
+  std::string Signature() const override {
+    return std::to_string(trans_a) + "_" + std::to_string(trans_b) + "_" + std::to_string(M) + "_" +
+           std::to_string(N) + "_" + std::to_string(K) + "_" + std::to_string(batch_size) + "_" +
+           std::to_string(thread_count);
+  }
+
+  CBLAS_TRANSPOSE trans_a;
+  CBLAS_TRANSPOSE trans_b;
+  size_t M;
+  size_t N;
+  size_t K;
+  const MLAS_SGEMM_DATA_PARAMS* data;
+  size_t batch_size;
+  concurrency::ThreadPool* thread_pool;
+  ptrdiff_t thread_count;
+
+  // Receives the partition of the candidate that ran last, which is the fastest one once tuning is done.
+  MLAS_SGEMM_THREAD_PARTITION* partition;
+};
+
+// The default partition of MlasGemmBatch, which is also used when tuning is off.
+Status DefaultPartition(const SgemmParams* params) {
+  MlasGemmGetThreadPartition(params->trans_a, params->trans_b, params->M, params->N, params->K, params->batch_size,
+                             params->partition, params->thread_pool);
+  MlasGemmBatch(params->trans_a, params->trans_b, params->M, params->N, params->K, params->data, params->batch_size,
+                params->thread_pool);
+  return Status::OK();
+}
+
+// Splits the threads of each multiplication into thread_count_n segments of columns and the remaining factor
+// of segments of rows.
+class SplitPartition {
+ public:
+  explicit SplitPartition(ptrdiff_t thread_count_n) : thread_count_n_(thread_count_n) {}
+
+  Status IsSupported(const SgemmParams* params) const {
+    // MLAS splits the columns in blocks of 16, so more segments than blocks would repeat another candidate.
+    const size_t column_blocks = (params->N + 15) / 16;
+    TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(thread_count_n_ > ThreadsPerGemm(params), "too many segments of N");
+    TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(static_cast<size_t>(thread_count_n_) > column_blocks,
+                                              "too many segments of N");
+    return Status::OK();
+  }
+
+  Status operator()(const SgemmParams* params) const {
+    ORT_RETURN_IF_ERROR(IsSupported(params));
+    MLAS_SGEMM_THREAD_PARTITION partition;
+    partition.ThreadCountN = thread_count_n_;
+    partition.ThreadCountM = std::max<ptrdiff_t>(ThreadsPerGemm(params) / thread_count_n_, 1);
+    MlasGemmBatch(params->trans_a, params->trans_b, params->M, params->N, params->K, params->data,
+                  params->batch_size, partition, params->thread_pool);
+    *params->partition = partition;
+    return Status::OK();
+  }
+
+ private:
+  static ptrdiff_t ThreadsPerGemm(const SgemmParams* params) {
+    const ptrdiff_t batch_size = static_cast<ptrdiff_t>(params->batch_size);
+    return (params->thread_count + batch_size - 1) / batch_size;
+  }
+
+  ptrdiff_t thread_count_n_;
+};
+
+class SgemmTunableOp : public TunableOp<SgemmParams> {
+ public:
+  SgemmTunableOp() {
+    this->ops_.emplace_back(DefaultPartition);
+    for (ptrdiff_t thread_count_n = 1; thread_count_n <= kMaximumThreadCountN; thread_count_n *= 2) {
+      this->ops_.emplace_back(SplitPartition{thread_count_n});
+    }
+    this->EnableTuning();
+  }
+
+ private:
+  static constexpr ptrdiff_t kMaximumThreadCountN = 256;
+};
+
+}  // namespace
+
+void TunedGemmBatch(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b, size_t M, size_t N, size_t K,
+                    const MLAS_SGEMM_DATA_PARAMS* data, size_t batch_size, concurrency::ThreadPool* thread_pool) {
+  const ptrdiff_t thread_count = concurrency::ThreadPool::DegreeOfParallelism(thread_pool);
+
+  MLAS_SGEMM_THREAD_PARTITION partition;
+
+#ifndef ORT_NO_RTTI
+  // TunableOp names the tuned op with RTTI, so tuning is not available without it.
+  const bool needs_tuning =
+      thread_count > 1 &&
+      !MlasGemmGetThreadPartition(trans_a, trans_b, M, N, K, batch_size, &partition, thread_pool) &&
+      std::all_of(data, data + batch_size, [](const MLAS_SGEMM_DATA_PARAMS& d) { return d.beta == 0.0f; });
+
+  if (needs_tuning) {
+    // The tunable op keeps the fastest candidate of every signature in a map that is not thread safe. The lock is
+    // only taken until the partition of a shape is recorded in MLAS.
+    static std::mutex mutex;
+    static SgemmTunableOp op;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    SgemmParams params;
+    params.trans_a = trans_a;
+    params.trans_b = trans_b;
+    params.M = M;
+    params.N = N;
+    params.K = K;
+    params.data = data;
+    params.batch_size = batch_size;
+    params.thread_pool = thread_pool;
+    params.thread_count = thread_count;
+    params.partition = &partition;
+
+    ORT_THROW_IF_ERROR(op(&params));
+
+    MlasGemmSetThreadPartition(trans_a, trans_b, M, N, K, batch_size, partition, thread_pool);
+    return;
+  }
+#else
+  ORT_UNUSED_PARAMETER(partition);
+#endif
+
+  MlasGemmBatch(trans_a, trans_b, M, N, K, data, batch_size, thread_pool);
+}
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
@@ -0,0 +1,23 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+// Runs MlasGemmBatch and tunes its thread partition for the shape. The first call for a shape and thread count
+// times the default partition and a set of M/N splits with the TunableOp infrastructure, then records the fastest
+// in MLAS with MlasGemmSetThreadPartition so every later MlasGemmBatch call with that shape uses it, whichever
+// kernel issues it. Tuning is skipped when beta is not zero, because timing the candidates repeats the
+// multiplication in place.
+void TunedGemmBatch(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b, size_t M, size_t N, size_t K,
+                    const MLAS_SGEMM_DATA_PARAMS* data, size_t batch_size, concurrency::ThreadPool* thread_pool);
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
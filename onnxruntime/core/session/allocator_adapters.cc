@@ -2,6 +2,11 @@
 // Licensed under the MIT License.
 
 #include "allocator_adapters.h"
+
+#include <cstring>
+#include <sstream>
+
+#include "core/common/parse_string.h"
 #include "core/session/inference_session.h"
 #include "core/session/ort_env.h"
 #include "core/session/ort_apis.h"
@@ -63,6 +68,69 @@ ORT_API_STATUS_IMPL(OrtApis::CreateAllocator, const OrtSession* sess,
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SessionGetAllocatorStats, _In_ const OrtSession* sess, _In_ const OrtMemoryInfo* mem_info,
+                    _In_reads_(num_keys) const char* const* stat_keys, _Out_writes_all_(num_keys) int64_t* stat_values,
+                    _In_ size_t num_keys) {
+  API_IMPL_BEGIN
+  auto* session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  auto allocator_ptr = session->GetAllocator(*mem_info);
+  if (!allocator_ptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "No requested allocator available");
+  }
+
+  onnxruntime::AllocatorStats stats;
+  allocator_ptr->GetStats(&stats);
+
+  static constexpr const char* kFreeBytesInBinPrefix = "free_bytes_in_bin_";
+  const size_t prefix_length = strlen(kFreeBytesInBinPrefix);
+
+  for (size_t i = 0; i < num_keys; ++i) {
+    const char* key = stat_keys[i];
+    if (strcmp(key, "num_allocs") == 0) {
+      stat_values[i] = stats.num_allocs;
+    } else if (strcmp(key, "num_reserves") == 0) {
+      stat_values[i] = stats.num_reserves;
+    } else if (strcmp(key, "num_arena_extensions") == 0) {
+      stat_values[i] = stats.num_arena_extensions;
+    } else if (strcmp(key, "num_arena_shrinkages") == 0) {
+      stat_values[i] = stats.num_arena_shrinkages;
+    } else if (strcmp(key, "bytes_in_use") == 0) {
+      stat_values[i] = stats.bytes_in_use;
+    } else if (strcmp(key, "total_allocated_bytes") == 0) {
+      stat_values[i] = stats.total_allocated_bytes;
+    } else if (strcmp(key, "max_bytes_in_use") == 0) {
+      stat_values[i] = stats.max_bytes_in_use;
+    } else if (strcmp(key, "max_alloc_size") == 0) {
+      stat_values[i] = stats.max_alloc_size;
+    } else if (strcmp(key, "bytes_limit") == 0) {
+      stat_values[i] = stats.bytes_limit;
+    } else if (strcmp(key, "num_regions") == 0) {
+      stat_values[i] = stats.num_regions;
+    } else if (strcmp(key, "largest_free_chunk") == 0) {
+      stat_values[i] = stats.largest_free_chunk;
+    } else if (strcmp(key, "num_bins") == 0) {
+      stat_values[i] = static_cast<int64_t>(stats.free_bytes_per_bin.size());
+    } else if (strncmp(key, kFreeBytesInBinPrefix, prefix_length) == 0) {
+      size_t bin = 0;
+      if (!onnxruntime::TryParseStringWithClassicLocale(std::string(key + prefix_length), bin) ||
+          bin >= stats.free_bytes_per_bin.size()) {
+        std::ostringstream oss;
+        oss << "Invalid bin in stat key: " << key;
+        return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, oss.str().c_str());
+      }
+
+      stat_values[i] = stats.free_bytes_per_bin[bin];
+    } else {
+      std::ostringstream oss;
+      oss << "Invalid key found: " << key;
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, oss.str().c_str());
+    }
+  }
+
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::CreateAndRegisterAllocator, _Inout_ OrtEnv* env,
                     _In_ const OrtMemoryInfo* mem_info,
                     _In_ const OrtArenaCfg* arena_cfg) {
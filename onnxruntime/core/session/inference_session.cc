@@ -4,6 +4,7 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/inference_session.h"
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
 #include <unordered_set>
@@ -57,6 +58,7 @@
 #include "core/session/inference_session_utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/session/onnxruntime_run_options_config_keys.h"
+#include "core/session/optimized_model_cache.h"
 #include "core/util/protobuf_parsing_utils.h"
 #include "core/util/thread_utils.h"
 
@@ -160,6 +162,9 @@ Status GetMinimalBuildOptimizationHandling(
 
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
+// the session whose RunAsync callback the current thread is invoking, if any
+thread_local const InferenceSession* run_async_callback_session = nullptr;
+
 }  // namespace
 
 std::atomic<uint32_t> InferenceSession::global_session_id_{1};
@@ -249,6 +254,8 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
 #if !defined(ORT_MINIMAL_BUILD)
   // Update the number of steps for the graph transformer manager using the "finalized" session options
   ORT_ENFORCE(graph_transformation_mgr_.SetSteps(session_options_.max_num_graph_transformation_steps).IsOK());
+  // Record the time spent in each transformer in the session profile when profiling is enabled
+  graph_transformation_mgr_.SetProfiler(&session_profiler_);
 #endif
 
   bool set_denormal_as_zero =
@@ -304,7 +311,7 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
             concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
       }
     }
-    if (session_options_.execution_mode == ExecutionMode::ORT_PARALLEL) {
+    if (session_options_.execution_mode != ExecutionMode::ORT_SEQUENTIAL) {
       if (!external_inter_op_thread_pool_) {
         bool allow_inter_op_spinning =
             session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigAllowInterOpSpinning, "1") == "1";
@@ -439,6 +446,28 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, const
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 InferenceSession::~InferenceSession() {
+  {
+    // queued RunAsync calls use the session and its thread pools
+    std::unique_lock<OrtMutex> lock(async_runs_mutex_);
+    async_runs_done_.wait(lock, [this]() { return num_pending_async_runs_ == 0; });
+  }
+
+  // A RunAsync callback may destroy the session on a thread of the RunAsync pool, which can't join itself.
+  // The pool is destroyed on another thread instead, which joins the threads once the callbacks return.
+  if (run_async_callback_session == this && run_async_thread_pool_) {
+    std::thread([thread_pool = std::move(run_async_thread_pool_)]() mutable { thread_pool.reset(); }).detach();
+  }
+
+#if !defined(ORT_MINIMAL_BUILD)
+  // the session failed to initialize after saving the optimized model of a cache entry
+  if (!optimized_model_cache_temp_suffix_.empty()) {
+    const PathString cache_path = ToPathString(
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigOptimizedModelCacheDir, ""));
+    optimized_model_cache::RemoveFile(optimized_model_cache::GetModelPath(cache_path, optimized_model_cache_key_) +
+                                      optimized_model_cache_temp_suffix_);
+  }
+#endif
+
   if (session_options_.enable_profiling) {
     ORT_TRY {
       EndProfiling();
@@ -637,6 +666,147 @@ common::Status InferenceSession::SaveToOrtFormat(const PathString& filepath) con
   return Status::OK();
 }
 
+// The cache key only covers the bytes of the model file, so a model whose initializers live in external data files
+// can't be matched against the cache.
+static bool HasExternalInitializers(const Graph& graph) {
+  for (const auto& it : graph.GetAllInitializedTensors()) {
+    if (utils::HasExternalData(*it.second)) {
+      return true;
+    }
+  }
+
+  for (const auto& node : graph.Nodes()) {
+    for (const auto& subgraph : node.GetSubgraphs()) {
+      if (HasExternalInitializers(*subgraph)) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+void InferenceSession::LoadOptimizedModelFromCache() {
+  const std::string cache_dir =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigOptimizedModelCacheDir, "");
+  if (cache_dir.empty() || optimized_model_cache_model_hash_.empty()) {
+    return;
+  }
+
+  // The key covers the model and the session options, so the cache is limited to sessions on the CPU EP whose graph
+  // depends on nothing else.
+  const auto& provider_ids = execution_providers_.GetIds();
+  const bool cpu_ep_only = std::all_of(provider_ids.cbegin(), provider_ids.cend(),
+                                       [](const std::string& id) { return id == kCpuExecutionProvider; });
+  if (!cpu_ep_only || !session_options_.optimized_model_filepath.empty() || HasLocalSchema() ||
+      !session_options_.external_initializers.empty() || !session_options_.initializers_to_share_map.empty() ||
+      HasExternalInitializers(model_->MainGraph())) {
+    LOGS(*session_logger_, INFO) << "The optimized model cache is not supported by the configuration of this session.";
+    return;
+  }
+
+  const PathString cache_path = ToPathString(cache_dir);
+  const std::string key =
+      optimized_model_cache::ComputeKey(optimized_model_cache_model_hash_, session_options_, optimizers_to_disable_);
+  const PathString model_path = optimized_model_cache::GetModelPath(cache_path, key);
+  if (!optimized_model_cache::FileExists(model_path)) {
+    LOGS(*session_logger_, INFO) << "The optimized model cache has no entry for the model. Saving it as " << key;
+    optimized_model_cache_key_ = key;
+    prepacked_weights_to_save_ = std::make_unique<PrepackedWeightsFile>();
+    return;
+  }
+
+  std::unique_ptr<PrepackedWeightsFile> prepacked_weights;
+  const PathString prepacked_weights_path = optimized_model_cache::GetPrepackedWeightsPath(cache_path, key);
+  if (optimized_model_cache::FileExists(prepacked_weights_path)) {
+    const Status status = PrepackedWeightsFile::Load(prepacked_weights_path, prepacked_weights);
+    if (!status.IsOK()) {
+      LOGS(*session_logger_, WARNING) << "Ignoring the pre-packed weights in the optimized model cache: "
+                                      << status.ErrorMessage();
+      prepacked_weights.reset();
+    }
+  }
+
+  // the optimized model replaces the loaded model, which is kept in case the optimized model can't be loaded
+  std::shared_ptr<onnxruntime::Model> loaded_model = model_;
+  const PathString loaded_model_location = model_location_;
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+    is_model_loaded_ = false;
+  }
+
+  const Status status = LoadOrtModel(model_path);
+
+  std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+  model_location_ = loaded_model_location;
+  if (!status.IsOK()) {
+    LOGS(*session_logger_, WARNING) << "Failed to load the optimized model from the cache, optimizing the model "
+                                    << "instead: " << status.ErrorMessage();
+    model_ = std::move(loaded_model);
+    ORT_IGNORE_RETURN_VALUE(SaveModelMetadata(*model_));
+    ort_format_model_bytes_ = gsl::span<const uint8_t>();
+    std::vector<uint8_t>().swap(ort_format_model_bytes_data_holder_);
+    is_model_loaded_ = true;
+    return;
+  }
+
+  LOGS(*session_logger_, INFO) << "Loaded the optimized model " << key << " from the cache with "
+                               << (prepacked_weights ? prepacked_weights->NumWeights() : 0) << " pre-packed weights.";
+  prepacked_weights_to_restore_ = std::move(prepacked_weights);
+}
+
+void InferenceSession::SaveOptimizedModelToCache() {
+  const PathString cache_path = ToPathString(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigOptimizedModelCacheDir, ""));
+  const PathString model_path = optimized_model_cache::GetModelPath(cache_path, optimized_model_cache_key_);
+
+  // The files are written to temporary paths and moved into place by SavePrepackedWeightsToCache, so another session
+  // never reads a partially written file.
+  const PathString temp_suffix = ToPathString(MakeString(".", Env::Default().GetSelfPid(), ".", session_id_, ".tmp"));
+  const Status status = SaveToOrtFormat(model_path + temp_suffix);
+  if (!status.IsOK()) {
+    LOGS(*session_logger_, WARNING) << "Failed to save the optimized model to the cache: " << status.ErrorMessage();
+    optimized_model_cache::RemoveFile(model_path + temp_suffix);
+    return;
+  }
+
+  optimized_model_cache_temp_suffix_ = temp_suffix;
+}
+
+void InferenceSession::SavePrepackedWeightsToCache() {
+  if (optimized_model_cache_temp_suffix_.empty()) {
+    return;
+  }
+
+  const PathString cache_path = ToPathString(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigOptimizedModelCacheDir, ""));
+  const PathString model_path = optimized_model_cache::GetModelPath(cache_path, optimized_model_cache_key_);
+  const PathString prepacked_weights_path =
+      optimized_model_cache::GetPrepackedWeightsPath(cache_path, optimized_model_cache_key_);
+  const PathString temp_model_path = model_path + optimized_model_cache_temp_suffix_;
+  const PathString temp_prepacked_weights_path = prepacked_weights_path + optimized_model_cache_temp_suffix_;
+  optimized_model_cache_temp_suffix_.clear();
+
+  // the pre-packed weights are moved into place first, so a session that finds the model also finds its weights
+  Status status = prepacked_weights_to_save_->Save(temp_prepacked_weights_path);
+  if (status.IsOK()) {
+    status = optimized_model_cache::RenameFile(temp_prepacked_weights_path, prepacked_weights_path);
+  }
+  if (status.IsOK()) {
+    status = optimized_model_cache::RenameFile(temp_model_path, model_path);
+  }
+
+  if (!status.IsOK()) {
+    LOGS(*session_logger_, WARNING) << "Failed to save the optimized model to the cache: " << status.ErrorMessage();
+    optimized_model_cache::RemoveFile(temp_model_path);
+    optimized_model_cache::RemoveFile(temp_prepacked_weights_path);
+    return;
+  }
+
+  LOGS(*session_logger_, INFO) << "Saved the optimized model " << optimized_model_cache_key_ << " to the cache with "
+                               << prepacked_weights_to_save_->NumWeights() << " pre-packed weights.";
+}
+
 common::Status InferenceSession::LoadWithLoader(std::function<common::Status(std::shared_ptr<Model>&)> loader,
                                                 const std::string& event_name) {
   Status status = Status::OK();
@@ -734,6 +904,13 @@ common::Status InferenceSession::Load(const PathString& model_uri) {
                            "Invoke Load().");
   }
 
+  if (!session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigOptimizedModelCacheDir, "").empty()) {
+    const Status hash_status = optimized_model_cache::HashModelFile(model_uri, optimized_model_cache_model_hash_);
+    if (!hash_status.IsOK()) {
+      LOGS(*session_logger_, WARNING) << "The optimized model cache is disabled: " << hash_status.ErrorMessage();
+    }
+  }
+
   return LoadOnnxModel(model_uri);
 #else
   return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "ONNX format model is not supported in this build.");
@@ -763,6 +940,11 @@ common::Status InferenceSession::Load(const void* model_data, int model_data_len
                            "Invoke Load().");
   }
 
+  if (!session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigOptimizedModelCacheDir, "").empty()) {
+    optimized_model_cache_model_hash_ =
+        optimized_model_cache::HashModelBytes(model_data, static_cast<size_t>(model_data_len));
+  }
+
   auto loader = [this, model_data, model_data_len](std::shared_ptr<onnxruntime::Model>& model) {
     ModelProto model_proto;
 
@@ -1271,6 +1453,10 @@ common::Status InferenceSession::Initialize() {
       have_cpu_ep = execution_providers_.Get(onnxruntime::kCpuExecutionProvider) != nullptr;
     }
 
+#if !defined(ORT_MINIMAL_BUILD)
+    LoadOptimizedModelFromCache();
+#endif
+
     // Verify that there are no external initializers in the graph if external data is disabled.
     onnxruntime::Graph& graph = model_->MainGraph();
 #ifdef DISABLE_EXTERNAL_INITIALIZERS
@@ -1352,6 +1538,7 @@ common::Status InferenceSession::Initialize() {
         session_options_.use_deterministic_compute,
         session_options_.enable_mem_reuse,
         prepacked_weights_container_);
+    session_state_->SetPrepackedWeightsFiles(prepacked_weights_to_restore_.get(), prepacked_weights_to_save_.get());
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
     // Don't want to pollute SessionState constructor since memory profile is enabled optionally.
@@ -1369,8 +1556,17 @@ common::Status InferenceSession::Initialize() {
     ORT_RETURN_IF_ERROR_SESSIONID_(kernel_registry_manager_.RegisterKernels(execution_providers_));
 
     const bool loading_ort_format = !ort_format_model_bytes_.empty();
+#if !defined(ORT_MINIMAL_BUILD)
+    // the optimized model cache holds ORT format models
+    const bool saving_to_cache = !optimized_model_cache_key_.empty();
+#else
+    const bool saving_to_cache = false;
+#endif
     const bool saving_model = !session_options_.optimized_model_filepath.empty();
     const bool saving_ort_format = [&]() {
+      if (saving_to_cache) {
+        return true;
+      }
       if (saving_model) {
         const std::string model_type = session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigSaveModelFormat, "");
         const bool has_explicit_type = !model_type.empty();
@@ -1484,6 +1680,14 @@ common::Status InferenceSession::Initialize() {
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
     }
 
+#if !defined(ORT_MINIMAL_BUILD)
+    // the cache entry is saved before the session state releases the initializers of the graph, so they aren't kept
+    // for the lifetime of the session next to their pre-packed copies
+    if (saving_to_cache && session_state_->GetFuncMgr().NumFuncs() == 0) {
+      SaveOptimizedModelToCache();
+    }
+#endif
+
     ORT_RETURN_IF_ERROR_SESSIONID_(
         session_state_->FinalizeSessionState(model_location_, kernel_registry_manager_,
                                              session_options_,
@@ -1492,6 +1696,10 @@ common::Status InferenceSession::Initialize() {
                                              saving_ort_format));
 
 #if !defined(ORT_MINIMAL_BUILD)
+    if (saving_to_cache) {
+      SavePrepackedWeightsToCache();
+    }
+
     if (saving_model) {
       if (session_state_->GetFuncMgr().NumFuncs() > 0) {
         ORT_RETURN_IF_ERROR_SESSIONID_(
@@ -1520,6 +1728,8 @@ common::Status InferenceSession::Initialize() {
     // Resolve memory pattern flags of the main graph and subgraph session states
     ResolveMemoryPatternFlags(*session_state_);
 
+    ORT_RETURN_IF_ERROR_SESSIONID_(CreateRequestBatcher());
+
     is_inited_ = true;
 
     if (!using_ort_model_bytes_for_initializers_) {
@@ -1885,6 +2095,12 @@ Status InferenceSession::Run(const RunOptions& run_options,
                              gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
                              gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
                              const std::vector<OrtDevice>* p_fetches_device_info) {
+  if (request_batcher_ != nullptr && p_fetches != nullptr &&
+      RequestBatcher::CanBatch(run_options, feeds, *p_fetches, p_fetches_device_info)) {
+    // the batcher calls back into Run with batching disabled in the RunOptions
+    return request_batcher_->Run(run_options, feed_names, feeds, output_names, *p_fetches);
+  }
+
   TimePoint tp;
   if (session_profiler_.IsEnabled()) {
     tp = session_profiler_.Start();
@@ -2014,6 +2230,8 @@ Status InferenceSession::Run(const RunOptions& run_options,
     if (!arenas_to_shrink.empty()) {
       ShrinkMemoryArenas(arenas_to_shrink);
     }
+
+    NotifyArenasOfRunEnd();
   }
 
   // keep track of telemetry
@@ -2264,6 +2482,188 @@ void InferenceSession::ShrinkMemoryArenas(gsl::span<const AllocatorPtr> arenas_t
   }
 }
 
+Status InferenceSession::RunAsync(const RunOptions* run_options, std::vector<std::string> feed_names,
+                                  std::vector<OrtValue> feeds, std::vector<std::string> output_names,
+                                  std::vector<OrtValue> fetches, RunAsyncCallback callback) {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  ORT_RETURN_IF_NOT(callback, "RunAsync requires a callback.");
+  ORT_RETURN_IF_NOT(fetches.empty() || fetches.size() == output_names.size(),
+                    "Number of pre-allocated outputs doesn't match the number of output names.");
+
+  struct AsyncRun {
+    const RunOptions* run_options;
+    std::vector<std::string> feed_names;
+    std::vector<OrtValue> feeds;
+    std::vector<std::string> output_names;
+    std::vector<OrtValue> fetches;
+    RunAsyncCallback callback;
+  };
+
+  // std::function requires a copyable target so the request is shared
+  auto async_run = std::make_shared<AsyncRun>(AsyncRun{run_options, std::move(feed_names), std::move(feeds),
+                                                       std::move(output_names), std::move(fetches),
+                                                       std::move(callback)});
+  {
+    std::lock_guard<OrtMutex> lock(async_runs_mutex_);
+    ++num_pending_async_runs_;
+  }
+
+  auto run = [this, async_run]() {
+    Status status;
+    ORT_TRY {
+      const RunOptions default_run_options;
+      status = Run(async_run->run_options ? *async_run->run_options : default_run_options,
+                   async_run->feed_names, async_run->feeds, async_run->output_names, &async_run->fetches);
+    }
+    ORT_CATCH(const std::exception& e) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = Status(common::ONNXRUNTIME, common::FAIL, e.what());
+      });
+    }
+
+    // the Run no longer uses the session, so the callback may destroy it. nothing below touches the session.
+    {
+      std::lock_guard<OrtMutex> lock(async_runs_mutex_);
+      if (--num_pending_async_runs_ == 0) {
+        async_runs_done_.notify_all();
+      }
+    }
+
+    const InferenceSession* outer_callback_session = run_async_callback_session;
+    run_async_callback_session = this;
+    ORT_TRY {
+      async_run->callback(status, async_run->fetches);
+    }
+    ORT_CATCH(const std::exception& e) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        LOGS_DEFAULT(ERROR) << "Exception from RunAsync callback: " << e.what();
+      });
+    }
+    run_async_callback_session = outer_callback_session;
+
+    async_run->feeds.clear();
+    async_run->fetches.clear();
+    async_run->callback = nullptr;
+  };
+
+  // A dedicated pool is used rather than the intra-op or inter-op pool. Nested ParallelFor calls from an intra-op
+  // thread run inline, so a Run on that pool would lose its intra-op parallelism and take threads from synchronous
+  // Run calls. A Run on an inter-op thread could block it waiting for node tasks of a parallel execution that are
+  // queued on the same pool.
+  auto* thread_pool = GetRunAsyncThreadPool();
+  if (thread_pool == nullptr) {
+    run();
+  } else {
+    concurrency::ThreadPool::Schedule(thread_pool, std::move(run));
+  }
+
+  return Status::OK();
+}
+
+concurrency::ThreadPool* InferenceSession::GetRunAsyncThreadPool() {
+  std::lock_guard<OrtMutex> lock(async_runs_mutex_);
+  if (!run_async_thread_pool_created_) {
+    run_async_thread_pool_created_ = true;
+
+    OrtThreadPoolParams to = session_options_.inter_op_param;
+    std::basic_stringstream<ORTCHAR_T> ss;
+    if (to.name) {
+      ss << to.name << ORT_TSTR("-");
+    }
+    ss << ORT_TSTR("session-") << session_id_ << ORT_TSTR("-run-async");
+    run_async_thread_pool_name_ = ss.str();
+    to.name = run_async_thread_pool_name_.c_str();
+    // the threads run the kernels of sequential executions
+    to.set_denormal_as_zero =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigSetDenormalAsZero, "0") == "1";
+    // the threads mostly wait for the intra-op pool
+    to.auto_set_affinity = false;
+    to.allow_spinning = false;
+    to.custom_create_thread_fn = session_options_.custom_create_thread_fn;
+    to.custom_thread_creation_options = session_options_.custom_thread_creation_options;
+    to.custom_join_thread_fn = session_options_.custom_join_thread_fn;
+
+    run_async_thread_pool_ =
+        concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTER_OP);
+    if (run_async_thread_pool_ == nullptr) {
+      LOGS(*session_logger_, INFO) << "No thread pool for RunAsync. Runs are executed by the calling thread.";
+    }
+  }
+
+  return run_async_thread_pool_.get();
+}
+
+common::Status InferenceSession::CreateRequestBatcher() {
+  const auto& config_options = session_options_.config_options;
+  const std::string max_batch_size_str =
+      config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize, "0");
+  int64_t max_batch_size = 0;
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(max_batch_size_str, max_batch_size) && max_batch_size >= 0,
+                    "Invalid value for ", kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize, ": ",
+                    max_batch_size_str);
+  if (max_batch_size <= 1) {
+    return Status::OK();
+  }
+
+  const std::string max_wait_str =
+      config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBatchingMaxWaitMicros, "1000");
+  int64_t max_wait_us = 0;
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(max_wait_str, max_wait_us) && max_wait_us >= 0,
+                    "Invalid value for ", kOrtSessionOptionsConfigDynamicBatchingMaxWaitMicros, ": ", max_wait_str);
+
+  // inputs and outputs with a fixed first dimension can't be concatenated or split along it.
+  // unknown shapes are accepted, outputs are checked again after each batched Run.
+  const auto has_batch_dimension = [](const NodeArg* node_arg) {
+    const auto* shape = node_arg->Shape();
+    return shape == nullptr || (shape->dim_size() > 0 && !utils::HasDimValue(shape->dim(0)));
+  };
+
+  const auto& graph_viewer = session_state_->GetGraphViewer();
+  for (const auto* node_args : {&graph_viewer.GetInputs(), &graph_viewer.GetOutputs()}) {
+    for (const auto* node_arg : *node_args) {
+      if (!has_batch_dimension(node_arg)) {
+        LOGS(*session_logger_, WARNING) << "Dynamic batching is disabled as the first dimension of '"
+                                        << node_arg->Name() << "' is not a symbolic batch dimension.";
+        return Status::OK();
+      }
+    }
+  }
+
+  auto cpu_allocator = session_state_->GetAllocator(OrtDevice());
+  ORT_RETURN_IF(cpu_allocator == nullptr, "Dynamic batching requires a CPU allocator.");
+
+  auto run_fn = [this](const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                       gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                       std::vector<OrtValue>* p_fetches) {
+    return Run(run_options, feed_names, feeds, output_names, p_fetches);
+  };
+
+  request_batcher_ = std::make_unique<RequestBatcher>(static_cast<size_t>(max_batch_size),
+                                                      std::chrono::microseconds(max_wait_us),
+                                                      std::move(cpu_allocator), std::move(run_fn));
+  LOGS(*session_logger_, INFO) << "Dynamic batching enabled with max batch size " << max_batch_size
+                               << " and max wait " << max_wait_us << "us.";
+  return Status::OK();
+}
+
+void InferenceSession::NotifyArenasOfRunEnd() {
+  // an arena can be shared by several execution providers, make sure each sees one run end per Run
+  InlinedVector<IAllocator*> arenas;
+  for (const auto& xp : execution_providers_) {
+    for (const auto& alloc : xp->GetAllocators()) {
+      if (alloc->Info().alloc_type == OrtAllocatorType::OrtArenaAllocator &&
+          std::find(arenas.begin(), arenas.end(), alloc.get()) == arenas.end()) {
+        arenas.push_back(alloc.get());
+        static_cast<BFCArena*>(alloc.get())->OnRunEnd();
+      }
+    }
+  }
+}
+
 #if !defined(ORT_MINIMAL_BUILD)
 // assumes model has already been loaded before
 common::Status InferenceSession::DoPostLoadProcessing(onnxruntime::Model& model) {
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 
@@ -23,6 +24,7 @@
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/insert_cast_transformer.h"
 #include "core/framework/session_options.h"
+#include "core/session/request_batcher.h"
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
 #include "core/language_interop_ops/language_interop_ops.h"
 #endif
@@ -340,6 +342,26 @@ class InferenceSession {
   virtual common::Status Run(const RunOptions& run_options, IOBinding& io_binding) ORT_MUST_USE_RESULT;
   common::Status Run(IOBinding& io_binding) ORT_MUST_USE_RESULT;
 
+  /**
+   * Called when an asynchronous Run completes. fetches holds the outputs in the order of the output names
+   * if status is OK.
+   */
+  using RunAsyncCallback = std::function<void(const common::Status& status, std::vector<OrtValue>& fetches)>;
+
+  /**
+   * Queues a Run on a thread pool of the session dedicated to RunAsync and returns without waiting for it.
+   * The pool is created on the first call with the inter-op thread pool options. The callback is invoked from the
+   * thread pool when the Run completes, or from the calling thread if there is no pool (the inter-op options ask for
+   * a single thread) or the pool can't queue more work. The callback may destroy the session.
+   * The Run can be cancelled by setting run_options->terminate.
+   * @param run_options options for the Run. Can be nullptr. Must stay valid until the callback is invoked.
+   * @param fetches pre-allocated outputs, or empty OrtValue instances for the outputs to allocate.
+   * @return OK if the Run was queued. Errors of the Run itself are reported to the callback.
+   */
+  common::Status RunAsync(const RunOptions* run_options, std::vector<std::string> feed_names,
+                          std::vector<OrtValue> feeds, std::vector<std::string> output_names,
+                          std::vector<OrtValue> fetches, RunAsyncCallback callback) ORT_MUST_USE_RESULT;
+
 #ifdef ENABLE_TRAINING
   /**
    * Partially run a pre-loaded and pre-intialized model.
@@ -503,6 +525,9 @@ class InferenceSession {
 
   bool IsInitialized() const;
 
+  // nullptr unless dynamic batching is enabled and supported by the model
+  const RequestBatcher* GetRequestBatcher() const { return request_batcher_.get(); }
+
   // Use these 2 threadpool methods to get access to the threadpools since they rely on
   // specific flags in session options
   // These methods assume that session options have been finalized before the call.
@@ -530,6 +555,9 @@ class InferenceSession {
     }
   }
 
+  // Creates the thread pool of RunAsync on first use. Returns nullptr if there is none.
+  onnxruntime::concurrency::ThreadPool* GetRunAsyncThreadPool();
+
   /// convenience pointer to logger. should always be the same as session_state_.Logger();
   const logging::Logger* session_logger_;
 
@@ -566,6 +594,18 @@ class InferenceSession {
   }
 
   common::Status SaveToOrtFormat(const PathString& filepath) const;
+
+  // Replace the loaded model with the optimized model in the cache set by kOrtSessionOptionsConfigOptimizedModelCacheDir
+  // if there is one, or prepare to save the optimized model to the cache.
+  void LoadOptimizedModelFromCache();
+
+  // Save the optimized model to a temporary file of the cache. Called before the session state is finalized, which
+  // releases the initializers the model holds. Failures are logged and don't fail the session.
+  void SaveOptimizedModelToCache();
+
+  // Save the pre-packed weights of the finalized session state next to the optimized model saved by
+  // SaveOptimizedModelToCache and move both into the cache. Failures are logged and don't fail the session.
+  void SavePrepackedWeightsToCache();
 #endif
 
   /**
@@ -630,6 +670,18 @@ class InferenceSession {
    */
   void ShrinkMemoryArenas(gsl::span<const AllocatorPtr> arenas_to_shrink);
 
+  /*
+   * Lets the arenas of the execution providers release memory regions that stayed idle for the number of
+   * Run calls configured by their shrink_idle_runs setting.
+   */
+  void NotifyArenasOfRunEnd();
+
+  /*
+   * Creates request_batcher_ if dynamic batching is enabled in the session options and every graph input and
+   * output has the batch as its first dimension.
+   */
+  common::Status CreateRequestBatcher();
+
 #if !defined(ORT_MINIMAL_BUILD)
   virtual common::Status AddPredefinedTransformers(
       GraphTransformerManager& transformer_manager,
@@ -669,6 +721,22 @@ class InferenceSession {
   MemoryProfiler memory_profiler_;
 #endif
 
+#if !defined(ORT_MINIMAL_BUILD)
+  // Hash of the loaded ONNX model, set when the optimized model cache is enabled.
+  std::string optimized_model_cache_model_hash_;
+
+  // Key the optimized model is saved under in the optimized model cache when the cache has no entry for the model.
+  std::string optimized_model_cache_key_;
+
+  // Suffix of the temporary files of the cache entry being saved. Empty unless the optimized model was saved.
+  PathString optimized_model_cache_temp_suffix_;
+#endif
+
+  // Pre-packed weights loaded from or to be saved in the optimized model cache. The kernels in session_state_
+  // may use their buffers, so they're declared first to outlive it.
+  std::unique_ptr<PrepackedWeightsFile> prepacked_weights_to_restore_;
+  std::unique_ptr<PrepackedWeightsFile> prepacked_weights_to_save_;
+
   // Immutable state for each op in the model. Shared by all executors.
   // It has a dependency on execution_providers_.
   std::unique_ptr<SessionState> session_state_;
@@ -735,6 +803,19 @@ class InferenceSession {
   // Number of concurrently running executors
   std::atomic<int> current_num_runs_ = 0;
 
+  // RunAsync calls whose Run hasn't completed yet. The destructor waits for them.
+  OrtMutex async_runs_mutex_;
+  OrtCondVar async_runs_done_;
+  int num_pending_async_runs_ = 0;  // GUARDED_BY(async_runs_mutex_)
+
+  // Thread pool of RunAsync, created on its first call. Nullptr if the inter-op options ask for a single thread.
+  std::basic_string<ORTCHAR_T> run_async_thread_pool_name_;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> run_async_thread_pool_;  // GUARDED_BY(async_runs_mutex_)
+  bool run_async_thread_pool_created_ = false;                                    // GUARDED_BY(async_runs_mutex_)
+
+  // Coalesces concurrent Run calls when dynamic batching is enabled
+  std::unique_ptr<RequestBatcher> request_batcher_;
+
   mutable onnxruntime::OrtMutex session_mutex_;  // to ensure only one thread can invoke Load/Initialize
   bool is_model_loaded_ = false;                 // GUARDED_BY(session_mutex_)
   bool is_inited_ = false;                       // GUARDED_BY(session_mutex_)
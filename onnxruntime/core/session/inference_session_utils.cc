@@ -45,13 +45,14 @@ static Status SetInterOpNumThreads(SessionOptions& session_options,
 static Status SetExecutionMode(SessionOptions& session_options,
                                int value,
                                const logging::Logger& logger) {
-  if (value != 0 && value != 1) {
+  if (value != 0 && value != 1 && value != 2) {
     LOGS(logger, ERROR) << "Unsupported execution_mode value in ORT config: " << value;
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unsupported execution_mode value in ORT config: ", value);
   }
 
-  LOGS(logger, INFO) << "Setting execution_mode to " << (value == 0 ? "Sequential mode" : "Parallel mode");
-  session_options.execution_mode = (value == 0 ? ExecutionMode::ORT_SEQUENTIAL : ExecutionMode::ORT_PARALLEL);
+  static constexpr const char* mode_names[] = {"Sequential mode", "Parallel mode", "Parallel work stealing mode"};
+  LOGS(logger, INFO) << "Setting execution_mode to " << mode_names[value];
+  session_options.execution_mode = static_cast<ExecutionMode>(value);
   return Status::OK();
 }
 
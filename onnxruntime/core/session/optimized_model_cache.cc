@@ -0,0 +1,199 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include "core/session/optimized_model_cache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "core/common/cpuid_info.h"
+#include "core/framework/murmurhash3.h"
+#include "core/platform/path_lib.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+namespace onnxruntime {
+namespace optimized_model_cache {
+
+namespace {
+
+// Data is hashed in chunks of this size, so hashing a file and hashing its bytes in memory produce the same hash.
+constexpr size_t kChunkSize = 1 << 20;
+
+// 128-bit hash of a sequence of values, built by hashing each chunk of data and then the previous hash together
+// with the hash of the chunk.
+class Hasher {
+ public:
+  void Update(const void* data, size_t size) {
+    const auto* bytes = static_cast<const char*>(data);
+    do {
+      const size_t chunk_size = std::min(size, kChunkSize);
+      uint32_t combined[8];
+      memcpy(combined, state_, sizeof(state_));
+      MurmurHash3::x86_128(bytes, static_cast<int>(chunk_size), 0, combined + 4);
+      MurmurHash3::x86_128(combined, static_cast<int>(sizeof(combined)), 0, state_);
+      bytes += chunk_size;
+      size -= chunk_size;
+    } while (size > 0);
+  }
+
+  void Update(const std::string& value) {
+    Update(static_cast<uint64_t>(value.size()));
+    Update(value.data(), value.size());
+  }
+
+  void Update(uint64_t value) {
+    Update(&value, sizeof(value));
+  }
+
+  std::string ToString() const {
+    std::ostringstream ss;
+    ss << std::hex << std::setfill('0');
+    for (uint32_t word : state_) {
+      ss << std::setw(8) << word;
+    }
+    return ss.str();
+  }
+
+ private:
+  uint32_t state_[4] = {};
+};
+
+std::string GetCpuFeatures() {
+  const auto& cpu_info = CPUIDInfo::GetCPUIDInfo();
+  const bool features[] = {
+      cpu_info.HasSSE3(), cpu_info.HasSSE4_1(), cpu_info.HasAVX(), cpu_info.HasAVX2(), cpu_info.HasF16C(),
+      cpu_info.HasAVX512f(), cpu_info.HasAVX512Skylake(), cpu_info.HasAVX512_BF16(), cpu_info.HasAMX_BF16(),
+      cpu_info.HasArmNeonDot(), cpu_info.HasArmNeon_FP16()};
+
+  std::string result;
+  for (bool feature : features) {
+    result += feature ? '1' : '0';
+  }
+  return result;
+}
+
+PathString GetEntryPath(const PathString& cache_dir, const std::string& key, const char* extension) {
+  PathString path = cache_dir;
+  if (!path.empty() && path.back() != GetPathSep<ORTCHAR_T>()) {
+    path += GetPathSep<ORTCHAR_T>();
+  }
+  return path + ToPathString(key) + ToPathString(extension);
+}
+
+}  // namespace
+
+std::string HashModelBytes(const void* model_data, size_t model_data_len) {
+  Hasher hasher;
+  hasher.Update(model_data, model_data_len);
+  return hasher.ToString();
+}
+
+Status HashModelFile(const PathString& model_path, /*out*/ std::string& model_hash) {
+  std::ifstream file(model_path, std::ios::binary);
+  ORT_RETURN_IF_NOT(file, "Failed to open model file: ", ToUTF8String(model_path));
+
+  Hasher hasher;
+  std::vector<char> chunk(kChunkSize);
+  bool empty = true;
+  while (file) {
+    file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    const auto read = static_cast<size_t>(file.gcount());
+    if (read > 0 || empty) {
+      hasher.Update(chunk.data(), read);
+      empty = false;
+    }
+  }
+  ORT_RETURN_IF_NOT(file.eof(), "Failed to read model file: ", ToUTF8String(model_path));
+
+  model_hash = hasher.ToString();
+  return Status::OK();
+}
+
+std::string ComputeKey(const std::string& model_hash, const SessionOptions& session_options,
+                       const InlinedHashSet<std::string>& optimizers_to_disable) {
+  Hasher hasher;
+  hasher.Update(model_hash);
+  hasher.Update(std::string(ORT_VERSION));
+  hasher.Update(GetCpuFeatures());
+  hasher.Update(static_cast<uint64_t>(session_options.graph_optimization_level));
+  hasher.Update(static_cast<uint64_t>(session_options.use_deterministic_compute));
+
+  // the entries of the maps and sets are sorted so the key doesn't depend on their order
+  std::vector<std::pair<std::string, std::string>> config_entries;
+  for (const auto& entry : session_options.config_options.configurations) {
+    if (entry.first != kOrtSessionOptionsConfigOptimizedModelCacheDir) {
+      config_entries.push_back(entry);
+    }
+  }
+  std::sort(config_entries.begin(), config_entries.end());
+  hasher.Update(static_cast<uint64_t>(config_entries.size()));
+  for (const auto& entry : config_entries) {
+    hasher.Update(entry.first);
+    hasher.Update(entry.second);
+  }
+
+  hasher.Update(static_cast<uint64_t>(session_options.free_dimension_overrides.size()));
+  for (const auto& free_dimension_override : session_options.free_dimension_overrides) {
+    hasher.Update(free_dimension_override.dim_identifier);
+    hasher.Update(static_cast<uint64_t>(free_dimension_override.dim_identifer_type));
+    hasher.Update(static_cast<uint64_t>(free_dimension_override.dim_value));
+  }
+
+  std::vector<std::string> disabled(optimizers_to_disable.begin(), optimizers_to_disable.end());
+  std::sort(disabled.begin(), disabled.end());
+  hasher.Update(static_cast<uint64_t>(disabled.size()));
+  for (const auto& optimizer : disabled) {
+    hasher.Update(optimizer);
+  }
+
+  return hasher.ToString();
+}
+
+PathString GetModelPath(const PathString& cache_dir, const std::string& key) {
+  return GetEntryPath(cache_dir, key, ".ort");
+}
+
+PathString GetPrepackedWeightsPath(const PathString& cache_dir, const std::string& key) {
+  return GetEntryPath(cache_dir, key, ".prepacked");
+}
+
+bool FileExists(const PathString& path) {
+  std::ifstream file(path, std::ios::binary);
+  return file.good();
+}
+
+Status RenameFile(const PathString& from, const PathString& to) {
+#ifdef _WIN32
+  ORT_RETURN_IF_NOT(MoveFileExW(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING),
+                    "Failed to move ", ToUTF8String(from), " to ", ToUTF8String(to));
+#else
+  ORT_RETURN_IF_NOT(std::rename(from.c_str(), to.c_str()) == 0,
+                    "Failed to move ", from, " to ", to);
+#endif
+  return Status::OK();
+}
+
+void RemoveFile(const PathString& path) {
+#ifdef _WIN32
+  DeleteFileW(path.c_str());
+#else
+  std::remove(path.c_str());
+#endif
+}
+
+}  // namespace optimized_model_cache
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include <string>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/common/path_string.h"
+#include "core/framework/session_options.h"
+
+namespace onnxruntime {
+namespace optimized_model_cache {
+
+// Helpers for the cache of optimized models enabled by kOrtSessionOptionsConfigOptimizedModelCacheDir.
+// An entry consists of the optimized model in ORT format and the pre-packed weights of its CPU kernels, stored as
+// <cache dir>/<key>.ort and <cache dir>/<key>.prepacked.
+
+// Hash of the serialized model.
+std::string HashModelBytes(const void* model_data, size_t model_data_len);
+Status HashModelFile(const PathString& model_path, /*out*/ std::string& model_hash);
+
+// Key of the optimized model produced from the model with the given hash by a session with the given options.
+// It also covers the ORT version and the features of the CPU, which decide the kernels and their pre-packed layouts.
+std::string ComputeKey(const std::string& model_hash, const SessionOptions& session_options,
+                       const InlinedHashSet<std::string>& optimizers_to_disable);
+
+PathString GetModelPath(const PathString& cache_dir, const std::string& key);
+PathString GetPrepackedWeightsPath(const PathString& cache_dir, const std::string& key);
+
+bool FileExists(const PathString& path);
+
+// Moves a file written to a temporary path into place, replacing any file written by a concurrent session.
+Status RenameFile(const PathString& from, const PathString& to);
+
+void RemoveFile(const PathString& path);
+
+}  // namespace optimized_model_cache
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
@@ -0,0 +1,270 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/request_batcher.h"
+
+#include <cstring>
+
+#include "core/framework/tensor.h"
+#include "core/session/onnxruntime_run_options_config_keys.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// the batch size of a request is the first dimension of its inputs, which CanBatch checks is the same for all
+int64_t RequestBatchSize(gsl::span<const OrtValue> feeds) {
+  return feeds[0].Get<Tensor>().Shape()[0];
+}
+
+// copy of the options of a request with batching disabled, so the Run it is used for doesn't come back here
+RunOptions UnbatchedRunOptions(const RunOptions& run_options) {
+  RunOptions unbatched_run_options = run_options;
+  ORT_THROW_IF_ERROR(
+      unbatched_run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigDisableDynamicBatching, "1"));
+  return unbatched_run_options;
+}
+
+}  // namespace
+
+RequestBatcher::RequestBatcher(size_t max_batch_size, std::chrono::microseconds max_wait,
+                               AllocatorPtr cpu_allocator, RunFn run_fn)
+    : max_batch_size_(max_batch_size),
+      max_wait_(max_wait),
+      cpu_allocator_(std::move(cpu_allocator)),
+      run_fn_(std::move(run_fn)) {
+  ORT_ENFORCE(max_batch_size_ > 1, "Dynamic batching requires a max batch size larger than 1");
+  ORT_ENFORCE(cpu_allocator_ != nullptr && run_fn_);
+}
+
+bool RequestBatcher::CanBatch(const RunOptions& run_options, gsl::span<const OrtValue> feeds,
+                              const std::vector<OrtValue>& fetches,
+                              const std::vector<OrtDevice>* p_fetches_device_info) {
+  if (run_options.terminate || run_options.only_execute_path_to_fetches ||
+      !run_options.config_options.configurations.empty() || p_fetches_device_info != nullptr || feeds.empty()) {
+    return false;
+  }
+
+  for (const auto& fetch : fetches) {
+    if (fetch.IsAllocated()) {
+      return false;
+    }
+  }
+
+  int64_t batch_size = -1;
+  for (const auto& feed : feeds) {
+    if (!feed.IsTensor()) {
+      return false;
+    }
+
+    const auto& tensor = feed.Get<Tensor>();
+    if (tensor.IsDataTypeString() || tensor.Location().device.Type() != OrtDevice::CPU ||
+        tensor.Shape().NumDimensions() == 0 || tensor.Shape()[0] < 1 ||
+        (batch_size != -1 && tensor.Shape()[0] != batch_size)) {
+      return false;
+    }
+
+    batch_size = tensor.Shape()[0];
+  }
+
+  return true;
+}
+
+std::string RequestBatcher::BatchKey(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                     gsl::span<const std::string> output_names) {
+  std::string key;
+  for (size_t i = 0; i < feed_names.size(); ++i) {
+    const auto& tensor = feeds[i].Get<Tensor>();
+    key.append(feed_names[i]).push_back(':');
+    key.append(std::to_string(tensor.GetElementType()));
+    const auto dims = tensor.Shape().GetDims();
+    for (size_t d = 1; d < dims.size(); ++d) {
+      key.push_back(',');
+      key.append(std::to_string(dims[d]));
+    }
+    key.push_back(';');
+  }
+
+  key.push_back('|');
+  for (const auto& output_name : output_names) {
+    key.append(output_name).push_back(';');
+  }
+
+  return key;
+}
+
+void RequestBatcher::CloseBatch(const std::string& key, Batch& batch) {
+  batch.closed = true;
+  auto it = open_batches_.find(key);
+  if (it != open_batches_.end() && it->second.get() == &batch) {
+    open_batches_.erase(it);
+  }
+}
+
+common::Status RequestBatcher::Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                   gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                   std::vector<OrtValue>& fetches) {
+  const int64_t batch_size = RequestBatchSize(feeds);
+  if (static_cast<size_t>(batch_size) >= max_batch_size_) {
+    return run_fn_(UnbatchedRunOptions(run_options), feed_names, feeds, output_names, &fetches);
+  }
+
+  const std::string key = BatchKey(feed_names, feeds, output_names);
+  Request request{feeds, &fetches, 0, batch_size, Status::OK()};
+
+  std::unique_lock<OrtMutex> lock(mutex_);
+  auto it = open_batches_.find(key);
+  if (it != open_batches_.end() && static_cast<size_t>(it->second->batch_size + batch_size) > max_batch_size_) {
+    // the request doesn't fit, let the first request of the open batch run it and start a new one
+    auto& full_batch = *it->second;
+    CloseBatch(key, full_batch);
+    full_batch.cv.notify_all();
+    it = open_batches_.end();
+  }
+
+  const bool is_first_request = it == open_batches_.end();
+  std::shared_ptr<Batch> batch = is_first_request ? std::make_shared<Batch>() : it->second;
+  if (is_first_request) {
+    open_batches_.emplace(key, batch);
+  }
+
+  request.batch_offset = batch->batch_size;
+  batch->requests.push_back(&request);
+  batch->batch_size += batch_size;
+
+  if (static_cast<size_t>(batch->batch_size) == max_batch_size_) {
+    CloseBatch(key, *batch);
+    batch->cv.notify_all();
+  }
+
+  if (!is_first_request) {
+    batch->cv.wait(lock, [&batch]() { return batch->done; });
+    return request.status;
+  }
+
+  const auto deadline = std::chrono::steady_clock::now() + max_wait_;
+  while (!batch->closed) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+      CloseBatch(key, *batch);
+      break;
+    }
+
+    batch->cv.wait_for(lock, deadline - now);
+  }
+
+  ++num_batches_;
+  num_batched_requests_ += batch->requests.size();
+  lock.unlock();
+
+  // the requests of a closed batch are only accessed by this thread until it is done
+  ORT_TRY {
+    RunBatch(run_options, feed_names, output_names, *batch);
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      for (auto* batch_request : batch->requests) {
+        batch_request->status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+      }
+    });
+  }
+
+  lock.lock();
+  batch->done = true;
+  batch->cv.notify_all();
+  return request.status;
+}
+
+void RequestBatcher::RunBatch(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                              gsl::span<const std::string> output_names, Batch& batch) {
+  const RunOptions batch_run_options = UnbatchedRunOptions(run_options);
+  const auto& requests = batch.requests;
+
+  if (requests.size() == 1) {
+    auto& request = *requests[0];
+    request.status = run_fn_(batch_run_options, feed_names, request.feeds, output_names, request.fetches);
+    return;
+  }
+
+  // concatenate the inputs along the first dimension
+  std::vector<OrtValue> batched_feeds(feed_names.size());
+  for (size_t i = 0; i < feed_names.size(); ++i) {
+    const auto& first_input = requests[0]->feeds[i].Get<Tensor>();
+    TensorShape batched_shape(first_input.Shape());
+    batched_shape[0] = batch.batch_size;
+    Tensor::InitOrtValue(first_input.DataType(), batched_shape, cpu_allocator_, batched_feeds[i]);
+
+    auto* dst = static_cast<uint8_t*>(batched_feeds[i].GetMutable<Tensor>()->MutableDataRaw());
+    for (const auto* request : requests) {
+      const auto& input = request->feeds[i].Get<Tensor>();
+      const size_t num_bytes = input.SizeInBytes();
+      std::memcpy(dst, input.DataRaw(), num_bytes);
+      dst += num_bytes;
+    }
+  }
+
+  std::vector<OrtValue> batched_fetches;
+  const Status status = run_fn_(batch_run_options, feed_names, batched_feeds, output_names, &batched_fetches);
+  if (!status.IsOK()) {
+    for (auto* request : requests) {
+      request->status = status;
+    }
+    return;
+  }
+
+  bool can_split = true;
+  for (const auto& fetch : batched_fetches) {
+    if (!fetch.IsTensor()) {
+      can_split = false;
+      break;
+    }
+
+    const auto& shape = fetch.Get<Tensor>().Shape();
+    if (shape.NumDimensions() == 0 || shape[0] != batch.batch_size) {
+      can_split = false;
+      break;
+    }
+  }
+
+  if (!can_split) {
+    // the output layout doesn't follow the batch. the batched outputs are dropped and each request is run alone.
+    for (auto* request : requests) {
+      request->status = run_fn_(batch_run_options, feed_names, request->feeds, output_names, request->fetches);
+    }
+    return;
+  }
+
+  // each request gets a view into its rows of the batched outputs. the view keeps the batched output alive.
+  const auto tensor_type = DataTypeImpl::GetType<Tensor>();
+  for (auto* request : requests) {
+    auto& fetches = *request->fetches;
+    fetches.resize(output_names.size());
+    for (size_t i = 0; i < batched_fetches.size(); ++i) {
+      const OrtValue& batched_fetch = batched_fetches[i];
+      const auto& batched_output = batched_fetch.Get<Tensor>();
+      const size_t bytes_per_sample = batched_output.SizeInBytes() / static_cast<size_t>(batch.batch_size);
+
+      TensorShape shape(batched_output.Shape());
+      shape[0] = request->batch_size;
+      auto view = std::make_unique<Tensor>(batched_output.DataType(), shape,
+                                           const_cast<void*>(batched_output.DataRaw()),
+                                           batched_output.Location(),
+                                           static_cast<ptrdiff_t>(bytes_per_sample * request->batch_offset));
+      fetches[i].Init(view.release(), tensor_type, [batched_fetch](void* p) {
+        delete static_cast<Tensor*>(p);
+      });
+    }
+  }
+}
+
+size_t RequestBatcher::NumBatches() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return num_batches_;
+}
+
+size_t RequestBatcher::NumBatchedRequests() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return num_batched_requests_;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/gsl.h"
+#include "core/common/inlined_containers.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/run_options.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+ * Coalesces concurrent Run calls of a session into batched Run calls.
+ *
+ * Requests with the same input and output names, element types and input shapes apart from the first dimension
+ * are concatenated along the first dimension. The first request of a batch waits until the batch holds
+ * max_batch_size samples or max_wait has elapsed, runs the batch on behalf of all requests and splits the outputs.
+ * Outputs are returned as views into the batched output, which stays alive until all of them are released, so no
+ * copy is made on the way out. If an output doesn't have the batch size as its first dimension the requests of
+ * the batch are run one by one instead.
+ *
+ * All graph inputs and outputs must have the batch as their first dimension, which InferenceSession checks before
+ * creating the batcher.
+ */
+class RequestBatcher {
+ public:
+  // Runs a request without batching
+  using RunFn = std::function<common::Status(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                             gsl::span<const OrtValue> feeds,
+                                             gsl::span<const std::string> output_names,
+                                             std::vector<OrtValue>* p_fetches)>;
+
+  RequestBatcher(size_t max_batch_size, std::chrono::microseconds max_wait, AllocatorPtr cpu_allocator,
+                 RunFn run_fn);
+
+  // Returns true if the request can go through Run. Requests with pre-allocated outputs, specific output devices,
+  // inputs that aren't dense CPU tensors, RunOptions config entries or a terminate request are not batched.
+  static bool CanBatch(const RunOptions& run_options, gsl::span<const OrtValue> feeds,
+                       const std::vector<OrtValue>& fetches, const std::vector<OrtDevice>* p_fetches_device_info);
+
+  // Adds the request to a batch and blocks until the batch has run. The logging options of the first request
+  // apply to the batch. Terminating a request after it joined a batch has no effect.
+  common::Status Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                     gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                     std::vector<OrtValue>& fetches);
+
+  // number of batched Run calls and number of requests they served
+  size_t NumBatches() const;
+  size_t NumBatchedRequests() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RequestBatcher);
+
+  struct Request {
+    gsl::span<const OrtValue> feeds;
+    std::vector<OrtValue>* fetches;
+    int64_t batch_offset;
+    int64_t batch_size;
+    common::Status status;
+  };
+
+  struct Batch {
+    std::vector<Request*> requests;
+    int64_t batch_size = 0;
+    // no more requests can join
+    bool closed = false;
+    bool done = false;
+    // the first request waits for the batch to close, the others for it to be done
+    OrtCondVar cv;
+  };
+
+  static std::string BatchKey(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                              gsl::span<const std::string> output_names);
+
+  void CloseBatch(const std::string& key, Batch& batch);
+
+  void RunBatch(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                gsl::span<const std::string> output_names, Batch& batch);
+
+  const size_t max_batch_size_;
+  const std::chrono::microseconds max_wait_;
+  const AllocatorPtr cpu_allocator_;
+  const RunFn run_fn_;
+
+  mutable OrtMutex mutex_;
+  // batches that requests can still join
+  InlinedHashMap<std::string, std::shared_ptr<Batch>> open_batches_;
+  size_t num_batches_{0};
+  size_t num_batched_requests_{0};
+};
+
+}  // namespace onnxruntime
@@ -1063,7 +1063,8 @@ void addObjectMethods(py::module& m, Environment& env, ExecutionProviderRegistra
 
   py::enum_<ExecutionMode>(m, "ExecutionMode")
       .value("ORT_SEQUENTIAL", ExecutionMode::ORT_SEQUENTIAL)
-      .value("ORT_PARALLEL", ExecutionMode::ORT_PARALLEL);
+      .value("ORT_PARALLEL", ExecutionMode::ORT_PARALLEL)
+      .value("ORT_PARALLEL_WORK_STEALING", ExecutionMode::ORT_PARALLEL_WORK_STEALING);
 
   py::enum_<ExecutionOrder>(m, "ExecutionOrder")
       .value("DEFAULT", ExecutionOrder::DEFAULT)
@@ -1116,6 +1117,10 @@ void addObjectMethods(py::module& m, Environment& env, ExecutionProviderRegistra
         ort_arena_cfg->max_dead_bytes_per_chunk = kvp.second.cast<int>();
       } else if (key == "initial_growth_chunk_size_bytes") {
         ort_arena_cfg->initial_growth_chunk_size_bytes = kvp.second.cast<int>();
+      } else if (key == "max_thread_cache_bytes") {
+        ort_arena_cfg->max_thread_cache_bytes = kvp.second.cast<size_t>();
+      } else if (key == "shrink_idle_runs") {
+        ort_arena_cfg->shrink_idle_runs = kvp.second.cast<int>();
         } else {
         ORT_THROW("Invalid OrtArenaCfg option: ", key);
       }
@@ -1126,7 +1131,9 @@ void addObjectMethods(py::module& m, Environment& env, ExecutionProviderRegistra
       .def_readwrite("arena_extend_strategy", &OrtArenaCfg::arena_extend_strategy)
       .def_readwrite("initial_chunk_size_bytes", &OrtArenaCfg::initial_chunk_size_bytes)
       .def_readwrite("max_dead_bytes_per_chunk", &OrtArenaCfg::max_dead_bytes_per_chunk)
-      .def_readwrite("initial_growth_chunk_size_bytes", &OrtArenaCfg::initial_growth_chunk_size_bytes);
+      .def_readwrite("initial_growth_chunk_size_bytes", &OrtArenaCfg::initial_growth_chunk_size_bytes)
+      .def_readwrite("max_thread_cache_bytes", &OrtArenaCfg::max_thread_cache_bytes)
+      .def_readwrite("shrink_idle_runs", &OrtArenaCfg::shrink_idle_runs);
 
   py::class_<OrtMemoryInfo> ort_memory_info_binding(m, "OrtMemoryInfo");
   ort_memory_info_binding.def(py::init([](const char* name, OrtAllocatorType type, int id, OrtMemType mem_type) {
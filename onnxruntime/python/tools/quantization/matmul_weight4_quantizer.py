@@ -0,0 +1,232 @@
+# -------------------------------------------------------------------------
+# Copyright (c) Microsoft Corporation.  All rights reserved.
+# Licensed under the MIT License.  See License.txt in the project root for
+# license information.
+# --------------------------------------------------------------------------
+
+import argparse
+import logging
+from typing import Dict
+
+import numpy as np
+import numpy.typing as npt
+import onnx
+from onnx.onnx_pb import GraphProto, ModelProto, NodeProto, TensorProto
+
+from .onnx_model import ONNXModel
+from .quant_utils import ms_domain
+
+logger = logging.getLogger(__name__)
+
+
+class MatMulWeight4Quantizer:
+    """Perform 4b quantization of constant MatMul weights.
+
+    The weights are packed into the block-wise layout consumed by the
+    com.microsoft.MatMulFpQ4 operator, see MLAS_BLK_QUANT_TYPE in mlas.h.
+    """
+
+    ##################
+    # quantization types, must be consistent with native code type
+    # MLAS_BLK_QUANT_TYPE defined in mlas.h
+
+    # 32 number block, symmetric quantization, with one fp32 as scale, zero point is always 8
+    BlkQ4Sym32 = 0
+    # 32 number block, quantization, with one fp32 as scale, one uint8 zero point
+    BlkQ4Zp32 = 1
+    # 128 number block, symmetric quantization, with one fp32 as scale, zero point is always 8
+    BlkQ4Sym128 = 2
+    # 128 number block, quantization, with one fp32 as scale, one uint8 zero point
+    BlkQ4Zp128 = 3
+
+    def __init__(self, model: ModelProto, quant_type: int = BlkQ4Sym32):
+        if quant_type not in (
+            MatMulWeight4Quantizer.BlkQ4Sym32,
+            MatMulWeight4Quantizer.BlkQ4Zp32,
+            MatMulWeight4Quantizer.BlkQ4Sym128,
+            MatMulWeight4Quantizer.BlkQ4Zp128,
+        ):
+            raise ValueError(f"Unsupported quantization type {quant_type}")
+        self.model = ONNXModel(model)
+        self.quant_type = quant_type
+
+    @staticmethod
+    def block_length(quant_type: int) -> int:
+        return 32 if quant_type in (MatMulWeight4Quantizer.BlkQ4Sym32, MatMulWeight4Quantizer.BlkQ4Zp32) else 128
+
+    @staticmethod
+    def has_zero_point(quant_type: int) -> bool:
+        return quant_type in (MatMulWeight4Quantizer.BlkQ4Zp32, MatMulWeight4Quantizer.BlkQ4Zp128)
+
+    @staticmethod
+    def packed_size(quant_type: int, n: int, k: int) -> int:
+        blk_len = MatMulWeight4Quantizer.block_length(quant_type)
+        blob_size = 4 + (1 if MatMulWeight4Quantizer.has_zero_point(quant_type) else 0) + blk_len // 2
+        return n * ((k + blk_len - 1) // blk_len) * blob_size
+
+    @staticmethod
+    def quantize_blocks(quant_type: int, fp32weight: npt.ArrayLike):
+        """Quantize a K x N weight block-wise along K.
+
+        Returns the scales and zero points with shape (N, blocks) and the 4b
+        values with shape (N, blocks, block_length). The arithmetic is done in
+        float32 with round half to even, which matches MlasQ4GemmPackB.
+        """
+        fp32weight = np.asarray(fp32weight, dtype=np.float32)
+        if fp32weight.ndim != 2:
+            raise ValueError("Only 2-D weights can be quantized")
+
+        k, n = fp32weight.shape
+        blk_len = MatMulWeight4Quantizer.block_length(quant_type)
+        pad_len = (blk_len - k % blk_len) % blk_len
+        blocks = np.pad(fp32weight, ((0, pad_len), (0, 0)), "constant")
+        blocks = np.ascontiguousarray(blocks.T).reshape(n, -1, blk_len)
+
+        if MatMulWeight4Quantizer.has_zero_point(quant_type):
+            # The range always includes zero so that zero is exact.
+            rmin = np.minimum(blocks.min(axis=-1), np.float32(0))
+            rmax = np.maximum(blocks.max(axis=-1), np.float32(0))
+            scale = ((rmax - rmin) / np.float32(15)).astype(np.float32)
+            with np.errstate(divide="ignore", invalid="ignore"):
+                zp_fp = np.where(scale != 0, -rmin / scale, np.float32(0)).astype(np.float32)
+            zero_point = np.clip(np.rint(zp_fp), 0, 15).astype(np.float32)
+        else:
+            # The element with the largest magnitude maps to -8.
+            index = np.argmax(np.abs(blocks), axis=-1)
+            rmax = np.take_along_axis(blocks, index[..., np.newaxis], axis=-1)[..., 0]
+            scale = (rmax / np.float32(-8)).astype(np.float32)
+            zero_point = np.full(scale.shape, 8, dtype=np.float32)
+
+        with np.errstate(divide="ignore"):
+            reciprocal = np.where(scale != 0, np.float32(1) / scale, np.float32(0)).astype(np.float32)
+
+        values = np.rint(blocks * reciprocal[..., np.newaxis]) + zero_point[..., np.newaxis]
+        values = np.clip(values, 0, 15).astype(np.uint8)
+        return scale, zero_point.astype(np.uint8), values
+
+    @staticmethod
+    def pack(quant_type: int, fp32weight: npt.ArrayLike) -> np.ndarray:
+        """Quantize a K x N weight and pack it into the MatMulFpQ4 data blob."""
+        has_zp = MatMulWeight4Quantizer.has_zero_point(quant_type)
+        scale, zero_point, values = MatMulWeight4Quantizer.quantize_blocks(quant_type, fp32weight)
+
+        # In each group of 32 elements, byte j holds element j in the low
+        # nibble and element j + 16 in the high nibble.
+        n, blocks, blk_len = values.shape
+        groups = values.reshape(n, blocks, blk_len // 32, 2, 16)
+        data = (groups[:, :, :, 0, :] | (groups[:, :, :, 1, :] << 4)).reshape(n, blocks, blk_len // 2)
+
+        header = [scale[..., np.newaxis].astype("<f4").view(np.uint8)]
+        if has_zp:
+            header.append(zero_point[..., np.newaxis])
+        packed = np.concatenate([*header, data], axis=-1)
+        return packed.reshape(-1)
+
+    def _q4_matmul_node(self, node: NodeProto, use_count: Dict[str, int]) -> NodeProto:
+        """If the node is MatMul with a constant 2-D float weight, quantize the
+        weight and return the MatMulFpQ4 node replacing it."""
+
+        if node.op_type != "MatMul":
+            return node
+
+        weight = self.model.get_initializer(node.input[1])
+        if weight is None or weight.data_type != TensorProto.FLOAT or len(weight.dims) != 2:
+            return node
+
+        # The float weight must stay if anything else reads it.
+        if use_count.get(weight.name, 0) > 1 or self.model.is_graph_input(weight.name):
+            return node
+
+        b_array = onnx.numpy_helper.to_array(weight)
+        k, n = b_array.shape
+        packed = self.pack(self.quant_type, b_array)
+
+        b_quant = onnx.numpy_helper.from_array(packed, weight.name + "_Q4")
+        self.model.remove_initializer(weight)
+        self.model.add_initializer(b_quant)
+
+        return onnx.helper.make_node(
+            "MatMulFpQ4",
+            inputs=[node.input[0], b_quant.name],
+            outputs=node.output,
+            name=node.name + "_Q4" if node.name else "",
+            domain=ms_domain,
+            K=k,
+            N=n,
+            blk_quant_type=self.quant_type,
+        )
+
+    @staticmethod
+    def _count_uses(graph: GraphProto, use_count: Dict[str, int]):
+        for node in graph.node:
+            for name in node.input:
+                use_count[name] = use_count.get(name, 0) + 1
+            for attr in node.attribute:
+                if attr.type == onnx.AttributeProto.GRAPH:
+                    MatMulWeight4Quantizer._count_uses(attr.g, use_count)
+                elif attr.type == onnx.AttributeProto.GRAPHS:
+                    for subgraph in attr.graphs:
+                        MatMulWeight4Quantizer._count_uses(subgraph, use_count)
+
+    def process(self) -> ModelProto:
+        """Replace every eligible MatMul in the main graph with MatMulFpQ4."""
+        opset_import = self.model.opset_import()
+        if not any(opset.domain == ms_domain for opset in opset_import):
+            opset_import.extend([onnx.helper.make_opsetid(ms_domain, 1)])
+
+        use_count = {}
+        self._count_uses(self.model.graph(), use_count)
+
+        new_nodes = [self._q4_matmul_node(node, use_count) for node in self.model.nodes()]
+        self.model.graph().ClearField("node")
+        self.model.graph().node.extend(new_nodes)
+        return self.model.model
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        description="""Blockwise int4 quantization for MatMul 2D weight matrices.
+
+A weight matrix is partitioned into blocks, where each block is a
+contiguous subset inside each column. Each block is quantized into a
+set of 4b integers with a scaling factor and an optional offset.
+"""
+    )
+
+    parser.add_argument("--input_model", required=True, help="Path to the input model file")
+    parser.add_argument("--output_model", required=True, help="Path to the output model file")
+    parser.add_argument(
+        "--quant_type",
+        required=False,
+        type=int,
+        default=0,
+        choices=[
+            MatMulWeight4Quantizer.BlkQ4Sym32,
+            MatMulWeight4Quantizer.BlkQ4Zp32,
+            MatMulWeight4Quantizer.BlkQ4Sym128,
+            MatMulWeight4Quantizer.BlkQ4Zp128,
+        ],
+        help="Quantization type: 0 for symmetric 32 element blocks, 1 for 32 element blocks with zero point, "
+        "2 for symmetric 128 element blocks, 3 for 128 element blocks with zero point",
+    )
+    parser.add_argument(
+        "--use_external_data_format",
+        required=False,
+        action="store_true",
+        help="Save the quantized weights as external data",
+    )
+
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+
+    model = onnx.load(args.input_model)
+    quant = MatMulWeight4Quantizer(model, args.quant_type)
+    quant.process()
+    quant.model.save_model_to_file(args.output_model, args.use_external_data_format)
+
+
+if __name__ == "__main__":
+    main()
@@ -887,6 +887,192 @@ TEST(AttentionTest, AttentionPastStateBatch1) {
                    use_past_state, past_sequence_length, &past_data, &present_data);
 }
 
+// Quantize each row of head_size values of a float state like the Attention CPU kernel: the row is quantized
+// symmetrically with a zero point of 128, and followed by its float scale.
+static std::vector<uint8_t> QuantizeAttentionState(const std::vector<float>& state, int head_size) {
+  const size_t row_size = static_cast<size_t>(head_size) + sizeof(float);
+  const size_t row_count = state.size() / head_size;
+  std::vector<uint8_t> quantized_state(row_count * row_size);
+
+  for (size_t r = 0; r < row_count; r++) {
+    const float* row = state.data() + r * head_size;
+    uint8_t* quantized_row = quantized_state.data() + r * row_size;
+
+    float max_abs = 0.0f;
+    for (int h = 0; h < head_size; h++) {
+      max_abs = std::max(max_abs, std::fabs(row[h]));
+    }
+    const float scale = max_abs > 0.0f ? max_abs / 127.0f : 1.0f;
+
+    for (int h = 0; h < head_size; h++) {
+      const float value = std::nearbyint(row[h] / scale) + 128.0f;
+      quantized_row[h] = static_cast<uint8_t>(std::min(std::max(value, 0.0f), 255.0f));
+    }
+    memcpy(quantized_row + head_size, &scale, sizeof(float));
+  }
+
+  return quantized_state;
+}
+
+static void RunAttentionQuantizedPastStateBatch1Test(const std::vector<float>* extra_add_qk_data,
+                                                     const std::vector<float>& output_data) {
+  int batch_size = 1;
+  int sequence_length = 1;
+  int hidden_size = 4;
+  int number_of_heads = 2;
+  int head_size = hidden_size / number_of_heads;
+  int past_sequence_length = 3;
+  int total_sequence_length = past_sequence_length + sequence_length;
+
+  std::vector<float> input_data = {
+      -0.019333266f, -0.21813886f, 0.16212955f, -0.015626367f};
+
+  std::vector<float> weight_data = {
+      -0.4738484025001526f,
+      -0.2613658607006073f,
+      -0.0978037416934967f,
+      -0.34988933801651f,
+      0.2243240624666214f,
+      -0.0429205559194088f,
+      0.418695330619812f,
+      0.17441125214099884f,
+      -0.18825532495975494f,
+      0.18357256054878235f,
+      -0.5806483626365662f,
+      -0.02251487597823143f,
+
+      0.08742205798625946f,
+      0.14734269678592682f,
+      0.2387014478445053f,
+      0.2884027063846588f,
+      0.6490834355354309f,
+      0.16965825855731964f,
+      -0.06346885114908218f,
+      0.4073973298072815f,
+      -0.03070945478975773f,
+      0.4110257923603058f,
+      0.07896808534860611f,
+      0.16783113777637482f,
+
+      0.0038893644232302904f,
+      0.06946629285812378f,
+      0.36680519580841064f,
+      -0.07261059433221817f,
+      -0.14960581064224243f,
+      0.020944256335496902f,
+      -0.09378612786531448f,
+      -0.1336742341518402f,
+      0.06061394885182381f,
+      0.2205914407968521f,
+      -0.03519909828901291f,
+      -0.18405692279338837f,
+
+      0.22149960696697235f,
+      -0.1884360909461975f,
+      -0.014074507169425488f,
+      0.4252440333366394f,
+      0.24987126886844635f,
+      -0.31396418809890747f,
+      0.14036843180656433f,
+      0.2854192554950714f,
+      0.09709841012954712f,
+      0.09935075044631958f,
+      -0.012154420837759972f,
+      0.2575816512107849f};
+
+  std::vector<float> bias_data = {
+      0.4803391396999359f,
+      -0.5254325866699219f,
+      -0.42926454544067383f,
+      -0.2059524953365326f,
+      -0.12773379683494568f,
+      -0.09542735666036606f,
+      -0.35286077857017517f,
+      -0.07646317780017853f,
+      -0.04590314254164696f,
+      -0.03752850368618965f,
+      -0.013764488510787487f,
+      -0.18478283286094666f};
+
+  std::vector<float> past_data = {
+      0.55445826f, 0.10127074f, 0.71770734f, 0.15915526f, 0.13913247f, 0.77447522f, 0.66044068f, 0.27559045f, 0.35731629f, 0.62033528f, 0.24354559f, 0.22859341f,
+      0.45075402f, 0.85365993f, 0.097346395f, 0.28859729f, 0.26926181f, 0.65922296f, 0.8177433f, 0.4212271f, 0.34352475f, 0.059609573f, 0.46556228f, 0.7226882f};
+
+  std::vector<float> present_data = {
+      0.55445826f, 0.10127074f, 0.71770734f, 0.15915526f, 0.13913247f, 0.77447522f, -0.30182117f, -0.12330482f, 0.66044068f, 0.27559045f, 0.35731629f, 0.62033528f, 0.24354559f, 0.22859341f, -0.36450946f, -0.19483691f,
+      0.45075402f, 0.85365993f, 0.097346395f, 0.28859729f, 0.26926181f, 0.65922296f, -0.027254611f, -0.096526355f, 0.8177433f, 0.4212271f, 0.34352475f, 0.059609573f, 0.46556228f, 0.7226882f, -0.025281552f, -0.25482416f};
+
+  std::vector<int64_t> input_dims = {batch_size, sequence_length, hidden_size};
+  std::vector<int64_t> weights_dims = {hidden_size, 3 * hidden_size};
+  std::vector<int64_t> bias_dims = {3 * hidden_size};
+  std::vector<int64_t> output_dims = {batch_size, sequence_length, hidden_size};
+  std::vector<int64_t> past_dims = {2, batch_size, number_of_heads, past_sequence_length, head_size + 4};
+  std::vector<int64_t> present_dims = {2, batch_size, number_of_heads, total_sequence_length, head_size + 4};
+
+  OpTester tester("Attention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(number_of_heads));
+  tester.AddAttribute<int64_t>("unidirectional", static_cast<int64_t>(1));
+  tester.AddInput<float>("input", input_dims, input_data);
+  tester.AddInput<float>("weight", weights_dims, weight_data);
+  tester.AddInput<float>("bias", bias_dims, bias_data);
+  tester.AddOptionalInputEdge<int32_t>();
+  tester.AddInput<uint8_t>("past", past_dims, QuantizeAttentionState(past_data, head_size));
+  if (extra_add_qk_data != nullptr) {
+    std::vector<int64_t> extra_add_qk_dims = {batch_size, number_of_heads, sequence_length, total_sequence_length};
+    tester.AddInput<float>("extra_add_qk", extra_add_qk_dims, *extra_add_qk_data);
+  }
+  tester.AddOutput<float>("output", output_dims, output_data);
+  tester.AddOutput<uint8_t>("present", present_dims, QuantizeAttentionState(present_data, head_size));
+
+  // The quantized state is compared with the float state after dequantization.
+  auto output_verifier = [&](const std::vector<OrtValue>& fetches, const std::string& provider_type) {
+    ASSERT_EQ(fetches.size(), 2u);
+
+    auto output_span = FetchTensor(fetches[0]).DataAsSpan<float>();
+    ASSERT_EQ(output_span.size(), output_data.size());
+    for (size_t i = 0; i < output_span.size(); i++) {
+      ASSERT_NEAR(output_span[i], output_data[i], 0.005f) << "output index " << i << ", provider: " << provider_type;
+    }
+
+    auto present_span = FetchTensor(fetches[1]).DataAsSpan<uint8_t>();
+    const size_t row_size = static_cast<size_t>(head_size) + sizeof(float);
+    ASSERT_EQ(present_span.size(), present_data.size() / head_size * row_size);
+    for (size_t r = 0; r < present_data.size() / head_size; r++) {
+      const uint8_t* quantized_row = present_span.data() + r * row_size;
+      float scale;
+      memcpy(&scale, quantized_row + head_size, sizeof(float));
+      for (int h = 0; h < head_size; h++) {
+        const float value = (static_cast<float>(quantized_row[h]) - 128.0f) * scale;
+        ASSERT_NEAR(value, present_data[r * head_size + h], scale)
+            << "present row " << r << ", provider: " << provider_type;
+      }
+    }
+  };
+  tester.SetCustomOutputVerifier(output_verifier);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(AttentionTest, AttentionQuantizedPastStateBatch1) {
+  std::vector<float> output_data = {
+      0.20141591f, 0.43005896f, 0.35745093f, 0.19957167f};
+
+  RunAttentionQuantizedPastStateBatch1Test(nullptr, output_data);
+}
+
+TEST(AttentionTest, AttentionQuantizedPastStateExtraAddQK) {
+  std::vector<float> extra_add_qk_data = {
+      0.2f, -0.6f, 1.0f, -0.3f,
+      -0.5f, 0.4f, 0.1f, 0.8f};
+
+  std::vector<float> output_data = {
+      0.25602068f, 0.5570944f, 0.22723424f, 0.06185585f};
+
+  RunAttentionQuantizedPastStateBatch1Test(&extra_add_qk_data, output_data);
+}
+
 TEST(AttentionTest, AttentionPastStateBatch2) {
   int batch_size = 2;
   int sequence_length = 1;
@@ -990,6 +1176,159 @@ TEST(AttentionTest, AttentionPastStateBatch2) {
                    use_past_state, past_sequence_length, &past_data, &present_data);
 }
 
+// The past state of each batch is held by the chunk of the other batch in a shared buffer of past and present state,
+// and the cache indirection points to it.
+TEST(AttentionTest, AttentionSharedBufferPastStateBatch2) {
+  int batch_size = 2;
+  int sequence_length = 1;
+  int hidden_size = 4;
+  int number_of_heads = 2;
+  int head_size = hidden_size / number_of_heads;
+  int past_sequence_length = 3;
+  int max_sequence_length = 6;
+
+  std::vector<float> input_data = {
+      -0.10902753f, 0.0041178204f, 0.1871525f, -0.20399982f,
+      0.027207348f, -0.25321805f, 0.12869114f, 0.023136809f};
+
+  std::vector<float> weight_data = {
+      -0.4738484025001526f,
+      -0.2613658607006073f,
+      -0.0978037416934967f,
+      -0.34988933801651f,
+      0.2243240624666214f,
+      -0.0429205559194088f,
+      0.418695330619812f,
+      0.17441125214099884f,
+      -0.18825532495975494f,
+      0.18357256054878235f,
+      -0.5806483626365662f,
+      -0.02251487597823143f,
+
+      0.08742205798625946f,
+      0.14734269678592682f,
+      0.2387014478445053f,
+      0.2884027063846588f,
+      0.6490834355354309f,
+      0.16965825855731964f,
+      -0.06346885114908218f,
+      0.4073973298072815f,
+      -0.03070945478975773f,
+      0.4110257923603058f,
+      0.07896808534860611f,
+      0.16783113777637482f,
+
+      0.0038893644232302904f,
+      0.06946629285812378f,
+      0.36680519580841064f,
+      -0.07261059433221817f,
+      -0.14960581064224243f,
+      0.020944256335496902f,
+      -0.09378612786531448f,
+      -0.1336742341518402f,
+      0.06061394885182381f,
+      0.2205914407968521f,
+      -0.03519909828901291f,
+      -0.18405692279338837f,
+
+      0.22149960696697235f,
+      -0.1884360909461975f,
+      -0.014074507169425488f,
+      0.4252440333366394f,
+      0.24987126886844635f,
+      -0.31396418809890747f,
+      0.14036843180656433f,
+      0.2854192554950714f,
+      0.09709841012954712f,
+      0.09935075044631958f,
+      -0.012154420837759972f,
+      0.2575816512107849f};
+
+  std::vector<float> bias_data = {
+      0.4803391396999359f,
+      -0.5254325866699219f,
+      -0.42926454544067383f,
+      -0.2059524953365326f,
+      -0.12773379683494568f,
+      -0.09542735666036606f,
+      -0.35286077857017517f,
+      -0.07646317780017853f,
+      -0.04590314254164696f,
+      -0.03752850368618965f,
+      -0.013764488510787487f,
+      -0.18478283286094666f};
+
+  std::vector<float> output_data = {
+      0.14902574f, 0.62273371f, 0.43022552f, 0.12759127f,
+      0.26993567f, 0.23553593f, 0.43190649f, 0.086044826f};
+
+  std::vector<float> past_data = {
+      0.42028648f, 0.55855948f, 0.044569403f, 0.76525789f, 0.13962431f, 0.40977913f, 0.36911047f, 0.83399564f, 0.36905321f, 0.91414654f, 0.17300875f, 0.78793788f,
+      0.10279467f, 0.80501258f, 0.089550517f, 0.85371113f, 0.61801594f, 0.91222942f, 0.88626182f, 0.069776468f, 0.10591964f, 0.84836882f, 0.83520192f, 0.0098680854f,
+      0.3113814f, 0.63999802f, 0.28603253f, 0.98899829f, 0.044405211f, 0.95105386f, 0.81278932f, 0.63969064f, 0.14494057f, 0.11349615f, 0.87086016f, 0.20983537f,
+      0.35107401f, 0.90144604f, 0.68950737f, 0.18928574f, 0.18029204f, 0.074517399f, 0.70763874f, 0.48440042f, 0.58114725f, 0.1048766f, 0.73694098f, 0.17766342f};
+
+  std::vector<float> present_data = {
+      0.42028648f, 0.55855948f, 0.044569403f, 0.76525789f, 0.13962431f, 0.40977913f, -0.22849128f, -0.022080801f, 0.36911047f, 0.83399564f, 0.36905321f, 0.91414654f, 0.17300875f, 0.78793788f, -0.4449589f, -0.17704415f, 0.10279467f, 0.80501258f, 0.089550517f, 0.85371113f, 0.61801594f, 0.91222942f, -0.2994619f, -0.14412443f, 0.88626182f, 0.069776468f, 0.10591964f, 0.84836882f, 0.83520192f, 0.0098680854f, -0.33421949f, -0.18547727f,
+      0.3113814f, 0.63999802f, 0.28603253f, 0.98899829f, 0.044405211f, 0.95105386f, -0.033968594f, -0.034833729f, 0.81278932f, 0.63969064f, 0.14494057f, 0.11349615f, 0.87086016f, 0.20983537f, 0.045759238f, -0.26863033f, 0.35107401f, 0.90144604f, 0.68950737f, 0.18928574f, 0.18029204f, 0.074517399f, -0.033201858f, -0.10592631f, 0.70763874f, 0.48440042f, 0.58114725f, 0.1048766f, 0.73694098f, 0.17766342f, -0.054369561f, -0.24562015f};
+
+  // Build the shared buffer with shape (2, batch_size, num_heads, max_sequence_length, head_size). The rows after
+  // the past state are not used, and the current key and value are written after the past state.
+  const size_t past_chunk_size = static_cast<size_t>(past_sequence_length) * head_size;
+  const size_t present_chunk_size = past_chunk_size + static_cast<size_t>(sequence_length) * head_size;
+  const size_t shared_chunk_size = static_cast<size_t>(max_sequence_length) * head_size;
+  std::vector<float> shared_past_data(2 * batch_size * number_of_heads * shared_chunk_size, 100.0f);
+  std::vector<float> shared_present_data(shared_past_data.size(), 100.0f);
+  std::vector<int32_t> cache_indirection_data(batch_size * max_sequence_length);
+  for (int kv = 0; kv < 2; kv++) {
+    for (int b = 0; b < batch_size; b++) {
+      const int source_batch = batch_size - 1 - b;
+      for (int n = 0; n < number_of_heads; n++) {
+        const size_t source_chunk = (static_cast<size_t>(kv) * batch_size + source_batch) * number_of_heads + n;
+        const size_t chunk = (static_cast<size_t>(kv) * batch_size + b) * number_of_heads + n;
+        std::copy_n(past_data.begin() + source_chunk * past_chunk_size, past_chunk_size,
+                    shared_past_data.begin() + chunk * shared_chunk_size);
+        std::copy_n(past_data.begin() + source_chunk * past_chunk_size, past_chunk_size,
+                    shared_present_data.begin() + chunk * shared_chunk_size);
+        std::copy_n(present_data.begin() + chunk * present_chunk_size + past_chunk_size,
+                    present_chunk_size - past_chunk_size,
+                    shared_present_data.begin() + chunk * shared_chunk_size + past_chunk_size);
+      }
+    }
+  }
+  for (int b = 0; b < batch_size; b++) {
+    for (int t = 0; t < max_sequence_length; t++) {
+      cache_indirection_data[b * max_sequence_length + t] = t < past_sequence_length ? batch_size - 1 - b : b;
+    }
+  }
+
+  std::vector<int64_t> input_dims = {batch_size, sequence_length, hidden_size};
+  std::vector<int64_t> weights_dims = {hidden_size, 3 * hidden_size};
+  std::vector<int64_t> bias_dims = {3 * hidden_size};
+  std::vector<int64_t> output_dims = {batch_size, sequence_length, hidden_size};
+  std::vector<int64_t> past_dims = {2, batch_size, number_of_heads, max_sequence_length, head_size};
+
+  OpTester tester("Attention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(number_of_heads));
+  tester.AddAttribute<int64_t>("unidirectional", static_cast<int64_t>(1));
+  tester.AddInput<float>("input", input_dims, input_data);
+  tester.AddInput<float>("weight", weights_dims, weight_data);
+  tester.AddInput<float>("bias", bias_dims, bias_data);
+  tester.AddOptionalInputEdge<int32_t>();
+  tester.AddInput<float>("past", past_dims, shared_past_data);
+  tester.AddOptionalInputEdge<float>();
+  tester.AddOptionalInputEdge<float>();
+  tester.AddOptionalInputEdge<float>();
+  tester.AddInput<int32_t>("past_sequence_length", {1}, {past_sequence_length});
+  tester.AddInput<int32_t>("cache_indirection", {batch_size, max_sequence_length}, cache_indirection_data);
+  tester.AddOutput<float>("output", output_dims, output_data);
+  tester.AddOutput<float>("present", past_dims, shared_present_data);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 TEST(AttentionTest, AttentionPastStateBatch2WithPadding) {
   int batch_size = 2;
   int sequence_length = 1;
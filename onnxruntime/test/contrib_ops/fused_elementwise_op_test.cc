@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
+
+namespace onnxruntime {
+namespace test {
+
+static void RunFusedElementwiseTest(OpTester& test) {
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+// x * 0.5 * (1 + erf(x / sqrt(2))) expressed with scalar inputs.
+TEST(FusedElementwiseTest, Gelu) {
+  const std::vector<int64_t> dims{2, 3, 4};
+  RandomValueGenerator random{};
+  const std::vector<float> x = random.Uniform<float>(dims, -3.0f, 3.0f);
+
+  std::vector<float> y(x.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    y[i] = x[i] * 0.5f * (1.0f + std::erf(x[i] * static_cast<float>(M_SQRT1_2)));
+  }
+
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("operations", std::vector<std::string>{"Mul", "Erf", "Add", "Mul", "Mul"});
+  // inputs 0-3, results of the operations 4-7
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 4, 5, 2, 0, 3, 7, 6});
+  test.AddInput<float>("x", dims, x);
+  test.AddInput<float>("c", {}, {static_cast<float>(M_SQRT1_2)});
+  test.AddInput<float>("one", {}, {1.0f});
+  test.AddInput<float>("half", {}, {0.5f});
+  test.AddOutput<float>("Y", dims, y);
+  test.SetOutputAbsErr("Y", 1e-5f);
+  RunFusedElementwiseTest(test);
+}
+
+// Inputs broadcast in every way the kernel reads them, over an output that spans several tiles.
+TEST(FusedElementwiseTest, BroadcastWhere) {
+  constexpr int64_t D0 = 4, D1 = 3, D2 = 1500;
+  RandomValueGenerator random{};
+  const std::vector<float> a = random.Uniform<float>(AsSpan({D0, D1, D2}), -2.0f, 2.0f);
+  const std::vector<float> b = random.Uniform<float>(AsSpan({D2}), -2.0f, 2.0f);
+  const std::vector<float> c = random.Uniform<float>(AsSpan({D0, int64_t{1}, int64_t{1}}), 0.0f, 1.0f);
+  const float d = 0.25f;
+  constexpr size_t condition_size = D1 * D2;
+  auto condition = std::make_unique<bool[]>(condition_size);
+  for (size_t i = 0; i < condition_size; i++) {
+    condition[i] = (i % 7) < 4;
+  }
+
+  // Where(condition, Relu(Sigmoid(a + b) - c) / d, a)
+  std::vector<float> y(D0 * D1 * D2);
+  for (int64_t i0 = 0; i0 < D0; i0++) {
+    for (int64_t i1 = 0; i1 < D1; i1++) {
+      for (int64_t i2 = 0; i2 < D2; i2++) {
+        const int64_t index = (i0 * D1 + i1) * D2 + i2;
+        const float sigmoid = 1.0f / (1.0f + std::exp(-(a[index] + b[i2])));
+        const float value = std::max(sigmoid - c[i0], 0.0f) / d;
+        y[index] = condition[i1 * D2 + i2] ? value : a[index];
+      }
+    }
+  }
+
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("operations", std::vector<std::string>{"Add", "Sigmoid", "Sub", "Relu", "Div", "Where"});
+  // inputs 0-4, results of the operations 5-9
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 5, 6, 2, 7, 8, 4, 3, 9, 0});
+  test.AddInput<float>("a", {D0, D1, D2}, a);
+  test.AddInput<float>("b", {D2}, b);
+  test.AddInput<float>("c", {D0, 1, 1}, c);
+  test.AddInput<bool>("condition", {D1, D2}, condition.get(), condition_size);
+  test.AddInput<float>("d", {}, {d});
+  test.AddOutput<float>("Y", {D0, D1, D2}, y);
+  test.SetOutputAbsErr("Y", 1e-5f);
+  RunFusedElementwiseTest(test);
+}
+
+// The output is larger than every input.
+TEST(FusedElementwiseTest, OuterBroadcast) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("operations", std::vector<std::string>{"Sub", "Relu"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 2});
+  test.AddInput<float>("a", {2, 1}, {1.0f, 2.0f});
+  test.AddInput<float>("b", {1, 3}, {0.5f, 1.5f, 2.5f});
+  test.AddOutput<float>("Y", {2, 3}, {0.5f, 0.0f, 0.0f, 1.5f, 0.5f, 0.0f});
+  RunFusedElementwiseTest(test);
+}
+
+TEST(FusedElementwiseTest, InvalidOperands) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("operations", std::vector<std::string>{"Add", "Relu"});
+  // the Relu reads its own result
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 3});
+  test.AddInput<float>("a", {2}, {1.0f, 2.0f});
+  test.AddInput<float>("b", {2}, {1.0f, 2.0f});
+  test.AddOutput<float>("Y", {2}, {2.0f, 4.0f});
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectFailure, "out of range", {}, nullptr, &execution_providers);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
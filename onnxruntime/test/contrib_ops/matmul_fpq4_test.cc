@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/span_utils.h"
+#include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+#include <functional>
+#include <numeric>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+static void TestMatMulFpQ4(const std::vector<int64_t>& A_dims,
+                           int64_t K,
+                           int64_t N,
+                           MLAS_BLK_QUANT_TYPE qtype,
+                           bool has_bias,
+                           bool is_matrix_b_constant = true) {
+  RandomValueGenerator random{};
+
+  std::vector<float> A_data = random.Uniform<float>(A_dims, -1.0f, 1.0f);
+  std::vector<float> B_data = random.Uniform<float>(AsSpan({K, N}), -1.0f, 1.0f);
+  std::vector<float> Bias = random.Uniform<float>(AsSpan({N}), -1.0f, 1.0f);
+
+  const size_t packed_b_size = MlasQ4GemmPackBSize(qtype, static_cast<size_t>(N), static_cast<size_t>(K));
+  ASSERT_GT(packed_b_size, size_t(0));
+  std::vector<uint8_t> packed_B(packed_b_size);
+  MlasQ4GemmPackB(qtype, packed_B.data(), B_data.data(), static_cast<size_t>(N), static_cast<size_t>(K),
+                  static_cast<size_t>(N));
+
+  // The expected output is computed from the dequantized weights, so only the
+  // accumulation order differs from the kernel.
+  std::vector<float> B_dequant(static_cast<size_t>(K * N));
+  MlasQ4GemmUnPackB(qtype, B_dequant.data(), packed_B.data(), static_cast<size_t>(N), static_cast<size_t>(K),
+                    static_cast<size_t>(N));
+
+  const int64_t M = std::accumulate(A_dims.begin(), A_dims.end() - 1, int64_t{1}, std::multiplies<int64_t>());
+  std::vector<float> Y_data(static_cast<size_t>(M * N));
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      float sum = has_bias ? Bias[n] : 0.0f;
+      for (int64_t k = 0; k < K; k++) {
+        sum += A_data[m * K + k] * B_dequant[k * N + n];
+      }
+      Y_data[m * N + n] = sum;
+    }
+  }
+
+  std::vector<int64_t> Y_dims(A_dims);
+  Y_dims.back() = N;
+
+  OpTester test("MatMulFpQ4", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("K", K);
+  test.AddAttribute<int64_t>("N", N);
+  test.AddAttribute<int64_t>("blk_quant_type", static_cast<int64_t>(qtype));
+  test.AddInput<float>("A", A_dims, A_data);
+  test.AddInput<uint8_t>("B", {static_cast<int64_t>(packed_b_size)}, packed_B, is_matrix_b_constant);
+  if (has_bias) {
+    test.AddInput<float>("bias", {N}, Bias);
+  } else {
+    test.AddOptionalInputEdge<float>();
+  }
+  test.AddOutput<float>("Y", Y_dims, Y_data);
+  test.SetOutputAbsErr("Y", 0.001f);
+  test.Run();
+}
+
+TEST(MatMulFpQ4, Gemv) {
+  TestMatMulFpQ4({1, 256}, 256, 128, BlkQ4Sym32, false);
+  TestMatMulFpQ4({1, 256}, 256, 128, BlkQ4Zp32, true);
+  TestMatMulFpQ4({1, 300}, 300, 67, BlkQ4Sym128, true);
+  TestMatMulFpQ4({1, 300}, 300, 67, BlkQ4Zp128, false);
+}
+
+TEST(MatMulFpQ4, Gemm) {
+  TestMatMulFpQ4({7, 160}, 160, 33, BlkQ4Sym32, true);
+  TestMatMulFpQ4({2, 5, 129}, 129, 40, BlkQ4Zp32, false);
+  TestMatMulFpQ4({3, 4, 512}, 512, 96, BlkQ4Zp128, true, false);
+}
+
+TEST(MatMulFpQ4, InvalidBlobSize) {
+  OpTester test("MatMulFpQ4", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("K", int64_t{64});
+  test.AddAttribute<int64_t>("N", int64_t{2});
+  test.AddAttribute<int64_t>("blk_quant_type", static_cast<int64_t>(BlkQ4Sym32));
+  test.AddInput<float>("A", {1, 64}, std::vector<float>(64, 1.0f));
+  test.AddInput<uint8_t>("B", {3}, {0, 0, 0});
+  test.AddOutput<float>("Y", {1, 2}, {0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "Input B must be a 1-D blob of");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -2,9 +2,14 @@
 // Licensed under the MIT License.
 
 #include "core/framework/bfc_arena.h"
+#include "test/util/include/asserts.h"
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <thread>
 
 namespace onnxruntime {
 namespace test {
@@ -298,5 +303,265 @@ TEST(BFCArenaTest, TestBackoffDoesntHang) {
   BFCArena a(std::unique_ptr<IAllocator>(new BadAllocator()), 10 * 1024 * 1024);
   EXPECT_THROW(a.Alloc(1024), OnnxRuntimeException) << "Arena should be unable to allocate memory";
 }
+
+TEST(BFCArenaTest, LockContentionStats) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30);
+
+  void* p = a.Alloc(1024);
+  a.Free(p);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_lock_acquisitions, 2);
+  EXPECT_EQ(stats.num_lock_contentions, 0);
+
+  constexpr int num_threads = 8;
+  constexpr int num_iterations = 1000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&a]() {
+      for (int i = 0; i < num_iterations; ++i) {
+        a.Free(a.Alloc(256));
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_lock_acquisitions, 2 + 2 * num_threads * num_iterations);
+  // how often the threads collide depends on the machine, but it can't exceed the number of acquisitions
+  EXPECT_LE(stats.num_lock_contentions, stats.num_lock_acquisitions);
+}
+
+TEST(BFCArenaTest, ThreadCacheReusesChunks) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, 1024 * 1024);
+
+  void* p1 = a.Alloc(1000);
+  a.Free(p1);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_lock_acquisitions, 1);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.bytes_in_thread_caches, 1024);
+
+  // same size class, served from the thread cache without the lock
+  void* p2 = a.Alloc(900);
+  EXPECT_EQ(p2, p1);
+  // different size class
+  void* p3 = a.Alloc(2000);
+  EXPECT_NE(p3, p1);
+
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_lock_acquisitions, 2);
+  EXPECT_EQ(stats.num_thread_cache_hits, 1);
+  EXPECT_EQ(stats.num_allocs, 3);
+  EXPECT_EQ(stats.bytes_in_use, 1024 + 2048);
+  EXPECT_EQ(stats.bytes_in_thread_caches, 0);
+
+  // allocations larger than the largest size class bypass the cache
+  void* p4 = a.Alloc(BFCArena::kMaxThreadCacheAllocationSize + 1);
+  a.Free(p4);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_thread_caches, 0);
+
+  a.Free(p2);
+  a.Free(p3);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_thread_caches, 1024 + 2048);
+
+  // Shrink returns the cached chunks to the bins first
+  ASSERT_STATUS_OK(a.Shrink());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.bytes_in_thread_caches, 0);
+}
+
+TEST(BFCArenaTest, ThreadCacheRespectsLimit) {
+  constexpr size_t max_thread_cache_bytes = 4096;
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, max_thread_cache_bytes);
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 8; ++i) {
+    ptrs.push_back(a.Alloc(1024));
+  }
+
+  AllocatorStats stats;
+  for (void* p : ptrs) {
+    a.Free(p);
+    a.GetStats(&stats);
+    EXPECT_LE(stats.bytes_in_thread_caches, static_cast<int64_t>(max_thread_cache_bytes));
+  }
+
+  // 5 chunks were cached when the limit was first exceeded. 3 of them went back to the bins in one batch,
+  // then the same happened again after 3 more frees.
+  EXPECT_EQ(stats.bytes_in_thread_caches, 2048);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.num_lock_acquisitions, 8 + 2);
+}
+
+TEST(BFCArenaTest, ThreadCacheCrossThreadFree) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, 256 * 1024);
+
+  constexpr int num_threads = 8;
+  constexpr int num_iterations = 2000;
+  std::mutex handoff_mutex;
+  std::vector<std::pair<void*, size_t>> handoff;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      std::default_random_engine generator(t);
+      std::uniform_int_distribution<size_t> size_distribution(1, 2 * BFCArena::kMaxThreadCacheAllocationSize);
+      std::vector<std::pair<void*, size_t>> live;
+      for (int i = 0; i < num_iterations; ++i) {
+        const size_t size = size_distribution(generator);
+        void* p = a.Alloc(size);
+        ASSERT_NE(p, nullptr);
+        memset(p, t, size);
+        live.emplace_back(p, size);
+
+        if (live.size() == 16) {
+          for (size_t j = 0; j < live.size(); ++j) {
+            // another thread wrote to the buffer if it was handed out twice
+            const auto* bytes = static_cast<const unsigned char*>(live[j].first);
+            ASSERT_EQ(bytes[0], static_cast<unsigned char>(t));
+            ASSERT_EQ(bytes[live[j].second - 1], static_cast<unsigned char>(t));
+
+            // every other buffer is freed by another thread
+            if (j % 2 == 0) {
+              a.Free(live[j].first);
+            } else {
+              std::lock_guard<std::mutex> guard(handoff_mutex);
+              handoff.push_back(live[j]);
+            }
+          }
+
+          live.clear();
+        }
+
+        std::pair<void*, size_t> other{nullptr, 0};
+        {
+          std::lock_guard<std::mutex> guard(handoff_mutex);
+          if (!handoff.empty()) {
+            other = handoff.back();
+            handoff.pop_back();
+          }
+        }
+
+        a.Free(other.first);
+      }
+
+      for (const auto& entry : live) {
+        a.Free(entry.first);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (const auto& entry : handoff) {
+    a.Free(entry.first);
+  }
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_GT(stats.num_thread_cache_hits, 0);
+
+  ASSERT_STATUS_OK(a.Shrink());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.bytes_in_thread_caches, 0);
+}
+
+TEST(BFCArenaTest, ShrinkIdleRegions) {
+  // regions unused for 2 runs are released. kSameAsRequested so the first region is considered too.
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_THREAD_CACHE_BYTES, 2);
+
+  AllocatorStats stats;
+  a.Free(a.Alloc(1 << 20));
+  a.OnRunEnd();
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_regions, 1);
+
+  a.OnRunEnd();
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_regions, 0);
+  EXPECT_EQ(stats.num_arena_shrinkages, 1);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+
+  // a region with a chunk in use is kept, and counts as used while the chunk is alive
+  void* p = a.Alloc(1 << 20);
+  a.OnRunEnd();
+  a.OnRunEnd();
+  a.Free(p);
+  a.OnRunEnd();
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_regions, 1);
+
+  a.OnRunEnd();
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_regions, 0);
+  EXPECT_EQ(stats.num_arena_shrinkages, 2);
+}
+
+TEST(BFCArenaTest, ShrinkIdleRegionsDisabledByDefault) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested);
+  a.Free(a.Alloc(1 << 20));
+  for (int i = 0; i < 10; ++i) {
+    a.OnRunEnd();
+  }
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_regions, 1);
+  EXPECT_EQ(stats.num_arena_shrinkages, 0);
+}
+
+TEST(BFCArenaTest, FragmentationStats) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested);
+
+  // one region holding a single free chunk of 64KB
+  a.Free(a.Alloc(64 * 1024));
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_regions, 1);
+  EXPECT_EQ(stats.largest_free_chunk, 64 * 1024);
+  ASSERT_EQ(stats.free_bytes_per_bin.size(), 21u);
+  EXPECT_EQ(stats.free_bytes_per_bin[8], 64 * 1024);
+
+  // splitting the chunk leaves 63KB free, which is in the bin below
+  void* p = a.Alloc(1024);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.largest_free_chunk, 63 * 1024);
+  EXPECT_EQ(stats.free_bytes_per_bin[7], 63 * 1024);
+  EXPECT_EQ(stats.free_bytes_per_bin[8], 0);
+
+  int64_t total_free_bytes = 0;
+  for (auto free_bytes : stats.free_bytes_per_bin) {
+    total_free_bytes += free_bytes;
+  }
+  EXPECT_EQ(total_free_bytes, stats.total_allocated_bytes - stats.bytes_in_use);
+
+  // coalesced again
+  a.Free(p);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.free_bytes_per_bin[7], 0);
+  EXPECT_EQ(stats.free_bytes_per_bin[8], 64 * 1024);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -29,6 +29,7 @@
 #include "core/graph/op.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/platform/env.h"
+#include "core/platform/path_lib.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
 #ifdef USE_CUDA
@@ -55,6 +56,7 @@
 #include "test/optimizer/dummy_graph_transformer.h"
 #include "test/util/include/default_providers.h"
 #include "test/util/include/inference_session_wrapper.h"
+#include "test/util/include/temp_dir.h"
 
 #include "gtest/gtest.h"
 
@@ -399,6 +401,27 @@ TEST(InferenceSessionTests, NoTimeout) {
   RunModel(session_object, run_options);
 }
 
+TEST(InferenceSessionTests, FastSequentialExecutor) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.FastSequentialExecutor";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigUseFastSequentialExecutor, "1"));
+
+  InferenceSessionWrapper session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  const auto* dispatch_table = session_object.GetSessionState().GetKernelDispatchTable();
+  ASSERT_NE(dispatch_table, nullptr);
+  EXPECT_EQ(dispatch_table->entries.size(), session_object.GetSessionState().GetExecutionPlan()->execution_plan.size());
+
+  RunOptions run_options;
+  run_options.run_tag = "fast sequential executor";
+  RunModel(session_object, run_options);
+  // memory patterns are recorded by the fast path as well
+  RunModel(session_object, run_options);
+}
+
 TEST(InferenceSessionTests, OnlyExecutePathToFetches) {
   SessionOptions so;
 
@@ -492,6 +515,177 @@ TEST(InferenceSessionTests, TestModelSerialization) {
   ASSERT_TRUE(session_object_emptyValidation.Initialize().IsOK());
 }
 
+#if !defined(ORT_MINIMAL_BUILD)
+// The first session saves the optimized model and the pre-packed weight of the MatMul to the optimized model cache,
+// the second session loads them.
+TEST(InferenceSessionTests, OptimizedModelCache) {
+  TemporaryDirectory cache_dir(ORT_TSTR("optimized_model_cache_test_dir"));
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.OptimizedModelCache";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigOptimizedModelCacheDir,
+                                                    ToUTF8String(cache_dir.Path()).c_str()));
+
+  auto run_model = [](InferenceSession& session_object) {
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {3, 2},
+                         {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &ml_value);
+    NameMLValMap feeds;
+    feeds.insert(std::make_pair("X", ml_value));
+    std::vector<std::string> output_names{"Y"};
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feeds, output_names, &fetches));
+    VerifyOutputs(fetches, {3, 1}, {5.0f, 11.0f, 17.0f});
+  };
+
+  InferenceSessionWrapper first_session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(first_session.Load(ORT_TSTR("testdata/matmul_1.onnx")));
+  ASSERT_STATUS_OK(first_session.Initialize());
+  run_model(first_session);
+  const size_t number_of_prepacks = first_session.GetSessionState().GetNumberOfPrepacksCounter();
+  ASSERT_EQ(first_session.GetSessionState().GetUsedSavedPrePackedWeightCounter(), static_cast<size_t>(0));
+
+  InferenceSessionWrapper second_session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(second_session.Load(ORT_TSTR("testdata/matmul_1.onnx")));
+  ASSERT_STATUS_OK(second_session.Initialize());
+  run_model(second_session);
+  // every weight pre-packed by the first session is taken from the cache
+  ASSERT_EQ(second_session.GetSessionState().GetNumberOfPrepacksCounter(), number_of_prepacks);
+  ASSERT_EQ(second_session.GetSessionState().GetUsedSavedPrePackedWeightCounter(), number_of_prepacks);
+
+  // a session with different options doesn't use the cached model
+  so.graph_optimization_level = TransformerLevel::Level1;
+  InferenceSessionWrapper third_session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(third_session.Load(ORT_TSTR("testdata/matmul_1.onnx")));
+  ASSERT_STATUS_OK(third_session.Initialize());
+  run_model(third_session);
+  ASSERT_EQ(third_session.GetSessionState().GetUsedSavedPrePackedWeightCounter(), static_cast<size_t>(0));
+}
+
+TEST(InferenceSessionTests, OptimizedModelCacheSkipsExternalData) {
+  TemporaryDirectory cache_dir(ORT_TSTR("optimized_model_cache_test_dir"));
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.OptimizedModelCacheSkipsExternalData";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigOptimizedModelCacheDir,
+                                                    ToUTF8String(cache_dir.Path()).c_str()));
+
+  // the initializers of the model are read from Pads.bin, which isn't covered by the cache key
+  InferenceSessionWrapper session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(ORT_TSTR("testdata/model_with_external_initializers.onnx")));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  // nothing is saved to the cache
+  size_t cached_files = 0;
+  LoopDir(cache_dir.Path(), [&cached_files](const PATH_CHAR_TYPE* filename, OrtFileType) -> bool {
+    if (filename[0] != '.') {
+      ++cached_files;
+    }
+    return true;
+  });
+  ASSERT_EQ(cached_files, static_cast<size_t>(0));
+}
+
+// square weight large enough to be pre-packed by MatMul, which leaves a small weight to the small matrix kernels
+constexpr int64_t kSharedWeightSize = 72;
+
+static float SharedWeightValue(int64_t row, int64_t column) {
+  return static_cast<float>((row * kSharedWeightSize + column) % 7 - 3);
+}
+
+// unnamed MatMul and Gemm(transB=1) nodes that pre-pack the same weight in different layouts
+static void CreateMatMulAndGemmSharingWeightModel(std::string& model_data) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 13;
+  std::vector<ONNX_NAMESPACE::FunctionProto> model_specific_functions;
+  Model model("test", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version,
+              model_specific_functions, DefaultLoggingManager().DefaultLogger(), ModelOptions(true, true));
+  onnxruntime::Graph& graph = model.MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &tensor_float);
+  auto& weight_arg = graph.GetOrCreateNodeArg("W", &tensor_float);
+  auto& matmul_output_arg = graph.GetOrCreateNodeArg("Y_matmul", &tensor_float);
+  auto& gemm_output_arg = graph.GetOrCreateNodeArg("Y_gemm", &tensor_float);
+
+  TensorProto weight;
+  weight.set_name("W");
+  weight.set_data_type(TensorProto_DataType_FLOAT);
+  weight.add_dims(kSharedWeightSize);
+  weight.add_dims(kSharedWeightSize);
+  for (int64_t row = 0; row < kSharedWeightSize; row++) {
+    for (int64_t column = 0; column < kSharedWeightSize; column++) {
+      weight.add_float_data(SharedWeightValue(row, column));
+    }
+  }
+  graph.AddInitializedTensor(weight);
+
+  graph.AddNode("", "MatMul", "MatMul", {&input_arg, &weight_arg}, {&matmul_output_arg}, nullptr,
+                onnxruntime::kOnnxDomain);
+  auto& gemm = graph.AddNode("", "Gemm", "Gemm", {&input_arg, &weight_arg}, {&gemm_output_arg}, nullptr,
+                             onnxruntime::kOnnxDomain);
+  gemm.AddAttribute("transB", static_cast<int64_t>(1));
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+}
+
+TEST(InferenceSessionTests, OptimizedModelCacheNodesSharingWeight) {
+  std::string model_data;
+  CreateMatMulAndGemmSharingWeightModel(model_data);
+
+  TemporaryDirectory cache_dir(ORT_TSTR("optimized_model_cache_test_dir"));
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.OptimizedModelCacheNodesSharingWeight";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigOptimizedModelCacheDir,
+                                                    ToUTF8String(cache_dir.Path()).c_str()));
+
+  // X * W and X * W' of small integers are exact
+  constexpr int64_t rows = 2;
+  std::vector<float> x_values(rows * kSharedWeightSize);
+  for (size_t i = 0; i < x_values.size(); i++) {
+    x_values[i] = static_cast<float>(static_cast<int>(i % 5) - 2);
+  }
+  std::vector<float> matmul_values(rows * kSharedWeightSize, 0.0f);
+  std::vector<float> gemm_values(rows * kSharedWeightSize, 0.0f);
+  for (int64_t r = 0; r < rows; r++) {
+    for (int64_t n = 0; n < kSharedWeightSize; n++) {
+      for (int64_t k = 0; k < kSharedWeightSize; k++) {
+        const float x = x_values[r * kSharedWeightSize + k];
+        matmul_values[r * kSharedWeightSize + n] += x * SharedWeightValue(k, n);
+        gemm_values[r * kSharedWeightSize + n] += x * SharedWeightValue(n, k);
+      }
+    }
+  }
+
+  auto run_model = [&](InferenceSession& session_object) {
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {rows, kSharedWeightSize},
+                         x_values, &ml_value);
+    NameMLValMap feeds;
+    feeds.insert(std::make_pair("X", ml_value));
+    std::vector<std::string> output_names{"Y_matmul", "Y_gemm"};
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feeds, output_names, &fetches));
+    ASSERT_EQ(fetches.size(), 2u);
+    VerifyOutputs(fetches[0].Get<Tensor>(), {rows, kSharedWeightSize}, matmul_values);
+    VerifyOutputs(fetches[1].Get<Tensor>(), {rows, kSharedWeightSize}, gemm_values);
+  };
+
+  InferenceSessionWrapper first_session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(first_session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(first_session.Initialize());
+  run_model(first_session);
+  ASSERT_EQ(first_session.GetSessionState().GetNumberOfPrepacksCounter(), static_cast<size_t>(2));
+
+  // each kernel gets the weight in its own layout from the cache
+  InferenceSessionWrapper second_session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(second_session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(second_session.Initialize());
+  run_model(second_session);
+  ASSERT_EQ(second_session.GetSessionState().GetUsedSavedPrePackedWeightCounter(), static_cast<size_t>(2));
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
 #ifdef ORT_RUN_EXTERNAL_ONNX_TESTS
 static bool Compare(const InputDefList& f_arg, const InputDefList& s_arg) {
   if (f_arg.size() != s_arg.size()) {
@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+#include "core/framework/mem_pattern_planner.h"
+#include "test/framework/test_utils.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+OrtValue CreateInput(const std::vector<int64_t>& dims) {
+  OrtValue value;
+  const size_t size = static_cast<size_t>(TensorShape(dims).Size());
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims,
+                       std::vector<float>(size, 1.0f), &value);
+  return value;
+}
+
+MemoryPatternGroup CreatePatternGroup(size_t peak_size) {
+  MemoryPatternGroup group;
+  group.locations.push_back(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault)->Info());
+  MemPatternPlanner planner{false};
+  planner.TraceAllocation(0, peak_size);
+  group.patterns.push_back(planner.GenerateMemPattern());
+  return group;
+}
+}  // namespace
+
+TEST(MemoryPatternCacheTest, BucketDim) {
+  EXPECT_EQ(MemoryPatternCache::BucketDim(33, MemoryPatternBucketPolicy::kExact), 33);
+  EXPECT_EQ(MemoryPatternCache::BucketDim(0, MemoryPatternBucketPolicy::kPowerOfTwo), 0);
+  EXPECT_EQ(MemoryPatternCache::BucketDim(1, MemoryPatternBucketPolicy::kPowerOfTwo), 1);
+  EXPECT_EQ(MemoryPatternCache::BucketDim(3, MemoryPatternBucketPolicy::kPowerOfTwo), 4);
+  EXPECT_EQ(MemoryPatternCache::BucketDim(64, MemoryPatternBucketPolicy::kPowerOfTwo), 64);
+  EXPECT_EQ(MemoryPatternCache::BucketDim(65, MemoryPatternBucketPolicy::kPowerOfTwo), 128);
+
+  MemoryPatternBucketPolicy policy;
+  ASSERT_TRUE(MemoryPatternCache::ParseBucketPolicy("pow2", policy).IsOK());
+  EXPECT_EQ(policy, MemoryPatternBucketPolicy::kPowerOfTwo);
+  ASSERT_TRUE(MemoryPatternCache::ParseBucketPolicy("exact", policy).IsOK());
+  EXPECT_EQ(policy, MemoryPatternBucketPolicy::kExact);
+  EXPECT_FALSE(MemoryPatternCache::ParseBucketPolicy("nearest", policy).IsOK());
+}
+
+TEST(MemoryPatternCacheTest, ExactPolicy) {
+  MemoryPatternCache cache;
+  cache.Configure(MemoryPatternBucketPolicy::kExact, 0);
+
+  std::vector<OrtValue> feeds{CreateInput({1, 40})};
+  EXPECT_EQ(cache.Find(feeds), nullptr);
+  cache.Insert(feeds, CreatePatternGroup(1024));
+  EXPECT_NE(cache.Find(feeds), nullptr);
+
+  // transposed dims must not collide with the cached entry
+  std::vector<OrtValue> other_feeds{CreateInput({40, 1})};
+  EXPECT_EQ(cache.Find(other_feeds), nullptr);
+
+  EXPECT_EQ(cache.NumHits(), 1u);
+  EXPECT_EQ(cache.NumMisses(), 2u);
+}
+
+TEST(MemoryPatternCacheTest, PowerOfTwoBuckets) {
+  MemoryPatternCache cache;
+  cache.Configure(MemoryPatternBucketPolicy::kPowerOfTwo, 0);
+
+  std::vector<OrtValue> feeds_100{CreateInput({1, 100})};
+  cache.Insert(feeds_100, CreatePatternGroup(400));
+
+  // smaller sequence length in the same bucket reuses the pattern planned for 100
+  std::vector<OrtValue> feeds_80{CreateInput({1, 80})};
+  auto entry = cache.Find(feeds_80);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->planned_input_dims[0][1], 100);
+
+  // larger sequence length in the same bucket misses and replaces the entry
+  std::vector<OrtValue> feeds_120{CreateInput({1, 120})};
+  EXPECT_EQ(cache.Find(feeds_120), nullptr);
+  cache.Insert(feeds_120, CreatePatternGroup(480));
+  EXPECT_EQ(cache.Size(), 1u);
+
+  // the replaced entry stays alive for existing users
+  EXPECT_EQ(entry->planned_input_dims[0][1], 100);
+
+  // a smaller pattern inserted later doesn't replace one that can serve it
+  auto current = cache.Insert(feeds_80, CreatePatternGroup(320));
+  EXPECT_EQ(current->planned_input_dims[0][1], 120);
+
+  // different bucket
+  std::vector<OrtValue> feeds_200{CreateInput({1, 200})};
+  EXPECT_EQ(cache.Find(feeds_200), nullptr);
+}
+
+TEST(MemoryPatternCacheTest, LruEviction) {
+  MemoryPatternCache cache;
+  cache.Configure(MemoryPatternBucketPolicy::kExact, 2);
+
+  std::vector<OrtValue> feeds_a{CreateInput({1, 8})};
+  std::vector<OrtValue> feeds_b{CreateInput({1, 16})};
+  std::vector<OrtValue> feeds_c{CreateInput({1, 32})};
+
+  cache.Insert(feeds_a, CreatePatternGroup(32));
+  cache.Insert(feeds_b, CreatePatternGroup(64));
+  // touch 'a' so 'b' is the least recently used
+  EXPECT_NE(cache.Find(feeds_a), nullptr);
+  cache.Insert(feeds_c, CreatePatternGroup(128));
+
+  EXPECT_EQ(cache.Size(), 2u);
+  EXPECT_EQ(cache.NumEvictions(), 1u);
+  EXPECT_NE(cache.Find(feeds_a), nullptr);
+  EXPECT_EQ(cache.Find(feeds_b), nullptr);
+  EXPECT_NE(cache.Find(feeds_c), nullptr);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -5,7 +5,9 @@
 #include "core/framework/op_kernel.h"
 #include "test/providers/provider_test_utils.h"
 #include "test_utils.h"
+#include "core/graph/model.h"
 #include "core/session/inference_session.h"
+#include "test/test_environment.h"
 
 #include "gtest/gtest.h"
 
@@ -76,8 +78,12 @@ struct TestOp {
   }
 };
 
+class ParallelExecutorModeTest : public testing::TestWithParam<ExecutionMode> {
+};
+
 // test that the status from TestOp is correctly returned from InferenceSession::Run
-TEST(ParallelExecutor, TestStatusPropagation) {
+TEST_P(ParallelExecutorModeTest, TestStatusPropagation) {
+  const ExecutionMode execution_mode = GetParam();
   auto registry = std::make_shared<CustomRegistry>();
   std::vector<OpSchema> schemas{TestOp::OpSchema()};
   Status status;
@@ -94,7 +100,7 @@ TEST(ParallelExecutor, TestStatusPropagation) {
     tester.AddOutput<int64_t>("action_out", {1}, {0});
     // TensorRT doesn't handle a custom op. Possibly it should, but that would be a separate PR
     tester.Run(OpTester::ExpectResult::kExpectSuccess, {}, {kTensorrtExecutionProvider}, nullptr, nullptr,
-               ExecutionMode::ORT_PARALLEL);
+               execution_mode);
   }
 
   {  // test failure
@@ -104,7 +110,7 @@ TEST(ParallelExecutor, TestStatusPropagation) {
     tester.AddInput<int64_t>("action", {1}, {/*failure*/ 1});
     tester.AddOutput<int64_t>("action_out", {1}, {0});
     tester.Run(OpTester::ExpectResult::kExpectFailure, "Action was 1", {kTensorrtExecutionProvider}, nullptr, nullptr,
-               ExecutionMode::ORT_PARALLEL);
+               execution_mode);
   }
 
   {  // test exception
@@ -113,7 +119,7 @@ TEST(ParallelExecutor, TestStatusPropagation) {
 
     tester.AddInput<int64_t>("action", {1}, {/*exception*/ 2});
     tester.AddOutput<int64_t>("action_out", {1}, {0});
-    tester.Run(OpTester::ExpectResult::kExpectFailure, "Throwing as action was 2", {kTensorrtExecutionProvider}, nullptr, nullptr, ExecutionMode::ORT_PARALLEL);
+    tester.Run(OpTester::ExpectResult::kExpectFailure, "Throwing as action was 2", {kTensorrtExecutionProvider}, nullptr, nullptr, execution_mode);
   }
 }
 
@@ -145,5 +151,81 @@ TEST_P(ParallelExecutorThreadPoolTest, TestNullInterOpThreadPool) {
 
 INSTANTIATE_TEST_SUITE_P(ParallelExecutorThreadPoolTests, ParallelExecutorThreadPoolTest,
                          testing::Values(1, 0));
+
+// Graph with many independent branches of different depths that are summed up at the end.
+// Branch b computes X + X + ... + X with (b % 4) + 2 terms.
+static void CreateWideModel(std::unique_ptr<Model>& p_model, int num_branches) {
+  p_model = std::make_unique<Model>("WideModel", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = p_model->MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+  std::vector<NodeArg*> branch_outputs;
+  for (int b = 0; b < num_branches; ++b) {
+    NodeArg* current = &input_arg;
+    for (int i = 0, depth = b % 4 + 1; i < depth; ++i) {
+      const std::string name = "branch_" + std::to_string(b) + "_" + std::to_string(i);
+      auto& output_arg = graph.GetOrCreateNodeArg(name, &float_tensor);
+      graph.AddNode(name, "Add", "", {current, &input_arg}, {&output_arg});
+      current = &output_arg;
+    }
+
+    branch_outputs.push_back(current);
+  }
+
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("sum", "Sum", "", branch_outputs, {&output_arg});
+  ASSERT_STATUS_OK(graph.Resolve());
+}
+
+TEST_P(ParallelExecutorModeTest, WideGraph) {
+  constexpr int num_branches = 32;
+  std::unique_ptr<Model> p_model;
+  CreateWideModel(p_model, num_branches);
+
+  std::string model_str;
+  p_model->ToProto().SerializeToString(&model_str);
+
+  SessionOptions so;
+  so.session_logid = "ParallelExecutorModeTest.WideGraph";
+  so.execution_mode = GetParam();
+  so.inter_op_param.thread_pool_size = 4;
+  InferenceSession session_object{so, GetEnvironment()};
+  std::stringstream sstr(model_str);
+  ASSERT_STATUS_OK(session_object.Load(sstr));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::vector<float> x_values{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 3}, x_values, &x);
+
+  float multiplier = 0.0f;
+  for (int b = 0; b < num_branches; ++b) {
+    multiplier += static_cast<float>(b % 4 + 2);
+  }
+
+  RunOptions run_options;
+  for (int run = 0; run < 10; ++run) {
+    NameMLValMap feeds{{"X", x}};
+    std::vector<std::string> output_names{"Y"};
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(run_options, feeds, output_names, &fetches));
+    ASSERT_EQ(fetches.size(), 1u);
+
+    const auto& y = fetches[0].Get<Tensor>();
+    auto y_values = y.DataAsSpan<float>();
+    ASSERT_EQ(y_values.size(), x_values.size());
+    for (size_t i = 0; i < x_values.size(); ++i) {
+      EXPECT_FLOAT_EQ(y_values[i], multiplier * x_values[i]);
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(ParallelExecutorModeTests, ParallelExecutorModeTest,
+                         testing::Values(ExecutionMode::ORT_PARALLEL, ExecutionMode::ORT_PARALLEL_WORK_STEALING));
 }  // namespace test
 }  // namespace onnxruntime
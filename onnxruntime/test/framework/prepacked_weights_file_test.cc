@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/prepacked_weights_file.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "core/framework/allocator.h"
+#include "core/graph/constants.h"
+#include "core/platform/path_lib.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/temp_dir.h"
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+static PrePackedWeights CreateWeights(const AllocatorPtr& alloc, std::initializer_list<size_t> buffer_sizes,
+                                      uint8_t seed) {
+  PrePackedWeights weights;
+  for (size_t size : buffer_sizes) {
+    auto* data = static_cast<uint8_t*>(alloc->Alloc(size));
+    for (size_t i = 0; i < size; ++i) {
+      data[i] = static_cast<uint8_t>(seed + i);
+    }
+    weights.buffers_.push_back(BufferUniquePtr(data, BufferDeleter(alloc)));
+    weights.buffer_sizes_.push_back(size);
+    ++seed;
+  }
+  return weights;
+}
+
+static void ExpectSameWeights(const PrePackedWeights& expected, const PrePackedWeights& actual) {
+  ASSERT_EQ(expected.buffer_sizes_, actual.buffer_sizes_);
+  for (size_t i = 0; i < expected.buffers_.size(); ++i) {
+    // saved buffers are as aligned as allocated ones
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(actual.buffers_[i].get()) % 64, 0u);
+    EXPECT_EQ(memcmp(expected.buffers_[i].get(), actual.buffers_[i].get(), expected.buffer_sizes_[i]), 0);
+  }
+}
+
+TEST(PrepackedWeightsFileTest, SaveAndLoad) {
+  TemporaryDirectory temp_dir(ORT_TSTR("prepacked_weights_file_test_dir"));
+  const PathString path = temp_dir.Path() + GetPathSep<PathChar>() + ORT_TSTR("weights.prepacked");
+
+  AllocatorPtr alloc = std::make_shared<CPUAllocator>();
+  PrepackedWeightsFile file;
+  const PrePackedWeights* matmul_weights = file.AddWeights(0, kOnnxDomain, "MatMul", 1, "W",
+                                                           CreateWeights(alloc, {100}, 1));
+  const PrePackedWeights* conv_weights = file.AddWeights(1, kOnnxDomain, "Conv", 1, "W",
+                                                         CreateWeights(alloc, {7, 300, 13}, 2));
+  ASSERT_NE(matmul_weights, nullptr);
+  ASSERT_NE(conv_weights, nullptr);
+  ASSERT_STATUS_OK(file.Save(path));
+
+  std::unique_ptr<PrepackedWeightsFile> loaded;
+  ASSERT_STATUS_OK(PrepackedWeightsFile::Load(path, loaded));
+  ASSERT_EQ(loaded->NumWeights(), static_cast<size_t>(2));
+
+  const PrePackedWeights* loaded_matmul_weights = loaded->GetWeights(0, kOnnxDomain, "MatMul", 1, "W");
+  ASSERT_NE(loaded_matmul_weights, nullptr);
+  ExpectSameWeights(*matmul_weights, *loaded_matmul_weights);
+
+  const PrePackedWeights* loaded_conv_weights = loaded->GetWeights(1, kOnnxDomain, "Conv", 1, "W");
+  ASSERT_NE(loaded_conv_weights, nullptr);
+  ExpectSameWeights(*conv_weights, *loaded_conv_weights);
+
+  EXPECT_EQ(loaded->GetWeights(0, kOnnxDomain, "MatMul", 0, "W"), nullptr);
+  EXPECT_EQ(loaded->GetWeights(1, kOnnxDomain, "Conv", 1, "B"), nullptr);
+  // the weights of a node are not handed to a kernel of another op type
+  EXPECT_EQ(loaded->GetWeights(0, kOnnxDomain, "Gemm", 1, "W"), nullptr);
+  EXPECT_EQ(loaded->GetWeights(0, kMSDomain, "MatMul", 1, "W"), nullptr);
+}
+
+TEST(PrepackedWeightsFileTest, AddExistingWeights) {
+  AllocatorPtr alloc = std::make_shared<CPUAllocator>();
+  PrepackedWeightsFile file;
+  const PrePackedWeights* weights = file.AddWeights(0, kOnnxDomain, "MatMul", 1, "W", CreateWeights(alloc, {100}, 1));
+  ASSERT_NE(weights, nullptr);
+  const void* buffer = weights->buffers_[0].get();
+
+  // a kernel may use the buffers of the stored weights, so they are kept
+  PrePackedWeights other_weights = CreateWeights(alloc, {100}, 2);
+  EXPECT_EQ(file.AddWeights(0, kOnnxDomain, "MatMul", 1, "W", std::move(other_weights)), nullptr);
+  EXPECT_EQ(file.NumWeights(), static_cast<size_t>(1));
+  EXPECT_EQ(file.GetWeights(0, kOnnxDomain, "MatMul", 1, "W")->buffers_[0].get(), buffer);
+}
+
+TEST(PrepackedWeightsFileTest, LoadTruncatedFile) {
+  TemporaryDirectory temp_dir(ORT_TSTR("prepacked_weights_file_test_dir"));
+  const PathString path = temp_dir.Path() + GetPathSep<PathChar>() + ORT_TSTR("weights.prepacked");
+
+  AllocatorPtr alloc = std::make_shared<CPUAllocator>();
+  PrepackedWeightsFile file;
+  file.AddWeights(0, kOnnxDomain, "MatMul", 1, "W", CreateWeights(alloc, {1000}, 1));
+  ASSERT_STATUS_OK(file.Save(path));
+
+  // drop the end of the buffer
+  {
+    std::ifstream in(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), static_cast<std::streamsize>(contents.size() - 10));
+  }
+
+  std::unique_ptr<PrepackedWeightsFile> loaded;
+  EXPECT_FALSE(PrepackedWeightsFile::Load(path, loaded).IsOK());
+  EXPECT_EQ(loaded, nullptr);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
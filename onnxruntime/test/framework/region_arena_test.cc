@@ -0,0 +1,152 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <thread>
+
+#include "core/framework/region_arena.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+std::shared_ptr<RegionArenaChunkPool> CreatePool(size_t chunk_size) {
+  return std::make_shared<RegionArenaChunkPool>(std::make_shared<CPUAllocator>(), chunk_size);
+}
+}  // namespace
+
+TEST(RegionArenaTest, BumpAllocation) {
+  auto pool = CreatePool(4096);
+  {
+    RegionArena arena(pool);
+    char* p1 = static_cast<char*>(arena.Alloc(100));
+    char* p2 = static_cast<char*>(arena.Alloc(300));
+    // allocations are rounded up to the alignment and placed one after the other
+    EXPECT_EQ(p2, p1 + kAllocAlignment);
+
+    // freeing the latest allocation rolls it back
+    arena.Free(p2);
+    char* p3 = static_cast<char*>(arena.Alloc(200));
+    EXPECT_EQ(p3, p2);
+
+    // freeing an older allocation doesn't
+    arena.Free(p1);
+    char* p4 = static_cast<char*>(arena.Alloc(10));
+    EXPECT_EQ(p4, p3 + kAllocAlignment);
+
+    // the last one doesn't fit in the remainder of the chunk so a new chunk is used
+    for (int i = 0; i < 4; ++i) {
+      arena.Alloc(1024);
+    }
+    EXPECT_EQ(pool->NumChunks(), 2u);
+
+    AllocatorStats stats;
+    arena.GetStats(&stats);
+    EXPECT_EQ(stats.num_allocs, 8);
+    EXPECT_EQ(stats.num_arena_extensions, 2);
+    EXPECT_EQ(stats.num_lock_contentions, 0);
+  }
+
+  // chunks are returned to the pool and reused by the next arena
+  RegionArena arena(pool);
+  for (int i = 0; i < 5; ++i) {
+    arena.Alloc(1024);
+  }
+  EXPECT_EQ(pool->NumChunks(), 2u);
+}
+
+TEST(RegionArenaTest, LargeAllocations) {
+  auto pool = CreatePool(4096);
+  RegionArena arena(pool);
+
+  void* large = arena.Alloc(2048);
+  ASSERT_NE(large, nullptr);
+  EXPECT_EQ(pool->NumChunks(), 0u);
+
+  AllocatorStats stats;
+  arena.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 2048);
+
+  arena.Free(large);
+  arena.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(RegionArenaTest, ConcurrentRuns) {
+  // chain of Add nodes with memory patterns disabled so every intermediate value is allocated individually
+  auto p_model = std::make_unique<Model>("ChainModel", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = p_model->MainGraph();
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  constexpr int depth = 8;
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+  NodeArg* current = &input_arg;
+  for (int i = 0; i < depth; ++i) {
+    const std::string name = i + 1 == depth ? "Y" : "add_" + std::to_string(i);
+    auto& output_arg = graph.GetOrCreateNodeArg(name, &float_tensor);
+    graph.AddNode(name, "Add", "", {current, &input_arg}, {&output_arg});
+    current = &output_arg;
+  }
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_str;
+  p_model->ToProto().SerializeToString(&model_str);
+
+  SessionOptions so;
+  so.session_logid = "RegionArenaTest.ConcurrentRuns";
+  so.enable_mem_pattern = false;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigUseRegionArena, "1"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigRegionArenaChunkSize, "65536"));
+  InferenceSession session_object{so, GetEnvironment()};
+  std::stringstream sstr(model_str);
+  ASSERT_STATUS_OK(session_object.Load(sstr));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::vector<float> x_values{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 3}, x_values, &x);
+
+  constexpr int num_threads = 8;
+  std::vector<std::thread> threads;
+  std::vector<std::vector<OrtValue>> outputs(num_threads);
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      RunOptions run_options;
+      for (int run = 0; run < 20; ++run) {
+        NameMLValMap feeds{{"X", x}};
+        std::vector<std::string> output_names{"Y"};
+        std::vector<OrtValue> fetches;
+        ASSERT_STATUS_OK(session_object.Run(run_options, feeds, output_names, &fetches));
+        outputs[t].push_back(fetches[0]);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // outputs stay valid after their Run returned
+  for (const auto& thread_outputs : outputs) {
+    ASSERT_EQ(thread_outputs.size(), 20u);
+    for (const auto& output : thread_outputs) {
+      auto y_values = output.Get<Tensor>().DataAsSpan<float>();
+      ASSERT_EQ(y_values.size(), x_values.size());
+      for (size_t i = 0; i < x_values.size(); ++i) {
+        EXPECT_FLOAT_EQ(y_values[i], 9.0f * x_values[i]);
+      }
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
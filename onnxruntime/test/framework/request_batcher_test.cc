@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <thread>
+
+#include "core/graph/model.h"
+#include "core/session/onnxruntime_run_options_config_keys.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/inference_session_wrapper.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+// Y = X * X with X of shape {batch_dim, 3}. batch_dim is symbolic if empty.
+std::string CreateMulModel(const std::string& batch_dim) {
+  auto p_model = std::make_unique<Model>("MulModel", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = p_model->MainGraph();
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  auto* shape = float_tensor.mutable_tensor_type()->mutable_shape();
+  if (batch_dim.empty()) {
+    shape->add_dim()->set_dim_param("batch");
+  } else {
+    shape->add_dim()->set_dim_value(std::stoll(batch_dim));
+  }
+  shape->add_dim()->set_dim_value(3);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("mul", "Mul", "", {&input_arg, &input_arg}, {&output_arg});
+  ORT_THROW_IF_ERROR(graph.Resolve());
+
+  std::string model_str;
+  p_model->ToProto().SerializeToString(&model_str);
+  return model_str;
+}
+
+void InitializeSession(InferenceSessionWrapper& session, const std::string& model_str) {
+  std::stringstream sstr(model_str);
+  ASSERT_STATUS_OK(session.Load(sstr));
+  ASSERT_STATUS_OK(session.Initialize());
+}
+}  // namespace
+
+TEST(RequestBatcherTest, ConcurrentRequestsAreBatched) {
+  SessionOptions so;
+  so.session_logid = "RequestBatcherTest.ConcurrentRequestsAreBatched";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize, "4"));
+  // long enough for all the requests of a batch to arrive
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigDynamicBatchingMaxWaitMicros, "200000"));
+  InferenceSessionWrapper session{so, GetEnvironment()};
+  InitializeSession(session, CreateMulModel(""));
+  const RequestBatcher* batcher = session.GetRequestBatcher();
+  ASSERT_NE(batcher, nullptr);
+
+  constexpr int num_threads = 8;
+  std::vector<std::thread> threads;
+  std::vector<std::vector<OrtValue>> outputs(num_threads);
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      std::vector<float> x_values{1.0f * t, 2.0f * t, 3.0f * t};
+      OrtValue x;
+      CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1, 3}, x_values, &x);
+      RunOptions run_options;
+      NameMLValMap feeds{{"X", x}};
+      std::vector<std::string> output_names{"Y"};
+      ASSERT_STATUS_OK(session.Run(run_options, feeds, output_names, &outputs[t]));
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int t = 0; t < num_threads; ++t) {
+    ASSERT_EQ(outputs[t].size(), 1u);
+    const auto& y = outputs[t][0].Get<Tensor>();
+    ASSERT_EQ(y.Shape(), TensorShape({1, 3}));
+    auto y_values = y.DataAsSpan<float>();
+    for (int i = 0; i < 3; ++i) {
+      const float x_value = static_cast<float>((i + 1) * t);
+      EXPECT_FLOAT_EQ(y_values[i], x_value * x_value);
+    }
+  }
+
+  EXPECT_EQ(batcher->NumBatchedRequests(), static_cast<size_t>(num_threads));
+  EXPECT_LT(batcher->NumBatches(), static_cast<size_t>(num_threads));
+}
+
+TEST(RequestBatcherTest, OptOut) {
+  SessionOptions so;
+  so.session_logid = "RequestBatcherTest.OptOut";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize, "4"));
+  InferenceSessionWrapper session{so, GetEnvironment()};
+  InitializeSession(session, CreateMulModel(""));
+  const RequestBatcher* batcher = session.GetRequestBatcher();
+  ASSERT_NE(batcher, nullptr);
+
+  std::vector<float> x_values{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 3}, x_values, &x);
+  NameMLValMap feeds{{"X", x}};
+
+  RunOptions run_options;
+  ASSERT_STATUS_OK(run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigDisableDynamicBatching, "1"));
+  std::vector<std::string> output_names{"Y"};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session.Run(run_options, feeds, output_names, &fetches));
+  EXPECT_EQ(fetches[0].Get<Tensor>().Shape(), TensorShape({2, 3}));
+  EXPECT_EQ(batcher->NumBatches(), 0u);
+}
+
+TEST(RequestBatcherTest, FixedBatchDimensionDisablesBatching) {
+  SessionOptions so;
+  so.session_logid = "RequestBatcherTest.FixedBatchDimensionDisablesBatching";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize, "4"));
+  InferenceSessionWrapper session{so, GetEnvironment()};
+  InitializeSession(session, CreateMulModel("2"));
+  EXPECT_EQ(session.GetRequestBatcher(), nullptr);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -283,6 +283,69 @@ TEST(SessionStateTest, TestInitializerMemoryAllocatedUsingNonArenaMemory) {
   }
 }
 
+// Test that the tensor of an initializer with external data is created on the mapped file without allocating memory
+// for it if the relevant session option config flag is set
+TEST(SessionStateTest, TestExternalInitializerMappedWithoutAllocation) {
+  // Part 1: Feature turned OFF: the session allocates a buffer for the initializer from the arena (default behavior)
+  // Part 2: Feature turned ON: the tensor of the initializer is created on the mapped file
+  for (bool use_mmap_for_external_initializers : {false, true}) {
+    const ORTCHAR_T* model_path = ORT_TSTR("testdata/model_with_external_initializers.onnx");
+    std::shared_ptr<Model> model;
+    ASSERT_STATUS_OK(Model::Load(model_path, model, nullptr, DefaultLoggingManager().DefaultLogger()));
+    Graph& graph = model->MainGraph();
+
+    ExecutionProviders execution_providers;
+    CPUExecutionProviderInfo epi{true};  // use an arena-based allocator for this EP
+    ASSERT_STATUS_OK(execution_providers.Add(onnxruntime::kCpuExecutionProvider,
+                                             std::make_unique<CPUExecutionProvider>(epi)));
+
+    KernelRegistryManager krm;
+    ASSERT_STATUS_OK(krm.RegisterKernels(execution_providers));
+
+    DataTransferManager dtm;
+    profiling::Profiler profiler;
+
+    SessionState session_state(graph, execution_providers, false, nullptr, nullptr, dtm,
+                               DefaultLoggingManager().DefaultLogger(), profiler);
+
+    GraphPartitioner partitioner(krm, execution_providers);
+    ASSERT_STATUS_OK(partitioner.Partition(graph, session_state.GetMutableFuncMgr(),
+                                           layout_transformer::TransformLayoutForEP));
+
+    SessionOptions so;
+    if (use_mmap_for_external_initializers) {
+      ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigUseMmapForExternalInitializers, "1"));
+    }
+    ASSERT_STATUS_OK(session_state.FinalizeSessionState(model_path, krm, so));
+
+    // the data of the initializer is read from the file
+    int idx;
+    ASSERT_STATUS_OK(session_state.GetOrtValueNameIdxMap().GetIdx("Pads", idx));
+    const auto& initialized_tensors = session_state.GetInitializedTensors();
+    ASSERT_NE(initialized_tensors.find(idx), initialized_tensors.end());
+    const Tensor& pads = initialized_tensors.at(idx).Get<Tensor>();
+    ASSERT_EQ(pads.Shape().Size(), 4);
+    const std::vector<int64_t> expected_pads{0, 0, 1, 1};
+    EXPECT_EQ(std::vector<int64_t>(pads.Data<int64_t>(), pads.Data<int64_t>() + 4), expected_pads);
+
+    // Fetch the CPU arena-allocator from the session state
+    OrtMemoryInfo mem_info(CPU, OrtArenaAllocator);
+    AllocatorPtr alloc = session_state.GetAllocator(mem_info);
+    ASSERT_TRUE(alloc != nullptr);
+
+    // Get stats for the CPU arena-based allocator
+    AllocatorStats alloc_stats;
+    static_cast<BFCArena*>(alloc.get())->GetStats(&alloc_stats);
+
+    // Assert that we have made no Reserve() calls
+    ASSERT_EQ(alloc_stats.num_reserves, 0);
+
+    // Without the feature a buffer is allocated for the initializer (Alloc() was invoked) even though its tensor ends
+    // up on the mapped file. With the feature no memory is allocated for it.
+    ASSERT_EQ(alloc_stats.num_allocs, use_mmap_for_external_initializers ? 0 : 1);
+  }
+}
+
 #endif
 
 INSTANTIATE_TEST_SUITE_P(SessionStateTests, SessionStateTestP, testing::ValuesIn(param_list));
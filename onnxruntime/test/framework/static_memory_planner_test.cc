@@ -0,0 +1,217 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <random>
+
+#include "core/framework/mem_pattern_planner.h"
+#include "core/framework/static_memory_planner.h"
+#include "core/graph/model.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/inference_session_wrapper.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+AllocPlanPerValue::ProgramCounter CreateCounter(std::initializer_list<std::pair<size_t, size_t>> intervals) {
+  AllocPlanPerValue::ProgramCounter counter;
+  for (const auto& interval : intervals) {
+    counter.AddStart(interval.first);
+    counter.AddEnd(interval.second);
+  }
+  return counter;
+}
+
+// chain of 'depth' Add nodes, each adding X to the previous output
+void CreateChainModel(std::unique_ptr<Model>& p_model, int depth, bool symbolic_batch) {
+  p_model = std::make_unique<Model>("ChainModel", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = p_model->MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  auto* batch_dim = float_tensor.mutable_tensor_type()->mutable_shape()->add_dim();
+  if (symbolic_batch) {
+    batch_dim->set_dim_param("batch");
+  } else {
+    batch_dim->set_dim_value(2);
+  }
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+  NodeArg* current = &input_arg;
+  for (int i = 0; i < depth; ++i) {
+    const std::string name = i + 1 == depth ? "Y" : "add_" + std::to_string(i);
+    auto& output_arg = graph.GetOrCreateNodeArg(name, &float_tensor);
+    graph.AddNode(name, "Add", "", {current, &input_arg}, {&output_arg});
+    current = &output_arg;
+  }
+
+  ASSERT_STATUS_OK(graph.Resolve());
+}
+}  // namespace
+
+TEST(StaticMemoryPlannerTest, BestFitBeatsTracedPattern) {
+  // A is allocated first and freed after B is allocated, C is allocated while B is still alive.
+  // tracing in execution order places B after A, leaving a gap too small for C.
+  auto counter_a = CreateCounter({{0, 1}});
+  auto counter_b = CreateCounter({{1, 2}});
+  auto counter_c = CreateCounter({{2, 2}});
+
+  MemPatternPlanner traced{false};
+  traced.TraceAllocation(0, 50);
+  traced.TraceAllocation(1, 100);
+  traced.TraceFree(0);
+  traced.TraceAllocation(2, 100);
+  EXPECT_EQ(traced.GenerateMemPattern().PeakSize(), 250u);
+
+  StaticMemoryPlanner planner;
+  planner.AddBuffer(0, 50, counter_a);
+  planner.AddBuffer(1, 100, counter_b);
+  planner.AddBuffer(2, 100, counter_c);
+  auto pattern = planner.GeneratePattern();
+  EXPECT_EQ(pattern.PeakSize(), 200u);
+
+  // B is placed first, C next to it, and A in the space C uses later
+  EXPECT_EQ(pattern.GetBlock(1)->offset_, 0u);
+  EXPECT_EQ(pattern.GetBlock(2)->offset_, 100u);
+  EXPECT_EQ(pattern.GetBlock(0)->offset_, 100u);
+}
+
+TEST(StaticMemoryPlannerTest, ReusedBufferLifetimes) {
+  // buffer 0 is reused by a later value so it's in use during two separate intervals
+  auto counter_0 = CreateCounter({{0, 1}, {4, 5}});
+  auto counter_1 = CreateCounter({{2, 3}});
+  auto counter_2 = CreateCounter({{1, 4}});
+
+  StaticMemoryPlanner planner;
+  planner.AddBuffer(0, 64, counter_0);
+  planner.AddBuffer(1, 64, counter_1);
+  planner.AddBuffer(2, 32, counter_2);
+  auto pattern = planner.GeneratePattern();
+
+  // buffer 1 fits in the gap of buffer 0
+  EXPECT_EQ(pattern.GetBlock(0)->offset_, pattern.GetBlock(1)->offset_);
+  EXPECT_EQ(pattern.PeakSize(), 96u);
+}
+
+TEST(StaticMemoryPlannerTest, RandomLifetimesDontOverlap) {
+  constexpr size_t num_buffers = 200;
+  constexpr size_t num_steps = 50;
+  std::default_random_engine generator(1234);
+  std::uniform_int_distribution<size_t> step_distribution(0, num_steps - 1);
+  std::uniform_int_distribution<size_t> size_distribution(1, 1024);
+
+  std::vector<AllocPlanPerValue::ProgramCounter> counters;
+  std::vector<size_t> sizes;
+  counters.reserve(num_buffers);
+  for (size_t i = 0; i < num_buffers; ++i) {
+    size_t start = step_distribution(generator);
+    size_t end = step_distribution(generator);
+    counters.push_back(CreateCounter({{std::min(start, end), std::max(start, end)}}));
+    sizes.push_back(size_distribution(generator) * kAllocAlignment);
+  }
+
+  StaticMemoryPlanner planner;
+  for (size_t i = 0; i < num_buffers; ++i) {
+    planner.AddBuffer(static_cast<int>(i), sizes[i], counters[i]);
+  }
+  auto pattern = planner.GeneratePattern();
+
+  // the peak can't be lower than the memory in use at the busiest step
+  size_t max_live_size = 0;
+  for (size_t step = 0; step < num_steps; ++step) {
+    size_t live_size = 0;
+    for (size_t i = 0; i < num_buffers; ++i) {
+      if (counters[i].Starts()[0] <= step && step <= counters[i].Ends()[0]) {
+        live_size += sizes[i];
+      }
+    }
+    max_live_size = std::max(max_live_size, live_size);
+  }
+  EXPECT_GE(pattern.PeakSize(), max_live_size);
+
+  for (size_t i = 0; i < num_buffers; ++i) {
+    const auto* block_i = pattern.GetBlock(static_cast<int>(i));
+    ASSERT_NE(block_i, nullptr);
+    EXPECT_LE(block_i->offset_ + block_i->size_, pattern.PeakSize());
+    for (size_t j = i + 1; j < num_buffers; ++j) {
+      const bool live_together = counters[i].Starts()[0] <= counters[j].Ends()[0] &&
+                                 counters[j].Starts()[0] <= counters[i].Ends()[0];
+      if (!live_together) {
+        continue;
+      }
+
+      const auto* block_j = pattern.GetBlock(static_cast<int>(j));
+      const bool disjoint = block_i->offset_ + block_i->size_ <= block_j->offset_ ||
+                            block_j->offset_ + block_j->size_ <= block_i->offset_;
+      EXPECT_TRUE(disjoint) << "buffers " << i << " and " << j << " overlap";
+    }
+  }
+}
+
+TEST(StaticMemoryPlannerTest, SessionWithStaticShapes) {
+  std::unique_ptr<Model> p_model;
+  CreateChainModel(p_model, 8, false);
+  std::string model_str;
+  p_model->ToProto().SerializeToString(&model_str);
+
+  SessionOptions so;
+  so.session_logid = "StaticMemoryPlannerTest.SessionWithStaticShapes";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigEnableStaticMemoryPlanning, "1"));
+  InferenceSessionWrapper session_object{so, GetEnvironment()};
+  std::stringstream sstr(model_str);
+  ASSERT_STATUS_OK(session_object.Load(sstr));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  const auto* plan = session_object.GetSessionState().GetStaticMemoryPlan();
+  ASSERT_NE(plan, nullptr);
+  EXPECT_GT(plan->PlannedPeakSize(), 0u);
+  EXPECT_LE(plan->PlannedPeakSize(), plan->TracedPeakSize());
+
+  std::vector<float> x_values{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 3}, x_values, &x);
+
+  RunOptions run_options;
+  for (int run = 0; run < 3; ++run) {
+    NameMLValMap feeds{{"X", x}};
+    std::vector<std::string> output_names{"Y"};
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(run_options, feeds, output_names, &fetches));
+    ASSERT_EQ(fetches.size(), 1u);
+
+    auto y_values = fetches[0].Get<Tensor>().DataAsSpan<float>();
+    ASSERT_EQ(y_values.size(), x_values.size());
+    for (size_t i = 0; i < x_values.size(); ++i) {
+      EXPECT_FLOAT_EQ(y_values[i], 9.0f * x_values[i]);
+    }
+  }
+
+  // no memory pattern is traced when the static plan is used
+  EXPECT_EQ(session_object.GetSessionState().GetMemoryPatternCache().Size(), 0u);
+}
+
+TEST(StaticMemoryPlannerTest, SessionWithSymbolicShapes) {
+  std::unique_ptr<Model> p_model;
+  CreateChainModel(p_model, 4, true);
+  std::string model_str;
+  p_model->ToProto().SerializeToString(&model_str);
+
+  SessionOptions so;
+  so.session_logid = "StaticMemoryPlannerTest.SessionWithSymbolicShapes";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigEnableStaticMemoryPlanning, "1"));
+  InferenceSessionWrapper session_object{so, GetEnvironment()};
+  std::stringstream sstr(model_str);
+  ASSERT_STATUS_OK(session_object.Load(sstr));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  // falls back to traced memory patterns
+  EXPECT_EQ(session_object.GetSessionState().GetStaticMemoryPlan(), nullptr);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/subgraph_result_cache.h"
+#include "core/graph/model.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/inference_session_wrapper.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+// U2 = U * U, U3 = U2 + U, Y = U3 + X. U, X and Y are of shape {3}.
+std::string CreateModel() {
+  auto p_model = std::make_unique<Model>("SubgraphResultCacheModel", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = p_model->MainGraph();
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  auto& u = graph.GetOrCreateNodeArg("U", &float_tensor);
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& u2 = graph.GetOrCreateNodeArg("U2", &float_tensor);
+  auto& u3 = graph.GetOrCreateNodeArg("U3", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("mul", "Mul", "", {&u, &u}, {&u2});
+  graph.AddNode("add_u", "Add", "", {&u2, &u}, {&u3});
+  graph.AddNode("add_x", "Add", "", {&u3, &x}, {&y});
+  ORT_THROW_IF_ERROR(graph.Resolve());
+
+  std::string model_str;
+  p_model->ToProto().SerializeToString(&model_str);
+  return model_str;
+}
+
+void RunAndCheck(InferenceSessionWrapper& session, const std::vector<float>& u_values,
+                 const std::vector<float>& x_values) {
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue u;
+  OrtValue x;
+  CreateMLValue<float>(allocator, {3}, u_values, &u);
+  CreateMLValue<float>(allocator, {3}, x_values, &x);
+  NameMLValMap feeds{{"U", u}, {"X", x}};
+
+  std::vector<std::string> output_names{"Y"};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session.Run(RunOptions{}, feeds, output_names, &fetches));
+  auto y_values = fetches[0].Get<Tensor>().DataAsSpan<float>();
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_FLOAT_EQ(y_values[i], u_values[i] * u_values[i] + u_values[i] + x_values[i]);
+  }
+}
+}  // namespace
+
+TEST(SubgraphResultCacheTest, RepeatedInputsHitTheCache) {
+  SessionOptions so;
+  so.session_logid = "SubgraphResultCacheTest.RepeatedInputsHitTheCache";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigCacheableInputs, "U"));
+  InferenceSessionWrapper session{so, GetEnvironment()};
+  std::stringstream sstr(CreateModel());
+  ASSERT_STATUS_OK(session.Load(sstr));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  const auto* cache = session.GetSessionState().GetSubgraphResultCache();
+  ASSERT_NE(cache, nullptr);
+  EXPECT_EQ(cache->NumCachedNodes(), 2u);
+
+  RunAndCheck(session, {1.f, 2.f, 3.f}, {1.f, 1.f, 1.f});
+  EXPECT_EQ(cache->NumMisses(), 1u);
+  EXPECT_EQ(cache->NumHits(), 0u);
+
+  // same U, different X
+  RunAndCheck(session, {1.f, 2.f, 3.f}, {5.f, 6.f, 7.f});
+  EXPECT_EQ(cache->NumHits(), 1u);
+
+  RunAndCheck(session, {4.f, 5.f, 6.f}, {5.f, 6.f, 7.f});
+  EXPECT_EQ(cache->NumMisses(), 2u);
+
+  RunAndCheck(session, {1.f, 2.f, 3.f}, {-1.f, 0.f, 1.f});
+  EXPECT_EQ(cache->NumHits(), 2u);
+  EXPECT_EQ(cache->NumEvictions(), 0u);
+}
+
+TEST(SubgraphResultCacheTest, BudgetEvictsLeastRecentlyUsed) {
+  SessionOptions so;
+  so.session_logid = "SubgraphResultCacheTest.BudgetEvictsLeastRecentlyUsed";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigCacheableInputs, "U"));
+  // an entry holds a copy of U and of U3, 24 bytes
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigSubgraphCacheBudgetBytes, "48"));
+  InferenceSessionWrapper session{so, GetEnvironment()};
+  std::stringstream sstr(CreateModel());
+  ASSERT_STATUS_OK(session.Load(sstr));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  const auto* cache = session.GetSessionState().GetSubgraphResultCache();
+  ASSERT_NE(cache, nullptr);
+
+  RunAndCheck(session, {1.f, 1.f, 1.f}, {0.f, 0.f, 0.f});
+  RunAndCheck(session, {2.f, 2.f, 2.f}, {0.f, 0.f, 0.f});
+  EXPECT_EQ(cache->SizeInBytes(), 48u);
+
+  // evicts U = 1
+  RunAndCheck(session, {3.f, 3.f, 3.f}, {0.f, 0.f, 0.f});
+  EXPECT_EQ(cache->NumEvictions(), 1u);
+  EXPECT_EQ(cache->SizeInBytes(), 48u);
+
+  RunAndCheck(session, {2.f, 2.f, 2.f}, {1.f, 1.f, 1.f});
+  EXPECT_EQ(cache->NumHits(), 1u);
+  RunAndCheck(session, {1.f, 1.f, 1.f}, {1.f, 1.f, 1.f});
+  EXPECT_EQ(cache->NumHits(), 1u);
+  EXPECT_EQ(cache->NumMisses(), 4u);
+}
+
+TEST(SubgraphResultCacheTest, InvalidInputName) {
+  SessionOptions so;
+  so.session_logid = "SubgraphResultCacheTest.InvalidInputName";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigCacheableInputs, "U2"));
+  InferenceSessionWrapper session{so, GetEnvironment()};
+  std::stringstream sstr(CreateModel());
+  ASSERT_STATUS_OK(session.Load(sstr));
+  auto status = session.Initialize();
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_THAT(status.ErrorMessage(), testing::HasSubstr("is not an input of the graph"));
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -1751,6 +1751,57 @@ TEST_F(GraphTest, ReplaceInitializedTensor) {
   }
 }
 
+// Resolve skips inference for nodes that are unchanged since it last ran, so check that changes to the constant
+// inputs of a node and to the types of its inputs are still propagated.
+TEST_F(GraphTest, ResolveAfterInitializerAndInputTypeChanges) {
+  Model model("graph_1", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("N");
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(12);
+  TypeProto shape_type;
+  shape_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& shape = graph.GetOrCreateNodeArg("shape", &shape_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  auto& z = graph.GetOrCreateNodeArg("Z", nullptr);
+  graph.SetInputs({&x});
+
+  TensorProto shape_initializer;
+  shape_initializer.set_name("shape");
+  shape_initializer.set_data_type(TensorProto_DataType_INT64);
+  shape_initializer.add_dims(2);
+  shape_initializer.add_int64_data(-1);
+  shape_initializer.add_int64_data(6);
+  graph.AddInitializedTensor(shape_initializer);
+
+  graph.AddNode("reshape", "Reshape", "", {&x, &shape}, {&y});
+  graph.AddNode("identity", "Identity", "", {&y}, {&z});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  // the first dimension is not known as N is symbolic
+  const auto* z_shape = graph.GetNodeArg("Z")->Shape();
+  ASSERT_NE(z_shape, nullptr);
+  ASSERT_EQ(z_shape->dim_size(), 2);
+  EXPECT_FALSE(utils::HasDimValue(z_shape->dim(0)));
+  EXPECT_EQ(z_shape->dim(1).dim_value(), 6);
+
+  shape_initializer.set_int64_data(0, 2);
+  ASSERT_STATUS_OK(graph.ReplaceInitializedTensor(shape_initializer));
+  graph.SetGraphResolveNeeded();
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  // Reshape is inferred again as its shape input changed, and Identity as its input type changed
+  z_shape = graph.GetNodeArg("Z")->Shape();
+  ASSERT_NE(z_shape, nullptr);
+  ASSERT_EQ(z_shape->dim_size(), 2);
+  EXPECT_EQ(z_shape->dim(0).dim_value(), 2);
+  EXPECT_EQ(z_shape->dim(1).dim_value(), 6);
+}
+
 #if !defined(ORT_MINIMAL_BUILD) && !defined(DISABLE_EXTERNAL_INITIALIZERS)
 
 namespace {
@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <cmath>
+#include <stdexcept>
+
+static const std::vector<std::string> flashattn_bench_arg_names = {"N", "S", "H"};
+
+//
+// Computes the attention of each head by materializing the S x T matrix of
+// attention probabilities, as the reference for the tiled implementation.
+//
+void ATTENTION_MATERIALIZED(benchmark::State& state, bool causal) {
+  if (state.range(0) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("S must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("H must greater than 0!");
+  const size_t N = static_cast<size_t>(state.range(0));
+  const size_t S = static_cast<size_t>(state.range(1));
+  const size_t H = static_cast<size_t>(state.range(2));
+
+  auto query = RandomVectorUniform(N * S * H, -1.0f, 1.0f);
+  auto key = RandomVectorUniform(N * S * H, -1.0f, 1.0f);
+  auto value = RandomVectorUniform(N * S * H, -1.0f, 1.0f);
+  std::vector<float> probs(S * S);
+  std::vector<float> output(S * N * H);
+  const float scale = 1.0f / std::sqrt(static_cast<float>(H));
+
+  for (auto _ : state) {
+    for (size_t n = 0; n < N; n++) {
+      MlasGemm(CblasNoTrans, CblasTrans, S, S, H, scale, query.data() + n * S * H, H,
+               key.data() + n * S * H, H, 0.0f, probs.data(), S, nullptr);
+      if (causal) {
+        for (size_t s = 0; s < S; s++) {
+          std::fill(probs.data() + s * S + s + 1, probs.data() + (s + 1) * S, -10000.0f);
+        }
+      }
+      MlasComputeSoftmax(probs.data(), probs.data(), S, S, false, nullptr);
+      MlasGemm(CblasNoTrans, CblasNoTrans, S, H, S, 1.0f, probs.data(), S,
+               value.data() + n * S * H, H, 0.0f, output.data() + n * H, N * H, nullptr);
+    }
+  }
+}
+
+void ATTENTION_TILED(benchmark::State& state, bool causal) {
+  if (state.range(0) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("S must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("H must greater than 0!");
+  const size_t N = static_cast<size_t>(state.range(0));
+  const size_t S = static_cast<size_t>(state.range(1));
+  const size_t H = static_cast<size_t>(state.range(2));
+
+  auto query = RandomVectorUniform(N * S * H, -1.0f, 1.0f);
+  auto key = RandomVectorUniform(N * S * H, -1.0f, 1.0f);
+  auto value = RandomVectorUniform(N * S * H, -1.0f, 1.0f);
+  std::vector<float> output(S * N * H);
+  const float scale = 1.0f / std::sqrt(static_cast<float>(H));
+
+  MLAS_FLASH_ATTENTION_PARAMETERS parameters;
+  size_t working_buffer_size;
+  MlasFlashAttentionPrepare(&parameters, 1, N, S, S, H, H, scale, causal, -10000.0f, &working_buffer_size, nullptr);
+  std::vector<float> working_buffer(working_buffer_size);
+
+  for (auto _ : state) {
+    MlasFlashAttention(&parameters, query.data(), key.data(), value.data(), nullptr,
+                       working_buffer.data(), output.data(), nullptr);
+  }
+}
+
+static void AttentionSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(flashattn_bench_arg_names);
+  ArgsProduct(b, {{1}, {512, 2048, 8192}, {64}});
+}
+
+BENCHMARK_CAPTURE(ATTENTION_MATERIALIZED, NonCausal, false)->Apply(AttentionSizes)->UseRealTime()->Unit(benchmark::TimeUnit::kMillisecond);
+BENCHMARK_CAPTURE(ATTENTION_MATERIALIZED, Causal, true)->Apply(AttentionSizes)->UseRealTime()->Unit(benchmark::TimeUnit::kMillisecond);
+BENCHMARK_CAPTURE(ATTENTION_TILED, NonCausal, false)->Apply(AttentionSizes)->UseRealTime()->Unit(benchmark::TimeUnit::kMillisecond);
+BENCHMARK_CAPTURE(ATTENTION_TILED, Causal, true)->Apply(AttentionSizes)->UseRealTime()->Unit(benchmark::TimeUnit::kMillisecond);
@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+#include <numeric>
+
+static const std::vector<std::string> halfgemm_bench_arg_names = {"M", "N", "K"};
+
+static std::vector<MLAS_FP16> RandomHalfVector(size_t N) {
+  auto values = RandomVectorUniform(N, -1.0f, 1.0f);
+  std::vector<MLAS_FP16> r(N);
+  MlasConvertFloatToHalfBuffer(values.data(), r.data(), N);
+  return r;
+}
+
+void HALFGEMM(benchmark::State& state, bool pack_b, bool trans_a, bool trans_b) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("K must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+
+  auto A = RandomHalfVector(M * K);
+  auto B = RandomHalfVector(N * K);
+  std::vector<MLAS_FP16> C(M * N);
+  std::vector<uint8_t> B_packed;
+
+  MLAS_HALF_GEMM_DATA_PARAMS data;
+  data.A = A.data();
+  data.lda = trans_a ? M : K;
+  data.B = B.data();
+  data.ldb = trans_b ? K : N;
+  data.C = C.data();
+  data.ldc = N;
+
+  if (pack_b) {
+    B_packed.resize(MlasHalfGemmPackBSize(N, K));
+    MlasHalfGemmPackB(trans_b ? CblasTrans : CblasNoTrans, N, K, B.data(), data.ldb, B_packed.data());
+    data.B = B_packed.data();
+    data.BIsPacked = true;
+  }
+
+  const CBLAS_TRANSPOSE TransA = trans_a ? CblasTrans : CblasNoTrans;
+  const CBLAS_TRANSPOSE TransB = trans_b ? CblasTrans : CblasNoTrans;
+
+  MlasHalfGemmBatch(TransA, TransB, M, N, K, &data, 1, nullptr);
+
+  for (auto _ : state) {
+    MlasHalfGemmBatch(TransA, TransB, M, N, K, &data, 1, nullptr);
+  }
+}
+
+static void HalfGemmSizeWithOne(benchmark::internal::Benchmark* b) {
+  b->ArgNames(halfgemm_bench_arg_names);
+  ArgsProduct(b, {{1}, {63, 255, 1023}, {63, 255, 1023}});
+  ArgsProduct(b, {{63, 255, 1023}, {1}, {63, 255, 1023}});
+}
+
+static void HalfGemmSizeProducts(benchmark::internal::Benchmark* b) {
+  b->ArgNames(halfgemm_bench_arg_names);
+  ArgsProduct(b, {{63, 255, 1023}, {63, 255, 1023}, {63, 255, 1023}});
+}
+
+BENCHMARK_CAPTURE(HALFGEMM, NORMAL_NoTrans, false, false, false)->Apply(HalfGemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(HALFGEMM, NORMAL_TransB, false, false, true)->Apply(HalfGemmSizeProducts)->UseRealTime();
+
+BENCHMARK_CAPTURE(HALFGEMM, GEMV_NoTrans, false, false, false)->Apply(HalfGemmSizeWithOne)->UseRealTime();
+BENCHMARK_CAPTURE(HALFGEMM, GEMV_PACKB, true, false, false)->Apply(HalfGemmSizeWithOne)->UseRealTime();
+
+BENCHMARK_CAPTURE(HALFGEMM, PACKB_NoTransA, true, false, false)->Apply(HalfGemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(HALFGEMM, PACKB_TransA, true, true, false)->Apply(HalfGemmSizeProducts)->UseRealTime();
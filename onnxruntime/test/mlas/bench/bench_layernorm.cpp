@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+
+static const std::vector<std::string> layernorm_bench_arg_names = {"N", "D"};
+
+void LAYERNORM(benchmark::State& state, bool skip, bool simplified) {
+  if (state.range(0) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("D must greater than 0!");
+  const size_t N = static_cast<size_t>(state.range(0));
+  const size_t D = static_cast<size_t>(state.range(1));
+
+  auto input = RandomVectorUniform(N * D, -1.0f, 1.0f);
+  auto skip_input = RandomVectorUniform(N * D, -1.0f, 1.0f);
+  auto bias = RandomVectorUniform(D, -1.0f, 1.0f);
+  auto scale = RandomVectorUniform(D, -1.0f, 1.0f);
+  auto shift = RandomVectorUniform(D, -1.0f, 1.0f);
+  std::vector<float> output(N * D);
+  std::vector<float> mean(N);
+  std::vector<float> inv_std_dev(N);
+
+  const float* skip_data = skip ? skip_input.data() : nullptr;
+  const float* bias_data = skip ? bias.data() : nullptr;
+  const float* shift_data = simplified ? nullptr : shift.data();
+
+  MlasLayerNorm(input.data(), skip_data, bias_data, scale.data(), shift_data, output.data(),
+                mean.data(), inv_std_dev.data(), N, D, 1e-5f, simplified, nullptr);
+
+  for (auto _ : state) {
+    MlasLayerNorm(input.data(), skip_data, bias_data, scale.data(), shift_data, output.data(),
+                  mean.data(), inv_std_dev.data(), N, D, 1e-5f, simplified, nullptr);
+  }
+}
+
+static void LayerNormSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(layernorm_bench_arg_names);
+  ArgsProduct(b, {{1, 128, 512}, {768, 1024, 4096}});
+}
+
+BENCHMARK_CAPTURE(LAYERNORM, LayerNorm, false, false)->Apply(LayerNormSizes)->UseRealTime();
+BENCHMARK_CAPTURE(LAYERNORM, SkipLayerNorm, true, false)->Apply(LayerNormSizes)->UseRealTime();
+BENCHMARK_CAPTURE(LAYERNORM, SimplifiedLayerNorm, false, true)->Apply(LayerNormSizes)->UseRealTime();
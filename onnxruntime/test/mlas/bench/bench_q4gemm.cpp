@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+#include <numeric>
+
+static const std::vector<std::string> q4gemm_bench_arg_names = {"M", "N", "K"};
+
+void Q4GEMM(benchmark::State& state, MLAS_BLK_QUANT_TYPE qtype) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("K must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+
+  auto A = RandomVectorUniform(M * K, -1.0f, 1.0f);
+  auto B = RandomVectorUniform(N * K, -1.0f, 1.0f);
+  std::vector<float> C(M * N);
+  std::vector<uint8_t> B_packed(MlasQ4GemmPackBSize(qtype, N, K));
+
+  MlasQ4GemmPackB(qtype, B_packed.data(), B.data(), N, K, N);
+
+  MLAS_Q4GEMM_DATA_PARAMS data;
+  data.A = A.data();
+  data.lda = K;
+  data.B = B_packed.data();
+  data.C = C.data();
+  data.ldc = N;
+
+  MlasQ4GemmBatch(qtype, M, N, K, &data, 1, nullptr);
+
+  for (auto _ : state) {
+    MlasQ4GemmBatch(qtype, M, N, K, &data, 1, nullptr);
+  }
+}
+
+static void Q4GemmGemvSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(q4gemm_bench_arg_names);
+  ArgsProduct(b, {{1}, {4096, 11008}, {4096, 11008}});
+}
+
+static void Q4GemmBatchedSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(q4gemm_bench_arg_names);
+  ArgsProduct(b, {{8, 32, 128}, {4096}, {4096}});
+}
+
+BENCHMARK_CAPTURE(Q4GEMM, GEMV_Sym32, BlkQ4Sym32)->Apply(Q4GemmGemvSizes)->UseRealTime();
+BENCHMARK_CAPTURE(Q4GEMM, GEMV_Zp32, BlkQ4Zp32)->Apply(Q4GemmGemvSizes)->UseRealTime();
+BENCHMARK_CAPTURE(Q4GEMM, GEMV_Sym128, BlkQ4Sym128)->Apply(Q4GemmGemvSizes)->UseRealTime();
+BENCHMARK_CAPTURE(Q4GEMM, GEMV_Zp128, BlkQ4Zp128)->Apply(Q4GemmGemvSizes)->UseRealTime();
+
+BENCHMARK_CAPTURE(Q4GEMM, GEMM_Sym32, BlkQ4Sym32)->Apply(Q4GemmBatchedSizes)->UseRealTime();
+BENCHMARK_CAPTURE(Q4GEMM, GEMM_Zp128, BlkQ4Zp128)->Apply(Q4GemmBatchedSizes)->UseRealTime();
@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+#include <numeric>
+
+static const std::vector<std::string> sbgemm_bench_arg_names = {"M", "N", "K"};
+
+void SBGEMM(benchmark::State& state, bool trans_a) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("K must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+
+  auto A = RandomVectorUniform(M * K, -1.0f, 1.0f);
+  auto B = RandomVectorUniform(N * K, -1.0f, 1.0f);
+  std::vector<float> C(M * N);
+  std::vector<uint8_t> B_packed(MlasSBGemmPackBSize(N, K));
+
+  MlasSBGemmPackB(CblasNoTrans, N, K, B.data(), N, B_packed.data());
+
+  MLAS_SBGEMM_DATA_PARAMS data;
+  data.A = A.data();
+  data.lda = trans_a ? M : K;
+  data.B = B_packed.data();
+  data.C = C.data();
+  data.ldc = N;
+
+  const CBLAS_TRANSPOSE TransA = trans_a ? CblasTrans : CblasNoTrans;
+
+  MlasSBGemmBatch(TransA, M, N, K, &data, 1, nullptr);
+
+  for (auto _ : state) {
+    MlasSBGemmBatch(TransA, M, N, K, &data, 1, nullptr);
+  }
+}
+
+static void SBGemmSizeWithOne(benchmark::internal::Benchmark* b) {
+  b->ArgNames(sbgemm_bench_arg_names);
+  ArgsProduct(b, {{1}, {63, 255, 1023, 4096}, {63, 255, 1023, 4096}});
+}
+
+static void SBGemmSizeProducts(benchmark::internal::Benchmark* b) {
+  b->ArgNames(sbgemm_bench_arg_names);
+  ArgsProduct(b, {{63, 255, 1023}, {63, 255, 1023}, {63, 255, 1023}});
+}
+
+BENCHMARK_CAPTURE(SBGEMM, GEMV, false)->Apply(SBGemmSizeWithOne)->UseRealTime();
+BENCHMARK_CAPTURE(SBGEMM, NoTransA, false)->Apply(SBGemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(SBGEMM, TransA, true)->Apply(SBGemmSizeProducts)->UseRealTime();
@@ -222,6 +222,22 @@ static void TeamsModel(benchmark::internal::Benchmark* b) {
 
 BENCHMARK_CAPTURE(SCONV_NCHW, TeamsModel, "")->Apply(TeamsModel)->UseRealTime();
 
+static void MobileNetV2(benchmark::internal::Benchmark* b) {
+  b->ArgNames(ArgNamesForConv(2));
+  //    Rank, N,  G, Cpg, Fpg,  I,   , K, , P, , , , S, , D, ,
+  b->Args({2, 1,  1,   3,  32,224,224, 3,3, 1,1,1,1, 2,2, 1,1});
+  b->Args({2, 1, 32,   1,   1,112,112, 3,3, 1,1,1,1, 1,1, 1,1});
+  b->Args({2, 1, 96,   1,   1,112,112, 3,3, 1,1,1,1, 2,2, 1,1});
+  b->Args({2, 1,144,   1,   1, 56, 56, 3,3, 1,1,1,1, 1,1, 1,1});
+  b->Args({2, 1,144,   1,   1, 56, 56, 3,3, 1,1,1,1, 2,2, 1,1});
+  b->Args({2, 1,192,   1,   1, 28, 28, 3,3, 1,1,1,1, 1,1, 1,1});
+  b->Args({2, 1,384,   1,   1, 14, 14, 3,3, 1,1,1,1, 1,1, 1,1});
+  b->Args({2, 1,576,   1,   1, 14, 14, 3,3, 1,1,1,1, 1,1, 1,1});
+  b->Args({2, 1,960,   1,   1,  7,  7, 3,3, 1,1,1,1, 1,1, 1,1});
+}
+
+BENCHMARK_CAPTURE(SCONV_NCHW, MobileNetV2, "")->Apply(MobileNetV2)->UseRealTime();
+
 static void General_Conv2d(benchmark::internal::Benchmark* b) {
   b->ArgNames(ArgNamesForConv(2));
   ArgsProduct(
@@ -106,6 +106,11 @@ static void GemmSizeProducts(benchmark::internal::Benchmark* b) {
   ArgsProduct(b, {{63, 255, 1023}, {63, 255, 1023}, {63, 255, 1023}});
 }
 
+static void GemmSizeSmall(benchmark::internal::Benchmark* b) {
+  b->ArgNames(sgemm_bench_arg_names);
+  ArgsProduct(b, {{1, 4, 7, 16}, {16, 33, 64, 256}, {16, 64, 256}});
+}
+
 BENCHMARK_CAPTURE(SGEMM, NORMAL_NoTrans, false, false, false)->Apply(GemmSizeProducts)->UseRealTime();
 BENCHMARK_CAPTURE(SGEMM, NORMAL_TransA, false, true, false)->Apply(GemmSizeProducts)->UseRealTime();
 BENCHMARK_CAPTURE(SGEMM, NORMAL_TransB, false, false, true)->Apply(GemmSizeProducts)->UseRealTime();
@@ -118,3 +123,8 @@ BENCHMARK_CAPTURE(SGEMM, GEMV_ABTrans, false, true, true)->Apply(GemmSizeWithOne
 
 BENCHMARK_CAPTURE(SGEMM, PACKB_NoTransA, true, false, false)->Apply(GemmSizeProducts)->UseRealTime();
 BENCHMARK_CAPTURE(SGEMM, PACKB_TransA, true, true, false)->Apply(GemmSizeProducts)->UseRealTime();
+
+BENCHMARK_CAPTURE(SGEMM, SMALL_NoTrans, false, false, false)->Apply(GemmSizeSmall)->UseRealTime();
+BENCHMARK_CAPTURE(SGEMM, SMALL_TransA, false, true, false)->Apply(GemmSizeSmall)->UseRealTime();
+BENCHMARK_CAPTURE(SGEMM, SMALL_TransB, false, false, true)->Apply(GemmSizeSmall)->UseRealTime();
+BENCHMARK_CAPTURE(SGEMM, SMALL_PACKB_NoTransA, true, false, false)->Apply(GemmSizeSmall)->UseRealTime();
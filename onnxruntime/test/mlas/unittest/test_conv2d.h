@@ -5,6 +5,8 @@
 
 #include "test_util.h"
 
+#include <cmath>
+
 template <bool Threaded>
 class MlasConv2DTest : public MlasTestBase {
  protected:
@@ -60,6 +62,8 @@ class MlasConv2DTest : public MlasTestBase {
                     0.0f,
                     threadpool_);
 
+    ApproximateOutput = (Parameters.Algorithm == MlasConvAlgorithmWinograd);
+
     MlasConv(&Parameters,
              Input,
              Filter,
@@ -157,13 +161,20 @@ class MlasConv2DTest : public MlasTestBase {
 
   MLAS_THREADPOOL* threadpool_;
 
+  //
+  // Set when the convolution used an algorithm that rounds differently than
+  // the reference convolution, such as the Winograd algorithm.
+  //
+
+  bool ApproximateOutput;
+
  public:
   static const char* GetTestSuiteName() {
     static const std::string suite_name(Threaded ? "Conv2d_Threaded" : "Conv2d_SingleThread");
     return suite_name.c_str();
   }
 
-  MlasConv2DTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+  MlasConv2DTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr), ApproximateOutput(false) {}
 
   void Test(
       size_t BatchCount,
@@ -215,6 +226,8 @@ class MlasConv2DTest : public MlasTestBase {
     float* Output = BufferOutput.GetBuffer(OutputElements);
     float* OutputReference = BufferOutputReference.GetBuffer(OutputElements);
 
+    ApproximateOutput = false;
+
     MlasConv2D(BatchCount,
                GroupCount,
                InputChannels,
@@ -246,6 +259,37 @@ class MlasConv2DTest : public MlasTestBase {
                     Bias,
                     OutputReference);
 
+    if (ApproximateOutput) {
+      float MaximumValue = 1.0f;
+
+      for (size_t i = 0; i < OutputElements; i++) {
+        MaximumValue = std::max(MaximumValue, std::fabs(OutputReference[i]));
+      }
+
+      const float Tolerance = MaximumValue * 1e-5f;
+      size_t MismatchCount = 0;
+
+      for (size_t i = 0; i < OutputElements; i++) {
+        if (!(std::fabs(Output[i] - OutputReference[i]) <= Tolerance)) {
+          MismatchCount++;
+        }
+      }
+
+      ASSERT_EQ(MismatchCount, size_t(0))
+          << "B" << BatchCount << "/"
+          << "G" << GroupCount << "/"
+          << "Cpg" << InputChannels << "/"
+          << "Fpg" << FilterCount << "/"
+          << "H" << InputHeight << "/"
+          << "W" << InputWidth << "/"
+          << "KH" << KernelHeight << "/"
+          << "KW" << KernelWidth << "/"
+          << "Pad" << PaddingLeftHeight << "," << PaddingLeftWidth << "," << PaddingRightHeight << "," << PaddingRightWidth << "/"
+          << "Dilation" << DilationHeight << "," << DilationWidth << "/"
+          << "Stride" << StrideHeight << "," << StrideWidth;
+      return;
+    }
+
     ASSERT_EQ(memcmp(Output, OutputReference, OutputElements * sizeof(float)), 0)
         << "B" << BatchCount << "/"
         << "G" << GroupCount << "/"
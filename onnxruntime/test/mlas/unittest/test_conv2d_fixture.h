@@ -140,6 +140,10 @@ class Conv2dShortExecuteTest : public MlasTestFixture<Conv2dTester> {
       test_registered += RegisterSingleTest(1, 16, 1, i, i, 1, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
       test_registered += RegisterSingleTest(1, 16, 1, i, i, 1, 3, 3, 1, 1, 1, 1, 1, 1, 2, 2);
     }
+    test_registered += RegisterSingleTest(2, 1, 24, 61, 75, 40, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+    test_registered += RegisterSingleTest(1, 1, 32, 58, 61, 64, 3, 3, 0, 1, 1, 0, 1, 1, 1, 1);
+    test_registered += RegisterSingleTest(2, 24, 1, 19, 33, 1, 5, 5, 2, 2, 2, 2, 1, 1, 1, 1);
+    test_registered += RegisterSingleTest(1, 24, 1, 19, 33, 1, 3, 3, 2, 2, 2, 2, 2, 2, 2, 1);
     return test_registered;
   }
 
@@ -0,0 +1,190 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Threaded>
+class MlasFlashAttentionTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferQuery;
+  MatrixGuardBuffer<float> BufferKey;
+  MatrixGuardBuffer<float> BufferValue;
+  MatrixGuardBuffer<float> BufferKeyBias;
+  MatrixGuardBuffer<float> BufferWorking;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  static constexpr float CausalMaskValue = -10000.0f;
+
+  void Test(size_t B, size_t N, size_t S, size_t T, size_t H, size_t Hv, bool Causal, bool HasKeyBias) {
+    float* Query = BufferQuery.GetBuffer(B * N * S * H);
+    float* Key = BufferKey.GetBuffer(B * N * T * H);
+    float* Value = BufferValue.GetBuffer(B * N * T * Hv);
+    float* KeyBias = HasKeyBias ? BufferKeyBias.GetBuffer(B * T) : nullptr;
+    float* Output = BufferOutput.GetBuffer(B * S * N * Hv);
+    float* OutputReference = BufferOutputReference.GetBuffer(B * S * N * Hv);
+
+    std::default_random_engine generator(static_cast<unsigned>(B * N * S * T * H));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    for (size_t i = 0; i < B * N * S * H; i++) {
+      Query[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < B * N * T * H; i++) {
+      Key[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < B * N * T * Hv; i++) {
+      Value[i] = distribution(generator);
+    }
+
+    //
+    // Mask the leading keys of odd batches, the trailing keys of even batches,
+    // and every key of the last batch. The query rows that see no unmasked key
+    // also attend to the keys hidden by the causal mask.
+    //
+
+    if (KeyBias != nullptr) {
+      for (size_t b = 0; b < B; b++) {
+        for (size_t t = 0; t < T; t++) {
+          bool Masked;
+          if (b + 1 == B && B > 1) {
+            Masked = true;
+          } else if (b % 2 == 1) {
+            Masked = t < T / 2;
+          } else {
+            Masked = t >= T - (b * 7) % T;
+          }
+          KeyBias[b * T + t] = Masked ? -10000.0f : 0.0f;
+        }
+      }
+    }
+
+    const float Scale = 1.0f / std::sqrt(float(H));
+
+    MLAS_FLASH_ATTENTION_PARAMETERS Parameters;
+    size_t WorkingBufferSize;
+
+    MlasFlashAttentionPrepare(&Parameters, B, N, S, T, H, Hv, Scale, Causal, CausalMaskValue,
+                              &WorkingBufferSize, threadpool_);
+
+    float* WorkingBuffer = BufferWorking.GetBuffer(WorkingBufferSize);
+
+    MlasFlashAttention(&Parameters, Query, Key, Value, KeyBias, WorkingBuffer, Output, threadpool_);
+
+    std::vector<bool> MaskedRows(B * S * N);
+
+    ReferenceAttention(B, N, S, T, H, Hv, Scale, Causal, Query, Key, Value, KeyBias, OutputReference, MaskedRows);
+
+    constexpr float AbsoluteTolerance = 1e-5f;
+    constexpr float RelativeTolerance = 1e-4f;
+
+    //
+    // The scores of a row without any unmasked key are close to the mask
+    // value, where a float has a precision of about 1e-3.
+    //
+
+    constexpr float MaskedRowTolerance = 5e-3f;
+
+    for (size_t i = 0; i < B * S * N * Hv; i++) {
+      float diff = std::fabs(Output[i] - OutputReference[i]);
+      ASSERT_TRUE(diff <= AbsoluteTolerance || diff <= std::fabs(OutputReference[i]) * RelativeTolerance ||
+                  (MaskedRows[i / Hv] && diff <= MaskedRowTolerance))
+          << "B/N/S/T/H/Hv " << B << "/" << N << "/" << S << "/" << T << "/" << H << "/" << Hv
+          << " Causal:" << Causal << " KeyBias:" << HasKeyBias << " index " << i
+          << ", got: " << Output[i] << ", expecting: " << OutputReference[i];
+    }
+  }
+
+  void ReferenceAttention(size_t B, size_t N, size_t S, size_t T, size_t H, size_t Hv, float Scale, bool Causal,
+                          const float* Query, const float* Key, const float* Value, const float* KeyBias,
+                          float* Output, std::vector<bool>& MaskedRows) {
+    std::vector<double> Scores(T);
+
+    for (size_t b = 0; b < B; b++) {
+      for (size_t n = 0; n < N; n++) {
+        const float* q = Query + (b * N + n) * S * H;
+        const float* k = Key + (b * N + n) * T * H;
+        const float* v = Value + (b * N + n) * T * Hv;
+
+        for (size_t s = 0; s < S; s++) {
+          double Maximum = std::numeric_limits<double>::lowest();
+
+          for (size_t t = 0; t < T; t++) {
+            double Score = 0.0;
+            if (Causal && t > s + T - S) {
+              Score = CausalMaskValue;
+            } else {
+              for (size_t h = 0; h < H; h++) {
+                Score += double(q[s * H + h]) * double(k[t * H + h]);
+              }
+              Score *= Scale;
+            }
+            if (KeyBias != nullptr) {
+              Score += KeyBias[b * T + t];
+            }
+            Scores[t] = Score;
+            Maximum = std::max(Maximum, Score);
+          }
+
+          double Sum = 0.0;
+
+          for (size_t t = 0; t < T; t++) {
+            Scores[t] = std::exp(Scores[t] - Maximum);
+            Sum += Scores[t];
+          }
+
+          MaskedRows[(b * S + s) * N + n] = Maximum < CausalMaskValue / 2;
+
+          float* o = Output + ((b * S + s) * N + n) * Hv;
+
+          for (size_t h = 0; h < Hv; h++) {
+            double Accumulation = 0.0;
+            for (size_t t = 0; t < T; t++) {
+              Accumulation += Scores[t] * double(v[t * Hv + h]);
+            }
+            o[h] = float(Accumulation / Sum);
+          }
+        }
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "FlashAttention_Threaded" : "FlashAttention_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasFlashAttentionTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (int mask = 0; mask < 4; mask++) {
+      const bool Causal = (mask & 1) != 0;
+      const bool HasKeyBias = (mask & 2) != 0;
+
+      Test(1, 1, 1, 1, 8, 8, Causal, HasKeyBias);
+      Test(1, 2, 1, 37, 16, 16, Causal, HasKeyBias);
+      Test(2, 3, 5, 5, 32, 24, Causal, HasKeyBias);
+      Test(2, 2, 7, 19, 64, 64, Causal, HasKeyBias);
+      Test(1, 2, 100, 100, 64, 64, Causal, HasKeyBias);
+      Test(3, 2, 130, 300, 32, 48, Causal, HasKeyBias);
+      Test(1, 1, 257, 600, 16, 16, Causal, HasKeyBias);
+      Test(3, 1, 300, 300, 32, 32, Causal, HasKeyBias);
+    }
+  }
+};
+
+template <> MlasFlashAttentionTest<false>* MlasTestFixture<MlasFlashAttentionTest<false>>::mlas_tester(nullptr);
+template <> MlasFlashAttentionTest<true>* MlasTestFixture<MlasFlashAttentionTest<true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
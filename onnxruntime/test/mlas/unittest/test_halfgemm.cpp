@@ -0,0 +1,153 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Packed, bool Threaded>
+class MlasHalfGemmTest : public MlasTestBase {
+ private:
+  MLAS_THREADPOOL* threadpool_;
+
+  MatrixGuardBuffer<MLAS_FP16> BufferA;
+  MatrixGuardBuffer<MLAS_FP16> BufferB;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MatrixGuardBuffer<MLAS_FP16> BufferC;
+  MatrixGuardBuffer<float> BufferFloat;
+  MatrixGuardBuffer<float> BufferCReference;
+
+  void FillHalf(MLAS_FP16* Buffer, size_t Count, int Seed) {
+    float* Values = BufferFloat.GetBuffer(Count);
+    for (size_t i = 0; i < Count; i++) {
+      Values[i] = float(int((i * 7 + Seed) % 17) - 8) / 16.0f;
+    }
+    MlasConvertFloatToHalfBuffer(Values, Buffer, Count);
+  }
+
+  float HalfToFloat(MLAS_FP16 Value) {
+    float f;
+    MlasConvertHalfToFloatBuffer(&Value, &f, 1);
+    return f;
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name = std::string("HalfGemm") +
+                                          (Packed ? "_Packed" : "_NoPack") +
+                                          (Threaded ? "_Threaded" : "_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasHalfGemmTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void Test(bool trans_a, bool trans_b, size_t M, size_t N, size_t K, size_t BatchSize, float alpha, float beta) {
+    if (Packed && (N == 0 || K == 0)) {
+      return;
+    }
+
+    MLAS_FP16* A = BufferA.GetBuffer(M * K * BatchSize);
+    MLAS_FP16* B = BufferB.GetBuffer(K * N * BatchSize);
+    MLAS_FP16* C = BufferC.GetBuffer(M * N * BatchSize);
+    float* CReference = BufferCReference.GetBuffer(M * N * BatchSize);
+
+    FillHalf(A, M * K * BatchSize, 1);
+    FillHalf(B, K * N * BatchSize, 5);
+    FillHalf(C, M * N * BatchSize, 3);
+
+    const size_t lda = trans_a ? M : K;
+    const size_t ldb = trans_b ? K : N;
+    const size_t PackedBSize = Packed ? MlasHalfGemmPackBSize(N, K) : 0;
+    uint8_t* PackedB = Packed ? BufferBPacked.GetBuffer(PackedBSize * BatchSize, true) : nullptr;
+
+    std::vector<MLAS_HALF_GEMM_DATA_PARAMS> data(BatchSize);
+    for (size_t i = 0; i < BatchSize; i++) {
+      data[i].A = A + M * K * i;
+      data[i].lda = lda;
+      if (Packed) {
+        MlasHalfGemmPackB(trans_b ? CblasTrans : CblasNoTrans, N, K, B + K * N * i, ldb, PackedB + PackedBSize * i);
+        data[i].B = PackedB + PackedBSize * i;
+        data[i].BIsPacked = true;
+      } else {
+        data[i].B = B + K * N * i;
+      }
+      data[i].ldb = ldb;
+      data[i].C = C + M * N * i;
+      data[i].ldc = N;
+      data[i].alpha = alpha;
+      data[i].beta = beta;
+    }
+
+    for (size_t batch = 0; batch < BatchSize; batch++) {
+      const MLAS_FP16* a = A + M * K * batch;
+      const MLAS_FP16* b = B + K * N * batch;
+      const MLAS_FP16* c = C + M * N * batch;
+      for (size_t m = 0; m < M; m++) {
+        for (size_t n = 0; n < N; n++) {
+          float sum = 0.0f;
+          for (size_t k = 0; k < K; k++) {
+            const float av = HalfToFloat(trans_a ? a[k * lda + m] : a[m * lda + k]);
+            const float bv = HalfToFloat(trans_b ? b[n * ldb + k] : b[k * ldb + n]);
+            sum += av * bv;
+          }
+          float reference = alpha * sum;
+          if (beta != 0.0f) {
+            reference += beta * HalfToFloat(c[m * N + n]);
+          }
+          CReference[(batch * M + m) * N + n] = reference;
+        }
+      }
+    }
+
+    MlasHalfGemmBatch(trans_a ? CblasTrans : CblasNoTrans, trans_b ? CblasTrans : CblasNoTrans,
+                      M, N, K, data.data(), BatchSize, threadpool_);
+
+    // Native half precision arithmetic rounds the partial sums, the other
+    // kernels only round the output.
+    const float tolerance = MlasFp16AccelerationSupported() ? 0.02f : 0.002f;
+
+    for (size_t f = 0; f < M * N * BatchSize; f++) {
+      const float output = HalfToFloat(C[f]);
+      ASSERT_NEAR(output, CReference[f], tolerance * std::max(1.0f, std::abs(CReference[f])))
+          << " @" << f << " " << (trans_a ? "TransA" : "A") << "/" << (trans_b ? "TransB" : "B")
+          << "/M" << M << "xN" << N << "xK" << K << "/Batch" << BatchSize
+          << "/Alpha" << alpha << "/Beta" << beta;
+    }
+  }
+
+  void Test(size_t M, size_t N, size_t K, size_t BatchSize, float alpha, float beta) {
+    Test(false, false, M, N, K, BatchSize, alpha, beta);
+    Test(false, true, M, N, K, BatchSize, alpha, beta);
+    Test(true, false, M, N, K, BatchSize, alpha, beta);
+    Test(true, true, M, N, K, BatchSize, alpha, beta);
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t b = 1; b < 32; b++) {
+      Test(b, b, b, 1, 1.0f, 0.0f);
+    }
+    for (size_t b = 1; b < 24; b += 5) {
+      Test(b, 3 * b + 1, 2 * b + 3, 3, 0.5f, 1.0f);
+    }
+    Test(1, 4096, 256, 1, 1.0f, 0.0f);
+    Test(37, 129, 300, 2, -1.0f, 0.25f);
+    Test(160, 160, 160, 1, 1.0f, 0.0f);
+    Test(25, 47, 0, 1, 1.0f, 0.5f);
+  }
+};
+
+template <> MlasHalfGemmTest<false, false>* MlasTestFixture<MlasHalfGemmTest<false, false>>::mlas_tester(nullptr);
+template <> MlasHalfGemmTest<false, true>* MlasTestFixture<MlasHalfGemmTest<false, true>>::mlas_tester(nullptr);
+template <> MlasHalfGemmTest<true, false>* MlasTestFixture<MlasHalfGemmTest<true, false>>::mlas_tester(nullptr);
+template <> MlasHalfGemmTest<true, true>* MlasTestFixture<MlasHalfGemmTest<true, true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasHalfGemmTest<false, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasHalfGemmTest<true, false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasHalfGemmTest<false, true>>::RegisterShortExecute();
+      count += MlasDirectShortExecuteTests<MlasHalfGemmTest<true, true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
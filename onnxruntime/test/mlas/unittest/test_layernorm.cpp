@@ -0,0 +1,170 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Threaded>
+class MlasLayerNormTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferSkip;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferScale;
+  MatrixGuardBuffer<float> BufferShift;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MatrixGuardBuffer<float> BufferMean;
+  MatrixGuardBuffer<float> BufferInvStdDev;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(size_t N, size_t D, bool HasSkip, bool HasBias, bool HasShift, bool Simplified) {
+    float* Input = BufferInput.GetBuffer(N * D);
+    float* Skip = HasSkip ? BufferSkip.GetBuffer(N * D) : nullptr;
+    float* Bias = HasBias ? BufferBias.GetBuffer(D) : nullptr;
+    float* Scale = BufferScale.GetBuffer(D);
+    float* Shift = HasShift ? BufferShift.GetBuffer(D) : nullptr;
+    float* Output = BufferOutput.GetBuffer(N * D);
+    float* OutputReference = BufferOutputReference.GetBuffer(N * D);
+    float* Mean = BufferMean.GetBuffer(N);
+    float* InvStdDev = BufferInvStdDev.GetBuffer(N);
+
+    std::default_random_engine generator(static_cast<unsigned>(N * D));
+    std::uniform_real_distribution<float> distribution(-2.0f, 3.0f);
+
+    for (size_t nd = 0; nd < N * D; nd++) {
+      Input[nd] = distribution(generator);
+      if (Skip != nullptr) {
+        Skip[nd] = distribution(generator);
+      }
+    }
+
+    for (size_t d = 0; d < D; d++) {
+      Scale[d] = distribution(generator);
+      if (Bias != nullptr) {
+        Bias[d] = distribution(generator);
+      }
+      if (Shift != nullptr) {
+        Shift[d] = distribution(generator);
+      }
+    }
+
+    constexpr float Epsilon = 1e-5f;
+
+    MlasLayerNorm(Input, Skip, Bias, Scale, Shift, Output, Mean, InvStdDev, N, D, Epsilon, Simplified, threadpool_);
+
+    constexpr float AbsoluteTolerance = 1e-4f;
+    constexpr float RelativeTolerance = 1e-4f;
+
+    for (size_t n = 0; n < N; n++) {
+      double ReferenceMean;
+      double ReferenceInvStdDev;
+
+      ReferenceLayerNorm(Input + n * D, Skip ? Skip + n * D : nullptr, Bias, Scale, Shift,
+                         OutputReference + n * D, D, Epsilon, Simplified, ReferenceMean, ReferenceInvStdDev);
+
+      ASSERT_NEAR(Mean[n], ReferenceMean, AbsoluteTolerance + std::fabs(ReferenceMean) * RelativeTolerance)
+          << "mean " << N << "/" << D << " row " << n;
+      ASSERT_NEAR(InvStdDev[n], ReferenceInvStdDev, AbsoluteTolerance + std::fabs(ReferenceInvStdDev) * RelativeTolerance)
+          << "inv std dev " << N << "/" << D << " row " << n;
+    }
+
+    for (size_t nd = 0; nd < N * D; nd++) {
+      float diff = std::fabs(Output[nd] - OutputReference[nd]);
+      ASSERT_TRUE(diff <= AbsoluteTolerance || diff <= std::fabs(OutputReference[nd]) * RelativeTolerance)
+          << "Skip:" << HasSkip << " Bias:" << HasBias << " Shift:" << HasShift << " Simplified:" << Simplified
+          << " difference " << N << "/" << D << ", got: " << Output[nd] << ", expecting: " << OutputReference[nd];
+    }
+
+    //
+    // Repeat the operation in place.
+    //
+
+    if (Skip == nullptr) {
+      std::copy_n(Input, N * D, Output);
+      MlasLayerNorm(Output, Skip, Bias, Scale, Shift, Output, nullptr, nullptr, N, D, Epsilon, Simplified, threadpool_);
+
+      for (size_t nd = 0; nd < N * D; nd++) {
+        float diff = std::fabs(Output[nd] - OutputReference[nd]);
+        ASSERT_TRUE(diff <= AbsoluteTolerance || diff <= std::fabs(OutputReference[nd]) * RelativeTolerance)
+            << "in place difference " << N << "/" << D << ", got: " << Output[nd] << ", expecting: " << OutputReference[nd];
+      }
+    }
+  }
+
+  void ReferenceLayerNorm(const float* Input, const float* Skip, const float* Bias, const float* Scale,
+                          const float* Shift, float* Output, size_t D, float Epsilon, bool Simplified,
+                          double& Mean, double& InvStdDev) {
+    std::vector<double> Values(D);
+
+    double Sum = 0.0;
+
+    for (size_t d = 0; d < D; d++) {
+      double Value = Input[d];
+      if (Skip != nullptr) {
+        Value += Skip[d];
+      }
+      if (Bias != nullptr) {
+        Value += Bias[d];
+      }
+      Values[d] = Value;
+      Sum += Value;
+    }
+
+    Mean = Simplified ? 0.0 : Sum / D;
+
+    double Variance = 0.0;
+
+    for (size_t d = 0; d < D; d++) {
+      Variance += (Values[d] - Mean) * (Values[d] - Mean);
+    }
+
+    InvStdDev = 1.0 / std::sqrt(Variance / D + Epsilon);
+
+    for (size_t d = 0; d < D; d++) {
+      double Value = (Values[d] - Mean) * InvStdDev * Scale[d];
+      if (Shift != nullptr) {
+        Value += Shift[d];
+      }
+      Output[d] = float(Value);
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "LayerNorm_Threaded" : "LayerNorm_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasLayerNormTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) { }
+
+  void ExecuteShort(void) override {
+    for (size_t d = 1; d < 160; d++) {
+      Test(1, d, false, false, true, false);
+    }
+
+    for (int mask = 0; mask < 16; mask++) {
+      const bool HasSkip = (mask & 1) != 0;
+      const bool HasBias = (mask & 2) != 0;
+      const bool HasShift = (mask & 4) != 0;
+      const bool Simplified = (mask & 8) != 0;
+
+      Test(3, 768, HasSkip, HasBias, HasShift, Simplified);
+      Test(7, 101, HasSkip, HasBias, HasShift, Simplified);
+      Test(33, 1024, HasSkip, HasBias, HasShift, Simplified);
+    }
+  }
+};
+
+template <> MlasLayerNormTest<false>* MlasTestFixture<MlasLayerNormTest<false>>::mlas_tester(nullptr);
+template <> MlasLayerNormTest<true>* MlasTestFixture<MlasLayerNormTest<true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasLayerNormTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasLayerNormTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
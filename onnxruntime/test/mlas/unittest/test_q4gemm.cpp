@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <MLAS_BLK_QUANT_TYPE QType, bool Threaded>
+class MlasQ4GemmTest : public MlasTestBase {
+ private:
+  MLAS_THREADPOOL* threadpool_;
+
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferBUnpacked;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name = std::string("Q4GemmFP") +
+                                          "_QType" + std::to_string(int(QType)) +
+                                          (Threaded ? "_Threaded" : "_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasQ4GemmTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void Test(size_t M, size_t N, size_t K, size_t BatchSize, bool with_bias) {
+    float* A = BufferA.GetBuffer(M * K * BatchSize);
+    float* B = BufferB.GetBuffer(K * N);
+    float* BUnpacked = BufferBUnpacked.GetBuffer(K * N);
+    const float* Bias = with_bias ? BufferBias.GetBuffer(N) : nullptr;
+    float* C = BufferC.GetBuffer(M * N * BatchSize);
+    float* CReference = BufferCReference.GetBuffer(M * N * BatchSize);
+
+    for (size_t i = 0; i < M * K * BatchSize; i++) {
+      A[i] = float(int((i * 7 + 1) % 17) - 8) / 8.0f;
+    }
+    for (size_t i = 0; i < K * N; i++) {
+      B[i] = float(int((i * 13 + 5) % 1021) - 510) / 510.0f;
+    }
+
+    const size_t PackedBSize = MlasQ4GemmPackBSize(QType, N, K);
+    ASSERT_GT(PackedBSize, size_t(0));
+    uint8_t* PackedB = BufferBPacked.GetBuffer(PackedBSize, true);
+
+    MlasQ4GemmPackB(QType, PackedB, B, N, K, N);
+    MlasQ4GemmUnPackB(QType, BUnpacked, PackedB, N, K, N);
+
+    // The range of a block is at most [-1, 1] and split in 15 steps, the
+    // dequantized weights are within a step of the originals.
+    for (size_t k = 0; k < K; k++) {
+      for (size_t n = 0; n < N; n++) {
+        ASSERT_NEAR(BUnpacked[k * N + n], B[k * N + n], 2.0f / 15.0f)
+            << " @k" << k << "n" << n;
+      }
+    }
+
+    std::vector<MLAS_Q4GEMM_DATA_PARAMS> data(BatchSize);
+    for (size_t i = 0; i < BatchSize; i++) {
+      data[i].A = A + M * K * i;
+      data[i].lda = K;
+      data[i].B = PackedB;
+      data[i].Bias = Bias;
+      data[i].C = C + M * N * i;
+      data[i].ldc = N;
+
+      for (size_t m = 0; m < M; m++) {
+        for (size_t n = 0; n < N; n++) {
+          float sum = Bias != nullptr ? Bias[n] : 0.0f;
+          for (size_t k = 0; k < K; k++) {
+            sum += A[M * K * i + m * K + k] * BUnpacked[k * N + n];
+          }
+          CReference[M * N * i + m * N + n] = sum;
+        }
+      }
+    }
+
+    MlasQ4GemmBatch(QType, M, N, K, data.data(), BatchSize, threadpool_);
+
+    for (size_t f = 0; f < M * N * BatchSize; f++) {
+      ASSERT_NEAR(C[f], CReference[f], 1e-4f * std::max(1.0f, std::abs(CReference[f])))
+          << " @" << f << " M" << M << "xN" << N << "xK" << K << "/Batch" << BatchSize
+          << (with_bias ? "/Bias" : "");
+    }
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t b = 1; b < 20; b++) {
+      Test(b, b, b, 1, false);
+    }
+    Test(1, 1, 257, 1, true);
+    Test(1, 4096, 256, 1, false);
+    Test(1, 67, 1024, 2, true);
+    Test(5, 33, 160, 3, true);
+    Test(37, 129, 300, 1, false);
+    Test(64, 96, 512, 1, true);
+  }
+};
+
+template <> MlasQ4GemmTest<BlkQ4Sym32, false>* MlasTestFixture<MlasQ4GemmTest<BlkQ4Sym32, false>>::mlas_tester(nullptr);
+template <> MlasQ4GemmTest<BlkQ4Zp32, false>* MlasTestFixture<MlasQ4GemmTest<BlkQ4Zp32, false>>::mlas_tester(nullptr);
+template <> MlasQ4GemmTest<BlkQ4Sym128, false>* MlasTestFixture<MlasQ4GemmTest<BlkQ4Sym128, false>>::mlas_tester(nullptr);
+template <> MlasQ4GemmTest<BlkQ4Zp128, false>* MlasTestFixture<MlasQ4GemmTest<BlkQ4Zp128, false>>::mlas_tester(nullptr);
+template <> MlasQ4GemmTest<BlkQ4Sym32, true>* MlasTestFixture<MlasQ4GemmTest<BlkQ4Sym32, true>>::mlas_tester(nullptr);
+template <> MlasQ4GemmTest<BlkQ4Zp128, true>* MlasTestFixture<MlasQ4GemmTest<BlkQ4Zp128, true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasQ4GemmTest<BlkQ4Sym32, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasQ4GemmTest<BlkQ4Zp32, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasQ4GemmTest<BlkQ4Sym128, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasQ4GemmTest<BlkQ4Zp128, false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasQ4GemmTest<BlkQ4Sym32, true>>::RegisterShortExecute();
+      count += MlasDirectShortExecuteTests<MlasQ4GemmTest<BlkQ4Zp128, true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
@@ -0,0 +1,150 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+#include <cstring>
+
+template <bool Threaded>
+class MlasSBGemmTest : public MlasTestBase {
+ private:
+  MLAS_THREADPOOL* threadpool_;
+
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+
+  static float RoundToBFloat16(float Value) {
+    uint32_t bits;
+    std::memcpy(&bits, &Value, sizeof(float));
+    bits += 0x7FFF + ((bits >> 16) & 1);
+    bits &= 0xFFFF0000;
+    std::memcpy(&Value, &bits, sizeof(float));
+    return Value;
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name = std::string("SBGemm") +
+                                          (Threaded ? "_Threaded" : "_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasSBGemmTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void Test(bool trans_a, bool trans_b, size_t M, size_t N, size_t K, size_t BatchSize, float alpha, float beta,
+            bool shared_b = false) {
+    if (N == 0 || K == 0) {
+      return;
+    }
+
+    float* A = BufferA.GetBuffer(M * K * BatchSize);
+    float* B = BufferB.GetBuffer(K * N * BatchSize);
+    float* C = BufferC.GetBuffer(M * N * BatchSize);
+    float* CReference = BufferCReference.GetBuffer(M * N * BatchSize);
+
+    // Matrix B uses values that are not exact in bfloat16 to check the
+    // rounding done while packing.
+    for (size_t i = 0; i < M * K * BatchSize; i++) {
+      A[i] = float(int((i * 7 + 1) % 17) - 8) / 16.0f;
+    }
+    for (size_t i = 0; i < K * N * BatchSize; i++) {
+      B[i] = float(int((i * 13 + 5) % 1021) - 510) / 511.0f;
+    }
+    for (size_t i = 0; i < M * N * BatchSize; i++) {
+      C[i] = float(int((i * 7 + 3) % 17) - 8) / 16.0f;
+    }
+
+    const size_t lda = trans_a ? M : K;
+    const size_t ldb = trans_b ? K : N;
+    const size_t PackedBSize = MlasSBGemmPackBSize(N, K);
+    uint8_t* PackedB = BufferBPacked.GetBuffer(PackedBSize * BatchSize, true);
+
+    // MatMul packs a constant matrix B once and uses it for every matrix of
+    // the batch.
+    const size_t BStride = shared_b ? 0 : K * N;
+    const size_t PackedBStride = shared_b ? 0 : PackedBSize;
+
+    std::vector<MLAS_SBGEMM_DATA_PARAMS> data(BatchSize);
+    for (size_t i = 0; i < BatchSize; i++) {
+      if (i == 0 || !shared_b) {
+        MlasSBGemmPackB(trans_b ? CblasTrans : CblasNoTrans, N, K, B + BStride * i, ldb, PackedB + PackedBStride * i);
+      }
+      data[i].A = A + M * K * i;
+      data[i].lda = lda;
+      data[i].B = PackedB + PackedBStride * i;
+      data[i].C = C + M * N * i;
+      data[i].ldc = N;
+      data[i].alpha = alpha;
+      data[i].beta = beta;
+    }
+
+    for (size_t batch = 0; batch < BatchSize; batch++) {
+      const float* a = A + M * K * batch;
+      const float* b = B + BStride * batch;
+      const float* c = C + M * N * batch;
+      for (size_t m = 0; m < M; m++) {
+        for (size_t n = 0; n < N; n++) {
+          float sum = 0.0f;
+          for (size_t k = 0; k < K; k++) {
+            const float av = trans_a ? a[k * lda + m] : a[m * lda + k];
+            const float bv = RoundToBFloat16(trans_b ? b[n * ldb + k] : b[k * ldb + n]);
+            sum += av * bv;
+          }
+          CReference[(batch * M + m) * N + n] = alpha * sum + beta * c[m * N + n];
+        }
+      }
+    }
+
+    MlasSBGemmBatch(trans_a ? CblasTrans : CblasNoTrans, M, N, K, data.data(), BatchSize, threadpool_);
+
+    for (size_t f = 0; f < M * N * BatchSize; f++) {
+      ASSERT_NEAR(C[f], CReference[f], 1e-4f * std::max(1.0f, std::abs(CReference[f])))
+          << " @" << f << " " << (trans_a ? "TransA" : "A") << "/" << (trans_b ? "TransB" : "B")
+          << "/M" << M << "xN" << N << "xK" << K << "/Batch" << BatchSize
+          << "/Alpha" << alpha << "/Beta" << beta << (shared_b ? "/SharedB" : "");
+    }
+  }
+
+  void Test(size_t M, size_t N, size_t K, size_t BatchSize, float alpha, float beta) {
+    Test(false, false, M, N, K, BatchSize, alpha, beta);
+    Test(false, true, M, N, K, BatchSize, alpha, beta);
+    Test(true, false, M, N, K, BatchSize, alpha, beta);
+    Test(true, true, M, N, K, BatchSize, alpha, beta);
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t b = 1; b < 40; b++) {
+      Test(b, b, b, 1, 1.0f, 0.0f);
+    }
+    for (size_t b = 1; b < 24; b += 5) {
+      Test(b, 3 * b + 1, 2 * b + 3, 3, 0.5f, 1.0f);
+    }
+    Test(1, 4096, 256, 1, 1.0f, 0.0f);
+    Test(37, 129, 300, 2, -1.0f, 0.25f);
+    Test(160, 160, 160, 1, 1.0f, 0.0f);
+    for (bool trans_a : {false, true}) {
+      for (bool trans_b : {false, true}) {
+        Test(trans_a, trans_b, 2, 3, 4, 2, 2.0f, 0.0f, true);
+        Test(trans_a, trans_b, 7, 50, 33, 4, 1.0f, 0.0f, true);
+      }
+    }
+    Test(64, 1000, 513, 1, 2.0f, 0.0f);
+  }
+};
+
+template <> MlasSBGemmTest<false>* MlasTestFixture<MlasSBGemmTest<false>>::mlas_tester(nullptr);
+template <> MlasSBGemmTest<true>* MlasTestFixture<MlasSBGemmTest<true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSBGemmTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasSBGemmTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Threaded>
+class MlasSgemmThreadPartitionTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferPackedB;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(size_t BatchSize, size_t M, size_t N, size_t K, bool PackB) {
+    const float* A = BufferA.GetBuffer(BatchSize * M * K);
+    const float* B = BufferB.GetBuffer(K * N);
+    float* C = BufferC.GetBuffer(BatchSize * M * N);
+    float* CReference = BufferCReference.GetBuffer(BatchSize * M * N);
+
+    const float* PackedB = nullptr;
+
+    if (PackB) {
+      float* Buffer = BufferPackedB.GetBuffer((MlasGemmPackBSize(N, K) + sizeof(float) - 1) / sizeof(float), true);
+      MlasGemmPackB(CblasNoTrans, N, K, B, N, Buffer);
+      PackedB = Buffer;
+    }
+
+    std::vector<MLAS_SGEMM_DATA_PARAMS> Data(BatchSize);
+    std::vector<MLAS_SGEMM_DATA_PARAMS> DataReference(BatchSize);
+
+    for (size_t i = 0; i < BatchSize; i++) {
+      Data[i].A = A + i * M * K;
+      Data[i].lda = K;
+      Data[i].B = PackB ? PackedB : B;
+      Data[i].ldb = N;
+      Data[i].BIsPacked = PackB;
+      Data[i].C = C + i * M * N;
+      Data[i].ldc = N;
+      Data[i].alpha = 0.5f;
+      Data[i].beta = 0.0f;
+      DataReference[i] = Data[i];
+      DataReference[i].C = CReference + i * M * N;
+    }
+
+    //
+    // The partition only selects which thread computes each element, so every
+    // partition must produce the same results as a single segment.
+    //
+
+    MLAS_SGEMM_THREAD_PARTITION Single;
+    MlasGemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, DataReference.data(), BatchSize, Single, threadpool_);
+
+    static const ptrdiff_t Counts[] = {1, 2, 3, 4, 7, 1000};
+
+    for (ptrdiff_t ThreadCountM : Counts) {
+      for (ptrdiff_t ThreadCountN : Counts) {
+        MLAS_SGEMM_THREAD_PARTITION Partition;
+        Partition.ThreadCountM = ThreadCountM;
+        Partition.ThreadCountN = ThreadCountN;
+
+        std::fill_n(C, BatchSize * M * N, -1.0f);
+        MlasGemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, Data.data(), BatchSize, Partition, threadpool_);
+
+        ASSERT_EQ(memcmp(C, CReference, BatchSize * M * N * sizeof(float)), 0)
+            << "B" << BatchSize << "/M" << M << "/N" << N << "/K" << K << "/Packed" << PackB
+            << " partition " << ThreadCountM << "x" << ThreadCountN;
+      }
+    }
+
+    //
+    // A recorded partition is returned for the shape and used by MlasGemmBatch.
+    //
+
+    MLAS_SGEMM_THREAD_PARTITION Recorded;
+    Recorded.ThreadCountM = 3;
+    Recorded.ThreadCountN = 2;
+
+    MlasGemmClearThreadPartitions();
+    MlasGemmSetThreadPartition(CblasNoTrans, CblasNoTrans, M, N, K, BatchSize, Recorded, threadpool_);
+
+    MLAS_SGEMM_THREAD_PARTITION Partition;
+    ASSERT_TRUE(MlasGemmGetThreadPartition(CblasNoTrans, CblasNoTrans, M, N, K, BatchSize, &Partition, threadpool_));
+    ASSERT_EQ(Partition.ThreadCountM, Recorded.ThreadCountM);
+    ASSERT_EQ(Partition.ThreadCountN, Recorded.ThreadCountN);
+    ASSERT_FALSE(MlasGemmGetThreadPartition(CblasNoTrans, CblasTrans, M, N, K, BatchSize, &Partition, threadpool_));
+    ASSERT_FALSE(MlasGemmGetThreadPartition(CblasNoTrans, CblasNoTrans, M, N, K + 1, BatchSize, &Partition, threadpool_));
+
+    std::fill_n(C, BatchSize * M * N, -1.0f);
+    MlasGemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, Data.data(), BatchSize, threadpool_);
+
+    for (size_t i = 0; i < BatchSize * M * N; i++) {
+      ASSERT_NEAR(C[i], CReference[i], std::fabs(CReference[i]) * 1e-5f + 1e-4f)
+          << "recorded partition B" << BatchSize << "/M" << M << "/N" << N << "/K" << K << "/Packed" << PackB;
+    }
+
+    MlasGemmClearThreadPartitions();
+    ASSERT_FALSE(MlasGemmGetThreadPartition(CblasNoTrans, CblasNoTrans, M, N, K, BatchSize, &Partition, threadpool_));
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "SgemmThreadPartition_Threaded" : "SgemmThreadPartition_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasSgemmThreadPartitionTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    Test(1, 1, 256, 64, false);
+    Test(1, 5, 67, 33, false);
+    Test(1, 64, 64, 64, true);
+    Test(3, 37, 129, 17, false);
+    Test(2, 128, 48, 96, true);
+  }
+};
+
+template <> MlasSgemmThreadPartitionTest<false>* MlasTestFixture<MlasSgemmThreadPartitionTest<false>>::mlas_tester(nullptr);
+template <> MlasSgemmThreadPartitionTest<true>* MlasTestFixture<MlasSgemmThreadPartitionTest<true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSgemmThreadPartitionTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasSgemmThreadPartitionTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
@@ -0,0 +1,147 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+//
+// Tests the shapes handled by the small matrix SGEMM kernels: M up to 16 and
+// N and K up to 256, with every transpose of A and B. A transposed B is
+// handled by the small matrix kernels for M up to 8 and K from 128.
+//
+
+template <bool Threaded>
+class MlasSgemmSmallTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  static void ReferenceGemm(CBLAS_TRANSPOSE TransA, CBLAS_TRANSPOSE TransB,
+                            size_t M, size_t N, size_t K, float alpha,
+                            const float* A, size_t lda, const float* B, size_t ldb,
+                            float beta, float* C, size_t ldc) {
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        double sum = 0.0;
+        for (size_t k = 0; k < K; k++) {
+          const float a = (TransA == CblasNoTrans) ? A[m * lda + k] : A[k * lda + m];
+          const float b = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+          sum += double(a) * double(b);
+        }
+        float& c = C[m * ldc + n];
+        c = (beta == 0.0f) ? float(sum) * alpha : float(sum) * alpha + c * beta;
+      }
+    }
+  }
+
+  void Test(CBLAS_TRANSPOSE TransA, CBLAS_TRANSPOSE TransB, size_t M, size_t N, size_t K,
+            size_t BatchSize, float alpha, float beta) {
+    const size_t lda = (TransA == CblasNoTrans) ? K : M;
+    const size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+    const float* A = BufferA.GetBuffer(M * K * BatchSize);
+    const float* B = BufferB.GetBuffer(K * N * BatchSize);
+    float* C = BufferC.GetBuffer(M * N * BatchSize);
+    float* CReference = BufferCReference.GetBuffer(M * N * BatchSize);
+
+    //
+    // Matrix C is ignored when beta is zero, so start it as NaN to check that
+    // it is never read.
+    //
+
+    const float CInitial = (beta == 0.0f) ? std::numeric_limits<float>::quiet_NaN() : -0.5f;
+    std::fill_n(C, M * N * BatchSize, CInitial);
+    std::fill_n(CReference, M * N * BatchSize, -0.5f);
+
+    std::vector<MLAS_SGEMM_DATA_PARAMS> Data(BatchSize);
+
+    for (size_t i = 0; i < BatchSize; i++) {
+      Data[i].A = A + M * K * i;
+      Data[i].lda = lda;
+      Data[i].B = B + K * N * i;
+      Data[i].ldb = ldb;
+      Data[i].C = C + M * N * i;
+      Data[i].ldc = N;
+      Data[i].alpha = alpha;
+      Data[i].beta = beta;
+    }
+
+    MlasGemmBatch(TransA, TransB, M, N, K, Data.data(), BatchSize, threadpool_);
+
+    for (size_t i = 0; i < BatchSize; i++) {
+      ReferenceGemm(TransA, TransB, M, N, K, alpha, A + M * K * i, lda, B + K * N * i, ldb,
+                    beta, CReference + M * N * i, N);
+    }
+
+    for (size_t f = 0; f < M * N * BatchSize; f++) {
+      ASSERT_EQ(C[f], CReference[f])
+          << " Diff @[" << f << "] " << C[f] << "/" << CReference[f]
+          << " TransA=" << TransA << " TransB=" << TransB
+          << " M=" << M << " N=" << N << " K=" << K << " Batch=" << BatchSize
+          << " alpha=" << alpha << " beta=" << beta;
+    }
+  }
+
+  void Test(size_t M, size_t N, size_t K, size_t BatchSize, float alpha, float beta) {
+    for (CBLAS_TRANSPOSE TransA : {CblasNoTrans, CblasTrans}) {
+      for (CBLAS_TRANSPOSE TransB : {CblasNoTrans, CblasTrans}) {
+        Test(TransA, TransB, M, N, K, BatchSize, alpha, beta);
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "SgemmSmall_Threaded" : "SgemmSmall_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasSgemmSmallTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    static const size_t Ms[] = {1, 2, 3, 4, 5, 6, 7, 11, 16};
+    static const size_t Ns[] = {1, 3, 4, 8, 15, 16, 17, 31, 33, 64, 100, 256};
+    static const size_t Ks[] = {1, 3, 7, 8, 9, 16, 31, 64, 127, 128, 129, 255, 256};
+
+    for (size_t M : Ms) {
+      for (size_t N : Ns) {
+        for (size_t K : Ks) {
+          Test(M, N, K, 1, 1.0f, 0.0f);
+        }
+      }
+    }
+
+    for (size_t M : {1, 4, 13}) {
+      for (size_t N : {5, 16, 48, 129}) {
+        for (size_t K : {2, 17, 130, 200}) {
+          Test(M, N, K, 1, 0.5f, 1.5f);
+          Test(M, N, K, 3, -1.0f, 0.0f);
+        }
+      }
+    }
+
+    //
+    // Batches above the single thread complexity are split by whole
+    // matrices.
+    //
+
+    Test(16, 256, 256, 8, 1.0f, 0.0f);
+    Test(7, 130, 96, 40, 0.5f, 1.0f);
+  }
+};
+
+template <> MlasSgemmSmallTest<false>* MlasTestFixture<MlasSgemmSmallTest<false>>::mlas_tester(nullptr);
+template <> MlasSgemmSmallTest<true>* MlasTestFixture<MlasSgemmSmallTest<true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSgemmSmallTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasSgemmSmallTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
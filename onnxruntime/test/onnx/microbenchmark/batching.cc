@@ -0,0 +1,243 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <core/graph/model.h>
+#include <core/platform/path_lib.h>
+#include <core/session/onnxruntime_c_api.h>
+#include <core/session/onnxruntime_session_options_config_keys.h>
+#include <core/session/ort_env.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+extern OrtEnv* env;
+extern const OrtApi* g_ort;
+
+namespace {
+
+constexpr int kRequestsPerClient = 16;
+
+#define ORT_BREAK_ON_ERROR(expr)                                \
+  do {                                                          \
+    OrtStatus* onnx_status = (expr);                            \
+    if (onnx_status != NULL) {                                  \
+      state.SkipWithError(g_ort->GetErrorMessage(onnx_status)); \
+      g_ort->ReleaseStatus(onnx_status);                        \
+      return;                                                   \
+    }                                                           \
+  } while (0);
+
+// Model zoo models often have a fixed batch size of 1, which disables dynamic batching.
+// Makes the first dimension of the graph inputs and outputs symbolic and drops the intermediate shapes.
+std::string LoadWithSymbolicBatch(const ORTCHAR_T* model_path) {
+  ONNX_NAMESPACE::ModelProto model_proto;
+  ORT_THROW_IF_ERROR(onnxruntime::Model::Load(model_path, model_proto));
+  auto& graph = *model_proto.mutable_graph();
+
+  std::unordered_set<std::string> initializer_names;
+  for (const auto& initializer : graph.initializer()) {
+    initializer_names.insert(initializer.name());
+  }
+
+  auto make_batch_symbolic = [](ONNX_NAMESPACE::ValueInfoProto& value_info) {
+    auto* shape = value_info.mutable_type()->mutable_tensor_type()->mutable_shape();
+    if (shape->dim_size() > 0) {
+      shape->mutable_dim(0)->set_dim_param("batch");
+    }
+  };
+
+  for (auto& input : *graph.mutable_input()) {
+    if (initializer_names.count(input.name()) == 0) {
+      make_batch_symbolic(input);
+    }
+  }
+
+  for (auto& output : *graph.mutable_output()) {
+    make_batch_symbolic(output);
+  }
+
+  graph.clear_value_info();
+
+  std::string model_bytes;
+  model_proto.SerializeToString(&model_bytes);
+  return model_bytes;
+}
+
+size_t ElementSize(ONNXTensorElementDataType type) {
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+      return 4;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+// Single sample requests from 'clients' threads against a session with the given max batch size.
+// Reports the throughput and the p50/p99 latency of the requests.
+// Args: clients, max batch size (0 disables batching)
+void RunBatching(benchmark::State& state, const ORTCHAR_T* model_path, int64_t symbolic_dim_value) {
+  const int clients = static_cast<int>(state.range(0));
+  const std::string max_batch_size = std::to_string(state.range(1));
+
+  OrtSessionOptions* session_options;
+  ORT_BREAK_ON_ERROR(g_ort->CreateSessionOptions(&session_options));
+  ORT_BREAK_ON_ERROR(g_ort->AddSessionConfigEntry(session_options, kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize,
+                                                  max_batch_size.c_str()));
+  ORT_BREAK_ON_ERROR(g_ort->AddSessionConfigEntry(session_options,
+                                                  kOrtSessionOptionsConfigDynamicBatchingMaxWaitMicros, "2000"));
+
+  std::string model_bytes;
+  try {
+    model_bytes = LoadWithSymbolicBatch(model_path);
+  } catch (const std::exception& ex) {
+    state.SkipWithError(ex.what());
+    return;
+  }
+
+  OrtSession* session;
+  ORT_BREAK_ON_ERROR(g_ort->CreateSessionFromArray(env, model_bytes.data(), model_bytes.size(), session_options,
+                                                   &session));
+
+  OrtAllocator* allocator;
+  ORT_BREAK_ON_ERROR(g_ort->GetAllocatorWithDefaultOptions(&allocator));
+
+  // a batch of one sample for every input, with symbolic dimensions other than the batch set to symbolic_dim_value
+  size_t num_inputs;
+  ORT_BREAK_ON_ERROR(g_ort->SessionGetInputCount(session, &num_inputs));
+  std::vector<std::string> input_names;
+  std::vector<OrtValue*> inputs;
+  for (size_t i = 0; i < num_inputs; ++i) {
+    char* name;
+    ORT_BREAK_ON_ERROR(g_ort->SessionGetInputName(session, i, allocator, &name));
+    input_names.emplace_back(name);
+    ORT_BREAK_ON_ERROR(g_ort->AllocatorFree(allocator, name));
+
+    OrtTypeInfo* type_info;
+    ORT_BREAK_ON_ERROR(g_ort->SessionGetInputTypeInfo(session, i, &type_info));
+    const OrtTensorTypeAndShapeInfo* tensor_info;
+    ORT_BREAK_ON_ERROR(g_ort->CastTypeInfoToTensorInfo(type_info, &tensor_info));
+    ONNXTensorElementDataType type;
+    ORT_BREAK_ON_ERROR(g_ort->GetTensorElementType(tensor_info, &type));
+    size_t num_dims;
+    ORT_BREAK_ON_ERROR(g_ort->GetDimensionsCount(tensor_info, &num_dims));
+    std::vector<int64_t> dims(num_dims);
+    ORT_BREAK_ON_ERROR(g_ort->GetDimensions(tensor_info, dims.data(), num_dims));
+    g_ort->ReleaseTypeInfo(type_info);
+
+    if (ElementSize(type) == 0 || dims.empty()) {
+      state.SkipWithError("Unsupported model input");
+      return;
+    }
+
+    dims[0] = 1;
+    int64_t num_elements = 1;
+    for (auto& dim : dims) {
+      if (dim < 0) dim = symbolic_dim_value;
+      num_elements *= dim;
+    }
+
+    OrtValue* input;
+    ORT_BREAK_ON_ERROR(g_ort->CreateTensorAsOrtValue(allocator, dims.data(), dims.size(), type, &input));
+    void* data;
+    ORT_BREAK_ON_ERROR(g_ort->GetTensorMutableData(input, &data));
+    std::memset(data, 0, static_cast<size_t>(num_elements) * ElementSize(type));
+    inputs.push_back(input);
+  }
+
+  size_t num_outputs;
+  ORT_BREAK_ON_ERROR(g_ort->SessionGetOutputCount(session, &num_outputs));
+  std::vector<std::string> output_names;
+  for (size_t i = 0; i < num_outputs; ++i) {
+    char* name;
+    ORT_BREAK_ON_ERROR(g_ort->SessionGetOutputName(session, i, allocator, &name));
+    output_names.emplace_back(name);
+    ORT_BREAK_ON_ERROR(g_ort->AllocatorFree(allocator, name));
+  }
+
+  std::vector<const char*> input_name_ptrs;
+  std::vector<const char*> output_name_ptrs;
+  for (const auto& name : input_names) input_name_ptrs.push_back(name.c_str());
+  for (const auto& name : output_names) output_name_ptrs.push_back(name.c_str());
+
+  std::vector<double> latencies_ms;
+  for (auto _ : state) {
+    std::vector<std::vector<double>> client_latencies(clients);
+    std::vector<std::thread> threads;
+    for (int c = 0; c < clients; ++c) {
+      threads.emplace_back([&, c]() {
+        for (int r = 0; r < kRequestsPerClient; ++r) {
+          std::vector<OrtValue*> outputs(num_outputs, nullptr);
+          const auto start = std::chrono::steady_clock::now();
+          OrtStatus* status = g_ort->Run(session, nullptr, input_name_ptrs.data(), inputs.data(), inputs.size(),
+                                         output_name_ptrs.data(), output_name_ptrs.size(), outputs.data());
+          const auto end = std::chrono::steady_clock::now();
+          if (status != nullptr) {
+            g_ort->ReleaseStatus(status);
+            continue;
+          }
+
+          client_latencies[c].push_back(std::chrono::duration<double, std::milli>(end - start).count());
+          for (auto* output : outputs) {
+            g_ort->ReleaseValue(output);
+          }
+        }
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    for (const auto& latencies : client_latencies) {
+      latencies_ms.insert(latencies_ms.end(), latencies.begin(), latencies.end());
+    }
+  }
+
+  if (latencies_ms.size() != static_cast<size_t>(state.iterations()) * clients * kRequestsPerClient) {
+    state.SkipWithError("Run failed");
+  } else {
+    std::sort(latencies_ms.begin(), latencies_ms.end());
+    state.counters["p50_ms"] = latencies_ms[latencies_ms.size() / 2];
+    state.counters["p99_ms"] = latencies_ms[latencies_ms.size() * 99 / 100];
+    state.SetItemsProcessed(static_cast<int64_t>(latencies_ms.size()));
+  }
+
+  for (auto* input : inputs) {
+    g_ort->ReleaseValue(input);
+  }
+
+  g_ort->ReleaseSession(session);
+  g_ort->ReleaseSessionOptions(session_options);
+}
+
+void BatchingArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"clients", "max_batch"});
+  for (int64_t clients : {1, 8, 32}) {
+    for (int64_t max_batch : {0, 8, 32}) {
+      b->Args({clients, max_batch});
+    }
+  }
+}
+
+}  // namespace
+
+static void BM_DynamicBatchingBert(benchmark::State& state) {
+  // sequence length 64
+  RunBatching(state, ORT_TSTR("testdata/bert_toy_optimized.onnx"), 64);
+}
+
+static void BM_DynamicBatchingResNet50(benchmark::State& state) {
+  RunBatching(state, ORT_TSTR("../models/opset8/test_resnet50/model.onnx"), 1);
+}
+
+BENCHMARK(BM_DynamicBatchingBert)->Apply(BatchingArgs)->UseRealTime()->Unit(benchmark::TimeUnit::kMillisecond);
+BENCHMARK(BM_DynamicBatchingResNet50)->Apply(BatchingArgs)->UseRealTime()->Unit(benchmark::TimeUnit::kMillisecond);
@@ -0,0 +1,164 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <core/graph/model.h>
+#include <core/session/onnxruntime_c_api.h>
+#include <core/session/ort_env.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+extern OrtEnv* env;
+extern const OrtApi* g_ort;
+
+namespace {
+
+#define ORT_BREAK_ON_ERROR(expr)                                \
+  do {                                                          \
+    OrtStatus* onnx_status = (expr);                            \
+    if (onnx_status != NULL) {                                  \
+      state.SkipWithError(g_ort->GetErrorMessage(onnx_status)); \
+      g_ort->ReleaseStatus(onnx_status);                        \
+      return;                                                   \
+    }                                                           \
+  } while (0);
+
+// A model with a single binary op_type node computing C from float inputs A and B.
+std::string MakeBinaryModel(const std::string& op_type, const std::vector<int64_t>& a_shape,
+                            const std::vector<int64_t>& b_shape, ONNX_NAMESPACE::TensorProto_DataType output_type) {
+  ONNX_NAMESPACE::ModelProto model;
+  model.set_ir_version(ONNX_NAMESPACE::IR_VERSION);
+  model.add_opset_import()->set_version(14);
+
+  auto* graph = model.mutable_graph();
+  graph->set_name("broadcast");
+  auto* node = graph->add_node();
+  node->set_op_type(op_type);
+  node->add_input("A");
+  node->add_input("B");
+  node->add_output("C");
+
+  auto add_value_info = [](ONNX_NAMESPACE::ValueInfoProto& value_info, const std::string& name,
+                           ONNX_NAMESPACE::TensorProto_DataType type) {
+    value_info.set_name(name);
+    value_info.mutable_type()->mutable_tensor_type()->set_elem_type(type);
+    return value_info.mutable_type()->mutable_tensor_type()->mutable_shape();
+  };
+
+  auto* a = add_value_info(*graph->add_input(), "A", ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  for (int64_t dim : a_shape) a->add_dim()->set_dim_value(dim);
+  auto* b = add_value_info(*graph->add_input(), "B", ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  for (int64_t dim : b_shape) b->add_dim()->set_dim_value(dim);
+  add_value_info(*graph->add_output(), "C", output_type);
+
+  std::string model_bytes;
+  model.SerializeToString(&model_bytes);
+  return model_bytes;
+}
+
+// Runs op_type over A and B, which have the same rank, in a session with state.range(0) intra-op threads.
+void RunBroadcast(benchmark::State& state, const std::string& op_type, const std::vector<int64_t>& a_shape,
+                  const std::vector<int64_t>& b_shape,
+                  ONNX_NAMESPACE::TensorProto_DataType output_type = ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+  OrtSessionOptions* session_options;
+  ORT_BREAK_ON_ERROR(g_ort->CreateSessionOptions(&session_options));
+  ORT_BREAK_ON_ERROR(g_ort->SetIntraOpNumThreads(session_options, static_cast<int>(state.range(0))));
+
+  const std::string model_bytes = MakeBinaryModel(op_type, a_shape, b_shape, output_type);
+  OrtSession* session;
+  ORT_BREAK_ON_ERROR(g_ort->CreateSessionFromArray(env, model_bytes.data(), model_bytes.size(), session_options,
+                                                   &session));
+
+  OrtAllocator* allocator;
+  ORT_BREAK_ON_ERROR(g_ort->GetAllocatorWithDefaultOptions(&allocator));
+
+  // inputs of equal rank, so the output dimensions are the larger of the input dimensions
+  int64_t output_size = 1;
+  for (size_t i = 0; i < a_shape.size(); ++i) {
+    output_size *= std::max(a_shape[i], b_shape[i]);
+  }
+
+  std::vector<OrtValue*> inputs;
+  for (const auto* shape : {&a_shape, &b_shape}) {
+    OrtValue* input;
+    ORT_BREAK_ON_ERROR(g_ort->CreateTensorAsOrtValue(allocator, shape->data(), shape->size(),
+                                                     ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, &input));
+    int64_t num_elements = 1;
+    for (int64_t dim : *shape) num_elements *= dim;
+    float* data;
+    ORT_BREAK_ON_ERROR(g_ort->GetTensorMutableData(input, reinterpret_cast<void**>(&data)));
+    for (int64_t i = 0; i < num_elements; ++i) {
+      data[i] = static_cast<float>(i % 17) * 0.25f;
+    }
+    inputs.push_back(input);
+  }
+
+  const char* input_names[] = {"A", "B"};
+  const char* output_names[] = {"C"};
+  for (auto _ : state) {
+    OrtValue* output = nullptr;
+    ORT_BREAK_ON_ERROR(g_ort->Run(session, nullptr, input_names, inputs.data(), inputs.size(), output_names, 1,
+                                  &output));
+    g_ort->ReleaseValue(output);
+  }
+
+  state.SetItemsProcessed(state.iterations() * output_size);
+
+  for (auto* input : inputs) {
+    g_ort->ReleaseValue(input);
+  }
+
+  g_ort->ReleaseSession(session);
+  g_ort->ReleaseSessionOptions(session_options);
+}
+
+void BroadcastArgs(benchmark::internal::Benchmark* b) {
+  b->ArgName("threads");
+  for (int64_t threads : {1, 4}) {
+    b->Arg(threads);
+  }
+}
+
+}  // namespace
+
+// Per channel bias of a feature map: the bias is repeated over spans of H*W elements.
+static void BM_BroadcastAddChannel(benchmark::State& state) {
+  RunBroadcast(state, "Add", {8, 64, 56, 56}, {8, 64, 1, 1});
+}
+
+// Per channel scale of a small feature map: spans of 7*7 elements.
+static void BM_BroadcastMulChannelSmallSpatial(benchmark::State& state) {
+  RunBroadcast(state, "Mul", {32, 512, 7, 7}, {1, 512, 1, 1});
+}
+
+// Middle axis broadcast, e.g. an attention mask shared by the heads: spans of 4*4 elements.
+static void BM_BroadcastAddMiddleAxis(benchmark::State& state) {
+  RunBroadcast(state, "Add", {64, 256, 4, 4}, {64, 1, 4, 4});
+}
+
+// Bias vector over the rows of a matrix: spans of one row.
+static void BM_BroadcastAddTrailing(benchmark::State& state) {
+  RunBroadcast(state, "Add", {1, 768}, {512, 768});
+}
+
+// Per row statistic, e.g. the mean in layer normalization: one element repeated over spans of one row.
+static void BM_BroadcastSubLastDim(benchmark::State& state) {
+  RunBroadcast(state, "Sub", {512, 768}, {512, 1});
+}
+
+// Outer comparison of a long and a short vector: spans of 16 elements in both inputs.
+static void BM_BroadcastLessOuter(benchmark::State& state) {
+  RunBroadcast(state, "Less", {16384, 1}, {1, 16}, ONNX_NAMESPACE::TensorProto_DataType_BOOL);
+}
+
+BENCHMARK(BM_BroadcastAddChannel)->Apply(BroadcastArgs)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
+BENCHMARK(BM_BroadcastMulChannelSmallSpatial)
+    ->Apply(BroadcastArgs)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
+BENCHMARK(BM_BroadcastAddMiddleAxis)->Apply(BroadcastArgs)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
+BENCHMARK(BM_BroadcastAddTrailing)->Apply(BroadcastArgs)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
+BENCHMARK(BM_BroadcastSubLastDim)->Apply(BroadcastArgs)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
+BENCHMARK(BM_BroadcastLessOuter)->Apply(BroadcastArgs)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
@@ -0,0 +1,239 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <core/graph/model.h>
+#include <core/session/onnxruntime_c_api.h>
+#include <core/session/onnxruntime_session_options_config_keys.h>
+#include <core/session/ort_env.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace onnxruntime;
+
+extern OrtEnv* env;
+extern const OrtApi* g_ort;
+
+namespace {
+
+constexpr int64_t kHiddenSize = 64;
+
+// Wide graph in the style of a multi-head ensemble: 'width' independent branches of 'depth' MatMul+Relu layers
+// reading the same input, concatenated at the end.
+std::string CreateWideModel(int64_t width, int64_t depth) {
+  auto logger = env->GetLoggingManager()->CreateLogger("executor_benchmark");
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 13}};
+  Model model("wide_model", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version, {}, *logger);
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kHiddenSize);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kHiddenSize);
+
+  std::default_random_engine generator(0);
+  std::uniform_real_distribution<float> distribution(-0.1f, 0.1f);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+  std::vector<NodeArg*> branch_outputs;
+  for (int64_t b = 0; b < width; ++b) {
+    NodeArg* current = &input_arg;
+    for (int64_t d = 0; d < depth; ++d) {
+      const std::string prefix = "b" + std::to_string(b) + "_d" + std::to_string(d);
+
+      ONNX_NAMESPACE::TensorProto weight;
+      weight.set_name(prefix + "_W");
+      weight.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+      weight.add_dims(kHiddenSize);
+      weight.add_dims(kHiddenSize);
+      for (int64_t i = 0; i < kHiddenSize * kHiddenSize; ++i) {
+        weight.add_float_data(distribution(generator));
+      }
+      graph.AddInitializedTensor(weight);
+
+      auto& weight_arg = graph.GetOrCreateNodeArg(prefix + "_W", &float_tensor);
+      auto& matmul_out = graph.GetOrCreateNodeArg(prefix + "_matmul", &float_tensor);
+      auto& relu_out = graph.GetOrCreateNodeArg(prefix + "_relu", &float_tensor);
+      graph.AddNode(prefix + "_matmul", "MatMul", "", {current, &weight_arg}, {&matmul_out});
+      graph.AddNode(prefix + "_relu", "Relu", "", {&matmul_out}, {&relu_out});
+      current = &relu_out;
+    }
+
+    branch_outputs.push_back(current);
+  }
+
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", nullptr);
+  ONNX_NAMESPACE::AttributeProto axis;
+  axis.set_name("axis");
+  axis.set_type(ONNX_NAMESPACE::AttributeProto::INT);
+  axis.set_i(1);
+  NodeAttributes attributes{{"axis", axis}};
+  graph.AddNode("concat", "Concat", "", branch_outputs, {&output_arg}, &attributes);
+  ORT_THROW_IF_ERROR(graph.Resolve());
+
+  std::string model_bytes;
+  model.ToProto().SerializeToString(&model_bytes);
+  return model_bytes;
+}
+
+// Chain of 'depth' Relu nodes on a tiny tensor, so the run time is dominated by the per-node executor overhead.
+std::string CreateChainModel(int64_t depth) {
+  auto logger = env->GetLoggingManager()->CreateLogger("executor_benchmark");
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 13}};
+  Model model("chain_model", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version, {}, *logger);
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+
+  NodeArg* current = &graph.GetOrCreateNodeArg("X", &float_tensor);
+  for (int64_t d = 0; d < depth; ++d) {
+    const std::string name = d + 1 == depth ? "Y" : "relu_" + std::to_string(d);
+    auto& output_arg = graph.GetOrCreateNodeArg(name, &float_tensor);
+    graph.AddNode(name, "Relu", "", {current}, {&output_arg});
+    current = &output_arg;
+  }
+  ORT_THROW_IF_ERROR(graph.Resolve());
+
+  std::string model_bytes;
+  model.ToProto().SerializeToString(&model_bytes);
+  return model_bytes;
+}
+
+#define ORT_BREAK_ON_ERROR(expr)                                \
+  do {                                                          \
+    OrtStatus* onnx_status = (expr);                            \
+    if (onnx_status != NULL) {                                  \
+      state.SkipWithError(g_ort->GetErrorMessage(onnx_status)); \
+      g_ort->ReleaseStatus(onnx_status);                        \
+      return;                                                   \
+    }                                                           \
+  } while (0);
+
+// Args: width, depth, inter-op threads
+void RunWideModel(benchmark::State& state, ExecutionMode execution_mode) {
+  const int64_t width = state.range(0);
+  const int64_t depth = state.range(1);
+  const int inter_op_threads = static_cast<int>(state.range(2));
+  const std::string model_bytes = CreateWideModel(width, depth);
+
+  OrtSessionOptions* session_options;
+  ORT_BREAK_ON_ERROR(g_ort->CreateSessionOptions(&session_options));
+  ORT_BREAK_ON_ERROR(g_ort->SetSessionExecutionMode(session_options, execution_mode));
+  ORT_BREAK_ON_ERROR(g_ort->SetInterOpNumThreads(session_options, inter_op_threads));
+  // keep the kernels single threaded so the executors are compared on graph level parallelism
+  ORT_BREAK_ON_ERROR(g_ort->SetIntraOpNumThreads(session_options, 1));
+
+  OrtSession* session;
+  ORT_BREAK_ON_ERROR(g_ort->CreateSessionFromArray(env, model_bytes.data(), model_bytes.size(), session_options,
+                                                   &session));
+
+  OrtMemoryInfo* memory_info;
+  ORT_BREAK_ON_ERROR(g_ort->CreateCpuMemoryInfo(OrtArenaAllocator, OrtMemTypeDefault, &memory_info));
+  std::vector<float> input_data(kHiddenSize * kHiddenSize, 1.0f);
+  const int64_t input_shape[] = {kHiddenSize, kHiddenSize};
+  OrtValue* input;
+  ORT_BREAK_ON_ERROR(g_ort->CreateTensorWithDataAsOrtValue(memory_info, input_data.data(),
+                                                           input_data.size() * sizeof(float), input_shape, 2,
+                                                           ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, &input));
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  for (auto _ : state) {
+    OrtValue* output = nullptr;
+    ORT_BREAK_ON_ERROR(g_ort->Run(session, nullptr, input_names, &input, 1, output_names, 1, &output));
+    g_ort->ReleaseValue(output);
+  }
+
+  g_ort->ReleaseValue(input);
+  g_ort->ReleaseMemoryInfo(memory_info);
+  g_ort->ReleaseSession(session);
+  g_ort->ReleaseSessionOptions(session_options);
+}
+
+// Args: depth
+void RunChainModel(benchmark::State& state, bool use_fast_sequential_executor) {
+  const int64_t depth = state.range(0);
+  const std::string model_bytes = CreateChainModel(depth);
+
+  OrtSessionOptions* session_options;
+  ORT_BREAK_ON_ERROR(g_ort->CreateSessionOptions(&session_options));
+  ORT_BREAK_ON_ERROR(g_ort->SetIntraOpNumThreads(session_options, 1));
+  ORT_BREAK_ON_ERROR(g_ort->AddSessionConfigEntry(session_options, kOrtSessionOptionsConfigUseFastSequentialExecutor,
+                                                  use_fast_sequential_executor ? "1" : "0"));
+
+  OrtSession* session;
+  ORT_BREAK_ON_ERROR(g_ort->CreateSessionFromArray(env, model_bytes.data(), model_bytes.size(), session_options,
+                                                   &session));
+
+  OrtMemoryInfo* memory_info;
+  ORT_BREAK_ON_ERROR(g_ort->CreateCpuMemoryInfo(OrtArenaAllocator, OrtMemTypeDefault, &memory_info));
+  std::vector<float> input_data{-1.0f, 0.0f, 1.0f, 2.0f};
+  const int64_t input_shape[] = {1, 4};
+  OrtValue* input;
+  ORT_BREAK_ON_ERROR(g_ort->CreateTensorWithDataAsOrtValue(memory_info, input_data.data(),
+                                                           input_data.size() * sizeof(float), input_shape, 2,
+                                                           ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, &input));
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  for (auto _ : state) {
+    OrtValue* output = nullptr;
+    ORT_BREAK_ON_ERROR(g_ort->Run(session, nullptr, input_names, &input, 1, output_names, 1, &output));
+    g_ort->ReleaseValue(output);
+  }
+
+  // average time per node, including the fixed cost of the Run call
+  state.counters["per_node"] = benchmark::Counter(static_cast<double>(depth),
+                                                  benchmark::Counter::kIsIterationInvariantRate |
+                                                      benchmark::Counter::kInvert);
+
+  g_ort->ReleaseValue(input);
+  g_ort->ReleaseMemoryInfo(memory_info);
+  g_ort->ReleaseSession(session);
+  g_ort->ReleaseSessionOptions(session_options);
+}
+
+void WideGraphArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"width", "depth", "threads"});
+  for (int64_t width : {8, 32, 128}) {
+    for (int64_t threads : {4, 8}) {
+      b->Args({width, 4, threads});
+    }
+  }
+}
+
+}  // namespace
+
+static void BM_WideGraphSequential(benchmark::State& state) {
+  RunWideModel(state, ORT_SEQUENTIAL);
+}
+
+static void BM_WideGraphParallel(benchmark::State& state) {
+  RunWideModel(state, ORT_PARALLEL);
+}
+
+static void BM_WideGraphWorkStealing(benchmark::State& state) {
+  RunWideModel(state, ORT_PARALLEL_WORK_STEALING);
+}
+
+BENCHMARK(BM_WideGraphSequential)->Apply(WideGraphArgs)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
+BENCHMARK(BM_WideGraphParallel)->Apply(WideGraphArgs)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
+BENCHMARK(BM_WideGraphWorkStealing)->Apply(WideGraphArgs)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
+
+static void BM_NodeOverheadSequential(benchmark::State& state) {
+  RunChainModel(state, false);
+}
+
+static void BM_NodeOverheadFastSequential(benchmark::State& state) {
+  RunChainModel(state, true);
+}
+
+BENCHMARK(BM_NodeOverheadSequential)->ArgName("depth")->Arg(16)->Arg(128)->Unit(benchmark::TimeUnit::kMicrosecond);
+BENCHMARK(BM_NodeOverheadFastSequential)->ArgName("depth")->Arg(16)->Arg(128)->Unit(benchmark::TimeUnit::kMicrosecond);
@@ -36,6 +36,7 @@
 #include "core/optimizer/div_mul_fusion.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/elementwise_fusion.h"
 #include "core/optimizer/embed_layer_norm_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
@@ -6524,5 +6525,153 @@ TEST_F(GraphTransformationTests, GatherToSliceFusion) {
   }
 }
 
+
+TEST_F(GraphTransformationTests, ElementwiseFusion) {
+  // Where(condition, Relu(Sigmoid(x + bias) * y) - 1, x) runs as a single FusedElementwise node.
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* x_arg = builder.MakeInput<float>({2, 3, 64}, -2.0f, 2.0f);
+    auto* y_arg = builder.MakeInput<float>({2, 3, 64}, -2.0f, 2.0f);
+    auto* condition_arg = builder.MakeInputBool({3, 64});
+    auto* bias_arg = builder.MakeInitializer<float>({64}, -1.0f, 1.0f);
+    auto* one_arg = builder.MakeInitializer<float>({}, {1.0f});
+    auto* add_out = builder.MakeIntermediate();
+    auto* sigmoid_out = builder.MakeIntermediate();
+    auto* mul_out = builder.MakeIntermediate();
+    auto* relu_out = builder.MakeIntermediate();
+    auto* sub_out = builder.MakeIntermediate();
+    auto* where_out = builder.MakeOutput();
+
+    builder.AddNode("Add", {x_arg, bias_arg}, {add_out});
+    builder.AddNode("Sigmoid", {add_out}, {sigmoid_out});
+    builder.AddNode("Mul", {sigmoid_out, y_arg}, {mul_out});
+    builder.AddNode("Relu", {mul_out}, {relu_out});
+    builder.AddNode("Sub", {relu_out, one_arg}, {sub_out});
+    builder.AddNode("Where", {condition_arg, sub_out, x_arg}, {where_out});
+  };
+
+  auto check_transformed_graph = [](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 1);
+    EXPECT_EQ(op_to_count["Add"], 0);
+    EXPECT_EQ(op_to_count["Sigmoid"], 0);
+    EXPECT_EQ(op_to_count["Mul"], 0);
+    EXPECT_EQ(op_to_count["Relu"], 0);
+    EXPECT_EQ(op_to_count["Sub"], 0);
+    EXPECT_EQ(op_to_count["Where"], 0);
+  };
+
+  auto add_session_options = [](SessionOptions& session_options) {
+    ASSERT_STATUS_OK(session_options.config_options.AddConfigEntry(kOrtSessionOptionsEnableElementwiseFusion, "1"));
+  };
+
+  TransformerTester(build_test_case, check_transformed_graph, TransformerLevel::Level1, TransformerLevel::Level2, 14,
+                    1e-5, 1e-5, nullptr, add_session_options);
+}
+
+TEST_F(GraphTransformationTests, ElementwiseFusion_StopsAtSharedOutputs) {
+  // The output of the Add has two consumers, so the Add is left in the graph.
+  {
+    auto build_test_case = [](ModelTestBuilder& builder) {
+      auto* x_arg = builder.MakeInput<float>({{4, 16}});
+      auto* y_arg = builder.MakeInput<float>({{4, 16}});
+      auto* add_out = builder.MakeIntermediate();
+      auto* relu_out = builder.MakeIntermediate();
+      auto* mul_out = builder.MakeOutput();
+      auto* sigmoid_out = builder.MakeOutput();
+
+      builder.AddNode("Add", {x_arg, y_arg}, {add_out});
+      builder.AddNode("Relu", {add_out}, {relu_out});
+      builder.AddNode("Mul", {relu_out, y_arg}, {mul_out});
+      builder.AddNode("Sigmoid", {add_out}, {sigmoid_out});
+    };
+
+    auto pre_graph_checker = [](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Add"] == 1);
+      return Status::OK();
+    };
+
+    auto post_graph_checker = [](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.FusedElementwise"] == 1);
+      TEST_RETURN_IF_NOT(op_to_count["Add"] == 1);
+      TEST_RETURN_IF_NOT(op_to_count["Sigmoid"] == 1);
+      TEST_RETURN_IF_NOT(op_to_count["Relu"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["Mul"] == 0);
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<ElementwiseFusion>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2, 1,
+                                          pre_graph_checker, post_graph_checker));
+  }
+
+  // The output of the Relu is a graph output, so only the Mul and the Sub are fused.
+  {
+    auto build_test_case = [](ModelTestBuilder& builder) {
+      auto* x_arg = builder.MakeInput<float>({{4, 16}});
+      auto* y_arg = builder.MakeInput<float>({{4, 16}});
+      auto* relu_out = builder.MakeOutput();
+      auto* mul_out = builder.MakeIntermediate();
+      auto* sub_out = builder.MakeOutput();
+
+      builder.AddNode("Relu", {x_arg}, {relu_out});
+      builder.AddNode("Mul", {relu_out, y_arg}, {mul_out});
+      builder.AddNode("Sub", {mul_out, x_arg}, {sub_out});
+    };
+
+    auto pre_graph_checker = [](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Relu"] == 1);
+      return Status::OK();
+    };
+
+    auto post_graph_checker = [](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.FusedElementwise"] == 1);
+      TEST_RETURN_IF_NOT(op_to_count["Relu"] == 1);
+      TEST_RETURN_IF_NOT(op_to_count["Mul"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["Sub"] == 0);
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<ElementwiseFusion>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2, 1,
+                                          pre_graph_checker, post_graph_checker));
+  }
+
+  // The output of the Add is broadcast by the Mul, so fusing it would compute the Add at the larger shape.
+  {
+    auto build_test_case = [](ModelTestBuilder& builder) {
+      auto* x_arg = builder.MakeInput<float>({{16}});
+      auto* y_arg = builder.MakeInput<float>({{16}});
+      auto* z_arg = builder.MakeInput<float>({{4, 16}});
+      auto* add_out = builder.MakeIntermediate();
+      auto* mul_out = builder.MakeIntermediate();
+      auto* relu_out = builder.MakeOutput();
+
+      builder.AddNode("Add", {x_arg, y_arg}, {add_out});
+      builder.AddNode("Mul", {add_out, z_arg}, {mul_out});
+      builder.AddNode("Relu", {mul_out}, {relu_out});
+    };
+
+    auto pre_graph_checker = [](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Add"] == 1);
+      return Status::OK();
+    };
+
+    auto post_graph_checker = [](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.FusedElementwise"] == 1);
+      TEST_RETURN_IF_NOT(op_to_count["Add"] == 1);
+      TEST_RETURN_IF_NOT(op_to_count["Mul"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["Relu"] == 0);
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<ElementwiseFusion>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2, 1,
+                                          pre_graph_checker, post_graph_checker));
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
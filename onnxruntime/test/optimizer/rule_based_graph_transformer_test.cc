@@ -10,6 +10,7 @@
 #include "core/graph/model.h"
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/graph_transformer_mgr.h"
+#include "core/optimizer/identity_elimination.h"
 #include "dummy_graph_transformer.h"
 #include "test/framework/test_utils.h"
 #include "test/test_environment.h"
@@ -59,6 +60,42 @@ TEST(RuleBasedGraphTransformerTest, TestCompatibleProviders) {
   ASSERT_TRUE(dummy_rule1_ptr->IsRewriteRuleInvoked());
 }
 
+TEST(RuleBasedGraphTransformerTest, TestTargetOpTypesInGraphTransformerManager) {
+  auto model_uri = ORT_TSTR("testdata/transform/fusion/fuse-conv-bn-mul-add-unsqueeze.onnx");
+
+  std::shared_ptr<Model> model;
+  ASSERT_STATUS_OK(Model::Load(model_uri, model, nullptr, DefaultLoggingManager().DefaultLogger()));
+  Graph& graph = model->MainGraph();
+
+  auto conv_transformer = std::make_unique<DummyGraphTransformer>("ConvTransformer",
+                                                                  std::vector<std::string>{"Softmax", "Conv"});
+  const auto* conv_transformer_ptr = conv_transformer.get();
+  auto softmax_transformer = std::make_unique<DummyGraphTransformer>("SoftmaxTransformer",
+                                                                     std::vector<std::string>{"Softmax"});
+  const auto* softmax_transformer_ptr = softmax_transformer.get();
+
+  // A rule based transformer targets the op types of its rules, or all op types if a rule does.
+  auto rule_transformer = std::make_unique<RuleBasedGraphTransformer>("RuleTransformer");
+  ASSERT_STATUS_OK(rule_transformer->Register(std::make_unique<EliminateIdentity>()));
+  ASSERT_EQ(rule_transformer->TargetOpTypes(), std::vector<std::string>{"Identity"});
+  auto any_op_rule_transformer = std::make_unique<RuleBasedGraphTransformer>("AnyOpRuleTransformer");
+  ASSERT_STATUS_OK(any_op_rule_transformer->Register(std::make_unique<EliminateIdentity>()));
+  ASSERT_STATUS_OK(any_op_rule_transformer->Register(std::make_unique<DummyRewriteRule>("DummyRule")));
+  ASSERT_TRUE(any_op_rule_transformer->TargetOpTypes().empty());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::move(conv_transformer), TransformerLevel::Level2));
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::move(softmax_transformer), TransformerLevel::Level2));
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::move(rule_transformer), TransformerLevel::Level2));
+
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2,
+                                                              DefaultLoggingManager().DefaultLogger()));
+
+  // The graph has a Conv node but no Softmax node.
+  ASSERT_TRUE(conv_transformer_ptr->IsTransformerInvoked());
+  ASSERT_FALSE(softmax_transformer_ptr->IsTransformerInvoked());
+}
+
 TEST(RuleBasedGraphTransformerTest, TestSettingStepsInGraphTransformerManager) {
   // steps provided at object construction time
   onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
@@ -454,6 +454,83 @@ TEST(MathOpTest, Add_Broadcast_2x1x1_3x4) {
 #endif
 }
 
+// Middle axis broadcast with a span of 5 elements over several tiles of the output.
+TEST(MathOpTest, Add_Broadcast_MiddleAxis_Tiled) {
+  constexpr int64_t N = 8, C = 130, W = 5;
+  std::vector<float> a(N * C * W);
+  std::vector<float> b(N * W);
+  std::vector<float> c(N * C * W);
+  for (size_t i = 0; i < a.size(); i++) {
+    a[i] = static_cast<float>(i);
+  }
+  for (size_t i = 0; i < b.size(); i++) {
+    b[i] = -0.5f * static_cast<float>(i);
+  }
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t ci = 0; ci < C; ci++) {
+      for (int64_t w = 0; w < W; w++) {
+        c[(n * C + ci) * W + w] = a[(n * C + ci) * W + w] + b[n * W + w];
+      }
+    }
+  }
+
+  OpTester test("Add", 14);
+  test.AddInput<float>("A", {N, C, W}, a);
+  test.AddInput<float>("B", {N, 1, W}, b);
+  test.AddOutput<float>("C", {N, C, W}, c);
+  test.Run();
+}
+
+// Outer product broadcast where both inputs repeat, which is processed per span.
+TEST(MathOpTest, Less_Broadcast_OuterProduct) {
+  constexpr int64_t M = 300, N = 15;
+  std::vector<int32_t> a(M);
+  std::vector<int32_t> b(N);
+  for (int64_t i = 0; i < M; i++) {
+    a[i] = static_cast<int32_t>((i * 37) % N);
+  }
+  for (int64_t j = 0; j < N; j++) {
+    b[j] = static_cast<int32_t>(j);
+  }
+  auto c = std::make_unique<bool[]>(M * N);
+  for (int64_t i = 0; i < M; i++) {
+    for (int64_t j = 0; j < N; j++) {
+      c[i * N + j] = a[i] < b[j];
+    }
+  }
+
+  OpTester test("Less", 13);
+  test.AddInput<int32_t>("A", {M, 1}, a);
+  test.AddInput<int32_t>("B", {1, N}, b);
+  test.AddOutput<bool>("C", {M, N}, c.get(), M * N);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+// Per row comparison where one element of B repeats over each row of A, with a partial last tile.
+TEST(MathOpTest, Less_Broadcast_LastDim_Tiled) {
+  constexpr int64_t M = 700, N = 7;
+  std::vector<int32_t> a(M * N);
+  std::vector<int32_t> b(M);
+  for (int64_t i = 0; i < M * N; i++) {
+    a[i] = static_cast<int32_t>((i * 37) % N);
+  }
+  for (int64_t i = 0; i < M; i++) {
+    b[i] = static_cast<int32_t>(i % N);
+  }
+  auto c = std::make_unique<bool[]>(M * N);
+  for (int64_t i = 0; i < M; i++) {
+    for (int64_t j = 0; j < N; j++) {
+      c[i * N + j] = a[i * N + j] < b[i];
+    }
+  }
+
+  OpTester test("Less", 13);
+  test.AddInput<int32_t>("A", {M, N}, a);
+  test.AddInput<int32_t>("B", {M, 1}, b);
+  test.AddOutput<bool>("C", {M, N}, c.get(), M * N);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 // Validate runtime failure has useful error message when ORT_ENFORCE is used
 TEST(MathOpTest, Add_Invalid_Broadcast) {
   OpTester test("Add");
@@ -184,6 +184,36 @@ TEST(GemmOpTest, GemmBroadcast) {
   TestGemmBroadcast<double>();
 }
 
+TEST(GemmOpTest, GemmBroadcast_Float16_Cpu) {
+  auto run_test = [](bool b_is_initializer) {
+    OpTester test("Gemm", 13);
+
+    test.AddAttribute("transA", (int64_t)1);
+    test.AddAttribute("transB", (int64_t)1);
+    test.AddAttribute("alpha", 0.5f);
+    test.AddAttribute("beta", 2.0f);
+
+    test.AddInput<MLFloat16>("A", {4, 2},
+                             FloatsToMLFloat16s({1.0f, -1.0f,
+                                                 2.0f, -2.0f,
+                                                 3.0f, -3.0f,
+                                                 4.0f, -4.0f}));
+    test.AddInput<MLFloat16>("B", {3, 4}, FloatsToMLFloat16s(std::vector<float>(12, 1.0f)), b_is_initializer);
+    test.AddInput<MLFloat16>("C", {3}, FloatsToMLFloat16s({1.0f, 2.0f, 3.0f}));
+    test.AddOutput<MLFloat16>("Y", {2, 3},
+                              FloatsToMLFloat16s({7.0f, 9.0f, 11.0f,
+                                                  -3.0f, -1.0f, 1.0f}));
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    test.ConfigEps(std::move(execution_providers))
+        .RunWithConfig();
+  };
+
+  run_test(false);
+  run_test(true);
+}
+
 template <typename T>
 static void TestGemmTrans() {
   OpTester test("Gemm");
@@ -759,19 +789,21 @@ TEST(GemmOpTest, SharedPrepackedWeights) {
   test.AddAttribute("alpha", 1.0f);
   test.AddAttribute("beta", 1.0f);
 
-  std::vector<float> b_init_values(12, 1.0f);
+  // MLAS leaves a small B unpacked for its small matrix kernels
+  constexpr int64_t N = 1040;
+  std::vector<float> b_init_values(4 * N, 1.0f);
   test.AddInput<float>("A", {2, 4},
                        {1.0f, 2.0f, 3.0f, 4.0f,
                         -1.0f, -2.0f, -3.0f, -4.0f});
   // B is to be an initializer for triggering pre-packing
-  test.AddInput<float>("B", {4, 3}, b_init_values, true);
-  test.AddInput<float>("C", {2, 3}, std::vector<float>(6, 1.0f));
-  test.AddOutput<float>("Y", {2, 3},
-                        {11.0f, 11.0f, 11.0f,
-                         -9.0f, -9.0f, -9.0f});
+  test.AddInput<float>("B", {4, N}, b_init_values, true);
+  test.AddInput<float>("C", {2, N}, std::vector<float>(2 * N, 1.0f));
+  std::vector<float> y_values(2 * N, 11.0f);
+  std::fill(y_values.begin() + N, y_values.end(), -9.0f);
+  test.AddOutput<float>("Y", {2, N}, y_values);
 
   OrtValue b;
-  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({4, 3}),
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({4, N}),
                        b_init_values.data(), OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator), b);
 
   SessionOptions so;
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "gtest/gtest.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/providers/run_options_config_keys.h"
 #include "test/common/dnnl_op_test_utils.h"
@@ -248,6 +249,133 @@ TEST(MathOpTest, MatMul_Float16) {
 }
 #endif
 
+TEST(MathOpTest, MatMul_Float16_Cpu) {
+  // Batched A with a 2D B, once as a graph input and once as a pre-packed initializer.
+  auto run_test = [](bool b_is_initializer) {
+    OpTester test("MatMul", 13);
+
+    test.AddInput<MLFloat16>("A", {2, 2, 4},
+                             FloatsToMLFloat16s({1.0f, 2.0f, 3.0f, 4.0f,
+                                                 -1.0f, -2.0f, -3.0f, -4.0f,
+                                                 0.5f, 0.5f, 0.5f, 0.5f,
+                                                 -0.25f, 0.0f, 0.25f, 0.5f}));
+    test.AddInput<MLFloat16>("B", {4, 3},
+                             FloatsToMLFloat16s({1.0f, 2.0f, 0.0f,
+                                                 1.0f, 2.0f, 0.0f,
+                                                 1.0f, 2.0f, 1.0f,
+                                                 1.0f, 2.0f, 1.0f}),
+                             b_is_initializer);
+    test.AddOutput<MLFloat16>("Y", {2, 2, 3},
+                              FloatsToMLFloat16s({10.0f, 20.0f, 7.0f,
+                                                  -10.0f, -20.0f, -7.0f,
+                                                  2.0f, 4.0f, 1.0f,
+                                                  0.5f, 1.0f, 0.75f}));
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    test.ConfigEps(std::move(execution_providers))
+        .RunWithConfig();
+  };
+
+  run_test(false);
+  run_test(true);
+}
+
+TEST(MathOpTest, MatMul_Bf16Weights_Cpu) {
+  // The weights are exact in bfloat16, so the packed bfloat16 path must match the float result. Transposed A
+  // and B are covered through FusedMatMul.
+  auto run_test = [](bool transposed) {
+    OpTester test(transposed ? "FusedMatMul" : "MatMul", transposed ? 1 : 13,
+                  transposed ? onnxruntime::kMSDomain : onnxruntime::kOnnxDomain);
+
+    if (transposed) {
+      test.AddAttribute("transA", int64_t{1});
+      test.AddAttribute("transB", int64_t{1});
+      test.AddAttribute("alpha", 2.0f);
+      test.AddInput<float>("A", {2, 4, 2},
+                           {1.0f, -1.0f, 2.0f, -2.0f, 3.0f, -3.0f, 4.0f, -4.0f,
+                            0.5f, -0.25f, 0.5f, 0.0f, 0.5f, 0.25f, 0.5f, 0.5f});
+      test.AddInput<float>("B", {3, 4},
+                           {1.0f, 1.0f, 1.0f, 1.0f,
+                            2.0f, 2.0f, 2.0f, 2.0f,
+                            0.0f, 0.0f, 1.0f, 1.0f},
+                           true);
+      test.AddOutput<float>("Y", {2, 2, 3},
+                            {20.0f, 40.0f, 14.0f,
+                             -20.0f, -40.0f, -14.0f,
+                             4.0f, 8.0f, 2.0f,
+                             1.0f, 2.0f, 1.5f});
+    } else {
+      test.AddInput<float>("A", {2, 2, 4},
+                           {1.0f, 2.0f, 3.0f, 4.0f,
+                            -1.0f, -2.0f, -3.0f, -4.0f,
+                            0.5f, 0.5f, 0.5f, 0.5f,
+                            -0.25f, 0.0f, 0.25f, 0.5f});
+      test.AddInput<float>("B", {4, 3},
+                           {1.0f, 2.0f, 0.0f,
+                            1.0f, 2.0f, 0.0f,
+                            1.0f, 2.0f, 1.0f,
+                            1.0f, 2.0f, 1.0f},
+                           true);
+      test.AddOutput<float>("Y", {2, 2, 3},
+                            {10.0f, 20.0f, 7.0f,
+                             -10.0f, -20.0f, -7.0f,
+                             2.0f, 4.0f, 1.0f,
+                             0.5f, 1.0f, 0.75f});
+    }
+
+    SessionOptions so;
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigMlasGemmBf16Weights, "1"));
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    test.Config(so)
+        .ConfigEps(std::move(execution_providers))
+        .RunWithConfig();
+  };
+
+  run_test(false);
+#if !defined(DISABLE_CONTRIB_OPS)
+  run_test(true);
+#endif
+}
+
+TEST(MathOpTest, MatMul_TuneThreadPartition_Cpu) {
+  // The first run tunes the thread partition of the shape and the second one reuses the recorded partition.
+  // Either must match the reference result.
+  constexpr int64_t M = 64, K = 48, N = 96;
+  std::vector<float> a(M * K), b(K * N), y(M * N, 0.0f);
+  for (int64_t i = 0; i < M * K; i++) {
+    a[i] = static_cast<float>((i % 7) - 3) * 0.5f;
+  }
+  for (int64_t i = 0; i < K * N; i++) {
+    b[i] = static_cast<float>((i % 5) - 2) * 0.25f;
+  }
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      for (int64_t k = 0; k < K; k++) {
+        y[m * N + n] += a[m * K + k] * b[k * N + n];
+      }
+    }
+  }
+
+  for (int run = 0; run < 2; run++) {
+    OpTester test("MatMul", 13);
+    test.AddInput<float>("A", {M, K}, a);
+    test.AddInput<float>("B", {K, N}, b);
+    test.AddOutput<float>("Y", {M, N}, y);
+
+    SessionOptions so;
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigMlasGemmTuneThreadPartition, "1"));
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    test.Config(so)
+        .ConfigEps(std::move(execution_providers))
+        .RunWithConfig();
+  }
+}
+
 #if defined(USE_CUDA) || defined(USE_ROCM) || defined(USE_DNNL)
 TEST(MathOpTest, MatMul_bfloat16) {
 #ifdef USE_CUDA
@@ -291,19 +419,21 @@ TEST(MathOpTest, MatMul_bfloat16) {
 TEST(MathOpTest, MatMulSharedPrepackedWeights) {
   OpTester test("MatMul");
 
-  std::vector<float> b_init_values(12, 1.0f);
+  // MLAS leaves a small B unpacked for its small matrix kernels
+  constexpr int64_t N = 1040;
+  std::vector<float> b_init_values(4 * N, 1.0f);
   test.AddInput<float>("A", {2, 4},
                        {1.0f, 2.0f, 3.0f, 4.0f,
                         -1.0f, -2.0f, -3.0f, -4.0f});
   // B is to be an initializer for triggering pre-packing
-  test.AddInput<float>("B", {4, 3}, b_init_values, true);
+  test.AddInput<float>("B", {4, N}, b_init_values, true);
 
-  test.AddOutput<float>("Y", {2, 3},
-                        {10.0f, 10.0f, 10.0f,
-                         -10.0f, -10.0f, -10.0f});
+  std::vector<float> y_values(2 * N, 10.0f);
+  std::fill(y_values.begin() + N, y_values.end(), -10.0f);
+  test.AddOutput<float>("Y", {2, N}, y_values);
 
   OrtValue b;
-  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({4, 3}),
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({4, N}),
                        b_init_values.data(), OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator), b);
 
   SessionOptions so;
@@ -3,6 +3,7 @@
 
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
 using namespace std;
 namespace onnxruntime {
 namespace test {
@@ -642,6 +643,54 @@ TEST(ConvTest, Conv2D_group) {
   TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape, true);
 }
 
+TEST(ConvTest, Conv2D_Float16_Cpu) {
+  auto run_test = [](int64_t group, const vector<int64_t>& pads,
+                     const vector<float>& X, const vector<int64_t>& X_shape,
+                     const vector<float>& W, const vector<int64_t>& W_shape,
+                     const vector<float>& B,
+                     const vector<float>& Y, const vector<int64_t>& Y_shape) {
+    OpTester test("Conv", 11);
+    test.AddAttribute("group", group);
+    test.AddAttribute("kernel_shape", vector<int64_t>{W_shape[2], W_shape[3]});
+    test.AddAttribute("pads", pads);
+
+    test.AddInput<MLFloat16>("X", X_shape, FloatsToMLFloat16s(X));
+    test.AddInput<MLFloat16>("W", W_shape, FloatsToMLFloat16s(W), true);
+    if (!B.empty()) {
+      test.AddInput<MLFloat16>("B", {W_shape[0]}, FloatsToMLFloat16s(B));
+    }
+    test.AddOutput<MLFloat16>("Y", Y_shape, FloatsToMLFloat16s(Y));
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    test.ConfigEps(std::move(execution_providers))
+        .RunWithConfig();
+  };
+
+  // 2x2 kernel with bias, uses the im2col transform.
+  run_test(1, {0, 0, 0, 0},
+           {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f}, {1, 1, 3, 3},
+           vector<float>(8, 1.0f), {2, 1, 2, 2},
+           {1.0f, -1.0f},
+           {13.0f, 17.0f, 25.0f, 29.0f, 11.0f, 15.0f, 23.0f, 27.0f}, {1, 2, 2, 2});
+
+  // Grouped pointwise convolution, reads the input in place.
+  run_test(2, {0, 0, 0, 0},
+           {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f, 16.0f, 17.0f},
+           {1, 2, 3, 3},
+           {1.0f, 2.0f}, {2, 1, 1, 1},
+           {},
+           {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 18.0f, 20.0f, 22.0f, 24.0f, 26.0f, 28.0f, 30.0f, 32.0f, 34.0f},
+           {1, 2, 3, 3});
+
+  // Padded 3x3 kernel.
+  run_test(1, {1, 1, 1, 1},
+           {1.0f, 1.0f, 1.0f, 1.0f}, {1, 1, 2, 2},
+           vector<float>(9, 1.0f), {1, 1, 3, 3},
+           {0.5f},
+           {4.5f, 4.5f, 4.5f, 4.5f}, {1, 1, 2, 2});
+}
+
 TEST(ConvTest, ConvDimWithZero) {
   ConvOpAndTestAttributes attrs = {
       "",                           // auto_pad
@@ -0,0 +1,109 @@
+#!/usr/bin/env python
+# coding: utf-8
+# -------------------------------------------------------------------------
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License. See License.txt in the project root for
+# license information.
+# --------------------------------------------------------------------------
+
+import tempfile
+import unittest
+from pathlib import Path
+
+import numpy as np
+import onnx
+from onnx import TensorProto, helper
+from op_test_utils import TestDataFeeds, check_model_correctness, check_op_type_count
+
+from onnxruntime.quantization import MatMulWeight4Quantizer
+
+
+class TestOpMatMul4Bits(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        cls._tmp_model_dir = tempfile.TemporaryDirectory(prefix="test_matmul4bits.")
+
+    @classmethod
+    def tearDownClass(cls):
+        cls._tmp_model_dir.cleanup()
+
+    def input_feeds(self, n, name2shape):
+        input_data_list = []
+        for _i in range(n):
+            inputs = {}
+            for name, shape in name2shape.items():
+                inputs.update({name: np.random.randint(-1, 2, shape).astype(np.float32)})
+            input_data_list.extend([inputs])
+        dr = TestDataFeeds(input_data_list)
+        return dr
+
+    def construct_model_matmul(self, output_model_path, weight):
+        #      (input)
+        #         |
+        #       MatMul
+        #         |
+        #      (output)
+        input_name = "input"
+        output_name = "output"
+        initializers = [onnx.numpy_helper.from_array(weight.astype(np.float32), name="linear1.weight")]
+        matmul_node = helper.make_node("MatMul", [input_name, "linear1.weight"], [output_name], "MatMul_0")
+
+        input_tensor = helper.make_tensor_value_info(input_name, TensorProto.FLOAT, [-1, weight.shape[0]])
+        output_tensor = helper.make_tensor_value_info(output_name, TensorProto.FLOAT, [-1, weight.shape[1]])
+        graph = helper.make_graph(
+            [matmul_node], "matmul_test", [input_tensor], [output_tensor], initializer=initializers
+        )
+        model = helper.make_model(graph, opset_imports=[helper.make_opsetid("", 13)])
+        model.ir_version = 7  # use stable onnx ir version
+
+        onnx.save(model, output_model_path)
+
+    def quant_test(self, model_fp32_path, weight, quant_type):
+        model_int4_path = str(Path(self._tmp_model_dir.name).joinpath(f"matmul_int4_{quant_type}.onnx").absolute())
+        model_dequant_path = str(
+            Path(self._tmp_model_dir.name).joinpath(f"matmul_dequant_{quant_type}.onnx").absolute()
+        )
+
+        model = onnx.load(model_fp32_path)
+        quant = MatMulWeight4Quantizer(model, quant_type)
+        quant.process()
+        quant.model.save_model_to_file(model_int4_path, False)
+
+        check_op_type_count(self, model_int4_path, MatMulFpQ4=1, MatMul=0)
+
+        blob = onnx.numpy_helper.to_array(quant.model.get_initializer("linear1.weight_Q4"))
+        self.assertEqual(blob.size, MatMulWeight4Quantizer.packed_size(quant_type, weight.shape[1], weight.shape[0]))
+
+        # The weights of this reference model are what the kernel sees after
+        # dequantization, so the outputs only differ by rounding.
+        scale, zero_point, values = MatMulWeight4Quantizer.quantize_blocks(quant_type, weight)
+        dequant = (values.astype(np.float32) - zero_point[..., np.newaxis]) * scale[..., np.newaxis]
+        dequant = dequant.reshape(weight.shape[1], -1)[:, : weight.shape[0]].T
+        self.construct_model_matmul(model_dequant_path, dequant)
+
+        data_reader = self.input_feeds(1, {"input": [100, weight.shape[0]]})
+        check_model_correctness(
+            self, model_dequant_path, model_int4_path, data_reader.get_next(), rtol=1e-4, atol=1e-3
+        )
+
+    def quant_test_all_types(self, weight, symmetric):
+        model_fp32_path = str(Path(self._tmp_model_dir.name).joinpath(f"matmul_fp32_{symmetric}.onnx").absolute())
+        self.construct_model_matmul(model_fp32_path, weight)
+        if symmetric:
+            quant_types = [MatMulWeight4Quantizer.BlkQ4Sym32, MatMulWeight4Quantizer.BlkQ4Sym128]
+        else:
+            quant_types = [MatMulWeight4Quantizer.BlkQ4Zp32, MatMulWeight4Quantizer.BlkQ4Zp128]
+        for quant_type in quant_types:
+            self.quant_test(model_fp32_path, weight, quant_type)
+
+    def test_quantize_matmul_int4_symmetric(self):
+        np.random.seed(13)
+        self.quant_test_all_types(np.random.uniform(-1.0, 1.0, [300, 60]), True)
+
+    def test_quantize_matmul_int4_offsets(self):
+        np.random.seed(13)
+        self.quant_test_all_types(np.random.uniform(-0.5, 1.0, [52, 288]), False)
+
+
+if __name__ == "__main__":
+    unittest.main()
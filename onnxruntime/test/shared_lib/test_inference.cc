@@ -9,6 +9,7 @@
 #include <atomic>
 #include <mutex>
 #include <algorithm>
+#include <future>
 #include <thread>
 
 #include "gtest/gtest.h"
@@ -986,6 +987,165 @@ TEST(CApiTest, get_allocator_cpu) {
   ASSERT_EQ(1024U, mem_allocation.size());
 }
 
+TEST(CApiTest, get_allocator_stats_cpu) {
+  const auto& api = Ort::GetApi();
+  Ort::SessionOptions session_options;
+  Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_CPU(session_options, 1));
+  Ort::Session session(*ort_env, NAMED_AND_ANON_DIM_PARAM_URI, session_options);
+  Ort::MemoryInfo info_cpu = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemTypeDefault);
+
+  const char* keys[] = {"num_allocs", "bytes_in_use", "num_regions", "largest_free_chunk", "num_bins"};
+  int64_t values[5] = {-1, -1, -1, -1, -1};
+  Ort::ThrowOnError(api.SessionGetAllocatorStats(session, info_cpu, keys, values, 5));
+  for (auto value : values) {
+    ASSERT_GE(value, 0);
+  }
+
+  // the histogram is only reported by arena based allocators
+  const int64_t num_bins = values[4];
+  if (num_bins > 0) {
+    const std::string last_bin_key = "free_bytes_in_bin_" + std::to_string(num_bins - 1);
+    const char* bin_keys[] = {"free_bytes_in_bin_0", last_bin_key.c_str()};
+    int64_t bin_values[2] = {-1, -1};
+    Ort::ThrowOnError(api.SessionGetAllocatorStats(session, info_cpu, bin_keys, bin_values, 2));
+    ASSERT_GE(bin_values[0], 0);
+    ASSERT_GE(bin_values[1], 0);
+  }
+
+  const std::string out_of_range_key = "free_bytes_in_bin_" + std::to_string(num_bins);
+  const char* invalid_keys[] = {out_of_range_key.c_str()};
+  OrtStatus* status = api.SessionGetAllocatorStats(session, info_cpu, invalid_keys, values, 1);
+  ASSERT_NE(status, nullptr);
+  EXPECT_EQ(api.GetErrorCode(status), ORT_INVALID_ARGUMENT);
+  api.ReleaseStatus(status);
+}
+
+struct RunAsyncResult {
+  std::promise<void> done;
+  OrtErrorCode error_code = ORT_OK;
+  std::vector<float> y_values;
+};
+
+static void ORT_API_CALL RunAsyncCallback(void* user_data, OrtValue** outputs, size_t num_outputs,
+                                          OrtStatusPtr status) {
+  auto* result = static_cast<RunAsyncResult*>(user_data);
+  if (status != nullptr) {
+    result->error_code = Ort::GetApi().GetErrorCode(status);
+    Ort::GetApi().ReleaseStatus(status);
+  } else if (num_outputs == 1) {
+    Ort::Value y{outputs[0]};
+    outputs[0] = nullptr;
+    const float* y_data = y.GetTensorData<float>();
+    result->y_values.assign(y_data, y_data + y.GetTensorTypeAndShapeInfo().GetElementCount());
+  }
+  result->done.set_value();
+}
+
+TEST(CApiTest, RunAsync) {
+  Ort::SessionOptions session_options;
+  session_options.SetIntraOpNumThreads(2);
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+
+  std::vector<float> x_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<int64_t> x_dims = {3, 2};
+  Ort::MemoryInfo info_cpu = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+  Ort::Value x = Ort::Value::CreateTensor<float>(info_cpu, x_values.data(), x_values.size(),
+                                                 x_dims.data(), x_dims.size());
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  Ort::RunOptions run_options;
+
+  constexpr size_t num_runs = 8;
+  std::vector<RunAsyncResult> results(num_runs);
+  std::vector<Ort::Value> outputs;
+  for (size_t i = 0; i < num_runs; ++i) {
+    outputs.emplace_back(nullptr);
+  }
+
+  for (size_t i = 0; i < num_runs; ++i) {
+    session.RunAsync(run_options, input_names, &x, 1, output_names, &outputs[i], 1, RunAsyncCallback, &results[i]);
+  }
+
+  const std::vector<float> expected_values_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+  for (auto& result : results) {
+    result.done.get_future().wait();
+    ASSERT_EQ(result.error_code, ORT_OK);
+    ASSERT_EQ(result.y_values, expected_values_y);
+  }
+}
+
+TEST(CApiTest, RunAsyncTerminate) {
+  Ort::SessionOptions session_options;
+  session_options.SetIntraOpNumThreads(2);
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+
+  std::vector<float> x_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<int64_t> x_dims = {3, 2};
+  Ort::MemoryInfo info_cpu = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+  Ort::Value x = Ort::Value::CreateTensor<float>(info_cpu, x_values.data(), x_values.size(),
+                                                 x_dims.data(), x_dims.size());
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  Ort::RunOptions run_options;
+  run_options.SetTerminate();
+
+  RunAsyncResult result;
+  Ort::Value y{nullptr};
+  session.RunAsync(run_options, input_names, &x, 1, output_names, &y, 1, RunAsyncCallback, &result);
+  result.done.get_future().wait();
+  ASSERT_NE(result.error_code, ORT_OK);
+  ASSERT_FALSE(y);
+}
+
+struct RunAsyncReleaseResult {
+  Ort::Session* session;
+  std::promise<OrtErrorCode> done;
+};
+
+// releases the session from the thread that runs the callback
+static void ORT_API_CALL RunAsyncReleaseCallback(void* user_data, OrtValue** outputs, size_t num_outputs,
+                                                 OrtStatusPtr status) {
+  auto* result = static_cast<RunAsyncReleaseResult*>(user_data);
+  OrtErrorCode error_code = ORT_OK;
+  if (status != nullptr) {
+    error_code = Ort::GetApi().GetErrorCode(status);
+    Ort::GetApi().ReleaseStatus(status);
+  }
+  for (size_t i = 0; i < num_outputs; ++i) {
+    Ort::Value{outputs[i]};
+    outputs[i] = nullptr;
+  }
+  delete result->session;
+  result->done.set_value(error_code);
+}
+
+TEST(CApiTest, RunAsyncReleaseSessionInCallback) {
+  std::vector<float> x_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<int64_t> x_dims = {3, 2};
+  Ort::MemoryInfo info_cpu = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+  Ort::Value x = Ort::Value::CreateTensor<float>(info_cpu, x_values.data(), x_values.size(),
+                                                 x_dims.data(), x_dims.size());
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  Ort::RunOptions run_options;
+
+  // with a thread pool, and without one, in which case the callback is invoked before RunAsync returns
+  for (int inter_op_num_threads : {2, 1}) {
+    Ort::SessionOptions session_options;
+    session_options.SetInterOpNumThreads(inter_op_num_threads);
+
+    RunAsyncReleaseResult result;
+    result.session = new Ort::Session(*ort_env, MODEL_URI, session_options);
+    std::future<OrtErrorCode> done = result.done.get_future();
+    Ort::Value y{nullptr};
+    result.session->RunAsync(run_options, input_names, &x, 1, output_names, &y, 1, RunAsyncReleaseCallback, &result);
+    ASSERT_EQ(done.get(), ORT_OK);
+  }
+}
+
 #ifdef USE_CUDA
 TEST(CApiTest, get_allocator_cuda) {
   Ort::SessionOptions session_options;
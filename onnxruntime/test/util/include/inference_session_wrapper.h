@@ -31,6 +31,10 @@ class InferenceSessionWrapper : public InferenceSession {
   const Model& GetModel() const {
     return *model_;
   }
+
+  const RequestBatcher* GetRequestBatcher() const {
+    return InferenceSession::GetRequestBatcher();
+  }
 };
 
 }  // namespace test